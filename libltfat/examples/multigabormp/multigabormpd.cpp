@@ -2,6 +2,7 @@
 #include "cxxopts.hpp"
 #include "wavhandler.h"
 #include <algorithm>
+#include <deque>
 
 
 template<class T>
@@ -21,6 +22,8 @@ int main(int argc, char* argv[])
     double atprodreltoldb = -80;
     size_t maxit = 0, maxat = 0;
     double seglen = 0.0;
+    int nthreads = 0;
+    size_t batchsize = 16;
     double kernthr = 1e-4;
     vector<tuple<string,int,int,int,int>> dicts;
     size_t numSamples = 0;
@@ -28,6 +31,8 @@ int main(int argc, char* argv[])
     int sampRate = 0;
     bool do_pedanticsearch = false;
     bool do_verbose = false;
+    bool do_stream = false;
+    size_t chunkLen = 1024;
     int alg = ltfat_dgtmp_alg_mp;
 
     try
@@ -58,13 +63,21 @@ int main(int argc, char* argv[])
          cxxopts::value<double>()->default_value(to_string(atprodreltoldb)))
         ("maxit", "Maximum number of iterations", cxxopts::value<size_t>() )
         ("maxat", "Maximum number of atoms", cxxopts::value<size_t>() )
-        ("alg", "MP algorithm. Available: mp(default),cyclicmp,selfprojmp", cxxopts::value<string>() )
+        ("alg", "MP algorithm. Available: mp(default),cyclicmp,selfprojmp,batchmp", cxxopts::value<string>() )
+        ("batchsize", "Maximum number of atoms selected at once by batchmp",
+         cxxopts::value<size_t>()->default_value(to_string(batchsize)) )
         ("kernthr", "Kernel truncation threshold",
          cxxopts::value<double>()->default_value(to_string(kernthr)))
         ("seglen", "Segment length in seconds. 0 disables the segmentation.",
          cxxopts::value<double>()->default_value(to_string(seglen)) )
+        ("threads", "Number of threads used with --seglen or --alg batchmp. 0 uses all processors.",
+         cxxopts::value<int>()->default_value(to_string(nthreads)) )
         ("pedanticsearch", "Enables pedantic search. Pedantic search is always enabled for cyclic MP.",
          cxxopts::value<bool>(do_pedanticsearch) )
+        ("stream", "Read the input and write the output chunk by chunk. Requires --seglen.",
+         cxxopts::value<bool>(do_stream) )
+        ("chunklen", "Chunk length in samples used with --stream",
+         cxxopts::value<size_t>()->default_value(to_string(chunkLen)) )
         ("verbose", "Print additional information.",
          cxxopts::value<bool>(do_verbose) )
         ("help", "Print help");
@@ -123,6 +136,42 @@ int main(int argc, char* argv[])
             }
         }
 
+        if(do_stream && seglen == 0.0)
+        {
+            cout << "stream requires seglen." << endl;
+            exit(1);
+        }
+
+        if(result.count("chunklen"))
+        {
+            chunkLen =  result["chunklen"].as<size_t>();
+            if(chunkLen == 0)
+            {
+                cout << "chunklen must be positive." << endl;
+                exit(1);
+            }
+        }
+
+        if(result.count("threads"))
+        {
+            nthreads =  result["threads"].as<int>();
+            if(nthreads < 0)
+            {
+                cout << "threads must be nonnegative." << endl;
+                exit(1);
+            }
+        }
+
+        if(result.count("batchsize"))
+        {
+            batchsize =  result["batchsize"].as<size_t>();
+            if(batchsize == 0)
+            {
+                cout << "batchsize must be positive." << endl;
+                exit(1);
+            }
+        }
+
         if (result.count("atprodtol"))
         {
             atprodreltoldb = result["atprodtol"].as<double>();
@@ -149,6 +198,7 @@ int main(int argc, char* argv[])
             if( algstr.compare("mp") == 0 ) alg = ltfat_dgtmp_alg_mp;
             else if( algstr.compare("cyclicmp") == 0 ) alg = ltfat_dgtmp_alg_loccyclicmp;
             else if( algstr.compare("selfprojmp") == 0 ) alg = ltfat_dgtmp_alg_locselfprojmp;
+            else if( algstr.compare("batchmp") == 0 ) alg = ltfat_dgtmp_alg_batchmp;
             else
             {
                 cout << "Unrecognized algorithm." << endl;
@@ -245,39 +295,135 @@ int main(int argc, char* argv[])
        }
     }
 
-    if( seglen == 0.0 || numSamples <= seglen*sampRate )
+    ltfat_int L = LTFAT_NAME(dgtrealmp_getparbuf_siglen)(pbuf, numSamples);
+
+    LTFAT_NAME(dgtrealmp_setparbuf_phaseconv)(pbuf, LTFAT_TIMEINV);
+    LTFAT_NAME(dgtrealmp_setparbuf_pedanticsearch)(pbuf, do_pedanticsearch);
+    LTFAT_NAME(dgtrealmp_setparbuf_atprodreltoldb)(pbuf, atprodreltoldb);
+    LTFAT_NAME(dgtrealmp_setparbuf_snrdb)(pbuf, targetsnrdb);
+    LTFAT_NAME(dgtrealmp_setparbuf_kernrelthr)(pbuf, kernthr);
+    LTFAT_NAME(dgtrealmp_setparbuf_maxatoms)(pbuf, maxat);
+    LTFAT_NAME(dgtrealmp_setparbuf_maxit)(pbuf, maxit);
+    LTFAT_NAME(dgtrealmp_setparbuf_iterstep)(pbuf, L);
+    LTFAT_NAME(dgtrealmp_setparbuf_alg)(pbuf, static_cast<ltfat_dgtmp_alg>(alg));
+    LTFAT_NAME(dgtrealmp_setparbuf_batchsize)(pbuf, batchsize);
+    LTFAT_NAME(dgtrealmp_setparbuf_batchthreads)(pbuf, nthreads);
+
+    if(do_stream)
     {
-        ltfat_int L = LTFAT_NAME(dgtrealmp_getparbuf_siglen)(pbuf, numSamples);
+        // Only the slices of length Lwin are decomposed, the memory
+        // requirements do not depend on the length of the input file.
+        ltfat_int Lwin = LTFAT_NAME(dgtrealmp_getparbuf_siglen)(pbuf, (ltfat_int)(seglen*sampRate));
+        double frac = std::min(1.0, Lwin/((double) numSamples));
+        LTFAT_NAME(dgtrealmp_setparbuf_maxatoms)(pbuf, std::max<size_t>(1, maxat*frac));
+        LTFAT_NAME(dgtrealmp_setparbuf_maxit)(pbuf, std::max<size_t>(1, maxit*frac));
+        LTFAT_NAME(dgtrealmp_setparbuf_iterstep)(pbuf, Lwin);
+
+        LTFAT_NAME(slidgtrealmp_state)* plan = NULL;
+        auto t1 = Clock::now();
+        if( 0 != LTFAT_NAME(slidgtrealmp_init)( pbuf, Lwin, numChannels,
+                                                chunkLen, &plan)) return -1;
+        auto t2 = Clock::now();
+        int dur = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+        cout << "INIT DURATION: " << dur << " ms" << std::endl;
+        auto uniplan = uni_ptrdel<LTFAT_NAME(slidgtrealmp_state)>(
+        plan,[](auto* p){ LTFAT_NAME(slidgtrealmp_done)(&p); });
 
-        LTFAT_NAME(dgtrealmp_setparbuf_phaseconv)(pbuf, LTFAT_TIMEINV);
-        LTFAT_NAME(dgtrealmp_setparbuf_pedanticsearch)(pbuf, do_pedanticsearch);
-        LTFAT_NAME(dgtrealmp_setparbuf_atprodreltoldb)(pbuf, atprodreltoldb);
-        LTFAT_NAME(dgtrealmp_setparbuf_snrdb)(pbuf, targetsnrdb);
-        LTFAT_NAME(dgtrealmp_setparbuf_kernrelthr)(pbuf, kernthr);
-        LTFAT_NAME(dgtrealmp_setparbuf_maxatoms)(pbuf, maxat);
-        LTFAT_NAME(dgtrealmp_setparbuf_maxit)(pbuf, maxit);
-        LTFAT_NAME(dgtrealmp_setparbuf_iterstep)(pbuf, L);
-        LTFAT_NAME(dgtrealmp_setparbuf_alg)(pbuf, static_cast<ltfat_dgtmp_alg>(alg));
+        size_t delay = LTFAT_NAME(slidgtrealmp_getprocdelay)(plan);
 
-        vector<vector<LTFAT_REAL>> f(numChannels);
-        for(auto& fEl:f) fEl = vector<LTFAT_REAL>(L,0.0);
+        WavReader<LTFAT_REAL> wr{inFile};
+        unique_ptr<WavWriter<LTFAT_REAL>> wwout, wwres;
+        if(!outFile.empty())
+            wwout.reset(new WavWriter<LTFAT_REAL>{outFile,sampRate,numChannels});
+        if(!resFile.empty())
+            wwres.reset(new WavWriter<LTFAT_REAL>{resFile,sampRate,numChannels});
+
+        vector<vector<LTFAT_REAL>> fchunk(numChannels, vector<LTFAT_REAL>(chunkLen));
+        vector<vector<LTFAT_REAL>> foutchunk(numChannels, vector<LTFAT_REAL>(chunkLen));
+        vector<vector<LTFAT_REAL>> fres(numChannels, vector<LTFAT_REAL>(chunkLen));
+        vector<const LTFAT_REAL*> inPtrs(numChannels);
+        vector<LTFAT_REAL*> outPtrs(numChannels);
+        // Input samples waiting for their approximation, needed for the
+        // residual and the SNR
+        vector<deque<LTFAT_REAL>> pending(numChannels);
+        vector<double> sigEn(numChannels), errEn(numChannels);
+
+        t1 = Clock::now();
+        for (size_t inPos = 0, outPos = 0; outPos < numSamples; inPos += chunkLen)
+        {
+            wr.readSamples(fchunk);
+            for (int nCh = 0; nCh < numChannels; nCh++)
+            {
+                inPtrs[nCh] = fchunk[nCh].data();
+                outPtrs[nCh] = foutchunk[nCh].data();
+                pending[nCh].insert(pending[nCh].end(), fchunk[nCh].begin(), fchunk[nCh].end());
+            }
 
-        vector<vector<LTFAT_REAL>> fout(numChannels);
-        for(auto& fEl:fout) fEl = vector<LTFAT_REAL>(L);
+            int status = LTFAT_NAME(slidgtrealmp_execute)(plan, inPtrs.data(), chunkLen,
+                         numChannels, outPtrs.data());
+            if( status < 0 )
+            {
+                cout << "Execute failed with " << status << endl;
+                return -1;
+            }
 
-        vector<unique_ptr<LTFAT_COMPLEX[]>> coef;
+            // The output chunk corresponds to input at inPos - delay
+            if( inPos + chunkLen <= delay )
+                continue;
 
-        for (int pidx = 0; pidx < LTFAT_NAME(dgtrealmp_getparbuf_dictno)(pbuf); pidx++ )
-        {
-            ltfat_int clen = LTFAT_NAME(dgtrealmp_getparbuf_coeflen)(pbuf, numSamples, pidx);
-            coef.push_back( unique_ptr<LTFAT_COMPLEX[]>(new LTFAT_COMPLEX[clen]) );
-        }
+            size_t skip = inPos < delay ? delay - inPos : 0;
+            size_t toWrite = std::min(chunkLen - skip, numSamples - outPos);
 
-        {
-            WavReader<LTFAT_REAL> wr{inFile};
-            wr.readSamples(f);
+            for (int nCh = 0; nCh < numChannels; nCh++)
+            {
+                auto& out = foutchunk[nCh];
+                std::copy(out.begin() + skip, out.begin() + skip + toWrite, out.begin());
+                for (size_t l = 0; l < toWrite; l++)
+                {
+                    LTFAT_REAL fval = pending[nCh].front();
+                    pending[nCh].pop_front();
+                    fres[nCh][l] = fval - out[l];
+                    sigEn[nCh] += fval * fval;
+                    errEn[nCh] += fres[nCh][l] * fres[nCh][l];
+                }
+            }
+
+            if(wwout) wwout->writeSamples(foutchunk, toWrite);
+            if(wwres) wwres->writeSamples(fres, toWrite);
+            outPos += toWrite;
         }
+        t2 = Clock::now();
+        dur = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+        cout << "DURATION: " << dur << " ms" << std::endl;
+
+        for (int nCh = 0; nCh < numChannels; nCh++)
+            cout << "channel " << nCh << ": SNR=" << 10.0*log10(sigEn[nCh]/errEn[nCh])
+                 << " dB" << endl;
+
+        return 0;
+    }
+
+    vector<vector<LTFAT_REAL>> f(numChannels);
+    for(auto& fEl:f) fEl = vector<LTFAT_REAL>(L,0.0);
+
+    vector<vector<LTFAT_REAL>> fout(numChannels);
+    for(auto& fEl:fout) fEl = vector<LTFAT_REAL>(L);
+
+    vector<unique_ptr<LTFAT_COMPLEX[]>> coef;
+
+    for (int pidx = 0; pidx < LTFAT_NAME(dgtrealmp_getparbuf_dictno)(pbuf); pidx++ )
+    {
+        ltfat_int clen = LTFAT_NAME(dgtrealmp_getparbuf_coeflen)(pbuf, numSamples, pidx);
+        coef.push_back( unique_ptr<LTFAT_COMPLEX[]>(new LTFAT_COMPLEX[clen]) );
+    }
 
+    {
+        WavReader<LTFAT_REAL> wr{inFile};
+        wr.readSamples(f);
+    }
+
+    if( seglen == 0.0 || numSamples <= seglen*sampRate )
+    {
         LTFAT_NAME(dgtrealmp_state)*  plan = NULL;
         auto t1 = Clock::now();
         if( 0 != LTFAT_NAME(dgtrealmp_init)( pbuf, L, &plan)) return -1;
@@ -308,27 +454,59 @@ int main(int argc, char* argv[])
             cout << "atoms=" << atoms << ", iters=" << iters << ", SNR=" << snr << " dB"
                  << ", perit=" << 1000.0 * dur / ((double)iters) << "us, exit code=" << status <<endl;
 
-        }
+            if (alg == ltfat_dgtmp_alg_batchmp)
+            {
+                size_t outoforder; double maxdevdb;
+                LTFAT_NAME(dgtrealmp_get_orderdeviation)(plan, &outoforder, &maxdevdb);
+                cout << "out of order=" << outoforder << ", max deviation=" << maxdevdb << " dB" << endl;
+            }
 
-        if(!outFile.empty())
-        {
-            WavWriter<LTFAT_REAL> ww{outFile,sampRate,(int)fout.size()};
-            ww.writeSamples(fout);
         }
+    }
+    else
+    {
+        LTFAT_NAME(segdgtrealmp_state)*  plan = NULL;
+        auto t1 = Clock::now();
+        if( 0 != LTFAT_NAME(segdgtrealmp_init)( pbuf, L, (ltfat_int)(seglen*sampRate),
+                                                nthreads, &plan)) return -1;
+        auto t2 = Clock::now();
+        int dur = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+        cout << "INIT DURATION: " << dur << " ms, segments="
+             << LTFAT_NAME(segdgtrealmp_get_segno)(plan) << std::endl;
+        auto uniplan = uni_ptrdel<LTFAT_NAME(segdgtrealmp_state)>(
+        plan,[](auto* p){ LTFAT_NAME(segdgtrealmp_done)(&p); });
 
-        if(!resFile.empty())
+        for (int nCh=0;nCh<numChannels;nCh++)
         {
-            for(size_t nCh=0;nCh<fout.size();nCh++)
-                for(size_t l=0;l<fout[nCh].size();l++)
-                    fout[nCh][l] =  f[nCh][l] - fout[nCh][l];
+            t1 = Clock::now();
+            int status = LTFAT_NAME(segdgtrealmp_execute)(plan, f[nCh].data(),
+                         (LTFAT_COMPLEX**) coef.data(), fout[nCh].data());
+            t2 = Clock::now();
+            dur = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+            cout << "DURATION: " << dur << " ms" << std::endl;
 
-            WavWriter<LTFAT_REAL> ww{resFile,sampRate,(int)fout.size()};
-            ww.writeSamples(fout);
+            size_t atoms; LTFAT_NAME(segdgtrealmp_get_numatoms)(plan, &atoms);
+            LTFAT_REAL snr; LTFAT_NAME(snr)(f[nCh].data(), fout[nCh].data(), L, &snr);
+
+            cout << "atoms=" << atoms << ", SNR=" << snr << " dB"
+                 << ", exit code=" << status <<endl;
         }
     }
-    else
+
+    if(!outFile.empty())
     {
-        cout << "Segment-wise processing is not supported yet." << endl;
+        WavWriter<LTFAT_REAL> ww{outFile,sampRate,(int)fout.size()};
+        ww.writeSamples(fout);
+    }
+
+    if(!resFile.empty())
+    {
+        for(size_t nCh=0;nCh<fout.size();nCh++)
+            for(size_t l=0;l<fout[nCh].size();l++)
+                fout[nCh][l] =  f[nCh][l] - fout[nCh][l];
+
+        WavWriter<LTFAT_REAL> ww{resFile,sampRate,(int)fout.size()};
+        ww.writeSamples(fout);
     }
     return 0;
 }
@@ -46,10 +46,18 @@ class WavReader
                 buffer.resize(reqSamples*chNo);
 
             samplesRead = drwav_read_f32(unifile.get(), reqSamples*chNo, buffer.data());
+            // Frames, not interleaved samples
+            samplesRead /= chNo;
 
             for(int ch = 0; ch < min(chNo,reqChannels); ch++)
-                for(size_t l = 0; l < min((size_t)samplesRead,v[ch].size()); l++)
+            {
+                size_t l = 0;
+                for(; l < min((size_t)samplesRead,v[ch].size()); l++)
                     v[ch][l] = static_cast<SAMPLE>( buffer[chNo*l+ch]);
+                // Past the end of the file
+                for(; l < min(reqSamples,v[ch].size()); l++)
+                    v[ch][l] = 0;
+            }
 
             return samplesRead;
         }
@@ -103,7 +111,7 @@ class WavWriter
                 buffer.resize(reqSamples*chNo);
 
             for(int ch = 0; ch < min(chNo,reqChannels); ch++)
-                for(size_t l = 0; l < v[ch].size(); l++)
+                for(size_t l = 0; l < min(reqSamples,v[ch].size()); l++)
                    buffer[chNo*l+ch] = (drwav_int16) ( v[ch][l] * SHRT_MAX );
 
             // writtenSamples = fwd_writeSamples(unifile.get(), buffer.data(), reqSamples*chNo);
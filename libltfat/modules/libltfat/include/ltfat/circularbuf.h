@@ -14,6 +14,18 @@
 #ifndef _LTFAT_CIRCULARBUF_H
 #define _LTFAT_CIRCULARBUF_H
 
+/** Sample formats of interleaved audio buffers
+ *
+ * The integer formats are scaled such that the full scale maps to [-1,1).
+ * When converting back, the samples are rounded and clipped.
+ */
+typedef enum
+{
+    LTFAT_SAMPLE_INT16,
+    LTFAT_SAMPLE_INT32,
+    LTFAT_SAMPLE_FLOAT32,
+    LTFAT_SAMPLE_FLOAT64
+} ltfat_sampleformat;
 
 #endif
 
@@ -76,6 +88,108 @@ LTFAT_NAME(block_processor_execute_compact)(
     LTFAT_NAME(block_processor_state)* p,
     const LTFAT_REAL* in, ltfat_int inLen, ltfat_int chanNo, ltfat_int outLen,
     LTFAT_REAL* out);
+
+/** Process interleaved samples
+ *
+ * Works like block_processor_execute() except that \a in and \a out hold
+ * frames of \a chanNo interleaved samples of format \a fmt, as delivered
+ * by most audio APIs. The conversion and (de)interleaving is done while
+ * the samples are moved in and out of the FIFOs. \a out can be NULL.
+ */
+LTFAT_API int
+LTFAT_NAME(block_processor_execute_interleaved)(
+    LTFAT_NAME(block_processor_state)* p, ltfat_sampleformat fmt,
+    const void* in, ltfat_int inLen, ltfat_int chanNo,
+    ltfat_int outLen, void* out);
+/** @} */
+
+/** \name Two-thread (lock-free) interface
+ *
+ * In this mode, the audio I/O thread only moves samples in and out of the
+ * FIFOs using block_processor_execute_io() and a separate processing
+ * thread runs the callback using block_processor_execute_compute().
+ * The FIFOs are single-producer/single-consumer lock-free ring buffers,
+ * block_processor_execute_io() does not allocate, lock or wait and its
+ * cost does not depend on the callback.
+ *
+ * The output is delayed by additional \a queueLen samples compared to
+ * the basic interface. This is the time the processing thread has to
+ * process a block before the I/O thread needs the result. If the
+ * processing thread falls behind, the missing output samples are
+ * replaced by zeros and LTFATERR_UNDERFLOW is returned.
+ *
+ * Setters (hops, windows, callback) and block_processor_reset() must not
+ * be called while the threads are running, except for
+ * block_processor_setprehop() and block_processor_setposthop(), which
+ * take effect in the processing thread.
+ *
+ * @{
+ */
+
+/** Create block processor for the two-thread mode
+ *
+ * \param[in] winLen     Block length
+ * \param[in] hop        Hop size
+ * \param[in] numChans   Maximum number of channels
+ * \param[in] bufLenMax  Maximum length of buffers passed to block_processor_execute_io()
+ * \param[in] procDelay  Processing delay, must be at least winLen - 1
+ * \param[in] queueLen   Additional delay in samples available to the processing thread
+ * \param[out] p         Block processor state
+ *
+ * \returns
+ * Status code              | Description
+ * -------------------------|--------------------------------------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | \a p was NULL
+ * LTFATERR_NOTPOSARG       | One of the size arguments was not positive
+ * LTFATERR_BADARG          | \a procDelay was smaller than winLen - 1
+ * LTFATERR_NOMEM           | Indicates that heap allocation failed
+ */
+LTFAT_API int
+LTFAT_NAME(block_processor_init_spsc)(
+    ltfat_int winLen, ltfat_int hop, ltfat_int numChans,
+    ltfat_int bufLenMax, ltfat_int procDelay, ltfat_int queueLen,
+    LTFAT_NAME(block_processor_state)** p);
+
+/** Push input samples and pull output samples (I/O thread)
+ *
+ * \returns
+ * Status code              | Description
+ * -------------------------|--------------------------------------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | One of \a p, \a in, \a out was NULL
+ * LTFATERR_NOTSUPPORTED    | \a p was not created by block_processor_init_spsc()
+ * LTFATERR_OVERFLOW        | Too many channels or samples, the rest was ignored
+ * LTFATERR_UNDERFLOW       | The processing thread did not keep up, \a out was padded with zeros
+ */
+LTFAT_API int
+LTFAT_NAME(block_processor_execute_io)(
+    LTFAT_NAME(block_processor_state)* p,
+    const LTFAT_REAL** in, ltfat_int inLen, ltfat_int chanNo,
+    ltfat_int outLen, LTFAT_REAL** out);
+
+/** Push and pull interleaved samples (I/O thread)
+ *
+ * Works like block_processor_execute_io() with the interleaved buffers of
+ * block_processor_execute_interleaved().
+ */
+LTFAT_API int
+LTFAT_NAME(block_processor_execute_io_interleaved)(
+    LTFAT_NAME(block_processor_state)* p, ltfat_sampleformat fmt,
+    const void* in, ltfat_int inLen, ltfat_int chanNo,
+    ltfat_int outLen, void* out);
+
+/** Process all complete blocks waiting in the input FIFO (processing thread)
+ *
+ * The function returns immediately if there is nothing to do. It is up to
+ * the caller to decide how the processing thread waits for new data.
+ *
+ * \returns Number of processed blocks or a negative error code.
+ * LTFATERR_FAILED is returned if the callback failed.
+ */
+LTFAT_API ltfat_int
+LTFAT_NAME(block_processor_execute_compute)(
+    LTFAT_NAME(block_processor_state)* p);
 /** @} */
 
 /** \name Advanced interface
@@ -180,6 +294,19 @@ LTFAT_NAME(analysis_fifo_write)(LTFAT_NAME(analysis_fifo_state)* p, const LTFAT_
  *
  * \returns Number of samples read
  */
+/** Write bufLen interleaved frames to the analysis ring buffer
+ *
+ * Works like analysis_fifo_write() except that \a buf holds bufLen frames
+ * of W interleaved samples of format \a fmt. The samples are converted
+ * while being written to the ring buffer. Channels above the number of
+ * channels of the ring buffer are ignored.
+ *
+ * \returns Number of frames written
+ */
+LTFAT_API ltfat_int
+LTFAT_NAME(analysis_fifo_write_interleaved)(LTFAT_NAME(analysis_fifo_state)* p,
+        const void* buf, ltfat_sampleformat fmt, ltfat_int bufLen, ltfat_int W);
+
 LTFAT_API ltfat_int
 LTFAT_NAME(analysis_fifo_read)(LTFAT_NAME(analysis_fifo_state)* p, LTFAT_REAL buf[]);
 
@@ -223,6 +350,13 @@ LTFAT_API int
 LTFAT_NAME(synthesis_fifo_setwritechanstride)(LTFAT_NAME(synthesis_fifo_state)* p,
         ltfat_int stride);
 
+/** Number of samples which can be written to the synthesis ring buffer
+ *
+ * synthesis_fifo_write() succeeds if this is at least p->winLen.
+ */
+LTFAT_API ltfat_int
+LTFAT_NAME(synthesis_fifo_freespace)(LTFAT_NAME(synthesis_fifo_state)* p);
+
 /** Write p->winLen samples to DGT synthesis ring buffer
  *
  * The function returns 0 if there is not enough space to write all
@@ -254,6 +388,19 @@ LTFAT_NAME(synthesis_fifo_read)(LTFAT_NAME(synthesis_fifo_state)* p,
                                 ltfat_int bufLen, ltfat_int W,
                                 LTFAT_REAL* buf[]);
 
+/** Read bufLen interleaved frames from the synthesis ring buffer
+ *
+ * Works like synthesis_fifo_read() except that the samples are converted
+ * to format \a fmt and written to \a buf as frames of W interleaved
+ * samples. Channels above the number of channels of the ring buffer are
+ * set to zero.
+ *
+ * \returns Number of frames read
+ */
+LTFAT_API ltfat_int
+LTFAT_NAME(synthesis_fifo_read_interleaved)(LTFAT_NAME(synthesis_fifo_state)* p,
+        ltfat_int bufLen, ltfat_int W, ltfat_sampleformat fmt, void* buf);
+
 /** Destroy DGT synthesis ring buffer
  * \param[in]  p      DGT synthesis ring buffer
  */
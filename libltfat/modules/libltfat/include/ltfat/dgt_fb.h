@@ -142,6 +142,46 @@ LTFAT_NAME(dgt_fb_execute)(const LTFAT_NAME(dgt_fb_plan)* plan,
                            const LTFAT_TYPE f[], ltfat_int L,
                            ltfat_int W, LTFAT_COMPLEX c[]);
 
+/** Set number of columns transformed by a single FFT call
+ *
+ * By default, dgt_fb_execute() folds the windowed signal to a buffer of
+ * length M and executes one FFT per time shift, i.e. N x W FFT calls of
+ * length M. With \a K > 1, up to \a K consecutive columns are first
+ * collected in an M x K buffer and transformed by one batched FFT plan.
+ * This removes most of the per-call overhead when M is small compared to
+ * the signal length. The output layout is not affected.
+ *
+ * The FFT plans are recreated using the \a flags passed to dgt_fb_init().
+ * The coefficients can differ from the unbatched ones in the order of the
+ * machine precision, because the FFT library might choose a different
+ * algorithm for the batched plan.
+ *
+ * \param[in]  plan   DGT plan
+ * \param[in]     K   Batch size. K = 1 disables batching.
+ *
+ * #### Versions #
+ * <tt>
+ * ltfat_dgt_fb_set_batchsize_d(ltfat_dgt_fb_plan_d* plan, ltfat_int K);
+ *
+ * ltfat_dgt_fb_set_batchsize_s(ltfat_dgt_fb_plan_s* plan, ltfat_int K);
+ *
+ * ltfat_dgt_fb_set_batchsize_dc(ltfat_dgt_fb_plan_dc* plan, ltfat_int K);
+ *
+ * ltfat_dgt_fb_set_batchsize_sc(ltfat_dgt_fb_plan_sc* plan, ltfat_int K);
+ * </tt>
+ *
+ * \returns
+ * Status code              | Description
+ * -------------------------|--------------------------------------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | \a plan was NULL.
+ * LTFATERR_NOTPOSARG       | \a K was less or equal to 0.
+ * LTFATERR_INITFAILED      | FFTW plan creation failed
+ * LTFATERR_NOMEM           | Indicates that heap allocation failed
+ */
+LTFAT_API int
+LTFAT_NAME(dgt_fb_set_batchsize)(LTFAT_NAME(dgt_fb_plan)* plan, ltfat_int K);
+
 /** Destroy the plan
  *
  * \param[in]  plan   DGT plan
@@ -150,6 +150,45 @@ LTFAT_NAME(dgt_long_execute_newarray)(LTFAT_NAME(dgt_long_plan)* plan,
                                       const LTFAT_TYPE f[], LTFAT_COMPLEX c[]);
 
 
+/** Set number of threads used by the plan
+ *
+ * The factorization is split into c*W independent tasks, where
+ * c = gcd(a,M) is the number of cosets and W is the number of channels.
+ * The tasks are distributed among \a nthreads threads (including the calling
+ * one). Each thread owns its own scratch buffers and FFT plans, the output
+ * is identical to the single-threaded execution.
+ *
+ * The final modulation FFT is always done by the calling thread.
+ *
+ * \param[in]     plan  DGT plan
+ * \param[in] nthreads  Number of threads. 1 means serial execution, 0 means
+ *                      one thread per processor.
+ *
+ *  Function versions
+ *  -----------------
+ *
+ *  <tt>
+ *  ltfat_dgt_long_set_nthreads_d(ltfat_dgt_long_plan_d* plan, ltfat_int nthreads);
+ *
+ *  ltfat_dgt_long_set_nthreads_s(ltfat_dgt_long_plan_s* plan, ltfat_int nthreads);
+ *
+ *  ltfat_dgt_long_set_nthreads_dc(ltfat_dgt_long_plan_dc* plan, ltfat_int nthreads);
+ *
+ *  ltfat_dgt_long_set_nthreads_sc(ltfat_dgt_long_plan_sc* plan, ltfat_int nthreads);
+ *  </tt>
+ * \returns
+ * Status code          |  Description
+ * ---------------------|----------------
+ * LTFATERR_SUCCESS     |  No error occured
+ * LTFATERR_NULLPOINTER |  \a plan was NULL
+ * LTFATERR_BADARG      |  \a nthreads was negative
+ * LTFATERR_NOMEM       |  Heap allocation failed
+ * LTFATERR_INITFAILED  |  Thread or FFT plan creation failed
+ */
+LTFAT_API int
+LTFAT_NAME(dgt_long_set_nthreads)(LTFAT_NAME(dgt_long_plan)* plan,
+                                  ltfat_int nthreads);
+
 /** Destroy DGT plan
  *
  *  Function versions
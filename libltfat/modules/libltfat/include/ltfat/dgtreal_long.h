@@ -142,6 +142,35 @@ LTFAT_API int
 LTFAT_NAME(dgtreal_long_execute_newarray)(LTFAT_NAME(dgtreal_long_plan)* plan,
         const LTFAT_REAL* f, LTFAT_COMPLEX* c);
 
+/** Set number of threads used by the plan
+ *
+ * The factorization is split into c*W independent tasks, c = gcd(a,M),
+ * which are distributed among \a nthreads threads. The output is identical
+ * to the single-threaded execution.
+ *
+ * \param[in]      plan  DGT plan
+ * \param[in]  nthreads  Number of threads. 1 means serial execution, 0 means
+ *                       one thread per processor.
+ *
+ * #### Versions #
+ * <tt>
+ * ltfat_dgtreal_long_set_nthreads_d(ltfat_dgtreal_long_plan_d* plan, ltfat_int nthreads);
+ *
+ * ltfat_dgtreal_long_set_nthreads_s(ltfat_dgtreal_long_plan_s* plan, ltfat_int nthreads);
+ * </tt>
+ * \returns
+ * Status code              | Description
+ * -------------------------|--------------------------------------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | plan was NULL.
+ * LTFATERR_BADARG          | nthreads was negative.
+ * LTFATERR_NOMEM           | Heap allocation failed.
+ * LTFATERR_INITFAILED      | Thread or FFT plan creation failed.
+ */
+LTFAT_API int
+LTFAT_NAME(dgtreal_long_set_nthreads)(LTFAT_NAME(dgtreal_long_plan)* plan,
+                                      ltfat_int nthreads);
+
 /** Destroy the plan
  *
  * \param[in]  plan   DGT plan
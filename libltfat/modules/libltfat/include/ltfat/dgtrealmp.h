@@ -30,6 +30,7 @@ typedef enum
     ltfat_dgtmp_alg_locomp          = 1,
     ltfat_dgtmp_alg_loccyclicmp     = 2,
     ltfat_dgtmp_alg_locselfprojmp   = 3,
+    ltfat_dgtmp_alg_batchmp         = 4,
 } ltfat_dgtmp_alg;
 
 typedef struct ltfat_dgtmp_params ltfat_dgtmp_params;
@@ -88,6 +89,14 @@ LTFAT_API int
 ltfat_dgtmp_setpar_cycles(
         ltfat_dgtmp_params* params, size_t cycles);
 
+LTFAT_API int
+ltfat_dgtmp_setpar_batchsize(
+        ltfat_dgtmp_params* params, size_t batchsize);
+
+LTFAT_API int
+ltfat_dgtmp_setpar_batchthreads(
+        ltfat_dgtmp_params* params, ltfat_int nthreads);
+
 // LTFAT_API int
 // ltfat_dgtmp_setpar_checkerreverynit(
 //     ltfat_dgtmp_params* p, ltfat_int itstep, double errtoldb);
@@ -898,6 +907,42 @@ LTFAT_API int
 LTFAT_NAME(dgtrealmp_get_numiters)(
         const LTFAT_NAME(dgtrealmp_state)* p, size_t* iters);
 
+/** Get deviation of the atom ordering from the strict MP
+ *
+ * Only meaningful with ltfat_dgtmp_alg_batchmp. Atoms selected in one batch
+ * have non-overlapping kernel supports and they are selected in descending
+ * order of their energy. Strict MP could have selected a different atom
+ * instead only if there was a candidate with a higher energy which was
+ * skipped because it overlapped with an already selected atom.
+ * Such iterations are counted in \a outoforder and \a maxdevdb is the
+ * largest energy ratio in dB between the skipped candidate and the selected
+ * atom. An atom selected repeatedly is counted once per selection, like in
+ * dgtrealmp_get_numiters(). Both values are upper bounds since the energy of
+ * the skipped candidate might have decreased after the update.
+ *
+ * \param[in]           p  DGTREALMP state
+ * \param[out] outoforder  Number of iterations possibly selected out of order
+ * \param[out]   maxdevdb  Maximum energy ratio in dB, 0 if there was none
+ *
+ * #### Versions #
+ * <tt>
+ * ltfat_dgtrealmp_get_orderdeviation_d( ltfat_dgtrealmp_state_d* p,
+ *                                       size_t* outoforder, double* maxdevdb);
+ *
+ * ltfat_dgtrealmp_get_orderdeviation_s( ltfat_dgtrealmp_state_s* p,
+ *                                       size_t* outoforder, double* maxdevdb);
+ * </tt>
+ * \returns
+ * Status code              | Description
+ * -------------------------|------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | At least one of the following was NULL: \a p, \a outoforder, \a maxdevdb
+ */
+LTFAT_API int
+LTFAT_NAME(dgtrealmp_get_orderdeviation)(
+        const LTFAT_NAME(dgtrealmp_state)* p, size_t* outoforder,
+        double* maxdevdb);
+
 /** Get pointer to an array of residual coefficients 
  * 
  * \param[in]        p  DGTREALMP state
@@ -1034,3 +1079,11 @@ LTFAT_NAME(dgtrealmp_revert_compact)(
 LTFAT_API int
 LTFAT_NAME(dgtrealmp_setparbuf_alg)(
         LTFAT_NAME(dgtrealmp_parbuf)* parbuf, ltfat_dgtmp_alg alg);
+
+LTFAT_API int
+LTFAT_NAME(dgtrealmp_setparbuf_batchsize)(
+        LTFAT_NAME(dgtrealmp_parbuf)* parbuf, size_t batchsize);
+
+LTFAT_API int
+LTFAT_NAME(dgtrealmp_setparbuf_batchthreads)(
+        LTFAT_NAME(dgtrealmp_parbuf)* parbuf, ltfat_int nthreads);
@@ -27,6 +27,17 @@ typedef enum
 LTFAT_API ltfat_dgt_params*
 ltfat_dgt_params_allocdef();
 
+/** Allocate a copy of dgt_params structure
+ *
+ * \warning The structure must be freed using ltfat_dgt_params_free()
+ *
+ * \returns Allocated struct (or NULL if \a params was NULL or the memory
+ *          allocation failed)
+ * \see ltfat_dgt_params_free
+ */
+LTFAT_API ltfat_dgt_params*
+ltfat_dgt_params_copy(const ltfat_dgt_params* params);
+
 /** Set DGT phase convention
  *
  * \returns
@@ -66,6 +77,27 @@ ltfat_dgt_setpar_hint(ltfat_dgt_params* params, ltfat_dgt_hint hint);
 LTFAT_API int
 ltfat_dgt_setpar_synoverwrites(ltfat_dgt_params* params, int do_synoverwrites);
 
+/** Set number of threads
+ *
+ * Used by the analysis when the factorization algorithm (_long) is chosen.
+ * The result does not depend on the number of threads.
+ *
+ * \param[in]  nthreads  1 (default) means serial execution, 0 means one
+ *                       thread per processor.
+ *
+ * \returns
+ * Status code          |  Description
+ * ---------------------|----------------
+ * LTFATERR_SUCESS      |  No error occured
+ * LTFATERR_NULLPOINTER |  \a params was NULL
+ * LTFATERR_BADARG      |  \a nthreads was negative
+ */
+LTFAT_API int
+ltfat_dgt_setpar_nthreads(ltfat_dgt_params* params, ltfat_int nthreads);
+
+LTFAT_API ltfat_int
+ltfat_dgt_getpar_nthreads(ltfat_dgt_params* params);
+
 /** Destroy struct
  *
  * \returns
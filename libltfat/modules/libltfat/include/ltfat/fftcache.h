@@ -0,0 +1,58 @@
+#ifndef _LTFAT_FFTCACHE_H
+#define _LTFAT_FFTCACHE_H
+
+/** \defgroup fftcache FFT plan cache
+ *
+ * When the cache is enabled, plans released by the fft_done(), ifft_done(),
+ * fftreal_done() and ifftreal_done() functions are not destroyed
+ * immediately, but are kept in a process-wide cache. A subsequent *_init
+ * call with the same length, number of channels, direction, precision,
+ * in-placeness and flags (and, with FFTW, array alignment) takes the plan
+ * from the cache instead of creating a new one.
+ * With FFTW this skips the planner, with KISS FFT the twiddle factor tables
+ * are reused.
+ *
+ * The cache holds idle plans only, a plan is never shared by two live
+ * objects. All functions are thread-safe.
+ *
+ * The cache is disabled by default, it is enabled by
+ * ltfat_fftcache_setcapacity(). Since the cached FFTW plans are not
+ * destroyed by the *_done functions, ltfat_fftcache_clear() must be
+ * called before fftw_cleanup() or fftwf_cleanup(). Otherwise the cache
+ * keeps plans which are no longer valid.
+ *
+ * \addtogroup fftcache
+ * @{
+ */
+
+/** Set the maximum number of idle plans kept in the cache
+ *
+ * When the cache is full, the least recently released plan is destroyed.
+ * The default capacity is 0, i.e. the cache is disabled. Passing 0
+ * destroys all cached plans and disables the cache.
+ *
+ * \returns
+ * Status code          |  Description
+ * ---------------------|----------------
+ * LTFATERR_SUCCESS     |  No error occured
+ * LTFATERR_BADARG      |  \a capacity was negative
+ * LTFATERR_NOMEM       |  Heap allocation failed
+ */
+LTFAT_API int
+ltfat_fftcache_setcapacity(ltfat_int capacity);
+
+/** Number of idle plans currently held in the cache
+ */
+LTFAT_API ltfat_int
+ltfat_fftcache_getcount(void);
+
+/** Destroy all plans held in the cache
+ *
+ * \returns LTFATERR_SUCCESS
+ */
+LTFAT_API int
+ltfat_fftcache_clear(void);
+
+/** @} */
+
+#endif
@@ -77,3 +77,32 @@ LTFAT_NAME(ifftreal_execute_newarray)(LTFAT_NAME(ifftreal_plan)* p,
 
 LTFAT_API int
 LTFAT_NAME(ifftreal_done)(LTFAT_NAME(ifftreal_plan)** p);
+
+/** Import FFTW wisdom from a file
+ *
+ * Plans created afterwards (also with FFTW_MEASURE or FFTW_PATIENT) can use
+ * the imported wisdom and skip the measurement.
+ *
+ * \returns
+ * Status code           |  Description
+ * ----------------------|----------------
+ * LTFATERR_SUCCESS      |  No error occured
+ * LTFATERR_NULLPOINTER  |  \a filename was NULL
+ * LTFATERR_FAILED       |  The file could not be read or parsed
+ * LTFATERR_NOTSUPPORTED |  libltfat was compiled without FFTW
+ */
+LTFAT_API int
+LTFAT_NAME(fft_wisdom_import)(const char* filename);
+
+/** Export accumulated FFTW wisdom to a file
+ *
+ * \returns
+ * Status code           |  Description
+ * ----------------------|----------------
+ * LTFATERR_SUCCESS      |  No error occured
+ * LTFATERR_NULLPOINTER  |  \a filename was NULL
+ * LTFATERR_FAILED       |  The file could not be written
+ * LTFATERR_NOTSUPPORTED |  libltfat was compiled without FFTW
+ */
+LTFAT_API int
+LTFAT_NAME(fft_wisdom_export)(const char* filename);
@@ -7,6 +7,13 @@ typedef enum
     CZT_NEXTPOW2
 } czt_ffthint;
 
+typedef enum
+{
+    CZT_AUTO,   //!< Choose the faster of the two by timing them
+    CZT_DIRECT, //!< Bluestein algorithm with one FFT of length >= L + K - 1
+    CZT_FAC     //!< ceil(L/K) FFTs of length >= 2K - 1
+} czt_method;
+
 #endif
 
 
@@ -35,6 +42,85 @@ LTFAT_NAME(gga_execute)(LTFAT_NAME(gga_plan) p,
                         ltfat_int W,
                         LTFAT_COMPLEX *cPtr);
 
+/** Set number of threads used by gga_execute
+ *
+ * The frequencies are split into blocks of 64 and the blocks of all
+ * W channels are distributed among \a nthreads threads. The output is
+ * identical to the single-threaded execution.
+ *
+ * \param[in]         p  GGA plan
+ * \param[in]  nthreads  Number of threads. 1 means serial execution, 0 means
+ *                       one thread per processor.
+ *
+ * \returns
+ * Status code              | Description
+ * -------------------------|--------------------------------------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | p was NULL.
+ * LTFATERR_BADARG          | nthreads was negative.
+ * LTFATERR_NOMEM           | Heap allocation failed.
+ * LTFATERR_INITFAILED      | Thread creation failed.
+ */
+LTFAT_API int
+LTFAT_NAME(gga_set_nthreads)(LTFAT_NAME(gga_plan) p, ltfat_int nthreads);
+
+/*
+Sliding Goertzel algorithm
+*/
+typedef struct LTFAT_NAME(gga_sliding_plan) LTFAT_NAME(gga_sliding_plan);
+
+/** Create a sliding GGA plan
+ *
+ * The plan keeps the last \a L samples of a stream and updates the
+ * bins of this window with O(M) operations per sample. The bins are
+ * those of gga() with the same \a indVecPtr and \a L; the window is
+ * zero before the first sample. The bins are recomputed from the window
+ * every 16*L samples to bound the accumulation of rounding errors.
+ *
+ * \param[in]  indVecPtr  Frequency indices, length M
+ * \param[in]          M  Number of frequencies
+ * \param[in]          L  Window length
+ * \param[out]         p  Sliding GGA plan
+ *
+ * \returns
+ * Status code              | Description
+ * -------------------------|--------------------------------------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | indVecPtr or p was NULL.
+ * LTFATERR_NOTPOSARG       | M or L was not positive.
+ * LTFATERR_NOMEM           | Heap allocation failed.
+ */
+LTFAT_API int
+LTFAT_NAME(gga_sliding_init)(const LTFAT_REAL* indVecPtr, ltfat_int M,
+                             ltfat_int L, LTFAT_NAME(gga_sliding_plan)** p);
+
+/** Push samples and get the bins of the last L samples
+ *
+ * \param[in]  p   Sliding GGA plan
+ * \param[in]  f   New samples, length Lb
+ * \param[in]  Lb  Number of new samples, can be 0
+ * \param[out] c   Bins after the last sample, length M
+ *
+ * \returns
+ * Status code              | Description
+ * -------------------------|--------------------------------------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | One of the arguments was NULL.
+ * LTFATERR_BADARG          | Lb was negative.
+ */
+LTFAT_API int
+LTFAT_NAME(gga_sliding_execute)(LTFAT_NAME(gga_sliding_plan)* p,
+                                const LTFAT_TYPE f[], ltfat_int Lb,
+                                LTFAT_COMPLEX c[]);
+
+/** Clear the window
+ */
+LTFAT_API int
+LTFAT_NAME(gga_sliding_reset)(LTFAT_NAME(gga_sliding_plan)* p);
+
+LTFAT_API int
+LTFAT_NAME(gga_sliding_done)(LTFAT_NAME(gga_sliding_plan)** p);
+
 
 /*
 Chirped Z transform
@@ -60,6 +146,64 @@ LTFAT_NAME(chzt_init)(ltfat_int K, ltfat_int L,
 LTFAT_API
 void LTFAT_NAME(chzt_done)(LTFAT_NAME(chzt_plan) p);
 
+/** Create a chirp-z transform plan for batches of signals
+ *
+ * The plan computes K samples of the z-transform along the unit circle
+ * starting at angle \a o with step \a deltao, like chzt() and chzt_fac().
+ *
+ * The chirp tables are shared by all the plans created with the same
+ * K, L, deltao, o, hint and method and they are kept in a process-wide
+ * cache after the last plan using them is destroyed. Together with the
+ * FFT plan cache (see \ref fftcache), creating a plan with previously
+ * used parameters does not compute any tables.
+ *
+ * chzt_execute() and chzt_fac_execute() transform \a Wb signals with
+ * a single multi-column FFT. W is best a multiple of \a Wb.
+ *
+ * With CZT_AUTO, both methods are timed on \a Wb zero signals and the
+ * faster one is used. The choice is remembered for the same K, L, Wb,
+ * hint and fftw_flags.
+ *
+ * \param[in]          K  Number of output samples
+ * \param[in]          L  Signal length
+ * \param[in]     deltao  Angle step
+ * \param[in]          o  Starting angle
+ * \param[in]         Wb  Number of signals per FFT call
+ * \param[in] fftw_flags  FFTW planning flags
+ * \param[in]       hint  FFT length choice
+ * \param[in]     method  Algorithm
+ * \param[out]         p  Plan, destroy with chzt_done()
+ *
+ * \returns
+ * Status code              | Description
+ * -------------------------|--------------------------------------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | p was NULL.
+ * LTFATERR_NOTPOSARG       | K, L or Wb was not positive.
+ * LTFATERR_CANNOTHAPPEN    | method is not a valid czt_method value.
+ * LTFATERR_NOMEM           | Heap allocation failed.
+ * LTFATERR_INITFAILED      | FFT plan creation failed.
+ */
+LTFAT_API int
+LTFAT_NAME(chzt_init_batch)(ltfat_int K, ltfat_int L, LTFAT_REAL deltao,
+                            LTFAT_REAL o, ltfat_int Wb, unsigned fftw_flags,
+                            czt_ffthint hint, czt_method method,
+                            LTFAT_NAME(chzt_plan)* p);
+
+/** Algorithm used by the plan
+ *
+ * \returns CZT_DIRECT, CZT_FAC or LTFATERR_NULLPOINTER
+ */
+LTFAT_API int
+LTFAT_NAME(chzt_get_method)(LTFAT_NAME(chzt_plan) p);
+
+/** Destroy the idle chirp tables and forget the CZT_AUTO choices
+ *
+ * \returns LTFATERR_SUCCESS
+ */
+LTFAT_API int
+LTFAT_NAME(chzt_cache_clear)(void);
+
 
 
 
@@ -1,8 +1,34 @@
+#ifndef _LTFAT_HEAP_H
+#define _LTFAT_HEAP_H
+
+typedef enum
+{
+    LTFAT_HEAP_BINARY, //!< Binary max-heap, exact ordering
+    LTFAT_HEAP_BUCKET  //!< Buckets of 1/8 of an octave of the values,
+                       //!< LIFO order within a bucket
+} ltfat_heap_type;
+
+#endif
+
 typedef struct LTFAT_NAME(heap) LTFAT_NAME(heap);
 
 LTFAT_API LTFAT_NAME(heap)*
 LTFAT_NAME(heap_init)(ltfat_int initmaxsize, const LTFAT_REAL* s);
 
+/** Heap of indices to s ordered by the values of s
+ *
+ * The bucket heap does O(1) work per operation and does not read s when
+ * extracting, but the order is only approximate. The buckets are uniform
+ * in the log domain, 1/8 of an octave wide, i.e. the extracted value is at
+ * least about 2^(-1/8) = 0.917 times the maximum (0.75 dB for magnitudes).
+ * The values must be on a linear scale, all values below the smallest
+ * positive normal float share a single bucket. Use the binary heap for
+ * log-magnitudes. Returns NULL if the allocation failed.
+ */
+LTFAT_API LTFAT_NAME(heap)*
+LTFAT_NAME(heap_initwithtype)(ltfat_int initmaxsize, const LTFAT_REAL* s,
+                              ltfat_heap_type type);
+
 LTFAT_API const LTFAT_REAL*
 LTFAT_NAME(heap_getdataptr)(LTFAT_NAME(heap)* h);
 
@@ -40,6 +40,12 @@ LTFAT_API int
 LTFAT_NAME(maxtree_findmax)(
     LTFAT_NAME(maxtree)* p, LTFAT_REAL* max, ltfat_int* maxPos);
 
+// Finds up to n largest values, sorted in descending order
+LTFAT_API int
+LTFAT_NAME(maxtree_findmaxn)(
+    LTFAT_NAME(maxtree)* p, ltfat_int n, LTFAT_REAL max[], ltfat_int maxPos[],
+    ltfat_int* found);
+
 LTFAT_API int
 LTFAT_NAME(maxtree_done)(LTFAT_NAME(maxtree)** p);
 
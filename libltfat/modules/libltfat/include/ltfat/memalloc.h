@@ -36,7 +36,7 @@ typedef struct
 /** Set custom malloc/free functions
  \returns Old malloc/free
  */
-ltfat_memory_handler_t
+LTFAT_API ltfat_memory_handler_t
 ltfat_set_memory_handler (ltfat_memory_handler_t new_handler);
 
 /** Allocate memory block
@@ -153,6 +153,165 @@ void  ltfat_free(const void *ptr);
 LTFAT_API
 void  ltfat_safefree(const void *ptr);
 
+/** \defgroup arena Arena allocation
+ *
+ * An arena is a user provided memory block from which ltfat_malloc()
+ * allocates instead of the heap. It allows placing everything a plan
+ * needs into a single pre-sized block (e.g. to pack many plans densely)
+ * and guarantees that nothing is allocated from the heap once the plan
+ * is initialized, provided the execute function of the plan does not
+ * allocate itself.
+ *
+ * The required size is obtained by running the initialization once in
+ * the measuring mode:
+ *
+ * \code
+ * size_t size;
+ * ltfat_arena* arena = NULL;
+ * ltfat_dgtreal_plan_d* plan = NULL;
+ *
+ * ltfat_arena_measure_begin();
+ * ltfat_dgtreal_init_d(g, gl, L, W, a, M, f, c, params, &plan);
+ * ltfat_dgtreal_done_d(&plan);
+ * ltfat_arena_measure_end(&size);
+ *
+ * void* mem = malloc(size);
+ * ltfat_arena_init(mem, size, &arena);
+ *
+ * ltfat_arena_begin(arena);
+ * ltfat_dgtreal_init_d(g, gl, L, W, a, M, f, c, params, &plan);
+ * ltfat_arena_end();
+ *
+ * ltfat_dgtreal_execute_ana_d(plan); // No heap allocation
+ *
+ * // Either call done with the arena active or just drop the plan
+ * ltfat_arena_reset(arena); // or free(mem)
+ * \endcode
+ *
+ * Functions without a plan (e.g. ltfat_gabreassign_d()) can be called
+ * between ltfat_arena_begin() and ltfat_arena_end() in the same way. The
+ * temporary buffers are then taken from the arena and ltfat_arena_reset()
+ * makes the space available again.
+ *
+ * \note The arena state is per thread. Memory allocated by worker threads
+ * (e.g. the ltfat_threadpool) and by FFTW internally is not taken from
+ * the arena. Plans initialized in an arena do not use the FFT plan
+ * cache.
+ *
+ * \warning ltfat_free() ignores arena memory only while the arena is
+ * active. The done function of a plan initialized in an arena must
+ * therefore be called between ltfat_arena_begin() and ltfat_arena_end()
+ * or not at all.
+ *
+ * \addtogroup arena
+ * @{
+ */
+
+typedef struct ltfat_arena ltfat_arena;
+
+/** Start measuring the arena size
+ *
+ * All ltfat_malloc() calls in the calling thread until
+ * ltfat_arena_measure_end() are counted. The memory is still allocated from
+ * the heap.
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_FAILED       | An arena or the measuring is already active
+ */
+LTFAT_API int
+ltfat_arena_measure_begin(void);
+
+/** Stop measuring the arena size
+ *
+ * \param[out] size  Size of a memory block for ltfat_arena_init() which
+ *                   can hold all the allocations done since
+ *                   ltfat_arena_measure_begin()
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | \a size was NULL
+ * LTFATERR_FAILED       | ltfat_arena_measure_begin() was not called
+ */
+LTFAT_API int
+ltfat_arena_measure_end(size_t* size);
+
+/** Create an arena in a memory block
+ *
+ * The arena header is placed in the block itself, nothing is allocated.
+ * The block must outlive everything allocated from the arena.
+ * The allocations are aligned to 64 bytes.
+ *
+ * \param[in]  mem    Memory block
+ * \param[in]  size   Size of the block in bytes
+ * \param[out] arena  Arena
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | \a mem or \a arena was NULL
+ * LTFATERR_BADSIZE      | The block cannot hold even the arena header
+ */
+LTFAT_API int
+ltfat_arena_init(void* mem, size_t size, ltfat_arena** arena);
+
+/** Make ltfat_malloc() allocate from the arena in the calling thread
+ *
+ * ltfat_malloc() returns NULL when the arena is full. Arenas cannot be
+ * nested.
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | \a arena was NULL
+ * LTFATERR_FAILED       | An arena or the measuring is already active
+ */
+LTFAT_API int
+ltfat_arena_begin(ltfat_arena* arena);
+
+/** Switch ltfat_malloc() back to the heap
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_FAILED       | No arena is active in the calling thread
+ */
+LTFAT_API int
+ltfat_arena_end(void);
+
+/** Release everything allocated from the arena
+ *
+ * Plans initialized in the arena become invalid.
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | \a arena was NULL
+ */
+LTFAT_API int
+ltfat_arena_reset(ltfat_arena* arena);
+
+/** Number of bytes allocated from the arena
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | \a arena or \a used was NULL
+ */
+LTFAT_API int
+ltfat_arena_get_used(const ltfat_arena* arena, size_t* used);
+
+/** @} */
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,7 @@ typedef LTFAT_NAME(rtdgtreal_plan) LTFAT_NAME(rtidgtreal_plan);
 int
 LTFAT_NAME(rtdgtreal_commoninit)(const LTFAT_REAL* g, ltfat_int gl,
                                  ltfat_int M, const rtdgt_phasetype ptype,
+                                 ltfat_int Wmax,
                                  const  ltfat_transformdirection tradir,
                                  LTFAT_NAME(rtdgtreal_plan)** p);
 
@@ -43,6 +44,26 @@ LTFAT_NAME(rtdgtreal_init)(const LTFAT_REAL g[], ltfat_int gl,
                            ltfat_int M, const rtdgt_phasetype ptype,
                            LTFAT_NAME(rtdgtreal_plan)** p);
 
+/** Create RTDGTREAL plan transforming several channels at once
+ *
+ * Up to \a Wmax channels are windowed directly to a multi-column buffer
+ * and transformed by a single FFT call. rtdgtreal_init() is equal to
+ * \a Wmax = 1.
+ *
+ * \param[in]  g      Window
+ * \param[in]  gl     Window length
+ * \param[in]  M      Number of FFT channels
+ * \param[in]  ptype  Phase convention
+ * \param[in]  Wmax   Number of channels per FFT call
+ *
+ * \note rtdgtreal_execute() with W not divisible by \a Wmax runs the last
+ * FFT call over all \a Wmax columns anyway.
+ */
+LTFAT_API int
+LTFAT_NAME(rtdgtreal_init_batch)(const LTFAT_REAL g[], ltfat_int gl,
+                                 ltfat_int M, const rtdgt_phasetype ptype,
+                                 ltfat_int Wmax, LTFAT_NAME(rtdgtreal_plan)** p);
+
 /** Execute RTDGTREAL plan
  * \param[in]  p      RTDGTREAL plan
  * \param[in]  f      Input buffer (gl x W)
@@ -77,6 +98,21 @@ LTFAT_NAME(rtidgtreal_init)(const LTFAT_REAL g[], ltfat_int gl,
                             ltfat_int M, const rtdgt_phasetype ptype,
                             LTFAT_NAME(rtdgtreal_plan)** p);
 
+/** Create RTIDGTREAL plan transforming several channels at once
+ *
+ * \param[in]  g      Window
+ * \param[in]  gl     Window length
+ * \param[in]  M      Number of FFT channels
+ * \param[in]  ptype  Phase convention
+ * \param[in]  Wmax   Number of channels per FFT call
+ *
+ * \see rtdgtreal_init_batch
+ */
+LTFAT_API int
+LTFAT_NAME(rtidgtreal_init_batch)(const LTFAT_REAL g[], ltfat_int gl,
+                                  ltfat_int M, const rtdgt_phasetype ptype,
+                                  ltfat_int Wmax, LTFAT_NAME(rtdgtreal_plan)** p);
+
 /** Execute RTIDGTREAL plan
  * \param[in]  p      RTDGTREAL plan
  * \param[int] c      Input DGT coefficients (M2 x W)
@@ -342,6 +378,52 @@ LTFAT_NAME(rtdgtreal_processor_execute_gen_compact)(
     LTFAT_NAME(rtdgtreal_processor_state)* p, const LTFAT_REAL* in,
     ltfat_int inLen, ltfat_int chanNo, ltfat_int outLen, LTFAT_REAL* out);
 
+/** Process interleaved samples
+ *
+ * Works exactly like rtdgtreal_processor_execute except that the buffers
+ * hold \a len frames of \a chanNo interleaved samples of format \a fmt,
+ * as delivered by most audio APIs. The samples are converted and
+ * (de)interleaved while being moved in and out of the internal FIFOs, so
+ * no extra pass over the buffers is needed. The function can run inplace
+ * i.e. in==out.
+ *
+ * \param[in]      p  DGTREAL processor
+ * \param[in]    fmt  Sample format of \a in and \a out
+ * \param[in]     in  Input frames
+ * \param[in]    len  Number of frames
+ * \param[in] chanNo  Number of channels
+ * \param[out]   out  Output frames
+ *
+ * #### Function versions #
+ * <tt>
+ * ltfat_rtdgtreal_processor_execute_interleaved_d(ltfat_rtdgtreal_processor_state_d* p,
+ *                                                 ltfat_sampleformat fmt, const void* in,
+ *                                                 ltfat_int len, ltfat_int chanNo, void* out);
+ *
+ * ltfat_rtdgtreal_processor_execute_interleaved_s(ltfat_rtdgtreal_processor_state_s* p,
+ *                                                 ltfat_sampleformat fmt, const void* in,
+ *                                                 ltfat_int len, ltfat_int chanNo, void* out);
+ * </tt>
+ *
+ * \returns
+ * Status code           |  Description
+ * ----------------------|----------------------
+ * LTFATERR_SUCCESS      |  No error occured
+ * LTFATERR_NULLPOINTER  |  One of \a p, \a in, \a out was NULL
+ * LTFATERR_BADARG       |  \a fmt was not a valid value from ltfat_sampleformat
+ * LTFATERR_OVERFLOW     |  Too many channels or samples, the rest was ignored
+ */
+LTFAT_API int
+LTFAT_NAME(rtdgtreal_processor_execute_interleaved)(
+    LTFAT_NAME(rtdgtreal_processor_state)* p, ltfat_sampleformat fmt,
+    const void* in, ltfat_int len, ltfat_int chanNo, void* out);
+
+LTFAT_API int
+LTFAT_NAME(rtdgtreal_processor_execute_gen_interleaved)(
+    LTFAT_NAME(rtdgtreal_processor_state)* p, ltfat_sampleformat fmt,
+    const void* in, ltfat_int inLen, ltfat_int chanNo, ltfat_int outLen,
+    void* out);
+
 
 /** Destroy DGTREAL processor state
  * \param[in]  p      DGTREAL processor
@@ -389,6 +471,79 @@ LTFAT_NAME(rtdgtreal_processor_setcallback)(LTFAT_NAME(rtdgtreal_processor_state
         LTFAT_NAME(rtdgtreal_processor_callback)* callback,
         void* userdata);
 
+/** Block processor callback signature
+ *
+ * Receives K consecutive frames of all channels at once. The frames of each
+ * channel are stored one after the other, i.e. frame k of channel w starts
+ * at in[k*M2 + w*M2*K].
+ *
+ * It is safe to assume that out and in are not aliased.
+ *
+ * \param[in]  userdata   User defined data
+ * \param[in]        in   Input coefficients, M2 x K x W array
+ * \param[in]        M2   Number of unique FFT channels; equals to M/2 + 1
+ * \param[in]         K   Number of frames, 1 <= K <= Kmax
+ * \param[in]         W   Number of channels
+ * \param[out]      out   Output coefficients, M2 x K x W array
+ *
+ *  #### Function versions #
+ *  <tt>
+ *  typedef void ltfat_rtdgtreal_processor_blockcallback_d(void* userdata, const ltfat_complex_d in[],
+ *                                                         int M2, int K, int W, ltfat_complex_d out[]);
+ *
+ *  typedef void ltfat_rtdgtreal_processor_blockcallback_s(void* userdata, const ltfat_complex_s in[],
+ *                                                         int M2, int K, int W, ltfat_complex_s out[]);
+ *  </tt>
+ */
+typedef void LTFAT_NAME(rtdgtreal_processor_blockcallback)(void* userdata,
+        const LTFAT_COMPLEX in[], int M2, int K, int W, LTFAT_COMPLEX out[]);
+
+/** Set DGTREAL processor block callback
+ *
+ * When a long buffer is passed to the execute function, up to \a Kmax
+ * pending frames are transformed by one FFT call, processed by one call
+ * of the block callback and transformed back by one IFFT call.
+ * Setting \a callback to NULL switches back to the frame callback set by
+ * rtdgtreal_processor_setcallback(), which is then called for each of the
+ * frames of the block.
+ *
+ * Changing \a Kmax re-creates the FFT plans. The function is not thread safe
+ * and it is not meant to be called from the audio loop.
+ *
+ * \param[in]            p   DGTREAL processor state
+ * \param[in]     callback   Custom function to process blocks of coefficients
+ * \param[in]     userdata   Custom callback data. Will be passed to the callback.
+ * \param[in]         Kmax   Maximum number of frames in a block
+ *
+ * \note The FFTs always run over Kmax frames, even if less frames are
+ * pending. \a Kmax should therefore be close to bufLen/a of the typical
+ * buffer length.
+ *
+ * #### Function versions #
+ * <tt>
+ * ltfat_rtdgtreal_processor_setblockcallback_d(ltfat_rtdgtreal_processor_state_d* p,
+ *                                              ltfat_rtdgtreal_processor_blockcallback_d* callback,
+ *                                              void* userdata, ltfat_int Kmax);
+ *
+ * ltfat_rtdgtreal_processor_setblockcallback_s(ltfat_rtdgtreal_processor_state_s* p,
+ *                                              ltfat_rtdgtreal_processor_blockcallback_s* callback,
+ *                                              void* userdata, ltfat_int Kmax);
+ * </tt>
+ *
+ * \returns
+ * Status code           |  Description
+ * ----------------------|----------------------
+ * LTFATERR_SUCCESS      |  No error occured
+ * LTFATERR_NULLPOINTER  |  \a p was NULL
+ * LTFATERR_NOTPOSARG    |  \a Kmax was less or equal to zero
+ * LTFATERR_NOMEM        |  Heap memory allocation failed
+ */
+LTFAT_API int
+LTFAT_NAME(rtdgtreal_processor_setblockcallback)(
+    LTFAT_NAME(rtdgtreal_processor_state)* p,
+    LTFAT_NAME(rtdgtreal_processor_blockcallback)* callback,
+    void* userdata, ltfat_int Kmax);
+
 /** Default processor callback
  *
  * The callback just copies data from input to the output.
@@ -0,0 +1,118 @@
+/* \defgroup segdgtrealmp Segmented parallel Matching Pursuit with Multi-Gabor Dictionaries
+*/
+#ifndef _LTFAT_SEGDGTREALMP_H
+#define _LTFAT_SEGDGTREALMP_H
+
+
+#endif
+
+typedef struct LTFAT_NAME(segdgtrealmp_state) LTFAT_NAME(segdgtrealmp_state);
+
+/* \addtogroup segdgtrealmp
+ * @{ */
+
+/** Initialize the segmented DGTREAL Matching Pursuit state
+ *
+ * The signal is split into non-overlapping regions of length approx. \a seglen
+ * which are decomposed concurrently, each one zero-padded by a guard interval
+ * longer than the longest window. In the second pass, the residual around
+ * the region borders is decomposed again (also concurrently) such that atoms
+ * straddling the borders are recovered. The coefficients of both passes are
+ * merged into a single set of coefficients of a length \a L transform.
+ *
+ * All parameters (target SNR, algorithm, phase convention, ...) are taken
+ * from \a pb. The target SNR is enforced in each region and the maximum number
+ * of atoms and iterations, if set, are distributed among the regions
+ * proportionally to their length. If \a L is too short to be split into at
+ * least 3 regions, the signal is decomposed by a single dgtrealmp_state.
+ *
+ * \param[in]        pb  Parameter buffer
+ * \param[in]         L  Signal length, see dgtrealmp_getparbuf_siglen()
+ * \param[in]    seglen  Desired region length
+ * \param[in]  nthreads  Number of threads. 0 uses all processors.
+ * \param[out]        p  Segmented DGTREALMP state
+ *
+ * #### Versions #
+ * <tt>
+ * ltfat_segdgtrealmp_init_d( ltfat_dgtrealmp_parbuf_d* pb, ltfat_int L,
+ *                            ltfat_int seglen, ltfat_int nthreads,
+ *                            ltfat_segdgtrealmp_state_d** p);
+ *
+ * ltfat_segdgtrealmp_init_s( ltfat_dgtrealmp_parbuf_s* pb, ltfat_int L,
+ *                            ltfat_int seglen, ltfat_int nthreads,
+ *                            ltfat_segdgtrealmp_state_s** p);
+ * </tt>
+ * \returns
+ * Status code              | Description
+ * -------------------------|------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | At least one of the following was NULL: \a pb, \a p
+ * LTFATERR_BADTRALEN       | \a L is not compatible with the dictionaries
+ * LTFATERR_NOTPOSARG       | \a seglen was not positive
+ * LTFATERR_NOMEM           | Indicates that heap allocation failed
+ */
+LTFAT_API int
+LTFAT_NAME(segdgtrealmp_init)(
+    LTFAT_NAME(dgtrealmp_parbuf)* pb, ltfat_int L, ltfat_int seglen,
+    ltfat_int nthreads, LTFAT_NAME(segdgtrealmp_state)** p);
+
+/** Execute segmented DGTREAL Matching Pursuit
+ *
+ * \param[in,out]    p Segmented DGTREALMP state
+ * \param[in]        f Input signal, array of length L
+ * \param[out]    cout Output coefficients, array of length equal to the number of dictionaries
+ * \param[out]    fout Output signal, array of length L
+ *
+ * The layout of \a cout is the same as in dgtrealmp_execute().
+ *
+ * #### Versions #
+ * <tt>
+ * ltfat_segdgtrealmp_execute_d( ltfat_segdgtrealmp_state_d* p, const double f[],
+ *                               ltfat_complex_d* cout[], double fout[]);
+ *
+ * ltfat_segdgtrealmp_execute_s( ltfat_segdgtrealmp_state_s* p, const float f[],
+ *                               ltfat_complex_s* cout[], float fout[]);
+ * </tt>
+ * \returns
+ * LTFAT_DGTREALMP_STATUS_TOLREACHED if the target SNR was reached for the whole
+ * signal, otherwise the most severe exit status of the individual regions,
+ * or a negative error code.
+ */
+LTFAT_API int
+LTFAT_NAME(segdgtrealmp_execute)(
+    LTFAT_NAME(segdgtrealmp_state)* p, const LTFAT_REAL f[],
+    LTFAT_COMPLEX* cout[], LTFAT_REAL fout[]);
+
+/** Delete the segmented DGTREAL Matching Pursuit state
+ *
+ * \returns
+ * Status code              | Description
+ * -------------------------|------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | \a p or \a *p was NULL
+ */
+LTFAT_API int
+LTFAT_NAME(segdgtrealmp_done)(LTFAT_NAME(segdgtrealmp_state)** p);
+
+/** Get the approximation error of the last execution in dB
+ */
+LTFAT_API int
+LTFAT_NAME(segdgtrealmp_get_errdb)(
+    const LTFAT_NAME(segdgtrealmp_state)* p, double* err);
+
+/** Get the total number of atoms selected during the last execution
+ */
+LTFAT_API int
+LTFAT_NAME(segdgtrealmp_get_numatoms)(
+    const LTFAT_NAME(segdgtrealmp_state)* p, size_t* atoms);
+
+/** Get the number of regions the signal is split into
+ *
+ * \returns Number of regions (1 if no segmentation takes place) or a negative
+ * error code
+ */
+LTFAT_API ltfat_int
+LTFAT_NAME(segdgtrealmp_get_segno)(
+    const LTFAT_NAME(segdgtrealmp_state)* p);
+
+/** @} */
@@ -0,0 +1,53 @@
+#ifndef _LTFAT_SIMD_H
+#define _LTFAT_SIMD_H
+
+/** \addtogroup utils
+ * @{
+ */
+
+/** Instruction set used by the explicitly vectorized kernels
+ *
+ * The kernels (the accumulation in fold_array and the Goertzel recursion
+ * in gga_execute) are compiled for all the listed instruction sets and the
+ * best one supported by the CPU is selected at runtime. LTFAT_SIMD_NONE
+ * selects the plain C loops, which serve as the reference implementation.
+ */
+typedef enum
+{
+    LTFAT_SIMD_NONE   = 0,
+    LTFAT_SIMD_SSE2   = 1,
+    LTFAT_SIMD_AVX2   = 2,
+    LTFAT_SIMD_AVX512 = 3
+} ltfat_simd_level;
+
+/** Get the instruction set currently used by the vectorized kernels
+ */
+LTFAT_API ltfat_simd_level
+ltfat_simd_get_level(void);
+
+/** Get the best instruction set supported both by the CPU and by the
+ * compiler libltfat was built with
+ */
+LTFAT_API ltfat_simd_level
+ltfat_simd_get_maxlevel(void);
+
+/** Override the instruction set used by the vectorized kernels
+ *
+ * The setting is global and it is meant for testing and benchmarking.
+ * It must not be changed while another thread is executing a transform.
+ *
+ * \param[in] level   Instruction set
+ *
+ * \returns
+ * Status code              | Description
+ * -------------------------|--------------------------------------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_CANNOTHAPPEN    | \a level is not a valid ltfat_simd_level value
+ * LTFATERR_NOTSUPPORTED    | \a level is not supported by the CPU
+ */
+LTFAT_API int
+ltfat_simd_set_level(ltfat_simd_level level);
+
+/** @}*/
+
+#endif
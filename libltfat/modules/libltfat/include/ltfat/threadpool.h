@@ -0,0 +1,88 @@
+#ifndef _LTFAT_THREADPOOL_H
+#define _LTFAT_THREADPOOL_H
+
+/** \defgroup threadpool Worker thread pool
+ *
+ * A persistent pool of worker threads used internally by the plans which
+ * support multi-threaded execution. The calling thread always takes part
+ * in the work, so a pool with \a nthreads = 1 does not spawn any thread and
+ * simply runs all the tasks serially.
+ *
+ * No heap allocation is done after ltfat_threadpool_init().
+ *
+ * If libltfat has been compiled with NOTHREADS, all pools behave as if
+ * \a nthreads = 1 was requested.
+ *
+ * \addtogroup threadpool
+ * @{
+ */
+
+typedef struct ltfat_threadpool ltfat_threadpool;
+
+/** Task callback
+ *
+ * \param[in] userdata  Data passed to ltfat_threadpool_execute()
+ * \param[in]   taskid  Index of the task, 0 <= taskid < ntasks
+ * \param[in] workerid  Index of the worker running the task,
+ *                      0 <= workerid < nthreads. Can be used to
+ *                      select per-worker scratch buffers.
+ */
+typedef void ltfat_threadpool_task(void* userdata, ltfat_int taskid,
+                                   ltfat_int workerid);
+
+/** Create a pool
+ *
+ * \param[in]  nthreads  Number of threads including the calling one.
+ *                       Pass 0 to use all available processors.
+ * \param[out]        p  Pool
+ *
+ * \returns
+ * Status code          |  Description
+ * ---------------------|----------------
+ * LTFATERR_SUCCESS     |  No error occured
+ * LTFATERR_NULLPOINTER |  \a p was NULL
+ * LTFATERR_BADARG      |  \a nthreads was negative
+ * LTFATERR_NOMEM       |  Heap allocation failed
+ * LTFATERR_INITFAILED  |  Thread creation failed
+ */
+LTFAT_API int
+ltfat_threadpool_init(ltfat_int nthreads, ltfat_threadpool** p);
+
+/** Run \a ntasks tasks and wait until all of them are finished
+ *
+ * The tasks are distributed dynamically among the workers. The function
+ * must not be called concurrently on the same pool.
+ *
+ * \returns
+ * Status code          |  Description
+ * ---------------------|----------------
+ * LTFATERR_SUCCESS     |  No error occured
+ * LTFATERR_NULLPOINTER |  \a p or \a task was NULL
+ * LTFATERR_BADARG      |  \a ntasks was negative
+ */
+LTFAT_API int
+ltfat_threadpool_execute(ltfat_threadpool* p, ltfat_int ntasks,
+                         ltfat_threadpool_task* task, void* userdata);
+
+/** Number of threads in the pool including the calling one
+ *
+ * \returns Number of threads or LTFATERR_NULLPOINTER
+ */
+LTFAT_API ltfat_int
+ltfat_threadpool_get_nthreads(ltfat_threadpool* p);
+
+/** Stop the worker threads and destroy the pool
+ */
+LTFAT_API int
+ltfat_threadpool_done(ltfat_threadpool** p);
+
+/** Number of processors available to the process
+ *
+ * Returns 1 if libltfat was compiled with NOTHREADS.
+ */
+LTFAT_API ltfat_int
+ltfat_threadpool_get_nprocs(void);
+
+/** @} */
+
+#endif
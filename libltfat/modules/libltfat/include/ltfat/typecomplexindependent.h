@@ -5,6 +5,7 @@
 #include "dgt_fb.h"
 #include "idgt_fb.h"
 #include "wavelets.h"
+#include "wfbt.h"
 #include "goertzel.h"
 #include "ciutils.h"
 #include "gabdual_painless.h"
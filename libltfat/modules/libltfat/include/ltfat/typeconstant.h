@@ -4,6 +4,9 @@
 #include "memalloc.h"
 #include "dgt_common.h"
 #include "dgtwrapper_typeconstant.h"
+#include "threadpool.h"
+#include "simd.h"
+#include "fftcache.h"
 
 typedef struct
 {
@@ -47,6 +50,17 @@ LTFAT_API ltfat_int
 ltfat_dgtlength(ltfat_int Ls, ltfat_int a, ltfat_int M);
 /** @}*/
 
+/** \addtogroup utils
+ * @{
+ */
+/** Monotonic wall-clock time in seconds
+ *
+ * Only differences of two calls are meaningful.
+ */
+LTFAT_API double
+ltfat_time_monotonic(void);
+/** @}*/
+
 LTFAT_API ltfat_int
 ltfat_pow2base(ltfat_int x);
 
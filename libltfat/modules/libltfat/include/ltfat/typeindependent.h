@@ -15,6 +15,7 @@
 #include "dgtrealwrapper.h"
 #include "dgtrealmp.h"
 #include "slidgtrealmp.h"
+#include "segdgtrealmp.h"
 #include "linalg.h"
 #include "maxtree.h"
 #include "ti_windows.h"
@@ -328,7 +329,8 @@ typedef struct LTFAT_NAME(heapinttask) LTFAT_NAME(heapinttask);
 LTFAT_API LTFAT_NAME(heapinttask)*
 LTFAT_NAME(heapinttask_init)(ltfat_int height, ltfat_int N,
                              ltfat_int initheapsize,
-                             const LTFAT_REAL* s, int do_real);
+                             const LTFAT_REAL* s, int do_real,
+                             ltfat_heap_type heaptype);
 
 LTFAT_API void
 LTFAT_NAME(heapint_execute)(LTFAT_NAME(heapinttask)* hit,
@@ -432,6 +434,54 @@ LTFAT_NAME(maskedheapintreal_relgrad)(const LTFAT_REAL* s,
                                       LTFAT_REAL tol, ltfat_phaseconvention phasetype,
                                       LTFAT_REAL* phase);
 
+/** Tiled heapint for long signals
+ *
+ * Splits the time axis into tiles of \a tileN columns, each extended by
+ * \a overlapN columns on both sides, and integrates the tiles in parallel.
+ * The phase of the neighboring tiles is aligned over the 2*\a overlapN
+ * shared columns. Memory used per thread is proportional to one extended
+ * tile instead of the whole coefficient array. Unlike heapint, the phase
+ * does not wrap around in time.
+ *
+ * \param[in]  tileN     Columns per tile
+ * \param[in]  overlapN  Columns added on each side of a tile, 0 < overlapN <= tileN
+ * \param[in]  nthreads  Number of threads, 0 for all available processors
+ *
+ * The rest of the parameters are the same as in heapint.
+ *
+ * \returns
+ * Status code          |  Description
+ * ---------------------|----------------
+ * LTFATERR_SUCCESS     |  No error occured
+ * LTFATERR_NULLPOINTER |  One of the arrays was NULL
+ * LTFATERR_NOTPOSARG   |  One of a, M, L/a, W, tileN, overlapN was not positive
+ * LTFATERR_BADARG      |  \a overlapN > \a tileN or \a nthreads was negative
+ * LTFATERR_NOMEM       |  Heap allocation failed
+ */
+LTFAT_API int
+LTFAT_NAME(heapint_tiled)(const LTFAT_REAL *s,
+                          const LTFAT_REAL *tgradw,
+                          const LTFAT_REAL *fgradw,
+                          ltfat_int a, ltfat_int M,
+                          ltfat_int L, ltfat_int W,
+                          LTFAT_REAL tol, ltfat_int tileN,
+                          ltfat_int overlapN, ltfat_int nthreads,
+                          LTFAT_REAL *phase);
+
+/** Tiled heapintreal for long signals
+ *
+ * \see heapint_tiled
+ */
+LTFAT_API int
+LTFAT_NAME(heapintreal_tiled)(const LTFAT_REAL *s,
+                              const LTFAT_REAL *tgradw,
+                              const LTFAT_REAL *fgradw,
+                              ltfat_int a, ltfat_int M,
+                              ltfat_int L, ltfat_int W,
+                              LTFAT_REAL tol, ltfat_int tileN,
+                              ltfat_int overlapN, ltfat_int nthreads,
+                              LTFAT_REAL *phase);
+
 LTFAT_API void
 LTFAT_NAME(filterbankphasegrad)(const LTFAT_COMPLEX* c [],
                                 const LTFAT_COMPLEX* ch[],
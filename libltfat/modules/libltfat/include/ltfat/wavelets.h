@@ -32,6 +32,120 @@ filterbank_td_size(ltfat_int L, ltfat_int a,
 
 // CAN BE INCLUDED MORE THAN ONCE
 
+/** \defgroup convsubtd Time-domain filtering with subsampling
+ *
+ * Planned versions of convsub_td(), upconv_td(), atrousconvsub_td() and
+ * atrousupconv_td(). The plan holds the filter and all the buffers, so
+ * the execute functions do not allocate. The boundary extension is
+ * evaluated only at the signal edges, the rest is a polyphase
+ * multiply-accumulate over contiguous arrays.
+ *
+ * One plan can be used for any number of signals of the same length,
+ * but not from several threads at once.
+ *
+ * \addtogroup convsubtd
+ * @{
+ */
+typedef struct LTFAT_NAME(convsub_td_plan) LTFAT_NAME(convsub_td_plan);
+typedef struct LTFAT_NAME(upconv_td_plan) LTFAT_NAME(upconv_td_plan);
+
+/** Create plan for filtering and subsampling
+ *
+ * The output length is filterbank_td_size(L, a, gl, skip, ext).
+ *
+ * \param[in]  g     Filter, length gl
+ * \param[in]  L     Signal length
+ * \param[in]  gl    Filter length
+ * \param[in]  a     Subsampling factor
+ * \param[in]  skip  Filter delay
+ * \param[in]  ext   Boundary extension
+ * \param[out] p     Plan
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | \a g or \a p was NULL
+ * LTFATERR_NOTPOSARG    | \a L, \a gl or \a a was not positive
+ * LTFATERR_BADARG       | Invalid \a ext
+ * LTFATERR_NOMEM        | Memory allocation failed
+ */
+LTFAT_API int
+LTFAT_NAME(convsub_td_init)(const LTFAT_TYPE g[], ltfat_int L, ltfat_int gl,
+                            ltfat_int a, ltfat_int skip, ltfatExtType ext,
+                            LTFAT_NAME(convsub_td_plan)** p);
+
+/** Create plan for the undecimated filtering with a dilated filter
+ *
+ * The output length is L.
+ *
+ * \param[in]  ga    Dilation factor of the filter
+ *
+ * The other parameters and return values are as in convsub_td_init.
+ */
+LTFAT_API int
+LTFAT_NAME(atrousconvsub_td_init)(const LTFAT_TYPE g[], ltfat_int L,
+                                  ltfat_int gl, ltfat_int ga, ltfat_int skip,
+                                  ltfatExtType ext,
+                                  LTFAT_NAME(convsub_td_plan)** p);
+
+/** Output length of the plan */
+LTFAT_API ltfat_int
+LTFAT_NAME(convsub_td_get_outlen)(const LTFAT_NAME(convsub_td_plan)* p);
+
+/** Filter and subsample
+ *
+ * \param[in]  p  Plan
+ * \param[in]  f  Input signal, length L
+ * \param[out] c  Output coefficients, can be equal to \a f
+ *
+ * \returns LTFATERR_SUCCESS or LTFATERR_NULLPOINTER
+ */
+LTFAT_API int
+LTFAT_NAME(convsub_td_execute)(const LTFAT_NAME(convsub_td_plan)* p,
+                               const LTFAT_TYPE f[], LTFAT_TYPE c[]);
+
+LTFAT_API int
+LTFAT_NAME(convsub_td_done)(LTFAT_NAME(convsub_td_plan)** p);
+
+/** Create plan for upsampling and filtering
+ *
+ * The plan is the adjoint of the one from convsub_td_init with the same
+ * parameters. The input length is filterbank_td_size(L, a, gl, skip, ext).
+ */
+LTFAT_API int
+LTFAT_NAME(upconv_td_init)(const LTFAT_TYPE g[], ltfat_int L, ltfat_int gl,
+                           ltfat_int a, ltfat_int skip, ltfatExtType ext,
+                           LTFAT_NAME(upconv_td_plan)** p);
+
+/** Adjoint of atrousconvsub_td_init */
+LTFAT_API int
+LTFAT_NAME(atrousupconv_td_init)(const LTFAT_TYPE g[], ltfat_int L,
+                                 ltfat_int gl, ltfat_int ga, ltfat_int skip,
+                                 ltfatExtType ext,
+                                 LTFAT_NAME(upconv_td_plan)** p);
+
+/** Input length of the plan */
+LTFAT_API ltfat_int
+LTFAT_NAME(upconv_td_get_inlen)(const LTFAT_NAME(upconv_td_plan)* p);
+
+/** Upsample, filter and add to the output
+ *
+ * \param[in]     p  Plan
+ * \param[in]     c  Input coefficients
+ * \param[in,out] f  Output signal, length L. The result is added to it.
+ *
+ * \returns LTFATERR_SUCCESS or LTFATERR_NULLPOINTER
+ */
+LTFAT_API int
+LTFAT_NAME(upconv_td_execute)(const LTFAT_NAME(upconv_td_plan)* p,
+                              const LTFAT_TYPE c[], LTFAT_TYPE f[]);
+
+LTFAT_API int
+LTFAT_NAME(upconv_td_done)(LTFAT_NAME(upconv_td_plan)** p);
+
+/** @} */
+
 
 LTFAT_API void
 LTFAT_NAME(extend_left)(const LTFAT_TYPE *in, ltfat_int inLen, LTFAT_TYPE *buffer, ltfat_int buffLen, ltfat_int filtLen, ltfatExtType ext, ltfat_int a);
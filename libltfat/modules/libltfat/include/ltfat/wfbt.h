@@ -0,0 +1,367 @@
+#ifndef _LTFAT_WFBT_H
+#define _LTFAT_WFBT_H
+
+/** Flags of the wavelet filter bank tree plans
+ *
+ * LTFAT_WFBT_PACKETS and LTFAT_WFBT_UNDECIMATED can be combined, at most
+ * one of the interscaling flags can be used and only together with
+ * LTFAT_WFBT_PACKETS.
+ */
+typedef enum
+{
+    LTFAT_WFBT_PACKETS     = 1 << 0, //!< Output all node channels (wpfbt)
+    LTFAT_WFBT_UNDECIMATED = 1 << 1, //!< Undecimated tree (uwfbt)
+    LTFAT_WFBT_INTSCALE    = 1 << 2, //!< Interscaling by 1/2
+    LTFAT_WFBT_INTSQRT     = 1 << 3, //!< Interscaling by 1/sqrt(2)
+} ltfat_wfbt_flags;
+
+#endif
+
+// CAN BE INCLUDED MORE THAN ONCE
+
+/** \defgroup wfbt Wavelet filter bank tree
+ *
+ * The whole tree is planned at once: all time-domain filtering plans and
+ * the buffers for the intermediate subbands are allocated by the init
+ * function, so the execute functions do not allocate. The tree is
+ * described by an array of nodes in breadth-first order, i.e. the parent
+ * of each node (except of the root, which comes first) must come before it.
+ * The transforms fwt(), wfbt(), wpfbt(), uwfbt() and uwpfbt() are all
+ * trees of this kind.
+ *
+ * The outputs (subbands) are numbered by going through the nodes in the
+ * order they were passed and, within a node, through its channels.
+ * Channels with a node attached are skipped unless LTFAT_WFBT_PACKETS is
+ * set. E.g. for the J-level DWT with a two-channel filter bank, where node
+ * j is attached to the first channel of node j-1, the outputs are the
+ * highpass subbands of nodes 0,...,J-2 followed by the lowpass and the
+ * highpass subband of node J-1.
+ *
+ * With several input channels (W > 1), the channels are processed
+ * concurrently by \a nthreads threads.
+ *
+ * \addtogroup wfbt
+ * @{
+ */
+typedef struct LTFAT_NAME(wfbt_plan) LTFAT_NAME(wfbt_plan);
+typedef struct LTFAT_NAME(iwfbt_plan) LTFAT_NAME(iwfbt_plan);
+
+/** Node of the tree
+ *
+ * For the undecimated tree, the filters of a node are dilated by the
+ * product of the subsampling factors on the path from the root and the
+ * offsets are multiplied by the same factor. Any scaling of the filters
+ * (uwfbt() scales them by 1/sqrt(a) by default) must be done by the caller.
+ */
+typedef struct
+{
+    ltfat_int M;               //!< Number of channels
+    const LTFAT_TYPE** g;      //!< Filters, M pointers
+    const ltfat_int* gl;       //!< Filter lengths
+    const ltfat_int* a;        //!< Subsampling factors
+    const ltfat_int* offset;   //!< Filter offsets, as skip in filterbank_td()
+    ltfat_int parent;          //!< Index of the parent node, -1 for the root
+    ltfat_int parentch;        //!< Channel of the parent the node is attached to
+} LTFAT_NAME(wfbt_node);
+
+/** Create plan for the analysis by a filter bank tree
+ *
+ * \param[in]  nodes     Nodes in breadth-first order, analysis filters
+ * \param[in]  nodesNo   Number of nodes
+ * \param[in]  L         Signal length
+ * \param[in]  W         Number of signal channels
+ * \param[in]  ext       Boundary extension
+ * \param[in]  flags     Combination of ltfat_wfbt_flags or 0
+ * \param[in]  nthreads  Number of threads, 0 uses all processors
+ * \param[out] p         Plan
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | \a nodes, \a p or a filter was NULL
+ * LTFATERR_NOTPOSARG    | \a L, \a W, \a nodesNo or a node parameter was not positive
+ * LTFATERR_BADARG       | The nodes do not form a tree, invalid \a ext or \a flags
+ * LTFATERR_NOMEM        | Memory allocation failed
+ */
+LTFAT_API int
+LTFAT_NAME(wfbt_init)(const LTFAT_NAME(wfbt_node) nodes[], ltfat_int nodesNo,
+                      ltfat_int L, ltfat_int W, ltfatExtType ext, int flags,
+                      ltfat_int nthreads, LTFAT_NAME(wfbt_plan)** p);
+
+/** Number of outputs */
+LTFAT_API ltfat_int
+LTFAT_NAME(wfbt_get_outno)(const LTFAT_NAME(wfbt_plan)* p);
+
+/** Length of the output \a m (per signal channel) */
+LTFAT_API ltfat_int
+LTFAT_NAME(wfbt_get_outlen)(const LTFAT_NAME(wfbt_plan)* p, ltfat_int m);
+
+/** Run the analysis
+ *
+ * \param[in]  p  Plan
+ * \param[in]  f  Input signal, L x W
+ * \param[out] c  Output subbands, array of wfbt_get_outno() pointers,
+ *                c[m] has size wfbt_get_outlen(m) x W
+ *
+ * \returns LTFATERR_SUCCESS or LTFATERR_NULLPOINTER
+ */
+LTFAT_API int
+LTFAT_NAME(wfbt_execute)(LTFAT_NAME(wfbt_plan)* p, const LTFAT_TYPE f[],
+                         LTFAT_TYPE* c[]);
+
+LTFAT_API int
+LTFAT_NAME(wfbt_done)(LTFAT_NAME(wfbt_plan)** p);
+
+/** Create plan for the synthesis by a filter bank tree
+ *
+ * The plan is the adjoint of the one from wfbt_init() with the same tree,
+ * the nodes are expected to hold the synthesis filters. The parameters and
+ * return values are as in wfbt_init().
+ */
+LTFAT_API int
+LTFAT_NAME(iwfbt_init)(const LTFAT_NAME(wfbt_node) nodes[], ltfat_int nodesNo,
+                       ltfat_int L, ltfat_int W, ltfatExtType ext, int flags,
+                       ltfat_int nthreads, LTFAT_NAME(iwfbt_plan)** p);
+
+/** Number of inputs */
+LTFAT_API ltfat_int
+LTFAT_NAME(iwfbt_get_inno)(const LTFAT_NAME(iwfbt_plan)* p);
+
+/** Length of the input \a m (per signal channel) */
+LTFAT_API ltfat_int
+LTFAT_NAME(iwfbt_get_inlen)(const LTFAT_NAME(iwfbt_plan)* p, ltfat_int m);
+
+/** Run the synthesis
+ *
+ * \param[in]  p  Plan
+ * \param[in]  c  Input subbands, as the output of wfbt_execute()
+ * \param[out] f  Output signal, L x W
+ *
+ * \returns LTFATERR_SUCCESS or LTFATERR_NULLPOINTER
+ */
+LTFAT_API int
+LTFAT_NAME(iwfbt_execute)(LTFAT_NAME(iwfbt_plan)* p, const LTFAT_TYPE* c[],
+                          LTFAT_TYPE f[]);
+
+LTFAT_API int
+LTFAT_NAME(iwfbt_done)(LTFAT_NAME(iwfbt_plan)** p);
+
+/** @} */
+
+/** \defgroup wfbtstream Streaming wavelet filter bank tree
+ *
+ * Block-wise versions of filterbank_td(), ifilterbank_td() and of the
+ * filter bank trees. The signal is treated as an infinite sequence
+ * starting with the first block, all samples before it being zero.
+ * Any block length up to \a maxLb can be used in each call and the states
+ * keep the filter history between the calls. No heap allocation is done
+ * after the init functions.
+ *
+ * The analysis emits, in every call, the subband coefficients which
+ * depend only on the samples received so far. Coefficient c[n] of a
+ * channel with subsampling factor a and offset skip (which must not be
+ * positive) is emitted once sample a*n - skip has been received.
+ *
+ * The synthesis consumes exactly these coefficients and outputs as many
+ * samples as the analysis received, delayed by a fixed number of samples
+ * returned by the get_delay functions. The output before the delay is
+ * zero. The coefficients equal those of filterbank_td() with the ZERO
+ * extension and the output equals that of ifilterbank_td(), so if these
+ * two reconstruct the signal, the chain of the streaming analysis and
+ * synthesis reproduces the input delayed by exactly that number of samples.
+ *
+ * \addtogroup wfbtstream
+ * @{
+ */
+typedef struct LTFAT_NAME(filterbank_td_stream) LTFAT_NAME(filterbank_td_stream);
+typedef struct LTFAT_NAME(ifilterbank_td_stream) LTFAT_NAME(ifilterbank_td_stream);
+typedef struct LTFAT_NAME(wfbt_stream) LTFAT_NAME(wfbt_stream);
+typedef struct LTFAT_NAME(iwfbt_stream) LTFAT_NAME(iwfbt_stream);
+
+/** Create streaming filter bank analysis state
+ *
+ * \param[in]  g      Filters, M pointers
+ * \param[in]  gl     Filter lengths
+ * \param[in]  a      Subsampling factors
+ * \param[in]  skip   Filter offsets, must not be positive
+ * \param[in]  M      Number of channels
+ * \param[in]  maxLb  Maximum block length
+ * \param[out] p      State
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | One of the arrays or a filter was NULL
+ * LTFATERR_NOTPOSARG    | \a M, \a maxLb, a filter length or \a a was not positive
+ * LTFATERR_BADARG       | \a skip was positive
+ * LTFATERR_NOMEM        | Memory allocation failed
+ */
+LTFAT_API int
+LTFAT_NAME(filterbank_td_stream_init)(const LTFAT_TYPE* g[],
+                                      const ltfat_int gl[], const ltfat_int a[],
+                                      const ltfat_int skip[], ltfat_int M,
+                                      ltfat_int maxLb,
+                                      LTFAT_NAME(filterbank_td_stream)** p);
+
+/** Maximum number of coefficients of channel \a m emitted in one call */
+LTFAT_API ltfat_int
+LTFAT_NAME(filterbank_td_stream_get_maxoutlen)(
+    const LTFAT_NAME(filterbank_td_stream)* p, ltfat_int m);
+
+/** Process one block
+ *
+ * \param[in]  p     State
+ * \param[in]  f     Input block, length \a Lb
+ * \param[in]  Lb    Block length, 0 <= Lb <= maxLb
+ * \param[out] c     Coefficients, M pointers to arrays of at least
+ *                   filterbank_td_stream_get_maxoutlen() elements
+ * \param[out] cLen  Number of coefficients written to each c[m]
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | One of the arguments was NULL
+ * LTFATERR_BADARG       | \a Lb was out of range
+ */
+LTFAT_API int
+LTFAT_NAME(filterbank_td_stream_execute)(LTFAT_NAME(filterbank_td_stream)* p,
+        const LTFAT_TYPE f[], ltfat_int Lb, LTFAT_TYPE* c[], ltfat_int cLen[]);
+
+/** Forget the history, the next block is the start of a new signal */
+LTFAT_API int
+LTFAT_NAME(filterbank_td_stream_reset)(LTFAT_NAME(filterbank_td_stream)* p);
+
+LTFAT_API int
+LTFAT_NAME(filterbank_td_stream_done)(LTFAT_NAME(filterbank_td_stream)** p);
+
+/** Create streaming filter bank synthesis state
+ *
+ * The state computes the adjoint of filterbank_td_stream with the same
+ * parameters, the filters \a g are expected to be the synthesis filters.
+ * The parameters and return values are as in filterbank_td_stream_init().
+ */
+LTFAT_API int
+LTFAT_NAME(ifilterbank_td_stream_init)(const LTFAT_TYPE* g[],
+                                       const ltfat_int gl[], const ltfat_int a[],
+                                       const ltfat_int skip[], ltfat_int M,
+                                       ltfat_int maxLb,
+                                       LTFAT_NAME(ifilterbank_td_stream)** p);
+
+/** Delay of the output in samples, the maximum of (gl[m]-1) */
+LTFAT_API ltfat_int
+LTFAT_NAME(ifilterbank_td_stream_get_delay)(
+    const LTFAT_NAME(ifilterbank_td_stream)* p);
+
+/** Number of coefficients of channel \a m the next call with a block of
+ * length \a Lb consumes */
+LTFAT_API ltfat_int
+LTFAT_NAME(ifilterbank_td_stream_get_inlen)(
+    const LTFAT_NAME(ifilterbank_td_stream)* p, ltfat_int Lb, ltfat_int m);
+
+/** Process one block
+ *
+ * \param[in]  p     State
+ * \param[in]  c     Coefficients, M pointers
+ * \param[in]  cLen  Number of coefficients in each c[m], must be equal to
+ *                   ifilterbank_td_stream_get_inlen()
+ * \param[in]  Lb    Block length, 0 <= Lb <= maxLb
+ * \param[out] f     Output block, length \a Lb
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|--------------------------------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | One of the arguments was NULL
+ * LTFATERR_BADARG       | \a Lb or \a cLen was wrong
+ */
+LTFAT_API int
+LTFAT_NAME(ifilterbank_td_stream_execute)(LTFAT_NAME(ifilterbank_td_stream)* p,
+        const LTFAT_TYPE* c[], const ltfat_int cLen[], ltfat_int Lb,
+        LTFAT_TYPE f[]);
+
+LTFAT_API int
+LTFAT_NAME(ifilterbank_td_stream_reset)(LTFAT_NAME(ifilterbank_td_stream)* p);
+
+LTFAT_API int
+LTFAT_NAME(ifilterbank_td_stream_done)(LTFAT_NAME(ifilterbank_td_stream)** p);
+
+/** Create streaming filter bank tree analysis state
+ *
+ * The tree and \a flags are as in wfbt_init(), the outputs are numbered in
+ * the same way. The offsets must not be positive.
+ *
+ * \param[in]  nodes    Nodes in breadth-first order, analysis filters
+ * \param[in]  nodesNo  Number of nodes
+ * \param[in]  maxLb    Maximum block length
+ * \param[in]  flags    Combination of ltfat_wfbt_flags or 0
+ * \param[out] p        State
+ *
+ * \returns As wfbt_init()
+ */
+LTFAT_API int
+LTFAT_NAME(wfbt_stream_init)(const LTFAT_NAME(wfbt_node) nodes[],
+                             ltfat_int nodesNo, ltfat_int maxLb, int flags,
+                             LTFAT_NAME(wfbt_stream)** p);
+
+/** Number of outputs */
+LTFAT_API ltfat_int
+LTFAT_NAME(wfbt_stream_get_outno)(const LTFAT_NAME(wfbt_stream)* p);
+
+/** Maximum number of coefficients of output \a m emitted in one call */
+LTFAT_API ltfat_int
+LTFAT_NAME(wfbt_stream_get_maxoutlen)(const LTFAT_NAME(wfbt_stream)* p,
+                                      ltfat_int m);
+
+/** Process one block
+ *
+ * The arguments are as in filterbank_td_stream_execute(), with
+ * wfbt_stream_get_outno() outputs.
+ */
+LTFAT_API int
+LTFAT_NAME(wfbt_stream_execute)(LTFAT_NAME(wfbt_stream)* p,
+                                const LTFAT_TYPE f[], ltfat_int Lb,
+                                LTFAT_TYPE* c[], ltfat_int cLen[]);
+
+LTFAT_API int
+LTFAT_NAME(wfbt_stream_reset)(LTFAT_NAME(wfbt_stream)* p);
+
+LTFAT_API int
+LTFAT_NAME(wfbt_stream_done)(LTFAT_NAME(wfbt_stream)** p);
+
+/** Create streaming filter bank tree synthesis state
+ *
+ * The subbands of the channels with a node attached are delayed
+ * such that all inputs of a node are aligned. The overall delay is
+ * returned by iwfbt_stream_get_delay(). The parameters are as in
+ * wfbt_stream_init(), the nodes are expected to hold the synthesis filters.
+ */
+LTFAT_API int
+LTFAT_NAME(iwfbt_stream_init)(const LTFAT_NAME(wfbt_node) nodes[],
+                              ltfat_int nodesNo, ltfat_int maxLb, int flags,
+                              LTFAT_NAME(iwfbt_stream)** p);
+
+/** Delay of the output in samples */
+LTFAT_API ltfat_int
+LTFAT_NAME(iwfbt_stream_get_delay)(const LTFAT_NAME(iwfbt_stream)* p);
+
+/** Process one block
+ *
+ * The arguments are as in ifilterbank_td_stream_execute(), with
+ * wfbt_stream_get_outno() inputs. \a cLen must be equal to the lengths
+ * returned by wfbt_stream_execute() for a block of the same length.
+ */
+LTFAT_API int
+LTFAT_NAME(iwfbt_stream_execute)(LTFAT_NAME(iwfbt_stream)* p,
+                                 const LTFAT_TYPE* c[], const ltfat_int cLen[],
+                                 ltfat_int Lb, LTFAT_TYPE f[]);
+
+LTFAT_API int
+LTFAT_NAME(iwfbt_stream_reset)(LTFAT_NAME(iwfbt_stream)* p);
+
+LTFAT_API int
+LTFAT_NAME(iwfbt_stream_done)(LTFAT_NAME(iwfbt_stream)** p);
+
+/** @} */
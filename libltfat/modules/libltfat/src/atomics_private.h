@@ -0,0 +1,37 @@
+#ifndef _ltfat_atomics_private_h
+#define _ltfat_atomics_private_h
+
+/*
+ * Minimal set of atomic operations on ltfat_int used by the thread pool and
+ * by the lock-free FIFOs. The _acq/_rel variants are meant for the
+ * single-producer/single-consumer handoffs, the plain ones are sequentially
+ * consistent.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+
+#define ltfat_atomic_load(ptr)           __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define ltfat_atomic_store(ptr, val)     __atomic_store_n((ptr), (val), __ATOMIC_SEQ_CST)
+#define ltfat_atomic_fetch_add(ptr, val) __atomic_fetch_add((ptr), (val), __ATOMIC_SEQ_CST)
+#define ltfat_atomic_load_acq(ptr)       __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define ltfat_atomic_store_rel(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define ltfat_cpu_relax()                do{}while(0)
+
+#elif defined(_MSC_VER)
+
+#include <windows.h>
+/* x86/x64 only. ltfat_int is either 32 or 64 bit. */
+#define ltfat_atomic_load(ptr)           ( MemoryBarrier(), *(volatile ltfat_int*)(ptr) )
+#define ltfat_atomic_store(ptr, val)     do{ *(volatile ltfat_int*)(ptr) = (val); MemoryBarrier(); }while(0)
+#define ltfat_atomic_load_acq(ptr)       ( *(volatile ltfat_int*)(ptr) )
+#define ltfat_atomic_store_rel(ptr, val) do{ _ReadWriteBarrier(); *(volatile ltfat_int*)(ptr) = (val); }while(0)
+#define ltfat_atomic_fetch_add(ptr, val) \
+    ( sizeof(ltfat_int) == sizeof(LONG64) ? \
+      (ltfat_int) InterlockedExchangeAdd64((volatile LONG64*)(ptr), (LONG64)(val)) : \
+      (ltfat_int) InterlockedExchangeAdd((volatile LONG*)(ptr), (LONG)(val)) )
+#define ltfat_cpu_relax()                YieldProcessor()
+
+#else
+#error "No atomic operations available for this compiler."
+#endif
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef _ltfat_bitscan_private_h
+#define _ltfat_bitscan_private_h
+#include <stdint.h>
+
+/*
+ * Index of the highest set bit of x, x must not be zero. Used by the bucket
+ * queues of the heap in heap.c and of rtpghi in libphaseret to find the
+ * highest nonempty bucket from a word of the occupancy mask.
+ */
+static inline int
+ltfat_highestbit64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#else
+    int r = 0;
+    if (x >> 32) { x >>= 32; r += 32; }
+    if (x >> 16) { x >>= 16; r += 16; }
+    if (x >> 8)  { x >>= 8;  r += 8; }
+    if (x >> 4)  { x >>= 4;  r += 4; }
+    if (x >> 2)  { x >>= 2;  r += 2; }
+    if (x >> 1)  { r += 1; }
+    return r;
+#endif
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "ltfat.h"
 #include "ltfat/types.h"
 #include "ltfat/macros.h"
+#include "simd_private.h"
 
 // in might be equal to out
 LTFAT_API int
@@ -207,6 +208,16 @@ error:
     return status;
 }
 
+/* out[ii] += in[ii] using the vectorized kernel. Complex arrays are
+ * treated as real arrays of twice the length. */
+static void
+LTFAT_NAME(fold_add)(const LTFAT_TYPE* in, ltfat_int L, LTFAT_TYPE* out)
+{
+    LTFAT_NAME_REAL(add_array_simd)((const LTFAT_REAL*) in,
+                                    L * (ltfat_int)(sizeof (LTFAT_TYPE) / sizeof (LTFAT_REAL)),
+                                    (LTFAT_REAL*) out);
+}
+
 /*
   *
  * If offset is not zero, the function performs:
@@ -246,9 +257,8 @@ LTFAT_NAME(fold_array)(const LTFAT_TYPE* in, ltfat_int Lin,
         // Common code for no offset
         ltfat_int startAt = in == out ? Lfold : 0;
 
-        for (ltfat_int ii = startAt; ii < Lin;)
-            for (ltfat_int kk = 0; ii < Lin && kk < Lfold; ii++, kk++)
-                out[kk] += in[ii];
+        for (ltfat_int ii = startAt; ii < Lin; ii += Lfold)
+            LTFAT_NAME(fold_add)(in + ii, ltfat_imin(Lfold, Lin - ii), out);
 
     }
     else
@@ -266,12 +276,14 @@ LTFAT_NAME(fold_array)(const LTFAT_TYPE* in, ltfat_int Lin,
             // doing circshift of all blocks
             for (ltfat_int ii = 0; ii < Lin;)
             {
-                ltfat_int kk = startIdx;
-                for (; kk < Lfold && ii < Lin; ii++, kk++)
-                    out[kk] += in[ii];
-
-                for (kk = 0; kk < startIdx && ii < Lin; ii++, kk++)
-                    out[kk] += in[ii];
+                ltfat_int len = ltfat_imin(Lfold - startIdx, Lin - ii);
+                LTFAT_NAME(fold_add)(in + ii, len, out + startIdx);
+                ii += len;
+
+                len = ltfat_imin(startIdx, Lin - ii);
+                if (len > 0)
+                    LTFAT_NAME(fold_add)(in + ii, len, out);
+                ii += len;
             }
         }
     }
@@ -2,6 +2,109 @@
 #include "ltfat/types.h"
 #include "ltfat/macros.h"
 #include "circularbuf_private.h"
+#include "atomics_private.h"
+#include <stdint.h>
+
+static int
+LTFAT_NAME(block_processor_init_common)(
+    ltfat_int winLen, ltfat_int hop, ltfat_int numChans,
+    ltfat_int bufLenMax, ltfat_int procDelay, ltfat_int queueLen,
+    LTFAT_REAL* prebuf, LTFAT_REAL* postbuf,
+    LTFAT_NAME(block_processor_state)** pout);
+
+static ltfat_int
+LTFAT_NAME(block_processor_processblocks)(
+    LTFAT_NAME(block_processor_state)* p, int do_out);
+
+size_t
+LTFAT_NAME(sample_size)(ltfat_sampleformat fmt)
+{
+    switch (fmt)
+    {
+    case LTFAT_SAMPLE_INT16:   return sizeof (int16_t);
+    case LTFAT_SAMPLE_INT32:   return sizeof (int32_t);
+    case LTFAT_SAMPLE_FLOAT32: return sizeof (float);
+    case LTFAT_SAMPLE_FLOAT64: return sizeof (double);
+    }
+    return 0;
+}
+
+/* Converts len frames of W interleaved channels starting at frame inOff
+ * and writes the first Wact channels to the channels of the ring buffer */
+static void
+LTFAT_NAME(sample_deinterleave)(const void* in, ltfat_sampleformat fmt,
+                                ltfat_int inOff, ltfat_int len,
+                                ltfat_int W, ltfat_int Wact,
+                                LTFAT_REAL* ring, ltfat_int ringStride)
+{
+#define LTFAT_DEINTERLEAVE(TYPE, SCALE)                                      \
+    do {                                                                     \
+        const TYPE* inFrame = (const TYPE*) in + inOff * W;                  \
+        for (ltfat_int l = 0; l < len; l++, inFrame += W)                    \
+            for (ltfat_int w = 0; w < Wact; w++)                             \
+                ring[l + w * ringStride] = (LTFAT_REAL) (inFrame[w] * SCALE);\
+    } while (0)
+
+    switch (fmt)
+    {
+    case LTFAT_SAMPLE_INT16:
+        LTFAT_DEINTERLEAVE(int16_t, (LTFAT_REAL) (1.0 / 32768.0)); break;
+    case LTFAT_SAMPLE_INT32:
+        LTFAT_DEINTERLEAVE(int32_t, (1.0 / 2147483648.0)); break;
+    case LTFAT_SAMPLE_FLOAT32:
+        LTFAT_DEINTERLEAVE(float, 1); break;
+    case LTFAT_SAMPLE_FLOAT64:
+        LTFAT_DEINTERLEAVE(double, 1); break;
+    }
+#undef LTFAT_DEINTERLEAVE
+}
+
+/* Inverse of sample_deinterleave, the integer formats are rounded and
+ * clipped to the full scale */
+static void
+LTFAT_NAME(sample_interleave)(const LTFAT_REAL* ring, ltfat_int ringStride,
+                              ltfat_int len, ltfat_int W, ltfat_int Wact,
+                              ltfat_sampleformat fmt, ltfat_int outOff,
+                              void* out)
+{
+#define LTFAT_INTERLEAVE(TYPE, CONV)                                         \
+    do {                                                                     \
+        TYPE* outFrame = (TYPE*) out + outOff * W;                           \
+        for (ltfat_int l = 0; l < len; l++, outFrame += W)                   \
+        {                                                                    \
+            for (ltfat_int w = 0; w < Wact; w++)                             \
+            {                                                                \
+                double x = ring[l + w * ringStride];                         \
+                outFrame[w] = CONV;                                          \
+            }                                                                \
+            for (ltfat_int w = Wact; w < W; w++)                             \
+                outFrame[w] = 0;                                             \
+        }                                                                    \
+    } while (0)
+
+#define LTFAT_PCMROUND(x, SCALE, MIN, MAX)                                   \
+    ( (x) * (SCALE) >= (MAX) ? (MAX) : (x) * (SCALE) <= (MIN) ? (MIN) :      \
+      (x) >= 0 ? (x) * (SCALE) + 0.5 : (x) * (SCALE) - 0.5 )
+
+    switch (fmt)
+    {
+    case LTFAT_SAMPLE_INT16:
+        LTFAT_INTERLEAVE(int16_t,
+                         (int16_t) LTFAT_PCMROUND(x, 32768.0, -32768.0, 32767.0));
+        break;
+    case LTFAT_SAMPLE_INT32:
+        LTFAT_INTERLEAVE(int32_t,
+                         (int32_t) LTFAT_PCMROUND(x, 2147483648.0, -2147483648.0,
+                                                  2147483647.0));
+        break;
+    case LTFAT_SAMPLE_FLOAT32:
+        LTFAT_INTERLEAVE(float, (float) x); break;
+    case LTFAT_SAMPLE_FLOAT64:
+        LTFAT_INTERLEAVE(double, x); break;
+    }
+#undef LTFAT_PCMROUND
+#undef LTFAT_INTERLEAVE
+}
 
 LTFAT_API int
 LTFAT_NAME(block_processor_init)( ltfat_int winLen, ltfat_int hop,
@@ -30,6 +133,39 @@ LTFAT_NAME(block_processor_init_withbuffers)(
     ltfat_int bufLenMax, ltfat_int procDelay,
     LTFAT_REAL* prebuf, LTFAT_REAL* postbuf,
     LTFAT_NAME(block_processor_state)** pout)
+{
+    return LTFAT_NAME(block_processor_init_common)(
+               winLen, hop, numChans, bufLenMax, procDelay, 0,
+               prebuf, postbuf, pout);
+}
+
+LTFAT_API int
+LTFAT_NAME(block_processor_init_spsc)(
+    ltfat_int winLen, ltfat_int hop, ltfat_int numChans,
+    ltfat_int bufLenMax, ltfat_int procDelay, ltfat_int queueLen,
+    LTFAT_NAME(block_processor_state)** pout)
+{
+    int status = LTFATERR_FAILED;
+    CHECK(LTFATERR_NOTPOSARG, queueLen > 0,
+          "queueLen must be positive (passed %td)", queueLen);
+
+    CHECKSTATUS(
+        LTFAT_NAME(block_processor_init_common)(
+            winLen, hop, numChans, bufLenMax, procDelay, queueLen,
+            NULL, NULL, pout));
+
+    (*pout)->spsc = 1;
+    return LTFATERR_SUCCESS;
+error:
+    return status;
+}
+
+static int
+LTFAT_NAME(block_processor_init_common)(
+    ltfat_int winLen, ltfat_int hop, ltfat_int numChans,
+    ltfat_int bufLenMax, ltfat_int procDelay, ltfat_int queueLen,
+    LTFAT_REAL* prebuf, LTFAT_REAL* postbuf,
+    LTFAT_NAME(block_processor_state)** pout)
 {
     LTFAT_NAME(block_processor_state)* p = NULL;
     int status = LTFATERR_FAILED;
@@ -63,13 +199,19 @@ LTFAT_NAME(block_processor_init_withbuffers)(
     CHECKMEM( p->inTmp = LTFAT_NEWARRAY(const LTFAT_REAL*, numChans));
     CHECKMEM( p->outTmp = LTFAT_NEWARRAY(LTFAT_REAL*, numChans));
 
+    // The FIFOs must be able to hold the queued samples on top of the
+    // usual requirements.
     CHECKSTATUS(
-        LTFAT_NAME(analysis_fifo_init)(bufLenMax + winLen, procDelay,
+        LTFAT_NAME(analysis_fifo_init)(bufLenMax + winLen + queueLen, procDelay,
                                        winLen, hop, numChans, &p->fwdfifo));
     CHECKSTATUS(
-        LTFAT_NAME(synthesis_fifo_init)(bufLenMax + winLen, winLen, hop,
+        LTFAT_NAME(synthesis_fifo_init)(bufLenMax + winLen + queueLen, winLen, hop,
                                         numChans, &p->backfifo));
 
+    // Pretend queueLen zero samples are already waiting to be read. This
+    // gives the processing thread a head start.
+    p->backfifo->writeIdx = queueLen;
+
     p->prehop = hop; p->posthop = hop;
     *pout = p;
     return LTFATERR_SUCCESS;
@@ -126,12 +268,16 @@ LTFAT_NAME(block_processor_execute)(
     const LTFAT_REAL** in, ltfat_int inLen, ltfat_int chanNo,
     ltfat_int outLen, LTFAT_REAL** out)
 {
-    int status = LTFATERR_FAILED, callbackstatus = 0;
+    int status = LTFATERR_FAILED;
     ltfat_int samplesWritten = 0, samplesRead = 0;
 
     // Failing these checks prohibits execution altogether
     CHECKNULL(p); CHECKNULL(in); // CHECKNULL(out);
 
+    CHECK(LTFATERR_NOTSUPPORTED, !p->spsc,
+          "Use block_processor_execute_io and block_processor_execute_compute"
+          " with a processor created by block_processor_init_spsc");
+
     CHECK(LTFATERR_CANNOTHAPPEN, p->processorCallback != NULL ||
                                  (p->prewin != NULL && p->postwin != NULL),
           "processor callback is not set" );
@@ -178,63 +324,315 @@ LTFAT_NAME(block_processor_execute)(
     samplesWritten =
         LTFAT_NAME(analysis_fifo_write)(p->fwdfifo, in, inLen, chanNo);
 
-    // While there is new data in the input fifo
-    while ( LTFAT_NAME(analysis_fifo_read)(p->fwdfifo, p->prebuf) > 0 )
+    if ( LTFAT_NAME(block_processor_processblocks)(p, out != NULL) < 0 )
+        CHECKSTATUS(LTFATERR_FAILED);
+
+    // Read sampples for output
+    if (out)
     {
+        samplesRead =
+            LTFAT_NAME(synthesis_fifo_read)(p->backfifo, outLen, chanNo, out);
+    }
+
+    LTFAT_NAME(block_processor_advanceby)( p, samplesWritten, samplesRead);
+    LTFAT_NAME(analysis_fifo_sethop)(p->fwdfifo, p->prehop);
+    LTFAT_NAME(synthesis_fifo_sethop)(p->backfifo, p->posthop);
+    status = LTFATERR_SUCCESS;
+error:
+    if (status != LTFATERR_SUCCESS) return status;
+    // These should never occur, it would mean internal error
+    if ( samplesWritten != inLen ) return LTFATERR_OVERFLOW;
+    else if ( out && samplesRead != outLen ) return LTFATERR_UNDERFLOW;
+    return status;
+
+}
+
+
+
+LTFAT_API int
+LTFAT_NAME(block_processor_execute_interleaved)(
+    LTFAT_NAME(block_processor_state)* p, ltfat_sampleformat fmt,
+    const void* in, ltfat_int inLen, ltfat_int chanNo,
+    ltfat_int outLen, void* out)
+{
+    ltfat_int samplesWritten = 0, samplesRead = 0;
+    size_t frameSize;
+    int status = LTFATERR_FAILED;
+
+    CHECKNULL(p); CHECKNULL(in);
+
+    CHECK(LTFATERR_NOTSUPPORTED, !p->spsc,
+          "Use block_processor_execute_io_interleaved and"
+          " block_processor_execute_compute with a processor created by"
+          " block_processor_init_spsc");
+
+    CHECK(LTFATERR_CANNOTHAPPEN, p->processorCallback != NULL ||
+                                 (p->prewin != NULL && p->postwin != NULL),
+          "processor callback is not set" );
+
+    CHECK(LTFATERR_BADSIZE, inLen >= 0 && outLen >= 0,
+          "len must be positive or zero (passed %td and %td)", inLen, outLen);
+    CHECK(LTFATERR_BADSIZE, chanNo >= 0,
+          "chanNo must be positive or zero (passed %td)", chanNo);
+    CHECK(LTFATERR_BADARG, LTFAT_NAME(sample_size)(fmt) > 0,
+          "Unknown sample format.");
+
+    if (chanNo == 0 || (inLen == 0 && outLen == 0)) return LTFATERR_SUCCESS;
+
+    status = LTFATERR_SUCCESS;
+    frameSize = chanNo * LTFAT_NAME(sample_size)(fmt);
+
+    // The superfluous channels are skipped in the input and set to zero in
+    // the output by the FIFOs
+    if ( chanNo > p->fwdfifo->numChans )
+    {
+        DEBUG("Channel overflow (passed %td, max %td)", chanNo, p->fwdfifo->numChans);
+        status = LTFATERR_OVERFLOW;
+    }
+
+    if ( inLen > p->bufLenMax )
+    {
+        DEBUG("Buffer overflow (passed %td, max %td)", inLen, p->bufLenMax);
+        status = LTFATERR_OVERFLOW;
+        inLen = p->bufLenMax;
+    }
+
+    if ( out && outLen > p->bufLenMax )
+    {
+        DEBUG("Buffer overflow (passed %td, max %td)", outLen, p->bufLenMax);
+        status = LTFATERR_OVERFLOW;
+        memset((char*) out + p->bufLenMax * frameSize, 0,
+               (outLen - p->bufLenMax) * frameSize);
+        outLen = p->bufLenMax;
+    }
+
+    samplesWritten = LTFAT_NAME(analysis_fifo_write_interleaved)(
+                         p->fwdfifo, in, fmt, inLen, chanNo);
+
+    if ( LTFAT_NAME(block_processor_processblocks)(p, out != NULL) < 0 )
+        CHECKSTATUS(LTFATERR_FAILED);
+
+    if (out)
+    {
+        samplesRead = LTFAT_NAME(synthesis_fifo_read_interleaved)(
+                          p->backfifo, outLen, chanNo, fmt, out);
+    }
+
+    LTFAT_NAME(block_processor_advanceby)( p, samplesWritten, samplesRead);
+    LTFAT_NAME(analysis_fifo_sethop)(p->fwdfifo, p->prehop);
+    LTFAT_NAME(synthesis_fifo_sethop)(p->backfifo, p->posthop);
+
+    // These should never occur, it would mean internal error
+    if ( samplesWritten != inLen ) return LTFATERR_OVERFLOW;
+    else if ( out && samplesRead != outLen ) return LTFATERR_UNDERFLOW;
+error:
+    return status;
+}
+
+static ltfat_int
+LTFAT_NAME(block_processor_processblocks)(
+    LTFAT_NAME(block_processor_state)* p, int do_out)
+{
+    ltfat_int nBlocks = 0;
+    LTFAT_NAME(analysis_fifo_state)* ff = p->fwdfifo;
+    LTFAT_NAME(synthesis_fifo_state)* bf = p->backfifo;
+
+    // While there is new data in the input fifo and space in the output one
+    while ( (!do_out || LTFAT_NAME(synthesis_fifo_freespace)(bf) >= bf->winLen)
+            && LTFAT_NAME(analysis_fifo_read)(ff, p->prebuf) > 0 )
+    {
+        int callbackstatus = 0;
+
         if (p->prewin)
         {
-            for (ltfat_int w = 0; w < p->fwdfifo->numChans; w++)
-                for (ltfat_int l = 0; l < p->fwdfifo->winLen; l++)
-                    p->prebuf[l + w * p->fwdfifo->numChans] *= p->prewin[l];
+            for (ltfat_int w = 0; w < ff->numChans; w++)
+                for (ltfat_int l = 0; l < ff->winLen; l++)
+                    p->prebuf[l + w * ff->readchanstride] *= p->prewin[l];
         }
 
-        if (out)
+        if (do_out)
         {
             callbackstatus =
-                p->processorCallback(p->userdata, p->prebuf, p->fwdfifo->winLen,
-                                     p->fwdfifo->numChans, p->postbuf);
+                p->processorCallback(p->userdata, p->prebuf, ff->winLen,
+                                     ff->numChans, p->postbuf);
 
             if (p->postwin)
             {
-                for (ltfat_int w = 0; w < p->fwdfifo->numChans; w++)
-                    for (ltfat_int l = 0; l < p->fwdfifo->winLen; l++)
-                        p->postbuf[l + w * p->fwdfifo->numChans] *= p->postwin[l];
+                for (ltfat_int w = 0; w < bf->numChans; w++)
+                    for (ltfat_int l = 0; l < bf->winLen; l++)
+                        p->postbuf[l + w * bf->writechanstride] *= p->postwin[l];
             }
 
-            LTFAT_NAME(synthesis_fifo_write)(p->backfifo, p->postbuf);
+            LTFAT_NAME(synthesis_fifo_write)(bf, p->postbuf);
         }
         else
         {
             callbackstatus =
-                p->processorCallback(p->userdata, p->prebuf, p->fwdfifo->winLen,
-                                     p->fwdfifo->numChans, NULL);
+                p->processorCallback(p->userdata, p->prebuf, ff->winLen,
+                                     ff->numChans, NULL);
         }
 
         if (callbackstatus < 0)
-            CHECKSTATUS(LTFATERR_FAILED);
+            return LTFATERR_FAILED;
+
+        nBlocks++;
     }
 
-    // Read sampples for output
-    if (out)
+    return nBlocks;
+}
+
+LTFAT_API int
+LTFAT_NAME(block_processor_execute_io)(
+    LTFAT_NAME(block_processor_state)* p,
+    const LTFAT_REAL** in, ltfat_int inLen, ltfat_int chanNo,
+    ltfat_int outLen, LTFAT_REAL** out)
+{
+    ltfat_int samplesWritten = 0, samplesRead = 0;
+    int status = LTFATERR_FAILED;
+
+    CHECKNULL(p); CHECKNULL(in); CHECKNULL(out);
+    CHECK(LTFATERR_NOTSUPPORTED, p->spsc,
+          "The processor was not created by block_processor_init_spsc");
+    CHECK(LTFATERR_BADSIZE, inLen >= 0 && outLen >= 0,
+          "len must be positive or zero (passed %td and %td)", inLen, outLen);
+    CHECK(LTFATERR_BADSIZE, chanNo >= 0,
+          "chanNo must be positive or zero (passed %td)", chanNo);
+
+    if (chanNo == 0 || (inLen == 0 && outLen == 0)) return LTFATERR_SUCCESS;
+
+    status = LTFATERR_SUCCESS;
+
+    if ( chanNo > p->fwdfifo->numChans )
     {
-        samplesRead =
-            LTFAT_NAME(synthesis_fifo_read)(p->backfifo, outLen, chanNo, out);
+        status = LTFATERR_OVERFLOW;
+        for (ltfat_int w = p->fwdfifo->numChans; w < chanNo; w++)
+            memset(out[w], 0, outLen * sizeof * out[w]);
+        chanNo = p->fwdfifo->numChans;
     }
 
-    LTFAT_NAME(block_processor_advanceby)( p, samplesWritten, samplesRead);
-    LTFAT_NAME(analysis_fifo_sethop)(p->fwdfifo, p->prehop);
-    LTFAT_NAME(synthesis_fifo_sethop)(p->backfifo, p->posthop);
-    status = LTFATERR_SUCCESS;
+    if ( inLen > p->bufLenMax )
+    {
+        status = LTFATERR_OVERFLOW;
+        inLen = p->bufLenMax;
+    }
+
+    if ( outLen > p->bufLenMax )
+    {
+        status = LTFATERR_OVERFLOW;
+        for (ltfat_int w = 0; w < chanNo; w++)
+            memset(out[w] + p->bufLenMax, 0,
+                   (outLen - p->bufLenMax)*sizeof * out[w]);
+        outLen = p->bufLenMax;
+    }
+
+    samplesWritten =
+        LTFAT_NAME(analysis_fifo_write)(p->fwdfifo, in, inLen, chanNo);
+    samplesRead =
+        LTFAT_NAME(synthesis_fifo_read)(p->backfifo, outLen, chanNo, out);
+
+    // The processing thread did not keep up, output silence instead of
+    // waiting for it.
+    if ( samplesRead >= 0 && samplesRead < outLen )
+    {
+        for (ltfat_int w = 0; w < chanNo; w++)
+            memset(out[w] + samplesRead, 0,
+                   (outLen - samplesRead)*sizeof * out[w]);
+        if (status == LTFATERR_SUCCESS) status = LTFATERR_UNDERFLOW;
+    }
+
+    if ( samplesWritten >= 0 && samplesWritten < inLen )
+        status = LTFATERR_OVERFLOW;
+
 error:
-    if (status != LTFATERR_SUCCESS) return status;
-    // These should never occur, it would mean internal error
-    if ( samplesWritten != inLen ) return LTFATERR_OVERFLOW;
-    else if ( out && samplesRead != outLen ) return LTFATERR_UNDERFLOW;
     return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(block_processor_execute_io_interleaved)(
+    LTFAT_NAME(block_processor_state)* p, ltfat_sampleformat fmt,
+    const void* in, ltfat_int inLen, ltfat_int chanNo,
+    ltfat_int outLen, void* out)
+{
+    ltfat_int samplesWritten = 0, samplesRead = 0;
+    size_t frameSize;
+    int status = LTFATERR_FAILED;
+
+    CHECKNULL(p); CHECKNULL(in); CHECKNULL(out);
+    CHECK(LTFATERR_NOTSUPPORTED, p->spsc,
+          "The processor was not created by block_processor_init_spsc");
+    CHECK(LTFATERR_BADSIZE, inLen >= 0 && outLen >= 0,
+          "len must be positive or zero (passed %td and %td)", inLen, outLen);
+    CHECK(LTFATERR_BADSIZE, chanNo >= 0,
+          "chanNo must be positive or zero (passed %td)", chanNo);
+    CHECK(LTFATERR_BADARG, LTFAT_NAME(sample_size)(fmt) > 0,
+          "Unknown sample format.");
 
+    if (chanNo == 0 || (inLen == 0 && outLen == 0)) return LTFATERR_SUCCESS;
+
+    status = LTFATERR_SUCCESS;
+    frameSize = chanNo * LTFAT_NAME(sample_size)(fmt);
+
+    if ( chanNo > p->fwdfifo->numChans )
+        status = LTFATERR_OVERFLOW;
+
+    if ( inLen > p->bufLenMax )
+    {
+        status = LTFATERR_OVERFLOW;
+        inLen = p->bufLenMax;
+    }
+
+    if ( outLen > p->bufLenMax )
+    {
+        status = LTFATERR_OVERFLOW;
+        memset((char*) out + p->bufLenMax * frameSize, 0,
+               (outLen - p->bufLenMax) * frameSize);
+        outLen = p->bufLenMax;
+    }
+
+    samplesWritten = LTFAT_NAME(analysis_fifo_write_interleaved)(
+                         p->fwdfifo, in, fmt, inLen, chanNo);
+    samplesRead = LTFAT_NAME(synthesis_fifo_read_interleaved)(
+                      p->backfifo, outLen, chanNo, fmt, out);
+
+    // The processing thread did not keep up, output silence instead of
+    // waiting for it.
+    if ( samplesRead >= 0 && samplesRead < outLen )
+    {
+        memset((char*) out + samplesRead * frameSize, 0,
+               (outLen - samplesRead) * frameSize);
+        if (status == LTFATERR_SUCCESS) status = LTFATERR_UNDERFLOW;
+    }
+
+    if ( samplesWritten >= 0 && samplesWritten < inLen )
+        status = LTFATERR_OVERFLOW;
+
+error:
+    return status;
 }
 
+LTFAT_API ltfat_int
+LTFAT_NAME(block_processor_execute_compute)(
+    LTFAT_NAME(block_processor_state)* p)
+{
+    ltfat_int nBlocks;
+    int status = LTFATERR_FAILED;
+    CHECKNULL(p);
+    CHECK(LTFATERR_NOTSUPPORTED, p->spsc,
+          "The processor was not created by block_processor_init_spsc");
+    CHECK(LTFATERR_CANNOTHAPPEN, p->processorCallback != NULL,
+          "processor callback is not set" );
+
+    nBlocks = LTFAT_NAME(block_processor_processblocks)(p, 1);
+    CHECK(LTFATERR_FAILED, nBlocks >= 0, "Callback returned an error");
 
+    // Only this thread touches the hops in the SPSC mode
+    LTFAT_NAME(analysis_fifo_sethop)(p->fwdfifo, p->prehop);
+    LTFAT_NAME(synthesis_fifo_sethop)(p->backfifo, p->posthop);
+
+    return nBlocks;
+error:
+    return status;
+}
 
 LTFAT_API int
 LTFAT_NAME(block_processor_reset)( LTFAT_NAME(block_processor_state)* p)
@@ -528,7 +926,7 @@ LTFAT_API ltfat_int
 LTFAT_NAME(analysis_fifo_write)(LTFAT_NAME(analysis_fifo_state)* p,
                                 const LTFAT_REAL** buf, ltfat_int bufLen, ltfat_int W)
 {
-    ltfat_int Wact, freeSpace, toWrite, valid, over, endWriteIdx;
+    ltfat_int Wact, freeSpace, toWrite, valid, over, endWriteIdx, writeIdx;
     int status = LTFATERR_FAILED;
     CHECKNULL(p); CHECKNULL(buf);
     CHECK(LTFATERR_NOTPOSARG, bufLen >= 0, "bufLen must be positive.");
@@ -539,8 +937,8 @@ LTFAT_NAME(analysis_fifo_write)(LTFAT_NAME(analysis_fifo_state)* p,
     for (ltfat_int w = 0; w < W; w++)
         CHECKNULL(buf[w]);
 
-
-    freeSpace = p->readIdx - p->writeIdx - 1;
+    writeIdx = p->writeIdx;
+    freeSpace = ltfat_atomic_load_acq(&p->readIdx) - writeIdx - 1;
     if (freeSpace < 0) freeSpace += p->bufLen;
 
     // CHECK(LTFATERR_OVERFLOW, freeSpace, "FIFO owerflow");
@@ -551,11 +949,11 @@ LTFAT_NAME(analysis_fifo_write)(LTFAT_NAME(analysis_fifo_state)* p,
     valid = toWrite;
     over = 0;
 
-    endWriteIdx = p->writeIdx + toWrite;
+    endWriteIdx = writeIdx + toWrite;
 
     if (endWriteIdx > p->bufLen)
     {
-        valid = p->bufLen - p->writeIdx;
+        valid = p->bufLen - writeIdx;
         over = endWriteIdx - p->bufLen;
     }
 
@@ -563,7 +961,7 @@ LTFAT_NAME(analysis_fifo_write)(LTFAT_NAME(analysis_fifo_state)* p,
     {
         for (ltfat_int w = 0; w < p->numChans; w++)
         {
-            LTFAT_REAL* pbufchan = p->buf + w * p->bufLen + p->writeIdx;
+            LTFAT_REAL* pbufchan = p->buf + w * p->bufLen + writeIdx;
             if (w < Wact)
                 memcpy(pbufchan, buf[w], valid * sizeof * p->buf );
             else
@@ -581,7 +979,58 @@ LTFAT_NAME(analysis_fifo_write)(LTFAT_NAME(analysis_fifo_state)* p,
                 memset(pbufchan, 0,  over * sizeof * p->buf);
         }
     }
-    p->writeIdx = ( p->writeIdx + toWrite ) % p->bufLen;
+    ltfat_atomic_store_rel(&p->writeIdx, ( writeIdx + toWrite ) % p->bufLen);
+
+    return toWrite;
+error:
+    return status;
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(analysis_fifo_write_interleaved)(LTFAT_NAME(analysis_fifo_state)* p,
+        const void* buf, ltfat_sampleformat fmt, ltfat_int bufLen, ltfat_int W)
+{
+    ltfat_int Wact, freeSpace, toWrite, valid, over, endWriteIdx, writeIdx;
+    int status = LTFATERR_FAILED;
+    CHECKNULL(p); CHECKNULL(buf);
+    CHECK(LTFATERR_NOTPOSARG, bufLen >= 0, "bufLen must be positive.");
+    CHECK(LTFATERR_NOTPOSARG, W > 0, "W must be positive.");
+    CHECK(LTFATERR_BADARG, LTFAT_NAME(sample_size)(fmt) > 0,
+          "Unknown sample format.");
+
+    if ( bufLen == 0 ) return 0;
+
+    writeIdx = p->writeIdx;
+    freeSpace = ltfat_atomic_load_acq(&p->readIdx) - writeIdx - 1;
+    if (freeSpace < 0) freeSpace += p->bufLen;
+
+    Wact = p->numChans < W ? p->numChans : W;
+
+    toWrite = bufLen > freeSpace ? freeSpace : bufLen;
+    valid = toWrite;
+    over = 0;
+
+    endWriteIdx = writeIdx + toWrite;
+
+    if (endWriteIdx > p->bufLen)
+    {
+        valid = p->bufLen - writeIdx;
+        over = endWriteIdx - p->bufLen;
+    }
+
+    // Conversion and deinterleaving is done while writing to the ring
+    LTFAT_NAME(sample_deinterleave)(buf, fmt, 0, valid, W, Wact,
+                                    p->buf + writeIdx, p->bufLen);
+    LTFAT_NAME(sample_deinterleave)(buf, fmt, valid, over, W, Wact,
+                                    p->buf, p->bufLen);
+
+    for (ltfat_int w = Wact; w < p->numChans; w++)
+    {
+        memset(p->buf + w * p->bufLen + writeIdx, 0, valid * sizeof * p->buf);
+        memset(p->buf + w * p->bufLen, 0, over * sizeof * p->buf);
+    }
+
+    ltfat_atomic_store_rel(&p->writeIdx, ( writeIdx + toWrite ) % p->bufLen);
 
     return toWrite;
 error:
@@ -592,11 +1041,12 @@ LTFAT_API ltfat_int
 LTFAT_NAME(analysis_fifo_read)(LTFAT_NAME(analysis_fifo_state)* p,
                                LTFAT_REAL* buf)
 {
-    ltfat_int available, toRead, valid, over, endReadIdx;
+    ltfat_int available, toRead, valid, over, endReadIdx, readIdx;
     int status = LTFATERR_FAILED;
     CHECKNULL(p); CHECKNULL(buf);
 
-    available = p->writeIdx - p->readIdx;
+    readIdx = p->readIdx;
+    available = ltfat_atomic_load_acq(&p->writeIdx) - readIdx;
     if (available < 0) available += p->bufLen;
 
     // CHECK(LTFATERR_UNDERFLOW, available >= p->winLen, "FIFO underflow");
@@ -608,11 +1058,11 @@ LTFAT_NAME(analysis_fifo_read)(LTFAT_NAME(analysis_fifo_state)* p,
     valid = toRead;
     over = 0;
 
-    endReadIdx = p->readIdx + valid;
+    endReadIdx = readIdx + valid;
 
     if (endReadIdx > p->bufLen)
     {
-        valid = p->bufLen - p->readIdx;
+        valid = p->bufLen - readIdx;
         over = endReadIdx - p->bufLen;
     }
 
@@ -620,7 +1070,7 @@ LTFAT_NAME(analysis_fifo_read)(LTFAT_NAME(analysis_fifo_state)* p,
     {
         for (ltfat_int w = 0; w < p->numChans; w++)
         {
-            LTFAT_REAL* pbufchan = p->buf + w * p->bufLen + p->readIdx;
+            LTFAT_REAL* pbufchan = p->buf + w * p->bufLen + readIdx;
             memcpy(buf + w * p->readchanstride, pbufchan, valid * sizeof * p->buf );
         }
     }
@@ -634,7 +1084,7 @@ LTFAT_NAME(analysis_fifo_read)(LTFAT_NAME(analysis_fifo_state)* p,
     }
 
     // Only advance by hop
-    p->readIdx = ( p->readIdx + p->hop ) % p->bufLen;
+    ltfat_atomic_store_rel(&p->readIdx, ( readIdx + p->hop ) % p->bufLen);
 
     return toRead;
 error:
@@ -735,16 +1185,24 @@ error:
     return status;
 }
 
+LTFAT_API ltfat_int
+LTFAT_NAME(synthesis_fifo_freespace)(LTFAT_NAME(synthesis_fifo_state)* p)
+{
+    ltfat_int freeSpace = ltfat_atomic_load_acq(&p->readIdx) - p->writeIdx - 1;
+    if (freeSpace < 0) freeSpace += p->bufLen;
+    return freeSpace;
+}
+
 LTFAT_API ltfat_int
 LTFAT_NAME(synthesis_fifo_write)(LTFAT_NAME(synthesis_fifo_state)* p,
                                  const LTFAT_REAL* buf)
 {
-    ltfat_int freeSpace, toWrite, valid, over, endWriteIdx;
+    ltfat_int freeSpace, toWrite, valid, over, endWriteIdx, writeIdx;
     int status = LTFATERR_FAILED;
     CHECKNULL(p); CHECKNULL(buf);
 
-    freeSpace = p->readIdx - p->writeIdx - 1;
-    if (freeSpace < 0) freeSpace += p->bufLen;
+    writeIdx = p->writeIdx;
+    freeSpace = LTFAT_NAME(synthesis_fifo_freespace)(p);
 
     // CHECK(LTFATERR_OVERFLOW, freeSpace >= p->winLen, "FIFO overflow");
     if (freeSpace < p->winLen) return 0;
@@ -753,11 +1211,11 @@ LTFAT_NAME(synthesis_fifo_write)(LTFAT_NAME(synthesis_fifo_state)* p,
     valid = toWrite;
     over = 0;
 
-    endWriteIdx = p->writeIdx + toWrite;
+    endWriteIdx = writeIdx + toWrite;
 
     if (endWriteIdx > p->bufLen)
     {
-        valid = p->bufLen - p->writeIdx;
+        valid = p->bufLen - writeIdx;
         over = endWriteIdx - p->bufLen;
     }
 
@@ -765,7 +1223,7 @@ LTFAT_NAME(synthesis_fifo_write)(LTFAT_NAME(synthesis_fifo_state)* p,
     {
         for (ltfat_int w = 0; w < p->numChans; w++)
         {
-            LTFAT_REAL* pbufchan = p->buf + p->writeIdx + w * p->bufLen;
+            LTFAT_REAL* pbufchan = p->buf + writeIdx + w * p->bufLen;
             const LTFAT_REAL* bufchan = buf + w * p->writechanstride;
             for (ltfat_int ii = 0; ii < valid; ii++)
                 pbufchan[ii] += bufchan[ii];
@@ -782,7 +1240,7 @@ LTFAT_NAME(synthesis_fifo_write)(LTFAT_NAME(synthesis_fifo_state)* p,
         }
     }
 
-    p->writeIdx = ( p->writeIdx + p->hop ) % p->bufLen;
+    ltfat_atomic_store_rel(&p->writeIdx, ( writeIdx + p->hop ) % p->bufLen);
 
     return toWrite;
 error:
@@ -794,7 +1252,7 @@ LTFAT_NAME(synthesis_fifo_read)(LTFAT_NAME(synthesis_fifo_state)* p,
                                 ltfat_int bufLen, ltfat_int W,
                                 LTFAT_REAL** buf)
 {
-    ltfat_int available, toRead, valid, over, endReadIdx;
+    ltfat_int available, toRead, valid, over, endReadIdx, readIdx;
     int status = LTFATERR_FAILED;
     CHECKNULL(p); CHECKNULL(buf);
     CHECK(LTFATERR_NOTPOSARG, W > 0, "W must be positive.");
@@ -803,8 +1261,8 @@ LTFAT_NAME(synthesis_fifo_read)(LTFAT_NAME(synthesis_fifo_state)* p,
 
     for (ltfat_int w = 0; w < W; w++) CHECKNULL(buf[w]);
 
-
-    available = p->writeIdx - p->readIdx;
+    readIdx = p->readIdx;
+    available = ltfat_atomic_load_acq(&p->writeIdx) - readIdx;
     if (available < 0) available += p->bufLen;
 
     // CHECK(LTFATERR_UNDERFLOW, available, "FIFO underflow");
@@ -814,11 +1272,11 @@ LTFAT_NAME(synthesis_fifo_read)(LTFAT_NAME(synthesis_fifo_state)* p,
     valid = toRead;
     over = 0;
 
-    endReadIdx = p->readIdx + valid;
+    endReadIdx = readIdx + valid;
 
     if (endReadIdx > p->bufLen)
     {
-        valid = p->bufLen - p->readIdx;
+        valid = p->bufLen - readIdx;
         over = endReadIdx - p->bufLen;
     }
 
@@ -828,7 +1286,7 @@ LTFAT_NAME(synthesis_fifo_read)(LTFAT_NAME(synthesis_fifo_state)* p,
     {
         for (ltfat_int w = 0; w < W; w++)
         {
-            LTFAT_REAL* pbufchan = p->buf + p->readIdx + w * p->bufLen;
+            LTFAT_REAL* pbufchan = p->buf + readIdx + w * p->bufLen;
             memcpy(buf[w], pbufchan, valid * sizeof * p->buf);
             memset(pbufchan, 0, valid * sizeof * p->buf);
         }
@@ -843,7 +1301,63 @@ LTFAT_NAME(synthesis_fifo_read)(LTFAT_NAME(synthesis_fifo_state)* p,
         }
     }
 
-    p->readIdx = ( p->readIdx + toRead ) % p->bufLen;
+    // The zeroed samples must be visible before the writer reuses them
+    ltfat_atomic_store_rel(&p->readIdx, ( readIdx + toRead ) % p->bufLen);
+
+    return toRead;
+error:
+    return status;
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(synthesis_fifo_read_interleaved)(LTFAT_NAME(synthesis_fifo_state)* p,
+        ltfat_int bufLen, ltfat_int W, ltfat_sampleformat fmt, void* buf)
+{
+    ltfat_int Wact, available, toRead, valid, over, endReadIdx, readIdx;
+    int status = LTFATERR_FAILED;
+    CHECKNULL(p); CHECKNULL(buf);
+    CHECK(LTFATERR_NOTPOSARG, W > 0, "W must be positive.");
+    CHECK(LTFATERR_NOTPOSARG, bufLen >= 0, "bufLen must be positive.");
+    CHECK(LTFATERR_BADARG, LTFAT_NAME(sample_size)(fmt) > 0,
+          "Unknown sample format.");
+    if (bufLen == 0) return 0;
+
+    readIdx = p->readIdx;
+    available = ltfat_atomic_load_acq(&p->writeIdx) - readIdx;
+    if (available < 0) available += p->bufLen;
+
+    Wact = p->numChans < W ? p->numChans : W;
+
+    toRead = available < bufLen ? available : bufLen;
+
+    valid = toRead;
+    over = 0;
+
+    endReadIdx = readIdx + valid;
+
+    if (endReadIdx > p->bufLen)
+    {
+        valid = p->bufLen - readIdx;
+        over = endReadIdx - p->bufLen;
+    }
+
+    // Conversion and interleaving is done while reading from the ring,
+    // channels above numChans are set to zero
+    LTFAT_NAME(sample_interleave)(p->buf + readIdx, p->bufLen, valid, W, Wact,
+                                  fmt, 0, buf);
+    LTFAT_NAME(sample_interleave)(p->buf, p->bufLen, over, W, Wact,
+                                  fmt, valid, buf);
+
+    // Set the just read samples to zero so that the values are not used in
+    // write again
+    for (ltfat_int w = 0; w < p->numChans; w++)
+    {
+        memset(p->buf + w * p->bufLen + readIdx, 0, valid * sizeof * p->buf);
+        memset(p->buf + w * p->bufLen, 0, over * sizeof * p->buf);
+    }
+
+    // The zeroed samples must be visible before the writer reuses them
+    ltfat_atomic_store_rel(&p->readIdx, ( readIdx + toRead ) % p->bufLen);
 
     return toRead;
 error:
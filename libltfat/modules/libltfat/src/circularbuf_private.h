@@ -1,6 +1,10 @@
 #ifndef _circularbuf_private_h
 #define _circularbuf_private_h
 
+/* readIdx and writeIdx of both FIFOs are accessed with acquire/release
+ * semantics such that one thread can write and another one can read
+ * concurrently without locking (single producer, single consumer).
+ * Each index is only ever modified by its owning side. */
 struct LTFAT_NAME(analysis_fifo_state)
 {
     ltfat_int winLen; //!< Window length
@@ -46,6 +50,12 @@ struct LTFAT_NAME(block_processor_state)
     double out_in_in_offset;
     ltfat_int prehop;
     ltfat_int posthop;
+    int spsc; //!< I/O and processing are done by different threads
 };
 
+/* Size of one sample of the interleaved formats in bytes, 0 if the format
+ * is not known */
+size_t
+LTFAT_NAME(sample_size)(ltfat_sampleformat fmt);
+
 #endif
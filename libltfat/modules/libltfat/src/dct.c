@@ -3,6 +3,7 @@
 #include "ltfat/macros.h"
 
 #include "ltfat/thirdparty/fftw3.h"
+#include "fftcache_private.h"
 
 /* typedef LTFAT_NAME(dct_plan) LTFAT_FFTW(plan); */
 
@@ -52,10 +53,12 @@ LTFAT_NAME(dct_init)( ltfat_int L, ltfat_int W, LTFAT_TYPE* cout,
         case DCTIV:  kindFftw = FFTW_REDFT11; break;
     };
 
+    ltfat_fftcache_lock();
     p = LTFAT_FFTW(plan_guru64_r2r)(1, &dims,
                                     1, &howmanydims,
                                     (LTFAT_REAL*)cout, (LTFAT_REAL*)cout,
                                     &kindFftw, flag);
+    ltfat_fftcache_unlock();
 
     return (LTFAT_NAME(dct_plan)*) p;
 }
@@ -76,7 +79,9 @@ LTFAT_NAME(dct)(const LTFAT_TYPE* f, ltfat_int L, ltfat_int W,
 LTFAT_API void
 LTFAT_NAME(dct_done)( LTFAT_NAME(dct_plan)* p)
 {
+    ltfat_fftcache_lock();
     LTFAT_FFTW(destroy_plan)((LTFAT_FFTW(plan))p);
+    ltfat_fftcache_unlock();
 }
 
 // f and cout can be equal, provided plan was already created
@@ -10,7 +10,10 @@ struct LTFAT_NAME(dgt_fb_plan)
     ltfat_int M;
     ltfat_int gl;
     ltfat_phaseconvention ptype;
+    unsigned flags;
+    ltfat_int K;
     LTFAT_NAME_REAL(fft_plan)* p_small;
+    LTFAT_NAME_REAL(fft_plan)* p_batch;
     LTFAT_COMPLEX* sbuf;
     LTFAT_COMPLEX* fw;
     LTFAT_TYPE* gw;
@@ -60,6 +63,8 @@ LTFAT_NAME(dgt_fb_init)(const LTFAT_TYPE* g,
     plan->M = M;
     plan->gl = gl;
     plan->ptype = ptype;
+    plan->flags = flags;
+    plan->K = 1;
 
     CHECKMEM(plan->gw  = LTFAT_NAME(malloc)(plan->gl));
     CHECKMEM(plan->fw  = LTFAT_NAME_COMPLEX(calloc)(plan->gl));
@@ -88,15 +93,55 @@ LTFAT_NAME(dgt_fb_done)(LTFAT_NAME(dgt_fb_plan)** plan)
 
     LTFAT_SAFEFREEALL(pp->sbuf, pp->gw, pp->fw);
     if (pp->p_small) LTFAT_NAME_REAL(fft_done)(&pp->p_small);
+    if (pp->p_batch) LTFAT_NAME_REAL(fft_done)(&pp->p_batch);
     ltfat_free(pp);
     pp = NULL;
 error:
     return status;
 }
 
+LTFAT_API int
+LTFAT_NAME(dgt_fb_set_batchsize)(LTFAT_NAME(dgt_fb_plan)* p, ltfat_int K)
+{
+    LTFAT_COMPLEX* sbufnew = NULL;
+    LTFAT_NAME_REAL(fft_plan)* p_small = NULL;
+    LTFAT_NAME_REAL(fft_plan)* p_batch = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_NOTPOSARG, K > 0, "K must be positive");
+
+    if (K == p->K) return status;
+
+    /* Build everything first so that the plan stays usable on failure */
+    CHECKMEM(sbufnew = LTFAT_NAME_COMPLEX(malloc)(p->M * K));
+    CHECKSTATUS(
+        LTFAT_NAME_REAL(fft_init)(p->M, 1, sbufnew, sbufnew, p->flags, &p_small));
+    if (K > 1)
+        CHECKSTATUS(
+            LTFAT_NAME_REAL(fft_init)(p->M, K, sbufnew, sbufnew, p->flags, &p_batch));
+
+    ltfat_free(p->sbuf);
+    LTFAT_NAME_REAL(fft_done)(&p->p_small);
+    if (p->p_batch) LTFAT_NAME_REAL(fft_done)(&p->p_batch);
+
+    p->sbuf = sbufnew;
+    p->p_small = p_small;
+    p->p_batch = p_batch;
+    p->K = K;
+    return status;
+error:
+    if (p_small) LTFAT_NAME_REAL(fft_done)(&p_small);
+    if (p_batch) LTFAT_NAME_REAL(fft_done)(&p_batch);
+    ltfat_safefree(sbufnew);
+    return status;
+}
+
 /* The following macro adds the coefficients together performing the
- * last part of the Poisson summation, executes the FFT on the summed
- * coefficients, and places the coefficients in the output array.
+ * last part of the Poisson summation and places the folded column
+ * into the k-th slot of the M x K batch buffer. Once K columns have
+ * been collected, a single batched FFT is executed and the whole
+ * block is copied to the output. Since the columns of a single channel
+ * are consecutive in the output, the block is contiguous there too.
  *
  * The first summation is done in that peculiar way to obtain the
  * correct phase for a frequency invariant Gabor transform. Summing
@@ -106,9 +151,12 @@ error:
  * The macro is called in three different places in the dgt_fb function.
  */
 #define THE_SUM { \
-LTFAT_NAME_COMPLEX(fold_array)(fw,gl,plan.ptype==LTFAT_TIMEINV?-glh:n*a-glh,M,sbuf); \
-LTFAT_NAME_REAL(fft_execute)(plan.p_small); \
-memcpy(cout + (n*M + w*M*N),sbuf,M*sizeof*cout); \
+LTFAT_NAME_COMPLEX(fold_array)(fw,gl,plan.ptype==LTFAT_TIMEINV?-glh:n*a-glh,M,sbuf + k*M); \
+if (++k == K) { \
+    LTFAT_NAME_REAL(fft_execute)(K > 1 ? plan.p_batch : plan.p_small); \
+    memcpy(cout + ((n + 1 - K)*M + w*M*N),sbuf,K*M*sizeof*cout); \
+    k = 0; \
+} \
 }
 
 LTFAT_API int
@@ -116,7 +164,7 @@ LTFAT_NAME(dgt_fb_execute)(const LTFAT_NAME(dgt_fb_plan)* p,
                            const LTFAT_TYPE* f,
                            ltfat_int L, ltfat_int W,  LTFAT_COMPLEX* cout)
 {
-    ltfat_int a, M, N, gl, glh, glh_d_a;
+    ltfat_int a, M, N, K, gl, glh, glh_d_a;
     LTFAT_COMPLEX* sbuf, *fw;
     LTFAT_TYPE* fbd;
     LTFAT_NAME(dgt_fb_plan) plan;
@@ -132,6 +180,7 @@ LTFAT_NAME(dgt_fb_execute)(const LTFAT_NAME(dgt_fb_plan)* p,
     a = plan.a;
     M = plan.M;
     N = L / a;
+    K = plan.K;
 
     gl = plan.gl;
     sbuf = plan.sbuf;
@@ -146,12 +195,14 @@ LTFAT_NAME(dgt_fb_execute)(const LTFAT_NAME(dgt_fb_plan)* p,
 
     /*  ---------- main body ----------- */
 
-    /*----- Handle the first boundary using periodic boundary conditions.*/
-    for (ltfat_int n = 0; n < glh_d_a; n++)
+    for (ltfat_int w = 0; w < W; w++)
     {
-        for (ltfat_int w = 0; w < W; w++)
-        {
+        /* Number of columns waiting in sbuf */
+        ltfat_int k = 0;
 
+        /*----- Handle the first boundary using periodic boundary conditions.*/
+        for (ltfat_int n = 0; n < glh_d_a; n++)
+        {
             fbd = (LTFAT_TYPE*)f + (L - (glh - n * a) + L * w);
             for (ltfat_int l = 0; l < glh - n * a; l++)
                 fw[l] = fbd[l] * plan.gw[l];
@@ -161,14 +212,10 @@ LTFAT_NAME(dgt_fb_execute)(const LTFAT_NAME(dgt_fb_plan)* p,
                 fw[l] = fbd[l] * plan.gw[l];
 
             THE_SUM
-
         }
-    }
 
-    /* ----- Handle the middle case. --------------------- */
-    for (ltfat_int n = glh_d_a; n < (L - (gl + 1) / 2) / a + 1; n++)
-    {
-        for (ltfat_int w = 0; w < W; w++)
+        /* ----- Handle the middle case. --------------------- */
+        for (ltfat_int n = glh_d_a; n < (L - (gl + 1) / 2) / a + 1; n++)
         {
             fbd = (LTFAT_TYPE*)f + (n * a - glh + L * w);
             for (ltfat_int l = 0; l < gl; l++)
@@ -177,12 +224,8 @@ LTFAT_NAME(dgt_fb_execute)(const LTFAT_NAME(dgt_fb_plan)* p,
             THE_SUM
         }
 
-    }
-
-    /* Handle the last boundary using periodic boundary conditions. */
-    for (ltfat_int n = (L - (gl + 1) / 2) / a + 1; n < N; n++)
-    {
-        for (ltfat_int w = 0; w < W; w++)
+        /* Handle the last boundary using periodic boundary conditions. */
+        for (ltfat_int n = (L - (gl + 1) / 2) / a + 1; n < N; n++)
         {
             fbd = (LTFAT_TYPE*)f + (n * a - glh + L * w);
             for (ltfat_int l = 0; l < L - n * a + glh; l++)
@@ -194,6 +237,16 @@ LTFAT_NAME(dgt_fb_execute)(const LTFAT_NAME(dgt_fb_plan)* p,
 
             THE_SUM
         }
+
+        /* Flush the incomplete batch column by column. Column kk is moved
+         * to the first slot because p_small works on the first M elements. */
+        for (ltfat_int kk = 0; kk < k; kk++)
+        {
+            if (kk > 0)
+                memcpy(sbuf, sbuf + kk * M, M * sizeof * sbuf);
+            LTFAT_NAME_REAL(fft_execute)(plan.p_small);
+            memcpy(cout + ((N - k + kk)*M + w * M * N), sbuf, M * sizeof * cout);
+        }
     }
 
 error:
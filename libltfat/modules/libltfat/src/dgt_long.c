@@ -72,6 +72,7 @@ LTFAT_NAME(dgt_long_init)( const LTFAT_TYPE* g,
     CHECKMEM( plan->cf = LTFAT_NAME_REAL(malloc)(2 * d * q * q * W));
     plan->cout = cout;
     plan->f    = f;
+    plan->flags = flags;
 
     /* Get factorization of window */
     CHECKSTATUS(
@@ -107,6 +108,7 @@ LTFAT_NAME(dgt_long_done)(LTFAT_NAME(dgt_long_plan)** plan)
     if (pp->p_veryend) LTFAT_NAME_REAL(fft_done)(&pp->p_veryend);
     if (pp->p_before) LTFAT_NAME_REAL(fft_done)(&pp->p_before);
     if (pp->p_after) LTFAT_NAME_REAL(ifft_done)(&pp->p_after);
+    LTFAT_NAME(dgt_long_set_nthreads)(pp, 1);
     LTFAT_SAFEFREEALL(pp->sbuf, pp->gf, pp->ff, pp->cf);
     ltfat_free(pp);
     pp = NULL;
@@ -114,6 +116,64 @@ error:
     return status;
 }
 
+LTFAT_API int
+LTFAT_NAME(dgt_long_set_nthreads)(LTFAT_NAME(dgt_long_plan)* plan,
+                                  ltfat_int nthreads)
+{
+    LTFAT_NAME_REAL(dgt_long_workspace)* ws;
+    ltfat_int p, q, d, nws;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(plan);
+    CHECK(LTFATERR_BADARG, nthreads >= 0,
+          "nthreads must be nonnegative (passed %td)", nthreads);
+
+    if (plan->pool)
+    {
+        nws = plan->ws ? ltfat_threadpool_get_nthreads(plan->pool) : 0;
+        for (ltfat_int t = 0; t < nws; t++)
+        {
+            ws = &plan->ws[t];
+            if (ws->p_before) LTFAT_NAME_REAL(fft_done)(&ws->p_before);
+            if (ws->p_after) LTFAT_NAME_REAL(ifft_done)(&ws->p_after);
+            LTFAT_SAFEFREEALL(ws->sbuf, ws->ff, ws->cf);
+        }
+        ltfat_free(plan->ws); plan->ws = NULL;
+        ltfat_threadpool_done(&plan->pool);
+    }
+
+    if (nthreads == 0) nthreads = ltfat_threadpool_get_nprocs();
+    if (nthreads == 1) return status;
+
+    p = plan->a / plan->c;
+    q = plan->M / plan->c;
+    d = plan->L / plan->M / p;
+
+    CHECKSTATUS( ltfat_threadpool_init(nthreads, &plan->pool));
+    nws = ltfat_threadpool_get_nthreads(plan->pool);
+    CHECKMEM( plan->ws = LTFAT_NEWARRAY(LTFAT_NAME_REAL(dgt_long_workspace), nws));
+
+    for (ltfat_int t = 0; t < nws; t++)
+    {
+        ws = &plan->ws[t];
+        CHECKMEM( ws->sbuf = LTFAT_NAME_REAL(malloc)(2 * d));
+        CHECKMEM( ws->ff = LTFAT_NAME_REAL(malloc)(2 * d * p * q));
+        CHECKMEM( ws->cf = LTFAT_NAME_REAL(malloc)(2 * d * q * q));
+
+        CHECKSTATUS(
+            LTFAT_NAME_REAL(fft_init)(d, 1, (LTFAT_COMPLEX*) ws->sbuf,
+                                      (LTFAT_COMPLEX*) ws->sbuf, plan->flags, &ws->p_before));
+
+        CHECKSTATUS(
+            LTFAT_NAME_REAL(ifft_init)(d, 1, (LTFAT_COMPLEX*) ws->sbuf,
+                                       (LTFAT_COMPLEX*) ws->sbuf, plan->flags, &ws->p_after));
+    }
+
+    return status;
+error:
+    if (plan) LTFAT_NAME(dgt_long_set_nthreads)(plan, 1);
+    return status;
+}
+
 LTFAT_API int
 LTFAT_NAME(dgt_long_execute)(LTFAT_NAME(dgt_long_plan)* plan)
 {
@@ -175,12 +235,17 @@ error:
     Special code for integer oversampling.
 
     Code works on LTFAT_REAL's instead on LTFAT_COMPLEX
+
+    The function processes a single coset r of channels w0,...,w0+W-1.
+    ws holds scratch buffers and FFT plans sized for W channels.
 */
 
 
-LTFAT_API int
-LTFAT_NAME(dgt_walnut_execute)(LTFAT_NAME(dgt_long_plan)* plan,
-                               LTFAT_COMPLEX* cout)
+static void
+LTFAT_NAME(dgt_walnut_coset)(LTFAT_NAME(dgt_long_plan)* plan,
+                             LTFAT_NAME_REAL(dgt_long_workspace)* ws,
+                             ltfat_int r, ltfat_int w0, ltfat_int W,
+                             LTFAT_COMPLEX* cout)
 {
 
     /*  --------- initial declarations -------------- */
@@ -190,26 +255,25 @@ LTFAT_NAME(dgt_walnut_execute)(LTFAT_NAME(dgt_long_plan)* plan,
     ltfat_int rem;
 
     LTFAT_REAL* ffp, *cfp;
-    LTFAT_TYPE* fp;
+    const LTFAT_TYPE* fp;
 
     /*  ----------- calculation of parameters and plans -------- */
 
     ltfat_int a = plan->a;
     ltfat_int M = plan->M;
     ltfat_int L = plan->L;
-    ltfat_int W = plan->W;
     ltfat_int N = L / a;
     ltfat_int c = plan->c;
     ltfat_int p = a / c;
     ltfat_int q = M / c;
     ltfat_int d = N / q;
 
-    LTFAT_TYPE* f = (LTFAT_TYPE*) plan->f;
+    const LTFAT_TYPE* f = plan->f + w0 * L;
     const LTFAT_COMPLEX* gf = (const LTFAT_COMPLEX*)plan->gf;
 
     ltfat_int h_a = plan->h_a;
 
-    LTFAT_REAL* sbuf = plan->sbuf;
+    LTFAT_REAL* sbuf = ws->sbuf;
     //LTFAT_COMPLEX* cout = plan->cout;
 
     /* Scaling constant needed because of FFTWs normalization. */
@@ -223,11 +287,10 @@ LTFAT_NAME(dgt_walnut_execute)(LTFAT_NAME(dgt_long_plan)* plan,
     ltfat_int ld3b = 2 * q * q * W;
     ltfat_int ld5c = M * N;
 
-    /* --------- main loop begins here ------------------- */
-    for (ltfat_int r = 0; r < c; r++)
+    /* --------- main loop body begins here ------------------- */
     {
         /*  ---------- compute signal factorization ----------- */
-        ffp = plan->ff;
+        ffp = ws->ff;
         fp = f + r;
         if (p == 1)
         {
@@ -248,7 +311,7 @@ LTFAT_NAME(dgt_walnut_execute)(LTFAT_NAME(dgt_long_plan)* plan,
 #endif
                     }
 
-                    LTFAT_NAME_REAL(fft_execute)(plan->p_before);
+                    LTFAT_NAME_REAL(fft_execute)(ws->p_before);
 
                     for (ltfat_int s = 0; s < d; s++)
                     {
@@ -265,8 +328,8 @@ LTFAT_NAME(dgt_walnut_execute)(LTFAT_NAME(dgt_long_plan)* plan,
             for (ltfat_int s = 0; s < d; s++)
             {
                 gbase = (LTFAT_REAL*)gf + 2 * (r + s * c) * q;
-                fbase = plan->ff + 2 * s * q * W;
-                cbase = plan->cf + 2 * s * q * q * W;
+                fbase = ws->ff + 2 * s * q * W;
+                cbase = ws->cf + 2 * s * q * q * W;
 
                 for (ltfat_int nm = 0; nm < q * W; nm++)
                 {
@@ -305,7 +368,7 @@ LTFAT_NAME(dgt_walnut_execute)(LTFAT_NAME(dgt_long_plan)* plan,
 #endif
                         }
 
-                        LTFAT_NAME_REAL(fft_execute)(plan->p_before);
+                        LTFAT_NAME_REAL(fft_execute)(ws->p_before);
 
                         for (ltfat_int s = 0; s < d; s++)
                         {
@@ -323,8 +386,8 @@ LTFAT_NAME(dgt_walnut_execute)(LTFAT_NAME(dgt_long_plan)* plan,
             for (ltfat_int s = 0; s < d; s++)
             {
                 gbase = (LTFAT_REAL*)gf + 2 * (r + s * c) * p * q;
-                fbase = plan->ff + 2 * s * p * q * W;
-                cbase = plan->cf + 2 * s * q * q * W;
+                fbase = ws->ff + 2 * s * p * q * W;
+                cbase = ws->cf + 2 * s * q * q * W;
 
                 for (ltfat_int nm = 0; nm < q * W; nm++)
                 {
@@ -352,7 +415,7 @@ LTFAT_NAME(dgt_walnut_execute)(LTFAT_NAME(dgt_long_plan)* plan,
         } /* end of if p==1 */
 
         /*  -------  compute inverse coefficient factorization ------- */
-        cfp = plan->cf;
+        cfp = ws->cf;
 
         /* Cover both integer and rational sampling case */
         for (ltfat_int w = 0; w < W; w++)
@@ -370,11 +433,11 @@ LTFAT_NAME(dgt_walnut_execute)(LTFAT_NAME(dgt_long_plan)* plan,
                     cfp += 2;
 
                     /* Do inverse fft of length d */
-                    LTFAT_NAME_REAL(ifft_execute)(plan->p_after);
+                    LTFAT_NAME_REAL(ifft_execute)(ws->p_after);
 
                     for (ltfat_int s = 0; s < d; s++)
                     {
-                        rem = r + l * c + ltfat_positiverem(u + s * q - l * h_a, N) * M + w * ld5c;
+                        rem = r + l * c + ltfat_positiverem(u + s * q - l * h_a, N) * M + (w0 + w) * ld5c;
                         LTFAT_REAL* coutTmp = (LTFAT_REAL*) &cout[rem];
                         coutTmp[0] = sbuf[2 * s];
                         coutTmp[1] = sbuf[2 * s + 1];
@@ -384,7 +447,48 @@ LTFAT_NAME(dgt_walnut_execute)(LTFAT_NAME(dgt_long_plan)* plan,
         }
 
 
-        /* ----------- Main loop ends here ------------------------ */
+        /* ----------- Main loop body ends here ------------------------ */
+    }
+}
+
+typedef struct
+{
+    LTFAT_NAME(dgt_long_plan)* plan;
+    LTFAT_COMPLEX* cout;
+} LTFAT_NAME(dgt_walnut_taskdata);
+
+static void
+LTFAT_NAME(dgt_walnut_task)(void* userdata, ltfat_int taskid, ltfat_int workerid)
+{
+    LTFAT_NAME(dgt_walnut_taskdata)* td =
+        (LTFAT_NAME(dgt_walnut_taskdata)*) userdata;
+    ltfat_int c = td->plan->c;
+
+    LTFAT_NAME(dgt_walnut_coset)(td->plan, &td->plan->ws[workerid],
+                                 taskid % c, taskid / c, 1, td->cout);
+}
+
+LTFAT_API int
+LTFAT_NAME(dgt_walnut_execute)(LTFAT_NAME(dgt_long_plan)* plan,
+                               LTFAT_COMPLEX* cout)
+{
+    if (plan->pool)
+    {
+        /* Cosets and channels are independent, the workers write to
+         * disjoint parts of cout. */
+        LTFAT_NAME(dgt_walnut_taskdata) td = { plan, cout };
+        return ltfat_threadpool_execute(plan->pool, plan->c * plan->W,
+                                        &LTFAT_NAME(dgt_walnut_task), &td);
+    }
+    else
+    {
+        LTFAT_NAME_REAL(dgt_long_workspace) ws =
+        {
+            plan->p_before, plan->p_after, plan->sbuf, plan->ff, plan->cf
+        };
+
+        for (ltfat_int r = 0; r < plan->c; r++)
+            LTFAT_NAME(dgt_walnut_coset)(plan, &ws, r, 0, plan->W, cout);
     }
 
     return LTFATERR_SUCCESS;
@@ -4,6 +4,18 @@
 
 #include "ltfat/thirdparty/fftw3.h"
 
+#ifndef _ltfat_dgt_long_private_h
+#define _ltfat_dgt_long_private_h
+/* Scratch of a single worker. It covers one coset and one channel. */
+typedef struct
+{
+    LTFAT_NAME_REAL(fft_plan)* p_before;
+    LTFAT_NAME_REAL(ifft_plan)* p_after;
+    LTFAT_REAL* sbuf;
+    LTFAT_REAL* ff, *cf;
+} LTFAT_NAME_REAL(dgt_long_workspace);
+#endif
+
 struct LTFAT_NAME_REAL(dgt_long_plan)
 {
     ltfat_int a;
@@ -21,6 +33,9 @@ struct LTFAT_NAME_REAL(dgt_long_plan)
     LTFAT_COMPLEX* gf;
     LTFAT_COMPLEX* cout;
     LTFAT_REAL* ff, *cf;
+    unsigned flags;
+    ltfat_threadpool* pool;
+    LTFAT_NAME_REAL(dgt_long_workspace)* ws;
 };
 
 struct LTFAT_NAME_COMPLEX(dgt_long_plan)
@@ -40,5 +55,8 @@ struct LTFAT_NAME_COMPLEX(dgt_long_plan)
     LTFAT_COMPLEX* gf;
     LTFAT_COMPLEX* cout;
     LTFAT_REAL* ff, *cf;
+    unsigned flags;
+    ltfat_threadpool* pool;
+    LTFAT_NAME_REAL(dgt_long_workspace)* ws;
 };
 
@@ -73,6 +73,7 @@ LTFAT_NAME(dgtreal_long_init)( const LTFAT_REAL* g,
 
     plan->cout = cout;
     plan->f    = f;
+    plan->flags = flags;
     CHECKMEM( plan->sbuf = LTFAT_NAME_REAL(malloc)( d ));
     CHECKMEM( plan->cbuf = LTFAT_NAME_COMPLEX(malloc)(d2));
     CHECKMEM( plan->ff = LTFAT_NAME_REAL(malloc)(2 * d2 * p * q * W));
@@ -112,6 +113,7 @@ LTFAT_NAME(dgtreal_long_done)(LTFAT_NAME(dgtreal_long_plan)** plan)
     if (pp->p_veryend) LTFAT_NAME(fftreal_done)(&pp->p_veryend);
     if (pp->p_before)  LTFAT_NAME(fftreal_done)(&pp->p_before);
     if (pp->p_after)   LTFAT_NAME(ifftreal_done)(&pp->p_after);
+    LTFAT_NAME(dgtreal_long_set_nthreads)(pp, 1);
     LTFAT_SAFEFREEALL(pp->sbuf, pp->cbuf,// pp->cwork,
                       pp->gf, pp->ff, pp->cf);
     ltfat_free(pp);
@@ -120,6 +122,64 @@ error:
     return status;
 }
 
+LTFAT_API int
+LTFAT_NAME(dgtreal_long_set_nthreads)(LTFAT_NAME(dgtreal_long_plan)* plan,
+                                      ltfat_int nthreads)
+{
+    LTFAT_NAME(dgtreal_long_workspace)* ws;
+    ltfat_int p, q, d, d2, nws;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(plan);
+    CHECK(LTFATERR_BADARG, nthreads >= 0,
+          "nthreads must be nonnegative (passed %td)", nthreads);
+
+    if (plan->pool)
+    {
+        nws = plan->ws ? ltfat_threadpool_get_nthreads(plan->pool) : 0;
+        for (ltfat_int t = 0; t < nws; t++)
+        {
+            ws = &plan->ws[t];
+            if (ws->p_before) LTFAT_NAME(fftreal_done)(&ws->p_before);
+            if (ws->p_after)  LTFAT_NAME(ifftreal_done)(&ws->p_after);
+            LTFAT_SAFEFREEALL(ws->sbuf, ws->cbuf, ws->ff, ws->cf);
+        }
+        ltfat_free(plan->ws); plan->ws = NULL;
+        ltfat_threadpool_done(&plan->pool);
+    }
+
+    if (nthreads == 0) nthreads = ltfat_threadpool_get_nprocs();
+    if (nthreads == 1) return status;
+
+    p = plan->a / plan->c;
+    q = plan->M / plan->c;
+    d = plan->L / plan->M / p;
+    d2 = d / 2 + 1;
+
+    CHECKSTATUS( ltfat_threadpool_init(nthreads, &plan->pool));
+    nws = ltfat_threadpool_get_nthreads(plan->pool);
+    CHECKMEM( plan->ws = LTFAT_NEWARRAY(LTFAT_NAME(dgtreal_long_workspace), nws));
+
+    for (ltfat_int t = 0; t < nws; t++)
+    {
+        ws = &plan->ws[t];
+        CHECKMEM( ws->sbuf = LTFAT_NAME_REAL(malloc)( d ));
+        CHECKMEM( ws->cbuf = LTFAT_NAME_COMPLEX(malloc)(d2));
+        CHECKMEM( ws->ff = LTFAT_NAME_REAL(malloc)(2 * d2 * p * q));
+        CHECKMEM( ws->cf = LTFAT_NAME_REAL(malloc)(2 * d2 * q * q));
+
+        CHECKSTATUS(
+            LTFAT_NAME(fftreal_init)(d, 1, ws->sbuf, ws->cbuf, plan->flags, &ws->p_before));
+
+        CHECKSTATUS(
+            LTFAT_NAME(ifftreal_init)(d, 1, ws->cbuf, ws->sbuf, plan->flags, &ws->p_after));
+    }
+
+    return status;
+error:
+    if (plan) LTFAT_NAME(dgtreal_long_set_nthreads)(plan, 1);
+    return status;
+}
+
 LTFAT_API int
 LTFAT_NAME(dgtreal_long_execute)(LTFAT_NAME(dgtreal_long_plan)* plan)
 {
@@ -182,17 +242,20 @@ error:
 
     Special code for integer oversampling.
 
+    The function processes a single coset r of channels w0,...,w0+W-1.
+    ws holds scratch buffers and FFT plans sized for W channels.
 */
 
-LTFAT_API int
-LTFAT_NAME(dgtreal_walnut_plan)(LTFAT_NAME(dgtreal_long_plan)* plan)
+static void
+LTFAT_NAME(dgtreal_walnut_coset)(LTFAT_NAME(dgtreal_long_plan)* plan,
+                                 LTFAT_NAME(dgtreal_long_workspace)* ws,
+                                 ltfat_int r, ltfat_int w0, ltfat_int W)
 {
     /*  --------- initial declarations -------------- */
 
     ltfat_int a = plan->a;
     ltfat_int M = plan->M;
     ltfat_int L = plan->L;
-    ltfat_int W = plan->W;
     ltfat_int N = L / a;
     ltfat_int c = plan->c;
     ltfat_int p = a / c;
@@ -204,13 +267,13 @@ LTFAT_NAME(dgtreal_walnut_plan)(LTFAT_NAME(dgtreal_long_plan)* plan)
     /* This is a floor operation. */
     ltfat_int d2 = d / 2 + 1;
 
-    const LTFAT_REAL* f = plan->f;
+    const LTFAT_REAL* f = plan->f + w0 * L;
     const LTFAT_COMPLEX* gf = (const LTFAT_COMPLEX*)plan->gf;
 
     ltfat_int h_a = plan->h_a;
 
-    LTFAT_REAL* sbuf = plan->sbuf;
-    LTFAT_COMPLEX* cbuf = plan->cbuf;
+    LTFAT_REAL* sbuf = ws->sbuf;
+    LTFAT_COMPLEX* cbuf = ws->cbuf;
 
     LTFAT_REAL* cout = (LTFAT_REAL*) plan->cout;
 
@@ -231,11 +294,10 @@ LTFAT_NAME(dgtreal_walnut_plan)(LTFAT_NAME(dgtreal_long_plan)* plan)
     /* Leading dimensions of cf */
     ltfat_int ld3b = 2 * q * q * W;
 
-    /* --------- main loop begins here ------------------- */
-    for (ltfat_int r = 0; r < c; r++)
+    /* --------- main loop body begins here ------------------- */
     {
         /*  ---------- compute signal factorization ----------- */
-        ffp = plan->ff;
+        ffp = ws->ff;
         fp = f + r;
         if (p == 1)
         {
@@ -249,7 +311,7 @@ LTFAT_NAME(dgtreal_walnut_plan)(LTFAT_NAME(dgtreal_long_plan)* plan)
                         sbuf[s]   = fp[(s * M + l * a) % L];
                     }
 
-                    LTFAT_NAME(fftreal_execute)(plan->p_before);
+                    LTFAT_NAME(fftreal_execute)(ws->p_before);
 
                     for (ltfat_int s = 0; s < d2; s++)
                     {
@@ -277,7 +339,7 @@ LTFAT_NAME(dgtreal_walnut_plan)(LTFAT_NAME(dgtreal_long_plan)* plan)
                             sbuf[s]   = fp[ ltfat_positiverem(k * M + s * p * M - l * h_a * a, L) ];
                         }
 
-                        LTFAT_NAME(fftreal_execute)(plan->p_before);
+                        LTFAT_NAME(fftreal_execute)(ws->p_before);
 
                         for (ltfat_int s = 0; s < d2; s++)
                         {
@@ -304,8 +366,8 @@ LTFAT_NAME(dgtreal_walnut_plan)(LTFAT_NAME(dgtreal_long_plan)* plan)
             for (ltfat_int s = 0; s < d2; s++)
             {
                 gbase = (LTFAT_REAL*)gf + 2 * (r + s * c) * q;
-                fbase = plan->ff + 2 * s * q * W;
-                cbase = plan->cf + 2 * s * q * q * W;
+                fbase = ws->ff + 2 * s * q * W;
+                cbase = ws->cf + 2 * s * q * q * W;
 
                 for (ltfat_int nm = 0; nm < q * W; nm++)
                 {
@@ -330,8 +392,8 @@ LTFAT_NAME(dgtreal_walnut_plan)(LTFAT_NAME(dgtreal_long_plan)* plan)
             for (ltfat_int s = 0; s < d2; s++)
             {
                 gbase = (LTFAT_REAL*)gf + 2 * (r + s * c) * p * q;
-                fbase = plan->ff + 2 * s * p * q * W;
-                cbase = plan->cf + 2 * s * q * q * W;
+                fbase = ws->ff + 2 * s * p * q * W;
+                cbase = ws->cf + 2 * s * q * q * W;
 
                 for (ltfat_int nm = 0; nm < q * W; nm++)
                 {
@@ -360,7 +422,7 @@ LTFAT_NAME(dgtreal_walnut_plan)(LTFAT_NAME(dgtreal_long_plan)* plan)
 
 
         /*  -------  compute inverse coefficient factorization ------- */
-        LTFAT_REAL* cfp = plan->cf;
+        LTFAT_REAL* cfp = ws->cf;
         ltfat_int ld5c = 2 * M2 * N;
 
         /* Cover both integer and rational sampling case */
@@ -380,20 +442,54 @@ LTFAT_NAME(dgtreal_walnut_plan)(LTFAT_NAME(dgtreal_long_plan)* plan)
                     cfp += 2;
 
                     /* Do inverse fft of length d */
-                    LTFAT_NAME(ifftreal_execute)(plan->p_after);
+                    LTFAT_NAME(ifftreal_execute)(ws->p_after);
 
                     for (ltfat_int s = 0; s < d; s++)
                     {
                         cout[ r + l * c + ltfat_positiverem(u + s * q - l * h_a,
-                                                            N) * 2 * M2 + w * ld5c ] = sbuf[s];
+                                                            N) * 2 * M2 + (w0 + w) * ld5c ] = sbuf[s];
                     }
                 }
             }
         }
 
 
-        /* ----------- Main loop ends here ------------------------ */
+        /* ----------- Main loop body ends here ------------------------ */
+    }
+}
+
+static void
+LTFAT_NAME(dgtreal_walnut_task)(void* userdata, ltfat_int taskid,
+                                ltfat_int workerid)
+{
+    LTFAT_NAME(dgtreal_long_plan)* plan =
+        (LTFAT_NAME(dgtreal_long_plan)*) userdata;
+
+    LTFAT_NAME(dgtreal_walnut_coset)(plan, &plan->ws[workerid],
+                                     taskid % plan->c, taskid / plan->c, 1);
+}
+
+LTFAT_API int
+LTFAT_NAME(dgtreal_walnut_plan)(LTFAT_NAME(dgtreal_long_plan)* plan)
+{
+    if (plan->pool)
+    {
+        /* Cosets and channels are independent, the workers write to
+         * disjoint parts of cout. */
+        return ltfat_threadpool_execute(plan->pool, plan->c * plan->W,
+                                        &LTFAT_NAME(dgtreal_walnut_task), plan);
+    }
+    else
+    {
+        LTFAT_NAME(dgtreal_long_workspace) ws =
+        {
+            plan->p_before, plan->p_after, plan->sbuf, plan->cbuf,
+            plan->ff, plan->cf
+        };
+
+        for (ltfat_int r = 0; r < plan->c; r++)
+            LTFAT_NAME(dgtreal_walnut_coset)(plan, &ws, r, 0, plan->W);
     }
 
-    return 0;
+    return LTFATERR_SUCCESS;
 }
@@ -4,6 +4,16 @@
 
 #include "ltfat/thirdparty/fftw3.h"
 
+/* Scratch of a single worker. It covers one coset and one channel. */
+typedef struct
+{
+    LTFAT_NAME(fftreal_plan)* p_before;
+    LTFAT_NAME(ifftreal_plan)* p_after;
+    LTFAT_REAL* sbuf;
+    LTFAT_COMPLEX* cbuf;
+    LTFAT_REAL* ff, *cf;
+} LTFAT_NAME(dgtreal_long_workspace);
+
 struct LTFAT_NAME(dgtreal_long_plan)
 {
     ltfat_int a;
@@ -23,4 +33,7 @@ struct LTFAT_NAME(dgtreal_long_plan)
     LTFAT_REAL* cwork;
     LTFAT_COMPLEX* cout;
     LTFAT_REAL* ff, *cf;
+    unsigned flags;
+    ltfat_threadpool* pool;
+    LTFAT_NAME(dgtreal_long_workspace)* ws;
 };
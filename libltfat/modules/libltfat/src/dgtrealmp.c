@@ -232,6 +232,27 @@ LTFAT_NAME(dgtrealmp_init_gen)(
         p->params->do_pedantic = 1;
     }
 
+    if (p->params->alg == ltfat_dgtmp_alg_batchmp)
+    {
+        LTFAT_NAME(dgtrealmpiter_state)* s = p->iterstate;
+        size_t batchsize = p->params->batchsize;
+        s->batchCap = 4 * batchsize;
+
+        CHECKMEM( s->batchPos    = LTFAT_NEWARRAY( kpoint, s->batchCap) );
+        CHECKMEM( s->batchVal    = LTFAT_NAME_REAL(malloc)( s->batchCap) );
+        CHECKMEM( s->batchTmpVal = LTFAT_NAME_REAL(malloc)( s->batchCap) );
+        CHECKMEM( s->batchTmpPos = LTFAT_NEWARRAY( ltfat_int, s->batchCap) );
+        CHECKMEM( s->batchSel    = LTFAT_NEWARRAY( kpoint, batchsize) );
+        CHECKMEM( s->batchCval   = LTFAT_NAME_COMPLEX(malloc)( batchsize) );
+        CHECKMEM( s->batchEnergy = LTFAT_NAME_REAL(malloc)( batchsize) );
+        CHECKMEM( s->colStamp    = LTFAT_NEWARRAY( size_t*, P) );
+
+        for (ltfat_int k = 0; k < P; k++)
+            CHECKMEM( s->colStamp[k] = LTFAT_NEWARRAY( size_t, p->N[k]) );
+
+        CHECKSTATUS( ltfat_threadpool_init(p->params->batchthreads, &s->pool));
+    }
+
     if (p->params->ptype == LTFAT_FREQINV)
     {
         CHECKMEM(p->iterstate->cvalModBuf = LTFAT_NEWARRAY(LTFAT_COMPLEX*, P * P));
@@ -245,6 +266,26 @@ LTFAT_NAME(dgtrealmp_init_gen)(
                              LTFAT_NAME_COMPLEX(malloc)( h2));
             }
         }
+
+        if (p->iterstate->pool)
+        {
+            LTFAT_NAME(dgtrealmpiter_state)* s = p->iterstate;
+            ltfat_int nth = ltfat_threadpool_get_nthreads(s->pool);
+
+            CHECKMEM( s->wcvalModBuf = LTFAT_NEWARRAY(LTFAT_COMPLEX**, nth));
+            s->wcvalModBuf[0] = s->cvalModBuf;
+
+            for (ltfat_int w = 1; w < nth; w++)
+            {
+                CHECKMEM( s->wcvalModBuf[w] = LTFAT_NEWARRAY(LTFAT_COMPLEX*, P * P));
+                for (ltfat_int kIdx = 0; kIdx < P * P; kIdx++)
+                {
+                    LTFAT_NAME(kerns)* currkern = p->gramkerns[kIdx];
+                    ltfat_int h2 = ltfat_idivceil( currkern->size.height , currkern->Mstep);
+                    CHECKMEM(s->wcvalModBuf[w][kIdx] = LTFAT_NAME_COMPLEX(malloc)( h2));
+                }
+            }
+        }
     }
 
 
@@ -299,6 +340,8 @@ LTFAT_NAME(dgtrealmp_reset)(LTFAT_NAME(dgtrealmp_state)* p, const LTFAT_REAL* f)
     istate->currit = 0;
     istate->curratoms = 0;
     istate->err = 0.0;
+    istate->outoforder = 0;
+    istate->maxdev = 0.0;
 
     for (ltfat_int l = 0; l < p->L; l++)
         istate->err += f[l] * f[l];
@@ -387,6 +430,11 @@ LTFAT_NAME(dgtrealmp_execute_niters)(
         case ltfat_dgtmp_alg_locselfprojmp:
             status  = LTFAT_NAME(dgtrealmp_execute_selfprojmp)( p, origpos, cout);
             break;
+        case ltfat_dgtmp_alg_batchmp:
+            status  = LTFAT_NAME(dgtrealmp_execute_batchmp)( p, origpos,
+                      itno - iter, cout);
+            iter += s->batchNo - 1;
+            break;
         }
 
         if (s->err < 0)
@@ -688,6 +736,34 @@ LTFAT_NAME(dgtrealmpiter_done)(LTFAT_NAME(dgtrealmpiter_state)** state)
     ltfat_safefree(s->cvalinvBuf);
     ltfat_safefree(s->cvalBufPos);
     ltfat_safefree(s->pBuf);
+
+    if (s->wcvalModBuf)
+    {
+        for (ltfat_int w = 1; w < ltfat_threadpool_get_nthreads(s->pool); w++)
+        {
+            if (s->wcvalModBuf[w])
+            {
+                for (ltfat_int p = 0; p < s->P * s->P; p++)
+                    ltfat_safefree(s->wcvalModBuf[w][p]);
+
+                ltfat_free(s->wcvalModBuf[w]);
+            }
+        }
+
+        ltfat_free(s->wcvalModBuf);
+    }
+
+    if (s->colStamp)
+    {
+        for (ltfat_int p = 0; p < s->P; p++)
+            ltfat_safefree(s->colStamp[p]);
+
+        ltfat_free(s->colStamp);
+    }
+
+    LTFAT_SAFEFREEALL(s->batchPos, s->batchVal, s->batchTmpVal, s->batchTmpPos,
+                      s->batchSel, s->batchCval, s->batchEnergy);
+    if (s->pool) ltfat_threadpool_done(&s->pool);
     if (s->hplan) LTFAT_NAME_COMPLEX(hermsystemsolver_done)(&s->hplan);
     ltfat_safefree(s->N);
     ltfat_free(s);
@@ -783,6 +859,21 @@ error:
     return status;
 }
 
+LTFAT_API int
+LTFAT_NAME(dgtrealmp_get_orderdeviation)(
+    const LTFAT_NAME(dgtrealmp_state)* p, size_t* outoforder, double* maxdevdb)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(outoforder); CHECKNULL(maxdevdb);
+
+    *outoforder = p->iterstate->outoforder;
+    *maxdevdb = 0.0;
+    if (p->iterstate->maxdev > 0.0)
+        *maxdevdb = 10.0 * log10(p->iterstate->maxdev);
+error:
+    return status;
+}
+
 LTFAT_API ltfat_int
 LTFAT_NAME(dgtrealmp_get_dictno)(
     const LTFAT_NAME(dgtrealmp_state)* p)
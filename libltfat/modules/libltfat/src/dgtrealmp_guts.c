@@ -50,12 +50,12 @@ MLOOPBOTH(\
 else if (p->params->ptype == LTFAT_FREQINV){\
     for(ltfat_int kmidx = kstart2.m, mmidx = 0; kmidx < k->size.height;\
         kmidx += k->Mstep, mmidx++){\
-        s->cvalModBuf[kIdx][mmidx] = ctmp * kexp[kmidx];}\
+        cvalModBuf[kIdx][mmidx] = ctmp * kexp[kmidx];}\
 NLOOPBOTH(\
     LTFAT_COMPLEX* currcCol = s->c[w2] + nidx * p->M2[w2];\
     LTFAT_COMPLEX* kcurrCol = k->kval + knidx * k->size.height;\
 MLOOPBOTH(\
-    currcCol[midx] = currcCol[midx] SIGN s->cvalModBuf[kIdx][mmidx] * kcurrCol[kmidx]; \
+    currcCol[midx] = currcCol[midx] SIGN cvalModBuf[kIdx][mmidx] * kcurrCol[kmidx]; \
     ))}}
 
 #define LTFAT_DGTREALMP_MARKMODIFIED \
@@ -63,6 +63,7 @@ NLOOPBOTH(\
     LTFAT_NAME(maxtree_setdirty)(s->fmaxtree[w2][nidx],\
                                  m2start + k->srange[knidx].start,\
                                  m2start + kdim2.height - k->srange[knidx].end);)\
+if (do_marktmaxtree)\
     LTFAT_NAME(maxtree_setdirty)(s->tmaxtree[w2],       n2start, n2start + kdim2.width);
 
 int
@@ -389,6 +390,203 @@ LTFAT_NAME(dgtrealmp_execute_mp)(
     return projenergy;
 }
 
+/* Range of columns of dictionary w2 touched by the update of atom origpos */
+static void
+LTFAT_NAME(dgtrealmp_execute_batchcols)(
+    LTFAT_NAME(dgtrealmp_state)* p, kpoint origpos, ltfat_int w2,
+    ltfat_int* n2start, ltfat_int* width)
+{
+    ltfat_int m2start;
+    ksize   kdim2; kanchor kmid2; kpoint  kstart2;
+    kpoint pos; pos.w = w2;
+
+    LTFAT_NAME(dgtrealmp_execute_indices)(
+        p, origpos, &pos, &m2start, n2start, &kdim2, &kmid2, &kstart2);
+
+    *n2start = ltfat_positiverem(*n2start, p->N[w2]);
+    *width = ltfat_imin(kdim2.width, p->N[w2]);
+}
+
+/* Checks (do_mark = 0) whether the update of atom at origpos would touch
+ * a column already touched by the current batch or marks (do_mark = 1) the
+ * columns as touched. */
+static int
+LTFAT_NAME(dgtrealmp_execute_batchfootprint)(
+    LTFAT_NAME(dgtrealmp_state)* p, kpoint origpos, int do_mark)
+{
+    LTFAT_NAME(dgtrealmpiter_state)* s = p->iterstate;
+
+    for (ltfat_int w2 = 0; w2 < s->P; w2++)
+    {
+        ltfat_int nidx, width;
+        size_t* stampCol = s->colStamp[w2];
+
+        LTFAT_NAME(dgtrealmp_execute_batchcols)(p, origpos, w2, &nidx, &width);
+
+        for (ltfat_int ii = 0; ii < width; ii++)
+        {
+            if (do_mark)
+                stampCol[nidx] = s->stamp;
+            else if (stampCol[nidx] == s->stamp)
+                return 1;
+
+            if (++nidx >= p->N[w2]) nidx = 0;
+        }
+    }
+    return 0;
+}
+
+/* Applies the update of one atom from the batch and refreshes the maxima of
+ * the touched columns. The columns are private to the atom, but tmaxtree is
+ * shared and it is updated by the caller. */
+static void
+LTFAT_NAME(dgtrealmp_execute_batchtask)(void* userdata, ltfat_int taskid,
+                                        ltfat_int workerid)
+{
+    LTFAT_NAME(dgtrealmp_state)* p = (LTFAT_NAME(dgtrealmp_state)*) userdata;
+    LTFAT_NAME(dgtrealmpiter_state)* s = p->iterstate;
+    kpoint pos = s->batchSel[taskid];
+
+    LTFAT_NAME(dgtrealmp_execute_updateresiduum_gen)(
+        p, pos, s->batchCval[taskid], 1,
+        s->wcvalModBuf ? s->wcvalModBuf[workerid] : NULL, 0);
+
+    s->suppind[PTOI(pos)]++;
+    s->batchCout[PTOI(pos)] += s->batchCval[taskid];
+
+    for (ltfat_int w2 = 0; w2 < s->P; w2++)
+    {
+        ltfat_int nidx, width;
+        LTFAT_NAME(dgtrealmp_execute_batchcols)(p, pos, w2, &nidx, &width);
+
+        for (ltfat_int ii = 0; ii < width; ii++)
+        {
+            LTFAT_NAME(maxtree_findmax)( s->fmaxtree[w2][nidx],
+                                         &s->maxcols[w2][nidx],
+                                         &s->maxcolspos[w2][nidx]);
+
+            if (++nidx >= p->N[w2]) nidx = 0;
+        }
+    }
+}
+
+/* Selects up to maxno atoms with mutually non-overlapping kernel supports,
+ * starting with the global maximum at origpos, and applies their updates
+ * concurrently. Atoms from the batch do not change each others inner
+ * products, so the result is the same as doing MP with the atoms in the
+ * batch order. Strict MP would pick a different atom only if a skipped
+ * (overlapping) candidate with higher energy would still have the highest
+ * energy after the preceeding updates. */
+int
+LTFAT_NAME(dgtrealmp_execute_batchmp)(
+    LTFAT_NAME(dgtrealmp_state)* p,
+    kpoint origpos, size_t maxno, LTFAT_COMPLEX** cout)
+{
+    LTFAT_NAME(dgtrealmpiter_state)* s = p->iterstate;
+    LTFAT_REAL skippedmax = 0.0;
+    long double errpred = s->err;
+
+    s->stamp++;
+    s->batchCandNo = 0;
+    s->batchNo = 0;
+    if (maxno > p->params->batchsize) maxno = p->params->batchsize;
+
+    /* The strongest column maxima of all dictionaries, sorted in descending
+     * order. The column maxima are up to date after findmaxatom. */
+    for (ltfat_int w = 0; w < s->P && maxno > 1; w++)
+    {
+        ltfat_int found = 0;
+        LTFAT_NAME(maxtree_findmaxn)(s->tmaxtree[w], (ltfat_int) s->batchCap,
+                                     s->batchTmpVal, s->batchTmpPos, &found);
+
+        for (ltfat_int fIdx = 0; fIdx < found; fIdx++)
+        {
+            LTFAT_REAL val = s->batchTmpVal[fIdx];
+            ltfat_int n = s->batchTmpPos[fIdx];
+            size_t ii = s->batchCandNo;
+
+            if (ii == s->batchCap)
+            {
+                if (val <= s->batchVal[ii - 1]) break;
+                ii--;
+            }
+            else
+                s->batchCandNo++;
+
+            for (; ii > 0 && s->batchVal[ii - 1] < val; ii--)
+            {
+                s->batchVal[ii] = s->batchVal[ii - 1];
+                s->batchPos[ii] = s->batchPos[ii - 1];
+            }
+            s->batchVal[ii] = val;
+            s->batchPos[ii] = kpoint_init(s->maxcolspos[w][n], n, w);
+        }
+    }
+
+    for (size_t cIdx = 0; cIdx <= s->batchCandNo && s->batchNo < maxno; cIdx++)
+    {
+        kpoint pos = origpos;
+
+        if (cIdx > 0)
+        {
+            pos = s->batchPos[cIdx - 1];
+
+            if ( kpoint_isequal(pos, origpos) ||
+                 ltfat_norm(s->c[PTOI(pos)]) < p->params->atprodreltoladj ||
+                 s->curratoms >= p->params->maxatoms ||
+                 s->currit + s->batchNo > p->params->maxit ||
+                 errpred <= p->params->errtoladj )
+                continue;
+
+            if (LTFAT_NAME(dgtrealmp_execute_batchfootprint)(p, pos, 0))
+            {
+                if (s->batchVal[cIdx - 1] > skippedmax)
+                    skippedmax = s->batchVal[cIdx - 1];
+                continue;
+            }
+
+            if (skippedmax > 0.0)
+            {
+                LTFAT_REAL dev = skippedmax / s->batchVal[cIdx - 1];
+                if (dev > s->maxdev) s->maxdev = dev;
+                s->outoforder++;
+            }
+
+            if ( !s->suppind[PTOI(pos)] ) s->curratoms++;
+        }
+
+        LTFAT_NAME(dgtrealmp_execute_batchfootprint)(p, pos, 1);
+
+        LTFAT_NAME(dgtrealmp_execute_dualprodandprojenergy)(
+            p, pos, s->c[PTOI(pos)],
+            &s->batchCval[s->batchNo], &s->batchEnergy[s->batchNo]);
+
+        errpred -= s->batchEnergy[s->batchNo];
+        s->batchSel[s->batchNo++] = pos;
+    }
+
+    s->currit += s->batchNo - 1;
+    s->batchCout = cout;
+
+    ltfat_threadpool_execute(s->pool, (ltfat_int) s->batchNo,
+                             LTFAT_NAME(dgtrealmp_execute_batchtask), p);
+
+    for (size_t bIdx = 0; bIdx < s->batchNo; bIdx++)
+    {
+        s->err -= s->batchEnergy[bIdx];
+
+        for (ltfat_int w2 = 0; w2 < s->P; w2++)
+        {
+            ltfat_int n2start, width;
+            LTFAT_NAME(dgtrealmp_execute_batchcols)(
+                p, s->batchSel[bIdx], w2, &n2start, &width);
+            LTFAT_NAME(maxtree_updaterange)(s->tmaxtree[w2], n2start, n2start + width);
+        }
+    }
+
+    return LTFAT_DGTREALMP_STATUS_CANCONTINUE;
+}
+
 LTFAT_REAL
 LTFAT_NAME(dgtrealmp_execute_invmp)(
     LTFAT_NAME(dgtrealmp_state)* p,
@@ -506,7 +704,18 @@ LTFAT_NAME(dgtrealmp_execute_updateresiduum)(
     LTFAT_NAME(dgtrealmp_state)* p, kpoint origpos, LTFAT_COMPLEX cval,
     int do_substract)
 {
+    return LTFAT_NAME(dgtrealmp_execute_updateresiduum_gen)(
+               p, origpos, cval, do_substract, p->iterstate->cvalModBuf, 1);
+}
 
+/* Updates of atoms touching disjoint sets of columns can run concurrently
+ * provided each one uses its own cvalModBuf and tmaxtree is marked
+ * afterwards (do_marktmaxtree = 0). */
+int
+LTFAT_NAME(dgtrealmp_execute_updateresiduum_gen)(
+    LTFAT_NAME(dgtrealmp_state)* p, kpoint origpos, LTFAT_COMPLEX cval,
+    int do_substract, LTFAT_COMPLEX** cvalModBuf, int do_marktmaxtree)
+{
 
     int uniquenyquest = p->M[origpos.w] % 2 == 0;
     int do_conj = !( origpos.m == 0 ||
@@ -639,15 +848,24 @@ LTFAT_NAME(dgtrealmp_execute_findmaxatom)(
 
         ltfat_int N = p->N[k];
 
-        dirtystart = ltfat_positiverem(dirtystart, N);
-        dirtyend =   ltfat_positiverem(dirtyend,   N);
-
         ltfat_int over = 0;
-        if (dirtyend < dirtystart)
+        if (dirtyend - dirtystart >= N)
         {
-            over = dirtyend;
+            /* The dirty range can cover all columns */
+            dirtystart = 0;
             dirtyend = N;
         }
+        else
+        {
+            dirtystart = ltfat_positiverem(dirtystart, N);
+            dirtyend =   ltfat_positiverem(dirtyend,   N);
+
+            if (dirtyend < dirtystart)
+            {
+                over = dirtyend;
+                dirtyend = N;
+            }
+        }
 
         for (ltfat_int nidx = 0; nidx < over; nidx++)
             LTFAT_NAME(maxtree_findmax)( s->fmaxtree[k][nidx],
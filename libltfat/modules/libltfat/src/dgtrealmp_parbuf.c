@@ -347,6 +347,26 @@ error:
     return status;
 }
 
+LTFAT_API int
+LTFAT_NAME(dgtrealmp_setparbuf_batchsize)(
+    LTFAT_NAME(dgtrealmp_parbuf)* p, size_t batchsize)
+{
+    int status = LTFATERR_FAILED; CHECKNULL(p);
+    return ltfat_dgtmp_setpar_batchsize(p->params, batchsize);
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(dgtrealmp_setparbuf_batchthreads)(
+    LTFAT_NAME(dgtrealmp_parbuf)* p, ltfat_int nthreads)
+{
+    int status = LTFATERR_FAILED; CHECKNULL(p);
+    return ltfat_dgtmp_setpar_batchthreads(p->params, nthreads);
+error:
+    return status;
+}
+
 LTFAT_API int
 LTFAT_NAME(dgtrealmp_setparbuf_pedanticsearch)(
     LTFAT_NAME(dgtrealmp_parbuf)* p, int do_pedantic)
@@ -35,6 +35,8 @@ struct ltfat_dgtmp_params
     int                   initwasrun;
     int                   treelevels;
     size_t                cycles;
+    size_t                batchsize;
+    ltfat_int             batchthreads;
     ltfat_phaseconvention ptype;
     int                   do_pedantic;
 };
@@ -118,6 +120,24 @@ typedef struct
     kpoint*                pBuf;
     size_t                 pBufSize;
     size_t                 pBufNo;
+    // BatchMP related
+    kpoint*                batchPos;    // Candidates sorted by energy
+    LTFAT_REAL*            batchVal;
+    size_t                 batchCap;
+    size_t                 batchCandNo;
+    LTFAT_REAL*            batchTmpVal;
+    ltfat_int*             batchTmpPos;
+    kpoint*                batchSel;    // Selected atoms
+    LTFAT_COMPLEX*         batchCval;
+    LTFAT_REAL*            batchEnergy;
+    size_t                 batchNo;
+    size_t**               colStamp;    // Columns touched by the current batch
+    size_t                 stamp;
+    size_t                 outoforder;
+    LTFAT_REAL             maxdev;
+    LTFAT_COMPLEX***       wcvalModBuf; // Per worker cvalModBuf
+    LTFAT_COMPLEX**        batchCout;
+    ltfat_threadpool*      pool;
 } LTFAT_NAME(dgtrealmpiter_state);
 
 
@@ -266,6 +286,11 @@ LTFAT_NAME(dgtrealmp_execute_updateresiduum)(
     LTFAT_NAME(dgtrealmp_state)* p, kpoint pos, LTFAT_COMPLEX cval,
     int do_substract);
 
+int
+LTFAT_NAME(dgtrealmp_execute_updateresiduum_gen)(
+    LTFAT_NAME(dgtrealmp_state)* p, kpoint pos, LTFAT_COMPLEX cval,
+    int do_substract, LTFAT_COMPLEX** cvalModBuf, int do_marktmaxtree);
+
 LTFAT_REAL
 LTFAT_NAME(dgtrealmp_execute_atenergy)(
     LTFAT_COMPLEX ainprod, LTFAT_COMPLEX cval);
@@ -299,6 +324,11 @@ LTFAT_NAME(dgtrealmp_execute_selfprojmp)(
     LTFAT_NAME(dgtrealmp_state)* p,
     kpoint origpos, LTFAT_COMPLEX** cout);
 
+int
+LTFAT_NAME(dgtrealmp_execute_batchmp)(
+    LTFAT_NAME(dgtrealmp_state)* p,
+    kpoint origpos, size_t maxno, LTFAT_COMPLEX** cout);
+
 int
 LTFAT_NAME(dgtrealmp_execute_locomp)(
     LTFAT_NAME(dgtrealmp_state)* p,
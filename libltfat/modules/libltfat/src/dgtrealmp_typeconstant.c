@@ -18,6 +18,8 @@ ltfat_dgtmp_params_defaults(ltfat_dgtmp_params* params)
     params->iterstep = 0;
     params->treelevels = 10;
     params->cycles = 1;
+    params->batchsize = 16;
+    params->batchthreads = 1;
     params->atprodreltoldb = -80.0;
     params->ptype = LTFAT_TIMEINV;
 error:
@@ -144,6 +146,35 @@ error:
     return status;
 }
 
+LTFAT_API int
+ltfat_dgtmp_setpar_batchsize(
+    ltfat_dgtmp_params* params, size_t batchsize)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(params);
+
+    CHECK(LTFATERR_NOTPOSARG, batchsize > 0, "batchsize must be greater than 0");
+    params->batchsize = batchsize;
+
+error:
+    return status;
+}
+
+LTFAT_API int
+ltfat_dgtmp_setpar_batchthreads(
+    ltfat_dgtmp_params* params, ltfat_int nthreads)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(params);
+
+    CHECK(LTFATERR_BADARG, nthreads >= 0,
+          "nthreads must be nonnegative (passed %td)", nthreads);
+    params->batchthreads = nthreads;
+
+error:
+    return status;
+}
+
 LTFAT_API int
 ltfat_dgtmp_setpar_errtoldb(
     ltfat_dgtmp_params* params, double errtoldb)
@@ -222,6 +253,7 @@ ltfat_dgtmp_alg_isvalid(ltfat_dgtmp_alg in)
     case ltfat_dgtmp_alg_locomp:
     case ltfat_dgtmp_alg_loccyclicmp:
     case ltfat_dgtmp_alg_locselfprojmp:
+    case ltfat_dgtmp_alg_batchmp:
         isvalid = 1;
     }
 
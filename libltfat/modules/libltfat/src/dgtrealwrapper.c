@@ -278,6 +278,11 @@ LTFAT_NAME(dgtreal_init_gen)(const LTFAT_REAL ga[], ltfat_int gal,
                                            paramsLoc.fftw_flags,
                                            (LTFAT_NAME(dgtreal_long_plan)**)&p->fwdtra_userdata));
 
+        if (paramsLoc.nthreads != 1)
+            CHECKSTATUS(
+                LTFAT_NAME(dgtreal_long_set_nthreads)(
+                    (LTFAT_NAME(dgtreal_long_plan)*) p->fwdtra_userdata, paramsLoc.nthreads));
+
         ltfat_safefree(g2);
     }
     else if ( ltfat_dgt_fb == paramsLoc.hint )
@@ -364,6 +369,11 @@ LTFAT_NAME(dgtreal_init_gen)(const LTFAT_REAL ga[], ltfat_int gal,
                                            paramsLoc.fftw_flags,
                                            (LTFAT_NAME(dgtreal_long_plan)**)&p->fwdtra_userdata);
 
+            if (paramsLoc.nthreads != 1 && p->fwdtra_userdata)
+                CHECKSTATUS(
+                    LTFAT_NAME(dgtreal_long_set_nthreads)(
+                        (LTFAT_NAME(dgtreal_long_plan)*) p->fwdtra_userdata, paramsLoc.nthreads));
+
             ltfat_safefree(g2);
         }
     }
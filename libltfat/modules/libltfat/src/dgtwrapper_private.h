@@ -8,6 +8,7 @@ struct ltfat_dgt_params
     unsigned fftw_flags;
     ltfat_dgt_hint hint;
     int do_synoverwrites;
+    ltfat_int nthreads;
 };
 
 typedef int LTFAT_NAME(donefunc)(void** pla);
@@ -14,6 +14,7 @@ ltfat_dgt_params_defaults(ltfat_dgt_params* params)
     params->fftw_flags = FFTW_ESTIMATE;
     params->hint = ltfat_dgt_auto;
     params->do_synoverwrites = 1;
+    params->nthreads = 1;
 error:
     return status;
 }
@@ -30,6 +31,19 @@ error:
     return params;
 }
 
+LTFAT_API ltfat_dgt_params*
+ltfat_dgt_params_copy(const ltfat_dgt_params* params)
+{
+    ltfat_dgt_params* pcopy = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(params);
+    CHECKMEM( pcopy = LTFAT_NEW(ltfat_dgt_params));
+
+    *pcopy = *params;
+error:
+    return pcopy;
+}
+
 LTFAT_API int
 ltfat_dgt_setpar_phaseconv(ltfat_dgt_params* params,
                                    ltfat_phaseconvention ptype)
@@ -70,6 +84,25 @@ error:
     return status;
 }
 
+LTFAT_API int
+ltfat_dgt_setpar_nthreads(ltfat_dgt_params* params, ltfat_int nthreads)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(params);
+    CHECK(LTFATERR_BADARG, nthreads >= 0,
+          "nthreads must be nonnegative (passed %td)", nthreads);
+    params->nthreads = nthreads;
+error:
+    return status;
+}
+
+LTFAT_API ltfat_int
+ltfat_dgt_getpar_nthreads(ltfat_dgt_params* params)
+{
+    if(params) return params->nthreads;
+    else return LTFATERR_NULLPOINTER;
+}
+
 LTFAT_API int
 ltfat_dgt_setpar_hint(ltfat_dgt_params* params,
                               ltfat_dgt_hint hint)
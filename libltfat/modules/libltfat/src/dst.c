@@ -3,6 +3,7 @@
 #include "ltfat/macros.h"
 
 #include "ltfat/thirdparty/fftw3.h"
+#include "fftcache_private.h"
 
 /* typedef enum */
 /* { */
@@ -49,10 +50,12 @@ LTFAT_NAME(dst_init)( ltfat_int L, ltfat_int W, LTFAT_TYPE *cout,
         case DSTIV: kindFftw = FFTW_RODFT11; break;
     };
 
+    ltfat_fftcache_lock();
     p = LTFAT_FFTW(plan_guru64_r2r)(1, &dims,
                                   1, &howmanydims,
                                   (LTFAT_REAL*)cout, (LTFAT_REAL*)cout,
                                   &kindFftw, flag);
+    ltfat_fftcache_unlock();
 
     return (LTFAT_NAME(dst_plan)*)p;
 }
@@ -73,7 +76,9 @@ LTFAT_NAME(dst)(const LTFAT_TYPE *f, ltfat_int L, ltfat_int W,
 LTFAT_API void
 LTFAT_NAME(dst_done)( LTFAT_NAME(dst_plan)* p)
 {
+    ltfat_fftcache_lock();
     LTFAT_FFTW(destroy_plan)((LTFAT_FFTW(plan)) p);
+    ltfat_fftcache_unlock();
 }
 
 // f and cout can be equal, provided plan was already created
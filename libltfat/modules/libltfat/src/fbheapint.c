@@ -36,7 +36,8 @@ LTFAT_NAME(heapinttask_init_ufb)(const ltfat_int height, const ltfat_int N,
 {
     struct LTFAT_NAME(heapinttask_ufb)* fbhit = LTFAT_NEW(struct LTFAT_NAME(heapinttask_ufb));
     //ltfat_malloc(sizeof * fbhit);
-    fbhit->hit = LTFAT_NAME(heapinttask_init)( height, N, initheapsize, s, do_real);
+    fbhit->hit = LTFAT_NAME(heapinttask_init)( height, N, initheapsize, s, do_real,
+                                               LTFAT_HEAP_BINARY);
     if (do_real)
         fbhit->intfun = LTFAT_NAME(trapezheapreal_ufb);
     else
@@ -355,7 +356,8 @@ LTFAT_NAME(heapinttask_init_fb)(const ltfat_int height,
 {
     struct LTFAT_NAME(heapinttask_fb)* fbhit = LTFAT_NEW(struct LTFAT_NAME(heapinttask_fb));
         //ltfat_malloc(sizeof * fbhit);
-    fbhit->hit = LTFAT_NAME(heapinttask_init)( height, 1, initheapsize, s, do_real);
+    fbhit->hit = LTFAT_NAME(heapinttask_init)( height, 1, initheapsize, s, do_real,
+                                               LTFAT_HEAP_BINARY);
     fbhit->intfun = LTFAT_NAME(trapezheap_fb);
     fbhit->N = (ltfat_int*) N;
     fbhit->a = (double*) a;
@@ -0,0 +1,181 @@
+#include "ltfat.h"
+#include "ltfat/macros.h"
+#include "fftcache_private.h"
+#include "memalloc_private.h"
+
+#ifndef LTFAT_NOTHREADS
+#include <pthread.h>
+static pthread_mutex_t ltfat_fftcache_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+#define LTFAT_FFTCACHE_DEFCAPACITY 0
+
+typedef struct
+{
+    ltfat_fftcache_key key;
+    void* plan;
+    ltfat_fftcache_destroy* destroy;
+    size_t stamp;
+} ltfat_fftcache_entry;
+
+/* All protected by ltfat_fftcache_mutex */
+static ltfat_fftcache_entry* ltfat_fftcache_entries = NULL;
+static ltfat_int ltfat_fftcache_capacity = LTFAT_FFTCACHE_DEFCAPACITY;
+static ltfat_int ltfat_fftcache_count = 0;
+static size_t ltfat_fftcache_clock = 0;
+
+void
+ltfat_fftcache_lock(void)
+{
+#ifndef LTFAT_NOTHREADS
+    pthread_mutex_lock(&ltfat_fftcache_mutex);
+#endif
+}
+
+void
+ltfat_fftcache_unlock(void)
+{
+#ifndef LTFAT_NOTHREADS
+    pthread_mutex_unlock(&ltfat_fftcache_mutex);
+#endif
+}
+
+static int
+ltfat_fftcache_keyeq(const ltfat_fftcache_key* a, const ltfat_fftcache_key* b)
+{
+    return a->L == b->L && a->W == b->W && a->kind == b->kind &&
+           a->precision == b->precision && a->inplace == b->inplace &&
+           a->inalign == b->inalign && a->outalign == b->outalign &&
+           a->flags == b->flags;
+}
+
+/* Must be called with the lock held. Destroys entries starting from
+ * the oldest one until at most keep entries remain. */
+static void
+ltfat_fftcache_shrink(ltfat_int keep)
+{
+    while (ltfat_fftcache_count > keep)
+    {
+        ltfat_int oldest = 0;
+        for (ltfat_int ii = 1; ii < ltfat_fftcache_count; ii++)
+            if (ltfat_fftcache_entries[ii].stamp < ltfat_fftcache_entries[oldest].stamp)
+                oldest = ii;
+
+        ltfat_fftcache_entries[oldest].destroy(ltfat_fftcache_entries[oldest].plan);
+        ltfat_fftcache_entries[oldest] =
+            ltfat_fftcache_entries[--ltfat_fftcache_count];
+    }
+}
+
+int
+ltfat_fftcache_take(const ltfat_fftcache_key* key, void** plan)
+{
+    int found = 0;
+
+    /* Plans created in an arena must be allocated there, see also
+     * ltfat_fftcache_give */
+    if (ltfat_arena_isactive())
+        return 0;
+
+    ltfat_fftcache_lock();
+
+    /* Prefer the most recently returned plan, its data are likely still
+     * in the cache. */
+    ltfat_int best = -1;
+    for (ltfat_int ii = 0; ii < ltfat_fftcache_count; ii++)
+        if ( ltfat_fftcache_keyeq(&ltfat_fftcache_entries[ii].key, key) &&
+             (best < 0 || ltfat_fftcache_entries[ii].stamp >
+              ltfat_fftcache_entries[best].stamp ))
+            best = ii;
+
+    if (best >= 0)
+    {
+        *plan = ltfat_fftcache_entries[best].plan;
+        ltfat_fftcache_entries[best] =
+            ltfat_fftcache_entries[--ltfat_fftcache_count];
+        found = 1;
+    }
+
+    ltfat_fftcache_unlock();
+    return found;
+}
+
+void
+ltfat_fftcache_give(const ltfat_fftcache_key* key, void* plan,
+                    ltfat_fftcache_destroy* destroy)
+{
+    /* The arena memory can go away any time */
+    if (ltfat_arena_isactive())
+    {
+        ltfat_fftcache_lock();
+        destroy(plan);
+        ltfat_fftcache_unlock();
+        return;
+    }
+
+    ltfat_fftcache_lock();
+
+    if (ltfat_fftcache_capacity > 0 && !ltfat_fftcache_entries)
+        ltfat_fftcache_entries =
+            LTFAT_NEWARRAY(ltfat_fftcache_entry, ltfat_fftcache_capacity);
+
+    if (!ltfat_fftcache_entries)
+    {
+        /* Caching disabled or allocation failed */
+        destroy(plan);
+    }
+    else
+    {
+        ltfat_fftcache_shrink(ltfat_fftcache_capacity - 1);
+        ltfat_fftcache_entry* e = &ltfat_fftcache_entries[ltfat_fftcache_count++];
+        e->key = *key;
+        e->plan = plan;
+        e->destroy = destroy;
+        e->stamp = ++ltfat_fftcache_clock;
+    }
+
+    ltfat_fftcache_unlock();
+}
+
+LTFAT_API int
+ltfat_fftcache_setcapacity(ltfat_int capacity)
+{
+    ltfat_fftcache_entry* newentries = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECK(LTFATERR_BADARG, capacity >= 0,
+          "capacity must be nonnegative (passed %td)", capacity);
+
+    if (capacity > 0)
+        CHECKMEM( newentries = LTFAT_NEWARRAY(ltfat_fftcache_entry, capacity));
+
+    ltfat_fftcache_lock();
+    ltfat_fftcache_shrink(capacity);
+    if (ltfat_fftcache_count > 0)
+        memcpy(newentries, ltfat_fftcache_entries,
+               ltfat_fftcache_count * sizeof * newentries);
+    ltfat_safefree(ltfat_fftcache_entries);
+    ltfat_fftcache_entries = newentries;
+    ltfat_fftcache_capacity = capacity;
+    ltfat_fftcache_unlock();
+error:
+    return status;
+}
+
+LTFAT_API ltfat_int
+ltfat_fftcache_getcount(void)
+{
+    ltfat_int count;
+    ltfat_fftcache_lock();
+    count = ltfat_fftcache_count;
+    ltfat_fftcache_unlock();
+    return count;
+}
+
+LTFAT_API int
+ltfat_fftcache_clear(void)
+{
+    ltfat_fftcache_lock();
+    ltfat_fftcache_shrink(0);
+    ltfat_fftcache_unlock();
+    return LTFATERR_SUCCESS;
+}
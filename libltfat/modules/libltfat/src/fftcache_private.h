@@ -0,0 +1,47 @@
+#ifndef _ltfat_fftcache_private_h
+#define _ltfat_fftcache_private_h
+
+/* Kinds of cached plans */
+enum ltfat_fftcache_kind
+{
+    LTFAT_FFTCACHE_FFT      = 0,
+    LTFAT_FFTCACHE_IFFT     = 1,
+    LTFAT_FFTCACHE_FFTREAL  = 2,
+    LTFAT_FFTCACHE_IFFTREAL = 3
+};
+
+/* Everything a backend plan depends on. Two plans with equal keys are
+ * interchangeable. */
+typedef struct
+{
+    ltfat_int L;
+    ltfat_int W;
+    int kind;      //!< ltfat_fftcache_kind
+    int precision; //!< sizeof(LTFAT_REAL)
+    int inplace;
+    int inalign;   //!< Input alignment as reported by the backend
+    int outalign;  //!< Output alignment as reported by the backend
+    unsigned flags;
+} ltfat_fftcache_key;
+
+typedef void ltfat_fftcache_destroy(void* plan);
+
+/* Returns 1 and removes a matching idle plan from the cache, 0 otherwise */
+int
+ltfat_fftcache_take(const ltfat_fftcache_key* key, void** plan);
+
+/* Hands a plan over to the cache. If the cache is full, the least recently
+ * returned plan is destroyed (possibly the one just passed). */
+void
+ltfat_fftcache_give(const ltfat_fftcache_key* key, void* plan,
+                    ltfat_fftcache_destroy* destroy);
+
+/* Global lock serializing backend planner calls. FFTW planner functions
+ * (plan creation and destruction, wisdom) are not thread-safe. */
+void
+ltfat_fftcache_lock(void);
+
+void
+ltfat_fftcache_unlock(void);
+
+#endif
@@ -2,6 +2,74 @@
 #include "ltfat/types.h"
 #include "ltfat/macros.h"
 #include "ltfat/thirdparty/fftw3.h"
+#include "fftcache_private.h"
+
+/* Plans are not destroyed in *_done but handed over to the plan cache
+ * (see fftcache.c) and reused by the next *_init with a matching key.
+ * A reused plan has been created with different arrays, therefore all
+ * execute functions use the new-array interface. The FFTW new-array
+ * interface requires the arrays to have the same alignment and
+ * in-placeness as the ones used for planning, hence these are part of
+ * the key. */
+static void
+LTFAT_NAME(fftw_makekey)(ltfat_int L, ltfat_int W, int kind,
+                         const void* in, const void* out, unsigned flags,
+                         ltfat_fftcache_key* key)
+{
+    key->L = L; key->W = W; key->kind = kind;
+    key->precision = sizeof(LTFAT_REAL);
+    key->inplace = in == out;
+    key->inalign = LTFAT_FFTW(alignment_of)((LTFAT_REAL*) in);
+    key->outalign = LTFAT_FFTW(alignment_of)((LTFAT_REAL*) out);
+    key->flags = flags;
+}
+
+static void
+LTFAT_NAME(fftw_destroy)(void* p)
+{
+    LTFAT_FFTW(destroy_plan)((LTFAT_FFTW(plan)) p);
+}
+
+/* The plan cache lock also serializes the FFTW planner */
+static void
+LTFAT_NAME(fftw_destroy_locked)(LTFAT_FFTW(plan) p)
+{
+    ltfat_fftcache_lock();
+    LTFAT_FFTW(destroy_plan)(p);
+    ltfat_fftcache_unlock();
+}
+
+LTFAT_API int
+LTFAT_NAME(fft_wisdom_import)(const char* filename)
+{
+    int status = LTFATERR_SUCCESS;
+    int ok;
+    CHECKNULL(filename);
+
+    ltfat_fftcache_lock();
+    ok = LTFAT_FFTW(import_wisdom_from_filename)(filename);
+    ltfat_fftcache_unlock();
+
+    CHECK(LTFATERR_FAILED, ok, "Could not import FFTW wisdom from %s", filename);
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(fft_wisdom_export)(const char* filename)
+{
+    int status = LTFATERR_SUCCESS;
+    int ok;
+    CHECKNULL(filename);
+
+    ltfat_fftcache_lock();
+    ok = LTFAT_FFTW(export_wisdom_to_filename)(filename);
+    ltfat_fftcache_unlock();
+
+    CHECK(LTFATERR_FAILED, ok, "Could not export FFTW wisdom to %s", filename);
+error:
+    return status;
+}
 
 /****** FFT ******/
 struct LTFAT_NAME(fft_plan)
@@ -11,6 +79,7 @@ struct LTFAT_NAME(fft_plan)
     LTFAT_COMPLEX* in;
     LTFAT_COMPLEX* out;
     LTFAT_FFTW(plan) p;
+    ltfat_fftcache_key key;
 };
 
 LTFAT_API int
@@ -35,6 +104,7 @@ LTFAT_NAME(fft_init)(ltfat_int L, ltfat_int W,
     LTFAT_FFTW(iodim64) dims;
     LTFAT_FFTW(iodim64) howmany_dims;
     LTFAT_NAME(fft_plan)* fftwp = NULL;
+    void* cached = NULL;
 
     int status = LTFATERR_SUCCESS;
 
@@ -44,14 +114,22 @@ LTFAT_NAME(fft_init)(ltfat_int L, ltfat_int W,
     CHECKMEM( fftwp = LTFAT_NEW(LTFAT_NAME(fft_plan)) );
 
     fftwp->L = L; fftwp->W = W; fftwp->in = in; fftwp->out = out;
+    LTFAT_NAME(fftw_makekey)(L, W, LTFAT_FFTCACHE_FFT, in, out, flags, &fftwp->key);
 
     dims.n = L; dims.is = 1; dims.os = 1;
     howmany_dims.n = W; howmany_dims.is = L; howmany_dims.os = L;
 
-    fftwp->p = LTFAT_FFTW(plan_guru64_dft)(1, &dims, 1, &howmany_dims,
-                                           (LTFAT_FFTW(complex)*)  in,
-                                           (LTFAT_FFTW(complex)*) out,
-                                           FFTW_FORWARD, flags);
+    if (ltfat_fftcache_take(&fftwp->key, &cached))
+        fftwp->p = (LTFAT_FFTW(plan)) cached;
+    else
+    {
+        ltfat_fftcache_lock();
+        fftwp->p = LTFAT_FFTW(plan_guru64_dft)(1, &dims, 1, &howmany_dims,
+                                               (LTFAT_FFTW(complex)*)  in,
+                                               (LTFAT_FFTW(complex)*) out,
+                                               FFTW_FORWARD, flags);
+        ltfat_fftcache_unlock();
+    }
 
     CHECKINIT(fftwp->p, "FFTW plan creation failed.");
     *p = fftwp;
@@ -59,7 +137,7 @@ LTFAT_NAME(fft_init)(ltfat_int L, ltfat_int W,
 error:
     if (fftwp)
     {
-        if (fftwp->p) LTFAT_FFTW(destroy_plan)(fftwp->p);
+        if (fftwp->p) LTFAT_NAME(fftw_destroy_locked)(fftwp->p);
         ltfat_free(fftwp);
     }
     *p = NULL;
@@ -71,7 +149,9 @@ LTFAT_NAME(fft_execute)(LTFAT_NAME(fft_plan)* p)
 {
     int status = LTFATERR_SUCCESS;
     CHECKNULL(p); CHECKNULL(p->in); CHECKNULL(p->out);
-    LTFAT_FFTW(execute)(p->p);
+    LTFAT_FFTW(execute_dft)(p->p,
+                            (LTFAT_FFTW(complex)*) p->in,
+                            (LTFAT_FFTW(complex)*) p->out);
 error:
     return status;
 }
@@ -96,7 +176,7 @@ LTFAT_NAME(fft_done)(LTFAT_NAME(fft_plan)** p)
     LTFAT_NAME(fft_plan)* pp = NULL;
     CHECKNULL(p); CHECKNULL(*p);
     pp = *p;
-    LTFAT_FFTW(destroy_plan)(pp->p);
+    ltfat_fftcache_give(&pp->key, pp->p, LTFAT_NAME(fftw_destroy));
     ltfat_free(pp);
     pp = NULL;
 error:
@@ -111,6 +191,7 @@ struct LTFAT_NAME(ifft_plan)
     LTFAT_COMPLEX* in;
     LTFAT_COMPLEX* out;
     LTFAT_FFTW(plan) p;
+    ltfat_fftcache_key key;
 };
 
 LTFAT_API int
@@ -135,6 +216,7 @@ LTFAT_NAME(ifft_init)(ltfat_int L, ltfat_int W,
     LTFAT_FFTW(iodim64) dims;
     LTFAT_FFTW(iodim64) howmany_dims;
     LTFAT_NAME(ifft_plan)* fftwp = NULL;
+    void* cached = NULL;
 
     int status = LTFATERR_SUCCESS;
 
@@ -144,14 +226,22 @@ LTFAT_NAME(ifft_init)(ltfat_int L, ltfat_int W,
     CHECKMEM( fftwp = LTFAT_NEW(LTFAT_NAME(ifft_plan)) );
 
     fftwp->L = L; fftwp->W = W; fftwp->in = in; fftwp->out = out;
+    LTFAT_NAME(fftw_makekey)(L, W, LTFAT_FFTCACHE_IFFT, in, out, flags, &fftwp->key);
 
     dims.n = L; dims.is = 1; dims.os = 1;
     howmany_dims.n = W; howmany_dims.is = L; howmany_dims.os = L;
 
-    fftwp->p = LTFAT_FFTW(plan_guru64_dft)(1, &dims, 1, &howmany_dims,
-                                           (LTFAT_FFTW(complex)*)  in,
-                                           (LTFAT_FFTW(complex)*) out,
-                                           FFTW_BACKWARD, flags);
+    if (ltfat_fftcache_take(&fftwp->key, &cached))
+        fftwp->p = (LTFAT_FFTW(plan)) cached;
+    else
+    {
+        ltfat_fftcache_lock();
+        fftwp->p = LTFAT_FFTW(plan_guru64_dft)(1, &dims, 1, &howmany_dims,
+                                               (LTFAT_FFTW(complex)*)  in,
+                                               (LTFAT_FFTW(complex)*) out,
+                                               FFTW_BACKWARD, flags);
+        ltfat_fftcache_unlock();
+    }
 
     CHECKINIT(fftwp->p, "FFTW plan creation failed.");
     *p = fftwp;
@@ -159,7 +249,7 @@ LTFAT_NAME(ifft_init)(ltfat_int L, ltfat_int W,
 error:
     if (fftwp)
     {
-        if (fftwp->p) LTFAT_FFTW(destroy_plan)(fftwp->p);
+        if (fftwp->p) LTFAT_NAME(fftw_destroy_locked)(fftwp->p);
         ltfat_free(fftwp);
     }
     *p = NULL;
@@ -171,7 +261,9 @@ LTFAT_NAME(ifft_execute)(LTFAT_NAME(ifft_plan)* p)
 {
     int status = LTFATERR_SUCCESS;
     CHECKNULL(p); CHECKNULL(p->in); CHECKNULL(p->out);
-    LTFAT_FFTW(execute)(p->p);
+    LTFAT_FFTW(execute_dft)(p->p,
+                            (LTFAT_FFTW(complex)*) p->in,
+                            (LTFAT_FFTW(complex)*) p->out);
 error:
     return status;
 }
@@ -196,7 +288,7 @@ LTFAT_NAME(ifft_done)(LTFAT_NAME(ifft_plan)** p)
     LTFAT_NAME(ifft_plan)* pp = NULL;
     CHECKNULL(p); CHECKNULL(*p);
     pp = *p;
-    LTFAT_FFTW(destroy_plan)(pp->p);
+    ltfat_fftcache_give(&pp->key, pp->p, LTFAT_NAME(fftw_destroy));
     ltfat_free(pp);
     pp = NULL;
 error:
@@ -211,6 +303,7 @@ struct LTFAT_NAME(fftreal_plan)
     LTFAT_REAL* in;
     LTFAT_COMPLEX* out;
     LTFAT_FFTW(plan) p;
+    ltfat_fftcache_key key;
 };
 
 LTFAT_API int
@@ -236,6 +329,7 @@ LTFAT_NAME(fftreal_init)(ltfat_int L, ltfat_int W,
     LTFAT_FFTW(iodim64) howmany_dims;
     ltfat_int M2;
     LTFAT_NAME(fftreal_plan)* fftwp = NULL;
+    void* cached = NULL;
 
     int status = LTFATERR_SUCCESS;
 
@@ -245,6 +339,7 @@ LTFAT_NAME(fftreal_init)(ltfat_int L, ltfat_int W,
     CHECKMEM( fftwp = LTFAT_NEW(LTFAT_NAME(fftreal_plan)) );
 
     fftwp->L = L; fftwp->W = W; fftwp->in = in; fftwp->out = out;
+    LTFAT_NAME(fftw_makekey)(L, W, LTFAT_FFTCACHE_FFTREAL, in, out, flags, &fftwp->key);
 
     M2 = L / 2 + 1;
     dims.n = L; dims.is = 1; dims.os = 1;
@@ -255,10 +350,17 @@ LTFAT_NAME(fftreal_init)(ltfat_int L, ltfat_int W,
     else
         howmany_dims.is = 2 * M2;
 
-    fftwp->p =
-        LTFAT_FFTW(plan_guru64_dft_r2c)(1, &dims, 1, &howmany_dims,
-                                        in, (LTFAT_FFTW(complex)*) out,
-                                        flags);
+    if (ltfat_fftcache_take(&fftwp->key, &cached))
+        fftwp->p = (LTFAT_FFTW(plan)) cached;
+    else
+    {
+        ltfat_fftcache_lock();
+        fftwp->p =
+            LTFAT_FFTW(plan_guru64_dft_r2c)(1, &dims, 1, &howmany_dims,
+                                            in, (LTFAT_FFTW(complex)*) out,
+                                            flags);
+        ltfat_fftcache_unlock();
+    }
 
     CHECKINIT(fftwp->p, "FFTW plan creation failed.");
     *p = fftwp;
@@ -266,7 +368,7 @@ LTFAT_NAME(fftreal_init)(ltfat_int L, ltfat_int W,
 error:
     if (fftwp)
     {
-        if (fftwp->p) LTFAT_FFTW(destroy_plan)(fftwp->p);
+        if (fftwp->p) LTFAT_NAME(fftw_destroy_locked)(fftwp->p);
         ltfat_free(fftwp);
     }
     *p = NULL;
@@ -278,7 +380,7 @@ LTFAT_NAME(fftreal_execute)(LTFAT_NAME(fftreal_plan)* p)
 {
     int status = LTFATERR_SUCCESS;
     CHECKNULL(p); CHECKNULL(p->in); CHECKNULL(p->out);
-    LTFAT_FFTW(execute)(p->p);
+    LTFAT_FFTW(execute_dft_r2c)(p->p, p->in, (LTFAT_FFTW(complex)*) p->out);
 error:
     return status;
 }
@@ -301,7 +403,7 @@ LTFAT_NAME(fftreal_done)(LTFAT_NAME(fftreal_plan)** p)
     LTFAT_NAME(fftreal_plan)* pp = NULL;
     CHECKNULL(p); CHECKNULL(*p);
     pp = *p;
-    LTFAT_FFTW(destroy_plan)(pp->p);
+    ltfat_fftcache_give(&pp->key, pp->p, LTFAT_NAME(fftw_destroy));
     ltfat_free(pp);
     pp = NULL;
 error:
@@ -316,6 +418,7 @@ struct LTFAT_NAME(ifftreal_plan)
     LTFAT_COMPLEX* in;
     LTFAT_REAL* out;
     LTFAT_FFTW(plan) p;
+    ltfat_fftcache_key key;
 };
 
 LTFAT_API int
@@ -341,6 +444,7 @@ LTFAT_NAME(ifftreal_init)(ltfat_int L, ltfat_int W,
     LTFAT_FFTW(iodim64) howmany_dims;
     ltfat_int M2;
     LTFAT_NAME(ifftreal_plan)* fftwp = NULL;
+    void* cached = NULL;
 
     int status = LTFATERR_SUCCESS;
 
@@ -352,6 +456,7 @@ LTFAT_NAME(ifftreal_init)(ltfat_int L, ltfat_int W,
     M2 = L / 2 + 1;
 
     fftwp->L = L; fftwp->W = W; fftwp->in = in; fftwp->out = out;
+    LTFAT_NAME(fftw_makekey)(L, W, LTFAT_FFTCACHE_IFFTREAL, in, out, flags, &fftwp->key);
 
     dims.n = L; dims.is = 1; dims.os = 1;
     howmany_dims.n = W; howmany_dims.is = L / 2 + 1;
@@ -361,10 +466,17 @@ LTFAT_NAME(ifftreal_init)(ltfat_int L, ltfat_int W,
     else
         howmany_dims.os = 2 * M2;
 
-    fftwp->p =
-        LTFAT_FFTW(plan_guru64_dft_c2r)(1, &dims, 1, &howmany_dims,
-                                        (LTFAT_FFTW(complex)*)  in,
-                                        out, flags);
+    if (ltfat_fftcache_take(&fftwp->key, &cached))
+        fftwp->p = (LTFAT_FFTW(plan)) cached;
+    else
+    {
+        ltfat_fftcache_lock();
+        fftwp->p =
+            LTFAT_FFTW(plan_guru64_dft_c2r)(1, &dims, 1, &howmany_dims,
+                                            (LTFAT_FFTW(complex)*)  in,
+                                            out, flags);
+        ltfat_fftcache_unlock();
+    }
 
     CHECKINIT(fftwp->p, "FFTW plan creation failed.");
     *p = fftwp;
@@ -372,7 +484,7 @@ LTFAT_NAME(ifftreal_init)(ltfat_int L, ltfat_int W,
 error:
     if (fftwp)
     {
-        if (fftwp->p) LTFAT_FFTW(destroy_plan)(fftwp->p);
+        if (fftwp->p) LTFAT_NAME(fftw_destroy_locked)(fftwp->p);
         ltfat_free(fftwp);
     }
     *p = NULL;
@@ -384,7 +496,7 @@ LTFAT_NAME(ifftreal_execute)(LTFAT_NAME(ifftreal_plan)* p)
 {
     int status = LTFATERR_SUCCESS;
     CHECKNULL(p); CHECKNULL(p->in); CHECKNULL(p->out);
-    LTFAT_FFTW(execute)(p->p);
+    LTFAT_FFTW(execute_dft_c2r)(p->p, (LTFAT_FFTW(complex)*) p->in, p->out);
 error:
     return status;
 }
@@ -407,7 +519,7 @@ LTFAT_NAME(ifftreal_done)(LTFAT_NAME(ifftreal_plan)** p)
     LTFAT_NAME(ifftreal_plan)* pp = NULL;
     CHECKNULL(p); CHECKNULL(*p);
     pp = *p;
-    LTFAT_FFTW(destroy_plan)(pp->p);
+    ltfat_fftcache_give(&pp->key, pp->p, LTFAT_NAME(fftw_destroy));
     ltfat_free(pp);
     pp = NULL;
 error:
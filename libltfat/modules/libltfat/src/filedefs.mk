@@ -5,11 +5,11 @@ files = dgt.c dgtreal_fb.c dgt_multi.c dgt_ola.c dgt_shear.c	\
 		windows.c  \
 		dgt_shearola.c utils.c rtdgtreal.c circularbuf.c slicingbuf.c \
 		dgtrealwrapper.c dgtrealmp.c dgtrealmp_parbuf.c dgtrealmp_kernel.c dgtrealmp_guts.c maxtree.c \
-		slidgtrealmp.c \
+		slidgtrealmp.c segdgtrealmp.c simd_kernels.c \
 		filterbankphaseret.c fbheapint.c
 
 files_complextransp =\
-ci_utils.c ci_windows.c spread.c wavelets.c goertzel.c \
+ci_utils.c ci_windows.c spread.c wavelets.c wfbt.c wfbt_stream.c goertzel.c \
 reassign.c gabdual_painless.c wfac.c iwfac.c \
 dgt_long.c idgt_long.c dgt_fb.c idgt_fb.c ci_memalloc.c \
 dgtwrapper.c
@@ -23,7 +23,8 @@ files_fftw_complextransp = dct.c dst.c
 files_notypechange = memalloc.c error.c version.c argchecks.c \
 					 dgtwrapper_typeconstant.c dgtrealmp_typeconstant.c  \
 				   	 reassign_typeconstant.c wavelets_typeconstant.c \
-					 integer_manip.c firwin_typeconstant.c
+					 integer_manip.c firwin_typeconstant.c threadpool.c \
+					 simd_typeconstant.c fftcache.c timing.c
 
 FFTBACKEND ?= FFTW
 
@@ -4,8 +4,16 @@
 
 #include "ltfat/thirdparty/fftw3.h"
 
-#ifndef GGA_UNROLL
-#   define GGA_UNROLL 8
+#include "simd_private.h"
+
+/* Frequencies per task and samples per pass. A pass over GGA_LBLOCK
+ * samples is repeated for every group of frequencies in the SIMD kernel,
+ * so it should stay in the L1 cache. */
+#ifndef GGA_MBLOCK
+#   define GGA_MBLOCK 64
+#endif
+#ifndef GGA_LBLOCK
+#   define GGA_LBLOCK 2048
 #endif
 
 struct LTFAT_NAME(gga_plan_struct)
@@ -15,24 +23,58 @@ struct LTFAT_NAME(gga_plan_struct)
     LTFAT_COMPLEX* cc2_term;
     ltfat_int M;
     ltfat_int L;
+    ltfat_threadpool* pool;
+    // Arguments of the running gga_execute
+    const LTFAT_TYPE* f;
+    LTFAT_COMPLEX* c;
 };
 
-struct LTFAT_NAME(chzt_plan_struct)
+struct LTFAT_NAME(gga_sliding_plan)
 {
-    LTFAT_COMPLEX* fbuffer;
+    LTFAT_NAME(gga_plan) p;
+    LTFAT_COMPLEX* rot;     //!< exp(i*w)
+    LTFAT_COMPLEX* c;       //!< Bins of the current window
+    LTFAT_TYPE* buf;        //!< Last L samples, circular
+    ltfat_int pos;          //!< Position of the oldest sample in buf
+    ltfat_int sincesync;    //!< Samples since the bins were recomputed
+};
+
+struct LTFAT_NAME(chzt_tables)
+{
+    ltfat_int K;
+    ltfat_int L;
+    LTFAT_REAL deltao;
+    LTFAT_REAL o;
+    czt_ffthint hint;
+    int fac;
+    ltfat_int Lfft;
+    ltfat_int q;
     LTFAT_COMPLEX* W2;
     LTFAT_COMPLEX* Wo;
     LTFAT_COMPLEX* chirpF;
-    /* LTFAT_FFTW(plan) plan; */
-    /* LTFAT_FFTW(plan) plan2; */
+    ltfat_int refcount;     //!< Number of plans using the tables
+    size_t stamp;           //!< Release time of idle tables
+    struct LTFAT_NAME(chzt_tables)* next;
+};
+typedef struct LTFAT_NAME(chzt_tables) LTFAT_NAME(chzt_tables);
+
+struct LTFAT_NAME(chzt_plan_struct)
+{
+    LTFAT_NAME(chzt_tables)* t; //!< Shared, read only
+    LTFAT_COMPLEX* fbuffer;
+    const LTFAT_COMPLEX* W2;
+    const LTFAT_COMPLEX* Wo;
+    const LTFAT_COMPLEX* chirpF;
     LTFAT_NAME_REAL(fft_plan)* plan;
     LTFAT_NAME_REAL(ifft_plan)* plan2;
     ltfat_int L;
     ltfat_int K;
     ltfat_int Lfft;
+    ltfat_int q;            //!< FFT columns per signal
+    ltfat_int Wb;           //!< Signals per FFT call
+    int fac;
 };
 
-
 LTFAT_API LTFAT_NAME(gga_plan)
 LTFAT_NAME(gga_init)(const LTFAT_REAL* indVecPtr, ltfat_int M,
                      ltfat_int L)
@@ -57,7 +99,7 @@ LTFAT_NAME(gga_init)(const LTFAT_REAL* indVecPtr, ltfat_int M,
     /* struct LTFAT_NAME(gga_plan_struct) plan_tmp = */
     /* {.cos_term = cos_term, .cc_term = cc_term, .cc2_term = cc2_term, .M = M, .L = L}; */
 
-    LTFAT_NAME(gga_plan) plan = (LTFAT_NAME(gga_plan)) ltfat_malloc(sizeof * plan);
+    LTFAT_NAME(gga_plan) plan = LTFAT_NEW(struct LTFAT_NAME(gga_plan_struct));
     plan->cos_term = cos_term; plan->cc_term = cc_term;
     plan->cc2_term = cc2_term; plan->M = M; plan->L = L;
 
@@ -69,6 +111,7 @@ LTFAT_NAME(gga_init)(const LTFAT_REAL* indVecPtr, ltfat_int M,
 LTFAT_API
 void LTFAT_NAME(gga_done)(LTFAT_NAME(gga_plan) plan)
 {
+    if (plan->pool) ltfat_threadpool_done(&plan->pool);
     LTFAT_SAFEFREEALL((void*)plan->cos_term,
                       (void*)plan->cc_term,
                       (void*)plan->cc2_term);
@@ -76,204 +119,708 @@ void LTFAT_NAME(gga_done)(LTFAT_NAME(gga_plan) plan)
 }
 
 
+LTFAT_API int
+LTFAT_NAME(gga_set_nthreads)(LTFAT_NAME(gga_plan) p, ltfat_int nthreads)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_BADARG, nthreads >= 0,
+          "nthreads must be nonnegative (passed %td)", nthreads);
+
+    if (p->pool) ltfat_threadpool_done(&p->pool);
+
+    if (nthreads == 0) nthreads = ltfat_threadpool_get_nprocs();
+    if (nthreads == 1) return status;
+
+    CHECKSTATUS( ltfat_threadpool_init(nthreads, &p->pool));
+error:
+    return status;
+}
+
+/* Runs the recursion over L samples, continuing from the states.
+ * Index 0 of the states holds the real part, index 1 the imaginary part
+ * of a complex signal. */
+static void
+LTFAT_NAME(gga_recursion)(const LTFAT_REAL* cos_term, const LTFAT_TYPE* f,
+                          ltfat_int L, ltfat_int Mb,
+                          LTFAT_REAL s0[2][GGA_MBLOCK],
+                          LTFAT_REAL s1[2][GGA_MBLOCK])
+{
+    for (ltfat_int l = 0; l < L; l += GGA_LBLOCK)
+    {
+        ltfat_int Lb = ltfat_imin(GGA_LBLOCK, L - l);
+#ifdef LTFAT_COMPLEXTYPE
+        const LTFAT_REAL* fr = (const LTFAT_REAL*) (f + l);
+        LTFAT_NAME_REAL(gga_recursion_simd)(fr, 2, Lb, cos_term, Mb, s0[0], s1[0]);
+        LTFAT_NAME_REAL(gga_recursion_simd)(fr + 1, 2, Lb, cos_term, Mb, s0[1], s1[1]);
+#else
+        LTFAT_NAME_REAL(gga_recursion_simd)(f + l, 1, Lb, cos_term, Mb, s0[0], s1[0]);
+#endif
+    }
+}
+
+static void
+LTFAT_NAME(gga_finish)(const LTFAT_COMPLEX* cc_term,
+                       const LTFAT_COMPLEX* cc2_term, ltfat_int Mb,
+                       LTFAT_REAL s0[2][GGA_MBLOCK],
+                       LTFAT_REAL s1[2][GGA_MBLOCK], LTFAT_COMPLEX* c)
+{
+    for (ltfat_int m = 0; m < Mb; m++)
+    {
+#ifdef LTFAT_COMPLEXTYPE
+        LTFAT_COMPLEX a = s0[0][m] + I * s0[1][m];
+        LTFAT_COMPLEX b = s1[0][m] + I * s1[1][m];
+#else
+        LTFAT_REAL a = s0[0][m], b = s1[0][m];
+#endif
+        c[m] = a * cc2_term[m] - b * cc_term[m];
+    }
+}
+
+/* Frequencies m0,...,m0 + GGA_MBLOCK - 1 of one channel */
+static void
+LTFAT_NAME(gga_block)(const struct LTFAT_NAME(gga_plan_struct)* p,
+                      const LTFAT_TYPE* f, ltfat_int m0, LTFAT_COMPLEX* c)
+{
+    LTFAT_REAL s0[2][GGA_MBLOCK] = {{0}}, s1[2][GGA_MBLOCK] = {{0}};
+    ltfat_int Mb = ltfat_imin(GGA_MBLOCK, p->M - m0);
+
+    LTFAT_NAME(gga_recursion)(p->cos_term + m0, f, p->L, Mb, s0, s1);
+    LTFAT_NAME(gga_finish)(p->cc_term + m0, p->cc2_term + m0, Mb, s0, s1,
+                           c + m0);
+}
+
+static void
+LTFAT_NAME(gga_task)(void* userdata, ltfat_int taskid,
+                     ltfat_int UNUSED(workerid))
+{
+    struct LTFAT_NAME(gga_plan_struct)* p = userdata;
+    ltfat_int blocksNo = ltfat_idivceil(p->M, GGA_MBLOCK);
+    ltfat_int w = taskid / blocksNo;
+
+    LTFAT_NAME(gga_block)(p, p->f + w * p->L, (taskid % blocksNo) * GGA_MBLOCK,
+                          p->c + w * p->M);
+}
+
 LTFAT_API
 void LTFAT_NAME(gga_execute)(LTFAT_NAME(gga_plan) p,
                              const LTFAT_TYPE* fPtr,
                              ltfat_int W,
                              LTFAT_COMPLEX* cPtr)
 {
-#ifndef GGA_UNROLL
+    ltfat_int ntasks = W * ltfat_idivceil(p->M, GGA_MBLOCK);
+    p->f = fPtr; p->c = cPtr;
+
+    if (p->pool)
+        ltfat_threadpool_execute(p->pool, ntasks, LTFAT_NAME(gga_task), p);
+    else
+        for (ltfat_int t = 0; t < ntasks; t++)
+            LTFAT_NAME(gga_task)(p, t, 0);
+
+    p->f = NULL; p->c = NULL;
+}
+
+LTFAT_API
+void LTFAT_NAME(gga)(const LTFAT_TYPE* fPtr, const LTFAT_REAL* indVecPtr,
+                     ltfat_int L, ltfat_int W, ltfat_int M, LTFAT_COMPLEX* cPtr)
+{
+    LTFAT_NAME(gga_plan) p = LTFAT_NAME(gga_init)(indVecPtr, M, L);
+    LTFAT_NAME(gga_execute)(p, fPtr, W, cPtr);
+    LTFAT_NAME(gga_done)(p);
+}
+
+/* The bins of the window f[n-L+1],...,f[n] obey
+ *
+ *   c(n) = exp(i*w)*(c(n-1) - f[n-L]) + exp(-i*w*(L-1))*f[n].
+ *
+ * The rounding errors of the recursion accumulate, so the bins are
+ * recomputed from the buffered window every GGA_SLIDING_RESYNC*L samples. */
+#ifndef GGA_SLIDING_RESYNC
+#   define GGA_SLIDING_RESYNC 16
+#endif
 
-    for (ltfat_int w = 0; w < W; w++)
+static void
+LTFAT_NAME(gga_sliding_resync)(LTFAT_NAME(gga_sliding_plan)* p)
+{
+    const struct LTFAT_NAME(gga_plan_struct)* gp = p->p;
+
+    for (ltfat_int m0 = 0; m0 < gp->M; m0 += GGA_MBLOCK)
     {
-        LTFAT_COMPLEX* cPtrTmp = (LTFAT_COMPLEX*) cPtr + w * p.M;
+        LTFAT_REAL s0[2][GGA_MBLOCK] = {{0}}, s1[2][GGA_MBLOCK] = {{0}};
+        ltfat_int Mb = ltfat_imin(GGA_MBLOCK, gp->M - m0);
+
+        LTFAT_NAME(gga_recursion)(gp->cos_term + m0, p->buf + p->pos,
+                                  gp->L - p->pos, Mb, s0, s1);
+        LTFAT_NAME(gga_recursion)(gp->cos_term + m0, p->buf, p->pos, Mb, s0, s1);
+        LTFAT_NAME(gga_finish)(gp->cc_term + m0, gp->cc2_term + m0, Mb, s0, s1,
+                               p->c + m0);
+    }
+    p->sincesync = 0;
+}
 
-        for (ltfat_int m = 0; m < p.M; m++)
-        {
-            LTFAT_TYPE s0 =  0.0;
-            LTFAT_TYPE s1 =  0.0;
-            LTFAT_TYPE s2 =  0.0;
-            LTFAT_TYPE* fPtrTmp = (LTFAT_TYPE*) fPtr + w * p.L;
+LTFAT_API int
+LTFAT_NAME(gga_sliding_init)(const LTFAT_REAL* indVecPtr, ltfat_int M,
+                             ltfat_int L, LTFAT_NAME(gga_sliding_plan)** p)
+{
+    LTFAT_NAME(gga_sliding_plan)* pp = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(indVecPtr);
+    CHECK(LTFATERR_NOTPOSARG, M > 0, "M must be positive");
+    CHECK(LTFATERR_NOTPOSARG, L > 0, "L must be positive");
+
+    CHECKMEM( pp = LTFAT_NEW(LTFAT_NAME(gga_sliding_plan)) );
+    CHECKMEM( pp->p = LTFAT_NAME(gga_init)(indVecPtr, M, L) );
+    CHECKMEM( pp->rot = LTFAT_NAME_COMPLEX(malloc)(M) );
+    CHECKMEM( pp->c = LTFAT_NAME_COMPLEX(calloc)(M) );
+    CHECKMEM( pp->buf = LTFAT_NAME(calloc)(L) );
 
-            for (ltfat_int ii = 0; ii < p.L - 1; ii++)
-            {
-                s0 = *fPtrTmp++ + p.cos_term[m] * s1 - s2;
-                s2 = s1;
-                s1 = s0;
-            }
-            s0 = *fPtrTmp + p.cos_term[m] * s1 - s2;
+    for (ltfat_int m = 0; m < M; m++)
+        pp->rot[m] = (LTFAT_COMPLEX) exp(I * 2.0 * M_PI * indVecPtr[m] / ((double) L));
 
-            *cPtrTmp++ = (s0 * p.cc2_term[m] - s1 * p.cc_term[m]);
-        }
+    *p = pp;
+    return status;
+error:
+    if (pp) LTFAT_NAME(gga_sliding_done)(&pp);
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(gga_sliding_execute)(LTFAT_NAME(gga_sliding_plan)* p,
+                                const LTFAT_TYPE f[], ltfat_int Lb,
+                                LTFAT_COMPLEX c[])
+{
+    ltfat_int M, L;
+    const LTFAT_COMPLEX* rot;
+    const LTFAT_COMPLEX* cc2_term;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(c);
+    CHECK(LTFATERR_BADARG, Lb >= 0, "Lb must not be negative (passed %td)", Lb);
+    CHECK(LTFATERR_NULLPOINTER, f || Lb == 0, "f is a null-pointer");
+
+    M = p->p->M; L = p->p->L;
+    rot = p->rot; cc2_term = p->p->cc2_term;
+
+    for (ltfat_int l = 0; l < Lb; l++)
+    {
+        LTFAT_TYPE fold = p->buf[p->pos], fnew = f[l];
+        p->buf[p->pos] = fnew;
+        if (++p->pos == L) p->pos = 0;
+
+        for (ltfat_int m = 0; m < M; m++)
+            p->c[m] = rot[m] * (p->c[m] - fold) + cc2_term[m] * fnew;
     }
-#else
-    for (ltfat_int w = 0; w < W; w++)
+
+    p->sincesync += Lb;
+    if (p->sincesync >= GGA_SLIDING_RESYNC * L)
+        LTFAT_NAME(gga_sliding_resync)(p);
+
+    memcpy(c, p->c, M * sizeof * c);
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(gga_sliding_reset)(LTFAT_NAME(gga_sliding_plan)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    LTFAT_NAME(clear_array)(p->buf, p->p->L);
+    LTFAT_NAME_COMPLEX(clear_array)(p->c, p->p->M);
+    p->pos = 0; p->sincesync = 0;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(gga_sliding_done)(LTFAT_NAME(gga_sliding_plan)** p)
+{
+    int status = LTFATERR_SUCCESS;
+    LTFAT_NAME(gga_sliding_plan)* pp;
+    CHECKNULL(p); CHECKNULL(*p);
+    pp = *p;
+    if (pp->p) LTFAT_NAME(gga_done)(pp->p);
+    LTFAT_SAFEFREEALL(pp->rot, pp->c, pp->buf);
+    ltfat_free(pp);
+    *p = NULL;
+error:
+    return status;
+}
+
+
+
+/* Chirp tables are shared by all the plans with the same parameters.
+ * Idle tables (no plan uses them) are kept up to CHZT_CACHE_CAPACITY. */
+#ifndef CHZT_CACHE_CAPACITY
+#   define CHZT_CACHE_CAPACITY 16
+#endif
+
+/* Number of remembered choices of chzt_init_batch with CZT_AUTO */
+#define CHZT_CHOICES 64
+
+static LTFAT_NAME(chzt_tables)* LTFAT_NAME(chzt_cache) = NULL;
+static size_t LTFAT_NAME(chzt_cache_clock) = 0;
+
+typedef struct
+{
+    ltfat_int K, L, Wb;
+    czt_ffthint hint;
+    unsigned flags;
+    czt_method method;
+} LTFAT_NAME(chzt_choice);
+
+static LTFAT_NAME(chzt_choice) LTFAT_NAME(chzt_choices)[CHZT_CHOICES];
+static ltfat_int LTFAT_NAME(chzt_choicesNo) = 0;
+
+#ifndef LTFAT_NOTHREADS
+#include <pthread.h>
+static pthread_mutex_t LTFAT_NAME(chzt_mutex) = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static void
+LTFAT_NAME(chzt_lock)(void)
+{
+#ifndef LTFAT_NOTHREADS
+    pthread_mutex_lock(&LTFAT_NAME(chzt_mutex));
+#endif
+}
+
+static void
+LTFAT_NAME(chzt_unlock)(void)
+{
+#ifndef LTFAT_NOTHREADS
+    pthread_mutex_unlock(&LTFAT_NAME(chzt_mutex));
+#endif
+}
+
+static ltfat_int
+LTFAT_NAME(chzt_nextfft)(ltfat_int L, czt_ffthint hint)
+{
+    return hint == CZT_NEXTPOW2 ? ltfat_nextpow2(L) : ltfat_nextfastfft(L);
+}
+
+static void
+LTFAT_NAME(chzt_tables_free)(LTFAT_NAME(chzt_tables)* t)
+{
+    LTFAT_SAFEFREEALL(t->W2, t->Wo, t->chirpF);
+    ltfat_free(t);
+}
+
+static int
+LTFAT_NAME(chzt_tables_direct)(LTFAT_NAME(chzt_tables)* t)
+{
+    ltfat_int K = t->K, L = t->L, Lfft = t->Lfft;
+    LTFAT_REAL deltao = t->deltao, o = t->o;
+    int status = LTFATERR_SUCCESS;
+
+    // Pre and post chirp
+    ltfat_int N = L > K ? L : K;
+    CHECKMEM( t->W2 = LTFAT_NAME_COMPLEX(malloc)(Lfft) );
+    CHECKMEM( t->chirpF = LTFAT_NAME_COMPLEX(malloc)(Lfft) );
+    CHECKMEM( t->Wo = LTFAT_NAME_COMPLEX(malloc)(L) );
+    LTFAT_COMPLEX* W2 = t->W2;
+    LTFAT_COMPLEX* chirpF = t->chirpF;
+
+    for (ltfat_int ii = 0; ii < N; ii++)
+    {
+        W2[ii] = exp(-I * (LTFAT_REAL)( deltao * ii * ii / 2.0));
+    }
+
+    for (ltfat_int ii = 0; ii < L; ii++)
+    {
+        t->Wo[ii] = exp(-I * (LTFAT_REAL)( o * ii )) * W2[ii];
+    }
+    // Set the rest to zero
+    LTFAT_NAME_COMPLEX(clear_array)( W2 + N, Lfft - N);
+
+    LTFAT_NAME_COMPLEX(conjugate_array)(W2, K, chirpF);
+    LTFAT_NAME_COMPLEX(conjugate_array)(W2 + 1, L - 1, chirpF + Lfft - L + 1);
+    LTFAT_NAME_COMPLEX(reverse_array)(chirpF + Lfft - L + 1, L - 1,
+                                      chirpF + Lfft - L + 1);
+
+    LTFAT_NAME_COMPLEX(clear_array)( chirpF + K, Lfft - (L + K - 1));
+
+    CHECKSTATUS( LTFAT_NAME_REAL(fft)(chirpF, Lfft, 1, chirpF));
+
+    for (ltfat_int ii = 0; ii < K; ii++)
+    {
+        W2[ii] = exp(-I * (LTFAT_REAL)(deltao * ii * ii / 2.0))
+                 / (( LTFAT_REAL) Lfft);
+    }
+error:
+    return status;
+}
+
+static int
+LTFAT_NAME(chzt_tables_fac)(LTFAT_NAME(chzt_tables)* t)
+{
+    ltfat_int K = t->K, q = t->q, Lfft = t->Lfft;
+    LTFAT_REAL deltao = t->deltao, o = t->o;
+    int status = LTFATERR_SUCCESS;
+
+    CHECKMEM( t->W2 = LTFAT_NAME_COMPLEX(malloc)(K) );
+    CHECKMEM( t->chirpF = LTFAT_NAME_COMPLEX(malloc)(Lfft) );
+    CHECKMEM( t->Wo = LTFAT_NAME_COMPLEX(malloc)(q * K) );
+    LTFAT_COMPLEX* W2 = t->W2;
+    LTFAT_COMPLEX* chirpF = t->chirpF;
+
+    for (ltfat_int k = 0; k < K; k++)
+    {
+        W2[k] = exp(- I * (LTFAT_REAL)( q * deltao *  k * k  / 2.0));
+    }
+
+    LTFAT_NAME_COMPLEX(conjugate_array)(W2, K, chirpF);
+    LTFAT_NAME_COMPLEX(conjugate_array)(W2 + 1, K - 1, chirpF + Lfft - K + 1);
+    LTFAT_NAME_COMPLEX(reverse_array)(chirpF + Lfft - K + 1, K - 1,
+                                      chirpF + Lfft - K + 1);
+
+    LTFAT_NAME_COMPLEX(clear_array)( chirpF + K, Lfft - (2 * K - 1));
+
+    CHECKSTATUS( LTFAT_NAME_REAL(ifft)( chirpF, Lfft, 1, chirpF));
+
+    LTFAT_REAL oneoverLfft = (LTFAT_REAL) ( 1.0 / Lfft );
+
+    for (ltfat_int jj = 0; jj < q; jj++)
     {
-        LTFAT_COMPLEX* cPtrTmp = (LTFAT_COMPLEX*) cPtr + w * p->M;
-        ltfat_int unrollRem = p->M % GGA_UNROLL;
-
-        const LTFAT_REAL* cos_term = p->cos_term;
-        const LTFAT_COMPLEX* cc_term = p->cc_term;
-        const LTFAT_COMPLEX* cc2_term = p->cc2_term;
-//#pragma omp parallel for
-        for (ltfat_int m = 0; m < p->M - unrollRem; m += GGA_UNROLL)
+        LTFAT_COMPLEX* Wotmp = t->Wo + jj * K;
+        for (ltfat_int k = 0; k < K; k++)
         {
-            LTFAT_TYPE s0[GGA_UNROLL] = {0};
-            LTFAT_TYPE s1[GGA_UNROLL] = {0};
-            LTFAT_TYPE s2[GGA_UNROLL] = {0};
+            Wotmp[k] = exp(- I * (LTFAT_REAL)jj * ((LTFAT_REAL)k * deltao + o)) * W2[k] *
+                       oneoverLfft;
+        }
+    }
 
-            /* for (ltfat_int un = 0; un < GGA_UNROLL; un++) */
-            /* { */
-            /*     s0[un] = 0.0; */
-            /*     s1[un] = 0.0; */
-            /*     s2[un] = 0.0; */
-            /* } */
+    for (ltfat_int k = 0; k < K; k++)
+    {
+        W2[k] *= exp(- I * (LTFAT_REAL)(k * q) * o);
+    }
+error:
+    return status;
+}
 
-            LTFAT_TYPE* fPtrTmp = (LTFAT_TYPE*) fPtr + w * p->L;
+/* Must be called with the lock held */
+static void
+LTFAT_NAME(chzt_cache_shrink)(ltfat_int keep)
+{
+    while (1)
+    {
+        LTFAT_NAME(chzt_tables)** oldest = NULL;
+        ltfat_int idle = 0;
 
-            for (ltfat_int ii = 0; ii < p->L - 1; ii++)
-            {
-                for (ltfat_int un = 0; un < GGA_UNROLL; un++)
-                {
-                    s0[un] = *fPtrTmp + cos_term[un] * s1[un] - s2[un];
-                    s2[un] = s1[un];
-                    s1[un] = s0[un];
-                }
-                fPtrTmp++;
-            }
-            for (ltfat_int un = 0; un < GGA_UNROLL; un++)
-            {
-                s0[un] = *fPtrTmp + cos_term[un] * s1[un] - s2[un];
-                cPtrTmp[m + un] = (s0[un] * cc2_term[un] - s1[un] * cc_term[un]);
-            }
-            cos_term += GGA_UNROLL;
-            cc_term += GGA_UNROLL;
-            cc2_term += GGA_UNROLL;
+        for (LTFAT_NAME(chzt_tables)** tp = &LTFAT_NAME(chzt_cache); *tp;
+             tp = &(*tp)->next)
+        {
+            if ((*tp)->refcount > 0) continue;
+            idle++;
+            if (!oldest || (*tp)->stamp < (*oldest)->stamp) oldest = tp;
         }
 
-        ltfat_int m = p->M - unrollRem;
+        if (idle <= keep) break;
+
+        LTFAT_NAME(chzt_tables)* t = *oldest;
+        *oldest = t->next;
+        LTFAT_NAME(chzt_tables_free)(t);
+    }
+}
 
+static int
+LTFAT_NAME(chzt_tables_get)(ltfat_int K, ltfat_int L, LTFAT_REAL deltao,
+                            LTFAT_REAL o, czt_ffthint hint, int fac,
+                            LTFAT_NAME(chzt_tables)** tout)
+{
+    LTFAT_NAME(chzt_tables)* t = NULL;
+    int status = LTFATERR_SUCCESS;
 
-        LTFAT_TYPE s0[GGA_UNROLL] = {0};
-        LTFAT_TYPE s1[GGA_UNROLL] = {0};
-        LTFAT_TYPE s2[GGA_UNROLL] = {0};
+    LTFAT_NAME(chzt_lock)();
 
-        /* for (ltfat_int un = 0; un < unrollRem; un++) */
-        /* { */
-        /*     s0[un] = 0.0; */
-        /*     s1[un] = 0.0; */
-        /*     s2[un] = 0.0; */
-        /* } */
+    for (t = LTFAT_NAME(chzt_cache); t; t = t->next)
+        if (t->K == K && t->L == L && t->deltao == deltao && t->o == o &&
+            t->hint == hint && t->fac == fac)
+            break;
 
-        LTFAT_TYPE* fPtrTmp = (LTFAT_TYPE*) fPtr + w * p->L;
+    if (!t)
+    {
+        CHECKMEM( t = LTFAT_NEW(LTFAT_NAME(chzt_tables)) );
+        t->K = K; t->L = L; t->deltao = deltao; t->o = o; t->hint = hint;
+        t->fac = fac;
 
-        for (ltfat_int ii = 0; ii < p->L - 1; ii++)
+        if (fac)
         {
-            for (ltfat_int un = 0; un < unrollRem; un++)
-            {
-                s0[un] = *fPtrTmp + cos_term[un] * s1[un] - s2[un];
-                s2[un] = s1[un];
-                s1[un] = s0[un];
-            }
-            fPtrTmp++;
+            t->q = (ltfat_int) ceil(((double)L) / ((double)K));
+            t->Lfft = LTFAT_NAME(chzt_nextfft)(2 * K - 1, hint);
+            CHECKSTATUS( LTFAT_NAME(chzt_tables_fac)(t));
         }
-
-        for (ltfat_int un = 0; un < unrollRem; un++)
+        else
         {
-            s0[un] = *fPtrTmp + cos_term[un] * s1[un] - s2[un];
-            cPtrTmp[m + un] = (s0[un] * cc2_term[un] - s1[un] * cc_term[un]);
+            t->q = 1;
+            t->Lfft = LTFAT_NAME(chzt_nextfft)(L + K - 1, hint);
+            CHECKSTATUS( LTFAT_NAME(chzt_tables_direct)(t));
         }
 
+        t->next = LTFAT_NAME(chzt_cache);
+        LTFAT_NAME(chzt_cache) = t;
     }
-#endif
+
+    t->refcount++;
+    *tout = t;
+    LTFAT_NAME(chzt_unlock)();
+    return status;
+error:
+    if (t) LTFAT_NAME(chzt_tables_free)(t);
+    LTFAT_NAME(chzt_unlock)();
+    return status;
 }
 
+static void
+LTFAT_NAME(chzt_tables_release)(LTFAT_NAME(chzt_tables)* t)
+{
+    LTFAT_NAME(chzt_lock)();
+    if (--t->refcount == 0)
+    {
+        t->stamp = LTFAT_NAME(chzt_cache_clock)++;
+        LTFAT_NAME(chzt_cache_shrink)(CHZT_CACHE_CAPACITY);
+    }
+    LTFAT_NAME(chzt_unlock)();
+}
 
+LTFAT_API int
+LTFAT_NAME(chzt_cache_clear)(void)
+{
+    LTFAT_NAME(chzt_lock)();
+    LTFAT_NAME(chzt_cache_shrink)(0);
+    LTFAT_NAME(chzt_choicesNo) = 0;
+    LTFAT_NAME(chzt_unlock)();
+    return LTFATERR_SUCCESS;
+}
 
-LTFAT_API
-void LTFAT_NAME(gga)(const LTFAT_TYPE* fPtr, const LTFAT_REAL* indVecPtr,
-                     ltfat_int L, ltfat_int W, ltfat_int M, LTFAT_COMPLEX* cPtr)
+static int
+LTFAT_NAME(chzt_plan_init)(ltfat_int K, ltfat_int L, LTFAT_REAL deltao,
+                           LTFAT_REAL o, ltfat_int Wb, unsigned fftw_flags,
+                           czt_ffthint hint, int fac, LTFAT_NAME(chzt_plan)* p)
 {
-    LTFAT_NAME(gga_plan) p = LTFAT_NAME(gga_init)(indVecPtr, M, L);
-    LTFAT_NAME(gga_execute)(p, fPtr, W, cPtr);
-    LTFAT_NAME(gga_done)(p);
+    LTFAT_NAME(chzt_plan) pp = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_NOTPOSARG, K > 0, "K must be positive");
+    CHECK(LTFATERR_NOTPOSARG, L > 0, "L must be positive");
+    CHECK(LTFATERR_NOTPOSARG, Wb > 0, "Wb must be positive");
+
+    CHECKMEM( pp = LTFAT_NEW(struct LTFAT_NAME(chzt_plan_struct)) );
+    CHECKSTATUS(
+        LTFAT_NAME(chzt_tables_get)(K, L, deltao, o, hint, fac, &pp->t));
+
+    pp->L = L; pp->K = K; pp->Wb = Wb; pp->fac = fac;
+    pp->Lfft = pp->t->Lfft; pp->q = pp->t->q;
+    pp->W2 = pp->t->W2; pp->Wo = pp->t->Wo; pp->chirpF = pp->t->chirpF;
+
+    // One multi-column FFT for q columns of Wb signals
+    CHECKMEM( pp->fbuffer = LTFAT_NAME_COMPLEX(malloc)(pp->q * pp->Lfft * Wb) );
+    CHECKSTATUS(
+        LTFAT_NAME_REAL(fft_init)( pp->Lfft, pp->q * Wb, pp->fbuffer,
+                                   pp->fbuffer, fftw_flags, &pp->plan));
+    CHECKSTATUS(
+        LTFAT_NAME_REAL(ifft_init)(pp->Lfft, pp->q * Wb, pp->fbuffer,
+                                   pp->fbuffer, fftw_flags, &pp->plan2));
+
+    *p = pp;
+    return status;
+error:
+    if (pp) LTFAT_NAME(chzt_done)(pp);
+    return status;
+}
+
+/* Seconds per execution */
+static double
+LTFAT_NAME(chzt_measure)(LTFAT_NAME(chzt_plan) p, const LTFAT_TYPE* f,
+                         LTFAT_COMPLEX* c)
+{
+    ltfat_int reps = 1;
+    double elapsed;
+
+    LTFAT_NAME(chzt_execute)(p, f, p->Wb, c);
+    while (1)
+    {
+        double start = ltfat_time_monotonic();
+        for (ltfat_int r = 0; r < reps; r++)
+            LTFAT_NAME(chzt_execute)(p, f, p->Wb, c);
+        elapsed = ltfat_time_monotonic() - start;
+
+        if (elapsed > 2e-3 || reps >= 1024) break;
+        reps *= 2;
+    }
+    return elapsed / reps;
+}
+
+static int
+LTFAT_NAME(chzt_choose)(ltfat_int K, ltfat_int L, ltfat_int Wb,
+                        unsigned fftw_flags, czt_ffthint hint,
+                        czt_method* method)
+{
+    LTFAT_NAME(chzt_plan) pd = NULL, pf = NULL;
+    LTFAT_TYPE* f = NULL;
+    LTFAT_COMPLEX* c = NULL;
+    int found = 0, status = LTFATERR_SUCCESS;
+
+    LTFAT_NAME(chzt_lock)();
+    for (ltfat_int ii = 0; ii < LTFAT_NAME(chzt_choicesNo); ii++)
+    {
+        LTFAT_NAME(chzt_choice)* ch = &LTFAT_NAME(chzt_choices)[ii];
+        if (ch->K == K && ch->L == L && ch->Wb == Wb && ch->hint == hint &&
+            ch->flags == fftw_flags)
+        {
+            *method = ch->method;
+            found = 1;
+            break;
+        }
+    }
+    LTFAT_NAME(chzt_unlock)();
+    if (found) return status;
+
+    // The speed does not depend on the frequency range
+    CHECKMEM( f = LTFAT_NAME(calloc)(L * Wb) );
+    CHECKMEM( c = LTFAT_NAME_COMPLEX(malloc)(K * Wb) );
+    CHECKSTATUS(
+        LTFAT_NAME(chzt_plan_init)(K, L, 0.0, 0.0, Wb, fftw_flags, hint, 0, &pd));
+    CHECKSTATUS(
+        LTFAT_NAME(chzt_plan_init)(K, L, 0.0, 0.0, Wb, fftw_flags, hint, 1, &pf));
+
+    *method = LTFAT_NAME(chzt_measure)(pf, f, c) < LTFAT_NAME(chzt_measure)(pd, f, c) ?
+              CZT_FAC : CZT_DIRECT;
+
+    LTFAT_NAME(chzt_lock)();
+    if (LTFAT_NAME(chzt_choicesNo) < CHZT_CHOICES)
+    {
+        LTFAT_NAME(chzt_choice) ch = { K, L, Wb, hint, fftw_flags, *method };
+        LTFAT_NAME(chzt_choices)[LTFAT_NAME(chzt_choicesNo)++] = ch;
+    }
+    LTFAT_NAME(chzt_unlock)();
+error:
+    if (pd) LTFAT_NAME(chzt_done)(pd);
+    if (pf) LTFAT_NAME(chzt_done)(pf);
+    LTFAT_SAFEFREEALL(f, c);
+    return status;
 }
 
+LTFAT_API int
+LTFAT_NAME(chzt_init_batch)(ltfat_int K, ltfat_int L, LTFAT_REAL deltao,
+                            LTFAT_REAL o, ltfat_int Wb, unsigned fftw_flags,
+                            czt_ffthint hint, czt_method method,
+                            LTFAT_NAME(chzt_plan)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_CANNOTHAPPEN,
+          method == CZT_AUTO || method == CZT_DIRECT || method == CZT_FAC,
+          "Invalid czt_method enum value.");
+    CHECK(LTFATERR_NOTPOSARG, K > 0 && L > 0 && Wb > 0,
+          "K, L and Wb must be positive");
+
+    if (method == CZT_AUTO)
+        CHECKSTATUS(
+            LTFAT_NAME(chzt_choose)(K, L, Wb, fftw_flags, hint, &method));
+
+    CHECKSTATUS(
+        LTFAT_NAME(chzt_plan_init)(K, L, deltao, o, Wb, fftw_flags, hint,
+                                   method == CZT_FAC, p));
+error:
+    return status;
+}
 
+LTFAT_API int
+LTFAT_NAME(chzt_get_method)(LTFAT_NAME(chzt_plan) p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    return p->fac ? CZT_FAC : CZT_DIRECT;
+error:
+    return status;
+}
 
 LTFAT_API void
 LTFAT_NAME(chzt)(const LTFAT_TYPE* fPtr, ltfat_int L, ltfat_int W,
                  ltfat_int K, const LTFAT_REAL deltao, const LTFAT_REAL o,
                  LTFAT_COMPLEX* cPtr)
 {
-    LTFAT_NAME(chzt_plan) p = LTFAT_NAME(chzt_init)(K, L, deltao, o,
-                              FFTW_ESTIMATE,
-                              CZT_NEXTFASTFFT);
+    LTFAT_NAME(chzt_plan) p = NULL;
+    if (LTFAT_NAME(chzt_init_batch)(K, L, deltao, o, W, FFTW_ESTIMATE,
+                                    CZT_NEXTFASTFFT, CZT_DIRECT, &p))
+        return;
 
     LTFAT_NAME(chzt_execute)(p, fPtr, W, cPtr);
 
     LTFAT_NAME(chzt_done)(p);
 }
 
-
-LTFAT_API void
-LTFAT_NAME(chzt_execute)(LTFAT_NAME(chzt_plan) p, const LTFAT_TYPE* fPtr,
-                         ltfat_int W, LTFAT_COMPLEX* cPtr)
+static void
+LTFAT_NAME(chzt_direct_execute)(LTFAT_NAME(chzt_plan) p, const LTFAT_TYPE* fPtr,
+                                ltfat_int W, LTFAT_COMPLEX* cPtr)
 {
-
     ltfat_int L = p->L;
     ltfat_int K = p->K;
     ltfat_int Lfft = p->Lfft;
-    LTFAT_COMPLEX* fbuffer = p->fbuffer;
-    /* LTFAT_FFTW(plan) plan_f = p->plan; */
-    /* LTFAT_FFTW(plan) plan_fi = p->plan2; */
     LTFAT_NAME_REAL(fft_plan)*   plan_f = p->plan;
     LTFAT_NAME_REAL(ifft_plan)* plan_fi = p->plan2;
-    LTFAT_COMPLEX* W2 = p->W2;
-    LTFAT_COMPLEX* Wo = p->Wo;
-    LTFAT_COMPLEX* chirpF = p->chirpF;
+    const LTFAT_COMPLEX* W2 = p->W2;
+    const LTFAT_COMPLEX* Wo = p->Wo;
+    const LTFAT_COMPLEX* chirpF = p->chirpF;
 
-    for (ltfat_int w = 0; w < W; w++)
+    for (ltfat_int w0 = 0; w0 < W; w0 += p->Wb)
     {
-        LTFAT_NAME_COMPLEX(clear_array)( fbuffer, Lfft);
-        //memset(fbuffer, 0, Lfft * sizeof * fbuffer);
+        // The unused columns of the last batch stay zero
+        ltfat_int Wc = ltfat_imin(p->Wb, W - w0);
+        LTFAT_NAME_COMPLEX(clear_array)( p->fbuffer, Lfft * p->Wb);
+
+        for (ltfat_int w = 0; w < Wc; w++)
+        {
+            LTFAT_COMPLEX* fbuffer = p->fbuffer + w * Lfft;
 #ifdef LTFAT_COMPLEXTYPE
-        memcpy(fbuffer, fPtr + w * L, L * sizeof * fbuffer);
+            memcpy(fbuffer, fPtr + (w0 + w) * L, L * sizeof * fbuffer);
 #else
-        LTFAT_NAME_REAL(real2complex_array)(fPtr + w * L, L, fbuffer);
+            LTFAT_NAME_REAL(real2complex_array)(fPtr + (w0 + w) * L, L, fbuffer);
 #endif
-        //1) Premultiply by a chirp
-
-        for (ltfat_int ii = 0; ii < L; ii++)
-        {
-            fbuffer[ii] *= Wo[ii];
+            //1) Premultiply by a chirp
+            for (ltfat_int ii = 0; ii < L; ii++)
+            {
+                fbuffer[ii] *= Wo[ii];
+            }
         }
 
         // 2) FFT of input
-        /* LTFAT_FFTW(execute)(plan_f); */
         LTFAT_NAME_REAL(fft_execute)(plan_f);
 
         // Frequency domain filtering
-        for (ltfat_int ii = 0; ii < Lfft; ii++)
+        for (ltfat_int w = 0; w < Wc; w++)
         {
-            fbuffer[ii] *= chirpF[ii];
+            LTFAT_COMPLEX* fbuffer = p->fbuffer + w * Lfft;
+            for (ltfat_int ii = 0; ii < Lfft; ii++)
+            {
+                fbuffer[ii] *= chirpF[ii];
+            }
         }
 
-
         // Inverse FFT
-        LTFAT_COMPLEX* fPtrTmp = fbuffer;
-        /* LTFAT_FFTW(execute)(plan_fi); */
         LTFAT_NAME_REAL(ifft_execute)(plan_fi);
 
         // Final chirp multiplication and normalization
-        LTFAT_COMPLEX* cPtrTmp = cPtr + w * K;
-        for (ltfat_int ii = 0; ii < K; ii++)
+        for (ltfat_int w = 0; w < Wc; w++)
         {
-            cPtrTmp[ii] = fPtrTmp[ii] * W2[ii];
+            LTFAT_COMPLEX* fPtrTmp = p->fbuffer + w * Lfft;
+            LTFAT_COMPLEX* cPtrTmp = cPtr + (w0 + w) * K;
+            for (ltfat_int ii = 0; ii < K; ii++)
+            {
+                cPtrTmp[ii] = fPtrTmp[ii] * W2[ii];
+            }
         }
-
     }
+}
 
+LTFAT_API void
+LTFAT_NAME(chzt_execute)(LTFAT_NAME(chzt_plan) p, const LTFAT_TYPE* fPtr,
+                         ltfat_int W, LTFAT_COMPLEX* cPtr)
+{
+    if (p->fac)
+        LTFAT_NAME(chzt_fac_execute)(p, fPtr, W, cPtr);
+    else
+        LTFAT_NAME(chzt_direct_execute)(p, fPtr, W, cPtr);
 }
 
 LTFAT_API LTFAT_NAME(chzt_plan)
@@ -281,93 +828,19 @@ LTFAT_NAME(chzt_init)(ltfat_int K, ltfat_int L, const LTFAT_REAL deltao,
                       const LTFAT_REAL o, const unsigned fftw_flags,
                       czt_ffthint hint)
 {
-    ltfat_int Lfft = L + K - 1;
-
-    if (hint == CZT_NEXTPOW2)
-        Lfft = ltfat_nextpow2(Lfft);
-    else
-        Lfft = ltfat_nextfastfft(Lfft);
-
-    LTFAT_COMPLEX* fbuffer = LTFAT_NAME_COMPLEX(malloc)(Lfft);
-    /* int Lfftint = (int) Lfft; */
-    /* LTFAT_FFTW(plan) plan_f =  LTFAT_FFTW(plan_dft_1d)(Lfftint, */
-    /*                            (LTFAT_FFTW(complex)*) fbuffer, */
-    /*                            (LTFAT_FFTW(complex)*) fbuffer, */
-    /*                            FFTW_FORWARD, fftw_flags); */
-    /* LTFAT_FFTW(plan) plan_fi =  LTFAT_FFTW(plan_dft_1d)(Lfftint, */
-    /*                             (LTFAT_FFTW(complex)*) fbuffer, */
-    /*                             (LTFAT_FFTW(complex)*) fbuffer, */
-    /*                             FFTW_BACKWARD, fftw_flags); */
-
-    LTFAT_NAME_REAL(fft_plan)*   plan_f;
-    LTFAT_NAME_REAL(ifft_plan)* plan_fi;
-    LTFAT_NAME_REAL(fft_init)( Lfft, 1, fbuffer, fbuffer, fftw_flags, &plan_f);
-    LTFAT_NAME_REAL(ifft_init)(Lfft, 1, fbuffer, fbuffer, fftw_flags, &plan_fi);
-
-    // Pre and post chirp
-    ltfat_int N = L > K ? L : K;
-    LTFAT_COMPLEX* W2 = LTFAT_NAME_COMPLEX(malloc)(Lfft);
-    LTFAT_COMPLEX* chirpF = LTFAT_NAME_COMPLEX(malloc)(Lfft);
-    LTFAT_COMPLEX* Wo = LTFAT_NAME_COMPLEX(malloc)(L);
-
-
-    for (ltfat_int ii = 0; ii < N; ii++)
-    {
-        W2[ii] = exp(-I * (LTFAT_REAL)( deltao * ii * ii / 2.0));
-    }
-
-    for (ltfat_int ii = 0; ii < L; ii++)
-    {
-        Wo[ii] = exp(-I * (LTFAT_REAL)( o * ii )) * W2[ii];
-    }
-    // Set the rest to zero
-    /* memset(W2 + N, 0, (Lfft - N)*sizeof * W2); */
-    LTFAT_NAME_COMPLEX(clear_array)( W2 + N, Lfft - N);
-
-    LTFAT_NAME_COMPLEX(conjugate_array)(W2, K, chirpF);
-    LTFAT_NAME_COMPLEX(conjugate_array)(W2 + 1, L - 1, chirpF + Lfft - L + 1);
-    LTFAT_NAME_COMPLEX(reverse_array)(chirpF + Lfft - L + 1, L - 1,
-                                      chirpF + Lfft - L + 1);
-
-    LTFAT_NAME_COMPLEX(clear_array)( chirpF + K, Lfft - (L + K - 1));
-    /* memset(chirpF + K, 0, (Lfft - (L + K - 1))*sizeof * chirpF); */
-
-    /* LTFAT_FFTW(execute_dft)(plan_f, (LTFAT_FFTW(complex)*) chirpF, */
-    /*                         (LTFAT_FFTW(complex)*) chirpF); */
-    LTFAT_NAME_REAL(fft_execute_newarray)(plan_f, chirpF, chirpF);
-
-    for (ltfat_int ii = 0; ii < K; ii++)
-    {
-        W2[ii] = exp(-I * (LTFAT_REAL)(deltao * ii * ii / 2.0))
-                 / (( LTFAT_REAL) Lfft);
-    }
-
-    /*
-    We could have shrinked the W2 to length K here.
-    */
-    /* struct LTFAT_NAME(chzt_plan_struct) p_struct = */
-    /* { */
-    /*     .fbuffer = fbuffer, .plan = plan_f, .plan2 = plan_fi, .L = L, .K = K, .W2 = W2, */
-    /*     .Wo = Wo, .chirpF = chirpF, .Lfft = Lfft */
-    /* }; */
-
-    LTFAT_NAME(chzt_plan) p = (LTFAT_NAME(chzt_plan)) ltfat_malloc(sizeof * p);
-    p->fbuffer = fbuffer; p->plan = plan_f; p->plan2 = plan_fi; p->L = L;
-    p->K = K; p->W2 = W2; p->Wo = Wo; p->chirpF = chirpF; p->Lfft = Lfft;
-
-    /* memcpy(p, &p_struct, sizeof * p); */
-
-    return  p;
+    LTFAT_NAME(chzt_plan) p = NULL;
+    LTFAT_NAME(chzt_init_batch)(K, L, deltao, o, 1, fftw_flags, hint,
+                                CZT_DIRECT, &p);
+    return p;
 }
 
 LTFAT_API
 void LTFAT_NAME(chzt_done)(LTFAT_NAME(chzt_plan) p)
 {
-    LTFAT_SAFEFREEALL(p->fbuffer, p->W2, p->Wo, p->chirpF);
-    /* LTFAT_FFTW(destroy_plan)(p->plan); */
-    /* LTFAT_FFTW(destroy_plan)(p->plan2); */
-    LTFAT_NAME_REAL(fft_done)(&p->plan);
-    LTFAT_NAME_REAL(ifft_done)(&p->plan2);
+    if (p->t) LTFAT_NAME(chzt_tables_release)(p->t);
+    ltfat_safefree(p->fbuffer);
+    if (p->plan) LTFAT_NAME_REAL(fft_done)(&p->plan);
+    if (p->plan2) LTFAT_NAME_REAL(ifft_done)(&p->plan2);
     ltfat_free(p);
 }
 
@@ -377,47 +850,45 @@ LTFAT_NAME(chzt_fac)(const LTFAT_TYPE* fPtr, ltfat_int L,
                      ltfat_int W, ltfat_int K, const LTFAT_REAL deltao,
                      const LTFAT_REAL o, LTFAT_COMPLEX* cPtr)
 {
-    LTFAT_NAME(chzt_plan) p = LTFAT_NAME(chzt_fac_init)(K, L, deltao, o,
-                              FFTW_ESTIMATE, CZT_NEXTFASTFFT);
+    LTFAT_NAME(chzt_plan) p = NULL;
+    if (LTFAT_NAME(chzt_init_batch)(K, L, deltao, o, W, FFTW_ESTIMATE,
+                                    CZT_NEXTFASTFFT, CZT_FAC, &p))
+        return;
 
     LTFAT_NAME(chzt_fac_execute)(p, fPtr, W, cPtr);
 
     LTFAT_NAME(chzt_done)(p);
 }
 
-LTFAT_API void
-LTFAT_NAME(chzt_fac_execute)(LTFAT_NAME(chzt_plan) p, const LTFAT_TYPE* fPtr,
-                             ltfat_int W, LTFAT_COMPLEX* cPtr)
+static void
+LTFAT_NAME(chzt_fac_batch)(LTFAT_NAME(chzt_plan) p, const LTFAT_TYPE* fPtr,
+                           ltfat_int Wc, LTFAT_COMPLEX* cPtr)
 {
     ltfat_int L = p->L;
     ltfat_int K = p->K;
     ltfat_int Lfft = p->Lfft;
-    LTFAT_COMPLEX* fbuffer = p->fbuffer;
-    /* LTFAT_FFTW(plan) plan_f = p->plan; */
-    /* LTFAT_FFTW(plan) plan_fi = p->plan2; */
-    LTFAT_NAME_REAL(fft_plan)*   plan_f = p->plan;
-    LTFAT_NAME_REAL(ifft_plan)* plan_fi = p->plan2;
-    LTFAT_COMPLEX* W2 = p->W2;
-    LTFAT_COMPLEX* Wo = p->Wo;
-    LTFAT_COMPLEX* chirpF = p->chirpF;
+    ltfat_int q = p->q;
+    const LTFAT_COMPLEX* W2 = p->W2;
+    const LTFAT_COMPLEX* Wo = p->Wo;
+    const LTFAT_COMPLEX* chirpF = p->chirpF;
 
     LTFAT_COMPLEX* fBufTmp;
-    ltfat_int q = (ltfat_int) ceil(((double)L) / ((double)K));
-
     ltfat_int lastK = (L / q);
 
-    for (ltfat_int w = 0; w < W; w++)
+    // *********************************
+    // 1) Read and reorganize input data
+    // *********************************
+    // The unused columns of the last batch stay zero
+    LTFAT_NAME_COMPLEX(clear_array)( p->fbuffer, q * Lfft * p->Wb);
+
+    for (ltfat_int w = 0; w < Wc; w++)
     {
-        // *********************************
-        // 1) Read and reorganize input data
-        // *********************************
-        LTFAT_NAME_COMPLEX(clear_array)( fbuffer, q * Lfft);
-        /* memset(fbuffer, 0, q * Lfft * sizeof * fbuffer); */
-        LTFAT_TYPE* fPtrTmp = ((LTFAT_TYPE*)fPtr) + w * L;
+        LTFAT_COMPLEX* fbuffer = p->fbuffer + w * q * Lfft;
+        const LTFAT_TYPE* fPtrTmp = fPtr + w * L;
 
         for (ltfat_int k = 0; k < lastK; k++)
         {
-            LTFAT_TYPE* fTmp = fPtrTmp + k * q;
+            const LTFAT_TYPE* fTmp = fPtrTmp + k * q;
             fBufTmp = fbuffer + k;
             for (ltfat_int jj = 0; jj < q; jj++)
             {
@@ -426,7 +897,7 @@ LTFAT_NAME(chzt_fac_execute)(LTFAT_NAME(chzt_plan) p, const LTFAT_TYPE* fPtr,
             }
         }
 
-        LTFAT_TYPE* fTmp = fPtrTmp + lastK * q;
+        const LTFAT_TYPE* fTmp = fPtrTmp + lastK * q;
         fBufTmp = fbuffer + lastK;
         for (ltfat_int jj = 0; jj < L - lastK * q; jj++)
         {
@@ -437,7 +908,6 @@ LTFAT_NAME(chzt_fac_execute)(LTFAT_NAME(chzt_plan) p, const LTFAT_TYPE* fPtr,
         // *********************************
         // 2) Premultiply
         // *********************************
-
         fBufTmp = fbuffer;
         for (ltfat_int jj = 0; jj < q; jj++)
         {
@@ -447,38 +917,40 @@ LTFAT_NAME(chzt_fac_execute)(LTFAT_NAME(chzt_plan) p, const LTFAT_TYPE* fPtr,
             }
             fBufTmp += Lfft;
         }
+    }
 
-        // *********************************
-        // 3) q ffts of length Lfft
-        // *********************************
-        /* LTFAT_FFTW(execute)(plan_f); */
-        LTFAT_NAME_REAL(fft_execute)(plan_f);
+    // *********************************
+    // 3) q*Wb ffts of length Lfft
+    // *********************************
+    LTFAT_NAME_REAL(fft_execute)(p->plan);
 
-        // *********************************
-        // 4) Filter
-        // *********************************
-        fBufTmp = fbuffer;
-        // Frequency domain filtering
-        for (ltfat_int jj = 0; jj < q; jj++)
+    // *********************************
+    // 4) Filter
+    // *********************************
+    fBufTmp = p->fbuffer;
+    for (ltfat_int jj = 0; jj < q * Wc; jj++)
+    {
+        for (ltfat_int ii = 0; ii < Lfft; ii++)
         {
-            for (ltfat_int ii = 0; ii < Lfft; ii++)
-            {
-                fBufTmp[ii] *= chirpF[ii];
-            }
-            fBufTmp += Lfft;
+            fBufTmp[ii] *= chirpF[ii];
         }
+        fBufTmp += Lfft;
+    }
 
-        // *********************************
-        // 5) q iffts of length Lfft
-        // *********************************
-        /* LTFAT_FFTW(execute)(plan_fi); */
-        LTFAT_NAME_REAL(ifft_execute)(plan_fi);
+    // *********************************
+    // 5) q*Wb iffts of length Lfft
+    // *********************************
+    LTFAT_NAME_REAL(ifft_execute)(p->plan2);
+
+    for (ltfat_int w = 0; w < Wc; w++)
+    {
+        LTFAT_COMPLEX* fbuffer = p->fbuffer + w * q * Lfft;
 
         // *********************************
         // 6) Postmultiply
         // *********************************
         fBufTmp = fbuffer;
-        LTFAT_COMPLEX* Wotmp = Wo;
+        const LTFAT_COMPLEX* Wotmp = Wo;
         for (ltfat_int jj = 0; jj < q; jj++)
         {
             for (ltfat_int k = 0; k < K; k++)
@@ -503,8 +975,22 @@ LTFAT_NAME(chzt_fac_execute)(LTFAT_NAME(chzt_plan) p, const LTFAT_TYPE* fPtr,
                 fBufTmp += Lfft;
             }
         }
+    }
+}
 
+LTFAT_API void
+LTFAT_NAME(chzt_fac_execute)(LTFAT_NAME(chzt_plan) p, const LTFAT_TYPE* fPtr,
+                             ltfat_int W, LTFAT_COMPLEX* cPtr)
+{
+    if (!p->fac)
+    {
+        LTFAT_NAME(chzt_direct_execute)(p, fPtr, W, cPtr);
+        return;
     }
+
+    for (ltfat_int w0 = 0; w0 < W; w0 += p->Wb)
+        LTFAT_NAME(chzt_fac_batch)(p, fPtr + w0 * p->L,
+                                   ltfat_imin(p->Wb, W - w0), cPtr + w0 * p->K);
 }
 
 LTFAT_API LTFAT_NAME(chzt_plan)
@@ -512,91 +998,8 @@ LTFAT_NAME(chzt_fac_init)(ltfat_int K, ltfat_int L,
                           const LTFAT_REAL deltao, const LTFAT_REAL o,
                           const unsigned fftw_flags, czt_ffthint hint)
 {
-
-    ltfat_int Lfft = 2 * K - 1;
-    if (hint == CZT_NEXTPOW2)
-        Lfft = ltfat_nextpow2(Lfft);
-    else
-        Lfft = ltfat_nextfastfft(Lfft);
-
-    ltfat_int q = (ltfat_int) ceil(((double)L) / ((double)K));
-
-    LTFAT_COMPLEX* fbuffer = LTFAT_NAME_COMPLEX(malloc)(q * Lfft);
-
-    /* LTFAT_FFTW(iodim64) dims; */
-    /* dims.n = Lfft; dims.is = 1; dims.os = 1; */
-    /* LTFAT_FFTW(iodim64) howmany_dims; */
-    /* howmany_dims.n = (int)q; howmany_dims.is = Lfft; howmany_dims.os = Lfft; */
-    /* LTFAT_FFTW(plan) plan_f =  LTFAT_FFTW(plan_guru64_dft)(1, &dims, 1, */
-    /*                            &howmany_dims, */
-    /*                            (LTFAT_FFTW(complex)*) fbuffer, */
-    /*                            (LTFAT_FFTW(complex)*) fbuffer, */
-    /*                            FFTW_FORWARD, fftw_flags); */
-    /*  */
-    /* LTFAT_FFTW(plan) plan_fi =  LTFAT_FFTW(plan_guru64_dft)(1, &dims, 1, */
-    /*                             &howmany_dims, */
-    /*                             (LTFAT_FFTW(complex)*) fbuffer, */
-    /*                             (LTFAT_FFTW(complex)*) fbuffer, */
-    /*                             FFTW_BACKWARD, fftw_flags); */
-
-    LTFAT_NAME_REAL(fft_plan)*   plan_f;
-    LTFAT_NAME_REAL(ifft_plan)* plan_fi;
-    LTFAT_NAME_REAL(fft_init)( Lfft, q, fbuffer, fbuffer, fftw_flags, &plan_f);
-    LTFAT_NAME_REAL(ifft_init)(Lfft, q, fbuffer, fbuffer, fftw_flags, &plan_fi);
-
-    LTFAT_COMPLEX* W2 = LTFAT_NAME_COMPLEX(malloc)(K);
-    LTFAT_COMPLEX* chirpF = LTFAT_NAME_COMPLEX(malloc)(Lfft);
-    LTFAT_COMPLEX* Wo = LTFAT_NAME_COMPLEX(malloc)(q * K);
-
-    /* LTFAT_FFTW(plan) plan_chirpF =  LTFAT_FFTW(plan_dft_1d)((int)Lfft, */
-    /*                                 (LTFAT_FFTW(complex)*) chirpF, */
-    /*                                 (LTFAT_FFTW(complex)*) chirpF, */
-    /*                                 FFTW_FORWARD, fftw_flags); */
-
-    for (ltfat_int k = 0; k < K; k++)
-    {
-        W2[k] = exp(- I * (LTFAT_REAL)( q * deltao *  k * k  / 2.0));
-    }
-
-    LTFAT_NAME_COMPLEX(conjugate_array)(W2, K, chirpF);
-    LTFAT_NAME_COMPLEX(conjugate_array)(W2 + 1, K - 1, chirpF + Lfft - K + 1);
-    LTFAT_NAME_COMPLEX(reverse_array)(chirpF + Lfft - K + 1, K - 1,
-                                      chirpF + Lfft - K + 1);
-
-    LTFAT_NAME_COMPLEX(clear_array)( chirpF + K, Lfft - (2 * K - 1));
-    /* memset(chirpF + K, 0, (Lfft - (2 * K - 1))*sizeof * chirpF); */
-    /* LTFAT_FFTW(execute)(plan_chirpF); */
-    /* LTFAT_FFTW(destroy_plan)(plan_chirpF); */
-
-    LTFAT_NAME_REAL(ifft)( chirpF, Lfft, 1, chirpF);
-
-    LTFAT_REAL oneoverLfft = (LTFAT_REAL) ( 1.0 / Lfft );
-
-    for (ltfat_int jj = 0; jj < q; jj++)
-    {
-        LTFAT_COMPLEX* Wotmp = Wo + jj * K;
-        for (ltfat_int k = 0; k < K; k++)
-        {
-            Wotmp[k] = exp(- I * (LTFAT_REAL)jj * ((LTFAT_REAL)k * deltao + o)) * W2[k] *
-                       oneoverLfft;
-        }
-    }
-
-    for (ltfat_int k = 0; k < K; k++)
-    {
-        W2[k] *= exp(- I * (LTFAT_REAL)(k * q) * o);
-    }
-
-    /* struct LTFAT_NAME(chzt_plan_struct) p_struct = */
-    /* { */
-    /*     .fbuffer = fbuffer, .plan = plan_f, .plan2 = plan_fi, .L = L, .K = K, .W2 = W2, */
-    /*     .Wo = Wo, .chirpF = chirpF, .Lfft = Lfft */
-    /* }; */
-
-    LTFAT_NAME(chzt_plan) p = (LTFAT_NAME(chzt_plan)) ltfat_malloc(sizeof * p);
-    p->fbuffer = fbuffer; p->plan = plan_f; p->plan2 = plan_fi;
-    p->L = L; p->K = K; p->W2 = W2; p->Wo = Wo; p->chirpF = chirpF;
-    p->Lfft = Lfft;
-    /* memcpy(p, &p_struct, sizeof * p); */
-    return  p;
+    LTFAT_NAME(chzt_plan) p = NULL;
+    LTFAT_NAME(chzt_init_batch)(K, L, deltao, o, 1, fftw_flags, hint,
+                                CZT_FAC, &p);
+    return p;
 }
@@ -1,6 +1,18 @@
 #include "ltfat.h"
 #include "ltfat/types.h"
 #include "ltfat/macros.h"
+#include "bitscan_private.h"
+
+/* The bucket heap keeps one LIFO list per bucket. The buckets are uniform
+ * in the log domain, BUCKET_PEROCTAVE buckets per octave of the value. The
+ * bucket is given by the exponent of the value converted to float and by
+ * floor(BUCKET_PEROCTAVE*log2(mantissa)), which is looked up in a table
+ * indexed by the BUCKET_TABLEBITS leading mantissa bits. Zero, negative
+ * and denormal values share the lowest bucket. */
+#define BUCKET_PEROCTAVE 8
+#define BUCKET_TABLEBITS 8
+#define BUCKET_NO (256 * BUCKET_PEROCTAVE)
+#define BUCKET_WORDS (BUCKET_NO / 64)
 
 struct LTFAT_NAME(heap)
 {
@@ -8,18 +20,61 @@ struct LTFAT_NAME(heap)
     ltfat_int heapsize;
     ltfat_int totalheapsize;
     const LTFAT_REAL* s;
+    ltfat_heap_type type;
+    /* Bucket heap only. h holds the keys of the list nodes. */
+    ltfat_int* next;        //!< Next node in the same bucket or the free list
+    ltfat_int* head;        //!< First node of each bucket, -1 if empty
+    uint64_t* nonempty;     //!< Bit per bucket
+    ltfat_int topword;      //!< No nonempty bucket above this word
+    ltfat_int freenode;     //!< Free list of nodes
+    ltfat_int usednodes;    //!< Nodes taken from the pool so far
+    unsigned char mantbucket[1 << BUCKET_TABLEBITS]; //!< Bucket within octave
 };
 
 LTFAT_API LTFAT_NAME(heap)*
 LTFAT_NAME(heap_init)(ltfat_int initmaxsize, const LTFAT_REAL* s)
 {
-    LTFAT_NAME(heap)* h = (LTFAT_NAME(heap)*) ltfat_malloc(sizeof * h);
+    return LTFAT_NAME(heap_initwithtype)(initmaxsize, s, LTFAT_HEAP_BINARY);
+}
 
-    h->totalheapsize  = initmaxsize;
-    h->h              = (ltfat_int*) ltfat_malloc(h->totalheapsize * sizeof * h->h);
+LTFAT_API LTFAT_NAME(heap)*
+LTFAT_NAME(heap_initwithtype)(ltfat_int initmaxsize, const LTFAT_REAL* s,
+                              ltfat_heap_type type)
+{
+    LTFAT_NAME(heap)* h = LTFAT_NEW(LTFAT_NAME(heap));
+    if (!h) return NULL;
+
+    h->totalheapsize  = ltfat_imax(initmaxsize, 1);
+    h->h              = LTFAT_NEWARRAY(ltfat_int, h->totalheapsize);
     h->s              = s;
     h->heapsize       = 0;
+    h->type           = type;
+
+    if (!h->h) goto error;
+
+    if (type == LTFAT_HEAP_BUCKET)
+    {
+        h->next = LTFAT_NEWARRAY(ltfat_int, h->totalheapsize);
+        h->head = LTFAT_NEWARRAY(ltfat_int, BUCKET_NO);
+        h->nonempty = LTFAT_NEWARRAY(uint64_t, BUCKET_WORDS);
+        if (!h->next || !h->head || !h->nonempty) goto error;
+
+        for (ltfat_int b = 0; b < BUCKET_NO; b++)
+            h->head[b] = -1;
+
+        /* Mantissa 1 + (j + 0.5)/2^BUCKET_TABLEBITS represents the j-th
+         * interval, the bucket borders are exact up to its width */
+        for (ltfat_int j = 0; j < 1 << BUCKET_TABLEBITS; j++)
+            h->mantbucket[j] = (unsigned char) floor( BUCKET_PEROCTAVE *
+                               log2(1.0 + (j + 0.5) / (1 << BUCKET_TABLEBITS)));
+
+        h->freenode = -1;
+    }
+
     return h;
+error:
+    LTFAT_NAME(heap_done)(h);
+    return NULL;
 }
 
 LTFAT_API const LTFAT_REAL*
@@ -31,7 +86,7 @@ LTFAT_NAME(heap_getdataptr)(LTFAT_NAME(heap)* h)
 LTFAT_API void
 LTFAT_NAME(heap_done)(LTFAT_NAME(heap)* h)
 {
-    ltfat_free(h->h);
+    LTFAT_SAFEFREEALL(h->h, h->next, h->head, h->nonempty);
     ltfat_free(h);
 }
 
@@ -39,7 +94,19 @@ LTFAT_API void
 LTFAT_NAME(heap_reset)(LTFAT_NAME(heap)* h, const LTFAT_REAL* news)
 {
     h->s = news;
+
+    if (h->type == LTFAT_HEAP_BUCKET && h->heapsize > 0)
+    {
+        for (ltfat_int b = 0; b < BUCKET_NO; b++)
+            h->head[b] = -1;
+
+        memset(h->nonempty, 0, BUCKET_WORDS * sizeof * h->nonempty);
+    }
+
     h->heapsize = 0;
+    h->topword = 0;
+    h->freenode = -1;
+    h->usednodes = 0;
 }
 
 LTFAT_API void
@@ -49,6 +116,79 @@ LTFAT_NAME(heap_grow)(LTFAT_NAME(heap)* h, int factor)
     h->h = (ltfat_int*)ltfat_realloc((void*)h->h,
                                     h->totalheapsize * sizeof * h->h / factor,
                                     h->totalheapsize * sizeof * h->h);
+
+    if (h->type == LTFAT_HEAP_BUCKET)
+        h->next = (ltfat_int*)ltfat_realloc((void*)h->next,
+                                           h->totalheapsize * sizeof * h->next / factor,
+                                           h->totalheapsize * sizeof * h->next);
+}
+
+static ltfat_int
+LTFAT_NAME(heap_bucket)(LTFAT_NAME(heap) *h, LTFAT_REAL val)
+{
+    float fval = (float) val;
+    uint32_t u, e;
+    memcpy(&u, &fval, sizeof u);
+
+    e = u >> 23;
+    /* e includes the sign bit, i.e. e > 255 for negative values */
+    if (e == 0 || e > 255) return 0;
+
+    return (ltfat_int) (BUCKET_PEROCTAVE * e +
+                        h->mantbucket[(u >> (23 - BUCKET_TABLEBITS)) &
+                                      ((1 << BUCKET_TABLEBITS) - 1)]);
+}
+
+static void
+LTFAT_NAME(heap_bucket_insert)(LTFAT_NAME(heap) *h, ltfat_int key)
+{
+    ltfat_int node, b = LTFAT_NAME(heap_bucket)(h, h->s[key]);
+
+    if (h->freenode >= 0)
+    {
+        node = h->freenode;
+        h->freenode = h->next[node];
+    }
+    else
+    {
+        if (h->totalheapsize == h->usednodes)
+            LTFAT_NAME(heap_grow)( h, 2);
+
+        node = h->usednodes++;
+    }
+
+    h->h[node] = key;
+    h->next[node] = h->head[b];
+    h->head[b] = node;
+    h->nonempty[b / 64] |= (uint64_t) 1 << (b % 64);
+    if (b / 64 > h->topword) h->topword = b / 64;
+    h->heapsize++;
+}
+
+/* Highest nonempty bucket, the heap must not be empty */
+static ltfat_int
+LTFAT_NAME(heap_bucket_top)(LTFAT_NAME(heap) *h)
+{
+    while (!h->nonempty[h->topword]) h->topword--;
+
+    return 64 * h->topword +
+           ltfat_highestbit64(h->nonempty[h->topword]);
+}
+
+static ltfat_int
+LTFAT_NAME(heap_bucket_delete)(LTFAT_NAME(heap) *h)
+{
+    ltfat_int b = LTFAT_NAME(heap_bucket_top)(h);
+    ltfat_int node = h->head[b];
+
+    h->head[b] = h->next[node];
+    if (h->head[b] < 0)
+        h->nonempty[b / 64] &= ~((uint64_t) 1 << (b % 64));
+
+    h->next[node] = h->freenode;
+    h->freenode = node;
+    h->heapsize--;
+    return h->h[node];
 }
 
 LTFAT_API void
@@ -56,6 +196,12 @@ LTFAT_NAME(heap_insert)(LTFAT_NAME(heap) *h, ltfat_int key)
 {
     ltfat_int pos, pos2;
 
+    if (h->type == LTFAT_HEAP_BUCKET)
+    {
+        LTFAT_NAME(heap_bucket_insert)(h, key);
+        return;
+    }
+
     /* Grow heap if necessary */
     if (h->totalheapsize == h->heapsize)
         LTFAT_NAME(heap_grow)( h, 2);
@@ -85,6 +231,8 @@ LTFAT_API ltfat_int
 LTFAT_NAME(heap_get)(LTFAT_NAME(heap) *h)
 {
     if (h->heapsize == 0) return LTFATERR_UNDERFLOW;
+    if (h->type == LTFAT_HEAP_BUCKET)
+        return h->h[h->head[LTFAT_NAME(heap_bucket_top)(h)]];
     return h->h[0];
 }
 
@@ -96,6 +244,8 @@ LTFAT_NAME(heap_delete)(LTFAT_NAME(heap) *h)
     LTFAT_REAL maxchildkey, val;
 
     if (h->heapsize == 0) return LTFATERR_UNDERFLOW;
+    if (h->type == LTFAT_HEAP_BUCKET) return LTFAT_NAME(heap_bucket_delete)(h);
+
     /* Extract first element */
     retkey = h->h[0];
     key = h->h[h->heapsize - 1];
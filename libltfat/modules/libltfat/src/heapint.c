@@ -7,16 +7,24 @@
 LTFAT_API LTFAT_NAME(heapinttask)*
 LTFAT_NAME(heapinttask_init)(ltfat_int height, ltfat_int N,
                              ltfat_int initheapsize,
-                             const LTFAT_REAL* s, int do_real)
+                             const LTFAT_REAL* s, int do_real,
+                             ltfat_heap_type heaptype)
 {
-    LTFAT_NAME(heapinttask)* hit = (LTFAT_NAME(heapinttask)*) ltfat_malloc(
-                                       sizeof * hit);
+    LTFAT_NAME(heapinttask)* hit = LTFAT_NEW(LTFAT_NAME(heapinttask));
+    if (!hit) return NULL;
+
     hit->height = height;
     hit->N = N;
     hit->donemask = (int*) ltfat_malloc(height * N * sizeof * hit->donemask);
-    hit->heap = LTFAT_NAME(heap_init)(initheapsize, s);
+    hit->heap = LTFAT_NAME(heap_initwithtype)(initheapsize, s, heaptype);
     hit->do_real = do_real;
 
+    if (!hit->donemask || !hit->heap)
+    {
+        LTFAT_NAME(heapinttask_done)(hit);
+        return NULL;
+    }
+
     if (do_real)
         hit->intfun = LTFAT_NAME(trapezheapreal);
     else
@@ -235,7 +243,7 @@ void LTFAT_NAME(heapint)(const LTFAT_REAL* s,
 
     // Init plan
     hit = LTFAT_NAME(heapinttask_init)( M, N, (ltfat_int)( M * log((double)M)) , s,
-                                        0);
+                                        0, LTFAT_HEAP_BINARY);
 
     for (ltfat_int w = 0; w < W; ++w)
     {
@@ -269,7 +277,7 @@ void LTFAT_NAME(maskedheapint)(const LTFAT_REAL* s,
 
     /* Main body */
     hit = LTFAT_NAME(heapinttask_init)( M, N, (ltfat_int)( M * log((double)M) ), s,
-                                        0);
+                                        0, LTFAT_HEAP_BINARY);
 
     // Set all phases outside of the mask to zeros, do not modify the rest
     for (ltfat_int ii = 0; ii < M * N * W; ii++)
@@ -470,7 +478,7 @@ void LTFAT_NAME(heapintreal)(const LTFAT_REAL* s,
     // Init plan
     hit = LTFAT_NAME(heapinttask_init)( M2, N, (ltfat_int)( M2 * log((double)M2)),
                                         s,
-                                        1);
+                                        1, LTFAT_HEAP_BINARY);
 
     for (ltfat_int w = 0; w < W; ++w)
     {
@@ -505,7 +513,7 @@ void LTFAT_NAME(maskedheapintreal)(const LTFAT_REAL* s,
 
     // Initialize plan
     hit = LTFAT_NAME(heapinttask_init)( M2, N, (ltfat_int)( M2 * log((double) M2)),
-                                        s, 1);
+                                        s, 1, LTFAT_HEAP_BINARY);
 
     // Set all phases outside of the mask to zeros, do not modify the rest
     for (ltfat_int ii = 0; ii < M2 * N * W; ii++)
@@ -529,6 +537,321 @@ void LTFAT_NAME(maskedheapintreal)(const LTFAT_REAL* s,
     LTFAT_NAME(heapinttask_done)(hit);
 }
 
+/*
+ *  Tiled versions
+ *
+ *  The time axis is split into tiles of tileN columns. Each tile is extended
+ *  by overlapN columns on both sides and integrated independently, so the
+ *  heap and the mask of a worker never hold more than one extended tile.
+ *  The phase of neighboring tiles is then aligned by a constant offset,
+ *  which is the magnitude-weighted circular mean of the phase difference
+ *  over the 2*overlapN columns shared by the two tiles.
+ * */
+struct LTFAT_NAME(heapint_tiled_state)
+{
+    const LTFAT_REAL* s;
+    const LTFAT_REAL* tgradw;
+    const LTFAT_REAL* fgradw;
+    ltfat_int height;
+    ltfat_int N;
+    ltfat_int tileN;
+    ltfat_int overlapN;
+    ltfat_int ntiles;
+    int do_real;
+    LTFAT_REAL* thr;                  //!< Threshold of each channel
+    LTFAT_NAME(heapinttask)** hit;    //!< Per worker
+    LTFAT_REAL** scratch;             //!< Per worker, phase of the tile
+    LTFAT_REAL* bandprev;             //!< Right band of tile k-1 per boundary
+    LTFAT_REAL* bandnext;             //!< Left band of tile k per boundary
+    LTFAT_REAL* offset;               //!< Phase offset of every tile
+    LTFAT_REAL* phase;
+};
+
+/* Like trapezheap, but the integration does not wrap around in time since
+ * the time borders of a tile are not periodic. */
+static void
+LTFAT_NAME(trapezheaptile)(const LTFAT_NAME(heapinttask) *hit,
+                           const LTFAT_REAL* tgradw, const LTFAT_REAL* fgradw,
+                           ltfat_int w, LTFAT_REAL* phase)
+{
+    ltfat_int M = hit->height;
+    ltfat_int N = hit->N;
+    LTFAT_NAME(heap)* h = hit->heap;
+    int* donemask = hit->donemask;
+    ltfat_int w_E, w_W, w_N, w_S, col = w / M;
+    LTFAT_REAL oneover2 = (LTFAT_REAL) (1.0 / 2.0);
+
+    w_N = NORTHFROMW(w, M, N);
+
+    if (!donemask[w_N])
+    {
+        phase[w_N] = phase[w] + (fgradw[w] + fgradw[w_N]) * oneover2;
+        donemask[w_N] = LTFAT_MASK_WENTNORTH;
+        LTFAT_NAME(heap_insert)(h, w_N);
+    }
+
+    w_S = SOUTHFROMW(w, M, N);
+
+    if (!donemask[w_S])
+    {
+        phase[w_S] = phase[w] - (fgradw[w] + fgradw[w_S]) * oneover2;
+        donemask[w_S] = LTFAT_MASK_WENTSOUTH;
+        LTFAT_NAME(heap_insert)(h, w_S);
+    }
+
+    w_E = EASTFROMW(w, M, N);
+
+    if (col != N - 1 && !donemask[w_E])
+    {
+        phase[w_E] = phase[w] + (tgradw[w] + tgradw[w_E]) * oneover2;
+        donemask[w_E] = LTFAT_MASK_WENTEAST;
+        LTFAT_NAME(heap_insert)(h, w_E);
+    }
+
+    w_W = WESTFROMW(w, M, N);
+
+    if (col != 0 && !donemask[w_W])
+    {
+        phase[w_W] = phase[w] - (tgradw[w] + tgradw[w_W]) * oneover2;
+        donemask[w_W] = LTFAT_MASK_WENTWEST;
+        LTFAT_NAME(heap_insert)(h, w_W);
+    }
+}
+
+/* Number of columns shared by tile k-1 and tile k */
+static ltfat_int
+LTFAT_NAME(heapint_tiled_bandcols)(const struct LTFAT_NAME(heapint_tiled_state)* st,
+                                   ltfat_int k)
+{
+    ltfat_int n0 = k * st->tileN;
+    return ltfat_imin(n0 + st->overlapN, st->N) - (n0 - st->overlapN);
+}
+
+static void
+LTFAT_NAME(heapint_tiled_task)(void* userdata, ltfat_int taskid,
+                               ltfat_int workerid)
+{
+    struct LTFAT_NAME(heapint_tiled_state)* st = userdata;
+    LTFAT_NAME(heapinttask)* hit = st->hit[workerid];
+    LTFAT_REAL* scratch = st->scratch[workerid];
+    ltfat_int height = st->height, ov = st->overlapN;
+    ltfat_int w = taskid / st->ntiles, k = taskid % st->ntiles;
+    ltfat_int n0 = k * st->tileN, n1 = ltfat_imin(n0 + st->tileN, st->N);
+    ltfat_int e0 = ltfat_imax(n0 - ov, 0), e1 = ltfat_imin(n1 + ov, st->N);
+    ltfat_int bandL = height * 2 * ov;
+    ltfat_int chanoff = w * height * st->N + e0 * height;
+    const LTFAT_REAL* s = st->s + chanoff;
+
+    hit->N = e1 - e0;
+    LTFAT_NAME(heap_reset)(hit->heap, s);
+    memset(scratch, 0, height * hit->N * sizeof * scratch);
+
+    for (ltfat_int ii = 0; ii < height * hit->N; ii++)
+        hit->donemask[ii] = s[ii] <= st->thr[w] ?
+                            LTFAT_MASK_BELOWTOL : LTFAT_MASK_UNKNOWN;
+
+    LTFAT_NAME(heapint_execute)(hit, s, st->tgradw + chanoff,
+                                st->fgradw + chanoff, scratch);
+
+    memcpy(st->phase + w * height * st->N + n0 * height,
+           scratch + (n0 - e0) * height,  height * (n1 - n0) * sizeof * scratch);
+
+    if (k > 0)
+        memcpy(st->bandnext + (w * st->ntiles + k) * bandL, scratch,
+               height * LTFAT_NAME(heapint_tiled_bandcols)(st, k) * sizeof * scratch);
+
+    if (k < st->ntiles - 1)
+        memcpy(st->bandprev + (w * st->ntiles + k + 1) * bandL,
+               scratch + (n1 - ov - e0) * height,
+               height * LTFAT_NAME(heapint_tiled_bandcols)(st, k + 1) * sizeof * scratch);
+}
+
+static void
+LTFAT_NAME(heapint_tiled_offset_task)(void* userdata, ltfat_int taskid,
+                                      ltfat_int UNUSED(workerid))
+{
+    struct LTFAT_NAME(heapint_tiled_state)* st = userdata;
+    ltfat_int height = st->height;
+    ltfat_int w = taskid / st->ntiles, k = taskid % st->ntiles;
+    ltfat_int n0 = k * st->tileN, n1 = ltfat_imin(n0 + st->tileN, st->N);
+    ltfat_int chanoff = w * height * st->N;
+    LTFAT_REAL offset = st->offset[taskid];
+
+    if (offset == 0) return;
+
+    // Coefficients below the threshold keep zero phase
+    for (ltfat_int ii = n0 * height; ii < n1 * height; ii++)
+        if (st->s[chanoff + ii] > st->thr[w])
+            st->phase[chanoff + ii] += offset;
+}
+
+static int
+LTFAT_NAME(heapint_tiled_common)(const LTFAT_REAL* s,
+                                 const LTFAT_REAL* tgradw,
+                                 const LTFAT_REAL* fgradw,
+                                 ltfat_int height, ltfat_int N, ltfat_int W,
+                                 LTFAT_REAL tol, ltfat_int tileN,
+                                 ltfat_int overlapN, ltfat_int nthreads,
+                                 int do_real, LTFAT_REAL* phase)
+{
+    struct LTFAT_NAME(heapint_tiled_state) st;
+    ltfat_threadpool* pool = NULL;
+    ltfat_int ntasks, bandL;
+    int status = LTFATERR_SUCCESS;
+    memset(&st, 0, sizeof st);
+
+    CHECKNULL(s); CHECKNULL(tgradw); CHECKNULL(fgradw); CHECKNULL(phase);
+    CHECK(LTFATERR_NOTPOSARG, N > 0, "N must be positive (passed %td)", N);
+    CHECK(LTFATERR_NOTPOSARG, W > 0, "W must be positive (passed %td)", W);
+    CHECK(LTFATERR_NOTPOSARG, tileN > 0,
+          "tileN must be positive (passed %td)", tileN);
+    CHECK(LTFATERR_NOTPOSARG, overlapN > 0,
+          "overlapN must be positive (passed %td)", overlapN);
+    CHECK(LTFATERR_BADARG, overlapN <= tileN,
+          "overlapN must not exceed tileN (passed %td > %td)", overlapN, tileN);
+    CHECK(LTFATERR_BADARG, nthreads >= 0,
+          "nthreads must be nonnegative (passed %td)", nthreads);
+
+    if (nthreads == 0) nthreads = ltfat_threadpool_get_nprocs();
+    if (nthreads > 1)
+    {
+        CHECKSTATUS( ltfat_threadpool_init(nthreads, &pool));
+        nthreads = ltfat_threadpool_get_nthreads(pool);
+    }
+    else
+        nthreads = 1;
+
+    st.s = s; st.tgradw = tgradw; st.fgradw = fgradw; st.phase = phase;
+    st.height = height; st.N = N; st.do_real = do_real;
+    st.tileN = ltfat_imin(tileN, N); st.overlapN = overlapN;
+    st.ntiles = ltfat_idivceil(N, st.tileN);
+    ntasks = W * st.ntiles;
+    bandL = height * 2 * overlapN;
+
+    CHECKMEM( st.thr = LTFAT_NAME_REAL(malloc)(W));
+    CHECKMEM( st.offset = LTFAT_NAME_REAL(calloc)(ntasks));
+    CHECKMEM( st.bandprev = LTFAT_NAME_REAL(malloc)(ntasks * bandL));
+    CHECKMEM( st.bandnext = LTFAT_NAME_REAL(malloc)(ntasks * bandL));
+    CHECKMEM( st.hit = LTFAT_NEWARRAY(LTFAT_NAME(heapinttask)*, nthreads));
+    CHECKMEM( st.scratch = LTFAT_NEWARRAY(LTFAT_REAL*, nthreads));
+
+    for (ltfat_int t = 0; t < nthreads; t++)
+    {
+        ltfat_int extN = ltfat_imin(st.tileN + 2 * overlapN, N);
+        CHECKMEM( st.scratch[t] = LTFAT_NAME_REAL(malloc)(height * extN));
+        CHECKMEM( st.hit[t] = LTFAT_NAME(heapinttask_init)(
+                                  height, extN, (ltfat_int)( height * log((double)height)),
+                                  NULL, do_real, LTFAT_HEAP_BINARY));
+        if (!do_real)
+            st.hit[t]->intfun = LTFAT_NAME(trapezheaptile);
+    }
+
+    // The threshold is relative to the maximum of the whole channel
+    for (ltfat_int w = 0; w < W; w++)
+    {
+        ltfat_int dummyImax;
+        LTFAT_REAL maxs;
+        LTFAT_NAME_REAL(findmaxinarray)(s + w * height * N, height * N, &maxs,
+                                        &dummyImax);
+        st.thr[w] = tol * maxs;
+    }
+
+    if (pool)
+        ltfat_threadpool_execute(pool, ntasks, LTFAT_NAME(heapint_tiled_task), &st);
+    else
+        for (ltfat_int t = 0; t < ntasks; t++)
+            LTFAT_NAME(heapint_tiled_task)(&st, t, 0);
+
+    // Offsets accumulate from the first tile of each channel
+    for (ltfat_int w = 0; w < W; w++)
+    {
+        for (ltfat_int k = 1; k < st.ntiles; k++)
+        {
+            ltfat_int tid = w * st.ntiles + k;
+            const LTFAT_REAL* prev = st.bandprev + tid * bandL;
+            const LTFAT_REAL* next = st.bandnext + tid * bandL;
+            const LTFAT_REAL* sband =
+                s + w * height * N + (k * st.tileN - overlapN) * height;
+            double re = 0.0, im = 0.0;
+
+            for (ltfat_int ii = 0;
+                 ii < height * LTFAT_NAME(heapint_tiled_bandcols)(&st, k); ii++)
+            {
+                if (sband[ii] > st.thr[w])
+                {
+                    re += sband[ii] * cos(prev[ii] - next[ii]);
+                    im += sband[ii] * sin(prev[ii] - next[ii]);
+                }
+            }
+
+            st.offset[tid] = st.offset[tid - 1] + (LTFAT_REAL) atan2(im, re);
+        }
+    }
+
+    if (pool)
+        ltfat_threadpool_execute(pool, ntasks,
+                                 LTFAT_NAME(heapint_tiled_offset_task), &st);
+    else
+        for (ltfat_int t = 0; t < ntasks; t++)
+            LTFAT_NAME(heapint_tiled_offset_task)(&st, t, 0);
+
+error:
+    if (st.hit)
+        for (ltfat_int t = 0; t < nthreads; t++)
+            if (st.hit[t]) LTFAT_NAME(heapinttask_done)(st.hit[t]);
+
+    if (st.scratch)
+        for (ltfat_int t = 0; t < nthreads; t++)
+            ltfat_safefree(st.scratch[t]);
+
+    LTFAT_SAFEFREEALL(st.thr, st.offset, st.bandprev, st.bandnext,
+                      st.hit, st.scratch);
+    if (pool) ltfat_threadpool_done(&pool);
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(heapint_tiled)(const LTFAT_REAL* s,
+                          const LTFAT_REAL* tgradw,
+                          const LTFAT_REAL* fgradw,
+                          ltfat_int a, ltfat_int M,
+                          ltfat_int L, ltfat_int W,
+                          LTFAT_REAL tol, ltfat_int tileN,
+                          ltfat_int overlapN, ltfat_int nthreads,
+                          LTFAT_REAL* phase)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECK(LTFATERR_NOTPOSARG, a > 0, "a must be positive (passed %td)", a);
+    CHECK(LTFATERR_NOTPOSARG, M > 0, "M must be positive (passed %td)", M);
+
+    return LTFAT_NAME(heapint_tiled_common)(s, tgradw, fgradw, M, L / a, W,
+                                            tol, tileN, overlapN, nthreads,
+                                            0, phase);
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(heapintreal_tiled)(const LTFAT_REAL* s,
+                              const LTFAT_REAL* tgradw,
+                              const LTFAT_REAL* fgradw,
+                              ltfat_int a, ltfat_int M,
+                              ltfat_int L, ltfat_int W,
+                              LTFAT_REAL tol, ltfat_int tileN,
+                              ltfat_int overlapN, ltfat_int nthreads,
+                              LTFAT_REAL* phase)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECK(LTFATERR_NOTPOSARG, a > 0, "a must be positive (passed %td)", a);
+    CHECK(LTFATERR_NOTPOSARG, M > 0, "M must be positive (passed %td)", M);
+
+    return LTFAT_NAME(heapint_tiled_common)(s, tgradw, fgradw, M / 2 + 1, L / a,
+                                            W, tol, tileN, overlapN, nthreads,
+                                            1, phase);
+error:
+    return status;
+}
+
 /*
  *  The _relgrad versions are just wrappers.
  *  They convert the relative phase gradients in samples to
@@ -3,6 +3,79 @@
 #include "ltfat/types.h"
 #include "ltfat/macros.h"
 #include "ltfat/thirdparty/kiss_fft.h"
+#include "fftcache_private.h"
+
+/* The kiss cfg structures (twiddle factors and factorization) depend on
+ * the length and direction only. Released cfgs are kept in the plan cache
+ * (see fftcache.c) and reused by the next *_init. The per-plan scratch
+ * buffers are never shared. */
+static void
+LTFAT_NAME(kiss_makekey)(ltfat_int L, int kind, ltfat_fftcache_key* key)
+{
+    memset(key, 0, sizeof * key);
+    key->L = L; key->kind = kind;
+    key->precision = sizeof(LTFAT_REAL);
+}
+
+static void
+LTFAT_NAME(kiss_destroy)(void* p)
+{
+    ltfat_free(p);
+}
+
+static LTFAT_KISS(fft_plan)*
+LTFAT_NAME(kiss_fft_take)(ltfat_int L, int inverse)
+{
+    ltfat_fftcache_key key;
+    void* cached = NULL;
+    LTFAT_NAME(kiss_makekey)(L, inverse ? LTFAT_FFTCACHE_IFFT : LTFAT_FFTCACHE_FFT,
+                             &key);
+    if (ltfat_fftcache_take(&key, &cached))
+        return cached;
+    return LTFAT_KISS(fft_alloc)(L, inverse, NULL, NULL);
+}
+
+static void
+LTFAT_NAME(kiss_fft_give)(ltfat_int L, int inverse, LTFAT_KISS(fft_plan)* p)
+{
+    ltfat_fftcache_key key;
+    LTFAT_NAME(kiss_makekey)(L, inverse ? LTFAT_FFTCACHE_IFFT : LTFAT_FFTCACHE_FFT,
+                             &key);
+    ltfat_fftcache_give(&key, p, LTFAT_NAME(kiss_destroy));
+}
+
+static LTFAT_KISS(fftr_plan)*
+LTFAT_NAME(kiss_fftr_take)(ltfat_int L, int inverse)
+{
+    ltfat_fftcache_key key;
+    void* cached = NULL;
+    LTFAT_NAME(kiss_makekey)(L, inverse ? LTFAT_FFTCACHE_IFFTREAL :
+                             LTFAT_FFTCACHE_FFTREAL, &key);
+    if (ltfat_fftcache_take(&key, &cached))
+        return cached;
+    return LTFAT_KISS(fftr_alloc)(L, inverse, NULL, NULL);
+}
+
+static void
+LTFAT_NAME(kiss_fftr_give)(ltfat_int L, int inverse, LTFAT_KISS(fftr_plan)* p)
+{
+    ltfat_fftcache_key key;
+    LTFAT_NAME(kiss_makekey)(L, inverse ? LTFAT_FFTCACHE_IFFTREAL :
+                             LTFAT_FFTCACHE_FFTREAL, &key);
+    ltfat_fftcache_give(&key, p, LTFAT_NAME(kiss_destroy));
+}
+
+LTFAT_API int
+LTFAT_NAME(fft_wisdom_import)(const char* UNUSED(filename))
+{
+    return LTFATERR_NOTSUPPORTED;
+}
+
+LTFAT_API int
+LTFAT_NAME(fft_wisdom_export)(const char* UNUSED(filename))
+{
+    return LTFATERR_NOTSUPPORTED;
+}
 
 /****** FFT ******/
 struct LTFAT_NAME(fft_plan)
@@ -13,6 +86,7 @@ struct LTFAT_NAME(fft_plan)
     LTFAT_COMPLEX* out;
     LTFAT_COMPLEX* tmp;
     LTFAT_KISS(fft_plan)* kiss_plan;
+    unsigned inverse;
 };
 
 LTFAT_API int
@@ -48,15 +122,15 @@ LTFAT_NAME(fft_init_common)(ltfat_int L, ltfat_int W,
     if (L != nextfastL)
     {
         DEBUG("Warning: L=%td is a \"slow\" FFT lengh. "
-              "Next fast FFT lenght is L=%td. See ltfat_nextfastfft. "
-              "Moreover, some dynamic memory allocation will occur "
-              "during execution.", L, nextfastL);
+              "Next fast FFT lenght is L=%td. See ltfat_nextfastfft.",
+              L, nextfastL);
     }
 
     CHECKMEM( fftwp = LTFAT_NEW(LTFAT_NAME(fft_plan)) );
     fftwp->L = L; fftwp->W = W; fftwp->in = in; fftwp->out = out;
+    fftwp->inverse = inverse;
 
-    fftwp->kiss_plan = LTFAT_KISS(fft_alloc)(L, inverse, NULL, NULL);
+    fftwp->kiss_plan = LTFAT_NAME(kiss_fft_take)(L, inverse);
     CHECKINIT(fftwp->kiss_plan, "FFTW plan creation failed.");
 
     if (in == out)
@@ -125,7 +199,8 @@ LTFAT_NAME(fft_done)(LTFAT_NAME(fft_plan)** p)
     CHECKNULL(p); CHECKNULL(*p);
     pp = *p;
     if (pp->tmp) ltfat_free(pp->tmp);
-    if (pp->kiss_plan) ltfat_free(pp->kiss_plan);
+    if (pp->kiss_plan)
+        LTFAT_NAME(kiss_fft_give)(pp->L, pp->inverse, pp->kiss_plan);
     ltfat_free(pp);
     pp = NULL;
 error:
@@ -191,6 +266,7 @@ struct LTFAT_NAME(fftreal_plan)
     LTFAT_COMPLEX* tmp;
     LTFAT_KISS(fft_plan)* kiss_plan_cpx;
     LTFAT_KISS(fftr_plan)* kiss_plan;
+    unsigned inverse;
 };
 
 LTFAT_API int
@@ -226,15 +302,15 @@ LTFAT_NAME(fftreal_init_common)(ltfat_int L, ltfat_int W,
 
     CHECKMEM( fftwp = LTFAT_NEW(LTFAT_NAME(fftreal_plan)) );
     fftwp->L = L; fftwp->W = W; fftwp->in = in; fftwp->out = out;
+    fftwp->inverse = inverse;
 
     nextfastL = ltfat_nextfastfft(L);
 
     if (L != nextfastL)
     {
         DEBUG("Warning: L=%td is a \"slow\" FFT lengh. "
-              "Next fast FFT lenght is L=%td. See ltfat_nextfastfft. "
-              "Moreover, some dynamic memory allocation will occur "
-              "during execution.", L, nextfastL);
+              "Next fast FFT lenght is L=%td. See ltfat_nextfastfft.",
+              L, nextfastL);
     }
 
     if (L % 2)
@@ -244,13 +320,13 @@ LTFAT_NAME(fftreal_init_common)(ltfat_int L, ltfat_int W,
             DEBUGNOTE("Warning: Odd L is a \"very slow\" FFT lengh. Full FFT will be performed.");
         }
         // Workaround for odd-length transforms
-        fftwp->kiss_plan_cpx = LTFAT_KISS(fft_alloc)(L, inverse, NULL, NULL);
+        fftwp->kiss_plan_cpx = LTFAT_NAME(kiss_fft_take)(L, inverse);
         CHECKINIT(fftwp->kiss_plan_cpx, "FFTW plan creation failed.");
         CHECKMEM( fftwp->tmp = LTFAT_NAME_COMPLEX(malloc)(4 * M2 ) );
     }
     else
     {
-        fftwp->kiss_plan = LTFAT_KISS(fftr_alloc)(L, inverse, NULL, NULL);
+        fftwp->kiss_plan = LTFAT_NAME(kiss_fftr_take)(L, inverse);
         CHECKINIT(fftwp->kiss_plan, "FFTW plan creation failed.");
 
         if (in == out)
@@ -343,8 +419,10 @@ LTFAT_NAME(fftreal_done)(LTFAT_NAME(fftreal_plan)** p)
     CHECKNULL(p); CHECKNULL(*p);
     pp = *p;
     if (pp->tmp) ltfat_free(pp->tmp);
-    if (pp->kiss_plan) ltfat_free(pp->kiss_plan);
-    if (pp->kiss_plan_cpx) ltfat_free(pp->kiss_plan_cpx);
+    if (pp->kiss_plan)
+        LTFAT_NAME(kiss_fftr_give)(pp->L, pp->inverse, pp->kiss_plan);
+    if (pp->kiss_plan_cpx)
+        LTFAT_NAME(kiss_fft_give)(pp->L, pp->inverse, pp->kiss_plan_cpx);
     ltfat_free(pp);
     pp = NULL;
 error:
@@ -349,3 +349,58 @@ LTFAT_NAME(maxtree_findmax)(LTFAT_NAME(maxtree)* p, LTFAT_REAL* max,
         *maxPos = p->treePos[*maxPos];
     return 0;
 }
+
+static void
+LTFAT_NAME(maxtree_findmaxn_rec)(
+    LTFAT_NAME(maxtree)* p, ltfat_int d, ltfat_int idx, ltfat_int n,
+    LTFAT_REAL max[], ltfat_int maxPos[], ltfat_int* found)
+{
+    if (idx >= (d == p->depth ? p->L : p->levelL[d])) return;
+
+    LTFAT_REAL val = p->treePtrs[d][idx];
+    if (*found == n && val <= max[n - 1]) return;
+
+    if (d < p->depth)
+    {
+        // Descend to the larger child first to prune more
+        ltfat_int first = 2 * idx, second = 2 * idx + 1;
+        ltfat_int Lnext = d + 1 == p->depth ? p->L : p->levelL[d + 1];
+        if (second < Lnext && p->treePtrs[d + 1][second] > p->treePtrs[d + 1][first])
+        {
+            first = second; second = 2 * idx;
+        }
+        LTFAT_NAME(maxtree_findmaxn_rec)(p, d + 1, first, n, max, maxPos, found);
+        LTFAT_NAME(maxtree_findmaxn_rec)(p, d + 1, second, n, max, maxPos, found);
+        return;
+    }
+
+    ltfat_int ii = *found < n ? (*found)++ : n - 1;
+    for (; ii > 0 && max[ii - 1] < val; ii--)
+    {
+        max[ii] = max[ii - 1];
+        maxPos[ii] = maxPos[ii - 1];
+    }
+    max[ii] = val;
+    maxPos[ii] = idx;
+}
+
+LTFAT_API int
+LTFAT_NAME(maxtree_findmaxn)(LTFAT_NAME(maxtree)* p, ltfat_int n,
+                             LTFAT_REAL max[], ltfat_int maxPos[],
+                             ltfat_int* found)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(max); CHECKNULL(maxPos); CHECKNULL(found);
+    CHECK(LTFATERR_NOTPOSARG, n > 0, "n must be positive (passed %td)", n);
+    CHECK(LTFATERR_NOTSUPPORTED, !p->is_complexinput,
+          "Complex input is not supported");
+
+    LTFAT_NAME(maxtree_updatedirty)(p);
+
+    *found = 0;
+    for (ltfat_int l = 0; l < p->levelL[0]; l++)
+        LTFAT_NAME(maxtree_findmaxn_rec)(p, 0, l, n, max, maxPos, found);
+
+error:
+    return status;
+}
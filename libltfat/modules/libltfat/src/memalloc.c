@@ -1,19 +1,43 @@
 #include "ltfat.h"
 #include "ltfat/types.h"
 #include "ltfat/memalloc.h"
+#include "ltfat/macros.h"
+#include "memalloc_private.h"
 
 #ifdef FFTW
 #include "ltfat/thirdparty/fftw3.h"
 #endif
 
 #include <stdlib.h>
-/* #include "ltfat/macros.h" */
 
+/* The arena state is per thread */
+#if defined(LTFAT_NOTHREADS)
+#define LTFAT_THREADLOCAL
+#elif defined(_MSC_VER)
+#define LTFAT_THREADLOCAL __declspec(thread)
+#else
+#define LTFAT_THREADLOCAL __thread
+#endif
+
+#define LTFAT_ARENA_ALIGN 64
+#define LTFAT_ARENA_ROUND(n) \
+    ( ((n) + LTFAT_ARENA_ALIGN - 1) & ~((size_t) LTFAT_ARENA_ALIGN - 1) )
+
+struct ltfat_arena
+{
+    unsigned char* base;
+    size_t size;
+    size_t used;
+};
+
+static LTFAT_THREADLOCAL ltfat_arena* ltfat_arena_current = NULL;
+static LTFAT_THREADLOCAL int ltfat_arena_measuring = 0;
+static LTFAT_THREADLOCAL size_t ltfat_arena_measured = 0;
 
 void* (*ltfat_custom_malloc)(size_t) = NULL;
 void (*ltfat_custom_free)(void*) = NULL;
 
-ltfat_memory_handler_t
+LTFAT_API ltfat_memory_handler_t
 ltfat_set_memory_handler (ltfat_memory_handler_t new_handler)
 {
     ltfat_memory_handler_t retVal = { ltfat_custom_malloc, ltfat_custom_free };
@@ -45,11 +69,43 @@ ltfat_aligned_free(void* ptr)
 }
 #endif
 
+static void*
+ltfat_arena_malloc(ltfat_arena* arena, size_t n)
+{
+    size_t nround = LTFAT_ARENA_ROUND(n > 0 ? n : 1);
+
+    if (nround < n || nround > arena->size - arena->used)
+        return NULL;
+
+    void* outp = arena->base + arena->used;
+    arena->used += nround;
+    return outp;
+}
+
+static int
+ltfat_arena_owns(const ltfat_arena* arena, const void* ptr)
+{
+    const unsigned char* p = (const unsigned char*) ptr;
+    return p >= arena->base && p < arena->base + arena->size;
+}
+
+int
+ltfat_arena_isactive(void)
+{
+    return ltfat_arena_current || ltfat_arena_measuring;
+}
+
 LTFAT_API void*
 ltfat_malloc (size_t n)
 {
     void* outp;
 
+    if (ltfat_arena_current)
+        return ltfat_arena_malloc(ltfat_arena_current, n);
+
+    if (ltfat_arena_measuring)
+        ltfat_arena_measured += LTFAT_ARENA_ROUND(n > 0 ? n : 1);
+
     if (ltfat_custom_malloc)
         outp = (*ltfat_custom_malloc)(n);
     else
@@ -113,6 +169,10 @@ ltfat_calloc (size_t nmemb, size_t size)
 LTFAT_API void
 ltfat_free(const void* ptr)
 {
+    // Arena memory is only released by ltfat_arena_reset
+    if (ltfat_arena_current && ltfat_arena_owns(ltfat_arena_current, ptr))
+        return;
+
     if (ltfat_custom_free)
         (*ltfat_custom_free)((void*)ptr);
     else
@@ -129,3 +189,103 @@ ltfat_safefree(const void* ptr)
     if (ptr)
         ltfat_free((void*)ptr);
 }
+
+LTFAT_API int
+ltfat_arena_measure_begin(void)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECK(LTFATERR_FAILED, !ltfat_arena_isactive(),
+          "An arena is already active in this thread");
+
+    ltfat_arena_measuring = 1;
+    ltfat_arena_measured = 0;
+error:
+    return status;
+}
+
+LTFAT_API int
+ltfat_arena_measure_end(size_t* size)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(size);
+    CHECK(LTFATERR_FAILED, ltfat_arena_measuring,
+          "ltfat_arena_measure_begin was not called");
+
+    // Header and the worst case alignment of the memory block
+    *size = ltfat_arena_measured + LTFAT_ARENA_ROUND(sizeof(ltfat_arena))
+            + LTFAT_ARENA_ALIGN - 1;
+    ltfat_arena_measuring = 0;
+    ltfat_arena_measured = 0;
+error:
+    return status;
+}
+
+LTFAT_API int
+ltfat_arena_init(void* mem, size_t size, ltfat_arena** arena)
+{
+    ltfat_arena* a = NULL;
+    unsigned char* base = NULL;
+    size_t skip;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(mem); CHECKNULL(arena);
+
+    base = (unsigned char*) LTFAT_ARENA_ROUND((size_t) mem);
+    skip = (size_t)(base - (unsigned char*) mem) +
+           LTFAT_ARENA_ROUND(sizeof(ltfat_arena));
+    CHECK(LTFATERR_BADSIZE, size >= skip,
+          "size is too small to hold the arena header (passed %zu, needs %zu)",
+          size, skip);
+
+    a = (ltfat_arena*) base;
+    a->base = base + LTFAT_ARENA_ROUND(sizeof(ltfat_arena));
+    a->size = (size - skip) & ~((size_t) LTFAT_ARENA_ALIGN - 1);
+    a->used = 0;
+    *arena = a;
+error:
+    return status;
+}
+
+LTFAT_API int
+ltfat_arena_begin(ltfat_arena* arena)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(arena);
+    CHECK(LTFATERR_FAILED, !ltfat_arena_isactive(),
+          "An arena is already active in this thread");
+
+    ltfat_arena_current = arena;
+error:
+    return status;
+}
+
+LTFAT_API int
+ltfat_arena_end(void)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECK(LTFATERR_FAILED, ltfat_arena_current,
+          "No arena is active in this thread");
+
+    ltfat_arena_current = NULL;
+error:
+    return status;
+}
+
+LTFAT_API int
+ltfat_arena_reset(ltfat_arena* arena)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(arena);
+    arena->used = 0;
+error:
+    return status;
+}
+
+LTFAT_API int
+ltfat_arena_get_used(const ltfat_arena* arena, size_t* used)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(arena); CHECKNULL(used);
+    *used = arena->used;
+error:
+    return status;
+}
@@ -0,0 +1,10 @@
+#ifndef _ltfat_memalloc_private_h
+#define _ltfat_memalloc_private_h
+
+/* Returns nonzero if the calling thread allocates from an arena or
+ * measures the arena size. Memory obtained in this state must not end up
+ * in process-wide structures (e.g. the FFT plan cache). */
+int
+ltfat_arena_isactive(void);
+
+#endif
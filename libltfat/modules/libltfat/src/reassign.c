@@ -107,28 +107,16 @@ LTFAT_NAME(filterbankreassign)(const LTFAT_TYPE* s[],
         cfreq2[m] = (LTFAT_REAL) ( cfreq[m] - floor(cfreq[m] * oneover2) * 2.0 );
     }
 
-    ltfat_int* tgradIdx = NULL;
-    ltfat_int* fgradIdx = NULL;
-    ltfat_int Nold = 0;
-    for (ltfat_int m = M - 1; m >= 0; m--)
-    {
-        // Ensure the temporary arrays have proper lengths
-        if (N[m] > Nold)
-        {
-            if (tgradIdx)
-            {
-                ltfat_free(tgradIdx);
-            }
-            if (fgradIdx)
-            {
-                ltfat_free(fgradIdx);
-            }
+    // The temporary arrays are allocated once for the longest channel
+    ltfat_int Nmax = 0;
+    for (ltfat_int m = 0; m < M; m++)
+        if (N[m] > Nmax) Nmax = N[m];
 
-            tgradIdx = (ltfat_int*) ltfat_malloc(N[m] * sizeof * tgradIdx);
-            fgradIdx = (ltfat_int*) ltfat_malloc(N[m] * sizeof * fgradIdx);
-            Nold = N[m];
-        }
+    ltfat_int* tgradIdx = (ltfat_int*) ltfat_malloc(Nmax * sizeof * tgradIdx);
+    ltfat_int* fgradIdx = (ltfat_int*) ltfat_malloc(Nmax * sizeof * fgradIdx);
 
+    for (ltfat_int m = M - 1; m >= 0; m--)
+    {
         // We will use this repeatedly
         LTFAT_REAL cfreqm = cfreq2[m];
 
@@ -16,10 +16,10 @@ struct LTFAT_NAME(rtdgtreal_plan)
     LTFAT_REAL* g; //!< Window
     ltfat_int gl; //!< Window length
     ltfat_int M; //!< Number of FFT channels
+    ltfat_int Wmax; //!< Number of channels transformed by one FFT call
     rtdgt_phasetype ptype; //!< Phase convention
-    LTFAT_REAL* fftBuf; //!< Internal buffer
-    LTFAT_COMPLEX* fftBuf_cpx; //!< Internal buffer
-    ltfat_int fftBufLen; //!< Internal buffer length
+    LTFAT_REAL* fftBuf; //!< Internal buffer, M x Wmax
+    LTFAT_COMPLEX* fftBuf_cpx; //!< Internal buffer, M2 x Wmax
     LTFAT_NAME_REAL(fftreal_plan)*  pfft;
     LTFAT_NAME_REAL(ifftreal_plan)* pifft;
 };
@@ -27,6 +27,7 @@ struct LTFAT_NAME(rtdgtreal_plan)
 int
 LTFAT_NAME(rtdgtreal_commoninit)(const LTFAT_REAL* g, ltfat_int gl,
                                  ltfat_int M, const rtdgt_phasetype ptype,
+                                 ltfat_int Wmax,
                                  const ltfat_transformdirection tradir,
                                  LTFAT_NAME(rtdgtreal_plan)** pout)
 {
@@ -34,32 +35,34 @@ LTFAT_NAME(rtdgtreal_commoninit)(const LTFAT_REAL* g, ltfat_int gl,
     LTFAT_NAME(rtdgtreal_plan)* p = NULL;
 
     int status = LTFATERR_FAILED;
+    CHECKNULL(g);
     CHECK(LTFATERR_NOTPOSARG, gl > 0, "gl must be positive");
     CHECK(LTFATERR_NOTPOSARG, M > 0, "M must be positive");
+    CHECK(LTFATERR_NOTPOSARG, Wmax > 0, "Wmax must be positive");
 
     CHECKMEM( p = LTFAT_NEW( LTFAT_NAME(rtdgtreal_plan) ));
 
     M2 = M / 2 + 1;
-    p->fftBufLen = gl > 2 * M2 ? gl : 2 * M2;
 
     CHECKMEM( p->g = LTFAT_NAME_REAL(malloc)(gl));
-    CHECKMEM( p->fftBuf =     LTFAT_NAME_REAL(malloc)(p->fftBufLen));
-    CHECKMEM( p->fftBuf_cpx = LTFAT_NAME_COMPLEX(malloc)(M2));
+    CHECKMEM( p->fftBuf =     LTFAT_NAME_REAL(calloc)(M * Wmax));
+    CHECKMEM( p->fftBuf_cpx = LTFAT_NAME_COMPLEX(calloc)(M2 * Wmax));
     p->gl = gl;
     p->M = M;
+    p->Wmax = Wmax;
     p->ptype = ptype;
 
     LTFAT_NAME_REAL(fftshift)(g, gl, p->g);
 
     if (LTFAT_FORWARD == tradir)
     {
-        LTFAT_NAME_REAL(fftreal_init)(M, 1, p->fftBuf, p->fftBuf_cpx,
+        LTFAT_NAME_REAL(fftreal_init)(M, Wmax, p->fftBuf, p->fftBuf_cpx,
                                       FFTW_MEASURE, &p->pfft);
         CHECKINIT(p->pfft, "FFTW plan creation failed.");
     }
     else if (LTFAT_INVERSE == tradir)
     {
-        LTFAT_NAME_REAL(ifftreal_init)(M, 1, p->fftBuf_cpx, p->fftBuf,
+        LTFAT_NAME_REAL(ifftreal_init)(M, Wmax, p->fftBuf_cpx, p->fftBuf,
                                        FFTW_MEASURE, &p->pifft);
         CHECKINIT(p->pifft, "FFTW plan creation failed.");
     }
@@ -79,7 +82,7 @@ LTFAT_NAME(rtdgtreal_init)(const LTFAT_REAL* g, ltfat_int gl,
                            ltfat_int M, const rtdgt_phasetype ptype,
                            LTFAT_NAME(rtdgtreal_plan)** p)
 {
-    return LTFAT_NAME(rtdgtreal_commoninit)(g, gl, M, ptype, LTFAT_FORWARD, p);
+    return LTFAT_NAME(rtdgtreal_commoninit)(g, gl, M, ptype, 1, LTFAT_FORWARD, p);
 }
 
 LTFAT_API int
@@ -87,7 +90,77 @@ LTFAT_NAME(rtidgtreal_init)(const LTFAT_REAL* g, ltfat_int gl,
                             ltfat_int M, const rtdgt_phasetype ptype,
                             LTFAT_NAME(rtdgtreal_plan)** p)
 {
-    return LTFAT_NAME(rtdgtreal_commoninit)(g, gl, M, ptype, LTFAT_INVERSE, p);
+    return LTFAT_NAME(rtdgtreal_commoninit)(g, gl, M, ptype, 1, LTFAT_INVERSE, p);
+}
+
+LTFAT_API int
+LTFAT_NAME(rtdgtreal_init_batch)(const LTFAT_REAL* g, ltfat_int gl,
+                                 ltfat_int M, const rtdgt_phasetype ptype,
+                                 ltfat_int Wmax, LTFAT_NAME(rtdgtreal_plan)** p)
+{
+    return LTFAT_NAME(rtdgtreal_commoninit)(g, gl, M, ptype, Wmax,
+                                            LTFAT_FORWARD, p);
+}
+
+LTFAT_API int
+LTFAT_NAME(rtidgtreal_init_batch)(const LTFAT_REAL* g, ltfat_int gl,
+                                  ltfat_int M, const rtdgt_phasetype ptype,
+                                  ltfat_int Wmax, LTFAT_NAME(rtdgtreal_plan)** p)
+{
+    return LTFAT_NAME(rtdgtreal_commoninit)(g, gl, M, ptype, Wmax,
+                                            LTFAT_INVERSE, p);
+}
+
+/* Position of the first sample of a frame in the FFT buffer, the zero
+ * phase convention centers the frame at the sample 0 */
+static ltfat_int
+LTFAT_NAME(rtdgtreal_start)(const LTFAT_NAME(rtdgtreal_plan)* p)
+{
+    ltfat_int shift = p->ptype == LTFAT_RTDGTPHASE_ZERO ? p->gl / 2 : 0;
+    return ltfat_positiverem(-shift, p->M);
+}
+
+/* Windows one frame of length gl, folds it to length M and circularly
+ * shifts it according to the phase convention, all in one pass.
+ * The samples are added in the same order as by fold_array. */
+static void
+LTFAT_NAME(rtdgtreal_window)(const LTFAT_NAME(rtdgtreal_plan)* p,
+                             const LTFAT_REAL* f, LTFAT_REAL* fftCol)
+{
+    ltfat_int M = p->M, gl = p->gl;
+    ltfat_int k = LTFAT_NAME(rtdgtreal_start)(p);
+    ltfat_int ii = 0;
+
+    if (M > gl)
+        memset(fftCol, 0, M * sizeof * fftCol);
+
+    for (; ii < ltfat_imin(gl, M); ii++)
+    {
+        fftCol[k] = f[ii] * p->g[ii];
+        if (++k == M) k = 0;
+    }
+
+    for (; ii < gl; ii++)
+    {
+        fftCol[k] += f[ii] * p->g[ii];
+        if (++k == M) k = 0;
+    }
+}
+
+/* Inverse of rtdgtreal_window: circular shift, periodization to length
+ * gl and windowing of one column of the FFT buffer */
+static void
+LTFAT_NAME(rtidgtreal_window)(const LTFAT_NAME(rtidgtreal_plan)* p,
+                              const LTFAT_REAL* fftCol, LTFAT_REAL* f)
+{
+    ltfat_int M = p->M, gl = p->gl;
+    ltfat_int k = LTFAT_NAME(rtdgtreal_start)(p);
+
+    for (ltfat_int ii = 0; ii < gl; ii++)
+    {
+        f[ii] = fftCol[k] * p->g[ii];
+        if (++k == M) k = 0;
+    }
 }
 
 LTFAT_API int
@@ -96,8 +169,6 @@ LTFAT_NAME(rtdgtreal_execute)(const LTFAT_NAME(rtdgtreal_plan)* p,
                               LTFAT_COMPLEX* c)
 {
     ltfat_int M, M2, gl;
-    LTFAT_REAL* fftBuf;
-    LTFAT_COMPLEX* fftBuf_cpx;
     int status = LTFATERR_FAILED;
     CHECKNULL(p); CHECKNULL(f); CHECKNULL(c);
     CHECK(LTFATERR_NOTPOSARG, W > 0, "W must be positive");
@@ -105,30 +176,23 @@ LTFAT_NAME(rtdgtreal_execute)(const LTFAT_NAME(rtdgtreal_plan)* p,
     M = p->M;
     M2 = M / 2 + 1;
     gl = p->gl;
-    fftBuf = p->fftBuf;
-    fftBuf_cpx = p->fftBuf_cpx;
 
-    for (ltfat_int w = 0; w < W; w++)
+    // Wmax channels at a time are windowed directly to the columns of
+    // the FFT buffer and transformed by a single FFT call
+    for (ltfat_int wstart = 0; wstart < W; wstart += p->Wmax)
     {
-        const LTFAT_REAL* fchan = f + w * gl;
-        LTFAT_COMPLEX* cchan = c + w * M2;
+        ltfat_int Wloc = ltfat_imin(p->Wmax, W - wstart);
 
-        if (p->g)
-            for (ltfat_int ii = 0; ii < gl; ii++)
-                fftBuf[ii] = fchan[ii] * p->g[ii];
-
-        if (M > gl)
-            memset(fftBuf + gl, 0, (M - gl) * sizeof * fftBuf);
-
-        if (gl > M)
-            LTFAT_NAME_REAL(fold_array)(fftBuf, gl, M, 0, fftBuf);
-
-        if (p->ptype == LTFAT_RTDGTPHASE_ZERO)
-            LTFAT_NAME_REAL(circshift)(fftBuf, M, -(gl / 2), fftBuf );
+        for (ltfat_int w = 0; w < Wloc; w++)
+            LTFAT_NAME(rtdgtreal_window)(p, f + (wstart + w) * gl,
+                                         p->fftBuf + w * M);
 
         LTFAT_NAME_REAL(fftreal_execute)(p->pfft);
 
-        memcpy(cchan, fftBuf_cpx, M2 * sizeof * c);
+        // The rtdgtreal_processor reads the coefficients directly from
+        // the plan buffer
+        if (c != p->fftBuf_cpx)
+            memcpy(c + wstart * M2, p->fftBuf_cpx, Wloc * M2 * sizeof * c);
     }
 
     return LTFATERR_SUCCESS;
@@ -150,8 +214,6 @@ LTFAT_NAME(rtidgtreal_execute)(const LTFAT_NAME(rtidgtreal_plan)* p,
                                LTFAT_REAL* f)
 {
     ltfat_int M, M2, gl;
-    LTFAT_REAL* fftBuf;
-    LTFAT_COMPLEX* fftBuf_cpx;
     int status = LTFATERR_FAILED;
     CHECKNULL(p); CHECKNULL(c); CHECKNULL(f);
     CHECK(LTFATERR_NOTPOSARG, W > 0, "W must be positive");
@@ -159,29 +221,21 @@ LTFAT_NAME(rtidgtreal_execute)(const LTFAT_NAME(rtidgtreal_plan)* p,
     M = p->M;
     M2 = M / 2 + 1;
     gl = p->gl;
-    fftBuf = p->fftBuf;
-    fftBuf_cpx = p->fftBuf_cpx;
 
-    for (ltfat_int w = 0; w < W; w++)
+    for (ltfat_int wstart = 0; wstart < W; wstart += p->Wmax)
     {
-        const LTFAT_COMPLEX* cchan = c + w * M2;
-        LTFAT_REAL* fchan = f + w * gl;
+        ltfat_int Wloc = ltfat_imin(p->Wmax, W - wstart);
 
-        memcpy(fftBuf_cpx, cchan, M2 * sizeof * cchan);
+        // The rtdgtreal_processor writes the coefficients directly to
+        // the plan buffer
+        if (c != p->fftBuf_cpx)
+            memcpy(p->fftBuf_cpx, c + wstart * M2, Wloc * M2 * sizeof * c);
 
         LTFAT_NAME_REAL(ifftreal_execute)(p->pifft);
 
-        if (p->ptype == LTFAT_RTDGTPHASE_ZERO)
-            LTFAT_NAME_REAL(circshift)(fftBuf, M, gl / 2, fftBuf );
-
-        if (gl > M)
-            LTFAT_NAME_REAL(periodize_array)(fftBuf, M , gl, fftBuf);
-
-        if (p->g)
-            for (ltfat_int ii = 0; ii < gl; ii++)
-                fftBuf[ii] *= p->g[ii];
-
-        memcpy(fchan, fftBuf, gl * sizeof * fchan);
+        for (ltfat_int w = 0; w < Wloc; w++)
+            LTFAT_NAME(rtidgtreal_window)(p, p->fftBuf + w * M,
+                                          f + (wstart + w) * gl);
     }
 
     return LTFATERR_SUCCESS;
@@ -225,6 +279,31 @@ LTFAT_NAME(rtidgtreal_done)(LTFAT_NAME(rtidgtreal_plan)** p)
     return LTFAT_NAME(rtdgtreal_done)(p);
 }
 
+/* Replaces the plan with an equal plan for Wmax channels */
+static int
+LTFAT_NAME(rtdgtreal_rebatch)(LTFAT_NAME(rtdgtreal_plan)** p, ltfat_int Wmax)
+{
+    LTFAT_NAME(rtdgtreal_plan)* pp = *p;
+    LTFAT_NAME(rtdgtreal_plan)* pnew = NULL;
+    LTFAT_REAL* g = NULL;
+    int status = LTFATERR_FAILED;
+
+    // The plan only keeps the fftshifted window
+    CHECKMEM( g = LTFAT_NAME_REAL(malloc)(pp->gl));
+    LTFAT_NAME_REAL(ifftshift)(pp->g, pp->gl, g);
+
+    CHECKSTATUS( LTFAT_NAME(rtdgtreal_commoninit)(g, pp->gl, pp->M, pp->ptype,
+                 Wmax, pp->pfft ? LTFAT_FORWARD : LTFAT_INVERSE, &pnew));
+
+    LTFAT_NAME(rtdgtreal_done)(p);
+    *p = pnew;
+    ltfat_free(g);
+    return LTFATERR_SUCCESS;
+error:
+    ltfat_safefree(g);
+    return status;
+}
+
 
 /* DGTREAL processor */
 struct LTFAT_NAME(rtdgtreal_processor_state)
@@ -232,6 +311,10 @@ struct LTFAT_NAME(rtdgtreal_processor_state)
     LTFAT_NAME(rtdgtreal_processor_callback)*
     processorCallback; //!< Custom processor callback
     void* userdata; //!< Callback data
+    LTFAT_NAME(rtdgtreal_processor_blockcallback)*
+    blockCallback; //!< Custom block processor callback
+    void* blockUserdata; //!< Block callback data
+    ltfat_int Kmax; //!< Maximum number of frames transformed at once
     LTFAT_NAME(analysis_fifo_state)* fwdfifo;
     LTFAT_NAME(synthesis_fifo_state)* backfifo;
     LTFAT_NAME(rtdgtreal_plan)* fwdplan;
@@ -239,8 +322,8 @@ struct LTFAT_NAME(rtdgtreal_processor_state)
     LTFAT_NAME(realtocomplextransform)* fwdtra;
     LTFAT_NAME(complextorealtransform)* backtra;
     LTFAT_REAL* buf;
-    LTFAT_COMPLEX* fftbufIn;
-    LTFAT_COMPLEX* fftbufOut;
+    LTFAT_COMPLEX* fftbufIn; //!< Owned by fwdplan
+    LTFAT_COMPLEX* fftbufOut; //!< Owned by backplan
     ltfat_int bufLenMax;
     void** garbageBin;
     int garbageBinSize;
@@ -274,13 +357,7 @@ LTFAT_NAME(rtdgtreal_processor_init)(const LTFAT_REAL* ga, ltfat_int gal,
     CHECK(LTFATERR_NOTPOSARG, bufLenMax > 0, "bufLenMax must be positive");
     CHECKMEM( p = LTFAT_NEW(LTFAT_NAME(rtdgtreal_processor_state)) );
 
-    CHECKMEM(
-        p->fftbufIn = LTFAT_NAME_COMPLEX(malloc)( numChans * (M / 2 + 1)));
-
-    CHECKMEM(
-        p->fftbufOut = LTFAT_NAME_COMPLEX(malloc)( numChans * (M / 2 + 1)));
-
-    CHECKMEM( p->buf = LTFAT_NAME_REAL(malloc)( numChans * gal));
+    CHECKMEM( p->buf = LTFAT_NAME_REAL(malloc)( numChans * (glmax + 1)));
     CHECKMEM( p->inTmp =  LTFAT_NEWARRAY(const LTFAT_REAL*, numChans));
     CHECKMEM( p->outTmp = LTFAT_NEWARRAY(LTFAT_REAL*, numChans));
 
@@ -291,15 +368,21 @@ LTFAT_NAME(rtdgtreal_processor_init)(const LTFAT_REAL* ga, ltfat_int gal,
     CHECKSTATUS(
         LTFAT_NAME(synthesis_fifo_init)(bufLenMax + gsl, gsl, a, numChans, &p->backfifo));
 
-    CHECKSTATUS( LTFAT_NAME(rtdgtreal_init)(ga, gal, M, LTFAT_RTDGTPHASE_ZERO,
-                                            &p->fwdplan));
+    // All channels are transformed by a single FFT call
+    CHECKSTATUS( LTFAT_NAME(rtdgtreal_init_batch)(ga, gal, M,
+                 LTFAT_RTDGTPHASE_ZERO, numChans, &p->fwdplan));
 
-    CHECKSTATUS( LTFAT_NAME(rtidgtreal_init)(gs, gsl, M,
-                 LTFAT_RTDGTPHASE_ZERO, &p->backplan));
+    CHECKSTATUS( LTFAT_NAME(rtidgtreal_init_batch)(gs, gsl, M,
+                 LTFAT_RTDGTPHASE_ZERO, numChans, &p->backplan));
+
+    // The callback works directly on the FFT buffers of the plans
+    p->fftbufIn = p->fwdplan->fftBuf_cpx;
+    p->fftbufOut = p->backplan->fftBuf_cpx;
 
     p->fwdtra = &LTFAT_NAME(rtdgtreal_execute_wrapper);
     p->backtra = &LTFAT_NAME(rtidgtreal_execute_wrapper);
     p->bufLenMax = bufLenMax;
+    p->Kmax = 1;
 
     *pout = p;
     return LTFATERR_SUCCESS;
@@ -407,6 +490,107 @@ error:
     return status;
 }
 
+LTFAT_API int
+LTFAT_NAME(rtdgtreal_processor_setblockcallback)(
+    LTFAT_NAME(rtdgtreal_processor_state)* p,
+    LTFAT_NAME(rtdgtreal_processor_blockcallback)* callback,
+    void* userdata, ltfat_int Kmax)
+{
+    LTFAT_REAL* buf = NULL;
+    int status = LTFATERR_FAILED;
+    CHECKNULL(p);
+    CHECK(LTFATERR_NOTPOSARG, Kmax > 0, "Kmax must be positive");
+
+    if (Kmax != p->Kmax)
+    {
+        ltfat_int W = p->fwdfifo->numChans;
+        ltfat_int glmax = ltfat_imax(p->fwdplan->gl, p->backplan->gl);
+
+        CHECKMEM( buf = LTFAT_NAME_REAL(malloc)(Kmax * W * glmax));
+
+        // Plans for more channels than needed are harmless, so a failure
+        // of the second one leaves a usable state
+        CHECKSTATUS( LTFAT_NAME(rtdgtreal_rebatch)(&p->fwdplan, Kmax * W));
+        p->fftbufIn = p->fwdplan->fftBuf_cpx;
+        CHECKSTATUS( LTFAT_NAME(rtdgtreal_rebatch)(&p->backplan, Kmax * W));
+        p->fftbufOut = p->backplan->fftBuf_cpx;
+
+        ltfat_free(p->buf);
+        p->buf = buf;
+        p->Kmax = Kmax;
+    }
+
+    p->blockCallback = callback;
+    p->blockUserdata = userdata;
+
+    return LTFATERR_SUCCESS;
+error:
+    ltfat_safefree(buf);
+    return status;
+}
+
+/* Transforms, processes and inverse transforms all complete frames
+ * waiting in the analysis fifo and adds them to the synthesis fifo */
+static void
+LTFAT_NAME(rtdgtreal_processor_processframes)(
+    LTFAT_NAME(rtdgtreal_processor_state)* p,
+    LTFAT_NAME(rtdgtreal_processor_callback)* processorCallback)
+{
+    ltfat_int W = p->fwdfifo->numChans;
+    ltfat_int M2 = p->fwdplan->M / 2 + 1;
+    ltfat_int frameStride;
+    int block;
+
+    // Frame k of channel w is at buf + (k*frameStride + w*chanStride)*gl.
+    // The block callback gets the frames of each channel one after the
+    // other, the frame callback gets the channels of each frame together.
+    block = p->blockCallback != NULL;
+    frameStride = block ? 1 : W;
+    LTFAT_NAME(analysis_fifo_setreadchanstride)(p->fwdfifo,
+            (block ? p->Kmax : 1) * p->fwdplan->gl);
+
+    // While there is new data in the input fifo, drain up to Kmax frames
+    while ( 1 )
+    {
+        ltfat_int K = 0;
+        while ( K < p->Kmax && LTFAT_NAME(analysis_fifo_read)(p->fwdfifo,
+                p->buf + K * frameStride * p->fwdplan->gl) > 0 )
+            K++;
+
+        if (K == 0) break;
+
+        // Compact a partial block to M2 x K x W
+        if (block && K < p->Kmax)
+            for (ltfat_int w = 1; w < W; w++)
+                memmove(p->buf + w * K * p->fwdplan->gl,
+                        p->buf + w * p->Kmax * p->fwdplan->gl,
+                        K * p->fwdplan->gl * sizeof * p->buf);
+
+        // Transform
+        p->fwdtra((void*)p->fwdplan, p->buf, K * W, p->fftbufIn);
+
+        // Process
+        if (block)
+            p->blockCallback(p->blockUserdata, p->fftbufIn, M2, K, W,
+                             p->fftbufOut);
+        else
+            for (ltfat_int k = 0; k < K; k++)
+                processorCallback(p->userdata, p->fftbufIn + k * W * M2, M2, W,
+                                  p->fftbufOut + k * W * M2);
+
+        // Reconstruct
+        p->backtra((void*)p->backplan, p->fftbufOut, K * W, p->buf);
+
+        // Write (and overlap) to out fifo
+        LTFAT_NAME(synthesis_fifo_setwritechanstride)(p->backfifo,
+                (block ? K : 1) * p->backplan->gl);
+
+        for (ltfat_int k = 0; k < K; k++)
+            LTFAT_NAME(synthesis_fifo_write)(p->backfifo,
+                                             p->buf + k * frameStride * p->backplan->gl);
+    }
+}
+
 LTFAT_API int
 LTFAT_NAME(rtdgtreal_processor_execute_compact)(
     LTFAT_NAME(rtdgtreal_processor_state)* p, const LTFAT_REAL* in,
@@ -522,23 +706,7 @@ LTFAT_NAME(rtdgtreal_processor_execute_gen)(
     samplesWritten =
         LTFAT_NAME(analysis_fifo_write)(p->fwdfifo, in, inLen, chanNo);
 
-    // While there is new data in the input fifo
-    while ( LTFAT_NAME(analysis_fifo_read)(p->fwdfifo, p->buf) > 0 )
-    {
-        // Transform
-        p->fwdtra((void*)p->fwdplan, p->buf, p->fwdfifo->numChans,
-                  p->fftbufIn);
-
-        // Process
-        processorCallback(p->userdata, p->fftbufIn, p->fwdplan->M / 2 + 1,
-                          p->fwdfifo->numChans, p->fftbufOut);
-
-        // Reconstruct
-        p->backtra((void*)p->backplan, p->fftbufOut, p->backfifo->numChans, p->buf);
-
-        // Write (and overlap) to out fifo
-        LTFAT_NAME(synthesis_fifo_write)(p->backfifo, p->buf);
-    }
+    LTFAT_NAME(rtdgtreal_processor_processframes)(p, processorCallback);
 
     // Read sampples for output
     samplesRead =
@@ -553,6 +721,86 @@ error:
     return status;
 }
 
+LTFAT_API int
+LTFAT_NAME(rtdgtreal_processor_execute_interleaved)(
+    LTFAT_NAME(rtdgtreal_processor_state)* p, ltfat_sampleformat fmt,
+    const void* in, ltfat_int len, ltfat_int chanNo, void* out)
+{
+    return LTFAT_NAME(rtdgtreal_processor_execute_gen_interleaved)(
+               p, fmt, in, len, chanNo, len, out);
+}
+
+LTFAT_API int
+LTFAT_NAME(rtdgtreal_processor_execute_gen_interleaved)(
+    LTFAT_NAME(rtdgtreal_processor_state)* p, ltfat_sampleformat fmt,
+    const void* in, ltfat_int inLen, ltfat_int chanNo, ltfat_int outLen,
+    void* out)
+{
+    int status = LTFATERR_FAILED;
+    ltfat_int samplesWritten = 0, samplesRead = 0;
+    size_t frameSize;
+    LTFAT_NAME(rtdgtreal_processor_callback)* processorCallback;
+
+    // Failing these checks prohibits execution altogether
+    CHECKNULL(p); CHECKNULL(in); CHECKNULL(out);
+    CHECK(LTFATERR_BADSIZE, inLen >= 0 && outLen >= 0,
+          "len must be positive or zero (passed %td and %td)", inLen, outLen);
+    CHECK(LTFATERR_BADSIZE, chanNo >= 0,
+          "chanNo must be positive or zero (passed %td)", chanNo);
+
+    // Just dont do anything
+    if (chanNo == 0 || (inLen == 0 && outLen == 0)) return LTFATERR_SUCCESS;
+
+    frameSize = chanNo * LTFAT_NAME(sample_size)(fmt);
+    CHECK(LTFATERR_BADARG, frameSize > 0, "Unknown sample format.");
+
+    status = LTFATERR_SUCCESS;
+
+    // The superfluous channels are skipped in the input and set to zero in
+    // the output by the fifos
+    if ( chanNo > p->fwdfifo->numChans )
+    {
+        DEBUG("Channel overflow (passed %td, max %td)", chanNo, p->fwdfifo->numChans);
+        status = LTFATERR_OVERFLOW;
+    }
+
+    if ( inLen > p->bufLenMax )
+    {
+        DEBUG("Buffer overflow (passed %td, max %td)", inLen, p->bufLenMax);
+        status = LTFATERR_OVERFLOW;
+        inLen = p->bufLenMax;
+    }
+
+    if ( outLen > p->bufLenMax )
+    {
+        DEBUG("Buffer overflow (passed %td, max %td)", outLen, p->bufLenMax);
+        status = LTFATERR_OVERFLOW;
+        memset((char*) out + p->bufLenMax * frameSize, 0,
+               (outLen - p->bufLenMax) * frameSize);
+        outLen = p->bufLenMax;
+    }
+
+    processorCallback = p->processorCallback;
+    if (!processorCallback)
+        processorCallback = &LTFAT_NAME(default_rtdgtreal_processor_callback);
+
+    // The samples are converted and deinterleaved while being written to
+    // the fifo
+    samplesWritten = LTFAT_NAME(analysis_fifo_write_interleaved)(
+                         p->fwdfifo, in, fmt, inLen, chanNo);
+
+    LTFAT_NAME(rtdgtreal_processor_processframes)(p, processorCallback);
+
+    samplesRead = LTFAT_NAME(synthesis_fifo_read_interleaved)(
+                      p->backfifo, outLen, chanNo, fmt, out);
+
+    // These should never occur, it would mean internal error
+    if ( samplesWritten != inLen ) return LTFATERR_OVERFLOW;
+    else if ( samplesRead != outLen ) return LTFATERR_UNDERFLOW;
+error:
+    return status;
+}
+
 LTFAT_API int
 LTFAT_NAME(rtdgtreal_processor_done)(LTFAT_NAME(rtdgtreal_processor_state)** p)
 {
@@ -565,7 +813,7 @@ LTFAT_NAME(rtdgtreal_processor_done)(LTFAT_NAME(rtdgtreal_processor_state)** p)
     if (pp->backfifo) LTFAT_NAME(synthesis_fifo_done)(&pp->backfifo);
     if (pp->fwdplan) LTFAT_NAME(rtdgtreal_done)(&pp->fwdplan);
     if (pp->backplan) LTFAT_NAME(rtidgtreal_done)(&pp->backplan);
-    LTFAT_SAFEFREEALL(pp->buf, pp->fftbufIn, pp->fftbufOut, pp->inTmp, pp->outTmp );
+    LTFAT_SAFEFREEALL(pp->buf, pp->inTmp, pp->outTmp );
 
     if (pp->garbageBinSize)
     {
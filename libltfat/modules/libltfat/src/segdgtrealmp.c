@@ -0,0 +1,389 @@
+#include "ltfat.h"
+#include "ltfat/types.h"
+#include "ltfat/macros.h"
+#include "dgtrealmp_private.h"
+#include "segdgtrealmp_private.h"
+
+/* The signal is split into S regions with borders at multiples of unit,
+ * which is the lcm of all a and M. Region offsets are therefore integer
+ * multiples of all time and frequency hops and the coefficients of a region
+ * can be copied to the global coefficient array without phase correction
+ * for both phase conventions.
+ *
+ * Pass 0 decomposes each region zero-padded by a guard of length G >= max gl.
+ * Pass 1 decomposes the residual in [border - G, border + G), again
+ * zero-padded by G, for all region borders.
+ *
+ * Only atoms centered within G/2 from the decomposed interval are kept,
+ * so the output of one window touches at most G samples on each side of the
+ * interval. With regions of length at least 2G, windows of regions
+ * (borders) s and s+2 never touch the same samples or coefficients. The
+ * windows are therefore processed in groups: even s, odd s and, if S is
+ * odd, s = S-1 alone (it neighbours s = 0 circularly). Windows within a
+ * group run concurrently. */
+
+static ltfat_int
+LTFAT_NAME(segdgtrealmp_regionstart)(LTFAT_NAME(segdgtrealmp_state)* p,
+                                     ltfat_int s)
+{
+    long long U = p->L / p->unit;
+    return (ltfat_int)( (s * U) / p->S ) * p->unit;
+}
+
+static int
+LTFAT_NAME(segdgtrealmp_setupstate)(LTFAT_NAME(dgtrealmp_parbuf)* pb,
+                                    ltfat_int L,
+                                    LTFAT_NAME(dgtrealmp_state)* st)
+{
+    ltfat_dgtmp_params* params = st->params;
+    double ratio = (double) st->L / L;
+
+    /* Split the global budget among the windows */
+    if (pb->params->maxatoms > 0)
+        params->maxatoms = (size_t) ceil(ratio * pb->params->maxatoms);
+
+    if (pb->params->maxit > 0)
+        params->maxit = (size_t) ceil(ratio * pb->params->maxit);
+    else
+        params->maxit = 2 * params->maxatoms;
+
+    params->iterstep = params->maxit;
+    return LTFAT_NAME(dgtrealmp_set_iterstepcallback)(st, NULL, NULL);
+}
+
+LTFAT_API int
+LTFAT_NAME(segdgtrealmp_init)(
+    LTFAT_NAME(dgtrealmp_parbuf)* pb, ltfat_int L, ltfat_int seglen,
+    ltfat_int nthreads, LTFAT_NAME(segdgtrealmp_state)** pout)
+{
+    int status = LTFATERR_FAILED;
+    LTFAT_NAME(segdgtrealmp_state)* p = NULL;
+    ltfat_int glmax = 0, segunits, Lseg, nth, batchthreads = -1;
+
+    CHECKNULL(pb); CHECKNULL(pout);
+    CHECK(LTFATERR_BADARG, pb->P > 0 , "No Gabor system set in the plan");
+    CHECK(LTFATERR_NOTPOSARG, L > 0, "L must be positive (passed %td)", L);
+    CHECK(LTFATERR_NOTPOSARG, seglen > 0,
+          "seglen must be positive (passed %td)", seglen);
+    CHECK(LTFATERR_BADTRALEN, L == ltfat_dgtlengthmulti(L, pb->P, pb->a, pb->M),
+          "L=%td is not compatible with the dictionaries", L);
+
+    CHECKMEM( p = LTFAT_NEW(LTFAT_NAME(segdgtrealmp_state)) );
+    p->L = L; p->P = pb->P;
+    p->errtoldb = pb->params->errtoldb;
+    p->unit = ltfat_dgtlengthmulti(1, pb->P, pb->a, pb->M);
+
+    for (ltfat_int k = 0; k < pb->P; k++)
+        glmax = ltfat_imax(glmax, pb->gl[k]);
+
+    p->G = ltfat_dgtlengthmulti(glmax, pb->P, pb->a, pb->M);
+    segunits = ltfat_idivceil(ltfat_imax(seglen, 2 * p->G), p->unit);
+    p->S = (L / p->unit) / segunits;
+
+    if (p->S < 3)
+    {
+        p->S = 1;
+        CHECKSTATUS( LTFAT_NAME(dgtrealmp_init)(pb, L, &p->fullstate));
+        *pout = p;
+        return LTFATERR_SUCCESS;
+    }
+
+    Lseg = ltfat_idivceil(L / p->unit, p->S) * p->unit + 2 * p->G;
+
+    CHECKSTATUS( ltfat_threadpool_init(nthreads, &p->pool));
+    nth = ltfat_threadpool_get_nthreads(p->pool);
+
+    CHECKMEM( p->segstates    = LTFAT_NEWARRAY(LTFAT_NAME(dgtrealmp_state)*, nth));
+    CHECKMEM( p->borderstates = LTFAT_NEWARRAY(LTFAT_NAME(dgtrealmp_state)*, nth));
+    CHECKMEM( p->fbuf    = LTFAT_NEWARRAY(LTFAT_REAL*, nth));
+    CHECKMEM( p->foutbuf = LTFAT_NEWARRAY(LTFAT_REAL*, nth));
+    CHECKMEM( p->cbuf    = LTFAT_NEWARRAY(LTFAT_COMPLEX**, nth));
+    CHECKMEM( p->atoms   = LTFAT_NEWARRAY(size_t, nth));
+    CHECKMEM( p->wstatus = LTFAT_NEWARRAY(int, nth));
+
+    /* The regions already run concurrently */
+    batchthreads = pb->params->batchthreads;
+    pb->params->batchthreads = 1;
+
+    for (ltfat_int w = 0; w < nth; w++)
+    {
+        CHECKSTATUS(
+            LTFAT_NAME(dgtrealmp_init)(pb, Lseg, &p->segstates[w]));
+        CHECKSTATUS(
+            LTFAT_NAME(segdgtrealmp_setupstate)(pb, L, p->segstates[w]));
+        CHECKSTATUS(
+            LTFAT_NAME(dgtrealmp_init)(pb, 4 * p->G, &p->borderstates[w]));
+        CHECKSTATUS(
+            LTFAT_NAME(segdgtrealmp_setupstate)(pb, L, p->borderstates[w]));
+
+        CHECKMEM( p->fbuf[w]    = LTFAT_NAME_REAL(malloc)(Lseg));
+        CHECKMEM( p->foutbuf[w] = LTFAT_NAME_REAL(malloc)(Lseg));
+        CHECKMEM( p->cbuf[w]    = LTFAT_NEWARRAY(LTFAT_COMPLEX*, p->P));
+
+        for (ltfat_int k = 0; k < p->P; k++)
+            CHECKMEM( p->cbuf[w][k] = LTFAT_NAME_COMPLEX(malloc)(
+                                          (pb->M[k] / 2 + 1) * (Lseg / pb->a[k])));
+    }
+
+    pb->params->batchthreads = batchthreads;
+    *pout = p;
+    return LTFATERR_SUCCESS;
+error:
+    if (batchthreads >= 0) pb->params->batchthreads = batchthreads;
+    if (p) LTFAT_NAME(segdgtrealmp_done)(&p);
+    *pout = NULL;
+    return status;
+}
+
+static void
+LTFAT_NAME(segdgtrealmp_task)(void* userdata, ltfat_int taskid,
+                              ltfat_int workerid)
+{
+    LTFAT_NAME(segdgtrealmp_state)* p =
+        (LTFAT_NAME(segdgtrealmp_state)*) userdata;
+    ltfat_int s = p->group < 2 ? 2 * taskid + p->group : p->S - 1;
+    ltfat_int L = p->L, G = p->G;
+    LTFAT_NAME(dgtrealmp_state)* st =
+        p->pass == 0 ? p->segstates[workerid] : p->borderstates[workerid];
+    LTFAT_REAL* fin = p->fbuf[workerid];
+    LTFAT_REAL* fo = p->foutbuf[workerid];
+    LTFAT_COMPLEX** c = p->cbuf[workerid];
+    ltfat_int cs, clen, ws;
+    long double Ein = 0.0, Ef = 0.0;
+    int status;
+
+    if (p->pass == 0)
+    {
+        cs = LTFAT_NAME(segdgtrealmp_regionstart)(p, s);
+        clen = LTFAT_NAME(segdgtrealmp_regionstart)(p, s + 1) - cs;
+    }
+    else
+    {
+        cs = LTFAT_NAME(segdgtrealmp_regionstart)(p, s) - G;
+        clen = 2 * G;
+    }
+    ws = ltfat_positiverem(cs - G, L);
+
+    memset(fin, 0, st->L * sizeof * fin);
+    for (ltfat_int j = 0, l = ltfat_positiverem(cs, L); j < clen; j++, l++)
+    {
+        if (l >= L) l -= L;
+        LTFAT_REAL v = p->f[l];
+        Ef += v * v;
+        if (p->pass == 1) v -= p->fout[l];
+        fin[G + j] = v;
+        Ein += v * v;
+    }
+
+    if (Ein == 0.0)
+        return;
+
+    if (p->pass == 1)
+    {
+        /* Only reach the target error of the original signal on the interval */
+        if ( Ein <= powl(10.0L, p->errtoldb / 10.0L) * Ef )
+            return;
+
+        LTFAT_NAME(dgtrealmp_set_errtoldb)(st, (double)( Ef > 0.0 ?
+                                           p->errtoldb + 10.0L * log10l(Ef / Ein) :
+                                           p->errtoldb));
+    }
+
+    status = LTFAT_NAME(dgtrealmp_execute_decompose)(st, fin, c);
+
+    if (status < 0)
+    {
+        p->wstatus[workerid] = status;
+        return;
+    }
+
+    if (status == LTFAT_DGTREALMP_STATUS_EMPTY)
+        return;
+
+    if (p->wstatus[workerid] >= 0 && status > p->wstatus[workerid])
+        p->wstatus[workerid] = status;
+
+    p->atoms[workerid] += st->iterstate->curratoms;
+
+    /* Drop atoms too far from the interval, see the comment at the top */
+    for (ltfat_int k = 0; k < p->P; k++)
+        for (ltfat_int n = 0; n < st->N[k]; n++)
+        {
+            ltfat_int t = n * st->a[k];
+            if ( t < G / 2 || t >= G + clen + G / 2 )
+                memset(c[k] + n * st->M2[k], 0, st->M2[k] * sizeof * c[k]);
+        }
+
+    LTFAT_NAME(dgtrealmp_execute_synthesize)(st, (const LTFAT_COMPLEX**) c,
+            NULL, fo);
+
+    for (ltfat_int j = 0, l = ws; j < clen + 2 * G; j++, l++)
+    {
+        if (l >= L) l -= L;
+        p->fout[l] += fo[j];
+    }
+
+    for (ltfat_int k = 0; k < p->P; k++)
+    {
+        ltfat_int M2 = st->M2[k], N = L / st->a[k];
+        ltfat_int n0 = ws / st->a[k];
+
+        for (ltfat_int n = 0; n < st->N[k]; n++)
+        {
+            ltfat_int t = n * st->a[k];
+            if ( t < G / 2 || t >= G + clen + G / 2 )
+                continue;
+
+            LTFAT_COMPLEX* cEl = p->cout[k] + ((n0 + n) % N) * M2;
+            const LTFAT_COMPLEX* cLoc = c[k] + n * M2;
+            for (ltfat_int m = 0; m < M2; m++)
+                cEl[m] += cLoc[m];
+        }
+    }
+}
+
+LTFAT_API int
+LTFAT_NAME(segdgtrealmp_execute)(
+    LTFAT_NAME(segdgtrealmp_state)* p, const LTFAT_REAL f[],
+    LTFAT_COMPLEX* cout[], LTFAT_REAL fout[])
+{
+    int status = LTFATERR_FAILED, status2 = LTFAT_DGTREALMP_STATUS_TOLREACHED;
+    ltfat_int nth;
+    long double fnorm2 = 0.0, err = 0.0;
+
+    CHECKNULL(p); CHECKNULL(f); CHECKNULL(cout); CHECKNULL(fout);
+
+    if (p->fullstate)
+    {
+        CHECKSTATUS(
+            status2 = LTFAT_NAME(dgtrealmp_execute)(p->fullstate, f, cout, fout));
+        LTFAT_NAME(dgtrealmp_get_numatoms)(p->fullstate, &p->numatoms);
+        LTFAT_NAME(dgtrealmp_get_errdb)(p->fullstate, &p->errdb);
+        return status2;
+    }
+
+    nth = ltfat_threadpool_get_nthreads(p->pool);
+
+    for (ltfat_int k = 0; k < p->P; k++)
+    {
+        CHECKNULL(cout[k]);
+        LTFAT_NAME_COMPLEX(clear_array)(cout[k], (p->L / p->segstates[0]->a[k]) *
+                                        p->segstates[0]->M2[k]);
+    }
+    memset(fout, 0, p->L * sizeof * fout);
+    memset(p->atoms, 0, nth * sizeof * p->atoms);
+    memset(p->wstatus, 0, nth * sizeof * p->wstatus);
+
+    p->f = f; p->cout = cout; p->fout = fout;
+
+    for (p->pass = 0; p->pass < 2; p->pass++)
+    {
+        for (p->group = 0; p->group < 3; p->group++)
+        {
+            ltfat_int ntasks = p->group < 2 ? p->S / 2 : p->S % 2;
+            CHECKSTATUS(
+                ltfat_threadpool_execute(p->pool, ntasks,
+                                         LTFAT_NAME(segdgtrealmp_task), p));
+        }
+    }
+
+    p->numatoms = 0;
+    for (ltfat_int w = 0; w < nth; w++)
+    {
+        CHECKSTATUS(p->wstatus[w]);
+        p->numatoms += p->atoms[w];
+        if (p->wstatus[w] > status2) status2 = p->wstatus[w];
+    }
+
+    for (ltfat_int l = 0; l < p->L; l++)
+    {
+        fnorm2 += f[l] * f[l];
+        err += (f[l] - fout[l]) * (f[l] - fout[l]);
+    }
+
+    CHECK( LTFAT_DGTREALMP_STATUS_EMPTY, fnorm2 > 0.0, "Zero energy signal");
+
+    p->errdb = (double) (10.0L * log10l(err / fnorm2));
+    if (p->errdb <= p->errtoldb)
+        status2 = LTFAT_DGTREALMP_STATUS_TOLREACHED;
+
+    p->f = NULL; p->cout = NULL; p->fout = NULL;
+    return status2;
+error:
+    if (p) { p->f = NULL; p->cout = NULL; p->fout = NULL; }
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(segdgtrealmp_get_errdb)(
+    const LTFAT_NAME(segdgtrealmp_state)* p, double* err)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(err);
+    *err = p->errdb;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(segdgtrealmp_get_numatoms)(
+    const LTFAT_NAME(segdgtrealmp_state)* p, size_t* atoms)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(atoms);
+    *atoms = p->numatoms;
+error:
+    return status;
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(segdgtrealmp_get_segno)(
+    const LTFAT_NAME(segdgtrealmp_state)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    return p->S;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(segdgtrealmp_done)(LTFAT_NAME(segdgtrealmp_state)** p)
+{
+    LTFAT_NAME(segdgtrealmp_state)* pp;
+    int status = LTFATERR_SUCCESS;
+    ltfat_int nth;
+    CHECKNULL(p); CHECKNULL(*p);
+    pp = *p;
+
+    if (pp->fullstate)
+        LTFAT_NAME(dgtrealmp_done)(&pp->fullstate);
+
+    nth = pp->pool ? ltfat_threadpool_get_nthreads(pp->pool) : 0;
+
+    for (ltfat_int w = 0; w < nth; w++)
+    {
+        if (pp->segstates && pp->segstates[w])
+            LTFAT_NAME(dgtrealmp_done)(&pp->segstates[w]);
+        if (pp->borderstates && pp->borderstates[w])
+            LTFAT_NAME(dgtrealmp_done)(&pp->borderstates[w]);
+        if (pp->fbuf) ltfat_safefree(pp->fbuf[w]);
+        if (pp->foutbuf) ltfat_safefree(pp->foutbuf[w]);
+        if (pp->cbuf && pp->cbuf[w])
+        {
+            for (ltfat_int k = 0; k < pp->P; k++)
+                ltfat_safefree(pp->cbuf[w][k]);
+            ltfat_free(pp->cbuf[w]);
+        }
+    }
+
+    LTFAT_SAFEFREEALL(pp->segstates, pp->borderstates, pp->fbuf, pp->foutbuf,
+                      pp->cbuf, pp->atoms, pp->wstatus);
+
+    if (pp->pool) ltfat_threadpool_done(&pp->pool);
+
+    ltfat_free(pp);
+    *p = NULL;
+error:
+    return status;
+}
@@ -0,0 +1,35 @@
+#ifndef _LTFAT_SEGDGTREALMP_PRIVATE_H
+#define _LTFAT_SEGDGTREALMP_PRIVATE_H
+
+
+#endif
+
+struct LTFAT_NAME(segdgtrealmp_state)
+{
+    ltfat_int L;
+    ltfat_int P;
+    ltfat_int S;         //!< Number of regions
+    ltfat_int unit;      //!< Region borders are multiples of unit
+    ltfat_int G;         //!< Guard length
+    long double errtoldb;
+    // Used if the signal is not segmented
+    LTFAT_NAME(dgtrealmp_state)* fullstate;
+    // Per worker
+    LTFAT_NAME(dgtrealmp_state)** segstates;    //!< Region decomposition
+    LTFAT_NAME(dgtrealmp_state)** borderstates; //!< Border decomposition
+    LTFAT_REAL** fbuf;
+    LTFAT_REAL** foutbuf;
+    LTFAT_COMPLEX*** cbuf;
+    size_t* atoms;
+    int* wstatus;
+    ltfat_threadpool* pool;
+    // Valid during execute
+    const LTFAT_REAL* f;
+    LTFAT_COMPLEX** cout;
+    LTFAT_REAL* fout;
+    int pass;
+    int group;
+    // Results of the last execute
+    size_t numatoms;
+    double errdb;
+};
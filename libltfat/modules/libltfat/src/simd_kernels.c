@@ -0,0 +1,496 @@
+#include "ltfat.h"
+#include "ltfat/types.h"
+#include "ltfat/macros.h"
+#include "simd_private.h"
+
+/* Reference implementation of gga_recursion_simd. Eight frequencies are
+ * interleaved so that the independent recursions overlap. */
+#define GGA_UNROLL 8
+
+static void
+LTFAT_NAME_REAL(gga_recursion_plain)(const LTFAT_REAL* f, ltfat_int fstride,
+                                     ltfat_int L, const LTFAT_REAL* cos_term,
+                                     ltfat_int M, LTFAT_REAL* s0, LTFAT_REAL* s1)
+{
+    ltfat_int m = 0;
+    for (; m + GGA_UNROLL <= M; m += GGA_UNROLL)
+    {
+        LTFAT_REAL c[GGA_UNROLL], a[GGA_UNROLL], b[GGA_UNROLL];
+        for (int un = 0; un < GGA_UNROLL; un++)
+        {
+            c[un] = cos_term[m + un]; a[un] = s0[m + un]; b[un] = s1[m + un];
+        }
+
+        for (ltfat_int l = 0; l < L; l++)
+        {
+            LTFAT_REAL x = f[l * fstride];
+            for (int un = 0; un < GGA_UNROLL; un++)
+            {
+                LTFAT_REAL n = x + c[un] * a[un] - b[un];
+                b[un] = a[un]; a[un] = n;
+            }
+        }
+
+        for (int un = 0; un < GGA_UNROLL; un++)
+        {
+            s0[m + un] = a[un]; s1[m + un] = b[un];
+        }
+    }
+
+    for (; m < M; m++)
+    {
+        LTFAT_REAL c = cos_term[m], a = s0[m], b = s1[m];
+        for (ltfat_int l = 0; l < L; l++)
+        {
+            LTFAT_REAL n = f[l * fstride] + c * a - b;
+            b = a; a = n;
+        }
+        s0[m] = a; s1[m] = b;
+    }
+}
+
+#undef GGA_UNROLL
+
+#ifdef LTFAT_SIMD_X86
+#include <immintrin.h>
+
+/* GCC fuses the separate multiply and add intrinsics into FMA for the
+ * AVX-512 target, which would change the results between the levels */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+/* The kernels are compiled with per-function target attributes so that
+ * the library itself does not have to be built with -mavx2 etc. */
+#ifdef LTFAT_SINGLE
+#define LTFAT_MM128(op)   _mm_##op##_ps
+#define LTFAT_MM256(op)   _mm256_##op##_ps
+#define LTFAT_MM512(op)   _mm512_##op##_ps
+#define LTFAT_M128        __m128
+#define LTFAT_M256        __m256
+#define LTFAT_M512        __m512
+#else
+#define LTFAT_MM128(op)   _mm_##op##_pd
+#define LTFAT_MM256(op)   _mm256_##op##_pd
+#define LTFAT_MM512(op)   _mm512_##op##_pd
+#define LTFAT_M128        __m128d
+#define LTFAT_M256        __m256d
+#define LTFAT_M512        __m512d
+#endif
+
+/* Number of LTFAT_REAL elements in one register */
+#define LTFAT_VL128  ((ltfat_int)(16 / sizeof (LTFAT_REAL)))
+#define LTFAT_VL256  ((ltfat_int)(32 / sizeof (LTFAT_REAL)))
+#define LTFAT_VL512  ((ltfat_int)(64 / sizeof (LTFAT_REAL)))
+
+__attribute__((target("sse2"))) static void
+LTFAT_NAME_REAL(add_array_sse2)(const LTFAT_REAL* in, ltfat_int L,
+                                LTFAT_REAL* out)
+{
+    ltfat_int ii = 0;
+    for (; ii + LTFAT_VL128 <= L; ii += LTFAT_VL128)
+    {
+        LTFAT_M128 x = LTFAT_MM128(loadu)(in + ii);
+        LTFAT_M128 y = LTFAT_MM128(loadu)(out + ii);
+        LTFAT_MM128(storeu)(out + ii, LTFAT_MM128(add)(x, y));
+    }
+
+    for (; ii < L; ii++)
+        out[ii] += in[ii];
+}
+
+__attribute__((target("sse2"))) static void
+LTFAT_NAME_REAL(axpy_array_sse2)(LTFAT_REAL h, const LTFAT_REAL* in,
+                                 ltfat_int L, LTFAT_REAL* out)
+{
+    ltfat_int ii = 0;
+    LTFAT_M128 hv = LTFAT_MM128(set1)(h);
+    for (; ii + LTFAT_VL128 <= L; ii += LTFAT_VL128)
+    {
+        LTFAT_M128 x = LTFAT_MM128(loadu)(in + ii);
+        LTFAT_M128 y = LTFAT_MM128(loadu)(out + ii);
+        LTFAT_MM128(storeu)(out + ii, LTFAT_MM128(add)(y, LTFAT_MM128(mul)(hv, x)));
+    }
+
+    for (; ii < L; ii++)
+        out[ii] += h * in[ii];
+}
+
+__attribute__((target("avx2"))) static void
+LTFAT_NAME_REAL(add_array_avx2)(const LTFAT_REAL* in, ltfat_int L,
+                                LTFAT_REAL* out)
+{
+    ltfat_int ii = 0;
+    /* Two registers per iteration to hide the load latency */
+    for (; ii + 2 * LTFAT_VL256 <= L; ii += 2 * LTFAT_VL256)
+    {
+        LTFAT_M256 x0 = LTFAT_MM256(loadu)(in + ii);
+        LTFAT_M256 x1 = LTFAT_MM256(loadu)(in + ii + LTFAT_VL256);
+        LTFAT_M256 y0 = LTFAT_MM256(loadu)(out + ii);
+        LTFAT_M256 y1 = LTFAT_MM256(loadu)(out + ii + LTFAT_VL256);
+        LTFAT_MM256(storeu)(out + ii, LTFAT_MM256(add)(x0, y0));
+        LTFAT_MM256(storeu)(out + ii + LTFAT_VL256, LTFAT_MM256(add)(x1, y1));
+    }
+
+    for (; ii + LTFAT_VL256 <= L; ii += LTFAT_VL256)
+    {
+        LTFAT_M256 x = LTFAT_MM256(loadu)(in + ii);
+        LTFAT_M256 y = LTFAT_MM256(loadu)(out + ii);
+        LTFAT_MM256(storeu)(out + ii, LTFAT_MM256(add)(x, y));
+    }
+
+    for (; ii < L; ii++)
+        out[ii] += in[ii];
+}
+
+__attribute__((target("avx2"))) static void
+LTFAT_NAME_REAL(axpy_array_avx2)(LTFAT_REAL h, const LTFAT_REAL* in,
+                                 ltfat_int L, LTFAT_REAL* out)
+{
+    ltfat_int ii = 0;
+    LTFAT_M256 hv = LTFAT_MM256(set1)(h);
+    /* Separate multiply and add, the results do not depend on FMA support */
+    for (; ii + 2 * LTFAT_VL256 <= L; ii += 2 * LTFAT_VL256)
+    {
+        LTFAT_M256 x0 = LTFAT_MM256(loadu)(in + ii);
+        LTFAT_M256 x1 = LTFAT_MM256(loadu)(in + ii + LTFAT_VL256);
+        LTFAT_M256 y0 = LTFAT_MM256(loadu)(out + ii);
+        LTFAT_M256 y1 = LTFAT_MM256(loadu)(out + ii + LTFAT_VL256);
+        LTFAT_MM256(storeu)(out + ii,
+                            LTFAT_MM256(add)(y0, LTFAT_MM256(mul)(hv, x0)));
+        LTFAT_MM256(storeu)(out + ii + LTFAT_VL256,
+                            LTFAT_MM256(add)(y1, LTFAT_MM256(mul)(hv, x1)));
+    }
+
+    for (; ii + LTFAT_VL256 <= L; ii += LTFAT_VL256)
+    {
+        LTFAT_M256 x = LTFAT_MM256(loadu)(in + ii);
+        LTFAT_M256 y = LTFAT_MM256(loadu)(out + ii);
+        LTFAT_MM256(storeu)(out + ii, LTFAT_MM256(add)(y, LTFAT_MM256(mul)(hv, x)));
+    }
+
+    for (; ii < L; ii++)
+        out[ii] += h * in[ii];
+}
+
+__attribute__((target("avx512f"))) static void
+LTFAT_NAME_REAL(add_array_avx512)(const LTFAT_REAL* in, ltfat_int L,
+                                  LTFAT_REAL* out)
+{
+    ltfat_int ii = 0;
+    for (; ii + 2 * LTFAT_VL512 <= L; ii += 2 * LTFAT_VL512)
+    {
+        LTFAT_M512 x0 = LTFAT_MM512(loadu)(in + ii);
+        LTFAT_M512 x1 = LTFAT_MM512(loadu)(in + ii + LTFAT_VL512);
+        LTFAT_M512 y0 = LTFAT_MM512(loadu)(out + ii);
+        LTFAT_M512 y1 = LTFAT_MM512(loadu)(out + ii + LTFAT_VL512);
+        LTFAT_MM512(storeu)(out + ii, LTFAT_MM512(add)(x0, y0));
+        LTFAT_MM512(storeu)(out + ii + LTFAT_VL512, LTFAT_MM512(add)(x1, y1));
+    }
+
+    for (; ii + LTFAT_VL512 <= L; ii += LTFAT_VL512)
+    {
+        LTFAT_M512 x = LTFAT_MM512(loadu)(in + ii);
+        LTFAT_M512 y = LTFAT_MM512(loadu)(out + ii);
+        LTFAT_MM512(storeu)(out + ii, LTFAT_MM512(add)(x, y));
+    }
+
+    for (; ii < L; ii++)
+        out[ii] += in[ii];
+}
+
+__attribute__((target("avx512f"))) static void
+LTFAT_NAME_REAL(axpy_array_avx512)(LTFAT_REAL h, const LTFAT_REAL* in,
+                                   ltfat_int L, LTFAT_REAL* out)
+{
+    ltfat_int ii = 0;
+    LTFAT_M512 hv = LTFAT_MM512(set1)(h);
+    for (; ii + 2 * LTFAT_VL512 <= L; ii += 2 * LTFAT_VL512)
+    {
+        LTFAT_M512 x0 = LTFAT_MM512(loadu)(in + ii);
+        LTFAT_M512 x1 = LTFAT_MM512(loadu)(in + ii + LTFAT_VL512);
+        LTFAT_M512 y0 = LTFAT_MM512(loadu)(out + ii);
+        LTFAT_M512 y1 = LTFAT_MM512(loadu)(out + ii + LTFAT_VL512);
+        LTFAT_MM512(storeu)(out + ii,
+                            LTFAT_MM512(add)(y0, LTFAT_MM512(mul)(hv, x0)));
+        LTFAT_MM512(storeu)(out + ii + LTFAT_VL512,
+                            LTFAT_MM512(add)(y1, LTFAT_MM512(mul)(hv, x1)));
+    }
+
+    for (; ii + LTFAT_VL512 <= L; ii += LTFAT_VL512)
+    {
+        LTFAT_M512 x = LTFAT_MM512(loadu)(in + ii);
+        LTFAT_M512 y = LTFAT_MM512(loadu)(out + ii);
+        LTFAT_MM512(storeu)(out + ii, LTFAT_MM512(add)(y, LTFAT_MM512(mul)(hv, x)));
+    }
+
+    for (; ii < L; ii++)
+        out[ii] += h * in[ii];
+}
+
+/* Goertzel recursion with the frequencies in the lanes. Four independent
+ * registers are updated per sample to hide the latency of the recursion.
+ * Separate multiply and add as in the plain C loop. */
+#define LTFAT_GGA_STEP(MM, x, c, a, b) MM(sub)(MM(add)(x, MM(mul)(c, a)), b)
+
+__attribute__((target("sse2"))) static void
+LTFAT_NAME_REAL(gga_recursion_sse2)(const LTFAT_REAL* f, ltfat_int fstride,
+                                    ltfat_int L, const LTFAT_REAL* cos_term,
+                                    ltfat_int M, LTFAT_REAL* s0, LTFAT_REAL* s1)
+{
+    ltfat_int m = 0;
+    for (; m + 4 * LTFAT_VL128 <= M; m += 4 * LTFAT_VL128)
+    {
+        LTFAT_M128 c0 = LTFAT_MM128(loadu)(cos_term + m);
+        LTFAT_M128 a0 = LTFAT_MM128(loadu)(s0 + m);
+        LTFAT_M128 b0 = LTFAT_MM128(loadu)(s1 + m);
+        LTFAT_M128 c1 = LTFAT_MM128(loadu)(cos_term + m + LTFAT_VL128);
+        LTFAT_M128 a1 = LTFAT_MM128(loadu)(s0 + m + LTFAT_VL128);
+        LTFAT_M128 b1 = LTFAT_MM128(loadu)(s1 + m + LTFAT_VL128);
+        LTFAT_M128 c2 = LTFAT_MM128(loadu)(cos_term + m + 2 * LTFAT_VL128);
+        LTFAT_M128 a2 = LTFAT_MM128(loadu)(s0 + m + 2 * LTFAT_VL128);
+        LTFAT_M128 b2 = LTFAT_MM128(loadu)(s1 + m + 2 * LTFAT_VL128);
+        LTFAT_M128 c3 = LTFAT_MM128(loadu)(cos_term + m + 3 * LTFAT_VL128);
+        LTFAT_M128 a3 = LTFAT_MM128(loadu)(s0 + m + 3 * LTFAT_VL128);
+        LTFAT_M128 b3 = LTFAT_MM128(loadu)(s1 + m + 3 * LTFAT_VL128);
+
+        for (ltfat_int l = 0; l < L; l++)
+        {
+            LTFAT_M128 x = LTFAT_MM128(set1)(f[l * fstride]);
+            LTFAT_M128 n0 = LTFAT_GGA_STEP(LTFAT_MM128, x, c0, a0, b0);
+            LTFAT_M128 n1 = LTFAT_GGA_STEP(LTFAT_MM128, x, c1, a1, b1);
+            LTFAT_M128 n2 = LTFAT_GGA_STEP(LTFAT_MM128, x, c2, a2, b2);
+            LTFAT_M128 n3 = LTFAT_GGA_STEP(LTFAT_MM128, x, c3, a3, b3);
+            b0 = a0; b1 = a1; b2 = a2; b3 = a3;
+            a0 = n0; a1 = n1; a2 = n2; a3 = n3;
+        }
+
+        LTFAT_MM128(storeu)(s0 + m, a0);
+        LTFAT_MM128(storeu)(s1 + m, b0);
+        LTFAT_MM128(storeu)(s0 + m + LTFAT_VL128, a1);
+        LTFAT_MM128(storeu)(s1 + m + LTFAT_VL128, b1);
+        LTFAT_MM128(storeu)(s0 + m + 2 * LTFAT_VL128, a2);
+        LTFAT_MM128(storeu)(s1 + m + 2 * LTFAT_VL128, b2);
+        LTFAT_MM128(storeu)(s0 + m + 3 * LTFAT_VL128, a3);
+        LTFAT_MM128(storeu)(s1 + m + 3 * LTFAT_VL128, b3);
+    }
+
+    for (; m + LTFAT_VL128 <= M; m += LTFAT_VL128)
+    {
+        LTFAT_M128 c0 = LTFAT_MM128(loadu)(cos_term + m);
+        LTFAT_M128 a0 = LTFAT_MM128(loadu)(s0 + m);
+        LTFAT_M128 b0 = LTFAT_MM128(loadu)(s1 + m);
+        for (ltfat_int l = 0; l < L; l++)
+        {
+            LTFAT_M128 n0 = LTFAT_GGA_STEP(LTFAT_MM128, LTFAT_MM128(set1)(f[l * fstride]), c0, a0, b0);
+            b0 = a0; a0 = n0;
+        }
+        LTFAT_MM128(storeu)(s0 + m, a0);
+        LTFAT_MM128(storeu)(s1 + m, b0);
+    }
+
+    LTFAT_NAME_REAL(gga_recursion_plain)(f, fstride, L, cos_term + m, M - m,
+                                         s0 + m, s1 + m);
+}
+
+__attribute__((target("avx2"))) static void
+LTFAT_NAME_REAL(gga_recursion_avx2)(const LTFAT_REAL* f, ltfat_int fstride,
+                                    ltfat_int L, const LTFAT_REAL* cos_term,
+                                    ltfat_int M, LTFAT_REAL* s0, LTFAT_REAL* s1)
+{
+    ltfat_int m = 0;
+    for (; m + 4 * LTFAT_VL256 <= M; m += 4 * LTFAT_VL256)
+    {
+        LTFAT_M256 c0 = LTFAT_MM256(loadu)(cos_term + m);
+        LTFAT_M256 a0 = LTFAT_MM256(loadu)(s0 + m);
+        LTFAT_M256 b0 = LTFAT_MM256(loadu)(s1 + m);
+        LTFAT_M256 c1 = LTFAT_MM256(loadu)(cos_term + m + LTFAT_VL256);
+        LTFAT_M256 a1 = LTFAT_MM256(loadu)(s0 + m + LTFAT_VL256);
+        LTFAT_M256 b1 = LTFAT_MM256(loadu)(s1 + m + LTFAT_VL256);
+        LTFAT_M256 c2 = LTFAT_MM256(loadu)(cos_term + m + 2 * LTFAT_VL256);
+        LTFAT_M256 a2 = LTFAT_MM256(loadu)(s0 + m + 2 * LTFAT_VL256);
+        LTFAT_M256 b2 = LTFAT_MM256(loadu)(s1 + m + 2 * LTFAT_VL256);
+        LTFAT_M256 c3 = LTFAT_MM256(loadu)(cos_term + m + 3 * LTFAT_VL256);
+        LTFAT_M256 a3 = LTFAT_MM256(loadu)(s0 + m + 3 * LTFAT_VL256);
+        LTFAT_M256 b3 = LTFAT_MM256(loadu)(s1 + m + 3 * LTFAT_VL256);
+
+        for (ltfat_int l = 0; l < L; l++)
+        {
+            LTFAT_M256 x = LTFAT_MM256(set1)(f[l * fstride]);
+            LTFAT_M256 n0 = LTFAT_GGA_STEP(LTFAT_MM256, x, c0, a0, b0);
+            LTFAT_M256 n1 = LTFAT_GGA_STEP(LTFAT_MM256, x, c1, a1, b1);
+            LTFAT_M256 n2 = LTFAT_GGA_STEP(LTFAT_MM256, x, c2, a2, b2);
+            LTFAT_M256 n3 = LTFAT_GGA_STEP(LTFAT_MM256, x, c3, a3, b3);
+            b0 = a0; b1 = a1; b2 = a2; b3 = a3;
+            a0 = n0; a1 = n1; a2 = n2; a3 = n3;
+        }
+
+        LTFAT_MM256(storeu)(s0 + m, a0);
+        LTFAT_MM256(storeu)(s1 + m, b0);
+        LTFAT_MM256(storeu)(s0 + m + LTFAT_VL256, a1);
+        LTFAT_MM256(storeu)(s1 + m + LTFAT_VL256, b1);
+        LTFAT_MM256(storeu)(s0 + m + 2 * LTFAT_VL256, a2);
+        LTFAT_MM256(storeu)(s1 + m + 2 * LTFAT_VL256, b2);
+        LTFAT_MM256(storeu)(s0 + m + 3 * LTFAT_VL256, a3);
+        LTFAT_MM256(storeu)(s1 + m + 3 * LTFAT_VL256, b3);
+    }
+
+    for (; m + LTFAT_VL256 <= M; m += LTFAT_VL256)
+    {
+        LTFAT_M256 c0 = LTFAT_MM256(loadu)(cos_term + m);
+        LTFAT_M256 a0 = LTFAT_MM256(loadu)(s0 + m);
+        LTFAT_M256 b0 = LTFAT_MM256(loadu)(s1 + m);
+        for (ltfat_int l = 0; l < L; l++)
+        {
+            LTFAT_M256 n0 = LTFAT_GGA_STEP(LTFAT_MM256, LTFAT_MM256(set1)(f[l * fstride]), c0, a0, b0);
+            b0 = a0; a0 = n0;
+        }
+        LTFAT_MM256(storeu)(s0 + m, a0);
+        LTFAT_MM256(storeu)(s1 + m, b0);
+    }
+
+    LTFAT_NAME_REAL(gga_recursion_plain)(f, fstride, L, cos_term + m, M - m,
+                                         s0 + m, s1 + m);
+}
+
+__attribute__((target("avx512f"))) static void
+LTFAT_NAME_REAL(gga_recursion_avx512)(const LTFAT_REAL* f, ltfat_int fstride,
+                                      ltfat_int L, const LTFAT_REAL* cos_term,
+                                      ltfat_int M, LTFAT_REAL* s0, LTFAT_REAL* s1)
+{
+    ltfat_int m = 0;
+    for (; m + 4 * LTFAT_VL512 <= M; m += 4 * LTFAT_VL512)
+    {
+        LTFAT_M512 c0 = LTFAT_MM512(loadu)(cos_term + m);
+        LTFAT_M512 a0 = LTFAT_MM512(loadu)(s0 + m);
+        LTFAT_M512 b0 = LTFAT_MM512(loadu)(s1 + m);
+        LTFAT_M512 c1 = LTFAT_MM512(loadu)(cos_term + m + LTFAT_VL512);
+        LTFAT_M512 a1 = LTFAT_MM512(loadu)(s0 + m + LTFAT_VL512);
+        LTFAT_M512 b1 = LTFAT_MM512(loadu)(s1 + m + LTFAT_VL512);
+        LTFAT_M512 c2 = LTFAT_MM512(loadu)(cos_term + m + 2 * LTFAT_VL512);
+        LTFAT_M512 a2 = LTFAT_MM512(loadu)(s0 + m + 2 * LTFAT_VL512);
+        LTFAT_M512 b2 = LTFAT_MM512(loadu)(s1 + m + 2 * LTFAT_VL512);
+        LTFAT_M512 c3 = LTFAT_MM512(loadu)(cos_term + m + 3 * LTFAT_VL512);
+        LTFAT_M512 a3 = LTFAT_MM512(loadu)(s0 + m + 3 * LTFAT_VL512);
+        LTFAT_M512 b3 = LTFAT_MM512(loadu)(s1 + m + 3 * LTFAT_VL512);
+
+        for (ltfat_int l = 0; l < L; l++)
+        {
+            LTFAT_M512 x = LTFAT_MM512(set1)(f[l * fstride]);
+            LTFAT_M512 n0 = LTFAT_GGA_STEP(LTFAT_MM512, x, c0, a0, b0);
+            LTFAT_M512 n1 = LTFAT_GGA_STEP(LTFAT_MM512, x, c1, a1, b1);
+            LTFAT_M512 n2 = LTFAT_GGA_STEP(LTFAT_MM512, x, c2, a2, b2);
+            LTFAT_M512 n3 = LTFAT_GGA_STEP(LTFAT_MM512, x, c3, a3, b3);
+            b0 = a0; b1 = a1; b2 = a2; b3 = a3;
+            a0 = n0; a1 = n1; a2 = n2; a3 = n3;
+        }
+
+        LTFAT_MM512(storeu)(s0 + m, a0);
+        LTFAT_MM512(storeu)(s1 + m, b0);
+        LTFAT_MM512(storeu)(s0 + m + LTFAT_VL512, a1);
+        LTFAT_MM512(storeu)(s1 + m + LTFAT_VL512, b1);
+        LTFAT_MM512(storeu)(s0 + m + 2 * LTFAT_VL512, a2);
+        LTFAT_MM512(storeu)(s1 + m + 2 * LTFAT_VL512, b2);
+        LTFAT_MM512(storeu)(s0 + m + 3 * LTFAT_VL512, a3);
+        LTFAT_MM512(storeu)(s1 + m + 3 * LTFAT_VL512, b3);
+    }
+
+    for (; m + LTFAT_VL512 <= M; m += LTFAT_VL512)
+    {
+        LTFAT_M512 c0 = LTFAT_MM512(loadu)(cos_term + m);
+        LTFAT_M512 a0 = LTFAT_MM512(loadu)(s0 + m);
+        LTFAT_M512 b0 = LTFAT_MM512(loadu)(s1 + m);
+        for (ltfat_int l = 0; l < L; l++)
+        {
+            LTFAT_M512 n0 = LTFAT_GGA_STEP(LTFAT_MM512, LTFAT_MM512(set1)(f[l * fstride]), c0, a0, b0);
+            b0 = a0; a0 = n0;
+        }
+        LTFAT_MM512(storeu)(s0 + m, a0);
+        LTFAT_MM512(storeu)(s1 + m, b0);
+    }
+
+    LTFAT_NAME_REAL(gga_recursion_plain)(f, fstride, L, cos_term + m, M - m,
+                                         s0 + m, s1 + m);
+}
+
+#undef LTFAT_GGA_STEP
+
+#undef LTFAT_MM128
+#undef LTFAT_MM256
+#undef LTFAT_MM512
+#undef LTFAT_M128
+#undef LTFAT_M256
+#undef LTFAT_M512
+#undef LTFAT_VL128
+#undef LTFAT_VL256
+#undef LTFAT_VL512
+#endif /* LTFAT_SIMD_X86 */
+
+void
+LTFAT_NAME_REAL(add_array_simd)(const LTFAT_REAL* in, ltfat_int L,
+                                LTFAT_REAL* out)
+{
+#ifdef LTFAT_SIMD_X86
+    switch (ltfat_simd_get_level())
+    {
+    case LTFAT_SIMD_AVX512:
+        LTFAT_NAME_REAL(add_array_avx512)(in, L, out); return;
+    case LTFAT_SIMD_AVX2:
+        LTFAT_NAME_REAL(add_array_avx2)(in, L, out); return;
+    case LTFAT_SIMD_SSE2:
+        LTFAT_NAME_REAL(add_array_sse2)(in, L, out); return;
+    default:
+        break;
+    }
+#endif
+
+    for (ltfat_int ii = 0; ii < L; ii++)
+        out[ii] += in[ii];
+}
+
+void
+LTFAT_NAME_REAL(axpy_array_simd)(LTFAT_REAL h, const LTFAT_REAL* in,
+                                 ltfat_int L, LTFAT_REAL* out)
+{
+#ifdef LTFAT_SIMD_X86
+    switch (ltfat_simd_get_level())
+    {
+    case LTFAT_SIMD_AVX512:
+        LTFAT_NAME_REAL(axpy_array_avx512)(h, in, L, out); return;
+    case LTFAT_SIMD_AVX2:
+        LTFAT_NAME_REAL(axpy_array_avx2)(h, in, L, out); return;
+    case LTFAT_SIMD_SSE2:
+        LTFAT_NAME_REAL(axpy_array_sse2)(h, in, L, out); return;
+    default:
+        break;
+    }
+#endif
+
+    for (ltfat_int ii = 0; ii < L; ii++)
+        out[ii] += h * in[ii];
+}
+
+void
+LTFAT_NAME_REAL(gga_recursion_simd)(const LTFAT_REAL* f, ltfat_int fstride,
+                                    ltfat_int L, const LTFAT_REAL* cos_term,
+                                    ltfat_int M, LTFAT_REAL* s0, LTFAT_REAL* s1)
+{
+#ifdef LTFAT_SIMD_X86
+    switch (ltfat_simd_get_level())
+    {
+    case LTFAT_SIMD_AVX512:
+        LTFAT_NAME_REAL(gga_recursion_avx512)(f, fstride, L, cos_term, M, s0, s1);
+        return;
+    case LTFAT_SIMD_AVX2:
+        LTFAT_NAME_REAL(gga_recursion_avx2)(f, fstride, L, cos_term, M, s0, s1);
+        return;
+    case LTFAT_SIMD_SSE2:
+        LTFAT_NAME_REAL(gga_recursion_sse2)(f, fstride, L, cos_term, M, s0, s1);
+        return;
+    default:
+        break;
+    }
+#endif
+
+    LTFAT_NAME_REAL(gga_recursion_plain)(f, fstride, L, cos_term, M, s0, s1);
+}
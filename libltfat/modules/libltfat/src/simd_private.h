@@ -0,0 +1,42 @@
+#ifndef _ltfat_simd_private_h
+#define _ltfat_simd_private_h
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__)) && !defined(LTFAT_NOSIMD)
+#define LTFAT_SIMD_X86
+#endif
+
+#endif
+
+/* Type dependent part, included in every typed compilation */
+#ifdef LTFAT_NAME_REAL
+
+/* out[ii] += in[ii] for ii = 0,...,L-1
+ *
+ * in and out must either be disjoint or identical. The instruction set is
+ * chosen according to ltfat_simd_get_level().
+ */
+void
+LTFAT_NAME_REAL(add_array_simd)(const LTFAT_REAL* in, ltfat_int L,
+                                LTFAT_REAL* out);
+
+/* out[ii] += h * in[ii] for ii = 0,...,L-1
+ *
+ * in and out must not overlap.
+ */
+void
+LTFAT_NAME_REAL(axpy_array_simd)(LTFAT_REAL h, const LTFAT_REAL* in,
+                                 ltfat_int L, LTFAT_REAL* out);
+
+/* Goertzel recursion s[l] = f[l*fstride] + cos_term[m]*s[l-1] - s[l-2],
+ * l = 0,...,L-1, for M frequencies at once
+ *
+ * s0[m] and s1[m] hold s[-1] and s[-2] on input and s[L-1] and s[L-2] on
+ * output, so a long signal can be processed in several calls.
+ */
+void
+LTFAT_NAME_REAL(gga_recursion_simd)(const LTFAT_REAL* f, ltfat_int fstride,
+                                    ltfat_int L, const LTFAT_REAL* cos_term,
+                                    ltfat_int M, LTFAT_REAL* s0, LTFAT_REAL* s1);
+
+#endif
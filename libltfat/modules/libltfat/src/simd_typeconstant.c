@@ -0,0 +1,49 @@
+#include "ltfat.h"
+#include "ltfat/macros.h"
+#include "atomics_private.h"
+#include "simd_private.h"
+
+/* -1 means not detected yet */
+static ltfat_int ltfat_simd_level_current = -1;
+
+LTFAT_API ltfat_simd_level
+ltfat_simd_get_maxlevel(void)
+{
+#ifdef LTFAT_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return LTFAT_SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2"))    return LTFAT_SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2"))    return LTFAT_SIMD_SSE2;
+#endif
+    return LTFAT_SIMD_NONE;
+}
+
+LTFAT_API ltfat_simd_level
+ltfat_simd_get_level(void)
+{
+    ltfat_int level = ltfat_atomic_load_acq(&ltfat_simd_level_current);
+
+    if (level < 0)
+    {
+        /* Racing threads store the same value */
+        level = (ltfat_int) ltfat_simd_get_maxlevel();
+        ltfat_atomic_store_rel(&ltfat_simd_level_current, level);
+    }
+
+    return (ltfat_simd_level) level;
+}
+
+LTFAT_API int
+ltfat_simd_set_level(ltfat_simd_level level)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECK(LTFATERR_CANNOTHAPPEN,
+          level >= LTFAT_SIMD_NONE && level <= LTFAT_SIMD_AVX512,
+          "Invalid ltfat_simd_level enum value.");
+    CHECK(LTFATERR_NOTSUPPORTED, level <= ltfat_simd_get_maxlevel(),
+          "The instruction set is not supported by this CPU.");
+
+    ltfat_atomic_store(&ltfat_simd_level_current, (ltfat_int) level);
+error:
+    return status;
+}
@@ -162,8 +162,23 @@ LTFAT_NAME(slidgtrealmp_execute_callback)(void* userdata,
 
     for (ltfat_int w = 0; w < W; w++)
     {
+        const LTFAT_REAL* inw = in + w * winLen;
+        int is_silent = 1;
+
+        for (ltfat_int l = 0; l < winLen && is_silent; l++)
+            is_silent = inw[l] == 0.0;
+
+        /* Silent slices are common in long streams, there is nothing to
+         * decompose and the coefficients from the previous slice must not be
+         * used. */
+        if (is_silent)
+        {
+            memset(out + w * winLen, 0, winLen * sizeof * out);
+            continue;
+        }
+
         LTFAT_NAME(dgtrealmp_execute_decompose)(
-            p->mpstate, in + w * winLen, p->couttmp);
+            p->mpstate, inw, p->couttmp);
 
         if(p->callback)
         {
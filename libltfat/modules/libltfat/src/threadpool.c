@@ -0,0 +1,260 @@
+#include "ltfat.h"
+#include "ltfat/macros.h"
+#include "atomics_private.h"
+
+#ifndef LTFAT_NOTHREADS
+#include <pthread.h>
+#if defined(_WIN32) || defined(__WIN32__)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#endif
+
+/* Number of polls before a waiting thread goes to sleep */
+#define LTFAT_THREADPOOL_SPINS 4096
+
+typedef struct
+{
+    ltfat_threadpool* pool;
+    ltfat_int workerid;
+} ltfat_threadpool_worker;
+
+struct ltfat_threadpool
+{
+    ltfat_int nthreads;
+    /* Job description, written by the caller before generation is bumped */
+    ltfat_threadpool_task* task;
+    void* userdata;
+    ltfat_int ntasks;
+    /* Atomics */
+    ltfat_int generation;
+    ltfat_int nexttask;
+    ltfat_int active;
+    ltfat_int sleepingworkers;
+    ltfat_int callersleeping;
+    ltfat_int stop;
+#ifndef LTFAT_NOTHREADS
+    pthread_mutex_t lock;
+    pthread_cond_t  workcond;
+    pthread_cond_t  donecond;
+    pthread_t* threads;
+    ltfat_threadpool_worker* workers;
+    int syncinitialized;
+#endif
+};
+
+static void
+ltfat_threadpool_runtasks(ltfat_threadpool* p, ltfat_int workerid)
+{
+    ltfat_int taskid;
+    while ( (taskid = ltfat_atomic_fetch_add(&p->nexttask, 1)) < p->ntasks )
+        p->task(p->userdata, taskid, workerid);
+}
+
+#ifndef LTFAT_NOTHREADS
+static void*
+ltfat_threadpool_workerloop(void* arg)
+{
+    ltfat_threadpool_worker* wrk = (ltfat_threadpool_worker*) arg;
+    ltfat_threadpool* p = wrk->pool;
+    ltfat_int seen = 0;
+
+    while (1)
+    {
+        ltfat_int spins = 0;
+        /* Lock-free fast path */
+        while ( ltfat_atomic_load(&p->generation) == seen &&
+                !ltfat_atomic_load(&p->stop) && spins++ < LTFAT_THREADPOOL_SPINS )
+            ltfat_cpu_relax();
+
+        if ( ltfat_atomic_load(&p->generation) == seen && !ltfat_atomic_load(&p->stop) )
+        {
+            pthread_mutex_lock(&p->lock);
+            ltfat_atomic_fetch_add(&p->sleepingworkers, 1);
+            while ( ltfat_atomic_load(&p->generation) == seen &&
+                    !ltfat_atomic_load(&p->stop) )
+                pthread_cond_wait(&p->workcond, &p->lock);
+            ltfat_atomic_fetch_add(&p->sleepingworkers, -1);
+            pthread_mutex_unlock(&p->lock);
+        }
+
+        if ( ltfat_atomic_load(&p->stop) ) break;
+
+        seen = ltfat_atomic_load(&p->generation);
+
+        ltfat_threadpool_runtasks(p, wrk->workerid);
+
+        if ( ltfat_atomic_fetch_add(&p->active, -1) == 1 &&
+             ltfat_atomic_load(&p->callersleeping) )
+        {
+            pthread_mutex_lock(&p->lock);
+            pthread_cond_signal(&p->donecond);
+            pthread_mutex_unlock(&p->lock);
+        }
+    }
+    return NULL;
+}
+#endif
+
+LTFAT_API ltfat_int
+ltfat_threadpool_get_nprocs(void)
+{
+#if defined(LTFAT_NOTHREADS)
+    return 1;
+#elif defined(_WIN32) || defined(__WIN32__)
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return sysinfo.dwNumberOfProcessors > 0 ? (ltfat_int) sysinfo.dwNumberOfProcessors : 1;
+#else
+    long nprocs = sysconf(_SC_NPROCESSORS_ONLN);
+    return nprocs > 0 ? (ltfat_int) nprocs : 1;
+#endif
+}
+
+LTFAT_API int
+ltfat_threadpool_init(ltfat_int nthreads, ltfat_threadpool** pout)
+{
+    ltfat_threadpool* p = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(pout);
+    CHECK(LTFATERR_BADARG, nthreads >= 0,
+          "nthreads must be nonnegative (passed %td)", nthreads);
+
+    if (nthreads == 0) nthreads = ltfat_threadpool_get_nprocs();
+
+    CHECKMEM( p = LTFAT_NEW(ltfat_threadpool) );
+#ifdef LTFAT_NOTHREADS
+    p->nthreads = 1;
+#else
+    p->nthreads = nthreads;
+
+    if (nthreads > 1)
+    {
+        CHECKMEM( p->threads = LTFAT_NEWARRAY(pthread_t, nthreads - 1) );
+        CHECKMEM( p->workers = LTFAT_NEWARRAY(ltfat_threadpool_worker, nthreads - 1) );
+
+        CHECKINIT( !pthread_mutex_init(&p->lock, NULL), "Mutex init failed.");
+        if ( pthread_cond_init(&p->workcond, NULL) )
+        {
+            pthread_mutex_destroy(&p->lock);
+            CHECKINIT( 0, "Condition variable init failed.");
+        }
+        if ( pthread_cond_init(&p->donecond, NULL) )
+        {
+            pthread_cond_destroy(&p->workcond);
+            pthread_mutex_destroy(&p->lock);
+            CHECKINIT( 0, "Condition variable init failed.");
+        }
+        p->syncinitialized = 1;
+
+        for (ltfat_int ii = 0; ii < nthreads - 1; ii++)
+        {
+            p->workers[ii].pool = p;
+            p->workers[ii].workerid = ii + 1;
+            if ( pthread_create(&p->threads[ii], NULL,
+                                ltfat_threadpool_workerloop, &p->workers[ii]) )
+            {
+                p->nthreads = ii + 1;
+                CHECKINIT( 0, "Thread creation failed.");
+            }
+        }
+    }
+#endif
+
+    *pout = p;
+    return status;
+error:
+    if (p) ltfat_threadpool_done(&p);
+    return status;
+}
+
+LTFAT_API int
+ltfat_threadpool_execute(ltfat_threadpool* p, ltfat_int ntasks,
+                         ltfat_threadpool_task* task, void* userdata)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(task);
+    CHECK(LTFATERR_BADARG, ntasks >= 0,
+          "ntasks must be nonnegative (passed %td)", ntasks);
+
+    p->task = task;
+    p->userdata = userdata;
+    p->ntasks = ntasks;
+    ltfat_atomic_store(&p->nexttask, 0);
+
+    if (p->nthreads == 1 || ntasks <= 1)
+    {
+        ltfat_threadpool_runtasks(p, 0);
+        return status;
+    }
+
+#ifndef LTFAT_NOTHREADS
+    ltfat_atomic_store(&p->active, p->nthreads - 1);
+    ltfat_atomic_fetch_add(&p->generation, 1);
+
+    if ( ltfat_atomic_load(&p->sleepingworkers) )
+    {
+        pthread_mutex_lock(&p->lock);
+        pthread_cond_broadcast(&p->workcond);
+        pthread_mutex_unlock(&p->lock);
+    }
+
+    ltfat_threadpool_runtasks(p, 0);
+
+    for (ltfat_int spins = 0; ltfat_atomic_load(&p->active) &&
+         spins < LTFAT_THREADPOOL_SPINS; spins++ )
+        ltfat_cpu_relax();
+
+    if ( ltfat_atomic_load(&p->active) )
+    {
+        pthread_mutex_lock(&p->lock);
+        ltfat_atomic_store(&p->callersleeping, 1);
+        while ( ltfat_atomic_load(&p->active) )
+            pthread_cond_wait(&p->donecond, &p->lock);
+        ltfat_atomic_store(&p->callersleeping, 0);
+        pthread_mutex_unlock(&p->lock);
+    }
+#endif
+error:
+    return status;
+}
+
+LTFAT_API ltfat_int
+ltfat_threadpool_get_nthreads(ltfat_threadpool* p)
+{
+    if (p) return p->nthreads;
+    else return LTFATERR_NULLPOINTER;
+}
+
+LTFAT_API int
+ltfat_threadpool_done(ltfat_threadpool** p)
+{
+    ltfat_threadpool* pp;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(*p);
+    pp = *p;
+
+#ifndef LTFAT_NOTHREADS
+    if (pp->syncinitialized)
+    {
+        pthread_mutex_lock(&pp->lock);
+        ltfat_atomic_store(&pp->stop, 1);
+        pthread_cond_broadcast(&pp->workcond);
+        pthread_mutex_unlock(&pp->lock);
+
+        for (ltfat_int ii = 0; ii < pp->nthreads - 1; ii++)
+            pthread_join(pp->threads[ii], NULL);
+
+        pthread_cond_destroy(&pp->donecond);
+        pthread_cond_destroy(&pp->workcond);
+        pthread_mutex_destroy(&pp->lock);
+    }
+    LTFAT_SAFEFREEALL(pp->threads, pp->workers);
+#endif
+
+    ltfat_free(pp);
+    *p = NULL;
+error:
+    return status;
+}
@@ -0,0 +1,25 @@
+#include "ltfat.h"
+#include "ltfat/macros.h"
+
+#if defined(_WIN32) || defined(__WIN32__)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/* clock() is the CPU time of the whole process, it also counts all other
+ * threads running at the same time. */
+LTFAT_API double
+ltfat_time_monotonic(void)
+{
+#if defined(_WIN32) || defined(__WIN32__)
+    LARGE_INTEGER frequency, t;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&t);
+    return (double) t.QuadPart / frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#endif
+}
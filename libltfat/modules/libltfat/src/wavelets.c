@@ -1,596 +1,613 @@
 #include "ltfat.h"
 #include "ltfat/types.h"
 #include "ltfat/macros.h"
+#include "simd_private.h"
+
+/* Number of output samples processed at once. All taps are applied to one
+ * block before moving to the next one so that the block stays in cache. */
+#ifndef LTFAT_CONVSUB_TD_BLOCK
+#define LTFAT_CONVSUB_TD_BLOCK 512
+#endif
+
+/* Time-domain engine shared by convsub_td, upconv_td and the a-trous
+ * variants. The analysis computes
+ *
+ *   c[n] = sum_j g[j] X[a*n - skip - j*ga],   n = 0,...,N-1,
+ *
+ * where X is f extended according to ext, and the synthesis its adjoint
+ *
+ *   f[l] += sum_j conj(g[j]) C[n],   a*n - skip - j*ga = l,
+ *
+ * where C is c extended periodically for PER and by zeros otherwise.
+ *
+ * The extended input is first copied to a polyphase representation
+ * (the extension is evaluated only at the edges), then every tap is
+ * a multiply-accumulate of two contiguous arrays.
+ */
+struct LTFAT_NAME(convsub_td_plan)
+{
+    ltfat_int L;
+    ltfat_int N;
+    ltfat_int gl;
+    ltfat_int a;         //!< Subsampling factor
+    ltfat_int ga;        //!< Filter dilation factor
+    ltfat_int skip;
+    ltfatExtType ext;
+    ltfat_int exta;      //!< a passed to extend_left and extend_right
+    ltfat_int extl;      //!< Length of the dilated filter
+    ltfat_int extbufl;   //!< Length of one extension buffer
+    LTFAT_TYPE* g;       //!< Conjugated for the synthesis
+    ltfat_int* tapphase; //!< Polyphase component used by a tap
+    ltfat_int* tapshift; //!< Offset of a tap within the component
+    ltfat_int inphases;  //!< a for the analysis, 1 for the synthesis
+    ltfat_int inmin;     //!< Index of the first input sample
+    ltfat_int inlen;     //!< Length of an input polyphase component
+    ltfat_int outlen;    //!< Length of an output polyphase component
+    LTFAT_TYPE* inbuf;   //!< inphases x inlen
+    LTFAT_TYPE* outbuf;  //!< a x outlen, synthesis with a>1 only
+    LTFAT_TYPE* extbuf;  //!< Left and right extension, 2 x extbufl
+};
+
+struct LTFAT_NAME(upconv_td_plan)
+{
+    struct LTFAT_NAME(convsub_td_plan) inplan;
+};
 
+static ltfat_int
+LTFAT_NAME(td_floordiv)(ltfat_int x, ltfat_int a)
+{
+    return (x - ltfat_positiverem(x, a)) / a;
+}
 
-LTFAT_API void
-LTFAT_NAME(atrousfilterbank_td)(const LTFAT_TYPE* f, const LTFAT_TYPE* g[],
-                                ltfat_int L, ltfat_int gl[],
-                                ltfat_int W, ltfat_int a[],
-                                ltfat_int skip[], ltfat_int M,
-                                LTFAT_TYPE* c, ltfatExtType ext)
+/* out[ii] += h*in[ii] */
+static void
+LTFAT_NAME(td_axpy)(LTFAT_TYPE h, const LTFAT_TYPE* in, ltfat_int L,
+                    LTFAT_TYPE* out)
 {
-    for (ltfat_int m = 0; m < M; m++)
+#ifdef LTFAT_COMPLEXTYPE
+    if (ltfat_imag(h) == 0)
     {
-        for (ltfat_int w = 0; w < W; w++)
-        {
-            LTFAT_NAME(atrousconvsub_td)(f + w * L, g[m], L, gl[m], a[m],
-                                         skip[m], c + w * M * L + m * L, ext);
-        }
+        // Complex arrays are treated as real arrays of twice the length
+        LTFAT_NAME_REAL(axpy_array_simd)(ltfat_real(h), (const LTFAT_REAL*) in,
+                                         2 * L, (LTFAT_REAL*) out);
     }
+    else
+    {
+        for (ltfat_int ii = 0; ii < L; ii++)
+            out[ii] += h * in[ii];
+    }
+#else
+    LTFAT_NAME_REAL(axpy_array_simd)(h, in, L, out);
+#endif
 }
 
-LTFAT_API void
-LTFAT_NAME(iatrousfilterbank_td)(const LTFAT_TYPE* c, const LTFAT_TYPE* g[],
-                                 ltfat_int L, ltfat_int gl[],
-                                 ltfat_int W, ltfat_int a[],
-                                 ltfat_int skip[], ltfat_int M,
-                                 LTFAT_TYPE* f, ltfatExtType ext)
+/* Copies samples inmin + q + P*k, k = 0,...,inlen-1, of in[] (length Lin)
+ * to the q-th polyphase component, q = 0,...,P-1, where P = inphases.
+ * Samples before and after in[] are taken from the left and the right
+ * extension, zeros beyond them. */
+static void
+LTFAT_NAME(td_splitphases)(const LTFAT_NAME(convsub_td_plan)* p,
+                           const LTFAT_TYPE* in, ltfat_int Lin)
 {
-    // Set output array to zeros, since the array is used as an accumulator
-    //memset(f,0,L*W*sizeof*f);
-    LTFAT_NAME(clear_array)(f, L * W);
+    // Left extension is at negative, right at nonnegative indices
+    const LTFAT_TYPE* ext = p->extbuf + p->extbufl;
+    ltfat_int P = p->inphases;
 
-    for (ltfat_int m = 0; m < M; m++)
+    for (ltfat_int q = 0; q < P; q++)
     {
-        for (ltfat_int w = 0; w < W; w++)
+        LTFAT_TYPE* out = p->inbuf + q * p->inlen;
+        ltfat_int first = p->inmin + q;
+        // Range of k for which the sample lies inside in[]
+        ltfat_int klo = ltfat_imin(p->inlen,
+                                   ltfat_imax(0, ltfat_idivceil(-first, P)));
+        ltfat_int khi = ltfat_imin(p->inlen,
+                                   ltfat_imax(klo, ltfat_idivceil(Lin - first, P)));
+
+        for (ltfat_int k = 0; k < klo; k++)
         {
-            LTFAT_NAME(atrousupconv_td)(c + w * M * L + m * L, g[m], L, gl[m], a[m],
-                                        skip[m], f + w * L, ext);
+            ltfat_int ii = first + P * k;
+            out[k] = ii >= -p->extbufl ? ext[ii] : (LTFAT_TYPE) 0.0;
         }
-    }
-
-}
 
+        if (P == 1)
+            memcpy(out + klo, in + first + klo, (khi - klo) * sizeof * out);
+        else
+            for (ltfat_int k = klo; k < khi; k++)
+                out[k] = in[first + P * k];
 
-LTFAT_API void
-LTFAT_NAME(filterbank_td)(const LTFAT_TYPE* f, const LTFAT_TYPE* g[],
-                          ltfat_int L, ltfat_int gl[],
-                          ltfat_int W, ltfat_int a[],
-                          ltfat_int skip[], ltfat_int M,
-                          LTFAT_TYPE* c[], ltfatExtType ext)
-{
-    for (ltfat_int m = 0; m < M; m++)
-    {
-        ltfat_int N = filterbank_td_size(L, a[m], gl[m], skip[m], ext);
-        for (ltfat_int w = 0; w < W; w++)
+        for (ltfat_int k = khi; k < p->inlen; k++)
         {
-
-            LTFAT_NAME(convsub_td)(f + w * L, g[m], L, gl[m], a[m],
-                                   skip[m], c[m] + w * N, ext);
+            ltfat_int ii = first + P * k - Lin;
+            out[k] = ii < p->extbufl ? ext[ii] : (LTFAT_TYPE) 0.0;
         }
     }
 }
 
-
-LTFAT_API void
-LTFAT_NAME(ifilterbank_td)(const LTFAT_TYPE* c[], const LTFAT_TYPE* g[],
-                           ltfat_int L, ltfat_int gl[],
-                           ltfat_int W, ltfat_int a[],
-                           ltfat_int skip[], ltfat_int M,
-                           LTFAT_TYPE* f, ltfatExtType ext)
+static int
+LTFAT_NAME(td_plan_init)(const LTFAT_TYPE g[], ltfat_int L, ltfat_int gl,
+                         ltfat_int a, ltfat_int ga, ltfat_int skip,
+                         ltfatExtType ext, ltfat_int N, int synthesis,
+                         LTFAT_NAME(convsub_td_plan)* p)
 {
-    /* memset(f, 0, L * W * sizeof * f); */
-    LTFAT_NAME(clear_array)(f, L * W);
-
-    for (ltfat_int m = 0; m < M; m++)
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(g);
+    CHECK(LTFATERR_NOTPOSARG, L > 0, "L must be positive");
+    CHECK(LTFATERR_NOTPOSARG, gl > 0, "gl must be positive");
+    CHECK(LTFATERR_NOTPOSARG, a > 0, "a must be positive");
+    CHECK(LTFATERR_NOTPOSARG, ga > 0, "ga must be positive");
+    CHECK(LTFATERR_BADARG, ext >= PER && ext < BAD_TYPE, "Invalid ext");
+
+    p->L = L; p->N = ltfat_imax(N, 0); p->gl = gl; p->a = a; p->ga = ga;
+    p->skip = skip; p->ext = ext;
+    p->exta = ga > 1 ? 1 : a;
+    p->extl = (gl - 1) * ga + 1;
+    // PERDEC can replicate up to a-1 samples on top of extl-1
+    p->extbufl = p->extl + a;
+
+    CHECKMEM( p->g = LTFAT_NAME(malloc)(gl) );
+    CHECKMEM( p->tapphase = LTFAT_NEWARRAY(ltfat_int, gl) );
+    CHECKMEM( p->tapshift = LTFAT_NEWARRAY(ltfat_int, gl) );
+    CHECKMEM( p->extbuf = LTFAT_NAME(calloc)(2 * p->extbufl) );
+
+    if (!synthesis)
     {
-        ltfat_int N = filterbank_td_size(L, a[m], gl[m], skip[m], ext);
-        for (ltfat_int w = 0; w < W; w++)
-        {
+        memcpy(p->g, g, gl * sizeof * p->g);
 
-            LTFAT_NAME(upconv_td)(c[m] + w * N, g[m], L, gl[m], a[m],
-                                  skip[m], f + w * L, ext);
+        // Input samples inmin,...,a*(N-1) - skip
+        p->inphases = a;
+        p->inmin = -skip - (gl - 1) * ga;
+        p->inlen = p->N - 1 + ((gl - 1) * ga) / a + 1;
+        p->outlen = 0;
+
+        for (ltfat_int j = 0; j < gl; j++)
+        {
+            ltfat_int d = (gl - 1 - j) * ga;
+            p->tapphase[j] = d % a;
+            p->tapshift[j] = d / a;
         }
     }
+    else
+    {
+        LTFAT_NAME(conjugate_array)(g, gl, p->g);
 
-}
+        // Coefficients inmin,...,inmax
+        p->inphases = 1;
+        p->inmin = -LTFAT_NAME(td_floordiv)(-skip, a);
+        ltfat_int inmax = LTFAT_NAME(td_floordiv)(L - 1 + skip + (gl - 1) * ga, a);
+        p->inlen = ltfat_imax(0, inmax - p->inmin + 1);
+        p->outlen = a > 1 ? ltfat_idivceil(L, a) : 0;
 
+        for (ltfat_int j = 0; j < gl; j++)
+        {
+            ltfat_int e = a * p->inmin - skip - j * ga;
+            p->tapshift[j] = LTFAT_NAME(td_floordiv)(e, a);
+            p->tapphase[j] = e - a * p->tapshift[j];
+        }
+    }
 
-LTFAT_API void
-LTFAT_NAME(atrousconvsub_td)(const LTFAT_TYPE* f, const LTFAT_TYPE* g,
-                             ltfat_int L, ltfat_int gl, ltfat_int ga,
-                             ltfat_int skip, LTFAT_TYPE* c, ltfatExtType ext)
-{
-    /* memset(c, 0, L * sizeof * c); */
-    LTFAT_NAME(clear_array)(c, L );
+    if (p->N > 0 && p->inlen > 0)
+        CHECKMEM( p->inbuf = LTFAT_NAME(malloc)(p->inphases * p->inlen) );
+    if (p->outlen > 0)
+        CHECKMEM( p->outbuf = LTFAT_NAME(malloc)(a * p->outlen) );
 
-    ltfat_int skipLoc = -skip;
-    LTFAT_TYPE* filtRev = LTFAT_NAME(malloc)(gl);
-    LTFAT_NAME(reverse_array)(g, gl, filtRev);
+error:
+    return status;
+}
 
-    ltfat_int glUps = ga * gl - (ga - 1);
+static void
+LTFAT_NAME(td_plan_free)(LTFAT_NAME(convsub_td_plan)* p)
+{
+    LTFAT_SAFEFREEALL(p->g, p->tapphase, p->tapshift, p->extbuf,
+                      p->inbuf, p->outbuf);
+}
 
-    LTFAT_TYPE* righExtbuff = 0;
-    // number of output samples that can be calculated "painlessly"
-    ltfat_int Nsafe = ltfat_imax((L - skipLoc), 0);
+LTFAT_API int
+LTFAT_NAME(convsub_td_init)(const LTFAT_TYPE g[], ltfat_int L, ltfat_int gl,
+                            ltfat_int a, ltfat_int skip, ltfatExtType ext,
+                            LTFAT_NAME(convsub_td_plan)** p)
+{
+    LTFAT_NAME(convsub_td_plan)* pp = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECKMEM( pp = LTFAT_NEW(LTFAT_NAME(convsub_td_plan)) );
+    CHECKSTATUS(
+        LTFAT_NAME(td_plan_init)(g, L, gl, a, 1, skip, ext,
+                                 filterbank_td_size(L, a, gl, skip, ext), 0, pp));
+    *p = pp;
+    return status;
+error:
+    if (pp) LTFAT_NAME(convsub_td_done)(&pp);
+    if (p) *p = NULL;
+    return status;
+}
 
-    // prepare cyclic buf of length of power of two (for effective modulo operations)
-    ltfat_int bufgl = ltfat_nextpow2(glUps);
-    // buf index
-    ltfat_int buffPtr = 0;
+LTFAT_API int
+LTFAT_NAME(atrousconvsub_td_init)(const LTFAT_TYPE g[], ltfat_int L,
+                                  ltfat_int gl, ltfat_int ga, ltfat_int skip,
+                                  ltfatExtType ext,
+                                  LTFAT_NAME(convsub_td_plan)** p)
+{
+    LTFAT_NAME(convsub_td_plan)* pp = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECKMEM( pp = LTFAT_NEW(LTFAT_NAME(convsub_td_plan)) );
+    CHECKSTATUS(
+        LTFAT_NAME(td_plan_init)(g, L, gl, 1, ga, skip, ext, L, 0, pp));
+    *p = pp;
+    return status;
+error:
+    if (pp) LTFAT_NAME(convsub_td_done)(&pp);
+    if (p) *p = NULL;
+    return status;
+}
 
-    // allocating and initializing the cyclic buf
-    LTFAT_TYPE* buf = LTFAT_NAME(calloc)(bufgl);
+LTFAT_API ltfat_int
+LTFAT_NAME(convsub_td_get_outlen)(const LTFAT_NAME(convsub_td_plan)* p)
+{
+    return p->N;
+}
 
-    // pointer for moving in the input data
-    const LTFAT_TYPE* tmpIn = f;
-    LTFAT_TYPE* tmpOut = c;
-    LTFAT_TYPE* tmpg = filtRev;
-    LTFAT_TYPE* tmpBuffPtr = buf;
+LTFAT_API int
+LTFAT_NAME(convsub_td_execute)(const LTFAT_NAME(convsub_td_plan)* p,
+                               const LTFAT_TYPE f[], LTFAT_TYPE c[])
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(f); CHECKNULL(c);
 
-    // fill buf with the initial values from the input signal according to the boundary treatment
-    // last glUps buf samples are filled to keep buffPtr=0
-    LTFAT_NAME(extend_left)(f, L, buf, bufgl, glUps, ext, 1);
+    if (p->N == 0)
+        return status;
 
-    if (Nsafe < L)
-    {
-        // right extension is necessary, additional buf from where to copy
-        righExtbuff = LTFAT_NAME(calloc)(bufgl);
-        /* memset(righExtbuff, 0, bufgl * sizeof(LTFAT_TYPE)); */
-        // store extension in the buf (must be done now to avoid errors when inplace calculation is done)
-        LTFAT_NAME(extend_right)(f, L, righExtbuff, glUps, ext, 1);
-    }
+    LTFAT_NAME(clear_array)(p->extbuf, 2 * p->extbufl);
+    LTFAT_NAME(extend_left)(f, p->L, p->extbuf, p->extbufl, p->extl, p->ext,
+                            p->exta);
+    LTFAT_NAME(extend_right)(f, p->L, p->extbuf + p->extbufl, p->extl, p->ext,
+                             p->exta);
 
-#define ONEOUTSAMPLE                                                    \
-         tmpg = filtRev;                                           \
-         ltfat_int revBufPtr = ltfat_modpow2(buffPtr-glUps,bufgl);             \
-         ltfat_int loop1it = gl+1;                                         \
-	      while(--loop1it)                                              \
-	      {                                                             \
-		     tmpBuffPtr = buf + ltfat_modpow2(revBufPtr,bufgl);          \
-		     revBufPtr+=ga;                                         \
-           *tmpOut += *(tmpBuffPtr) * *(tmpg++);                  \
-         }                                                             \
-         tmpOut++;
-
-
-#define READNEXTDATA(samples,wherePtr)                                              \
-	   buffOver = ltfat_imax(buffPtr+(samples)-bufgl, 0);                               \
-   	memcpy(buf + buffPtr, wherePtr, ((samples)-buffOver)*sizeof(LTFAT_TYPE)); \
-	   memcpy(buf,wherePtr+(samples)-buffOver,buffOver*sizeof(LTFAT_TYPE));      \
-	   buffPtr = ltfat_modpow2(buffPtr += (samples),bufgl);
-
-#define READNEXTSAMPLE(wherePtr)                               \
-   	   *(buf + buffPtr) = *wherePtr;                        \
-	   buffPtr = ltfat_modpow2(++buffPtr,bufgl);
-
-
-    ltfat_int buffOver = 0;
-    /*** initial buf fill ***/
-    ltfat_int sampToRead = ltfat_imin((skipLoc + 1), L);
-    READNEXTDATA(sampToRead, tmpIn);
-    tmpIn += sampToRead;
-
-    /*********** STEP 1: FREE LUNCH ( but also a hot-spot) *******************************/
-    // Take the smaller value from "painless" output length and the user defined output length
-    ltfat_int iiLoops = ltfat_imin(Nsafe - 1, L - 1);
-
-    // loop trough all output samples, omit the very last one.
-    for (ltfat_int ii = 0; ii < iiLoops; ii++)
-    {
-        ONEOUTSAMPLE
-        READNEXTSAMPLE(tmpIn)
-        tmpIn++;
-    }
+    // f is not touched after this, c can be equal to f
+    LTFAT_NAME(td_splitphases)(p, f, p->L);
+    LTFAT_NAME(clear_array)(c, p->N);
 
-    /*********** STEP 2: FINALIZE FREE LUNCH ************************************/
-    if (Nsafe > 0)
+    for (ltfat_int n = 0; n < p->N; n += LTFAT_CONVSUB_TD_BLOCK)
     {
-        ONEOUTSAMPLE
-    }
-    /*********** STEP 3: NOW FOR THE TRICKY PART ************************************/
-    if (Nsafe < L)
-    {
-        /************ STEP 3a: DEALING WITH THE REMAINING SAMPLES ******************/
-        // CAREFULL NOW! possibly stepping outside of input signal
-        // last index in the input signal for which reading next a samples reaches outside of the input signal
-        ltfat_int rightExtBuffIdx = 0;
-        if (Nsafe > 0)
-        {
-            ltfat_int lastInIdx = ((Nsafe - 1) + 1 + skipLoc);
-            rightExtBuffIdx = lastInIdx + 1 - L;
-            ltfat_int diff = ltfat_imax(0, L - lastInIdx);
-            READNEXTDATA(diff, (f + lastInIdx))
-        }
-        else
-        {
-            rightExtBuffIdx = 1 + skipLoc - L;
-        }
-
-        // now copying samples that are outside
-        READNEXTDATA(rightExtBuffIdx, righExtbuff)
+        ltfat_int nlen = ltfat_imin(LTFAT_CONVSUB_TD_BLOCK, p->N - n);
 
-        /************ STEP 3b: ALL OK, proceed reading input values from righExtbuff ******************/
-        // loop for the remaining output samples
-        for (ltfat_int ii = 0; ii < L - Nsafe; ii++)
-        {
-            ONEOUTSAMPLE
-            READNEXTSAMPLE((righExtbuff + rightExtBuffIdx))
-            ++rightExtBuffIdx;
-            //rightExtBuffIdx = ltfat_modpow2(++rightExtBuffIdx,bufgl);
-        }
+        for (ltfat_int j = 0; j < p->gl; j++)
+            LTFAT_NAME(td_axpy)(p->g[j], p->inbuf + p->tapphase[j] * p->inlen +
+                                p->tapshift[j] + n, nlen, c + n);
     }
-
-
-#undef READNEXTDATA
-#undef READNEXTSAMPLE
-#undef ONEOUTSAMPLE
-    LTFAT_SAFEFREEALL(buf, filtRev, righExtbuff);
+error:
+    return status;
 }
 
-LTFAT_API void
-LTFAT_NAME(atrousupconv_td)(const LTFAT_TYPE* c, const LTFAT_TYPE* g,
-                            ltfat_int L, ltfat_int gl,
-                            ltfat_int ga, ltfat_int skip,
-                            LTFAT_TYPE* f, ltfatExtType ext)
+LTFAT_API int
+LTFAT_NAME(convsub_td_done)(LTFAT_NAME(convsub_td_plan)** p)
 {
-    ltfat_int glUps = ga * gl - (ga - 1);
-    ltfat_int skipLoc = -(1 - glUps - skip);
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(*p);
+    LTFAT_NAME(td_plan_free)(*p);
+    ltfat_free(*p);
+    *p = NULL;
+error:
+    return status;
+}
 
-    // Copy, reverse and conjugate the imp resp.
-    LTFAT_TYPE* gInv = LTFAT_NAME(malloc)(gl);
-    memcpy(gInv, g, gl * sizeof * gInv);
-    LTFAT_NAME(reverse_array)(gInv, gl, gInv);
-    LTFAT_NAME(conjugate_array)(gInv, gl, gInv);
+LTFAT_API int
+LTFAT_NAME(upconv_td_init)(const LTFAT_TYPE g[], ltfat_int L, ltfat_int gl,
+                           ltfat_int a, ltfat_int skip, ltfatExtType ext,
+                           LTFAT_NAME(upconv_td_plan)** p)
+{
+    LTFAT_NAME(upconv_td_plan)* pp = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECKMEM( pp = LTFAT_NEW(LTFAT_NAME(upconv_td_plan)) );
+    CHECKSTATUS(
+        LTFAT_NAME(td_plan_init)(g, L, gl, a, 1, skip, ext,
+                                 filterbank_td_size(L, a, gl, skip, ext), 1,
+                                 &pp->inplan));
+    *p = pp;
+    return status;
+error:
+    if (pp) LTFAT_NAME(upconv_td_done)(&pp);
+    if (p) *p = NULL;
+    return status;
+}
 
+LTFAT_API int
+LTFAT_NAME(atrousupconv_td_init)(const LTFAT_TYPE g[], ltfat_int L,
+                                 ltfat_int gl, ltfat_int ga, ltfat_int skip,
+                                 ltfatExtType ext,
+                                 LTFAT_NAME(upconv_td_plan)** p)
+{
+    LTFAT_NAME(upconv_td_plan)* pp = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECKMEM( pp = LTFAT_NEW(LTFAT_NAME(upconv_td_plan)) );
+    CHECKSTATUS(
+        LTFAT_NAME(td_plan_init)(g, L, gl, 1, ga, skip, ext, L, 1, &pp->inplan));
+    *p = pp;
+    return status;
+error:
+    if (pp) LTFAT_NAME(upconv_td_done)(&pp);
+    if (p) *p = NULL;
+    return status;
+}
 
-    // Running output pointer
-    LTFAT_TYPE* tmpOut = f;
-    // Running input pointer
-    LTFAT_TYPE* tmpIn =  (LTFAT_TYPE*) c;
+LTFAT_API ltfat_int
+LTFAT_NAME(upconv_td_get_inlen)(const LTFAT_NAME(upconv_td_plan)* p)
+{
+    return p->inplan.N;
+}
 
-    /** prepare cyclic buf */
-    ltfat_int bufgl = ltfat_nextpow2(glUps);
-    LTFAT_TYPE* buf = LTFAT_NAME(calloc)(bufgl);
-    ltfat_int buffPtr = 0;
+LTFAT_API int
+LTFAT_NAME(upconv_td_execute)(const LTFAT_NAME(upconv_td_plan)* p,
+                              const LTFAT_TYPE c[], LTFAT_TYPE f[])
+{
+    const LTFAT_NAME(convsub_td_plan)* pp = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(c); CHECKNULL(f);
+    pp = &p->inplan;
 
-    ltfat_int iiLoops = 0;
-    ltfat_int remainsOutSamp = L;
-    ltfat_int rightBuffPreLoad = 0;
+    if (pp->N == 0 || pp->inlen == 0)
+        return status;
 
-    if (skipLoc >= L)
-    {
-        rightBuffPreLoad = (skipLoc + 1) - L;
-        skipLoc = L;
-    }
-    else
+    LTFAT_NAME(clear_array)(pp->extbuf, 2 * pp->extbufl);
+    if (pp->ext == PER)
     {
-        iiLoops = ltfat_imin(L - skipLoc, L); // just in case L < L - inSkip
-        remainsOutSamp = L - (iiLoops - 1);
+        LTFAT_NAME(extend_left)(c, pp->N, pp->extbuf, pp->extbufl, pp->extl,
+                                PER, 0);
+        LTFAT_NAME(extend_right)(c, pp->N, pp->extbuf + pp->extbufl, pp->extl,
+                                 PER, 0);
     }
 
-    LTFAT_TYPE* rightbuf = LTFAT_NAME(calloc)(bufgl);
-    LTFAT_TYPE* rightbufTmp = rightbuf;
+    LTFAT_NAME(td_splitphases)(pp, c, pp->N);
 
-    if (ext == PER) // if periodic extension
+    // Output phases are accumulated separately and interleaved at the end
+    LTFAT_TYPE* out = pp->a > 1 ? pp->outbuf : f;
+    ltfat_int outlen = pp->a > 1 ? pp->outlen : pp->L;
+    if (pp->a > 1)
+        LTFAT_NAME(clear_array)(pp->outbuf, pp->a * pp->outlen);
+
+    for (ltfat_int m = 0; m < outlen; m += LTFAT_CONVSUB_TD_BLOCK)
     {
-        LTFAT_NAME(extend_left)(c, L, buf, bufgl, glUps, PER,
-                                0); // extension as a last (tmpgl-1) samples of the buf -> pointer dont have to be moved
-        LTFAT_NAME(extend_right)(c, L, rightbuf, glUps, PER, 0);
+        for (ltfat_int j = 0; j < pp->gl; j++)
+        {
+            ltfat_int q = pp->tapphase[j];
+            // Number of output samples in the q-th phase
+            ltfat_int qlen = ltfat_idivceil(pp->L - q, pp->a);
+            ltfat_int mlen = ltfat_imin(LTFAT_CONVSUB_TD_BLOCK, qlen - m);
+
+            if (mlen > 0)
+                LTFAT_NAME(td_axpy)(pp->g[j], pp->inbuf + m - pp->tapshift[j],
+                                    mlen, out + q * pp->outlen + m);
+        }
     }
 
-    ltfat_int iniStoCopy = ltfat_imin(skipLoc, bufgl);
-    ltfat_int tmpInSkip = ltfat_imax(0, skipLoc - bufgl);
-    memcpy(buf, tmpIn + tmpInSkip, iniStoCopy * sizeof * buf);
-    tmpIn += (iniStoCopy + tmpInSkip);
-    buffPtr = ltfat_modpow2(buffPtr += iniStoCopy, bufgl);
-
+    if (pp->a > 1)
+        for (ltfat_int q = 0; q < pp->a; q++)
+        {
+            const LTFAT_TYPE* outq = pp->outbuf + q * pp->outlen;
+            for (ltfat_int m = 0; q + pp->a * m < pp->L; m++)
+                f[q + pp->a * m] += outq[m];
+        }
 
-//LTFAT_TYPE* filtTmp = g;
-#define ONEOUTSAMPLE(filtTmp,jjLoops)                                   \
-	    for(ltfat_int jj=0;jj<(jjLoops);jj++)                                  \
-		    {                                                            \
-				ltfat_int idx = ltfat_modpow2((-jj*ga+buffPtr-1), bufgl);      \
-				*tmpOut += *(buf+idx) * *((filtTmp) + jj);            \
-		    }                                                            \
-	    tmpOut++;
+error:
+    return status;
+}
 
-#define READNEXTSAMPLE(wherePtr)                               \
-   	   *(buf + buffPtr) = *(wherePtr);                      \
-	   buffPtr = ltfat_modpow2(++buffPtr,bufgl);
+LTFAT_API int
+LTFAT_NAME(upconv_td_done)(LTFAT_NAME(upconv_td_plan)** p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(*p);
+    LTFAT_NAME(td_plan_free)(&(*p)->inplan);
+    ltfat_free(*p);
+    *p = NULL;
+error:
+    return status;
+}
 
+/* Creates the plans of all M channels. If one of them fails, the ones
+ * created so far are destroyed, the filterbanks then return without
+ * touching their output. */
+static LTFAT_NAME(convsub_td_plan)**
+LTFAT_NAME(convsub_td_initall)(const LTFAT_TYPE* g[], ltfat_int L,
+                               ltfat_int gl[], ltfat_int a[], ltfat_int skip[],
+                               ltfat_int M, ltfatExtType ext, int atrous)
+{
+    LTFAT_NAME(convsub_td_plan)** p =
+        LTFAT_NEWARRAY(LTFAT_NAME(convsub_td_plan)*, M);
+    if (!p) return NULL;
 
-    /** STEP 2: MAIN LOOP */
-    if (iiLoops > 0)
+    for (ltfat_int m = 0; m < M; m++)
     {
-        for (ltfat_int ii = 0; ii < iiLoops - 1; ii++)
+        int status = atrous ?
+                     LTFAT_NAME(atrousconvsub_td_init)(g[m], L, gl[m], a[m],
+                             skip[m], ext, &p[m]) :
+                     LTFAT_NAME(convsub_td_init)(g[m], L, gl[m], a[m], skip[m],
+                             ext, &p[m]);
+        if (status)
         {
-            READNEXTSAMPLE(tmpIn)
-            tmpIn++;
-            ONEOUTSAMPLE(gInv, gl)
+            for (ltfat_int mm = 0; mm < m; mm++)
+                LTFAT_NAME(convsub_td_done)(&p[mm]);
+            ltfat_free(p);
+            return NULL;
         }
-        READNEXTSAMPLE(tmpIn)
-        //tmpIn++;
-    }
-
-
-    /** STEP 3b: load samples from right buf */
-    while (rightBuffPreLoad--)
-    {
-        READNEXTSAMPLE((rightbufTmp))
-        rightbufTmp++;
     }
+    return p;
+}
 
+static LTFAT_NAME(upconv_td_plan)**
+LTFAT_NAME(upconv_td_initall)(const LTFAT_TYPE* g[], ltfat_int L,
+                              ltfat_int gl[], ltfat_int a[], ltfat_int skip[],
+                              ltfat_int M, ltfatExtType ext, int atrous)
+{
+    LTFAT_NAME(upconv_td_plan)** p =
+        LTFAT_NEWARRAY(LTFAT_NAME(upconv_td_plan)*, M);
+    if (!p) return NULL;
 
-    /*
-    STEP 3b: calculate remaining output samples,
-    Again, there can be shift/up misaligment thne shift>L
-    */
-
-    for (ltfat_int ii = 0; ii < remainsOutSamp; ii++)
+    for (ltfat_int m = 0; m < M; m++)
     {
-        if (ii != 0)
+        int status = atrous ?
+                     LTFAT_NAME(atrousupconv_td_init)(g[m], L, gl[m], a[m],
+                             skip[m], ext, &p[m]) :
+                     LTFAT_NAME(upconv_td_init)(g[m], L, gl[m], a[m], skip[m],
+                             ext, &p[m]);
+        if (status)
         {
-            READNEXTSAMPLE((rightbufTmp))
-            rightbufTmp++;
+            for (ltfat_int mm = 0; mm < m; mm++)
+                LTFAT_NAME(upconv_td_done)(&p[mm]);
+            ltfat_free(p);
+            return NULL;
         }
-        ONEOUTSAMPLE((gInv), (gl))
     }
-
-#undef READNEXTDATA
-#undef ONEOUTSAMPLE
-    LTFAT_SAFEFREEALL(buf, rightbuf, gInv);
+    return p;
 }
 
-
 LTFAT_API void
-LTFAT_NAME(convsub_td)(const LTFAT_TYPE* f, const LTFAT_TYPE* g, ltfat_int L,
-                       ltfat_int gl, ltfat_int a, ltfat_int skip,
-                       LTFAT_TYPE* c, ltfatExtType ext)
+LTFAT_NAME(atrousfilterbank_td)(const LTFAT_TYPE* f, const LTFAT_TYPE* g[],
+                                ltfat_int L, ltfat_int gl[],
+                                ltfat_int W, ltfat_int a[],
+                                ltfat_int skip[], ltfat_int M,
+                                LTFAT_TYPE* c, ltfatExtType ext)
 {
-    ltfat_int N = filterbank_td_size(L, a, gl, skip, ext);
-    // Since c is used as an accu
-    LTFAT_NAME(clear_array)(c, N);//memset(c, 0, N * sizeof * c);
-    // Reverse and conjugate the filter
-    LTFAT_TYPE* filtRev = LTFAT_NAME(malloc)(gl);
-    LTFAT_NAME(reverse_array)(g, gl, filtRev);
-
-    LTFAT_TYPE* righExtbuff = 0;
-    // number of output samples that can be calculated "painlessly"
-    ltfat_int Nsafe = ltfat_imax((L + skip + a - 1) / a, 0);
-
-    // prepare cyclic buf of length of power of two (for effective modulo operations)
-    ltfat_int bufgl = ltfat_nextpow2(ltfat_imax(gl, a + 1));
-    // buf index
-    ltfat_int buffPtr = 0;
-
-    // allocating and initializing the cyclic buf
-    LTFAT_TYPE* buf = LTFAT_NAME(calloc)(bufgl);
-
-    // pointer for moving in the input data
-    const LTFAT_TYPE* tmpIn = f;
-    LTFAT_TYPE* tmpOut = c;
-    LTFAT_TYPE* tmpg = filtRev;
-    LTFAT_TYPE* tmpBuffPtr = buf;
-
-    // fill buf with the initial values from the input signal according to the boundary treatment
-    // last glUps buf samples are filled to keep buffPtr=0
-    LTFAT_NAME(extend_left)(f, L, buf, bufgl, gl, ext, a);
-
-    if (Nsafe < N)
-    {
-        // right extension is necessary, additional buf from where to copy
-        righExtbuff = LTFAT_NAME(calloc)(bufgl);
-        // store extension in the buf (must be done now to avoid errors when inplace calculation is done)
-        LTFAT_NAME(extend_right)(f, L, righExtbuff, gl, ext, a);
-    }
-
-#define ONEOUTSAMPLE                                                    \
-          tmpg = filtRev;                                           \
-          ltfat_int revBufPtr = ltfat_modpow2(buffPtr-gl,bufgl);                \
-          ltfat_int loop1it = gl+1;                                         \
-	      while(--loop1it)                                              \
-	      {                                                             \
-		     tmpBuffPtr = buf + ltfat_modpow2(revBufPtr++,bufgl);        \
-             *tmpOut += *(tmpBuffPtr) * *(tmpg++);                  \
-          }                                                             \
-          tmpOut++;
-
-
-
-#define READNEXTDATA(samples,wherePtr)                                              \
-	   buffOver = ltfat_imax(buffPtr+(samples)-bufgl, 0);                               \
-   	memcpy(buf + buffPtr, wherePtr, ((samples)-buffOver)*sizeof*buf); \
-	   memcpy(buf,wherePtr+(samples)-buffOver,buffOver*sizeof*buf);      \
-	   buffPtr = ltfat_modpow2(buffPtr += (samples),bufgl);
-
-
-    ltfat_int buffOver = 0;
-    /*** initial buf fill ***/
-    ltfat_int sampToRead = ltfat_imin((-skip + 1), L);
-    READNEXTDATA(sampToRead, tmpIn);
-    tmpIn += sampToRead;
+    LTFAT_NAME(convsub_td_plan)** p =
+        LTFAT_NAME(convsub_td_initall)(g, L, gl, a, skip, M, ext, 1);
+    if (!p) return;
 
-    /*********** STEP 1: FREE LUNCH ( but also a hot-spot) *******************************/
-    // Take the smaller value from "painless" output length and the user defined output length
-    ltfat_int iiLoops = ltfat_imin(Nsafe - 1, N - 1);
-
-    // loop trough all output samples, omit the very last one.
-    for (ltfat_int ii = 0; ii < iiLoops; ii++)
+    for (ltfat_int m = 0; m < M; m++)
     {
-        ONEOUTSAMPLE
-        READNEXTDATA(a, tmpIn)
-        tmpIn += a;
-    }
+        for (ltfat_int w = 0; w < W; w++)
+            LTFAT_NAME(convsub_td_execute)(p[m], f + w * L, c + w * M * L + m * L);
 
-    /*********** STEP 2: FINALIZE FREE LUNCH ************************************/
-    if (Nsafe > 0)
-    {
-        ONEOUTSAMPLE
+        LTFAT_NAME(convsub_td_done)(&p[m]);
     }
-    /*********** STEP 3: NOW FOR THE TRICKY PART ************************************/
-    if (Nsafe < N)
-    {
-        /************ STEP 3a: DEALING WITH THE REMAINING SAMPLES ******************/
-        // CAREFULL NOW! possibly stepping outside of input signal
-        // last index in the input signal for which reading next a samples reaches outside of the input signal
-        ltfat_int rightExtBuffIdx = 0;
-        if (Nsafe > 0)
-        {
-            ltfat_int lastInIdx = (a * (Nsafe - 1) + 1 - skip);
-            rightExtBuffIdx = lastInIdx + a - L;
-            ltfat_int diff = ltfat_imax(0, L - lastInIdx);
-            READNEXTDATA(diff, (f + lastInIdx))
-        }
-        else
-        {
-            rightExtBuffIdx = 1 - skip - L;
-        }
+    ltfat_free(p);
+}
 
-        // now copying samples that are outside
-        READNEXTDATA(rightExtBuffIdx, righExtbuff)
+LTFAT_API void
+LTFAT_NAME(iatrousfilterbank_td)(const LTFAT_TYPE* c, const LTFAT_TYPE* g[],
+                                 ltfat_int L, ltfat_int gl[],
+                                 ltfat_int W, ltfat_int a[],
+                                 ltfat_int skip[], ltfat_int M,
+                                 LTFAT_TYPE* f, ltfatExtType ext)
+{
+    LTFAT_NAME(upconv_td_plan)** p =
+        LTFAT_NAME(upconv_td_initall)(g, L, gl, a, skip, M, ext, 1);
+    if (!p) return;
 
-        /************ STEP 3b: ALL OK, proceed reading input values from righExtbuff ******************/
-        // loop for the remaining output samples
-        for (ltfat_int ii = 0; ii < N - Nsafe; ii++)
-        {
-            ONEOUTSAMPLE
-            READNEXTDATA(a, (righExtbuff + rightExtBuffIdx))
-            rightExtBuffIdx = ltfat_modpow2(rightExtBuffIdx += a, bufgl);
-        }
-    }
+    // Set output array to zeros, since the array is used as an accumulator
+    LTFAT_NAME(clear_array)(f, L * W);
 
+    for (ltfat_int m = 0; m < M; m++)
+    {
+        for (ltfat_int w = 0; w < W; w++)
+            LTFAT_NAME(upconv_td_execute)(p[m], c + w * M * L + m * L, f + w * L);
 
-#undef READNEXTDATA
-#undef ONEOUTSAMPLE
-    LTFAT_SAFEFREEALL(buf, filtRev, righExtbuff);
+        LTFAT_NAME(upconv_td_done)(&p[m]);
+    }
+    ltfat_free(p);
 }
 
 
 LTFAT_API void
-LTFAT_NAME(upconv_td)(const LTFAT_TYPE* c, const LTFAT_TYPE* g, ltfat_int L,
-                      ltfat_int gl, ltfat_int a, ltfat_int skip,
-                      LTFAT_TYPE* f, ltfatExtType ext)
+LTFAT_NAME(filterbank_td)(const LTFAT_TYPE* f, const LTFAT_TYPE* g[],
+                          ltfat_int L, ltfat_int gl[],
+                          ltfat_int W, ltfat_int a[],
+                          ltfat_int skip[], ltfat_int M,
+                          LTFAT_TYPE* c[], ltfatExtType ext)
 {
-    ltfat_int N = filterbank_td_size(L, a, gl, skip, ext);
-
-    // Copy, reverse and conjugate the imp resp.
-    LTFAT_TYPE* gInv = LTFAT_NAME(malloc)(gl);
-    memcpy(gInv, g, gl * sizeof * gInv);
-    LTFAT_NAME(reverse_array)(gInv, gl, gInv);
-    LTFAT_NAME(conjugate_array)(gInv, gl, gInv);
-    ltfat_int skipRev = -(1 - gl - skip);
-
-    // Running output pointer
-    LTFAT_TYPE* tmpOut = f;
-    // Running input pointer
-    const LTFAT_TYPE* tmpIn =  c;
-
-    /** prepare cyclic buf */
-    ltfat_int bufgl = ltfat_nextpow2(gl);
-    LTFAT_TYPE* buf = LTFAT_NAME(calloc)(bufgl);
-    ltfat_int buffPtr = 0;
-
-    ltfat_int inSkip = (skipRev + a - 1) / a;
-    ltfat_int skipModUp = skipRev % a;
-    ltfat_int skipToNextUp = 0;
-    if (skipModUp != 0)  skipToNextUp = a - skipModUp;
-    ltfat_int outAlign = 0;
-
-    ltfat_int iiLoops = 0;
-    ltfat_int uuLoops = 0;
-    ltfat_int remainsOutSamp = L;
-    ltfat_int rightBuffPreLoad = 0;
-
-    if (inSkip >= N)
-    {
-        inSkip = N;
-        outAlign = skipModUp;
-        rightBuffPreLoad = (skipRev + 1 + a - 1) / a - N;
-    }
-    else
-    {
-        uuLoops = skipToNextUp;
-        iiLoops = ltfat_imin(N - inSkip,
-                             (L - skipToNextUp + a - 1) / a); // just in case L/a < N - inSkip
-        remainsOutSamp = L - (uuLoops + (iiLoops - 1) * a);
-    }
-
-    LTFAT_TYPE* rightbuf = LTFAT_NAME(calloc)(bufgl);
-    LTFAT_TYPE* rightbufTmp = rightbuf;
+    LTFAT_NAME(convsub_td_plan)** p =
+        LTFAT_NAME(convsub_td_initall)(g, L, gl, a, skip, M, ext, 0);
+    if (!p) return;
 
-    if (ext == PER) // if periodic extension
+    for (ltfat_int m = 0; m < M; m++)
     {
-        LTFAT_NAME(extend_left)(c, N, buf, bufgl, gl, PER,
-                                0); // extension as a last (tmpgl-1) samples of the buf -> pointer dont have to be moved
-        LTFAT_NAME(extend_right)(c, N, rightbuf, gl, PER, 0);
-    }
-
-    ltfat_int iniStoCopy = ltfat_imin(inSkip, bufgl);
-    ltfat_int tmpInSkip = ltfat_imax(0, inSkip - bufgl);
-    memcpy(buf, tmpIn + tmpInSkip, iniStoCopy * sizeof * buf);
-    tmpIn += (iniStoCopy + tmpInSkip);
-    buffPtr = ltfat_modpow2(buffPtr += iniStoCopy, bufgl);
-
+        ltfat_int N = LTFAT_NAME(convsub_td_get_outlen)(p[m]);
+        for (ltfat_int w = 0; w < W; w++)
+            LTFAT_NAME(convsub_td_execute)(p[m], f + w * L, c[m] + w * N);
 
+        LTFAT_NAME(convsub_td_done)(&p[m]);
+    }
+    ltfat_free(p);
+}
 
-#define ONEOUTSAMPLE(filtTmp,jjLoops)                                   \
-	    for(ltfat_int jj=0;jj<(jjLoops);jj++)                                  \
-		    {                                                            \
-				ltfat_int idx = ltfat_modpow2((-jj+buffPtr-1), bufgl);             \
-				*tmpOut += *(buf+idx) * *((filtTmp) +(jj*a));        \
-		    }                                                            \
-	    tmpOut++;
 
-#define READNEXTSAMPLE(wherePtr)                               \
-   	   *(buf + buffPtr) = *(wherePtr);                      \
-	   buffPtr = ltfat_modpow2(++buffPtr,bufgl);
+LTFAT_API void
+LTFAT_NAME(ifilterbank_td)(const LTFAT_TYPE* c[], const LTFAT_TYPE* g[],
+                           ltfat_int L, ltfat_int gl[],
+                           ltfat_int W, ltfat_int a[],
+                           ltfat_int skip[], ltfat_int M,
+                           LTFAT_TYPE* f, ltfatExtType ext)
+{
+    LTFAT_NAME(upconv_td_plan)** p =
+        LTFAT_NAME(upconv_td_initall)(g, L, gl, a, skip, M, ext, 0);
+    if (!p) return;
 
+    /* memset(f, 0, L * W * sizeof * f); */
+    LTFAT_NAME(clear_array)(f, L * W);
 
-    /** STEP 1: Deal with the shift - upsampling misaligment */
-    for (ltfat_int uu = 0; uu < uuLoops; uu++)
+    for (ltfat_int m = 0; m < M; m++)
     {
-        ONEOUTSAMPLE((gInv + skipModUp + uu), ((gl - (skipModUp + uu) + a - 1) / a))
-    }
+        ltfat_int N = LTFAT_NAME(upconv_td_get_inlen)(p[m]);
+        for (ltfat_int w = 0; w < W; w++)
+            LTFAT_NAME(upconv_td_execute)(p[m], c[m] + w * N, f + w * L);
 
-    /** STEP 2: MAIN LOOP */
-    if (iiLoops > 0)
-    {
-        for (ltfat_int ii = 0; ii < iiLoops - 1; ii++)
-        {
-            READNEXTSAMPLE(tmpIn)
-            tmpIn++;
-            for (ltfat_int uu = 0; uu < a; uu++)
-            {
-                ONEOUTSAMPLE((gInv + uu), ((gl - uu + a - 1) / a))
-            }
-        }
-        READNEXTSAMPLE(tmpIn)
-        tmpIn++;
+        LTFAT_NAME(upconv_td_done)(&p[m]);
     }
+    ltfat_free(p);
+}
 
 
-    /** STEP 3b: load samples from right buf */
-    while (rightBuffPreLoad--)
-    {
-        READNEXTSAMPLE((rightbufTmp))
-        rightbufTmp++;
-    }
-
+LTFAT_API void
+LTFAT_NAME(atrousconvsub_td)(const LTFAT_TYPE* f, const LTFAT_TYPE* g,
+                             ltfat_int L, ltfat_int gl, ltfat_int ga,
+                             ltfat_int skip, LTFAT_TYPE* c, ltfatExtType ext)
+{
+    LTFAT_NAME(convsub_td_plan)* p = NULL;
+    if (LTFAT_NAME(atrousconvsub_td_init)(g, L, gl, ga, skip, ext, &p))
+        return;
+    LTFAT_NAME(convsub_td_execute)(p, f, c);
+    LTFAT_NAME(convsub_td_done)(&p);
+}
 
-    /*
-    STEP 3b: calculate remaining output samples,
-    Again, there can be shift/a misaligment thne shift>L
-    */
+LTFAT_API void
+LTFAT_NAME(atrousupconv_td)(const LTFAT_TYPE* c, const LTFAT_TYPE* g,
+                            ltfat_int L, ltfat_int gl,
+                            ltfat_int ga, ltfat_int skip,
+                            LTFAT_TYPE* f, ltfatExtType ext)
+{
+    LTFAT_NAME(upconv_td_plan)* p = NULL;
+    if (LTFAT_NAME(atrousupconv_td_init)(g, L, gl, ga, skip, ext, &p))
+        return;
+    LTFAT_NAME(upconv_td_execute)(p, c, f);
+    LTFAT_NAME(upconv_td_done)(&p);
+}
 
-    for (ltfat_int ii = outAlign; ii < remainsOutSamp + outAlign; ii++)
-    {
-        if (ii != outAlign && ii % a == 0)
-        {
-            READNEXTSAMPLE((rightbufTmp))
-            rightbufTmp++;
-        }
-        ONEOUTSAMPLE((gInv + ii % a), ((gl - ii % a + a - 1) / a))
-    }
 
-#undef ONEOUTSAMPLE
-#undef READNEXTSAMPLE
-    LTFAT_SAFEFREEALL(buf, rightbuf, gInv);
+LTFAT_API void
+LTFAT_NAME(convsub_td)(const LTFAT_TYPE* f, const LTFAT_TYPE* g, ltfat_int L,
+                       ltfat_int gl, ltfat_int a, ltfat_int skip,
+                       LTFAT_TYPE* c, ltfatExtType ext)
+{
+    LTFAT_NAME(convsub_td_plan)* p = NULL;
+    if (LTFAT_NAME(convsub_td_init)(g, L, gl, a, skip, ext, &p))
+        return;
+    LTFAT_NAME(convsub_td_execute)(p, f, c);
+    LTFAT_NAME(convsub_td_done)(&p);
 }
 
 
-
+LTFAT_API void
+LTFAT_NAME(upconv_td)(const LTFAT_TYPE* c, const LTFAT_TYPE* g, ltfat_int L,
+                      ltfat_int gl, ltfat_int a, ltfat_int skip,
+                      LTFAT_TYPE* f, ltfatExtType ext)
+{
+    LTFAT_NAME(upconv_td_plan)* p = NULL;
+    if (LTFAT_NAME(upconv_td_init)(g, L, gl, a, skip, ext, &p))
+        return;
+    LTFAT_NAME(upconv_td_execute)(p, c, f);
+    LTFAT_NAME(upconv_td_done)(&p);
+}
 
 
 // fills last buf samples
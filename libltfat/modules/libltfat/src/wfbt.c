@@ -0,0 +1,455 @@
+#include "ltfat.h"
+#include "ltfat/types.h"
+#include "ltfat/macros.h"
+#include "wfbt_private.h"
+
+/* The data of a channel live either in the output array (an output
+ * channel) or, if the channel has a node attached and is not an output, in
+ * a per-worker intermediate buffer. For the synthesis with packets, the
+ * channels with a node attached are outputs and need a buffer, the
+ * reconstruction of the child is added to a copy of them.
+ */
+struct LTFAT_NAME(wfbt_plan)
+{
+    ltfat_int L;
+    ltfat_int W;
+    ltfat_wfbt_tree t;
+    int synthesis;
+    ltfat_int* chlen;    //!< Length of a channel
+    ltfat_int workers;
+    // Per worker
+    LTFAT_NAME(convsub_td_plan)*** ana;  //!< workers x chNo, analysis
+    LTFAT_NAME(upconv_td_plan)*** syn;   //!< workers x chNo, synthesis
+    LTFAT_TYPE*** buf;                   //!< workers x chNo, NULL if unused
+    ltfat_threadpool* pool;
+    // Valid during execute
+    const LTFAT_TYPE* fin;
+    LTFAT_TYPE** cout;
+    const LTFAT_TYPE** cin;
+    LTFAT_TYPE* fout;
+};
+
+struct LTFAT_NAME(iwfbt_plan)
+{
+    struct LTFAT_NAME(wfbt_plan) p;
+};
+
+int
+LTFAT_NAME(wfbt_tree_init)(const LTFAT_NAME(wfbt_node) nodes[],
+                           ltfat_int nodesNo, int flags, ltfat_wfbt_tree* t)
+{
+    int status = LTFATERR_SUCCESS;
+    int packets = flags & LTFAT_WFBT_PACKETS;
+    int intflags = flags & (LTFAT_WFBT_INTSCALE | LTFAT_WFBT_INTSQRT);
+    CHECKNULL(nodes);
+    CHECK(LTFATERR_NOTPOSARG, nodesNo > 0, "nodesNo must be positive");
+    CHECK(LTFATERR_BADARG,
+          !(flags & ~(LTFAT_WFBT_PACKETS | LTFAT_WFBT_UNDECIMATED |
+                      LTFAT_WFBT_INTSCALE | LTFAT_WFBT_INTSQRT)),
+          "Unknown flags");
+    CHECK(LTFATERR_BADARG,
+          intflags != (LTFAT_WFBT_INTSCALE | LTFAT_WFBT_INTSQRT),
+          "Only one interscaling flag can be used");
+    CHECK(LTFATERR_BADARG, !intflags || packets,
+          "Interscaling requires LTFAT_WFBT_PACKETS");
+
+    t->nodesNo = nodesNo; t->flags = flags;
+    t->interscaling = flags & LTFAT_WFBT_INTSCALE ? 0.5 :
+                      flags & LTFAT_WFBT_INTSQRT ? 1.0 / sqrt(2.0) : 1.0;
+
+    CHECKMEM( t->chstart = LTFAT_NEWARRAY(ltfat_int, nodesNo + 1) );
+    CHECKMEM( t->nodein = LTFAT_NEWARRAY(ltfat_int, nodesNo) );
+    CHECKMEM( t->ups = LTFAT_NEWARRAY(ltfat_int, nodesNo) );
+
+    for (ltfat_int n = 0; n < nodesNo; n++)
+    {
+        const LTFAT_NAME(wfbt_node)* nd = nodes + n;
+        CHECK(LTFATERR_NOTPOSARG, nd->M > 0, "Node %td: M must be positive", n);
+        CHECK(LTFATERR_NULLPOINTER, nd->g && nd->gl && nd->a && nd->offset,
+              "Node %td: g, gl, a or offset is NULL", n);
+        if (n == 0)
+            CHECK(LTFATERR_BADARG, nd->parent == -1, "Node 0 must be the root");
+        else
+            CHECK(LTFATERR_BADARG, nd->parent >= 0 && nd->parent < n &&
+                  nd->parentch >= 0 && nd->parentch < nodes[nd->parent].M,
+                  "Node %td: parent must be an earlier node", n);
+
+        t->chstart[n + 1] = t->chstart[n] + nd->M;
+    }
+    t->chNo = t->chstart[nodesNo];
+
+    CHECKMEM( t->chout = LTFAT_NEWARRAY(ltfat_int, t->chNo) );
+    CHECKMEM( t->chchild = LTFAT_NEWARRAY(ltfat_int, t->chNo) );
+    CHECKMEM( t->outch = LTFAT_NEWARRAY(ltfat_int, t->chNo) );
+
+    for (ltfat_int ch = 0; ch < t->chNo; ch++)
+        t->chchild[ch] = -1;
+
+    t->nodein[0] = -1; t->ups[0] = 1;
+    for (ltfat_int n = 1; n < nodesNo; n++)
+    {
+        const LTFAT_NAME(wfbt_node)* nd = nodes + n;
+        ltfat_int ch = t->chstart[nd->parent] + nd->parentch;
+        CHECK(LTFATERR_BADARG, t->chchild[ch] < 0,
+              "Node %td: channel %td of node %td already has a node attached",
+              n, nd->parentch, nd->parent);
+        t->chchild[ch] = n;
+        t->nodein[n] = ch;
+        t->ups[n] = t->ups[nd->parent] * nodes[nd->parent].a[nd->parentch];
+    }
+
+    t->outNo = 0;
+    for (ltfat_int ch = 0; ch < t->chNo; ch++)
+    {
+        if (packets || t->chchild[ch] < 0)
+        {
+            t->outch[t->outNo] = ch;
+            t->chout[ch] = t->outNo++;
+        }
+        else
+            t->chout[ch] = -1;
+    }
+
+error:
+    return status;
+}
+
+void
+LTFAT_NAME(wfbt_tree_free)(ltfat_wfbt_tree* t)
+{
+    LTFAT_SAFEFREEALL(t->chstart, t->chout, t->chchild, t->nodein, t->outch,
+                      t->ups);
+}
+
+static void
+LTFAT_NAME(wfbt_scale)(LTFAT_TYPE* in, ltfat_int L, LTFAT_REAL s)
+{
+    for (ltfat_int ii = 0; ii < L; ii++)
+        in[ii] *= s;
+}
+
+static int
+LTFAT_NAME(wfbt_plan_init)(const LTFAT_NAME(wfbt_node) nodes[],
+                           ltfat_int nodesNo, ltfat_int L, ltfat_int W,
+                           ltfatExtType ext, int flags, ltfat_int nthreads,
+                           int synthesis, struct LTFAT_NAME(wfbt_plan)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    ltfat_wfbt_tree* t = &p->t;
+    int undec = flags & LTFAT_WFBT_UNDECIMATED;
+    CHECK(LTFATERR_NOTPOSARG, L > 0, "L must be positive");
+    CHECK(LTFATERR_NOTPOSARG, W > 0, "W must be positive");
+    CHECK(LTFATERR_NOTPOSARG, nthreads >= 0, "nthreads must not be negative");
+    CHECK(LTFATERR_BADARG, ext >= PER && ext < BAD_TYPE, "Invalid ext");
+    CHECKSTATUS( LTFAT_NAME(wfbt_tree_init)(nodes, nodesNo, flags, t));
+
+    p->L = L; p->W = W; p->synthesis = synthesis;
+
+    CHECKMEM( p->chlen = LTFAT_NEWARRAY(ltfat_int, t->chNo) );
+
+    for (ltfat_int n = 0; n < nodesNo; n++)
+    {
+        const LTFAT_NAME(wfbt_node)* nd = nodes + n;
+        ltfat_int Lin = n == 0 ? L : p->chlen[t->nodein[n]];
+        CHECK(LTFATERR_BADARG, Lin > 0,
+              "Node %td: the input would be empty", n);
+
+        for (ltfat_int k = 0; k < nd->M; k++)
+            p->chlen[t->chstart[n] + k] =
+                undec ? L : filterbank_td_size(Lin, nd->a[k], nd->gl[k],
+                                               nd->offset[k], ext);
+    }
+
+    nthreads = nthreads == 0 ? ltfat_threadpool_get_nprocs() : nthreads;
+    CHECKSTATUS( ltfat_threadpool_init(ltfat_imin(nthreads, W), &p->pool));
+    p->workers = ltfat_threadpool_get_nthreads(p->pool);
+
+    if (synthesis)
+        CHECKMEM( p->syn = LTFAT_NEWARRAY(LTFAT_NAME(upconv_td_plan)**, p->workers));
+    else
+        CHECKMEM( p->ana = LTFAT_NEWARRAY(LTFAT_NAME(convsub_td_plan)**, p->workers));
+    CHECKMEM( p->buf = LTFAT_NEWARRAY(LTFAT_TYPE**, p->workers));
+
+    for (ltfat_int w = 0; w < p->workers; w++)
+    {
+        if (synthesis)
+            CHECKMEM( p->syn[w] = LTFAT_NEWARRAY(LTFAT_NAME(upconv_td_plan)*, t->chNo));
+        else
+            CHECKMEM( p->ana[w] = LTFAT_NEWARRAY(LTFAT_NAME(convsub_td_plan)*, t->chNo));
+        CHECKMEM( p->buf[w] = LTFAT_NEWARRAY(LTFAT_TYPE*, t->chNo));
+
+        for (ltfat_int n = 0; n < nodesNo; n++)
+        {
+            const LTFAT_NAME(wfbt_node)* nd = nodes + n;
+            ltfat_int Lin = n == 0 ? L : p->chlen[t->nodein[n]];
+            ltfat_int ups = t->ups[n];
+
+            for (ltfat_int k = 0; k < nd->M; k++)
+            {
+                ltfat_int ch = t->chstart[n] + k;
+                CHECKNULL(nd->g[k]);
+
+                if (synthesis && undec)
+                    CHECKSTATUS(
+                        LTFAT_NAME(atrousupconv_td_init)(
+                            nd->g[k], L, nd->gl[k], ups,
+                            ups * nd->offset[k], ext, &p->syn[w][ch]));
+                else if (synthesis)
+                    CHECKSTATUS(
+                        LTFAT_NAME(upconv_td_init)(
+                            nd->g[k], Lin, nd->gl[k], nd->a[k],
+                            nd->offset[k], ext, &p->syn[w][ch]));
+                else if (undec)
+                    CHECKSTATUS(
+                        LTFAT_NAME(atrousconvsub_td_init)(
+                            nd->g[k], L, nd->gl[k], ups,
+                            ups * nd->offset[k], ext, &p->ana[w][ch]));
+                else
+                    CHECKSTATUS(
+                        LTFAT_NAME(convsub_td_init)(
+                            nd->g[k], Lin, nd->gl[k], nd->a[k],
+                            nd->offset[k], ext, &p->ana[w][ch]));
+
+                if (t->chchild[ch] >= 0 && (synthesis || t->chout[ch] < 0))
+                    CHECKMEM( p->buf[w][ch] = LTFAT_NAME(malloc)(p->chlen[ch]));
+            }
+        }
+    }
+
+error:
+    return status;
+}
+
+static void
+LTFAT_NAME(wfbt_plan_free)(struct LTFAT_NAME(wfbt_plan)* p)
+{
+    for (ltfat_int w = 0; w < p->workers; w++)
+    {
+        for (ltfat_int ch = 0; ch < p->t.chNo; ch++)
+        {
+            if (p->ana && p->ana[w] && p->ana[w][ch])
+                LTFAT_NAME(convsub_td_done)(&p->ana[w][ch]);
+            if (p->syn && p->syn[w] && p->syn[w][ch])
+                LTFAT_NAME(upconv_td_done)(&p->syn[w][ch]);
+            if (p->buf && p->buf[w]) ltfat_safefree(p->buf[w][ch]);
+        }
+        if (p->ana) ltfat_safefree(p->ana[w]);
+        if (p->syn) ltfat_safefree(p->syn[w]);
+        if (p->buf) ltfat_safefree(p->buf[w]);
+    }
+
+    if (p->pool) ltfat_threadpool_done(&p->pool);
+    LTFAT_SAFEFREEALL(p->ana, p->syn, p->buf, p->chlen);
+    LTFAT_NAME(wfbt_tree_free)(&p->t);
+}
+
+/* Data of the channel ch for the signal channel w */
+static LTFAT_TYPE*
+LTFAT_NAME(wfbt_chdata)(struct LTFAT_NAME(wfbt_plan)* p, ltfat_int ch,
+                        ltfat_int w, ltfat_int workerid)
+{
+    if (p->buf[workerid][ch])
+        return p->buf[workerid][ch];
+
+    if (p->synthesis)
+        return (LTFAT_TYPE*) p->cin[p->t.chout[ch]] + w * p->chlen[ch];
+
+    return p->cout[p->t.chout[ch]] + w * p->chlen[ch];
+}
+
+static void
+LTFAT_NAME(wfbt_task)(void* userdata, ltfat_int w, ltfat_int workerid)
+{
+    struct LTFAT_NAME(wfbt_plan)* p = (struct LTFAT_NAME(wfbt_plan)*) userdata;
+
+    for (ltfat_int n = 0; n < p->t.nodesNo; n++)
+    {
+        const LTFAT_TYPE* in = n == 0 ? p->fin + w * p->L :
+                               LTFAT_NAME(wfbt_chdata)(p, p->t.nodein[n], w, workerid);
+
+        for (ltfat_int ch = p->t.chstart[n]; ch < p->t.chstart[n + 1]; ch++)
+        {
+            LTFAT_TYPE* out = LTFAT_NAME(wfbt_chdata)(p, ch, w, workerid);
+            LTFAT_NAME(convsub_td_execute)(p->ana[workerid][ch], in, out);
+
+            // Packets: the input of the child is scaled together with the output
+            if (p->t.chchild[ch] >= 0 && p->t.interscaling != 1.0)
+                LTFAT_NAME(wfbt_scale)(out, p->chlen[ch], p->t.interscaling);
+        }
+    }
+}
+
+static void
+LTFAT_NAME(iwfbt_task)(void* userdata, ltfat_int w, ltfat_int workerid)
+{
+    struct LTFAT_NAME(wfbt_plan)* p = (struct LTFAT_NAME(wfbt_plan)*) userdata;
+    int packets = p->t.flags & LTFAT_WFBT_PACKETS;
+    LTFAT_TYPE* f = p->fout + w * p->L;
+
+    for (ltfat_int ch = 0; ch < p->t.chNo; ch++)
+    {
+        LTFAT_TYPE* b = p->buf[workerid][ch];
+        if (b && packets)
+            memcpy(b, p->cin[p->t.chout[ch]] + w * p->chlen[ch],
+                   p->chlen[ch] * sizeof * b);
+        else if (b)
+            LTFAT_NAME(clear_array)(b, p->chlen[ch]);
+    }
+    LTFAT_NAME(clear_array)(f, p->L);
+
+    // Children come after their parents, all of them are done before the parent
+    for (ltfat_int n = p->t.nodesNo - 1; n >= 0; n--)
+    {
+        LTFAT_TYPE* out = n == 0 ? f : p->buf[workerid][p->t.nodein[n]];
+
+        for (ltfat_int ch = p->t.chstart[n]; ch < p->t.chstart[n + 1]; ch++)
+            LTFAT_NAME(upconv_td_execute)(p->syn[workerid][ch],
+                                          LTFAT_NAME(wfbt_chdata)(p, ch, w, workerid),
+                                          out);
+
+        if (n > 0 && p->t.interscaling != 1.0)
+            LTFAT_NAME(wfbt_scale)(out, p->chlen[p->t.nodein[n]], p->t.interscaling);
+    }
+}
+
+LTFAT_API int
+LTFAT_NAME(wfbt_init)(const LTFAT_NAME(wfbt_node) nodes[], ltfat_int nodesNo,
+                      ltfat_int L, ltfat_int W, ltfatExtType ext, int flags,
+                      ltfat_int nthreads, LTFAT_NAME(wfbt_plan)** p)
+{
+    LTFAT_NAME(wfbt_plan)* pp = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECKMEM( pp = LTFAT_NEW(LTFAT_NAME(wfbt_plan)) );
+    CHECKSTATUS(
+        LTFAT_NAME(wfbt_plan_init)(nodes, nodesNo, L, W, ext, flags, nthreads,
+                                   0, pp));
+    *p = pp;
+    return status;
+error:
+    if (pp) LTFAT_NAME(wfbt_done)(&pp);
+    if (p) *p = NULL;
+    return status;
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(wfbt_get_outno)(const LTFAT_NAME(wfbt_plan)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    return p->t.outNo;
+error:
+    return status;
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(wfbt_get_outlen)(const LTFAT_NAME(wfbt_plan)* p, ltfat_int m)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_BADARG, m >= 0 && m < p->t.outNo,
+          "m must be in range [0,%td)", p->t.outNo);
+    return p->chlen[p->t.outch[m]];
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(wfbt_execute)(LTFAT_NAME(wfbt_plan)* p, const LTFAT_TYPE f[],
+                         LTFAT_TYPE* c[])
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(f); CHECKNULL(c);
+    for (ltfat_int m = 0; m < p->t.outNo; m++)
+        CHECKNULL(c[m]);
+
+    p->fin = f; p->cout = c;
+    status = ltfat_threadpool_execute(p->pool, p->W,
+                                      LTFAT_NAME(wfbt_task), p);
+    p->fin = NULL; p->cout = NULL;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(wfbt_done)(LTFAT_NAME(wfbt_plan)** p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(*p);
+    LTFAT_NAME(wfbt_plan_free)(*p);
+    ltfat_free(*p);
+    *p = NULL;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(iwfbt_init)(const LTFAT_NAME(wfbt_node) nodes[], ltfat_int nodesNo,
+                       ltfat_int L, ltfat_int W, ltfatExtType ext, int flags,
+                       ltfat_int nthreads, LTFAT_NAME(iwfbt_plan)** p)
+{
+    LTFAT_NAME(iwfbt_plan)* pp = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECKMEM( pp = LTFAT_NEW(LTFAT_NAME(iwfbt_plan)) );
+    CHECKSTATUS(
+        LTFAT_NAME(wfbt_plan_init)(nodes, nodesNo, L, W, ext, flags, nthreads,
+                                   1, &pp->p));
+    *p = pp;
+    return status;
+error:
+    if (pp) LTFAT_NAME(iwfbt_done)(&pp);
+    if (p) *p = NULL;
+    return status;
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(iwfbt_get_inno)(const LTFAT_NAME(iwfbt_plan)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    return p->p.t.outNo;
+error:
+    return status;
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(iwfbt_get_inlen)(const LTFAT_NAME(iwfbt_plan)* p, ltfat_int m)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_BADARG, m >= 0 && m < p->p.t.outNo,
+          "m must be in range [0,%td)", p->p.t.outNo);
+    return p->p.chlen[p->p.t.outch[m]];
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(iwfbt_execute)(LTFAT_NAME(iwfbt_plan)* p, const LTFAT_TYPE* c[],
+                          LTFAT_TYPE f[])
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(c); CHECKNULL(f);
+    for (ltfat_int m = 0; m < p->p.t.outNo; m++)
+        CHECKNULL(c[m]);
+
+    p->p.cin = c; p->p.fout = f;
+    status = ltfat_threadpool_execute(p->p.pool, p->p.W,
+                                      LTFAT_NAME(iwfbt_task), &p->p);
+    p->p.cin = NULL; p->p.fout = NULL;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(iwfbt_done)(LTFAT_NAME(iwfbt_plan)** p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(*p);
+    LTFAT_NAME(wfbt_plan_free)(&(*p)->p);
+    ltfat_free(*p);
+    *p = NULL;
+error:
+    return status;
+}
@@ -0,0 +1,29 @@
+#ifndef _LTFAT_WFBT_PRIVATE_H
+#define _LTFAT_WFBT_PRIVATE_H
+
+/* Topology of a filter bank tree. The channels of all nodes are numbered
+ * consecutively, channel k of node n has index chstart[n] + k. */
+typedef struct
+{
+    ltfat_int nodesNo;
+    ltfat_int chNo;      //!< Total number of channels
+    ltfat_int outNo;     //!< Number of outputs
+    int flags;
+    double interscaling;
+    ltfat_int* chstart;  //!< First channel of a node, nodesNo + 1
+    ltfat_int* chout;    //!< Output index of a channel or -1
+    ltfat_int* chchild;  //!< Node attached to a channel or -1
+    ltfat_int* nodein;   //!< Channel a node is attached to, -1 for the root
+    ltfat_int* outch;    //!< Channel of an output
+    ltfat_int* ups;      //!< Filter dilation of a node (undecimated tree)
+} ltfat_wfbt_tree;
+
+#endif
+
+/* Checks the nodes and the flags and fills in the tree */
+int
+LTFAT_NAME(wfbt_tree_init)(const LTFAT_NAME(wfbt_node) nodes[],
+                           ltfat_int nodesNo, int flags, ltfat_wfbt_tree* t);
+
+void
+LTFAT_NAME(wfbt_tree_free)(ltfat_wfbt_tree* t);
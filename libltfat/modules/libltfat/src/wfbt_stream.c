@@ -0,0 +1,828 @@
+#include "ltfat.h"
+#include "ltfat/types.h"
+#include "ltfat/macros.h"
+#include "wfbt_private.h"
+
+/* Channel m computes
+ *
+ *   c[n] = sum_j g[j] x[a*n - skip - j*ga],
+ *
+ * with x[t] = 0 for t < 0, and its adjoint
+ *
+ *   f[l] += sum_j conj(g[j]) c[n],   a*n - skip - j*ga = l.
+ *
+ * ga > 1 is used only by the undecimated trees (with a = 1).
+ *
+ * After T samples, coefficients n = 0,...,count(T)-1 are known, where
+ * count(T) = floor((T - 1 + skip)/a) + 1. The analysis keeps the last
+ * (gl-1)*ga input samples. The synthesis scatters each new coefficient to
+ * f[l] for l in [a*n - skip - (gl-1)*ga, a*n - skip] <= T - 1. With the
+ * delay D >= (gl-1)*ga, samples l < T - D receive no more contributions
+ * and can be output.
+ */
+struct LTFAT_NAME(filterbank_td_stream)
+{
+    ltfat_int M;
+    ltfat_int maxLb;
+    ltfat_int T;         //!< Number of samples received so far
+    LTFAT_TYPE** g;
+    ltfat_int* gl;
+    ltfat_int* a;
+    ltfat_int* ga;
+    ltfat_int* skip;
+    ltfat_int keep;      //!< Number of past samples kept
+    LTFAT_TYPE* buf;     //!< keep + maxLb, past samples followed by the block
+};
+
+struct LTFAT_NAME(ifilterbank_td_stream)
+{
+    ltfat_int M;
+    ltfat_int maxLb;
+    ltfat_int T;         //!< Number of samples output so far (incl. delay)
+    LTFAT_TYPE** g;      //!< Conjugated filters
+    ltfat_int* gl;
+    ltfat_int* a;
+    ltfat_int* ga;
+    ltfat_int* skip;
+    ltfat_int D;         //!< Delay
+    LTFAT_TYPE* acc;     //!< D + maxLb, acc[i] holds f[T - D + i]
+};
+
+/* Fixed delay of d elements, at most maxn elements are pushed at once */
+typedef struct
+{
+    ltfat_int d;
+    LTFAT_TYPE* buf;     //!< d + maxn
+} LTFAT_NAME(wfbt_delayline);
+
+struct LTFAT_NAME(wfbt_stream)
+{
+    ltfat_wfbt_tree t;
+    LTFAT_NAME(filterbank_td_stream)** nodes;
+    ltfat_int* chmaxlen; //!< Maximum number of coefficients per call
+    ltfat_int* chlen;    //!< Number of coefficients in the current call
+    LTFAT_TYPE** buf;    //!< Channels with a node attached which are not outputs
+    LTFAT_TYPE** cptr;   //!< Output pointers of a node
+};
+
+struct LTFAT_NAME(iwfbt_stream)
+{
+    ltfat_wfbt_tree t;
+    ltfat_int maxLb;
+    ltfat_int delay;
+    LTFAT_NAME(ifilterbank_td_stream)** nodes;
+    ltfat_int* chmaxlen;
+    ltfat_int* chlen;
+    ltfat_int* nodeLb;   //!< Block length of a node in the current call
+    LTFAT_NAME(wfbt_delayline)* align; //!< Aligns the inputs of a node
+    LTFAT_NAME(wfbt_delayline)* pack;  //!< Packets: delays the own subband
+    LTFAT_TYPE** recon;  //!< Output of the node attached to a channel
+    LTFAT_TYPE** in;     //!< Aligned input of a channel
+    const LTFAT_TYPE** cptr;
+};
+
+static ltfat_int
+LTFAT_NAME(fbtd_stream_count)(ltfat_int T, ltfat_int a, ltfat_int skip)
+{
+    return T - 1 + skip < 0 ? 0 : (T - 1 + skip) / a + 1;
+}
+
+static int
+LTFAT_NAME(fbtd_stream_params)(const LTFAT_TYPE* g[], const ltfat_int gl[],
+                               const ltfat_int a[], const ltfat_int ga[],
+                               const ltfat_int skip[], ltfat_int M,
+                               ltfat_int maxLb, int conjugate,
+                               LTFAT_TYPE*** gout, ltfat_int** glout,
+                               ltfat_int** aout, ltfat_int** gaout,
+                               ltfat_int** skipout, ltfat_int* maxdelay)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(g); CHECKNULL(gl); CHECKNULL(a); CHECKNULL(skip);
+    CHECK(LTFATERR_NOTPOSARG, M > 0, "M must be positive");
+    CHECK(LTFATERR_NOTPOSARG, maxLb > 0, "maxLb must be positive");
+
+    CHECKMEM( *gout = LTFAT_NEWARRAY(LTFAT_TYPE*, M) );
+    CHECKMEM( *glout = LTFAT_NEWARRAY(ltfat_int, M) );
+    CHECKMEM( *aout = LTFAT_NEWARRAY(ltfat_int, M) );
+    CHECKMEM( *gaout = LTFAT_NEWARRAY(ltfat_int, M) );
+    CHECKMEM( *skipout = LTFAT_NEWARRAY(ltfat_int, M) );
+    *maxdelay = 0;
+
+    for (ltfat_int m = 0; m < M; m++)
+    {
+        CHECKNULL(g[m]);
+        CHECK(LTFATERR_NOTPOSARG, gl[m] > 0, "gl[%td] must be positive", m);
+        CHECK(LTFATERR_NOTPOSARG, a[m] > 0, "a[%td] must be positive", m);
+        CHECK(LTFATERR_NOTPOSARG, !ga || ga[m] > 0, "ga[%td] must be positive", m);
+        CHECK(LTFATERR_BADARG, skip[m] <= 0,
+              "skip[%td] must not be positive (passed %td)", m, skip[m]);
+
+        (*glout)[m] = gl[m]; (*aout)[m] = a[m]; (*skipout)[m] = skip[m];
+        (*gaout)[m] = ga ? ga[m] : 1;
+        CHECKMEM( (*gout)[m] = LTFAT_NAME(malloc)(gl[m]) );
+        if (conjugate)
+            LTFAT_NAME(conjugate_array)(g[m], gl[m], (*gout)[m]);
+        else
+            memcpy((*gout)[m], g[m], gl[m] * sizeof * g[m]);
+
+        *maxdelay = ltfat_imax(*maxdelay, (gl[m] - 1) * (*gaout)[m]);
+    }
+error:
+    return status;
+}
+
+static void
+LTFAT_NAME(fbtd_stream_freeparams)(LTFAT_TYPE** g, ltfat_int* gl, ltfat_int* a,
+                                   ltfat_int* ga, ltfat_int* skip, ltfat_int M)
+{
+    if (g)
+        for (ltfat_int m = 0; m < M; m++)
+            ltfat_safefree(g[m]);
+    LTFAT_SAFEFREEALL(g, gl, a, ga, skip);
+}
+
+static int
+LTFAT_NAME(fbtd_stream_init)(const LTFAT_TYPE* g[], const ltfat_int gl[],
+                             const ltfat_int a[], const ltfat_int ga[],
+                             const ltfat_int skip[], ltfat_int M,
+                             ltfat_int maxLb,
+                             LTFAT_NAME(filterbank_td_stream)** p)
+{
+    LTFAT_NAME(filterbank_td_stream)* pp = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECKMEM( pp = LTFAT_NEW(LTFAT_NAME(filterbank_td_stream)) );
+    pp->M = M; pp->maxLb = maxLb;
+    CHECKSTATUS(
+        LTFAT_NAME(fbtd_stream_params)(g, gl, a, ga, skip, M, maxLb, 0, &pp->g,
+                                       &pp->gl, &pp->a, &pp->ga, &pp->skip,
+                                       &pp->keep));
+    CHECKMEM( pp->buf = LTFAT_NAME(calloc)(pp->keep + maxLb) );
+    *p = pp;
+    return status;
+error:
+    if (pp) LTFAT_NAME(filterbank_td_stream_done)(&pp);
+    if (p) *p = NULL;
+    return status;
+}
+
+static int
+LTFAT_NAME(ifbtd_stream_init)(const LTFAT_TYPE* g[], const ltfat_int gl[],
+                              const ltfat_int a[], const ltfat_int ga[],
+                              const ltfat_int skip[], ltfat_int M,
+                              ltfat_int maxLb,
+                              LTFAT_NAME(ifilterbank_td_stream)** p)
+{
+    LTFAT_NAME(ifilterbank_td_stream)* pp = NULL;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECKMEM( pp = LTFAT_NEW(LTFAT_NAME(ifilterbank_td_stream)) );
+    pp->M = M; pp->maxLb = maxLb;
+    CHECKSTATUS(
+        LTFAT_NAME(fbtd_stream_params)(g, gl, a, ga, skip, M, maxLb, 1, &pp->g,
+                                       &pp->gl, &pp->a, &pp->ga, &pp->skip,
+                                       &pp->D));
+    CHECKMEM( pp->acc = LTFAT_NAME(calloc)(pp->D + maxLb) );
+    *p = pp;
+    return status;
+error:
+    if (pp) LTFAT_NAME(ifilterbank_td_stream_done)(&pp);
+    if (p) *p = NULL;
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(filterbank_td_stream_init)(const LTFAT_TYPE* g[],
+                                      const ltfat_int gl[], const ltfat_int a[],
+                                      const ltfat_int skip[], ltfat_int M,
+                                      ltfat_int maxLb,
+                                      LTFAT_NAME(filterbank_td_stream)** p)
+{
+    return LTFAT_NAME(fbtd_stream_init)(g, gl, a, NULL, skip, M, maxLb, p);
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(filterbank_td_stream_get_maxoutlen)(
+    const LTFAT_NAME(filterbank_td_stream)* p, ltfat_int m)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_BADARG, m >= 0 && m < p->M, "m must be in range [0,%td)", p->M);
+    return ltfat_idivceil(p->maxLb, p->a[m]);
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(filterbank_td_stream_execute)(LTFAT_NAME(filterbank_td_stream)* p,
+        const LTFAT_TYPE f[], ltfat_int Lb, LTFAT_TYPE* c[], ltfat_int cLen[])
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(c); CHECKNULL(cLen);
+    CHECK(LTFATERR_BADARG, Lb >= 0 && Lb <= p->maxLb,
+          "Lb must be in range [0,%td] (passed %td)", p->maxLb, Lb);
+    CHECK(LTFATERR_NULLPOINTER, f || Lb == 0, "f is a null-pointer");
+
+    if (Lb > 0)
+        memcpy(p->buf + p->keep, f, Lb * sizeof * f);
+
+    // buf[0] holds sample T - keep
+    ltfat_int bufstart = p->T - p->keep;
+
+    for (ltfat_int m = 0; m < p->M; m++)
+    {
+        const LTFAT_TYPE* g = p->g[m];
+        ltfat_int nfirst = LTFAT_NAME(fbtd_stream_count)(p->T, p->a[m], p->skip[m]);
+        ltfat_int nend = LTFAT_NAME(fbtd_stream_count)(p->T + Lb, p->a[m], p->skip[m]);
+        CHECKNULL(c[m]);
+
+        for (ltfat_int n = nfirst; n < nend; n++)
+        {
+            const LTFAT_TYPE* x = p->buf + p->a[m] * n - p->skip[m] - bufstart;
+            LTFAT_TYPE acc = 0;
+            for (ltfat_int j = 0; j < p->gl[m]; j++)
+                acc += g[j] * x[-j * p->ga[m]];
+            c[m][n - nfirst] = acc;
+        }
+        cLen[m] = nend - nfirst;
+    }
+
+    memmove(p->buf, p->buf + Lb, p->keep * sizeof * p->buf);
+    p->T += Lb;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(filterbank_td_stream_reset)(LTFAT_NAME(filterbank_td_stream)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    LTFAT_NAME(clear_array)(p->buf, p->keep + p->maxLb);
+    p->T = 0;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(filterbank_td_stream_done)(LTFAT_NAME(filterbank_td_stream)** p)
+{
+    int status = LTFATERR_SUCCESS;
+    LTFAT_NAME(filterbank_td_stream)* pp = NULL;
+    CHECKNULL(p); CHECKNULL(*p);
+    pp = *p;
+    LTFAT_NAME(fbtd_stream_freeparams)(pp->g, pp->gl, pp->a, pp->ga, pp->skip,
+                                       pp->M);
+    ltfat_safefree(pp->buf);
+    ltfat_free(pp);
+    *p = NULL;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(ifilterbank_td_stream_init)(const LTFAT_TYPE* g[],
+                                       const ltfat_int gl[], const ltfat_int a[],
+                                       const ltfat_int skip[], ltfat_int M,
+                                       ltfat_int maxLb,
+                                       LTFAT_NAME(ifilterbank_td_stream)** p)
+{
+    return LTFAT_NAME(ifbtd_stream_init)(g, gl, a, NULL, skip, M, maxLb, p);
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(ifilterbank_td_stream_get_delay)(
+    const LTFAT_NAME(ifilterbank_td_stream)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    return p->D;
+error:
+    return status;
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(ifilterbank_td_stream_get_inlen)(
+    const LTFAT_NAME(ifilterbank_td_stream)* p, ltfat_int Lb, ltfat_int m)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_BADARG, m >= 0 && m < p->M, "m must be in range [0,%td)", p->M);
+    CHECK(LTFATERR_BADARG, Lb >= 0, "Lb must not be negative");
+    return LTFAT_NAME(fbtd_stream_count)(p->T + Lb, p->a[m], p->skip[m]) -
+           LTFAT_NAME(fbtd_stream_count)(p->T, p->a[m], p->skip[m]);
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(ifilterbank_td_stream_execute)(LTFAT_NAME(ifilterbank_td_stream)* p,
+        const LTFAT_TYPE* c[], const ltfat_int cLen[], ltfat_int Lb,
+        LTFAT_TYPE f[])
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p); CHECKNULL(c); CHECKNULL(cLen);
+    CHECK(LTFATERR_BADARG, Lb >= 0 && Lb <= p->maxLb,
+          "Lb must be in range [0,%td] (passed %td)", p->maxLb, Lb);
+    CHECK(LTFATERR_NULLPOINTER, f || Lb == 0, "f is a null-pointer");
+
+    for (ltfat_int m = 0; m < p->M; m++)
+        CHECK(LTFATERR_BADARG,
+              cLen[m] == LTFAT_NAME(ifilterbank_td_stream_get_inlen)(p, Lb, m),
+              "cLen[%td] does not match the block length", m);
+
+    // acc[0] holds f[T - D]
+    ltfat_int accstart = p->T - p->D;
+
+    for (ltfat_int m = 0; m < p->M; m++)
+    {
+        const LTFAT_TYPE* g = p->g[m];
+        ltfat_int nfirst = LTFAT_NAME(fbtd_stream_count)(p->T, p->a[m], p->skip[m]);
+        CHECKNULL(c[m]);
+
+        for (ltfat_int k = 0; k < cLen[m]; k++)
+        {
+            LTFAT_TYPE* y = p->acc + p->a[m] * (nfirst + k) - p->skip[m] - accstart;
+            for (ltfat_int j = 0; j < p->gl[m]; j++)
+                y[-j * p->ga[m]] += g[j] * c[m][k];
+        }
+    }
+
+    // Samples before the start of the signal are not output
+    for (ltfat_int l = 0; l < Lb; l++)
+        f[l] = accstart + l < 0 ? (LTFAT_TYPE) 0.0 : p->acc[l];
+
+    memmove(p->acc, p->acc + Lb, p->D * sizeof * p->acc);
+    LTFAT_NAME(clear_array)(p->acc + p->D, Lb);
+    p->T += Lb;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(ifilterbank_td_stream_reset)(LTFAT_NAME(ifilterbank_td_stream)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    LTFAT_NAME(clear_array)(p->acc, p->D + p->maxLb);
+    p->T = 0;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(ifilterbank_td_stream_done)(LTFAT_NAME(ifilterbank_td_stream)** p)
+{
+    int status = LTFATERR_SUCCESS;
+    LTFAT_NAME(ifilterbank_td_stream)* pp = NULL;
+    CHECKNULL(p); CHECKNULL(*p);
+    pp = *p;
+    LTFAT_NAME(fbtd_stream_freeparams)(pp->g, pp->gl, pp->a, pp->ga, pp->skip,
+                                       pp->M);
+    ltfat_safefree(pp->acc);
+    ltfat_free(pp);
+    *p = NULL;
+error:
+    return status;
+}
+
+static int
+LTFAT_NAME(wfbt_delayline_init)(ltfat_int d, ltfat_int maxn,
+                                LTFAT_NAME(wfbt_delayline)* dl)
+{
+    int status = LTFATERR_SUCCESS;
+    dl->d = d;
+    CHECKMEM( dl->buf = LTFAT_NAME(calloc)(d + maxn) );
+error:
+    return status;
+}
+
+static void
+LTFAT_NAME(wfbt_delayline_execute)(LTFAT_NAME(wfbt_delayline)* dl,
+                                   const LTFAT_TYPE in[], ltfat_int n,
+                                   LTFAT_TYPE out[])
+{
+    memcpy(dl->buf + dl->d, in, n * sizeof * in);
+    memcpy(out, dl->buf, n * sizeof * out);
+    memmove(dl->buf, dl->buf + n, dl->d * sizeof * dl->buf);
+}
+
+/* Per call, node n receives the coefficients of its parent channel
+ * emitted in the same call. A node of the undecimated tree runs at the
+ * full rate with the filters dilated. */
+static int
+LTFAT_NAME(wfbt_stream_nodeparams)(const LTFAT_NAME(wfbt_node)* nd,
+                                   const ltfat_wfbt_tree* t, ltfat_int n,
+                                   ltfat_int* a, ltfat_int* ga, ltfat_int* skip)
+{
+    int status = LTFATERR_SUCCESS;
+    int undec = t->flags & LTFAT_WFBT_UNDECIMATED;
+    for (ltfat_int k = 0; k < nd->M; k++)
+    {
+        a[k] = undec ? 1 : nd->a[k];
+        ga[k] = undec ? t->ups[n] : 1;
+        skip[k] = undec ? t->ups[n] * nd->offset[k] : nd->offset[k];
+    }
+    return status;
+}
+
+static ltfat_int
+LTFAT_NAME(wfbt_stream_maxM)(const LTFAT_NAME(wfbt_node) nodes[],
+                             ltfat_int nodesNo)
+{
+    ltfat_int maxM = 0;
+    for (ltfat_int n = 0; n < nodesNo; n++)
+        maxM = ltfat_imax(maxM, nodes[n].M);
+    return maxM;
+}
+
+LTFAT_API int
+LTFAT_NAME(wfbt_stream_init)(const LTFAT_NAME(wfbt_node) nodes[],
+                             ltfat_int nodesNo, ltfat_int maxLb, int flags,
+                             LTFAT_NAME(wfbt_stream)** p)
+{
+    LTFAT_NAME(wfbt_stream)* pp = NULL;
+    ltfat_int* a = NULL, *ga = NULL, *skip = NULL;
+    ltfat_wfbt_tree* t = NULL;
+    ltfat_int maxM;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_NOTPOSARG, maxLb > 0, "maxLb must be positive");
+    CHECKMEM( pp = LTFAT_NEW(LTFAT_NAME(wfbt_stream)) );
+    t = &pp->t;
+    CHECKSTATUS( LTFAT_NAME(wfbt_tree_init)(nodes, nodesNo, flags, t));
+
+    maxM = LTFAT_NAME(wfbt_stream_maxM)(nodes, nodesNo);
+    CHECKMEM( a = LTFAT_NEWARRAY(ltfat_int, maxM) );
+    CHECKMEM( ga = LTFAT_NEWARRAY(ltfat_int, maxM) );
+    CHECKMEM( skip = LTFAT_NEWARRAY(ltfat_int, maxM) );
+    CHECKMEM( pp->nodes = LTFAT_NEWARRAY(LTFAT_NAME(filterbank_td_stream)*, nodesNo));
+    CHECKMEM( pp->chmaxlen = LTFAT_NEWARRAY(ltfat_int, t->chNo));
+    CHECKMEM( pp->chlen = LTFAT_NEWARRAY(ltfat_int, t->chNo));
+    CHECKMEM( pp->buf = LTFAT_NEWARRAY(LTFAT_TYPE*, t->chNo));
+    CHECKMEM( pp->cptr = LTFAT_NEWARRAY(LTFAT_TYPE*, maxM));
+
+    for (ltfat_int n = 0; n < nodesNo; n++)
+    {
+        const LTFAT_NAME(wfbt_node)* nd = nodes + n;
+        ltfat_int Lb = n == 0 ? maxLb : pp->chmaxlen[t->nodein[n]];
+        LTFAT_NAME(wfbt_stream_nodeparams)(nd, t, n, a, ga, skip);
+        CHECKSTATUS(
+            LTFAT_NAME(fbtd_stream_init)(nd->g, nd->gl, a, ga, skip, nd->M, Lb,
+                                         &pp->nodes[n]));
+
+        for (ltfat_int k = 0; k < nd->M; k++)
+        {
+            ltfat_int ch = t->chstart[n] + k;
+            pp->chmaxlen[ch] =
+                LTFAT_NAME(filterbank_td_stream_get_maxoutlen)(pp->nodes[n], k);
+            if (t->chchild[ch] >= 0 && t->chout[ch] < 0)
+                CHECKMEM( pp->buf[ch] = LTFAT_NAME(malloc)(pp->chmaxlen[ch]));
+        }
+    }
+
+    LTFAT_SAFEFREEALL(a, ga, skip);
+    *p = pp;
+    return status;
+error:
+    LTFAT_SAFEFREEALL(a, ga, skip);
+    if (pp) LTFAT_NAME(wfbt_stream_done)(&pp);
+    if (p) *p = NULL;
+    return status;
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(wfbt_stream_get_outno)(const LTFAT_NAME(wfbt_stream)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    return p->t.outNo;
+error:
+    return status;
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(wfbt_stream_get_maxoutlen)(const LTFAT_NAME(wfbt_stream)* p,
+                                      ltfat_int m)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_BADARG, m >= 0 && m < p->t.outNo,
+          "m must be in range [0,%td)", p->t.outNo);
+    return p->chmaxlen[p->t.outch[m]];
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(wfbt_stream_execute)(LTFAT_NAME(wfbt_stream)* p,
+                                const LTFAT_TYPE f[], ltfat_int Lb,
+                                LTFAT_TYPE* c[], ltfat_int cLen[])
+{
+    int status = LTFATERR_SUCCESS;
+    const ltfat_wfbt_tree* t = NULL;
+    CHECKNULL(p); CHECKNULL(c); CHECKNULL(cLen);
+    t = &p->t;
+    for (ltfat_int m = 0; m < t->outNo; m++)
+        CHECKNULL(c[m]);
+
+    for (ltfat_int n = 0; n < t->nodesNo; n++)
+    {
+        ltfat_int ch0 = t->chstart[n], M = t->chstart[n + 1] - ch0;
+        const LTFAT_TYPE* in = f;
+        ltfat_int Lin = Lb;
+
+        if (n > 0)
+        {
+            ltfat_int pch = t->nodein[n];
+            in = p->buf[pch] ? p->buf[pch] : c[t->chout[pch]];
+            Lin = p->chlen[pch];
+        }
+
+        for (ltfat_int k = 0; k < M; k++)
+            p->cptr[k] = p->buf[ch0 + k] ? p->buf[ch0 + k] : c[t->chout[ch0 + k]];
+
+        CHECKSTATUS(
+            LTFAT_NAME(filterbank_td_stream_execute)(p->nodes[n], in, Lin,
+                    p->cptr, p->chlen + ch0));
+
+        // Packets: the input of the child is scaled together with the output
+        for (ltfat_int k = 0; k < M; k++)
+            if (t->chchild[ch0 + k] >= 0 && t->interscaling != 1.0)
+                for (ltfat_int ii = 0; ii < p->chlen[ch0 + k]; ii++)
+                    p->cptr[k][ii] *= t->interscaling;
+    }
+
+    for (ltfat_int m = 0; m < t->outNo; m++)
+        cLen[m] = p->chlen[t->outch[m]];
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(wfbt_stream_reset)(LTFAT_NAME(wfbt_stream)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    for (ltfat_int n = 0; n < p->t.nodesNo; n++)
+        LTFAT_NAME(filterbank_td_stream_reset)(p->nodes[n]);
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(wfbt_stream_done)(LTFAT_NAME(wfbt_stream)** p)
+{
+    int status = LTFATERR_SUCCESS;
+    LTFAT_NAME(wfbt_stream)* pp = NULL;
+    CHECKNULL(p); CHECKNULL(*p);
+    pp = *p;
+
+    if (pp->nodes)
+        for (ltfat_int n = 0; n < pp->t.nodesNo; n++)
+            if (pp->nodes[n])
+                LTFAT_NAME(filterbank_td_stream_done)(&pp->nodes[n]);
+
+    if (pp->buf)
+        for (ltfat_int ch = 0; ch < pp->t.chNo; ch++)
+            ltfat_safefree(pp->buf[ch]);
+
+    LTFAT_SAFEFREEALL(pp->nodes, pp->chmaxlen, pp->chlen, pp->buf, pp->cptr);
+    LTFAT_NAME(wfbt_tree_free)(&pp->t);
+    ltfat_free(pp);
+    *p = NULL;
+error:
+    return status;
+}
+
+/* The node n outputs its input signal delayed by delay(n) = Delta + D,
+ * where D is the delay of its ifilterbank_td_stream and Delta is the delay
+ * of the node inputs. The subband of channel k, running at 1/r of the node
+ * rate, is delayed by Delta/r samples in total: the node attached to it
+ * contributes delay(child), the delay line the rest. Delta is therefore
+ * the smallest multiple of all r with Delta >= r*delay(child) for all k.
+ * Delaying a subband by Delta/r equals the analysis of the input delayed
+ * by Delta, so the synthesis reconstructs the input delayed by Delta + D.
+ */
+LTFAT_API int
+LTFAT_NAME(iwfbt_stream_init)(const LTFAT_NAME(wfbt_node) nodes[],
+                              ltfat_int nodesNo, ltfat_int maxLb, int flags,
+                              LTFAT_NAME(iwfbt_stream)** p)
+{
+    LTFAT_NAME(iwfbt_stream)* pp = NULL;
+    ltfat_int* a = NULL, *ga = NULL, *skip = NULL, *delay = NULL;
+    ltfat_wfbt_tree* t = NULL;
+    ltfat_int maxM;
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_NOTPOSARG, maxLb > 0, "maxLb must be positive");
+    CHECKMEM( pp = LTFAT_NEW(LTFAT_NAME(iwfbt_stream)) );
+    t = &pp->t;
+    CHECKSTATUS( LTFAT_NAME(wfbt_tree_init)(nodes, nodesNo, flags, t));
+    pp->maxLb = maxLb;
+
+    maxM = LTFAT_NAME(wfbt_stream_maxM)(nodes, nodesNo);
+    CHECKMEM( a = LTFAT_NEWARRAY(ltfat_int, maxM) );
+    CHECKMEM( ga = LTFAT_NEWARRAY(ltfat_int, maxM) );
+    CHECKMEM( skip = LTFAT_NEWARRAY(ltfat_int, maxM) );
+    CHECKMEM( delay = LTFAT_NEWARRAY(ltfat_int, nodesNo) );
+    CHECKMEM( pp->nodes = LTFAT_NEWARRAY(LTFAT_NAME(ifilterbank_td_stream)*, nodesNo));
+    CHECKMEM( pp->chmaxlen = LTFAT_NEWARRAY(ltfat_int, t->chNo));
+    CHECKMEM( pp->chlen = LTFAT_NEWARRAY(ltfat_int, t->chNo));
+    CHECKMEM( pp->nodeLb = LTFAT_NEWARRAY(ltfat_int, nodesNo));
+    CHECKMEM( pp->align = LTFAT_NEWARRAY(LTFAT_NAME(wfbt_delayline), t->chNo));
+    CHECKMEM( pp->pack = LTFAT_NEWARRAY(LTFAT_NAME(wfbt_delayline), t->chNo));
+    CHECKMEM( pp->recon = LTFAT_NEWARRAY(LTFAT_TYPE*, t->chNo));
+    CHECKMEM( pp->in = LTFAT_NEWARRAY(LTFAT_TYPE*, t->chNo));
+    CHECKMEM( pp->cptr = LTFAT_NEWARRAY(const LTFAT_TYPE*, maxM));
+
+    for (ltfat_int n = 0; n < nodesNo; n++)
+    {
+        const LTFAT_NAME(wfbt_node)* nd = nodes + n;
+        ltfat_int Lb = n == 0 ? maxLb : pp->chmaxlen[t->nodein[n]];
+        LTFAT_NAME(wfbt_stream_nodeparams)(nd, t, n, a, ga, skip);
+        CHECKSTATUS(
+            LTFAT_NAME(ifbtd_stream_init)(nd->g, nd->gl, a, ga, skip, nd->M, Lb,
+                                          &pp->nodes[n]));
+
+        for (ltfat_int k = 0; k < nd->M; k++)
+        {
+            ltfat_int ch = t->chstart[n] + k;
+            pp->chmaxlen[ch] = ltfat_idivceil(Lb, a[k]);
+            CHECKMEM( pp->in[ch] = LTFAT_NAME(malloc)(pp->chmaxlen[ch]));
+            if (t->chchild[ch] >= 0)
+                CHECKMEM( pp->recon[ch] = LTFAT_NAME(malloc)(pp->chmaxlen[ch]));
+        }
+    }
+
+    // Children come after their parents
+    for (ltfat_int n = nodesNo - 1; n >= 0; n--)
+    {
+        const LTFAT_NAME(wfbt_node)* nd = nodes + n;
+        ltfat_int r = 1, Delta = 0;
+        LTFAT_NAME(wfbt_stream_nodeparams)(nd, t, n, a, ga, skip);
+
+        for (ltfat_int k = 0; k < nd->M; k++)
+        {
+            ltfat_int child = t->chchild[t->chstart[n] + k];
+            r = ltfat_lcm(r, a[k]);
+            if (child >= 0)
+                Delta = ltfat_imax(Delta, a[k] * delay[child]);
+        }
+        Delta = ltfat_idivceil(Delta, r) * r;
+        delay[n] = Delta + pp->nodes[n]->D;
+
+        for (ltfat_int k = 0; k < nd->M; k++)
+        {
+            ltfat_int ch = t->chstart[n] + k, child = t->chchild[ch];
+            ltfat_int dchild = child >= 0 ? delay[child] : 0;
+            CHECKSTATUS(
+                LTFAT_NAME(wfbt_delayline_init)(Delta / a[k] - dchild,
+                                                pp->chmaxlen[ch], &pp->align[ch]));
+            if (child >= 0 && t->chout[ch] >= 0)
+                CHECKSTATUS(
+                    LTFAT_NAME(wfbt_delayline_init)(dchild, pp->chmaxlen[ch],
+                                                    &pp->pack[ch]));
+        }
+    }
+    pp->delay = delay[0];
+
+    LTFAT_SAFEFREEALL(a, ga, skip, delay);
+    *p = pp;
+    return status;
+error:
+    LTFAT_SAFEFREEALL(a, ga, skip, delay);
+    if (pp) LTFAT_NAME(iwfbt_stream_done)(&pp);
+    if (p) *p = NULL;
+    return status;
+}
+
+LTFAT_API ltfat_int
+LTFAT_NAME(iwfbt_stream_get_delay)(const LTFAT_NAME(iwfbt_stream)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    return p->delay;
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(iwfbt_stream_execute)(LTFAT_NAME(iwfbt_stream)* p,
+                                 const LTFAT_TYPE* c[], const ltfat_int cLen[],
+                                 ltfat_int Lb, LTFAT_TYPE f[])
+{
+    int status = LTFATERR_SUCCESS;
+    const ltfat_wfbt_tree* t = NULL;
+    CHECKNULL(p); CHECKNULL(c); CHECKNULL(cLen);
+    CHECK(LTFATERR_BADARG, Lb >= 0 && Lb <= p->maxLb,
+          "Lb must be in range [0,%td] (passed %td)", p->maxLb, Lb);
+    t = &p->t;
+
+    // Block lengths of all nodes
+    p->nodeLb[0] = Lb;
+    for (ltfat_int n = 0; n < t->nodesNo; n++)
+    {
+        if (n > 0) p->nodeLb[n] = p->chlen[t->nodein[n]];
+
+        for (ltfat_int ch = t->chstart[n]; ch < t->chstart[n + 1]; ch++)
+            p->chlen[ch] = LTFAT_NAME(ifilterbank_td_stream_get_inlen)(
+                               p->nodes[n], p->nodeLb[n], ch - t->chstart[n]);
+    }
+
+    for (ltfat_int m = 0; m < t->outNo; m++)
+    {
+        CHECKNULL(c[m]);
+        CHECK(LTFATERR_BADARG, cLen[m] == p->chlen[t->outch[m]],
+              "cLen[%td] does not match the block length", m);
+    }
+
+    for (ltfat_int n = t->nodesNo - 1; n >= 0; n--)
+    {
+        ltfat_int ch0 = t->chstart[n], M = t->chstart[n + 1] - ch0;
+
+        for (ltfat_int k = 0; k < M; k++)
+        {
+            ltfat_int ch = ch0 + k, len = p->chlen[ch];
+            LTFAT_TYPE* in = p->in[ch];
+
+            if (t->chchild[ch] < 0)
+            {
+                LTFAT_NAME(wfbt_delayline_execute)(&p->align[ch], c[t->chout[ch]],
+                                                   len, in);
+            }
+            else
+            {
+                LTFAT_TYPE* rec = p->recon[ch];
+                if (t->chout[ch] >= 0)
+                {
+                    // Packets: own subband plus the reconstruction, scaled
+                    LTFAT_NAME(wfbt_delayline_execute)(&p->pack[ch],
+                                                       c[t->chout[ch]], len, in);
+                    for (ltfat_int ii = 0; ii < len; ii++)
+                        rec[ii] = (rec[ii] + in[ii]) * t->interscaling;
+                }
+                LTFAT_NAME(wfbt_delayline_execute)(&p->align[ch], rec, len, in);
+            }
+            p->cptr[k] = in;
+        }
+
+        CHECKSTATUS(
+            LTFAT_NAME(ifilterbank_td_stream_execute)(p->nodes[n], p->cptr,
+                    p->chlen + ch0, p->nodeLb[n],
+                    n == 0 ? f : p->recon[t->nodein[n]]));
+    }
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(iwfbt_stream_reset)(LTFAT_NAME(iwfbt_stream)* p)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    for (ltfat_int n = 0; n < p->t.nodesNo; n++)
+        LTFAT_NAME(ifilterbank_td_stream_reset)(p->nodes[n]);
+
+    for (ltfat_int ch = 0; ch < p->t.chNo; ch++)
+    {
+        if (p->align[ch].buf)
+            LTFAT_NAME(clear_array)(p->align[ch].buf,
+                                    p->align[ch].d + p->chmaxlen[ch]);
+        if (p->pack[ch].buf)
+            LTFAT_NAME(clear_array)(p->pack[ch].buf,
+                                    p->pack[ch].d + p->chmaxlen[ch]);
+    }
+error:
+    return status;
+}
+
+LTFAT_API int
+LTFAT_NAME(iwfbt_stream_done)(LTFAT_NAME(iwfbt_stream)** p)
+{
+    int status = LTFATERR_SUCCESS;
+    LTFAT_NAME(iwfbt_stream)* pp = NULL;
+    CHECKNULL(p); CHECKNULL(*p);
+    pp = *p;
+
+    if (pp->nodes)
+        for (ltfat_int n = 0; n < pp->t.nodesNo; n++)
+            if (pp->nodes[n])
+                LTFAT_NAME(ifilterbank_td_stream_done)(&pp->nodes[n]);
+
+    for (ltfat_int ch = 0; ch < pp->t.chNo; ch++)
+    {
+        if (pp->align) ltfat_safefree(pp->align[ch].buf);
+        if (pp->pack) ltfat_safefree(pp->pack[ch].buf);
+        if (pp->recon) ltfat_safefree(pp->recon[ch]);
+        if (pp->in) ltfat_safefree(pp->in[ch]);
+    }
+
+    LTFAT_SAFEFREEALL(pp->nodes, pp->chmaxlen, pp->chlen, pp->nodeLb,
+                      pp->align, pp->pack, pp->recon, pp->in, pp->cptr);
+    LTFAT_NAME(wfbt_tree_free)(&pp->t);
+    ltfat_free(pp);
+    *p = NULL;
+error:
+    return status;
+}
@@ -0,0 +1,167 @@
+#include <complex.h>
+#include "ltfat.h"
+#include "ltfat/thirdparty/fftw3.h"
+#ifdef LTFAT_BENCH_PHASERET
+#include "phaseret.h"
+#endif
+#include "benchmark.h"
+
+#define LTFAT_DOUBLE
+#include "ltfat/types.h"
+#ifdef LTFAT_BENCH_PHASERET
+#include "phaseret/types.h"
+#endif
+#define BENCH_NAME(name) name##_d
+#define BENCH_REAL_NAME(name) name##_d
+
+#include "bench_typeindependent.c"
+
+#undef BENCH_NAME
+#undef BENCH_REAL_NAME
+#undef LTFAT_DOUBLE
+
+#define LTFAT_SINGLE
+#include "ltfat/types.h"
+#ifdef LTFAT_BENCH_PHASERET
+#include "phaseret/types.h"
+#endif
+#define BENCH_NAME(name) name##_s
+#define BENCH_REAL_NAME(name) name##_s
+
+#include "bench_typeindependent.c"
+
+#undef BENCH_NAME
+#undef BENCH_REAL_NAME
+#undef LTFAT_SINGLE
+
+// Unsets all the macros
+#include "ltfat/types.h"
+
+#define BENCH_OPS(init, exec, flops, suffix) \
+    { init##_##suffix, exec##_##suffix, bench_done_##suffix, flops, NULL }
+
+#define BENCH_OPS_ERROR(init, exec, error, suffix) \
+    { init##_##suffix, exec##_##suffix, bench_done_##suffix, NULL, \
+      error##_##suffix }
+
+#define BENCH_DEF(name, flops) \
+    { #name, BENCH_OPS(name##_init, name##_exec, flops, d), \
+             BENCH_OPS(name##_init, name##_exec, flops, s) }
+
+#define BENCH_DEF_INIT(name, init, flops) \
+    { #name, BENCH_OPS(init, name##_exec, flops, d), \
+             BENCH_OPS(init, name##_exec, flops, s) }
+
+#define BENCH_DEF_EXEC(name, exec, flops) \
+    { #name, BENCH_OPS(name##_init, exec, flops, d), \
+             BENCH_OPS(name##_init, exec, flops, s) }
+
+#define BENCH_DEF_ERROR(name, exec, error) \
+    { #name, BENCH_OPS_ERROR(name##_init, exec, error, d), \
+             BENCH_OPS_ERROR(name##_init, exec, error, s) }
+
+const bench_def bench_defs[] =
+{
+    BENCH_DEF(dgt_long, bench_flops_dgt_long),
+    BENCH_DEF(idgt_long, bench_flops_dgt_long),
+    BENCH_DEF(dgtreal_long, bench_flops_dgtreal_long),
+    BENCH_DEF(idgtreal_long, bench_flops_dgtreal_long),
+    BENCH_DEF(dgt_fb, bench_flops_dgt_fb),
+    BENCH_DEF(idgt_fb, bench_flops_dgt_fb),
+    BENCH_DEF(dgtreal_fb, bench_flops_dgtreal_fb),
+    BENCH_DEF(idgtreal_fb, bench_flops_dgtreal_fb),
+    BENCH_DEF(filterbank_fft, bench_flops_filterbank_fft),
+    BENCH_DEF(filterbank_fftbl, bench_flops_filterbank_fftbl),
+    BENCH_DEF(rtdgtreal_processor, bench_flops_rtdgtreal),
+    BENCH_DEF(dgtrealmp, NULL),
+    BENCH_DEF_ERROR(heapintreal, heapintreal_exec, heapintreal_error),
+    BENCH_DEF_ERROR(heapintreal_bucket, heapintreal_exec, heapintreal_error),
+#ifdef LTFAT_BENCH_PHASERET
+    BENCH_DEF(pghi, NULL),
+    BENCH_DEF_EXEC(pghi_bucket, pghi_exec, NULL),
+    BENCH_DEF_INIT(spsi, phaseret_init, NULL),
+    BENCH_DEF_INIT(gla, phaseret_init, NULL),
+    BENCH_DEF_INIT(legla, phaseret_init, NULL),
+    BENCH_DEF(rtpghi, NULL),
+    BENCH_DEF_EXEC(rtpghi_bucket, rtpghi_exec, NULL),
+    BENCH_DEF(rtisila, NULL),
+#endif
+};
+
+const size_t bench_defs_no = sizeof bench_defs / sizeof * bench_defs;
+
+/* Flop counts. The DGT ones are taken from timing/flopcounts.m, the rest
+ * uses the same convention: 5*n*log2(n) for a complex FFT of length n,
+ * half of that for a real one, 6 flops per complex multiplication. */
+
+double
+bench_log2(double x)
+{
+    return log(x) / log(2.0);
+}
+
+double
+bench_flops_dgt_long(const bench_params* par)
+{
+    double L = par->L, a = par->a, M = par->M, N = L / a;
+    ltfat_int r, s, c = ltfat_gcd(par->a, par->M, &r, &s);
+    double p = a / c, q = M / c, d = N / q;
+
+    return par->W * (L * 8 * q + 4 * L * (1 + q / p) * bench_log2(d) +
+                     4 * M * N * bench_log2(M));
+}
+
+double
+bench_flops_dgtreal_long(const bench_params* par)
+{
+    double L = par->L, a = par->a, M = par->M, N = L / a;
+    ltfat_int r, s, c = ltfat_gcd(par->a, par->M, &r, &s);
+    double p = a / c, q = M / c, d = N / q;
+
+    return par->W * (L * 4 * q + 2 * L * (1 + q / p) * bench_log2(d) +
+                     2 * M * N * bench_log2(M));
+}
+
+double
+bench_flops_dgt_fb(const bench_params* par)
+{
+    double L = par->L, a = par->a, M = par->M, N = L / a;
+
+    return par->W * (8 * L * par->gl / a + 4 * M * N * bench_log2(M));
+}
+
+double
+bench_flops_dgtreal_fb(const bench_params* par)
+{
+    double L = par->L, a = par->a, M = par->M, N = L / a;
+
+    return par->W * (2 * L * par->gl / a + 2 * M * N * bench_log2(M));
+}
+
+/* Per channel: multiplication of the spectrum with the filter and
+ * an IFFT of length N */
+double
+bench_flops_filterbank_fft(const bench_params* par)
+{
+    double N = par->L / (double) par->a;
+
+    return par->W * par->M * (6.0 * par->L + 5 * N * bench_log2(N));
+}
+
+/* As above, but the filters have only gl nonzero coefficients */
+double
+bench_flops_filterbank_fftbl(const bench_params* par)
+{
+    double N = par->L / (double) par->a;
+
+    return par->W * par->M * (6.0 * par->gl + 5 * N * bench_log2(N));
+}
+
+/* Per frame: windowing, real FFT and IFFT, windowing and overlap-add */
+double
+bench_flops_rtdgtreal(const bench_params* par)
+{
+    double N = par->L / (double) par->a, M = par->M;
+
+    return par->W * N * (3.0 * par->gl + 5 * M * bench_log2(M));
+}
@@ -0,0 +1,810 @@
+/* Typed benchmark bodies. This file is included twice from bench_defs.c,
+ * once for each precision, see multiinclude in testing/cUnit. */
+
+typedef struct
+{
+    bench_params par;
+    ltfat_int M2;
+    ltfat_int N;
+    void* plan;
+    void (*plandone)(void* userdata); //!< Receives the whole struct
+    LTFAT_REAL* g;
+    LTFAT_COMPLEX* gc;
+    LTFAT_REAL* f;
+    LTFAT_COMPLEX* fc;
+    LTFAT_COMPLEX* c;
+    LTFAT_COMPLEX* c2;
+    LTFAT_REAL* s;
+    /* Heap integration */
+    LTFAT_REAL* tgradw;
+    LTFAT_REAL* fgradw;
+    LTFAT_REAL* phi;
+    /* Filter bank */
+    LTFAT_COMPLEX** G;
+    LTFAT_COMPLEX** cfb;
+    ltfat_int* foff;
+    int* realonly;
+    ltfat_int* afb;
+    /* Streaming */
+    const LTFAT_REAL** inPtr;
+    LTFAT_REAL** outPtr;
+} BENCH_NAME(bench_data);
+
+static void
+BENCH_NAME(bench_done)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = (BENCH_NAME(bench_data)*) userdata;
+    if (!d) return;
+
+    if (d->plan && d->plandone) d->plandone(d);
+
+    if (d->G)
+        for (ltfat_int m = 0; m < d->par.M; m++) ltfat_safefree(d->G[m]);
+
+    if (d->cfb)
+        for (ltfat_int m = 0; m < d->par.M; m++) ltfat_safefree(d->cfb[m]);
+
+    ltfat_safefree(d->g); ltfat_safefree(d->gc); ltfat_safefree(d->f);
+    ltfat_safefree(d->fc); ltfat_safefree(d->c); ltfat_safefree(d->c2);
+    ltfat_safefree(d->s); ltfat_safefree(d->tgradw); ltfat_safefree(d->fgradw);
+    ltfat_safefree(d->phi);
+    ltfat_safefree(d->G); ltfat_safefree(d->cfb); ltfat_safefree(d->foff);
+    ltfat_safefree(d->realonly); ltfat_safefree(d->afb);
+    ltfat_safefree(d->inPtr); ltfat_safefree(d->outPtr);
+    ltfat_free(d);
+}
+
+/* Allocates the buffers shared by all benchmarks. The window is a Hann
+ * window of length gl, zero-extended to L if longwin is set. */
+static BENCH_NAME(bench_data)*
+BENCH_NAME(bench_alloc)(const bench_params* par, int longwin)
+{
+    BENCH_NAME(bench_data)* d = NULL;
+    ltfat_int L = par->L, W = par->W, gl = par->gl;
+    ltfat_int glalloc = longwin ? L : gl;
+
+    if (gl > L || L % par->a != 0) return NULL;
+
+    d = ltfat_calloc(1, sizeof * d);
+    if (!d) return NULL;
+
+    d->par = *par;
+    d->M2 = par->M / 2 + 1;
+    d->N = L / par->a;
+
+    d->g = ltfat_calloc(glalloc, sizeof * d->g);
+    d->gc = ltfat_calloc(glalloc, sizeof * d->gc);
+    d->f = ltfat_calloc(L * W, sizeof * d->f);
+    d->fc = ltfat_calloc(L * W, sizeof * d->fc);
+    d->c = ltfat_calloc(par->M * d->N * W, sizeof * d->c);
+    d->s = ltfat_calloc(d->M2 * d->N * W, sizeof * d->s);
+
+    if (!d->g || !d->gc || !d->f || !d->fc || !d->c || !d->s)
+    {
+        BENCH_NAME(bench_done)(d);
+        return NULL;
+    }
+
+    LTFAT_NAME(firwin)(LTFAT_HANN, gl, d->g);
+    LTFAT_NAME(normalize)(d->g, gl, LTFAT_NORM_ENERGY, d->g);
+    for (ltfat_int l = 0; l < gl; l++) d->gc[l] = d->g[l];
+
+    if (longwin)
+    {
+        LTFAT_NAME(fir2long)(d->g, gl, L, d->g);
+        LTFAT_NAME_COMPLEX(fir2long)(d->gc, gl, L, d->gc);
+    }
+
+    BENCH_REAL_NAME(bench_fillrand)(d->f, L * W);
+    for (ltfat_int l = 0; l < L * W; l++) d->fc[l] = d->f[l];
+    BENCH_REAL_NAME(bench_fillrand)(d->s, d->M2 * d->N * W);
+
+    return d;
+}
+
+#define BENCH_FAIL(d, st) do { *status = (st); BENCH_NAME(bench_done)(d); return NULL; } while(0)
+
+/* ----------------------------- DGT, long ------------------------------- */
+
+static void BENCH_NAME(dgt_long_plandone)(void* p)
+{ LTFAT_NAME_COMPLEX(dgt_long_plan)* pp = ((BENCH_NAME(bench_data)*) p)->plan; LTFAT_NAME_COMPLEX(dgt_long_done)(&pp); }
+
+static void*
+BENCH_NAME(dgt_long_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 1);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(dgt_long_plandone);
+    if ((*status = LTFAT_NAME_COMPLEX(dgt_long_init)(
+                       d->gc, par->L, par->W, par->a, par->M, d->fc, d->c,
+                       LTFAT_FREQINV, FFTW_ESTIMATE,
+                       (LTFAT_NAME_COMPLEX(dgt_long_plan)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static int
+BENCH_NAME(dgt_long_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return LTFAT_NAME_COMPLEX(dgt_long_execute)(d->plan);
+}
+
+static void BENCH_NAME(idgt_long_plandone)(void* p)
+{ LTFAT_NAME_COMPLEX(idgt_long_plan)* pp = ((BENCH_NAME(bench_data)*) p)->plan; LTFAT_NAME_COMPLEX(idgt_long_done)(&pp); }
+
+static void*
+BENCH_NAME(idgt_long_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 1);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(idgt_long_plandone);
+    if ((*status = LTFAT_NAME_COMPLEX(idgt_long_init)(
+                       d->gc, par->L, par->W, par->a, par->M, d->c, d->fc,
+                       LTFAT_FREQINV, FFTW_ESTIMATE,
+                       (LTFAT_NAME_COMPLEX(idgt_long_plan)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static int
+BENCH_NAME(idgt_long_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return LTFAT_NAME_COMPLEX(idgt_long_execute)(d->plan);
+}
+
+static void BENCH_NAME(dgtreal_long_plandone)(void* p)
+{ LTFAT_NAME(dgtreal_long_plan)* pp = ((BENCH_NAME(bench_data)*) p)->plan; LTFAT_NAME(dgtreal_long_done)(&pp); }
+
+static void*
+BENCH_NAME(dgtreal_long_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 1);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(dgtreal_long_plandone);
+    if ((*status = LTFAT_NAME(dgtreal_long_init)(
+                       d->g, par->L, par->W, par->a, par->M, d->f, d->c,
+                       LTFAT_FREQINV, FFTW_ESTIMATE,
+                       (LTFAT_NAME(dgtreal_long_plan)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static int
+BENCH_NAME(dgtreal_long_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return LTFAT_NAME(dgtreal_long_execute)(d->plan);
+}
+
+static void BENCH_NAME(idgtreal_long_plandone)(void* p)
+{ LTFAT_NAME(idgtreal_long_plan)* pp = ((BENCH_NAME(bench_data)*) p)->plan; LTFAT_NAME(idgtreal_long_done)(&pp); }
+
+static void*
+BENCH_NAME(idgtreal_long_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 1);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(idgtreal_long_plandone);
+    if ((*status = LTFAT_NAME(idgtreal_long_init)(
+                       d->g, par->L, par->W, par->a, par->M, d->c, d->f,
+                       LTFAT_FREQINV, FFTW_ESTIMATE,
+                       (LTFAT_NAME(idgtreal_long_plan)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static int
+BENCH_NAME(idgtreal_long_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return LTFAT_NAME(idgtreal_long_execute)(d->plan);
+}
+
+/* --------------------------- DGT, filter bank -------------------------- */
+
+static void BENCH_NAME(dgt_fb_plandone)(void* p)
+{ LTFAT_NAME_COMPLEX(dgt_fb_plan)* pp = ((BENCH_NAME(bench_data)*) p)->plan; LTFAT_NAME_COMPLEX(dgt_fb_done)(&pp); }
+
+static void*
+BENCH_NAME(dgt_fb_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 0);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(dgt_fb_plandone);
+    if ((*status = LTFAT_NAME_COMPLEX(dgt_fb_init)(
+                       d->gc, par->gl, par->a, par->M, LTFAT_FREQINV,
+                       FFTW_ESTIMATE,
+                       (LTFAT_NAME_COMPLEX(dgt_fb_plan)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static int
+BENCH_NAME(dgt_fb_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return LTFAT_NAME_COMPLEX(dgt_fb_execute)(d->plan, d->fc, d->par.L,
+            d->par.W, d->c);
+}
+
+static void BENCH_NAME(idgt_fb_plandone)(void* p)
+{ LTFAT_NAME_COMPLEX(idgt_fb_plan)* pp = ((BENCH_NAME(bench_data)*) p)->plan; LTFAT_NAME_COMPLEX(idgt_fb_done)(&pp); }
+
+static void*
+BENCH_NAME(idgt_fb_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 0);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(idgt_fb_plandone);
+    if ((*status = LTFAT_NAME_COMPLEX(idgt_fb_init)(
+                       d->gc, par->gl, par->a, par->M, LTFAT_FREQINV,
+                       FFTW_ESTIMATE,
+                       (LTFAT_NAME_COMPLEX(idgt_fb_plan)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static int
+BENCH_NAME(idgt_fb_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return LTFAT_NAME_COMPLEX(idgt_fb_execute)(d->plan, d->c, d->par.L,
+            d->par.W, d->fc);
+}
+
+static void BENCH_NAME(dgtreal_fb_plandone)(void* p)
+{ LTFAT_NAME(dgtreal_fb_plan)* pp = ((BENCH_NAME(bench_data)*) p)->plan; LTFAT_NAME(dgtreal_fb_done)(&pp); }
+
+static void*
+BENCH_NAME(dgtreal_fb_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 0);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(dgtreal_fb_plandone);
+    if ((*status = LTFAT_NAME(dgtreal_fb_init)(
+                       d->g, par->gl, par->a, par->M, LTFAT_FREQINV,
+                       FFTW_ESTIMATE,
+                       (LTFAT_NAME(dgtreal_fb_plan)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static int
+BENCH_NAME(dgtreal_fb_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return LTFAT_NAME(dgtreal_fb_execute)(d->plan, d->f, d->par.L,
+                                          d->par.W, d->c);
+}
+
+static void BENCH_NAME(idgtreal_fb_plandone)(void* p)
+{ LTFAT_NAME(idgtreal_fb_plan)* pp = ((BENCH_NAME(bench_data)*) p)->plan; LTFAT_NAME(idgtreal_fb_done)(&pp); }
+
+static void*
+BENCH_NAME(idgtreal_fb_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 0);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(idgtreal_fb_plandone);
+    if ((*status = LTFAT_NAME(idgtreal_fb_init)(
+                       d->g, par->gl, par->a, par->M, LTFAT_FREQINV,
+                       FFTW_ESTIMATE,
+                       (LTFAT_NAME(idgtreal_fb_plan)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static int
+BENCH_NAME(idgtreal_fb_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return LTFAT_NAME(idgtreal_fb_execute)(d->plan, d->c, d->par.L,
+                                           d->par.W, d->f);
+}
+
+/* ------------------------- Filter bank, FFT based ---------------------- */
+/* M channels, uniform subsampling by a. filterbank_fft uses full length
+ * filters, filterbank_fftbl uses band-limited filters of length gl with
+ * center frequencies spaced by L/M. F is the FFT of the input signal. */
+
+/* Full-length filters are not attempted above this number of elements */
+#define BENCH_FB_MAXELEMS ((size_t)1 << 25)
+
+static void BENCH_NAME(filterbank_fft_plandone)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    LTFAT_NAME(convsub_fft_plan)* p = d->plan;
+
+    for (ltfat_int m = 0; m < d->par.M; m++)
+        if (p[m]) LTFAT_NAME(convsub_fft_done)(p[m]);
+
+    ltfat_free(p);
+}
+
+static void BENCH_NAME(filterbank_fftbl_plandone)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    LTFAT_NAME(convsub_fftbl_plan)* p = d->plan;
+
+    for (ltfat_int m = 0; m < d->par.M; m++)
+        if (p[m]) LTFAT_NAME(convsub_fftbl_done)(p[m]);
+
+    ltfat_free(p);
+}
+
+static BENCH_NAME(bench_data)*
+BENCH_NAME(filterbank_alloc)(const bench_params* par, ltfat_int Gl)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 0);
+    ltfat_int M = par->M, N = par->L / par->a;
+    if (!d) return NULL;
+
+    d->G = ltfat_calloc(M, sizeof * d->G);
+    d->cfb = ltfat_calloc(M, sizeof * d->cfb);
+    d->foff = ltfat_calloc(M, sizeof * d->foff);
+    d->realonly = ltfat_calloc(M, sizeof * d->realonly);
+    d->afb = ltfat_calloc(M, sizeof * d->afb);
+    if (!d->G || !d->cfb || !d->foff || !d->realonly || !d->afb) goto error;
+
+    for (ltfat_int m = 0; m < M; m++)
+    {
+        d->G[m] = ltfat_calloc(Gl, sizeof * d->G[m]);
+        d->cfb[m] = ltfat_calloc(N * par->W, sizeof * d->cfb[m]);
+        if (!d->G[m] || !d->cfb[m]) goto error;
+
+        /* Band-limited Hann frequency response centered at m*L/M */
+        for (ltfat_int l = 0; l < Gl && l < par->gl; l++)
+            d->G[m][l] = d->g[l];
+
+        d->foff[m] = m * (par->L / M) - par->gl / 2;
+        d->afb[m] = par->a;
+    }
+
+    /* fc holds the spectrum of the signal */
+    return d;
+error:
+    BENCH_NAME(bench_done)(d);
+    return NULL;
+}
+
+static void*
+BENCH_NAME(filterbank_fft_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = NULL;
+    LTFAT_NAME(convsub_fft_plan)* p = NULL;
+
+    if ((size_t) par->M * par->L * (par->W + 1) > BENCH_FB_MAXELEMS)
+    { *status = LTFATERR_NOTSUPPORTED; return NULL; }
+
+    d = BENCH_NAME(filterbank_alloc)(par, par->L);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+
+    /* Full length filters are circularly shifted band-limited ones */
+    for (ltfat_int m = 0; m < par->M; m++)
+        LTFAT_NAME_COMPLEX(circshift)(d->G[m], par->L, d->foff[m], d->G[m]);
+
+    p = ltfat_calloc(par->M, sizeof * p);
+    if (!p) BENCH_FAIL(d, LTFATERR_NOMEM);
+    d->plan = p;
+    d->plandone = BENCH_NAME(filterbank_fft_plandone);
+
+    for (ltfat_int m = 0; m < par->M; m++)
+    {
+        p[m] = LTFAT_NAME(convsub_fft_init)(par->L, par->W, par->a, d->cfb[m]);
+        if (!p[m])
+        {
+            *status = LTFATERR_INITFAILED;
+            BENCH_NAME(bench_done)(d);
+            return NULL;
+        }
+    }
+
+    *status = 0;
+    return d;
+}
+
+static int
+BENCH_NAME(filterbank_fft_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    LTFAT_NAME(filterbank_fft_execute)(
+        d->plan, d->fc, (const LTFAT_COMPLEX**) d->G, d->par.M, d->cfb);
+    return 0;
+}
+
+static void*
+BENCH_NAME(filterbank_fftbl_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(filterbank_alloc)(par, par->gl);
+    LTFAT_NAME(convsub_fftbl_plan)* p = NULL;
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+
+    p = ltfat_calloc(par->M, sizeof * p);
+    if (!p) BENCH_FAIL(d, LTFATERR_NOMEM);
+    d->plan = p;
+    d->plandone = BENCH_NAME(filterbank_fftbl_plandone);
+
+    for (ltfat_int m = 0; m < par->M; m++)
+    {
+        p[m] = LTFAT_NAME(convsub_fftbl_init)(par->L, par->gl, par->W,
+                                              (double) par->a, d->cfb[m]);
+        if (!p[m])
+        {
+            *status = LTFATERR_INITFAILED;
+            BENCH_NAME(bench_done)(d);
+            return NULL;
+        }
+    }
+
+    *status = 0;
+    return d;
+}
+
+static int
+BENCH_NAME(filterbank_fftbl_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    LTFAT_NAME(filterbank_fftbl_execute)(
+        d->plan, d->fc, (const LTFAT_COMPLEX**) d->G, d->par.M,
+        d->foff, d->realonly, d->cfb);
+    return 0;
+}
+
+/* ------------------------- rtdgtreal_processor ------------------------- */
+/* The whole signal is processed in blocks of a samples */
+
+static void BENCH_NAME(rtdgtreal_plandone)(void* p)
+{ LTFAT_NAME(rtdgtreal_processor_state)* pp = ((BENCH_NAME(bench_data)*) p)->plan; LTFAT_NAME(rtdgtreal_processor_done)(&pp); }
+
+static void*
+BENCH_NAME(rtdgtreal_processor_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 0);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(rtdgtreal_plandone);
+
+    d->inPtr = ltfat_calloc(par->W, sizeof * d->inPtr);
+    d->outPtr = ltfat_calloc(par->W, sizeof * d->outPtr);
+    if (!d->inPtr || !d->outPtr) BENCH_FAIL(d, LTFATERR_NOMEM);
+
+    if ((*status = LTFAT_NAME(rtdgtreal_processor_init)(
+                       d->g, par->gl, d->g, par->gl, par->a, par->M, par->W,
+                       par->a, par->gl,
+                       (LTFAT_NAME(rtdgtreal_processor_state)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static int
+BENCH_NAME(rtdgtreal_processor_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    ltfat_int L = d->par.L, W = d->par.W, a = d->par.a;
+    int status = 0;
+
+    for (ltfat_int n = 0; n < d->N && !status; n++)
+    {
+        for (ltfat_int w = 0; w < W; w++)
+        {
+            d->inPtr[w] = d->f + w * L + n * a;
+            d->outPtr[w] = (LTFAT_REAL*) d->fc + w * L + n * a;
+        }
+
+        status = LTFAT_NAME(rtdgtreal_processor_execute)(
+                     d->plan, d->inPtr, a, W, d->outPtr);
+    }
+    return status;
+}
+
+/* ------------------------------ dgtrealmp ------------------------------ */
+/* Single dictionary, the number of atoms is fixed to L/16 such that the
+ * amount of work does not depend on the (random) signal. */
+
+static void BENCH_NAME(dgtrealmp_plandone)(void* p)
+{ LTFAT_NAME(dgtrealmp_state)* pp = ((BENCH_NAME(bench_data)*) p)->plan; LTFAT_NAME(dgtrealmp_done)(&pp); }
+
+static void*
+BENCH_NAME(dgtrealmp_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = NULL;
+    LTFAT_NAME(dgtrealmp_parbuf)* pb = NULL;
+
+    if (par->W != 1) { *status = LTFATERR_NOTSUPPORTED; return NULL; }
+
+    d = BENCH_NAME(bench_alloc)(par, 0);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(dgtrealmp_plandone);
+
+    if ((*status = LTFAT_NAME(dgtrealmp_parbuf_init)(&pb))) BENCH_FAIL(d, *status);
+
+    if ((*status = LTFAT_NAME(dgtrealmp_parbuf_add_firwin)(
+                       pb, LTFAT_HANN, par->gl, par->a, par->M)) ||
+        (*status = LTFAT_NAME(dgtrealmp_setparbuf_snrdb)(pb, 200)) ||
+        (*status = LTFAT_NAME(dgtrealmp_setparbuf_maxatoms)(pb, par->L / 16)) ||
+        (*status = LTFAT_NAME(dgtrealmp_setparbuf_maxit)(pb, par->L / 16)) ||
+        (*status = LTFAT_NAME(dgtrealmp_init)(
+                       pb, par->L, (LTFAT_NAME(dgtrealmp_state)**) &d->plan)))
+    {
+        LTFAT_NAME(dgtrealmp_parbuf_done)(&pb);
+        BENCH_FAIL(d, *status);
+    }
+
+    LTFAT_NAME(dgtrealmp_parbuf_done)(&pb);
+    return d;
+}
+
+static int
+BENCH_NAME(dgtrealmp_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    int status = LTFAT_NAME(dgtrealmp_execute_compact)(
+                     d->plan, d->f, d->c, (LTFAT_REAL*) d->fc);
+    return status < 0 ? status : 0;
+}
+
+/* ----------------------------- heapintreal ----------------------------- */
+/* Magnitudes spread over 16 octaves, the gradients are the ones of a
+ * smooth phase phi disturbed by noise, such that the result depends on the
+ * order of integration. The error is 1 - |sum s*exp(i*(phase - phi))|/sum s,
+ * which does not depend on the arbitrary constant phase. */
+
+static void BENCH_NAME(heapintreal_plandone)(void* p)
+{ LTFAT_NAME(heapinttask_done)(((BENCH_NAME(bench_data)*) p)->plan); }
+
+static void*
+BENCH_NAME(heapintreal_inittype)(const bench_params* par, ltfat_heap_type type,
+                                 int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 0);
+    ltfat_int M2, N, L;
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(heapintreal_plandone);
+    M2 = d->M2; N = d->N; L = M2 * N * par->W;
+
+    d->tgradw = ltfat_calloc(L, sizeof * d->tgradw);
+    d->fgradw = ltfat_calloc(L, sizeof * d->fgradw);
+    d->phi = ltfat_calloc(L, sizeof * d->phi);
+    if (!d->tgradw || !d->fgradw || !d->phi) BENCH_FAIL(d, LTFATERR_NOMEM);
+
+    BENCH_REAL_NAME(bench_fillrand)(d->tgradw, L);
+    BENCH_REAL_NAME(bench_fillrand)(d->fgradw, L);
+
+    for (ltfat_int ii = 0; ii < L; ii++)
+    {
+        ltfat_int m = ii % M2, n = (ii / M2) % N;
+        d->s[ii] = (LTFAT_REAL) exp2(16.0 * d->s[ii]);
+        d->phi[ii] = (LTFAT_REAL) (0.3 * n + 1e-3 * m * n - 1e-4 * m * m);
+        d->tgradw[ii] = (LTFAT_REAL) (0.3 + 1e-3 * m + 0.02 * d->tgradw[ii]);
+        d->fgradw[ii] = (LTFAT_REAL) (1e-3 * n - 2e-4 * m + 0.02 * d->fgradw[ii]);
+    }
+
+    d->plan = LTFAT_NAME(heapinttask_init)(M2, N, (ltfat_int)(M2 * log((double) M2)),
+                                           d->s, 1, type);
+    if (!d->plan) BENCH_FAIL(d, LTFATERR_NOMEM);
+    *status = 0;
+    return d;
+}
+
+static void*
+BENCH_NAME(heapintreal_init)(const bench_params* par, int* status)
+{
+    return BENCH_NAME(heapintreal_inittype)(par, LTFAT_HEAP_BINARY, status);
+}
+
+static void*
+BENCH_NAME(heapintreal_bucket_init)(const bench_params* par, int* status)
+{
+    return BENCH_NAME(heapintreal_inittype)(par, LTFAT_HEAP_BUCKET, status);
+}
+
+static int
+BENCH_NAME(heapintreal_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    ltfat_int chanL = d->M2 * d->N;
+    LTFAT_REAL* phase = (LTFAT_REAL*) d->c;
+
+    for (ltfat_int w = 0; w < d->par.W; w++)
+    {
+        memset(phase + w * chanL, 0, chanL * sizeof * phase);
+        LTFAT_NAME(heapinttask_resetmax)(d->plan, d->s + w * chanL, (LTFAT_REAL) 1e-10);
+        LTFAT_NAME(heapint_execute)(d->plan, d->s + w * chanL, d->tgradw + w * chanL,
+                                    d->fgradw + w * chanL, phase + w * chanL);
+    }
+    return 0;
+}
+
+static double
+BENCH_NAME(heapintreal_error)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    ltfat_int chanL = d->M2 * d->N;
+    const LTFAT_REAL* phase = (const LTFAT_REAL*) d->c;
+    double err = 0.0;
+
+    for (ltfat_int w = 0; w < d->par.W; w++)
+    {
+        double re = 0.0, im = 0.0, nrm = 0.0;
+        for (ltfat_int ii = w * chanL; ii < (w + 1) * chanL; ii++)
+        {
+            re += d->s[ii] * cos(phase[ii] - d->phi[ii]);
+            im += d->s[ii] * sin(phase[ii] - d->phi[ii]);
+            nrm += d->s[ii];
+        }
+        err += 1.0 - sqrt(re * re + im * im) / nrm;
+    }
+    return err / d->par.W;
+}
+
+#ifdef LTFAT_BENCH_PHASERET
+/* ------------------------------ phaseret ------------------------------- */
+/* The iterative algorithms do a fixed number of iterations */
+#define BENCH_PHASERET_ITER 8
+
+static void*
+BENCH_NAME(phaseret_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 0);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+
+    /* Initial coefficients for gla and legla */
+    d->c2 = ltfat_calloc(d->M2 * d->N * par->W, sizeof * d->c2);
+    if (!d->c2) BENCH_FAIL(d, LTFATERR_NOMEM);
+
+    *status = 0;
+    return d;
+}
+
+/* Magnitudes spread over 16 octaves like in heapintreal. The magnitudes
+ * are independent, with the default tolerance 1e-1 they would form many
+ * small islands, each of them costing a full search for the next maximum.
+ * A single pass with tolerance 1e-10 is done instead. */
+static void BENCH_NAME(pghi_plandone)(void* p)
+{ PHASERET_NAME(pghi_plan)* pp = ((BENCH_NAME(bench_data)*) p)->plan; PHASERET_NAME(pghi_done)(&pp); }
+
+static void*
+BENCH_NAME(pghi_inittype)(const bench_params* par, ltfat_heap_type type,
+                          int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 0);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(pghi_plandone);
+
+    for (ltfat_int ii = 0; ii < d->M2 * d->N * par->W; ii++)
+        d->s[ii] = (LTFAT_REAL) exp2(16.0 * d->s[ii]);
+
+    if ((*status = PHASERET_NAME(pghi_init_withheaptype)(
+                       par->L, par->W, par->a, par->M, 1e-10, NAN,
+                       phaseret_firwin2gamma(LTFAT_HANN, par->gl), type,
+                       (PHASERET_NAME(pghi_plan)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static void*
+BENCH_NAME(pghi_init)(const bench_params* par, int* status)
+{
+    return BENCH_NAME(pghi_inittype)(par, LTFAT_HEAP_BINARY, status);
+}
+
+static void*
+BENCH_NAME(pghi_bucket_init)(const bench_params* par, int* status)
+{
+    return BENCH_NAME(pghi_inittype)(par, LTFAT_HEAP_BUCKET, status);
+}
+
+static int
+BENCH_NAME(pghi_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return PHASERET_NAME(pghi_execute)(d->plan, d->s, d->c);
+}
+
+static int
+BENCH_NAME(spsi_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return PHASERET_NAME(spsi)(d->s, d->par.L, d->par.W, d->par.a, d->par.M,
+                               NULL, d->c);
+}
+
+static int
+BENCH_NAME(gla_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return PHASERET_NAME(gla)(d->c2, NULL, d->g, d->par.L, d->par.gl, d->par.W,
+                              d->par.a, d->par.M, BENCH_PHASERET_ITER, d->c);
+}
+
+static int
+BENCH_NAME(legla_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    return PHASERET_NAME(legla)(d->c2, d->g, d->par.L, d->par.gl, d->par.W,
+                                d->par.a, d->par.M, BENCH_PHASERET_ITER, d->c);
+}
+
+static void BENCH_NAME(rtpghi_plandone)(void* p)
+{ PHASERET_NAME(rtpghi_state)* pp = ((BENCH_NAME(bench_data)*) p)->plan; PHASERET_NAME(rtpghi_done)(&pp); }
+
+static void*
+BENCH_NAME(rtpghi_inittype)(const bench_params* par, ltfat_heap_type type,
+                            int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 0);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(rtpghi_plandone);
+
+    if ((*status = PHASERET_NAME(rtpghi_init)(
+                       par->W, par->a, par->M,
+                       phaseret_firwin2gamma(LTFAT_HANN, par->gl), 1e-6, 1,
+                       (PHASERET_NAME(rtpghi_state)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    if ((*status = PHASERET_NAME(rtpghi_set_heaptype)(d->plan, type)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static void*
+BENCH_NAME(rtpghi_init)(const bench_params* par, int* status)
+{
+    return BENCH_NAME(rtpghi_inittype)(par, LTFAT_HEAP_BINARY, status);
+}
+
+static void*
+BENCH_NAME(rtpghi_bucket_init)(const bench_params* par, int* status)
+{
+    return BENCH_NAME(rtpghi_inittype)(par, LTFAT_HEAP_BUCKET, status);
+}
+
+/* Frame by frame, the magnitude is stored as M2 x W per frame */
+static int
+BENCH_NAME(rtpghi_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    ltfat_int frameLen = d->M2 * d->par.W;
+    int status = 0;
+
+    for (ltfat_int n = 0; n < d->N && !status; n++)
+        status = PHASERET_NAME(rtpghi_execute)(d->plan, d->s + n * frameLen,
+                                               d->c + n * frameLen);
+    return status;
+}
+
+static void BENCH_NAME(rtisila_plandone)(void* p)
+{ PHASERET_NAME(rtisila_state)* pp = ((BENCH_NAME(bench_data)*) p)->plan; PHASERET_NAME(rtisila_done)(&pp); }
+
+static void*
+BENCH_NAME(rtisila_init)(const bench_params* par, int* status)
+{
+    BENCH_NAME(bench_data)* d = BENCH_NAME(bench_alloc)(par, 0);
+    if (!d) { *status = LTFATERR_BADARG; return NULL; }
+    d->plandone = BENCH_NAME(rtisila_plandone);
+
+    if ((*status = PHASERET_NAME(rtisila_init)(
+                       d->g, par->gl, par->W, par->a, par->M, 1,
+                       BENCH_PHASERET_ITER,
+                       (PHASERET_NAME(rtisila_state)**) &d->plan)))
+        BENCH_FAIL(d, *status);
+    return d;
+}
+
+static int
+BENCH_NAME(rtisila_exec)(void* userdata)
+{
+    BENCH_NAME(bench_data)* d = userdata;
+    ltfat_int frameLen = d->M2 * d->par.W;
+    int status = 0;
+
+    for (ltfat_int n = 0; n < d->N && !status; n++)
+        status = PHASERET_NAME(rtisila_execute)(d->plan, d->s + n * frameLen,
+                                                d->c + n * frameLen);
+    return status;
+}
+#undef BENCH_PHASERET_ITER
+#endif
+
+#undef BENCH_FAIL
+#undef BENCH_FB_MAXELEMS
@@ -0,0 +1,80 @@
+#ifndef _LTFATBENCH_H
+#define _LTFATBENCH_H
+
+#include "ltfat.h"
+
+/* One point of the parameter sweep */
+typedef struct
+{
+    ltfat_int L;
+    ltfat_int a;
+    ltfat_int M;
+    ltfat_int gl;
+    ltfat_int W;
+} bench_params;
+
+/* Result of a single benchmark run */
+typedef struct
+{
+    const char* name;
+    const char* precision;
+    bench_params par;
+    int status;          //!< 0 or ltfat error code, negative if skipped
+    double nsPerSample;  //!< Median time per input sample (per channel)
+    double nsPerSampleMin;
+    double gflops;       //!< Estimated throughput, 0 if there is no flop model
+    double relError;     //!< Error of the result, negative if not measured
+    size_t initAllocs;   //!< Heap allocations done by the init function
+    size_t execAllocs;   //!< Heap allocations per execute call
+    size_t execBytes;    //!< Bytes allocated per execute call
+    int reps;
+    long innerIters;
+} bench_result;
+
+/* Benchmark body
+ *
+ * init  Allocates and plans everything, returns userdata (NULL on failure)
+ * exec  One call of the benchmarked function
+ * done  Releases everything allocated by init
+ * flops Flop count of one exec call according to the model or 0
+ * error Relative error of the result of the last exec call, can be NULL
+ */
+typedef struct
+{
+    void* (*init)(const bench_params* par, int* status);
+    int (*exec)(void* userdata);
+    void (*done)(void* userdata);
+    double (*flops)(const bench_params* par);
+    double (*error)(void* userdata);
+} bench_ops;
+
+typedef struct
+{
+    const char* name;
+    bench_ops ops_d;
+    bench_ops ops_s;
+} bench_def;
+
+/* Allocation counter, see ltfatbench.c */
+size_t bench_allocs(void);
+size_t bench_allocbytes(void);
+
+/* Helpers shared between the benchmark bodies */
+double bench_log2(double x);
+void bench_fillrand_d(double f[], size_t L);
+void bench_fillrand_s(float f[], size_t L);
+
+/* Flop models, after timing/flopcounts.m */
+double bench_flops_dgt_long(const bench_params* par);
+double bench_flops_dgtreal_long(const bench_params* par);
+double bench_flops_dgt_fb(const bench_params* par);
+double bench_flops_dgtreal_fb(const bench_params* par);
+double bench_flops_filterbank_fft(const bench_params* par);
+double bench_flops_filterbank_fftbl(const bench_params* par);
+double bench_flops_rtdgtreal(const bench_params* par);
+
+/* Typed tables defined in bench_typeindependent.c */
+extern const bench_def bench_defs[];
+extern const size_t bench_defs_no;
+
+#endif
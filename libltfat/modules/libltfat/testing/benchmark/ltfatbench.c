@@ -0,0 +1,430 @@
+/* Benchmark of the libltfat (and libphaseret) C API
+ *
+ * Sweeps all combinations of the given L, a, M, gl, W and precisions for
+ * the selected functions and reports time per sample, GFLOP/s according
+ * to the flop model and the number of heap allocations done by libltfat.
+ * Results can be written as JSON and/or CSV. See README.md.
+ */
+#include "ltfat.h"
+#include "benchmark.h"
+#include <math.h>
+#include <stdint.h>
+
+/* ----------------------------- Timing --------------------------------- */
+
+static double
+bench_time_ns(void)
+{
+    return 1e9 * ltfat_time_monotonic();
+}
+
+/* -------------------------- Allocation counter ------------------------- */
+/* Installed as the libltfat memory handler before anything is allocated.
+ * The memory is aligned the same way libltfat does it when compiled
+ * without FFTW. Counting is not atomic, multi-threaded execute functions
+ * might be undercounted. */
+
+#define BENCH_ALIGN 64
+
+static size_t bench_allocno = 0;
+static size_t bench_allocsize = 0;
+
+static void*
+bench_malloc(size_t n)
+{
+    void* mem = malloc(n + sizeof(void*) + BENCH_ALIGN - 1);
+    void** ptr;
+    if (!mem) return NULL;
+
+    ptr = (void**)(((uintptr_t)mem + BENCH_ALIGN - 1 + sizeof(void*)) &
+                   ~((uintptr_t)BENCH_ALIGN - 1));
+    ptr[-1] = mem;
+
+    bench_allocno++;
+    bench_allocsize += n;
+    return ptr;
+}
+
+static void
+bench_free(void* ptr)
+{
+    if (ptr) free(((void**) ptr)[-1]);
+}
+
+size_t bench_allocs(void) { return bench_allocno; }
+size_t bench_allocbytes(void) { return bench_allocsize; }
+
+/* ------------------------------ Helpers -------------------------------- */
+
+/* Deterministic, the same signal is used for every run */
+static uint32_t bench_seed = 1;
+
+static double
+bench_rand(void)
+{
+    bench_seed = bench_seed * 1664525u + 1013904223u;
+    return (bench_seed >> 8) / (double)(1 << 24) - 0.5;
+}
+
+void bench_fillrand_d(double f[], size_t L)
+{ for (size_t l = 0; l < L; l++) f[l] = bench_rand(); }
+
+void bench_fillrand_s(float f[], size_t L)
+{ for (size_t l = 0; l < L; l++) f[l] = (float) bench_rand(); }
+
+static int
+bench_cmpdouble(const void* a, const void* b)
+{
+    double da = *(const double*) a, db = *(const double*) b;
+    return (da > db) - (da < db);
+}
+
+#define BENCH_MAXLIST 32
+
+typedef struct
+{
+    ltfat_int v[BENCH_MAXLIST];
+    int n;
+} bench_list;
+
+static int
+bench_parselist(const char* str, bench_list* l)
+{
+    char* end;
+    l->n = 0;
+    while (*str && l->n < BENCH_MAXLIST)
+    {
+        long v = strtol(str, &end, 10);
+        if (end == str || v <= 0) return 1;
+        l->v[l->n++] = (ltfat_int) v;
+        str = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') return 1;
+    }
+    return l->n == 0;
+}
+
+/* Comma separated list of names, NULL matches everything */
+static int
+bench_inlist(const char* list, const char* name)
+{
+    size_t len = strlen(name);
+    const char* s = list;
+
+    if (!list) return 1;
+
+    while ((s = strstr(s, name)))
+    {
+        if ((s == list || s[-1] == ',') && (s[len] == ',' || s[len] == '\0'))
+            return 1;
+        s += len;
+    }
+    return 0;
+}
+
+/* ------------------------------ Running -------------------------------- */
+
+typedef struct
+{
+    int reps;
+    double mintime; //!< Minimum duration of one repetition in ns
+} bench_opts;
+
+static void
+bench_run(const char* name, const char* precision, const bench_ops* ops,
+          const bench_params* par, const bench_opts* opts, bench_result* r)
+{
+    void* ud;
+    size_t allocs0, bytes0;
+    double t0, tone, times[64];
+    int reps = opts->reps > 64 ? 64 : opts->reps;
+    long iters;
+
+    memset(r, 0, sizeof * r);
+    r->relError = -1.0;
+    r->name = name;
+    r->precision = precision;
+    r->par = *par;
+
+    allocs0 = bench_allocs();
+    ud = ops->init(par, &r->status);
+    r->initAllocs = bench_allocs() - allocs0;
+    if (!ud) { if (!r->status) r->status = LTFATERR_FAILED; return; }
+
+    /* The first call might still allocate lazily */
+    if ((r->status = ops->exec(ud))) goto done;
+
+    allocs0 = bench_allocs();
+    bytes0 = bench_allocbytes();
+    t0 = bench_time_ns();
+    if ((r->status = ops->exec(ud))) goto done;
+    tone = bench_time_ns() - t0;
+    r->execAllocs = bench_allocs() - allocs0;
+    r->execBytes = bench_allocbytes() - bytes0;
+
+    iters = tone > 0 ? (long) ceil(opts->mintime / tone) : 1;
+    if (iters < 1) iters = 1;
+
+    for (int rep = 0; rep < reps; rep++)
+    {
+        t0 = bench_time_ns();
+        for (long it = 0; it < iters; it++)
+            if ((r->status = ops->exec(ud))) goto done;
+        times[rep] = (bench_time_ns() - t0) / iters;
+    }
+
+    qsort(times, reps, sizeof * times, bench_cmpdouble);
+    r->reps = reps;
+    r->innerIters = iters;
+    r->nsPerSample = times[reps / 2] / ((double) par->L * par->W);
+    r->nsPerSampleMin = times[0] / ((double) par->L * par->W);
+    if (ops->flops)
+        r->gflops = ops->flops(par) / times[reps / 2];
+    if (ops->error)
+        r->relError = ops->error(ud);
+done:
+    ops->done(ud);
+}
+
+/* Configurations the function does not support are not errors */
+static int
+bench_isskipped(const bench_result* r)
+{
+    return r->status == LTFATERR_BADARG || r->status == LTFATERR_NOTSUPPORTED;
+}
+
+/* ------------------------------ Output --------------------------------- */
+
+static const char*
+bench_backend(void)
+{
+#ifdef FFTW
+    return "fftw";
+#else
+    return "kissfft";
+#endif
+}
+
+static void
+bench_printjson(FILE* fp, const bench_result* res, size_t nres)
+{
+    const ltfat_library_version* v = ltfat_get_version();
+
+    fprintf(fp, "{\n  \"library\": {\"version\": \"%s\", \"build_date\": \"%s\", "
+            "\"fft_backend\": \"%s\", \"ltfat_int_size\": %d},\n",
+            v->version, v->build_date, bench_backend(), v->ltfat_int_size);
+    fprintf(fp, "  \"results\": [");
+
+    for (size_t ii = 0; ii < nres; ii++)
+    {
+        const bench_result* r = res + ii;
+        fprintf(fp, "%s\n    {\"name\": \"%s\", \"precision\": \"%s\", "
+                "\"L\": %td, \"a\": %td, \"M\": %td, \"gl\": %td, \"W\": %td, "
+                "\"status\": %d, \"skipped\": %s, ",
+                ii ? "," : "", r->name, r->precision,
+                (ptrdiff_t) r->par.L, (ptrdiff_t) r->par.a, (ptrdiff_t) r->par.M,
+                (ptrdiff_t) r->par.gl, (ptrdiff_t) r->par.W, r->status,
+                bench_isskipped(r) ? "true" : "false");
+
+        if (r->status)
+        {
+            fprintf(fp, "\"ns_per_sample\": null, \"ns_per_sample_min\": null, "
+                    "\"gflops\": null, ");
+        }
+        else
+        {
+            fprintf(fp, "\"ns_per_sample\": %.6g, \"ns_per_sample_min\": %.6g, ",
+                    r->nsPerSample, r->nsPerSampleMin);
+            if (r->gflops > 0) fprintf(fp, "\"gflops\": %.6g, ", r->gflops);
+            else               fprintf(fp, "\"gflops\": null, ");
+        }
+
+        if (r->relError >= 0) fprintf(fp, "\"rel_error\": %.6g, ", r->relError);
+        else                  fprintf(fp, "\"rel_error\": null, ");
+
+        fprintf(fp, "\"init_allocs\": %zu, \"exec_allocs\": %zu, "
+                "\"exec_alloc_bytes\": %zu, \"reps\": %d, \"iters\": %ld}",
+                r->initAllocs, r->execAllocs, r->execBytes, r->reps,
+                r->innerIters);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+}
+
+static void
+bench_printcsv(FILE* fp, const bench_result* res, size_t nres)
+{
+    fprintf(fp, "name,precision,backend,L,a,M,gl,W,status,ns_per_sample,"
+            "ns_per_sample_min,gflops,rel_error,init_allocs,exec_allocs,"
+            "exec_alloc_bytes\n");
+
+    for (size_t ii = 0; ii < nres; ii++)
+    {
+        const bench_result* r = res + ii;
+        fprintf(fp, "%s,%s,%s,%td,%td,%td,%td,%td,%d,", r->name, r->precision,
+                bench_backend(), (ptrdiff_t) r->par.L, (ptrdiff_t) r->par.a,
+                (ptrdiff_t) r->par.M, (ptrdiff_t) r->par.gl,
+                (ptrdiff_t) r->par.W, r->status);
+        if (r->status) fprintf(fp, ",,,");
+        else           fprintf(fp, "%.6g,%.6g,%.6g,", r->nsPerSample,
+                                   r->nsPerSampleMin, r->gflops);
+        if (r->relError >= 0) fprintf(fp, "%.6g,", r->relError);
+        else                  fprintf(fp, ",");
+        fprintf(fp, "%zu,%zu,%zu\n", r->initAllocs, r->execAllocs, r->execBytes);
+    }
+}
+
+static void
+bench_printline(FILE* fp, const bench_result* r)
+{
+    fprintf(fp, "%-20s %s L=%-7td a=%-5td M=%-5td gl=%-5td W=%-2td ",
+            r->name, r->precision, (ptrdiff_t) r->par.L, (ptrdiff_t) r->par.a,
+            (ptrdiff_t) r->par.M, (ptrdiff_t) r->par.gl, (ptrdiff_t) r->par.W);
+
+    if (bench_isskipped(r))
+        fprintf(fp, "skipped (%d)\n", r->status);
+    else if (r->status)
+        fprintf(fp, "FAILED (%d)\n", r->status);
+    else if (r->gflops > 0)
+        fprintf(fp, "%10.3f ns/sample %8.3f GFLOP/s allocs %zu/%zu",
+                r->nsPerSample, r->gflops, r->initAllocs, r->execAllocs);
+    else
+        fprintf(fp, "%10.3f ns/sample %8s GFLOP/s allocs %zu/%zu",
+                r->nsPerSample, "-", r->initAllocs, r->execAllocs);
+
+    if (!r->status)
+    {
+        if (r->relError >= 0) fprintf(fp, " error %.3g\n", r->relError);
+        else                  fprintf(fp, "\n");
+    }
+}
+
+static void
+bench_usage(const char* prog)
+{
+    printf("Usage: %s [options]\n\n"
+           "  --bench n1,n2,...  Benchmarks to run (default all, see --list)\n"
+           "  --L l1,l2,...      Signal lengths (default 8192,65536)\n"
+           "  --a a1,...         Hop sizes (default 256)\n"
+           "  --M M1,...         Numbers of channels (default 1024)\n"
+           "  --gl g1,...        Window lengths (default 1024)\n"
+           "  --W W1,...         Numbers of signal channels (default 1)\n"
+           "  --precision d,s    Precisions (default d,s)\n"
+           "  --reps n           Repetitions, the median is reported (default 7)\n"
+           "  --mintime ms       Minimum duration of one repetition (default 20)\n"
+           "  --json file        Write results as JSON\n"
+           "  --csv file         Write results as CSV\n"
+           "  --list             List available benchmarks\n\n"
+           "L is rounded up to the next multiple of lcm(a,M).\n", prog);
+}
+
+int
+main(int argc, char* argv[])
+{
+    bench_list Ls = {{8192, 65536}, 2}, as = {{256}, 1}, Ms = {{1024}, 1},
+               gls = {{1024}, 1}, Ws = {{1}, 1};
+    const char* benchnames = NULL, *precisions = "d,s";
+    const char* jsonfile = NULL, *csvfile = NULL;
+    bench_opts opts = {7, 20e6};
+    bench_result* res = NULL;
+    size_t nres = 0, rescap = 0;
+    int failed = 0;
+    ltfat_memory_handler_t handler = {bench_malloc, bench_free};
+
+    ltfat_set_memory_handler(handler);
+
+    for (int ii = 1; ii < argc; ii++)
+    {
+        const char* opt = argv[ii];
+        const char* val = ii + 1 < argc ? argv[ii + 1] : NULL;
+        int err = 0;
+
+        if (!strcmp(opt, "--help") || !strcmp(opt, "-h"))
+        { bench_usage(argv[0]); return 0; }
+
+        if (!strcmp(opt, "--list"))
+        {
+            for (size_t b = 0; b < bench_defs_no; b++)
+                printf("%s\n", bench_defs[b].name);
+            return 0;
+        }
+
+        if (!val) { bench_usage(argv[0]); return 1; }
+
+        if      (!strcmp(opt, "--L"))         err = bench_parselist(val, &Ls);
+        else if (!strcmp(opt, "--a"))         err = bench_parselist(val, &as);
+        else if (!strcmp(opt, "--M"))         err = bench_parselist(val, &Ms);
+        else if (!strcmp(opt, "--gl"))        err = bench_parselist(val, &gls);
+        else if (!strcmp(opt, "--W"))         err = bench_parselist(val, &Ws);
+        else if (!strcmp(opt, "--bench"))     benchnames = val;
+        else if (!strcmp(opt, "--precision")) precisions = val;
+        else if (!strcmp(opt, "--json"))      jsonfile = val;
+        else if (!strcmp(opt, "--csv"))       csvfile = val;
+        else if (!strcmp(opt, "--reps"))      err = (opts.reps = atoi(val)) <= 0;
+        else if (!strcmp(opt, "--mintime"))   err = (opts.mintime = 1e6 * atof(val)) <= 0;
+        else err = 1;
+
+        if (err)
+        {
+            fprintf(stderr, "Bad option %s %s\n", opt, val);
+            return 1;
+        }
+        ii++;
+    }
+
+    for (size_t b = 0; b < bench_defs_no; b++)
+    {
+        const bench_def* def = bench_defs + b;
+        if (!bench_inlist(benchnames, def->name)) continue;
+
+        for (int p = 0; p < 2; p++)
+        {
+            const char* prec = p ? "s" : "d";
+            if (!bench_inlist(precisions, prec)) continue;
+
+            for (int iL = 0; iL < Ls.n; iL++)
+            for (int ia = 0; ia < as.n; ia++)
+            for (int iM = 0; iM < Ms.n; iM++)
+            for (int ig = 0; ig < gls.n; ig++)
+            for (int iW = 0; iW < Ws.n; iW++)
+            {
+                bench_params par;
+                par.a = as.v[ia]; par.M = Ms.v[iM];
+                par.gl = gls.v[ig]; par.W = Ws.v[iW];
+                par.L = ltfat_dgtlength(Ls.v[iL], par.a, par.M);
+
+                if (nres == rescap)
+                {
+                    rescap = rescap ? 2 * rescap : 64;
+                    res = realloc(res, rescap * sizeof * res);
+                    if (!res) { fprintf(stderr, "Out of memory\n"); return 1; }
+                }
+
+                bench_run(def->name, p ? "single" : "double",
+                          p ? &def->ops_s : &def->ops_d, &par, &opts, res + nres);
+                bench_printline(stdout, res + nres);
+                fflush(stdout);
+
+                if (res[nres].status && !bench_isskipped(res + nres)) failed++;
+                nres++;
+            }
+        }
+    }
+
+    if (jsonfile)
+    {
+        FILE* fp = fopen(jsonfile, "w");
+        if (!fp) { fprintf(stderr, "Cannot open %s\n", jsonfile); return 1; }
+        bench_printjson(fp, res, nres);
+        fclose(fp);
+    }
+
+    if (csvfile)
+    {
+        FILE* fp = fopen(csvfile, "w");
+        if (!fp) { fprintf(stderr, "Cannot open %s\n", csvfile); return 1; }
+        bench_printcsv(fp, res, nres);
+        fclose(fp);
+    }
+
+    free(res);
+    return failed ? 1 : 0;
+}
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include <stdio.h>
+#include "ltfat/thirdparty/fftw3.h"
 
 int tests_run;
 
@@ -49,7 +50,8 @@ void test_error_handler (int ltfat_errno, const char* file, int line,
 
 #define mu_suite_start() int message = 0; do { ltfat_set_error_handler(test_error_handler); } while(0)
 
-#define mu_suite_stop() do{ fftw_cleanup(); fftwf_cleanup(); } while(0)
+// Cached plans must be destroyed before the FFTW cleanup
+#define mu_suite_stop() do{ ltfat_fftcache_clear(); fftw_cleanup(); fftwf_cleanup(); } while(0)
 
 #define mu_assert(test, ...) do{ printf("    "); printf(__VA_ARGS__);  if (!(test)) { printf("    <--- FAILED"); return 1; }  printf("\n"); }while(0)
 
@@ -1,5 +1,8 @@
 #define LTFAT_DOUBLE
 #include "ltfat/types.h"
+#ifdef LTFAT_TEST_PHASERET
+#include "phaseret/types.h"
+#endif
 #define TEST_NAME(name) name##_d
 #define TEST_NAME_COMPLEX(name) name##_dc
 
@@ -12,6 +15,9 @@
 
 #define LTFAT_SINGLE
 #include "ltfat/types.h"
+#ifdef LTFAT_TEST_PHASERET
+#include "phaseret/types.h"
+#endif
 #define TEST_NAME(name) name##_s
 #define TEST_NAME_COMPLEX(name) name##_sc
 
@@ -2,6 +2,9 @@
 #include "ltfat/errno.h"
 #include "ltfat/macros.h"
 #include "minunit.h"
+#ifdef LTFAT_TEST_PHASERET
+#include "phaseret.h"
+#endif
 
 
 void all_tests()
@@ -9,6 +12,12 @@ void all_tests()
     mu_suite_start();
 
     mu_run_test_singledoublecomplex(test_circshift);
+    mu_run_test_singledoublecomplex(test_fold_array);
+    mu_run_test_singledoublecomplex(test_convsub_td);
+    mu_run_test_singledoublecomplex(test_wfbt);
+    mu_run_test_singledoublecomplex(test_wfbt_stream);
+    mu_run_test_singledoublecomplex(test_gga);
+    mu_run_test_singledoublecomplex(test_chzt);
     mu_run_test_singledoublecomplex(test_fftshift);
     mu_run_test_singledoublecomplex(test_ifftshift);
     mu_run_test_singledoublecomplex(test_fir2long);
@@ -32,6 +41,21 @@ void all_tests()
     mu_run_test_singledouble(test_fftrealcircshift);
     mu_run_test_singledouble(test_fftrealfftshift);
     mu_run_test_singledouble(test_fftrealifftshift);
+    mu_run_test_singledouble(test_fftcache);
+    mu_run_test_singledouble(test_arena);
+    mu_run_test_singledouble(test_heapint);
+    mu_run_test_singledouble(test_rtdgtreal);
+    mu_run_test_singledouble(test_block_processor);
+    mu_run_test_singledouble(test_maxtree);
+    mu_run_test_singledouble(test_dgtrealmp);
+    mu_run_test_singledouble(test_segdgtrealmp);
+#ifdef LTFAT_TEST_PHASERET
+    mu_run_test_singledouble(test_gla);
+    mu_run_test_singledouble(test_leglaupdate);
+    mu_run_test_singledouble(test_rtisila);
+    mu_run_test_singledouble(test_rtpghi);
+    mu_run_test_singledouble(test_pghi);
+#endif
 
     mu_suite_stop();
 }
@@ -0,0 +1,90 @@
+#ifndef _TEST_ARENA_HELPERS
+#define _TEST_ARENA_HELPERS
+static size_t test_arena_heapallocs = 0;
+
+static void*
+test_arena_malloc(size_t n)
+{
+    test_arena_heapallocs++;
+    return malloc(n);
+}
+#endif
+
+int TEST_NAME(test_arena)()
+{
+    // 2*67 has a prime factor above the KISS FFT stack scratch limit
+    ltfatInt L[] = {134, 1024};
+    ltfatInt W = 2;
+    ltfat_memory_handler_t oldhandler =
+        ltfat_set_memory_handler( (ltfat_memory_handler_t) { test_arena_malloc, free });
+
+    mu_assert( ltfat_arena_measure_end(NULL) == LTFATERR_NULLPOINTER, "measure_end NULL");
+    mu_assert( ltfat_arena_end() == LTFATERR_FAILED, "end without begin");
+
+    for (unsigned int lId = 0; lId < ARRAYLEN(L); lId++)
+    {
+        ltfatInt M2 = L[lId] / 2 + 1;
+        LTFAT_REAL* f = LTFAT_NAME_REAL(malloc)(L[lId] * W);
+        LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(M2 * W);
+        LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(M2 * W);
+        TEST_NAME(fillRand)(f, L[lId] * W);
+        LTFAT_NAME(fftreal_plan)* p = NULL;
+        ltfat_arena* arena = NULL;
+        size_t size = 0, used = 0;
+
+        mu_assert( LTFAT_NAME(fftreal)(f, L[lId], W, cref) == LTFATERR_SUCCESS,
+                   "fftreal");
+        ltfatInt cachecount = ltfat_fftcache_getcount();
+
+        mu_assert( ltfat_arena_measure_begin() == LTFATERR_SUCCESS, "measure_begin");
+        mu_assert( ltfat_arena_measure_begin() == LTFATERR_FAILED, "nested measure_begin");
+        mu_assert( LTFAT_NAME(fftreal_init)(L[lId], W, f, c, FFTW_ESTIMATE, &p)
+                   == LTFATERR_SUCCESS, "fftreal_init measure");
+        LTFAT_NAME(fftreal_done)(&p);
+        mu_assert( ltfat_arena_measure_end(&size) == LTFATERR_SUCCESS, "measure_end");
+        mu_assert( ltfat_fftcache_getcount() == cachecount,
+                   "Measuring must not use the plan cache");
+
+        void* mem = malloc(size);
+        mu_assert( ltfat_arena_init(mem, 8, &arena) == LTFATERR_BADSIZE, "arena_init small");
+        mu_assert( ltfat_arena_init(mem, size, &arena) == LTFATERR_SUCCESS, "arena_init");
+
+        size_t heapallocs = test_arena_heapallocs;
+        mu_assert( ltfat_arena_begin(arena) == LTFATERR_SUCCESS, "arena_begin");
+        mu_assert( ltfat_arena_begin(arena) == LTFATERR_FAILED, "nested arena_begin");
+        mu_assert( LTFAT_NAME(fftreal_init)(L[lId], W, f, c, FFTW_ESTIMATE, &p)
+                   == LTFATERR_SUCCESS, "fftreal_init arena");
+        mu_assert( ltfat_arena_end() == LTFATERR_SUCCESS, "arena_end");
+        ltfat_arena_get_used(arena, &used);
+        mu_assert( used > 0 && used <= size, "Arena usage");
+
+        mu_assert( test_arena_heapallocs == heapallocs, "Heap allocation in init");
+        heapallocs = test_arena_heapallocs;
+        mu_assert( LTFAT_NAME(fftreal_execute)(p) == LTFATERR_SUCCESS,
+                   "fftreal_execute");
+        mu_assert( test_arena_heapallocs == heapallocs, "Heap allocation in execute");
+
+        LTFAT_REAL err = 0;
+        for (ltfatInt ii = 0; ii < M2 * W; ii++)
+            err += ltfat_abs(c[ii] - cref[ii]);
+        mu_assert( err < 1e-3, "Arena plan gives a different result");
+
+        ltfat_arena_begin(arena);
+        mu_assert( LTFAT_NAME(fftreal_done)(&p) == LTFATERR_SUCCESS, "fftreal_done");
+        ltfat_arena_end();
+        mu_assert( ltfat_fftcache_getcount() == cachecount,
+                   "Arena plans must not be cached");
+
+        mu_assert( ltfat_arena_reset(arena) == LTFATERR_SUCCESS, "arena_reset");
+        ltfat_arena_get_used(arena, &used);
+        mu_assert( used == 0, "Arena not empty after reset");
+
+        free(mem);
+        ltfat_free(f);
+        ltfat_free(c);
+        ltfat_free(cref);
+    }
+
+    ltfat_set_memory_handler(oldhandler);
+    return 0;
+}
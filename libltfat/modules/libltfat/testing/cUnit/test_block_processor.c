@@ -0,0 +1,182 @@
+#include <pthread.h>
+#include <sched.h>
+
+static int
+TEST_NAME(block_processor_identity)(void* UNUSED(userdata), const LTFAT_REAL in[],
+                                    int winLen, int W, LTFAT_REAL out[])
+{
+    memcpy(out, in, winLen * W * sizeof * out);
+    return 0;
+}
+
+typedef struct
+{
+    LTFAT_NAME(block_processor_state)* p;
+    const LTFAT_REAL* in;
+    LTFAT_REAL* out;
+    ltfatInt Ltot, W;
+    const ltfatInt* Lb;
+    int pushed;  // Number of execute_io calls done
+    int seen;    // Value of pushed before the last complete compute pass
+    int iostatus, computestatus;
+} TEST_NAME(block_processor_spscdata);
+
+static void*
+TEST_NAME(block_processor_iothread)(void* userdata)
+{
+    TEST_NAME(block_processor_spscdata)* d = userdata;
+    const LTFAT_REAL* inptr[8];
+    LTFAT_REAL* outptr[8];
+    int call = 0;
+
+    for (ltfatInt l = 0; l < d->Ltot; l += d->Lb[call++])
+    {
+        // Let the I/O thread run at most one call ahead of the processing
+        while (__atomic_load_n(&d->seen, __ATOMIC_ACQUIRE) < call - 1)
+            sched_yield();
+
+        for (ltfatInt w = 0; w < d->W; w++)
+        {
+            inptr[w] = d->in + w * d->Ltot + l;
+            outptr[w] = d->out + w * d->Ltot + l;
+        }
+
+        int status = LTFAT_NAME(block_processor_execute_io)(d->p, inptr,
+                     d->Lb[call], d->W, d->Lb[call], outptr);
+        if (status != LTFATERR_SUCCESS) d->iostatus = status;
+
+        __atomic_store_n(&d->pushed, call + 1, __ATOMIC_RELEASE);
+    }
+
+    __atomic_store_n(&d->pushed, -1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void*
+TEST_NAME(block_processor_computethread)(void* userdata)
+{
+    TEST_NAME(block_processor_spscdata)* d = userdata;
+    int pushed;
+
+    while ((pushed = __atomic_load_n(&d->pushed, __ATOMIC_ACQUIRE)) >= 0)
+    {
+        if (LTFAT_NAME(block_processor_execute_compute)(d->p) < 0)
+            d->computestatus = LTFATERR_FAILED;
+
+        __atomic_store_n(&d->seen, pushed, __ATOMIC_RELEASE);
+        sched_yield();
+    }
+    return NULL;
+}
+
+int TEST_NAME(test_block_processor)()
+{
+    ltfatInt winLen = 32, hop = 8, W = 3, bufLenMax = 100, Ltot = 3000;
+    ltfatInt procDelay = winLen - 1, queueLen = 2 * bufLenMax;
+    ltfatInt Lb[200], Lbno = 0;
+    double tol = sizeof (LTFAT_REAL) == sizeof (double) ? 1e-10 : 1e-4;
+    double err = 0.0;
+    int ioerr = 0;
+
+    LTFAT_REAL* in = LTFAT_NAME_REAL(malloc)(Ltot * W);
+    LTFAT_REAL* out = LTFAT_NAME_REAL(malloc)(Ltot * W);
+    LTFAT_REAL* outspsc = LTFAT_NAME_REAL(malloc)(Ltot * W);
+    TEST_NAME(fillRand)(in, Ltot * W);
+
+    // Block lengths up to bufLenMax, not related to hop
+    for (ltfatInt l = 0; l < Ltot; l += Lb[Lbno++])
+        Lb[Lbno] = ltfat_imin(bufLenMax - (Lbno * 37) % 61, Ltot - l);
+
+    // The synchronous processor, the windows form a tight frame
+    LTFAT_NAME(block_processor_state)* p = NULL;
+    mu_assert( LTFAT_NAME(block_processor_init)(winLen, hop, W, bufLenMax,
+               procDelay, &p) == LTFATERR_SUCCESS, "block_processor_init");
+    mu_assert( LTFAT_NAME(block_processor_setcallback)(p,
+               &TEST_NAME(block_processor_identity), NULL) == LTFATERR_SUCCESS,
+               "block_processor_setcallback");
+    mu_assert( LTFAT_NAME(block_processor_setfirwin)(p, LTFAT_HANN, 1)
+               == LTFATERR_SUCCESS, "block_processor_setfirwin");
+
+    for (ltfatInt ii = 0, l = 0; ii < Lbno; l += Lb[ii++])
+    {
+        const LTFAT_REAL* inptr[3];
+        LTFAT_REAL* outptr[3];
+        for (ltfatInt w = 0; w < W; w++)
+        {
+            inptr[w] = in + w * Ltot + l;
+            outptr[w] = out + w * Ltot + l;
+        }
+        if (LTFAT_NAME(block_processor_execute)(p, inptr, Lb[ii], W, Lb[ii],
+                                                outptr) != LTFATERR_SUCCESS)
+            ioerr++;
+    }
+    mu_assert( ioerr == 0, "block_processor_execute");
+
+    mu_assert( LTFAT_NAME(block_processor_execute_compute)(p) == LTFATERR_NOTSUPPORTED,
+               "block_processor_execute_compute not in SPSC mode");
+    LTFAT_NAME(block_processor_done)(&p);
+
+    // Output is the input delayed by procDelay
+    for (ltfatInt w = 0; w < W; w++)
+    {
+        for (ltfatInt l = 0; l < procDelay; l++)
+            err += fabs(out[l + w * Ltot]);
+        for (ltfatInt l = procDelay; l < Ltot; l++)
+            err += fabs(out[l + w * Ltot] - in[l - procDelay + w * Ltot]);
+    }
+    mu_assert( err < tol * Ltot * W, "block_processor delays by procDelay");
+
+    // The same with the I/O and the processing in two threads
+    TEST_NAME(block_processor_spscdata) d;
+    pthread_t iothread, computethread;
+    mu_assert( LTFAT_NAME(block_processor_init_spsc)(winLen, hop, W, bufLenMax,
+               procDelay, queueLen, &p) == LTFATERR_SUCCESS,
+               "block_processor_init_spsc");
+    mu_assert( LTFAT_NAME(block_processor_setcallback)(p,
+               &TEST_NAME(block_processor_identity), NULL) == LTFATERR_SUCCESS,
+               "block_processor_setcallback");
+    mu_assert( LTFAT_NAME(block_processor_setfirwin)(p, LTFAT_HANN, 1)
+               == LTFATERR_SUCCESS, "block_processor_setfirwin");
+
+    d.p = p; d.in = in; d.out = outspsc; d.Ltot = Ltot; d.W = W; d.Lb = Lb;
+    d.pushed = 0; d.seen = 0; d.iostatus = LTFATERR_SUCCESS;
+    d.computestatus = LTFATERR_SUCCESS;
+
+    mu_assert( pthread_create(&computethread, NULL,
+                              &TEST_NAME(block_processor_computethread), &d) == 0 &&
+               pthread_create(&iothread, NULL,
+                              &TEST_NAME(block_processor_iothread), &d) == 0,
+               "Thread creation");
+    pthread_join(iothread, NULL);
+    pthread_join(computethread, NULL);
+    mu_assert( d.iostatus == LTFATERR_SUCCESS,
+               "block_processor_execute_io, no underflow");
+    mu_assert( d.computestatus == LTFATERR_SUCCESS,
+               "block_processor_execute_compute");
+
+    // Output equals the synchronous one delayed by queueLen
+    err = 0.0;
+    for (ltfatInt w = 0; w < W; w++)
+    {
+        for (ltfatInt l = 0; l < queueLen; l++)
+            err += fabs(outspsc[l + w * Ltot]);
+        for (ltfatInt l = queueLen; l < Ltot; l++)
+            err += fabs(outspsc[l + w * Ltot] - out[l - queueLen + w * Ltot]);
+    }
+    mu_assert( err == 0.0, "block_processor SPSC equals synchronous");
+
+    const LTFAT_REAL* inptr[3] = {in, in + Ltot, in + 2 * Ltot};
+    LTFAT_REAL* outptr[3] = {out, out + Ltot, out + 2 * Ltot};
+    mu_assert( LTFAT_NAME(block_processor_execute)(p, inptr, 10, W, 10, outptr)
+               == LTFATERR_NOTSUPPORTED, "block_processor_execute in SPSC mode");
+    mu_assert( LTFAT_NAME(block_processor_execute_io)(p, inptr, 10, W, 10, NULL)
+               == LTFATERR_NULLPOINTER, "block_processor_execute_io NULL");
+    LTFAT_NAME(block_processor_done)(&p);
+
+    mu_assert( LTFAT_NAME(block_processor_init_spsc)(winLen, hop, W, bufLenMax,
+               procDelay, 0, &p) == LTFATERR_NOTPOSARG,
+               "block_processor_init_spsc queueLen=0");
+
+    LTFAT_SAFEFREEALL(in, out, outspsc);
+    return 0;
+}
@@ -0,0 +1,73 @@
+int TEST_NAME(test_chzt)()
+{
+    ltfatInt L = 100, K = 37, W = 5, Wb[] = {1, 2, 5};
+    LTFAT_REAL deltao = (LTFAT_REAL) (2.0 * M_PI / 300.0), o = (LTFAT_REAL) 0.3;
+    czt_method method[] = {CZT_DIRECT, CZT_FAC, CZT_AUTO};
+    double tol = sizeof (LTFAT_REAL) == sizeof (double) ? 1e-9 : 1e-3;
+
+    LTFAT_TYPE* f = LTFAT_NAME(malloc)(L * W);
+    LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(K * W);
+    LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(K * W);
+    TEST_NAME(fillRand)(f, L * W);
+
+    // Direct evaluation of the z-transform
+    double nrm = 0.0, err = 0.0;
+    for (ltfatInt w = 0; w < W; w++)
+    {
+        for (ltfatInt k = 0; k < K; k++)
+        {
+            double _Complex s = 0.0;
+            for (ltfatInt l = 0; l < L; l++)
+                s += f[l + w * L] * cexp(-I * (o + k * deltao) * l);
+            cref[k + w * K] = (LTFAT_COMPLEX) s;
+            nrm += cabs(s);
+        }
+    }
+
+    LTFAT_NAME(chzt)(f, L, W, K, deltao, o, c);
+    for (ltfatInt n = 0; n < K * W; n++) err += sqrt(ltfat_energy(c[n] - cref[n]));
+    mu_assert( err < tol * nrm, "chzt");
+
+    err = 0.0;
+    LTFAT_NAME(chzt_fac)(f, L, W, K, deltao, o, c);
+    for (ltfatInt n = 0; n < K * W; n++) err += sqrt(ltfat_energy(c[n] - cref[n]));
+    mu_assert( err < tol * nrm, "chzt_fac");
+
+    for (unsigned int mId = 0; mId < ARRAYLEN(method); mId++)
+    {
+        for (unsigned int bId = 0; bId < ARRAYLEN(Wb); bId++)
+        {
+            // The second plan reuses the tables of the first one
+            LTFAT_NAME(chzt_plan) p[2] = {NULL, NULL};
+            for (int ii = 0; ii < 2; ii++)
+                mu_assert( LTFAT_NAME(chzt_init_batch)(K, L, deltao, o, Wb[bId],
+                           FFTW_ESTIMATE, CZT_NEXTFASTFFT, method[mId], &p[ii])
+                           == LTFATERR_SUCCESS, "chzt_init_batch");
+
+            int m = LTFAT_NAME(chzt_get_method)(p[0]);
+            mu_assert( m == (int) method[mId] ||
+                       (method[mId] == CZT_AUTO && (m == CZT_DIRECT || m == CZT_FAC)),
+                       "chzt_get_method");
+
+            for (int ii = 0; ii < 2; ii++)
+            {
+                err = 0.0;
+                LTFAT_NAME(chzt_execute)(p[ii], f, W, c);
+                for (ltfatInt n = 0; n < K * W; n++)
+                    err += sqrt(ltfat_energy(c[n] - cref[n]));
+                mu_assert( err < tol * nrm, "chzt_execute batch");
+                LTFAT_NAME(chzt_done)(p[ii]);
+            }
+        }
+    }
+
+    LTFAT_NAME(chzt_plan) p = NULL;
+    mu_assert( LTFAT_NAME(chzt_init_batch)(K, L, deltao, o, 0, FFTW_ESTIMATE,
+               CZT_NEXTFASTFFT, CZT_DIRECT, &p) == LTFATERR_NOTPOSARG,
+               "chzt_init_batch Wb=0");
+    mu_assert( LTFAT_NAME(chzt_cache_clear)() == LTFATERR_SUCCESS,
+               "chzt_cache_clear");
+
+    LTFAT_SAFEFREEALL(f, cref, c);
+    return 0;
+}
@@ -0,0 +1,196 @@
+/* X[E + i] is in[i] extended as the plans do it: E samples on both sides
+ * from extend_left/extend_right, zeros beyond */
+static void
+TEST_NAME(convsub_td_extend)(const LTFAT_TYPE in[], ltfatInt Lin, ltfatInt E,
+                             ltfatInt extl, ltfatExtType ext, ltfatInt exta,
+                             LTFAT_TYPE X[])
+{
+    LTFAT_NAME(clear_array)(X, Lin + 2 * E);
+    LTFAT_NAME(extend_left)(in, Lin, X, E, extl, ext, exta);
+    memcpy(X + E, in, Lin * sizeof * X);
+    LTFAT_NAME(extend_right)(in, Lin, X + E + Lin, extl, ext, exta);
+}
+
+/* Checks one plan pair against
+ *
+ *   c[n] = sum_j g[j] X[a*n - skip - j*ga]
+ *   f[l] = sum_j conj(g[j]) C[n],   a*n - skip - j*ga = l
+ *
+ * with X the extended f and C the periodically (PER) or zero extended c.
+ * With atrous, a is the dilation ga and the subsampling factor is 1. */
+static int
+TEST_NAME(convsub_td_check)(ltfatInt L, ltfatInt gl, ltfatInt a,
+                            ltfatInt skip, ltfatExtType ext,
+                            const char* extname, int atrous)
+{
+    ltfatInt ga = atrous ? a : 1, sub = atrous ? 1 : a;
+    ltfatInt extl = (gl - 1) * ga + 1, E = extl + sub;
+    ltfatInt N = atrous ? L : filterbank_td_size(L, a, gl, skip, ext);
+    double tol = sizeof (LTFAT_REAL) == sizeof (double) ? 1e-10 : 1e-4;
+    double err = 0.0, nrm = 0.0;
+    LTFAT_TYPE* g = LTFAT_NAME(malloc)(gl);
+    LTFAT_TYPE* gc = LTFAT_NAME(malloc)(gl);
+    LTFAT_TYPE* f = LTFAT_NAME(malloc)(L);
+    LTFAT_TYPE* X = LTFAT_NAME(malloc)(L + 2 * E);
+    LTFAT_TYPE* fup = LTFAT_NAME(malloc)(L);
+    LTFAT_TYPE* fref = LTFAT_NAME(calloc)(L);
+    LTFAT_TYPE* c = LTFAT_NAME(malloc)(N);
+    LTFAT_TYPE* c2 = LTFAT_NAME(malloc)(N);
+    LTFAT_TYPE* C = LTFAT_NAME(malloc)(N + 2 * E);
+    LTFAT_NAME(convsub_td_plan)* p = NULL;
+    LTFAT_NAME(upconv_td_plan)* pu = NULL;
+    TEST_NAME(fillRand)(g, gl);
+    TEST_NAME(fillRand)(f, L);
+    TEST_NAME(fillRand)(c2, N);
+    LTFAT_NAME(conjugate_array)(g, gl, gc);
+
+    if (atrous)
+    {
+        mu_assert( LTFAT_NAME(atrousconvsub_td_init)(g, L, gl, ga, skip, ext, &p)
+                   == LTFATERR_SUCCESS, "atrousconvsub_td_init");
+        mu_assert( LTFAT_NAME(atrousupconv_td_init)(g, L, gl, ga, skip, ext, &pu)
+                   == LTFATERR_SUCCESS, "atrousupconv_td_init");
+    }
+    else
+    {
+        mu_assert( LTFAT_NAME(convsub_td_init)(g, L, gl, a, skip, ext, &p)
+                   == LTFATERR_SUCCESS, "convsub_td_init");
+        mu_assert( LTFAT_NAME(upconv_td_init)(g, L, gl, a, skip, ext, &pu)
+                   == LTFATERR_SUCCESS, "upconv_td_init");
+    }
+    mu_assert( LTFAT_NAME(convsub_td_get_outlen)(p) == N &&
+               LTFAT_NAME(upconv_td_get_inlen)(pu) == N, "td plan lengths");
+
+    mu_assert( LTFAT_NAME(convsub_td_execute)(p, f, c) == LTFATERR_SUCCESS,
+               "convsub_td_execute");
+    TEST_NAME(convsub_td_extend)(f, L, E, extl, ext, atrous ? 1 : a, X);
+    for (ltfatInt n = 0; n < N; n++)
+    {
+        LTFAT_TYPE ref = 0;
+        for (ltfatInt j = 0; j < gl; j++)
+        {
+            ltfatInt l = sub * n - skip - j * ga;
+            if (l >= -E && l < L + E) ref += g[j] * X[E + l];
+        }
+        err += sqrt(ltfat_energy(ref - c[n]));
+        nrm += sqrt(ltfat_energy(ref));
+    }
+    mu_assert( err <= tol * nrm, "%s %s L=%td gl=%td a=%td skip=%td equals "
+               "the formula", atrous ? "atrousconvsub_td" : "convsub_td",
+               extname, L, gl, a, skip);
+
+    LTFAT_NAME(clear_array)(fup, L);
+    mu_assert( LTFAT_NAME(upconv_td_execute)(pu, c2, fup) == LTFATERR_SUCCESS,
+               "upconv_td_execute");
+    TEST_NAME(convsub_td_extend)(c2, N, E, extl, ext == PER ? PER : ZERO, 0, C);
+    for (ltfatInt n = -E; n < N + E; n++)
+    {
+        for (ltfatInt j = 0; j < gl; j++)
+        {
+            ltfatInt l = sub * n - skip - j * ga;
+            if (l >= 0 && l < L) fref[l] += gc[j] * C[E + n];
+        }
+    }
+    err = 0.0; nrm = 0.0;
+    for (ltfatInt l = 0; l < L; l++)
+    {
+        err += sqrt(ltfat_energy(fref[l] - fup[l]));
+        nrm += sqrt(ltfat_energy(fref[l]));
+    }
+    mu_assert( err <= tol * nrm, "%s %s L=%td gl=%td a=%td skip=%td equals "
+               "the formula", atrous ? "atrousupconv_td" : "upconv_td",
+               extname, L, gl, a, skip);
+
+    // Both sides are extended by zeros, the upconv plan is the adjoint
+    if (ext == ZERO || ext == VALID)
+    {
+        LTFAT_TYPE ipc = 0, ipf = 0;
+        LTFAT_NAME(conjugate_array)(c2, N, c2);
+        LTFAT_NAME(conjugate_array)(fup, L, fup);
+        for (ltfatInt n = 0; n < N; n++) ipc += c[n] * c2[n];
+        for (ltfatInt l = 0; l < L; l++) ipf += f[l] * fup[l];
+        mu_assert( sqrt(ltfat_energy(ipc - ipf)) <
+                   tol * (1.0 + sqrt(ltfat_energy(ipc))), "upconv_td is adjoint");
+    }
+
+    // In-place filtering, N <= L in all cases
+    mu_assert( LTFAT_NAME(convsub_td_execute)(p, f, f) == LTFATERR_SUCCESS &&
+               memcmp(f, c, N * sizeof * c) == 0, "convsub_td inplace");
+
+    mu_assert( LTFAT_NAME(convsub_td_done)(&p) == LTFATERR_SUCCESS && p == NULL,
+               "convsub_td_done");
+    mu_assert( LTFAT_NAME(upconv_td_done)(&pu) == LTFATERR_SUCCESS && pu == NULL,
+               "upconv_td_done");
+    LTFAT_SAFEFREEALL(g, gc, f, X, fup, fref, c, c2, C);
+    return 0;
+}
+
+int TEST_NAME(test_convsub_td)()
+{
+    // The last three have |skip| > gl - 1
+    ltfatInt L[]    = {37, 256, 1000,  37, 64, 64};
+    ltfatInt gl[]   = { 7,   1,   40,   7,  5,  5};
+    ltfatInt a[]    = { 3,   2,    4,   3,  4,  4};
+    ltfatInt skip[] = {-3,   0,  -39, -12, -5,  6};
+    // a is the dilation, the last one has |skip| > (gl - 1) * a
+    ltfatInt Lat[]    = {64, 37, 50};
+    ltfatInt glat[]   = { 4,  3,  5};
+    ltfatInt aat[]    = { 2,  4,  3};
+    ltfatInt skipat[] = {-3,  0, -15};
+    ltfatExtType exts[] = {PER, PERDEC, SYM, EVEN, ODD, ZERO, VALID};
+    const char* extnames[] = {"per", "perdec", "sym", "even", "odd", "zero",
+                              "valid"
+                             };
+
+    for (unsigned int eId = 0; eId < ARRAYLEN(exts); eId++)
+    {
+        for (unsigned int lId = 0; lId < ARRAYLEN(L); lId++)
+            mu_assert( TEST_NAME(convsub_td_check)(L[lId], gl[lId], a[lId],
+                       skip[lId], exts[eId], extnames[eId], 0) == 0,
+                       "convsub_td %s", extnames[eId]);
+
+        for (unsigned int lId = 0; lId < ARRAYLEN(Lat); lId++)
+            mu_assert( TEST_NAME(convsub_td_check)(Lat[lId], glat[lId], aat[lId],
+                       skipat[lId], exts[eId], extnames[eId], 1) == 0,
+                       "atrousconvsub_td %s", extnames[eId]);
+    }
+
+    LTFAT_NAME(convsub_td_plan)* p = NULL;
+    LTFAT_TYPE g[3] = {1, 2, 3};
+    mu_assert( LTFAT_NAME(convsub_td_init)(NULL, 10, 3, 1, 0, ZERO, &p)
+               == LTFATERR_NULLPOINTER, "convsub_td_init NULL");
+    mu_assert( LTFAT_NAME(convsub_td_init)(g, 10, 3, 0, 0, ZERO, &p)
+               == LTFATERR_NOTPOSARG, "convsub_td_init a=0");
+    mu_assert( LTFAT_NAME(convsub_td_init)(g, 10, 3, 1, 0, BAD_TYPE, &p)
+               == LTFATERR_BADARG, "convsub_td_init bad ext");
+
+    // A channel that cannot be planned leaves all outputs as they were
+    {
+        const LTFAT_TYPE* gs[2] = {g, g};
+        ltfatInt gls[2] = {3, 0}, as[2] = {1, 1}, skips[2] = {0, 0};
+        LTFAT_TYPE f[10], fout[10], c0[12], c1[12], cat[20];
+        LTFAT_TYPE* cs[2] = {c0, c1};
+        int untouched = 1;
+        TEST_NAME(fillRand)(f, 10);
+        LTFAT_NAME(clear_array)(c0, 12);
+        LTFAT_NAME(clear_array)(c1, 12);
+        LTFAT_NAME(clear_array)(cat, 20);
+        memcpy(fout, f, sizeof f);
+
+        LTFAT_NAME(filterbank_td)(f, gs, 10, gls, 1, as, skips, 2, cs, ZERO);
+        LTFAT_NAME(atrousfilterbank_td)(f, gs, 10, gls, 1, as, skips, 2, cat,
+                                        ZERO);
+        for (ltfatInt ii = 0; ii < 12; ii++) untouched &= c0[ii] == 0;
+        for (ltfatInt ii = 0; ii < 20; ii++) untouched &= cat[ii] == 0;
+        mu_assert( untouched, "filterbank_td with an invalid channel leaves c");
+
+        LTFAT_NAME(ifilterbank_td)((const LTFAT_TYPE**) cs, gs, 10, gls, 1, as,
+                                   skips, 2, fout, ZERO);
+        LTFAT_NAME(iatrousfilterbank_td)(cat, gs, 10, gls, 1, as, skips, 2, fout,
+                                         ZERO);
+        mu_assert( memcmp(fout, f, sizeof f) == 0,
+                   "ifilterbank_td with an invalid channel leaves f");
+    }
+
+    return 0;
+}
@@ -26,9 +26,37 @@ int TEST_NAME(test_dgt_fb)()
             LTFAT_NAME(dgt_fb)(f, g, L[id], gl[id], W[id], a[id], M[id], LTFAT_TIMEINV, c)
             == LTFATERR_SUCCESS, "dgt_fb TIMEINV");
 
+        // Batched FFT must give the same coefficients
+        LTFAT_COMPLEX* cb = LTFAT_NAME_COMPLEX(malloc)(M[id] * N * W[id]);
+        LTFAT_NAME(dgt_fb_plan)* p = NULL;
+        mu_assert(
+            LTFAT_NAME(dgt_fb_init)(g, gl[id], a[id], M[id], LTFAT_TIMEINV,
+                                    FFTW_ESTIMATE, &p) == LTFATERR_SUCCESS,
+            "dgt_fb_init");
+
+        mu_assert(
+            LTFAT_NAME(dgt_fb_set_batchsize)(p, 4) == LTFATERR_SUCCESS,
+            "dgt_fb_set_batchsize");
+
+        mu_assert(
+            LTFAT_NAME(dgt_fb_execute)(p, f, L[id], W[id], cb) == LTFATERR_SUCCESS,
+            "dgt_fb_execute batched");
+
+        LTFAT_REAL err = 0;
+        for (ltfatInt ii = 0; ii < M[id] * N * W[id]; ii++)
+            if (ltfat_energy(cb[ii] - c[ii]) > err) err = ltfat_energy(cb[ii] - c[ii]);
+        mu_assert( err < 1e-8, "dgt_fb batched differs");
+
+        mu_assert(
+            LTFAT_NAME(dgt_fb_set_batchsize)(p, 0) == LTFATERR_NOTPOSARG,
+            "Batch size is not positive");
+
+        LTFAT_NAME(dgt_fb_done)(&p);
+
         ltfat_free(f);
         ltfat_free(g);
         ltfat_free(c);
+        ltfat_free(cb);
     }
 
     ltfatInt N = L[0] / a[0];
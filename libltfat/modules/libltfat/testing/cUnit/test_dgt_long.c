@@ -25,6 +25,26 @@ int TEST_NAME(test_dgt_long)()
             LTFAT_NAME(dgt_long)(f, g, L[id], W[id], a[id], M[id], LTFAT_TIMEINV, c)
             == LTFATERR_SUCCESS, "dgt_long TIMEINV");
 
+        // The threaded execution must give exactly the serial result
+        LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(M[id] * N * W[id]);
+        LTFAT_NAME(dgt_long_plan)* p = NULL;
+        mu_assert(
+            LTFAT_NAME(dgt_long_init)(g, L[id], W[id], a[id], M[id], f, cref,
+                                      LTFAT_FREQINV, FFTW_ESTIMATE, &p)
+            == LTFATERR_SUCCESS, "dgt_long_init");
+        mu_assert( LTFAT_NAME(dgt_long_execute)(p) == LTFATERR_SUCCESS,
+                   "dgt_long_execute");
+        mu_assert( LTFAT_NAME(dgt_long_set_nthreads)(p, 4) == LTFATERR_SUCCESS,
+                   "dgt_long_set_nthreads");
+        mu_assert( LTFAT_NAME(dgt_long_execute_newarray)(p, f, c) == LTFATERR_SUCCESS,
+                   "dgt_long_execute_newarray");
+        mu_assert( memcmp(c, cref, M[id] * N * W[id] * sizeof * c) == 0,
+                   "Threaded dgt_long equals serial");
+        mu_assert( LTFAT_NAME(dgt_long_set_nthreads)(p, -1) == LTFATERR_BADARG,
+                   "Negative nthreads");
+        LTFAT_NAME(dgt_long_done)(&p);
+        ltfat_free(cref);
+
         ltfat_free(f);
         ltfat_free(g);
         ltfat_free(c);
@@ -0,0 +1,96 @@
+static int
+TEST_NAME(dgtrealmp_run)(ltfat_dgtmp_alg alg, size_t batchsize,
+                         ltfatInt batchthreads, size_t maxit,
+                         const LTFAT_REAL f[], ltfatInt L,
+                         LTFAT_COMPLEX c[], LTFAT_REAL fout[],
+                         double* errdb, size_t* iters)
+{
+    LTFAT_NAME(dgtrealmp_parbuf)* pb = NULL;
+    LTFAT_NAME(dgtrealmp_state)* p = NULL;
+    int status;
+
+    if ((status = LTFAT_NAME(dgtrealmp_parbuf_init)(&pb))) return status;
+
+    if ((status = LTFAT_NAME(dgtrealmp_parbuf_add_firwin)(pb, LTFAT_HANN,
+                  128, 32, 256)) ||
+        (status = LTFAT_NAME(dgtrealmp_setparbuf_snrdb)(pb, 200)) ||
+        (status = LTFAT_NAME(dgtrealmp_setparbuf_maxatoms)(pb, L)) ||
+        (status = LTFAT_NAME(dgtrealmp_setparbuf_maxit)(pb, maxit)) ||
+        (status = LTFAT_NAME(dgtrealmp_setparbuf_iterstep)(pb, 10)) ||
+        (status = LTFAT_NAME(dgtrealmp_setparbuf_alg)(pb, alg)) ||
+        (status = LTFAT_NAME(dgtrealmp_setparbuf_batchsize)(pb, batchsize)) ||
+        (status = LTFAT_NAME(dgtrealmp_setparbuf_batchthreads)(pb, batchthreads)) ||
+        (status = LTFAT_NAME(dgtrealmp_init)(pb, L, &p)))
+    {
+        LTFAT_NAME(dgtrealmp_parbuf_done)(&pb);
+        return status;
+    }
+    LTFAT_NAME(dgtrealmp_parbuf_done)(&pb);
+
+    status = LTFAT_NAME(dgtrealmp_execute_compact)(p, f, c, fout);
+    if (status >= 0)
+    {
+        LTFAT_NAME(dgtrealmp_get_errdb)(p, errdb);
+        LTFAT_NAME(dgtrealmp_get_numiters)(p, iters);
+        status = LTFATERR_SUCCESS;
+    }
+
+    LTFAT_NAME(dgtrealmp_done)(&p);
+    return status;
+}
+
+int TEST_NAME(test_dgtrealmp)()
+{
+    ltfatInt L = 2048, clen = 129 * 64;
+    size_t maxit = L / 16 + 3;
+    double errdb, errdbmp;
+    size_t iters, itersmp;
+
+    LTFAT_REAL* f = LTFAT_NAME_REAL(malloc)(L);
+    LTFAT_REAL* fout = LTFAT_NAME_REAL(malloc)(L);
+    LTFAT_REAL* foutmp = LTFAT_NAME_REAL(malloc)(L);
+    LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(clen);
+    LTFAT_COMPLEX* cmp = LTFAT_NAME_COMPLEX(malloc)(clen);
+    LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(clen);
+    TEST_NAME(fillRand)(f, L);
+
+    mu_assert( TEST_NAME(dgtrealmp_run)(ltfat_dgtmp_alg_mp, 1, 1, maxit, f, L,
+               cmp, foutmp, &errdbmp, &itersmp) == LTFATERR_SUCCESS,
+               "dgtrealmp mp");
+    mu_assert( itersmp == maxit, "dgtrealmp mp does maxit iterations");
+
+    // A batch of one atom is plain MP
+    mu_assert( TEST_NAME(dgtrealmp_run)(ltfat_dgtmp_alg_batchmp, 1, 1, maxit,
+               f, L, c, fout, &errdb, &iters) == LTFATERR_SUCCESS,
+               "dgtrealmp batchmp batchsize=1");
+    mu_assert( iters == itersmp &&
+               memcmp(c, cmp, clen * sizeof * c) == 0 &&
+               memcmp(fout, foutmp, L * sizeof * fout) == 0,
+               "dgtrealmp batchmp batchsize=1 equals mp");
+
+    /* Bigger batches do not exceed maxit and do not depend on the thread
+     * count. maxit is not a multiple of iterstep, so the last batch is cut
+     * by maxit. */
+    mu_assert( TEST_NAME(dgtrealmp_run)(ltfat_dgtmp_alg_batchmp, 8, 1, maxit,
+               f, L, cref, fout, &errdb, &iters) == LTFATERR_SUCCESS,
+               "dgtrealmp batchmp batchsize=8");
+    mu_assert( iters == maxit, "dgtrealmp batchmp does maxit iterations");
+    mu_assert( fabs(errdb - errdbmp) < 0.5,
+               "dgtrealmp batchmp SNR within 0.5 dB of mp");
+
+    for (ltfatInt nthreads = 2; nthreads <= 4; nthreads++)
+    {
+        size_t itersthr;
+        double errdbthr;
+        mu_assert( TEST_NAME(dgtrealmp_run)(ltfat_dgtmp_alg_batchmp, 8,
+                   nthreads, maxit, f, L, c, foutmp, &errdbthr, &itersthr)
+                   == LTFATERR_SUCCESS, "dgtrealmp batchmp threads");
+        mu_assert( itersthr == iters && errdbthr == errdb &&
+                   memcmp(c, cref, clen * sizeof * c) == 0 &&
+                   memcmp(foutmp, fout, L * sizeof * fout) == 0,
+                   "dgtrealmp batchmp threads=%td equals threads=1", nthreads);
+    }
+
+    LTFAT_SAFEFREEALL(f, fout, foutmp, c, cmp, cref);
+    return 0;
+}
@@ -0,0 +1,74 @@
+int TEST_NAME(test_fftcache)()
+{
+    ltfatInt L[] = {111, 1, 100, 1024};
+    ltfatInt W = 3;
+
+    mu_assert( ltfat_fftcache_getcount() == 0, "Cache is disabled by default");
+    mu_assert( ltfat_fftcache_setcapacity(32) == LTFATERR_SUCCESS,
+               "fftcache_setcapacity");
+
+    for (unsigned int lId = 0; lId < ARRAYLEN(L); lId++)
+    {
+        ltfatInt M2 = L[lId] / 2 + 1;
+        LTFAT_REAL* f = LTFAT_NAME_REAL(malloc)(L[lId] * W);
+        LTFAT_REAL* fref = LTFAT_NAME_REAL(malloc)(L[lId] * W);
+        LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(M2 * W);
+        LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(M2 * W);
+        TEST_NAME(fillRand)(fref, L[lId] * W);
+
+        LTFAT_NAME(fftreal_plan)* p = NULL;
+        LTFAT_NAME(ifftreal_plan)* ip = NULL;
+
+        // The second round gets the plans from the cache
+        for (int round = 0; round < 2; round++)
+        {
+            memcpy(f, fref, L[lId] * W * sizeof * f);
+            mu_assert( LTFAT_NAME(fftreal_init)(L[lId], W, f, c, FFTW_ESTIMATE, &p)
+                       == LTFATERR_SUCCESS, "fftreal_init");
+            mu_assert( LTFAT_NAME(ifftreal_init)(L[lId], W, c, f, FFTW_ESTIMATE, &ip)
+                       == LTFATERR_SUCCESS, "ifftreal_init");
+
+            mu_assert( LTFAT_NAME(fftreal_execute)(p) == LTFATERR_SUCCESS,
+                       "fftreal_execute");
+            if (round == 0)
+                memcpy(cref, c, M2 * W * sizeof * c);
+            else
+                mu_assert( memcmp(cref, c, M2 * W * sizeof * c) == 0,
+                           "Cached plan gives a different result");
+
+            mu_assert( LTFAT_NAME(ifftreal_execute)(ip) == LTFATERR_SUCCESS,
+                       "ifftreal_execute");
+            LTFAT_REAL err = 0;
+            for (ltfatInt ii = 0; ii < L[lId] * W; ii++)
+            {
+                f[ii] /= L[lId];
+                err += ltfat_abs(f[ii] - fref[ii]);
+            }
+            mu_assert( err < 1e-3, "Reconstruction");
+
+            mu_assert( LTFAT_NAME(fftreal_done)(&p) == LTFATERR_SUCCESS,
+                       "fftreal_done");
+            mu_assert( LTFAT_NAME(ifftreal_done)(&ip) == LTFATERR_SUCCESS,
+                       "ifftreal_done");
+            mu_assert( ltfat_fftcache_getcount() == 2 * (ltfatInt)(lId + 1),
+                       "Released plans should be cached");
+        }
+
+        ltfat_free(f);
+        ltfat_free(fref);
+        ltfat_free(c);
+        ltfat_free(cref);
+    }
+
+    mu_assert( ltfat_fftcache_setcapacity(1) == LTFATERR_SUCCESS,
+               "fftcache_setcapacity");
+    mu_assert( ltfat_fftcache_getcount() == 1, "Capacity not respected");
+    mu_assert( ltfat_fftcache_setcapacity(-1) == LTFATERR_BADARG,
+               "Negative capacity");
+    mu_assert( ltfat_fftcache_clear() == LTFATERR_SUCCESS, "fftcache_clear");
+    mu_assert( ltfat_fftcache_getcount() == 0, "Cache not empty");
+    mu_assert( ltfat_fftcache_setcapacity(0) == LTFATERR_SUCCESS,
+               "fftcache_setcapacity");
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+int TEST_NAME(test_fold_array)()
+{
+    ltfatInt Lin[]    = {111, 1, 100, 1000};
+    ltfatInt Lfold[]  = { 16, 1,  33,  257};
+    ltfatInt offset[] = { 0, 1, -5, 40};
+
+    ltfat_simd_level maxlevel = ltfat_simd_get_maxlevel();
+
+    for (unsigned int lId = 0; lId < ARRAYLEN(Lin); lId++)
+    {
+        LTFAT_TYPE* fin = LTFAT_NAME(malloc)(Lin[lId]);
+        TEST_NAME(fillRand)(fin, Lin[lId]);
+        LTFAT_TYPE* fref = LTFAT_NAME(malloc)(Lfold[lId]);
+        LTFAT_TYPE* fout = LTFAT_NAME(malloc)(Lfold[lId]);
+
+        for (unsigned int offId = 0; offId < ARRAYLEN(offset); offId++)
+        {
+            // The scalar loop is the reference
+            mu_assert( ltfat_simd_set_level(LTFAT_SIMD_NONE) == LTFATERR_SUCCESS,
+                       "simd_set_level none");
+            mu_assert( LTFAT_NAME(fold_array)(fin, Lin[lId], offset[offId],
+                                              Lfold[lId], fref) == 0,
+                       "fold_array scalar");
+
+            for (int level = LTFAT_SIMD_SSE2; level <= (int) maxlevel; level++)
+            {
+                mu_assert( ltfat_simd_set_level((ltfat_simd_level) level)
+                           == LTFATERR_SUCCESS, "simd_set_level");
+                mu_assert( LTFAT_NAME(fold_array)(fin, Lin[lId], offset[offId],
+                                                  Lfold[lId], fout) == 0,
+                           "fold_array simd");
+                mu_assert( memcmp(fref, fout, Lfold[lId] * sizeof * fout) == 0,
+                           "fold_array simd differs from scalar");
+            }
+        }
+        ltfat_free(fin);
+        ltfat_free(fref);
+        ltfat_free(fout);
+    }
+
+    ltfat_simd_set_level(maxlevel);
+
+    mu_assert( ltfat_simd_set_level((ltfat_simd_level) 10) == LTFATERR_CANNOTHAPPEN,
+               "Wrong enum value");
+
+    return 0;
+}
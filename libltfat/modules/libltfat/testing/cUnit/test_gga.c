@@ -0,0 +1,103 @@
+int TEST_NAME(test_gga)()
+{
+    ltfatInt L = 2500, W = 2, M = 150;
+    // Goertzel in single precision loses accuracy with the signal length
+    int isdouble = sizeof (LTFAT_REAL) == sizeof (double);
+    double tol = isdouble ? 1e-8 : 2e-2, slidtol = isdouble ? 1e-10 : 1e-3;
+    ltfat_simd_level maxlevel = ltfat_simd_get_maxlevel();
+
+    LTFAT_REAL* ind = LTFAT_NAME_REAL(malloc)(M);
+    LTFAT_TYPE* f = LTFAT_NAME(malloc)(L * W);
+    LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(M * W);
+    LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(M * W);
+    TEST_NAME(fillRand)(f, L * W);
+
+    for (ltfatInt m = 0; m < M; m++)
+        ind[m] = (LTFAT_REAL) (0.37 * m * m);
+
+    // Direct evaluation of the DFT at the frequencies
+    double err = 0.0, nrm = 0.0;
+    LTFAT_NAME(gga)(f, ind, L, W, M, c);
+    for (ltfatInt w = 0; w < W; w++)
+    {
+        for (ltfatInt m = 0; m < M; m++)
+        {
+            double _Complex s = 0.0;
+            for (ltfatInt l = 0; l < L; l++)
+                s += f[l + w * L] * cexp(-I * 2.0 * M_PI * ind[m] * l / L);
+            err += cabs(s - c[m + w * M]);
+            nrm += cabs(s);
+        }
+    }
+    mu_assert( err < tol * nrm, "gga equals DFT");
+
+    // The scalar loop is the reference for all the instruction sets and
+    // thread counts
+    LTFAT_NAME(gga_plan) p = LTFAT_NAME(gga_init)(ind, M, L);
+    mu_assert( ltfat_simd_set_level(LTFAT_SIMD_NONE) == LTFATERR_SUCCESS,
+               "simd_set_level none");
+    LTFAT_NAME(gga_execute)(p, f, W, cref);
+
+    for (int level = LTFAT_SIMD_SSE2; level <= (int) maxlevel; level++)
+    {
+        mu_assert( ltfat_simd_set_level((ltfat_simd_level) level)
+                   == LTFATERR_SUCCESS, "simd_set_level");
+        LTFAT_NAME(gga_execute)(p, f, W, c);
+        mu_assert( memcmp(cref, c, M * W * sizeof * c) == 0,
+                   "gga simd differs from scalar");
+    }
+
+    mu_assert( LTFAT_NAME(gga_set_nthreads)(p, 3) == LTFATERR_SUCCESS,
+               "gga_set_nthreads");
+    LTFAT_NAME(gga_execute)(p, f, W, c);
+    mu_assert( memcmp(cref, c, M * W * sizeof * c) == 0, "gga threads");
+    mu_assert( LTFAT_NAME(gga_set_nthreads)(p, -1) == LTFATERR_BADARG,
+               "gga_set_nthreads negative");
+    LTFAT_NAME(gga_done)(p);
+    ltfat_simd_set_level(maxlevel);
+
+    // Sliding: the bins after every block equal gga of the last Lw samples
+    {
+        ltfatInt Lw = 64, Mw = 10, Lbmax = 50;
+        LTFAT_NAME(gga_sliding_plan)* sp = NULL;
+        LTFAT_TYPE* fz = LTFAT_NAME(calloc)(Lw + L);
+        memcpy(fz + Lw, f, L * sizeof * f);
+        err = 0.0; nrm = 0.0;
+
+        mu_assert( LTFAT_NAME(gga_sliding_init)(ind, Mw, Lw, &sp)
+                   == LTFATERR_SUCCESS, "gga_sliding_init");
+
+        for (ltfatInt l = 0, Lb = 0; l < L; l += Lb)
+        {
+            Lb = ltfat_imin(rand() % (Lbmax + 1), L - l);
+            mu_assert( LTFAT_NAME(gga_sliding_execute)(sp, f + l, Lb, c)
+                       == LTFATERR_SUCCESS, "gga_sliding_execute");
+            LTFAT_NAME(gga)(fz + l + Lb, ind, Lw, 1, Mw, cref);
+
+            for (ltfatInt m = 0; m < Mw; m++)
+            {
+                err += sqrt(ltfat_energy(cref[m] - c[m]));
+                nrm += sqrt(ltfat_energy(cref[m]));
+            }
+        }
+        mu_assert( err < slidtol * nrm, "gga_sliding equals gga");
+
+        LTFAT_NAME(gga_sliding_reset)(sp);
+        mu_assert( LTFAT_NAME(gga_sliding_execute)(sp, f, 0, c)
+                   == LTFATERR_SUCCESS, "gga_sliding_execute empty");
+        for (ltfatInt m = 0; m < Mw; m++)
+            mu_assert( c[m] == 0, "gga_sliding_reset");
+
+        mu_assert( LTFAT_NAME(gga_sliding_execute)(sp, f, -1, c)
+                   == LTFATERR_BADARG, "gga_sliding_execute negative Lb");
+        LTFAT_NAME(gga_sliding_done)(&sp);
+        ltfat_free(fz);
+    }
+
+    LTFAT_NAME(gga_sliding_plan)* sp = NULL;
+    mu_assert( LTFAT_NAME(gga_sliding_init)(ind, 0, L, &sp) == LTFATERR_NOTPOSARG,
+               "gga_sliding_init M=0");
+
+    LTFAT_SAFEFREEALL(ind, f, cref, c);
+    return 0;
+}
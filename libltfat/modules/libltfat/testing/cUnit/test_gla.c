@@ -0,0 +1,68 @@
+static int
+TEST_NAME(gla_run)(const LTFAT_COMPLEX cinit[], const LTFAT_REAL g[],
+                   ltfatInt L, ltfatInt gl, ltfatInt W, ltfatInt a, ltfatInt M,
+                   double alpha, ltfatInt nthreads, LTFAT_COMPLEX c[])
+{
+    PHASERET_NAME(gla_plan)* p = NULL;
+    ltfat_dgt_params* params = ltfat_dgt_params_allocdef();
+    int status;
+
+    if (!params) return LTFATERR_NOMEM;
+
+    if (!(status = ltfat_dgt_setpar_nthreads(params, nthreads)) &&
+        !(status = PHASERET_NAME(gla_init)(cinit, g, L, gl, W, a, M, alpha, c,
+                   params, &p)))
+    {
+        status = PHASERET_NAME(gla_execute)(p, NULL, 5);
+        PHASERET_NAME(gla_done)(&p);
+    }
+
+    ltfat_dgt_params_free(params);
+    return status;
+}
+
+int TEST_NAME(test_gla)()
+{
+    ltfatInt L = 4096, gl = 256, a = 64, M = 256, M2 = M / 2 + 1;
+    ltfatInt Ws[] = {1, 3};
+    double alphas[] = {0.0, 0.99};
+
+    LTFAT_REAL* f = LTFAT_NAME_REAL(malloc)(L * 3);
+    LTFAT_REAL* g = LTFAT_NAME_REAL(malloc)(gl);
+    LTFAT_COMPLEX* cinit = LTFAT_NAME_COMPLEX(malloc)(M2 * (L / a) * 3);
+    LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(M2 * (L / a) * 3);
+    LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(M2 * (L / a) * 3);
+    TEST_NAME(fillRand)(f, L * 3);
+    LTFAT_NAME(firwin)(LTFAT_HANN, gl, g);
+
+    // Magnitudes with zero phase, so that the iterations have work to do
+    mu_assert( LTFAT_NAME(dgtreal_fb)(f, g, L, gl, 3, a, M, LTFAT_FREQINV, cinit)
+               == LTFATERR_SUCCESS, "dgtreal_fb");
+    for (ltfatInt ii = 0; ii < M2 * (L / a) * 3; ii++)
+        cinit[ii] = sqrt(ltfat_energy(cinit[ii]));
+
+    /* The result does not depend on the number of threads. With W > 1,
+     * the channels are transformed by separate plans in parallel. Blocks of
+     * the projection are split among the threads for any W. */
+    for (int wi = 0; wi < 2; wi++)
+    {
+        for (int ai = 0; ai < 2; ai++)
+        {
+            ltfatInt W = Ws[wi], clen = M2 * (L / a) * W;
+            mu_assert( TEST_NAME(gla_run)(cinit, g, L, gl, W, a, M, alphas[ai],
+                       1, cref) == LTFATERR_SUCCESS, "gla W=%td", W);
+
+            for (ltfatInt nthreads = 2; nthreads <= 4; nthreads++)
+            {
+                mu_assert( TEST_NAME(gla_run)(cinit, g, L, gl, W, a, M,
+                           alphas[ai], nthreads, c) == LTFATERR_SUCCESS,
+                           "gla threads");
+                mu_assert( memcmp(c, cref, clen * sizeof * c) == 0,
+                           "gla W=%td, threads=%td equals threads=1", W, nthreads);
+            }
+        }
+    }
+
+    LTFAT_SAFEFREEALL(f, g, cinit, cref, c);
+    return 0;
+}
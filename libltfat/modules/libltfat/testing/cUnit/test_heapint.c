@@ -0,0 +1,161 @@
+int TEST_NAME(test_heapint)()
+{
+    // The gradients of phi = p*n + q*m + r*m*n + t*n*n are linear along
+    // the integration paths, so the trapezoidal rule recovers phi exactly
+    // up to a constant
+    ltfat_int a = 4, M = 64, N = 200, L = a * N, W = 2, M2 = M / 2 + 1;
+    ltfat_int tileN = 37, overlapN = 5;
+    double p = 0.3, q = -0.2, r = 0.01, t = 0.001;
+    // In the complex layout the frequency wraps around, phi must be
+    // periodic in m there
+    double qc = 2.0 * M_PI * 3.0 / M, rc = 2.0 * M_PI / M;
+    double tol = sizeof (LTFAT_REAL) == sizeof (double) ? 1e-8 : 1e-2;
+
+    LTFAT_REAL* s = LTFAT_NAME_REAL(malloc)(M * N * W);
+    LTFAT_REAL* tgradw = LTFAT_NAME_REAL(malloc)(M * N * W);
+    LTFAT_REAL* fgradw = LTFAT_NAME_REAL(malloc)(M * N * W);
+    LTFAT_REAL* tgradc = LTFAT_NAME_REAL(malloc)(M * N * W);
+    LTFAT_REAL* fgradc = LTFAT_NAME_REAL(malloc)(M * N * W);
+    LTFAT_REAL* phase = LTFAT_NAME_REAL(malloc)(M * N * W);
+    LTFAT_REAL* phase2 = LTFAT_NAME_REAL(malloc)(M * N * W);
+    TEST_NAME(fillRand)(s, M * N * W);
+
+    for (ltfat_int ii = 0; ii < M * N * W; ii++)
+        s[ii] += (LTFAT_REAL) 1.0;
+
+    for (ltfat_int w = 0; w < W; w++)
+    {
+        for (ltfat_int n = 0; n < N; n++)
+        {
+            for (ltfat_int m = 0; m < M2; m++)
+            {
+                ltfat_int ii = m + n * M2 + w * M2 * N;
+                tgradw[ii] = (LTFAT_REAL) (p + r * m + 2.0 * t * n);
+                fgradw[ii] = (LTFAT_REAL) (q + r * n);
+            }
+
+            for (ltfat_int m = 0; m < M; m++)
+            {
+                ltfat_int ii = m + n * M + w * M * N;
+                tgradc[ii] = (LTFAT_REAL) (p + rc * m + 2.0 * t * n);
+                fgradc[ii] = (LTFAT_REAL) (qc + rc * n);
+            }
+        }
+    }
+
+    mu_assert( LTFAT_NAME(heapintreal_tiled)(s, tgradw, fgradw, a, M, L, W,
+               (LTFAT_REAL) 1e-6, tileN, overlapN, 1, phase) == LTFATERR_SUCCESS,
+               "heapintreal_tiled");
+
+    for (ltfat_int w = 0; w < W; w++)
+    {
+        double err = 0.0;
+        LTFAT_REAL* phasechan = phase + w * M2 * N;
+
+        for (ltfat_int n = 0; n < N; n++)
+        {
+            for (ltfat_int m = 0; m < M2; m++)
+            {
+                double d = phasechan[m + n * M2] - phasechan[0]
+                           - (p * n + q * m + r * m * n + t * n * n);
+                err += fabs(sin(d));
+            }
+        }
+        mu_assert( err < tol * M2 * N, "heapintreal_tiled equals phi");
+    }
+
+    // The result does not depend on the number of threads
+    mu_assert( LTFAT_NAME(heapintreal_tiled)(s, tgradw, fgradw, a, M, L, W,
+               (LTFAT_REAL) 1e-6, tileN, overlapN, 3, phase2) == LTFATERR_SUCCESS,
+               "heapintreal_tiled threads");
+    mu_assert( memcmp(phase, phase2, M2 * N * W * sizeof * phase) == 0,
+               "heapintreal_tiled threads=3 equals threads=1");
+
+    // The complex layout integrates across the time edges of the tiles
+    mu_assert( LTFAT_NAME(heapint_tiled)(s, tgradc, fgradc, a, M, L, W,
+               (LTFAT_REAL) 1e-6, tileN, overlapN, 1, phase) == LTFATERR_SUCCESS,
+               "heapint_tiled");
+
+    for (ltfat_int w = 0; w < W; w++)
+    {
+        double err = 0.0;
+        LTFAT_REAL* phasechan = phase + w * M * N;
+
+        for (ltfat_int n = 0; n < N; n++)
+        {
+            for (ltfat_int m = 0; m < M; m++)
+            {
+                double d = phasechan[m + n * M] - phasechan[0]
+                           - (p * n + qc * m + rc * m * n + t * n * n);
+                err += fabs(sin(d));
+            }
+        }
+        mu_assert( err < tol * M * N, "heapint_tiled equals phi");
+    }
+
+    mu_assert( LTFAT_NAME(heapint_tiled)(s, tgradc, fgradc, a, M, L, W,
+               (LTFAT_REAL) 1e-6, tileN, overlapN, 3, phase2) == LTFATERR_SUCCESS,
+               "heapint_tiled threads");
+    mu_assert( memcmp(phase, phase2, M * N * W * sizeof * phase) == 0,
+               "heapint_tiled threads=3 equals threads=1");
+
+    mu_assert( LTFAT_NAME(heapintreal_tiled)(s, tgradw, fgradw, a, M, L, W,
+               (LTFAT_REAL) 1e-6, tileN, tileN + 1, 1, phase) == LTFATERR_BADARG,
+               "heapintreal_tiled overlapN > tileN");
+    mu_assert( LTFAT_NAME(heapintreal_tiled)(s, tgradw, fgradw, a, M, L, W,
+               (LTFAT_REAL) 1e-6, 0, overlapN, 1, phase) == LTFATERR_NOTPOSARG,
+               "heapintreal_tiled tileN=0");
+
+    // The bucket heap gives the same phase, the gradients are integrable
+    for (int ht = LTFAT_HEAP_BINARY; ht <= LTFAT_HEAP_BUCKET; ht++)
+    {
+        LTFAT_NAME(heapinttask)* hit = LTFAT_NAME(heapinttask_init)(
+                                           M2, N, M2, s, 1, (ltfat_heap_type) ht);
+        double err = 0.0;
+        mu_assert( hit != NULL, "heapinttask_init");
+        LTFAT_NAME(heapinttask_resetmax)(hit, s, (LTFAT_REAL) 1e-6);
+        LTFAT_NAME(heapint_execute)(hit, s, tgradw, fgradw, phase);
+        LTFAT_NAME(heapinttask_done)(hit);
+
+        for (ltfat_int n = 0; n < N; n++)
+            for (ltfat_int m = 0; m < M2; m++)
+                err += fabs(sin(phase[m + n * M2] - phase[0]
+                                - (p * n + q * m + r * m * n + t * n * n)));
+        mu_assert( err < tol * M2 * N, "heapint_execute heap type");
+    }
+
+    // Every key comes out once and within one bucket of the maximum
+    {
+        ltfat_int Lh = 1000, inserted = 0, deleted = 0, key;
+        int* seen = ltfat_calloc(Lh, sizeof * seen);
+        LTFAT_NAME(heap)* h = LTFAT_NAME(heap_initwithtype)(4, s, LTFAT_HEAP_BUCKET);
+        mu_assert( h != NULL, "heap_initwithtype");
+
+        while (inserted < Lh / 2)
+            LTFAT_NAME(heap_insert)(h, inserted++);
+
+        while ((key = LTFAT_NAME(heap_delete)(h)) >= 0)
+        {
+            LTFAT_REAL maxleft = 0;
+            mu_assert( !seen[key], "heap_delete twice");
+            seen[key] = 1;
+            deleted++;
+
+            for (ltfat_int ii = 0; ii < inserted; ii++)
+                if (!seen[ii] && s[ii] > maxleft)
+                    maxleft = s[ii];
+            // 1/8 of an octave plus the error of the mantissa table
+            mu_assert( s[key] * 1.094 >= maxleft, "heap_delete order");
+
+            if (inserted < Lh)
+                LTFAT_NAME(heap_insert)(h, inserted++);
+        }
+        mu_assert( deleted == Lh, "heap_delete count");
+
+        LTFAT_NAME(heap_done)(h);
+        ltfat_free(seen);
+    }
+
+    LTFAT_SAFEFREEALL(s, tgradw, fgradw, tgradc, fgradc, phase, phase2);
+    return 0;
+}
@@ -0,0 +1,126 @@
+/* leglaupdate_execute as it was before the update was split into passes:
+ * the whole kernel is applied to one column after another by
+ * leglaupdate_col_execute */
+static void
+TEST_NAME(leglaupdate_colwise)(const LTFAT_COMPLEX kern[], phaseret_size ksize,
+                               ltfatInt L, ltfatInt W, ltfatInt a, ltfatInt M,
+                               int flags, const LTFAT_REAL s[],
+                               const LTFAT_COMPLEX c[], LTFAT_COMPLEX cout[])
+{
+    ltfatInt N = L / a, M2 = M / 2 + 1, kNo = ltfat_lcm(M, a) / a;
+    ltfatInt kernh2 = ksize.height / 2 + 1, kl = ksize.width * kernh2;
+    ltfatInt M2buf = M2 + ksize.height - 1;
+    PHASERET_NAME(leglaupdate_plan_col)* p = NULL;
+    LTFAT_COMPLEX* ktmp = LTFAT_NAME_COMPLEX(calloc)(kl);
+    LTFAT_COMPLEX* k = LTFAT_NAME_COMPLEX(calloc)(kNo * kl);
+    LTFAT_COMPLEX* buf = LTFAT_NAME_COMPLEX(malloc)(M2buf * (N + ksize.width - 1));
+
+    PHASERET_NAME(leglaupdate_col_init)(M, ksize, flags, &p);
+
+    // The kernels are prepared as in leglaupdate_init
+    for (ltfatInt ii = 0; ii < kernh2; ii++)
+    {
+        ktmp[ii] = kern[ii];
+        for (ltfatInt jj = 1; jj < ksize.width; jj++)
+            ktmp[ii + jj * kernh2] = conj(kern[ii + (ksize.width - jj) * kernh2]);
+    }
+    if (flags & MOD_MODIFIEDUPDATE) ktmp[0] = 0;
+    for (ltfatInt n = 0; n < kNo; n++)
+        PHASERET_NAME(kernphasefi)(ktmp, ksize, n, a, M, k + n * kl);
+
+    for (ltfatInt w = 0; w < W; w++)
+    {
+        PHASERET_NAME(extendborders)(p, c + w * M2 * N, N, buf);
+
+        for (ltfatInt n = 0; n < N; n++)
+            PHASERET_NAME(leglaupdate_col_execute)(p, s + w * M2 * N + n * M2,
+                                                   k + (n % kNo) * kl,
+                                                   buf + n * M2buf,
+                                                   cout + w * M2 * N + n * M2);
+    }
+
+    if (!(flags & (MOD_COEFFICIENTWISE | MOD_FRAMEWISE)))
+        for (ltfatInt ii = 0; ii < M2 * N * W; ii++)
+            cout[ii] = s[ii] * cexp(I * carg(cout[ii]));
+
+    PHASERET_NAME(leglaupdate_col_done)(&p);
+    LTFAT_SAFEFREEALL(ktmp, k, buf);
+}
+
+int TEST_NAME(test_leglaupdate)()
+{
+    ltfatInt L = 640, a = 16, M = 64, M2 = M / 2 + 1, W = 3;
+    ltfatInt clen = M2 * (L / a) * W;
+    phaseret_size ksize = { .width = 7, .height = 7 };
+    int flags[] = {MOD_STEPWISE, MOD_FRAMEWISE, MOD_COEFFICIENTWISE};
+    const char* flagnames[] = {"stepwise", "framewise", "coefficientwise"};
+    // The right half of the kernel is now summed first
+    double tol = sizeof (LTFAT_REAL) == sizeof (double) ? 1e-12 : 1e-4;
+    ltfat_simd_level maxlevel = ltfat_simd_get_maxlevel();
+
+    LTFAT_REAL* s = LTFAT_NAME_REAL(malloc)(clen);
+    LTFAT_COMPLEX* kern = LTFAT_NAME_COMPLEX(malloc)(ksize.width * (ksize.height / 2 + 1));
+    LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(clen);
+    LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(clen);
+    LTFAT_COMPLEX* cout = LTFAT_NAME_COMPLEX(malloc)(clen);
+    LTFAT_COMPLEX* cout1 = LTFAT_NAME_COMPLEX(malloc)(clen);
+    TEST_NAME(fillRand)(s, clen);
+    TEST_NAME_COMPLEX(fillRand)(kern, ksize.width * (ksize.height / 2 + 1));
+    TEST_NAME_COMPLEX(fillRand)(c, clen);
+
+    for (int fi = 0; fi < 3; fi++)
+    {
+        for (ltfatInt Wi = 1; Wi <= W; Wi += W - 1)
+        {
+            ltfatInt clenW = M2 * (L / a) * Wi;
+            int fl = flags[fi] | MOD_MODIFIEDUPDATE;
+            PHASERET_NAME(leglaupdate_plan)* p = NULL;
+            double err = 0.0, nrm = 0.0;
+
+            TEST_NAME(leglaupdate_colwise)(kern, ksize, L, Wi, a, M, fl, s, c,
+                                           cref);
+
+            mu_assert( PHASERET_NAME(leglaupdate_init)(kern, ksize, L, Wi, a, M,
+                       fl, &p) == LTFATERR_SUCCESS, "leglaupdate_init");
+            mu_assert( ltfat_simd_set_level(LTFAT_SIMD_NONE) == LTFATERR_SUCCESS,
+                       "simd_set_level none");
+            PHASERET_NAME(leglaupdate_execute)(p, s, c, cout1);
+
+            for (ltfatInt ii = 0; ii < clenW; ii++)
+            {
+                err += sqrt(ltfat_energy(cout1[ii] - cref[ii]));
+                nrm += sqrt(ltfat_energy(cref[ii]));
+            }
+            mu_assert( err < tol * nrm,
+                       "leglaupdate %s W=%td equals the column-wise update, "
+                       "relative error %.1e", flagnames[fi], Wi, err / nrm);
+
+            // The scalar loop is the reference for the instruction sets
+            for (int level = LTFAT_SIMD_SSE2; level <= (int) maxlevel; level++)
+            {
+                mu_assert( ltfat_simd_set_level((ltfat_simd_level) level)
+                           == LTFATERR_SUCCESS, "simd_set_level");
+                PHASERET_NAME(leglaupdate_execute)(p, s, c, cout);
+                mu_assert( memcmp(cout, cout1, clenW * sizeof * cout) == 0,
+                           "leglaupdate %s W=%td simd level %d equals scalar",
+                           flagnames[fi], Wi, level);
+            }
+            ltfat_simd_set_level(maxlevel);
+
+            for (ltfatInt nthreads = 2; nthreads <= 4; nthreads++)
+            {
+                mu_assert( PHASERET_NAME(leglaupdate_set_nthreads)(p, nthreads)
+                           == LTFATERR_SUCCESS, "leglaupdate_set_nthreads");
+                PHASERET_NAME(leglaupdate_execute)(p, s, c, cout);
+                mu_assert( memcmp(cout, cout1, clenW * sizeof * cout) == 0,
+                           "leglaupdate %s W=%td threads=%td equals threads=1",
+                           flagnames[fi], Wi, nthreads);
+            }
+
+            PHASERET_NAME(leglaupdate_done)(&p);
+        }
+    }
+
+    LTFAT_SAFEFREEALL(s, kern, c, cref, cout, cout1);
+    return 0;
+}
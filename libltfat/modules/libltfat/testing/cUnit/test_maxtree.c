@@ -1,61 +1,113 @@
-ltfat_int      L[] = {  9 , 10, 100, 101 };
-ltfat_int  depth[] = {  1, 2, 3, 4, 5 };
-ltfat_int  rLen[]  = { 1, 2, 3, 4, 7, 8, 10, 19, 21};
-
-for (unsigned int lId = 0; lId < ARRAYLEN(L); lId++)
+int TEST_NAME(test_maxtree)()
 {
-    LTFAT_REAL* fin = LTFAT_NAME_REAL(malloc)(L[lId]);
-    TEST_NAME(fillRand)(fin, L[lId]);
+    ltfat_int      L[] = {  9 , 10, 100, 101 };
+    ltfat_int  depth[] = {  1, 2, 3, 4, 5 };
+    ltfat_int  rLen[]  = { 1, 2, 3, 4, 7, 8, 10, 19, 21};
 
-    for (unsigned int dId = 0; dId < ARRAYLEN(depth); dId++)
+    for (unsigned int lId = 0; lId < ARRAYLEN(L); lId++)
     {
-        ltfat_int maxPos;
-        LTFAT_REAL max;
-        ltfat_int maxPos2;
-        LTFAT_REAL max2;
-        /* fin[L[lId]-1] = 100; */
-        LTFAT_NAME(findmaxinarray)(fin, L[lId], &max, &maxPos);
-        printf("max=%.2f, maxPos=%td\n", max, maxPos);
-
-        LTFAT_NAME(maxtree)* p = NULL;
-        LTFAT_NAME(maxtree_initwitharray)(L[lId], depth[dId], fin, &p);
-        LTFAT_NAME(maxtree_findmax)(p, &max2, &maxPos2);
-        printf("max=%.2f, maxPos=%td\n", max2, maxPos2);
-
-        for (unsigned int idx = 0; idx < L[lId]; idx++)
+        LTFAT_REAL* fin = LTFAT_NAME_REAL(malloc)(L[lId]);
+        TEST_NAME(fillRand)(fin, L[lId]);
+
+        for (unsigned int dId = 0; dId < ARRAYLEN(depth); dId++)
         {
-            for (unsigned int rIdx = 0; rIdx < ARRAYLEN(rLen); rIdx++)
-            {
+            ltfat_int maxPos;
+            LTFAT_REAL max;
+            ltfat_int maxPos2;
+            LTFAT_REAL max2;
+            /* fin[L[lId]-1] = 100; */
+            LTFAT_NAME(findmaxinarray)(fin, L[lId], &max, &maxPos);
 
-                max = -100; max2 = -101; maxPos = -1; maxPos2 = -1;
-                TEST_NAME(fillRand)(fin, L[lId]);
-                LTFAT_NAME(maxtree_reset)(p, fin);
+            LTFAT_NAME(maxtree)* p = NULL;
+            LTFAT_NAME(maxtree_initwitharray)(L[lId], depth[dId], fin, &p);
+            LTFAT_NAME(maxtree_findmax)(p, &max2, &maxPos2);
+            mu_assert( max == max2 && maxPos == maxPos2,
+                       "TREEMAX init L=%td, d=%td", L[lId], depth[dId] );
 
-                for (unsigned int ii = 0; ii < rLen[rIdx]; ii++)
+            ltfat_int mismatches = 0;
+            for (unsigned int idx = 0; idx < L[lId]; idx++)
+            {
+                for (unsigned int rIdx = 0; rIdx < ARRAYLEN(rLen); rIdx++)
                 {
-                    ltfat_int pos = idx + ii;
-                    if (pos >= L[lId])
-                        pos = pos%L[lId];
 
-                    fin[pos] = 100 + ii;
-                }
+                    max = -100; max2 = -101; maxPos = -1; maxPos2 = -1;
+                    TEST_NAME(fillRand)(fin, L[lId]);
+                    LTFAT_NAME(maxtree_reset)(p, fin);
+
+                    for (unsigned int ii = 0; ii < rLen[rIdx]; ii++)
+                    {
+                        ltfat_int pos = idx + ii;
+                        if (pos >= L[lId])
+                            pos = pos%L[lId];
+
+                        fin[pos] = 100 + ii;
+                    }
 
-                LTFAT_NAME(findmaxinarray)(fin, L[lId], &max, &maxPos);
-                /* printf("max=%.2f, maxPos=%td\n",max,maxPos); */
+                    LTFAT_NAME(findmaxinarray)(fin, L[lId], &max, &maxPos);
+                    /* printf("max=%.2f, maxPos=%td\n",max,maxPos); */
 
-                LTFAT_NAME(maxtree_setdirty)(p, idx, idx + rLen[rIdx]);
-                LTFAT_NAME(maxtree_findmax)(p, &max2, &maxPos2);
+                    LTFAT_NAME(maxtree_setdirty)(p, idx, idx + rLen[rIdx]);
+                    LTFAT_NAME(maxtree_findmax)(p, &max2, &maxPos2);
 
-                /* printf("max=%.2f, maxPos=%td\n",max2,maxPos2);  */
-                mu_assert( max == max2 && maxPos == maxPos2 ,
-                           "TREEMAX L=%td, d=%td, idx=%d, r=%td",
-                           L[lId], depth[dId], idx, rLen[rIdx] );
+                    /* printf("max=%.2f, maxPos=%td\n",max2,maxPos2);  */
+                    if (max != max2 || maxPos != maxPos2) mismatches++;
+                }
             }
+
+            mu_assert( mismatches == 0, "TREEMAX L=%td, d=%td", L[lId], depth[dId] );
+
+
+            LTFAT_NAME(maxtree_done)(&p);
         }
 
+        ltfat_free(fin);
+    }
+
+    ltfat_int  nLen[]  = { 1, 3, 8, 200 };
+
+    for (unsigned int lId = 0; lId < ARRAYLEN(L); lId++)
+    {
+        LTFAT_REAL* fin = LTFAT_NAME_REAL(malloc)(L[lId]);
+        LTFAT_REAL* maxn = LTFAT_NAME_REAL(malloc)(200);
+        ltfat_int* maxnPos = ltfat_malloc(200 * sizeof * maxnPos);
+
+        for (unsigned int dId = 0; dId < ARRAYLEN(depth); dId++)
+        {
+            LTFAT_NAME(maxtree)* p = NULL;
+            TEST_NAME(fillRand)(fin, L[lId]);
+            LTFAT_NAME(maxtree_initwitharray)(L[lId], depth[dId], fin, &p);
+
+            for (unsigned int nIdx = 0; nIdx < ARRAYLEN(nLen); nIdx++)
+            {
+                ltfat_int found = 0;
+                LTFAT_NAME(maxtree_findmaxn)(p, nLen[nIdx], maxn, maxnPos, &found);
+
+                mu_assert( found == ltfat_imin(nLen[nIdx], L[lId]),
+                           "TREEMAXN found L=%td, d=%td, n=%td",
+                           L[lId], depth[dId], nLen[nIdx] );
+
+                ltfat_int bigger = 0;
+                for (ltfat_int l = 0; l < L[lId]; l++)
+                    if (fin[l] > maxn[found - 1]) bigger++;
+
+                mu_assert( bigger == found - 1,
+                           "TREEMAXN L=%td, d=%td, n=%td",
+                           L[lId], depth[dId], nLen[nIdx] );
+
+                for (ltfat_int ii = 0; ii < found; ii++)
+                    mu_assert( fin[maxnPos[ii]] == maxn[ii] &&
+                               (ii == 0 || maxn[ii - 1] >= maxn[ii]),
+                               "TREEMAXN order L=%td, d=%td, n=%td",
+                               L[lId], depth[dId], nLen[nIdx] );
+            }
+
+            LTFAT_NAME(maxtree_done)(&p);
+        }
 
-        LTFAT_NAME(maxtree_done)(&p);
+        ltfat_free(fin);
+        ltfat_free(maxn);
+        ltfat_free(maxnPos);
     }
 
-    ltfat_free(fin);
+    return 0;
 }
@@ -0,0 +1,50 @@
+int TEST_NAME(test_pghi)()
+{
+    ltfatInt L = 2048, gl = 256, a = 32, M = 256, M2 = M / 2 + 1, W = 3;
+    ltfatInt N = L / a, clen = M2 * N;
+    double gamma = phaseret_firwin2gamma(LTFAT_HANN, gl);
+
+    LTFAT_REAL* s = LTFAT_NAME_REAL(malloc)(clen * W);
+    int* mask = ltfat_calloc(clen * W, sizeof * mask);
+    LTFAT_COMPLEX* cin = LTFAT_NAME_COMPLEX(malloc)(clen * W);
+    LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(clen * W);
+    LTFAT_COMPLEX* crefmask = LTFAT_NAME_COMPLEX(malloc)(clen * W);
+    LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(clen * W);
+    PHASERET_NAME(pghi_plan)* p = NULL;
+
+    /* All magnitudes are above the tolerances, no coefficient gets a random
+     * phase and every channel is integrated from its own gradients */
+    TEST_NAME(fillRand)(s, clen * W);
+    for (ltfatInt ii = 0; ii < clen * W; ii++)
+    {
+        s[ii] += (LTFAT_REAL) 1.0;
+        cin[ii] = s[ii] * cexp(I * 2.0 * M_PI * s[ii]);
+        mask[ii] = ii % 7 == 0;
+    }
+
+    // The channels are processed one by one, W > 1 equals W = 1 per channel
+    mu_assert( PHASERET_NAME(pghi_init)(L, 1, a, M, 1e-1, 1e-10, gamma, &p)
+               == LTFATERR_SUCCESS, "pghi_init W=1");
+    for (ltfatInt w = 0; w < W; w++)
+    {
+        PHASERET_NAME(pghi_execute)(p, s + w * clen, cref + w * clen);
+        PHASERET_NAME(pghi_execute_withmask)(p, cin + w * clen, mask + w * clen,
+                                             NULL, crefmask + w * clen);
+    }
+    PHASERET_NAME(pghi_done)(&p);
+
+    mu_assert( PHASERET_NAME(pghi_init)(L, W, a, M, 1e-1, 1e-10, gamma, &p)
+               == LTFATERR_SUCCESS, "pghi_init W=%td", W);
+    mu_assert( PHASERET_NAME(pghi_execute_withmask)(p, cin, mask, NULL, c)
+               == LTFATERR_SUCCESS, "pghi_execute_withmask");
+    mu_assert( memcmp(crefmask, c, clen * W * sizeof * c) == 0,
+               "pghi_execute_withmask W=%td equals W=1 per channel", W);
+    mu_assert( PHASERET_NAME(pghi_execute)(p, s, c) == LTFATERR_SUCCESS,
+               "pghi_execute");
+    mu_assert( memcmp(cref, c, clen * W * sizeof * c) == 0,
+               "pghi_execute W=%td equals W=1 per channel", W);
+    PHASERET_NAME(pghi_done)(&p);
+
+    LTFAT_SAFEFREEALL(s, mask, cin, cref, crefmask, c);
+    return 0;
+}
@@ -0,0 +1,234 @@
+// Channel-dependent gain, once per frame and once per block of frames
+static void
+TEST_NAME(rtdgtreal_framegain)(void* UNUSED(userdata), const LTFAT_COMPLEX in[],
+                               int M2, int W, LTFAT_COMPLEX out[])
+{
+    for (int ii = 0; ii < M2 * W; ii++)
+        out[ii] = in[ii] * (LTFAT_REAL) (1 + ii / M2);
+}
+
+static void
+TEST_NAME(rtdgtreal_blockgain)(void* UNUSED(userdata), const LTFAT_COMPLEX in[],
+                               int M2, int K, int W, LTFAT_COMPLEX out[])
+{
+    for (int ii = 0; ii < M2 * K * W; ii++)
+        out[ii] = in[ii] * (LTFAT_REAL) (1 + ii / (M2 * K));
+}
+
+int TEST_NAME(test_rtdgtreal)()
+{
+    // Windows shorter and longer than the number of channels, W not
+    // divisible by the batch size
+    ltfatInt gl[] = {12, 16, 40};
+    ltfatInt M = 16, M2 = M / 2 + 1, W = 5, Wmax = 2, glmax = 40;
+    rtdgt_phasetype ptypes[] = {LTFAT_RTDGTPHASE_ZERO, LTFAT_RTDGTPHASE_HALFSHIFT};
+    double tol = sizeof (LTFAT_REAL) == sizeof (double) ? 1e-10 : 1e-4;
+
+    LTFAT_REAL* g = LTFAT_NAME_REAL(malloc)(glmax);
+    LTFAT_REAL* gshift = LTFAT_NAME_REAL(malloc)(glmax);
+    LTFAT_REAL* f = LTFAT_NAME_REAL(malloc)(glmax * W);
+    LTFAT_REAL* fref = LTFAT_NAME_REAL(malloc)(glmax * W);
+    LTFAT_REAL* fout = LTFAT_NAME_REAL(malloc)(glmax * W);
+    LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(M2 * W);
+    LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(M2 * W);
+    TEST_NAME(fillRand)(g, glmax);
+    TEST_NAME(fillRand)(f, glmax * W);
+
+    for (unsigned int glId = 0; glId < ARRAYLEN(gl); glId++)
+    {
+        for (unsigned int pId = 0; pId < ARRAYLEN(ptypes); pId++)
+        {
+            LTFAT_NAME(rtdgtreal_plan)* p = NULL;
+            LTFAT_NAME(rtidgtreal_plan)* ip = NULL;
+            ltfatInt L = gl[glId];
+            ltfatInt start = ptypes[pId] == LTFAT_RTDGTPHASE_ZERO ? L / 2 : 0;
+            double err = 0.0, ierr = 0.0;
+            LTFAT_NAME_REAL(fftshift)(g, L, gshift);
+
+            // Direct evaluation: frame sample l sits at (l - start) mod M
+            for (ltfatInt w = 0; w < W; w++)
+            {
+                for (ltfatInt m = 0; m < M2; m++)
+                {
+                    double _Complex s = 0.0;
+                    for (ltfatInt l = 0; l < L; l++)
+                        s += f[l + w * L] * gshift[l] *
+                             cexp(-I * 2.0 * M_PI * m * (l - start) / M);
+                    cref[m + w * M2] = (LTFAT_COMPLEX) s;
+                }
+
+                for (ltfatInt l = 0; l < L; l++)
+                {
+                    double s = creal(cref[w * M2]);
+                    for (ltfatInt m = 1; m < M2; m++)
+                        s += (m == M - m ? 1.0 : 2.0) *
+                             creal(cref[m + w * M2] *
+                                   cexp(I * 2.0 * M_PI * m * (l - start) / M));
+                    fref[l + w * L] = (LTFAT_REAL) (s * gshift[l]);
+                }
+            }
+
+            mu_assert( LTFAT_NAME(rtdgtreal_init_batch)(g, L, M, ptypes[pId],
+                       Wmax, &p) == LTFATERR_SUCCESS, "rtdgtreal_init_batch");
+            mu_assert( LTFAT_NAME(rtidgtreal_init_batch)(g, L, M, ptypes[pId],
+                       Wmax, &ip) == LTFATERR_SUCCESS, "rtidgtreal_init_batch");
+
+            mu_assert( LTFAT_NAME(rtdgtreal_execute)(p, f, W, c)
+                       == LTFATERR_SUCCESS, "rtdgtreal_execute");
+            mu_assert( LTFAT_NAME(rtidgtreal_execute)(ip, cref, W, fout)
+                       == LTFATERR_SUCCESS, "rtidgtreal_execute");
+
+            for (ltfatInt ii = 0; ii < M2 * W; ii++)
+                err += sqrt(ltfat_energy(c[ii] - cref[ii]));
+            for (ltfatInt ii = 0; ii < L * W; ii++)
+                ierr += fabs(fout[ii] - fref[ii]);
+
+            mu_assert( err < tol * M2 * W * L, "rtdgtreal equals DGT");
+            mu_assert( ierr < tol * M * W * L, "rtidgtreal equals IDGT");
+
+            LTFAT_NAME(rtdgtreal_done)(&p);
+            LTFAT_NAME(rtidgtreal_done)(&ip);
+        }
+    }
+
+    // Processor: draining several frames at once must not change the output
+    {
+        ltfatInt a = 8, bufLenMax = 200, Ltot = 2000, Kmax = 7;
+        LTFAT_REAL* in = LTFAT_NAME_REAL(malloc)(Ltot * W);
+        LTFAT_REAL* out[2] = { LTFAT_NAME_REAL(malloc)(Ltot * W),
+                               LTFAT_NAME_REAL(malloc)(Ltot * W)
+                             };
+        double err = 0.0;
+        TEST_NAME(fillRand)(in, Ltot * W);
+
+        for (int mode = 0; mode < 2; mode++)
+        {
+            LTFAT_NAME(rtdgtreal_processor_state)* proc = NULL;
+            mu_assert( LTFAT_NAME(rtdgtreal_processor_init)(g, glmax, g, glmax, a,
+                       M, W, bufLenMax, glmax - 1, &proc) == LTFATERR_SUCCESS,
+                       "rtdgtreal_processor_init");
+            LTFAT_NAME(rtdgtreal_processor_setcallback)(proc,
+                    &TEST_NAME(rtdgtreal_framegain), NULL);
+
+            if (mode)
+                mu_assert( LTFAT_NAME(rtdgtreal_processor_setblockcallback)(proc,
+                           &TEST_NAME(rtdgtreal_blockgain), NULL, Kmax)
+                           == LTFATERR_SUCCESS, "rtdgtreal_processor_setblockcallback");
+
+            // Block lengths up to bufLenMax, the last blocks are short
+            for (ltfatInt l = 0, Lb = 0; l < Ltot; l += Lb)
+            {
+                const LTFAT_REAL* inptr[5];
+                LTFAT_REAL* outptr[5];
+                Lb = ltfat_imin(bufLenMax - 10 * (l / 500), Ltot - l);
+                for (ltfatInt w = 0; w < W; w++)
+                {
+                    inptr[w] = in + w * Ltot + l;
+                    outptr[w] = out[mode] + w * Ltot + l;
+                }
+
+                mu_assert( LTFAT_NAME(rtdgtreal_processor_execute)(proc, inptr, Lb, W,
+                           outptr) == LTFATERR_SUCCESS, "rtdgtreal_processor_execute");
+            }
+
+            mu_assert( LTFAT_NAME(rtdgtreal_processor_setblockcallback)(proc,
+                       NULL, NULL, 0) == LTFATERR_NOTPOSARG,
+                       "rtdgtreal_processor_setblockcallback Kmax=0");
+            LTFAT_NAME(rtdgtreal_processor_done)(&proc);
+        }
+
+        for (ltfatInt ii = 0; ii < Ltot * W; ii++)
+            err += fabs(out[0][ii] - out[1][ii]);
+        mu_assert( err < tol * Ltot * W, "rtdgtreal_processor block equals frames");
+
+        LTFAT_SAFEFREEALL(in, out[0], out[1]);
+    }
+
+    // Processor: interleaved I/O must equal the planar one
+    {
+        ltfatInt a = 8, bufLenMax = 200, Ltot = 1000, Lb = 100;
+        ltfat_sampleformat fmt = sizeof (LTFAT_REAL) == sizeof (double) ?
+                                 LTFAT_SAMPLE_FLOAT64 : LTFAT_SAMPLE_FLOAT32;
+        LTFAT_REAL* in = LTFAT_NAME_REAL(malloc)(Ltot * W);
+        LTFAT_REAL* inter = LTFAT_NAME_REAL(malloc)(Ltot * W);
+        LTFAT_REAL* out = LTFAT_NAME_REAL(malloc)(Ltot * W);
+        int16_t* in16 = ltfat_malloc(Ltot * W * sizeof * in16);
+        int16_t* out16 = ltfat_malloc(Ltot * W * sizeof * out16);
+        double err = 0.0, err16 = 0.0;
+        TEST_NAME(fillRand)(in, Ltot * W);
+
+        // Input exactly representable in int16
+        for (ltfatInt l = 0; l < Ltot; l++)
+            for (ltfatInt w = 0; w < W; w++)
+            {
+                in16[w + l * W] = (int16_t) (in[l + w * Ltot] * 16384);
+                in[l + w * Ltot] = in16[w + l * W] / (LTFAT_REAL) 32768;
+                inter[w + l * W] = in[l + w * Ltot];
+            }
+
+        for (int mode = 0; mode < 3; mode++)
+        {
+            LTFAT_NAME(rtdgtreal_processor_state)* proc = NULL;
+            mu_assert( LTFAT_NAME(rtdgtreal_processor_init)(g, glmax, g, glmax, a,
+                       M, W, bufLenMax, glmax - 1, &proc) == LTFATERR_SUCCESS,
+                       "rtdgtreal_processor_init");
+            LTFAT_NAME(rtdgtreal_processor_setcallback)(proc,
+                    &TEST_NAME(rtdgtreal_framegain), NULL);
+
+            for (ltfatInt l = 0; l < Ltot; l += Lb)
+            {
+                if (mode == 0)
+                {
+                    const LTFAT_REAL* inptr[5];
+                    LTFAT_REAL* outptr[5];
+                    for (ltfatInt w = 0; w < W; w++)
+                    {
+                        inptr[w] = in + w * Ltot + l;
+                        outptr[w] = out + w * Ltot + l;
+                    }
+                    mu_assert( LTFAT_NAME(rtdgtreal_processor_execute)(proc,
+                               inptr, Lb, W, outptr) == LTFATERR_SUCCESS,
+                               "rtdgtreal_processor_execute");
+                }
+                else if (mode == 1)
+                    mu_assert( LTFAT_NAME(rtdgtreal_processor_execute_interleaved)(
+                                   proc, fmt, inter + l * W, Lb, W, inter + l * W)
+                               == LTFATERR_SUCCESS,
+                               "rtdgtreal_processor_execute_interleaved");
+                else
+                    mu_assert( LTFAT_NAME(rtdgtreal_processor_execute_interleaved)(
+                                   proc, LTFAT_SAMPLE_INT16, in16 + l * W, Lb, W,
+                                   out16 + l * W) == LTFATERR_SUCCESS,
+                               "rtdgtreal_processor_execute_interleaved int16");
+            }
+
+            LTFAT_NAME(rtdgtreal_processor_done)(&proc);
+        }
+
+        // The int16 output is rounded and clipped
+        for (ltfatInt l = 0; l < Ltot; l++)
+            for (ltfatInt w = 0; w < W; w++)
+            {
+                double ref = ltfat_round(out[l + w * Ltot] * 32768);
+                ref = ref > 32767 ? 32767 : ref < -32768 ? -32768 : ref;
+                err += fabs(inter[w + l * W] - out[l + w * Ltot]);
+                err16 = fmax(err16, fabs(out16[w + l * W] - ref));
+            }
+        mu_assert( err == 0.0, "rtdgtreal_processor interleaved equals planar");
+        mu_assert( err16 <= 1.0, "rtdgtreal_processor int16");
+
+        mu_assert( LTFAT_NAME(rtdgtreal_processor_execute_interleaved)(NULL,
+                   fmt, inter, Lb, W, inter) == LTFATERR_NULLPOINTER,
+                   "rtdgtreal_processor_execute_interleaved NULL");
+
+        LTFAT_SAFEFREEALL(in, inter, out, in16, out16);
+    }
+
+    LTFAT_NAME(rtdgtreal_plan)* p = NULL;
+    mu_assert( LTFAT_NAME(rtdgtreal_init_batch)(g, glmax, M,
+               LTFAT_RTDGTPHASE_ZERO, 0, &p) == LTFATERR_NOTPOSARG,
+               "rtdgtreal_init_batch Wmax=0");
+
+    LTFAT_SAFEFREEALL(g, gshift, f, fref, fout, cref, c);
+    return 0;
+}
@@ -0,0 +1,95 @@
+/* Spectral convergence ||s - |dgtreal(idgtreal(c))|||/||s|| in dB */
+static double
+TEST_NAME(rtisila_magerrdb)(const LTFAT_REAL s[], const LTFAT_COMPLEX c[],
+                            const LTFAT_REAL g[], const LTFAT_REAL gd[],
+                            ltfatInt L, ltfatInt gl, ltfatInt W, ltfatInt a,
+                            ltfatInt M)
+{
+    ltfatInt clen = (M / 2 + 1) * (L / a) * W;
+    LTFAT_REAL* f = LTFAT_NAME_REAL(malloc)(L * W);
+    LTFAT_COMPLEX* c2 = LTFAT_NAME_COMPLEX(malloc)(clen);
+    double err = 0.0, nrm = 0.0;
+
+    LTFAT_NAME(idgtreal_fb)(c, gd, L, gl, W, a, M, LTFAT_TIMEINV, f);
+    LTFAT_NAME(dgtreal_fb)(f, g, L, gl, W, a, M, LTFAT_TIMEINV, c2);
+
+    for (ltfatInt ii = 0; ii < clen; ii++)
+    {
+        double d = s[ii] - sqrt(ltfat_energy(c2[ii]));
+        err += d * d;
+        nrm += (double) s[ii] * s[ii];
+    }
+
+    LTFAT_SAFEFREEALL(f, c2);
+    return 10.0 * log10(err / nrm);
+}
+
+int TEST_NAME(test_rtisila)()
+{
+    ltfatInt L = 16384, gl = 256, a = 64, M = 256, M2 = M / 2 + 1, W = 2;
+    ltfatInt N = L / a, clen = M2 * N * W, lookahead = 3, maxit = 8;
+    double errdb, errdbseg;
+
+    LTFAT_REAL* f = LTFAT_NAME_REAL(malloc)(L * W);
+    LTFAT_REAL* g = LTFAT_NAME_REAL(malloc)(gl);
+    LTFAT_REAL* gd = LTFAT_NAME_REAL(malloc)(gl);
+    LTFAT_REAL* s = LTFAT_NAME_REAL(malloc)(clen);
+    LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(clen);
+    LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(clen);
+
+    // Chirps in noise, a different one in each channel
+    TEST_NAME(fillRand)(f, L * W);
+    for (ltfatInt w = 0; w < W; w++)
+        for (ltfatInt l = 0; l < L; l++)
+            f[l + w * L] = (LTFAT_REAL) (0.1 * f[l + w * L] +
+                           sin(2.0 * M_PI * (0.02 * (w + 1) * l + 4e-6 * l * l)));
+
+    LTFAT_NAME(firwin)(LTFAT_HANN, gl, g);
+    mu_assert( LTFAT_NAME(gabdual_painless)(g, gl, a, M, gd) == LTFATERR_SUCCESS,
+               "gabdual_painless");
+    mu_assert( LTFAT_NAME(dgtreal_fb)(f, g, L, gl, W, a, M, LTFAT_TIMEINV, cref)
+               == LTFATERR_SUCCESS, "dgtreal_fb");
+    for (ltfatInt ii = 0; ii < clen; ii++)
+        s[ii] = (LTFAT_REAL) sqrt(ltfat_energy(cref[ii]));
+
+    mu_assert( PHASERET_NAME(rtisilaoffline)(s, g, L, gl, W, a, M, lookahead,
+               maxit, cref) == LTFATERR_SUCCESS, "rtisilaoffline");
+    errdb = TEST_NAME(rtisila_magerrdb)(s, cref, g, gd, L, gl, W, a, M);
+    mu_assert( errdb < -20.0, "rtisilaoffline spectral convergence %.1f dB", errdb);
+
+    // The multi-channel FFTs equal the single channel ones
+    for (ltfatInt w = 0; w < W; w++)
+        mu_assert( PHASERET_NAME(rtisilaoffline)(s + w * M2 * N, g, L, gl, 1, a,
+                   M, lookahead, maxit, c + w * M2 * N) == LTFATERR_SUCCESS,
+                   "rtisilaoffline W=1");
+    mu_assert( memcmp(c, cref, clen * sizeof * c) == 0,
+               "rtisilaoffline channels one by one equal W=%td", W);
+
+    // Up to W threads, the channels are only divided among the threads
+    for (ltfatInt nthreads = 1; nthreads <= W; nthreads++)
+    {
+        mu_assert( PHASERET_NAME(rtisilaoffline_batched)(s, g, L, gl, W, a, M,
+                   lookahead, maxit, nthreads, c) == LTFATERR_SUCCESS,
+                   "rtisilaoffline_batched");
+        mu_assert( memcmp(c, cref, clen * sizeof * c) == 0,
+                   "rtisilaoffline_batched threads=%td equals rtisilaoffline",
+                   nthreads);
+    }
+
+    /* With more threads, the channels are split into 2 and 4 segments. The
+     * segments start from scratch, which costs about 1.5 dB per doubling of
+     * their number */
+    for (ltfatInt nthreads = 2 * W; nthreads <= 4 * W; nthreads *= 2)
+    {
+        mu_assert( PHASERET_NAME(rtisilaoffline_batched)(s, g, L, gl, W, a, M,
+                   lookahead, maxit, nthreads, c) == LTFATERR_SUCCESS,
+                   "rtisilaoffline_batched");
+        errdbseg = TEST_NAME(rtisila_magerrdb)(s, c, g, gd, L, gl, W, a, M);
+        mu_assert( errdbseg < errdb + 6.0,
+                   "rtisilaoffline_batched threads=%td spectral convergence "
+                   "%.1f dB, within 6 dB of rtisilaoffline", nthreads, errdbseg);
+    }
+
+    LTFAT_SAFEFREEALL(f, g, gd, s, cref, c);
+    return 0;
+}
@@ -0,0 +1,99 @@
+/* Runs rtpghi over N frames of s, M2 x W x N, one frame at a time */
+static int
+TEST_NAME(rtpghi_run)(ltfatInt W, ltfatInt a, ltfatInt M, double gamma,
+                      int do_causal, ltfat_heap_type heaptype, ltfatInt nthreads,
+                      const LTFAT_REAL s[], ltfatInt N, LTFAT_COMPLEX c[])
+{
+    PHASERET_NAME(rtpghi_state)* p = NULL;
+    ltfatInt M2 = M / 2 + 1;
+    int status;
+
+    // The coefficients below tol get phases drawn by rand() in rtpghi_init
+    srand(0);
+    if ((status = PHASERET_NAME(rtpghi_init)(W, a, M, gamma, 1e-6, do_causal,
+                  &p)))
+        return status;
+
+    if (!(status = PHASERET_NAME(rtpghi_set_heaptype)(p, heaptype)) &&
+        !(status = PHASERET_NAME(rtpghi_set_nthreads)(p, nthreads)))
+    {
+        for (ltfatInt n = 0; n < N && !status; n++)
+            status = PHASERET_NAME(rtpghi_execute)(p, s + n * M2 * W,
+                                                   c + n * M2 * W);
+    }
+
+    PHASERET_NAME(rtpghi_done)(&p);
+    return status;
+}
+
+int TEST_NAME(test_rtpghi)()
+{
+    ltfatInt W = 3, a = 64, M = 256, M2 = M / 2 + 1, N = 40, clen = M2 * W * N;
+    double gamma = phaseret_firwin2gamma(LTFAT_HANN, M);
+    double logtol = sizeof (LTFAT_REAL) == sizeof (double) ? 1e-14 : 1e-6;
+    ltfat_heap_type heaptypes[] = {LTFAT_HEAP_BINARY, LTFAT_HEAP_BUCKET};
+    ltfat_simd_level maxlevel = ltfat_simd_get_maxlevel();
+    double err = 0.0;
+
+    LTFAT_REAL* s = LTFAT_NAME_REAL(malloc)(clen);
+    LTFAT_REAL* slog = LTFAT_NAME_REAL(malloc)(clen);
+    LTFAT_COMPLEX* cref = LTFAT_NAME_COMPLEX(malloc)(clen);
+    LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(clen);
+    TEST_NAME(fillRand)(s, clen);
+
+    // Magnitudes over 16 octaves, zeros included
+    for (ltfatInt ii = 0; ii < clen; ii++)
+        s[ii] = ii % 97 ? (LTFAT_REAL) exp2(16.0 * s[ii] - 8.0) : 0;
+
+    // The logarithm is accurate to a few ulp at any level
+    PHASERET_NAME(rtpghilog)(s, clen, slog);
+    for (ltfatInt ii = 0; ii < clen; ii++)
+    {
+        LTFAT_REAL x = s[ii] + (sizeof (LTFAT_REAL) == sizeof (double) ?
+                                (LTFAT_REAL) DBL_MIN : (LTFAT_REAL) FLT_MIN);
+        err = fmax(err, fabs(slog[ii] - log((double) x)) / fmax(1.0, fabs(log(x))));
+    }
+    mu_assert( err < logtol, "rtpghilog equals log, error %.1e", err);
+
+    /* The scalar loop is the reference for the instruction sets. The
+     * kernels give bit-identical logarithms and gradients, so the phase does
+     * not depend on the instruction set either. */
+    for (int hi = 0; hi < 2; hi++)
+    {
+        for (int do_causal = 0; do_causal <= 1; do_causal++)
+        {
+            mu_assert( ltfat_simd_set_level(LTFAT_SIMD_NONE) == LTFATERR_SUCCESS,
+                       "simd_set_level none");
+            mu_assert( TEST_NAME(rtpghi_run)(W, a, M, gamma, do_causal,
+                       heaptypes[hi], 1, s, N, cref) == LTFATERR_SUCCESS,
+                       "rtpghi heap %d causal %d", hi, do_causal);
+
+            for (int level = LTFAT_SIMD_SSE2; level <= (int) maxlevel; level++)
+            {
+                mu_assert( ltfat_simd_set_level((ltfat_simd_level) level)
+                           == LTFATERR_SUCCESS, "simd_set_level");
+                mu_assert( TEST_NAME(rtpghi_run)(W, a, M, gamma, do_causal,
+                           heaptypes[hi], 1, s, N, c) == LTFATERR_SUCCESS,
+                           "rtpghi simd");
+                mu_assert( memcmp(c, cref, clen * sizeof * c) == 0,
+                           "rtpghi heap %d causal %d simd level %d equals scalar",
+                           hi, do_causal, level);
+            }
+            ltfat_simd_set_level(maxlevel);
+
+            // The channels are divided among the threads, at most W are used
+            for (ltfatInt nthreads = 2; nthreads <= 4; nthreads++)
+            {
+                mu_assert( TEST_NAME(rtpghi_run)(W, a, M, gamma, do_causal,
+                           heaptypes[hi], nthreads, s, N, c) == LTFATERR_SUCCESS,
+                           "rtpghi threads");
+                mu_assert( memcmp(c, cref, clen * sizeof * c) == 0,
+                           "rtpghi heap %d causal %d threads=%td equals threads=1",
+                           hi, do_causal, nthreads);
+            }
+        }
+    }
+
+    LTFAT_SAFEFREEALL(s, slog, cref, c);
+    return 0;
+}
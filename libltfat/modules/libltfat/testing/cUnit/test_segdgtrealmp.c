@@ -0,0 +1,72 @@
+int TEST_NAME(test_segdgtrealmp)()
+{
+    ltfatInt L = 16384, seglen = 1024, clen = 129 * (L / 32);
+    double snrdb = 15.0, errdb, errdbseg, errdbthr;
+    size_t atoms, atomsseg, atomsthr;
+    int status;
+
+    LTFAT_REAL* f = LTFAT_NAME_REAL(malloc)(L);
+    LTFAT_REAL* fout = LTFAT_NAME_REAL(malloc)(L);
+    LTFAT_REAL* foutthr = LTFAT_NAME_REAL(malloc)(L);
+    LTFAT_COMPLEX* c = LTFAT_NAME_COMPLEX(malloc)(clen);
+    LTFAT_COMPLEX* cthr = LTFAT_NAME_COMPLEX(malloc)(clen);
+    TEST_NAME(fillRand)(f, L);
+
+    LTFAT_NAME(dgtrealmp_parbuf)* pb = NULL;
+    LTFAT_NAME(dgtrealmp_state)* p = NULL;
+    LTFAT_NAME(segdgtrealmp_state)* sp = NULL;
+    mu_assert( LTFAT_NAME(dgtrealmp_parbuf_init)(&pb) == LTFATERR_SUCCESS,
+               "dgtrealmp_parbuf_init");
+    mu_assert( LTFAT_NAME(dgtrealmp_parbuf_add_firwin)(pb, LTFAT_HANN,
+               128, 32, 256) == LTFATERR_SUCCESS, "dgtrealmp_parbuf_add_firwin");
+    mu_assert( LTFAT_NAME(dgtrealmp_setparbuf_snrdb)(pb, snrdb) == LTFATERR_SUCCESS &&
+               LTFAT_NAME(dgtrealmp_setparbuf_maxatoms)(pb, L) == LTFATERR_SUCCESS,
+               "dgtrealmp_setparbuf");
+
+    // Reference: MP over the whole signal
+    mu_assert( LTFAT_NAME(dgtrealmp_init)(pb, L, &p) == LTFATERR_SUCCESS,
+               "dgtrealmp_init");
+    status = LTFAT_NAME(dgtrealmp_execute)(p, f, &c, fout);
+    mu_assert( status == LTFAT_DGTREALMP_STATUS_TOLREACHED,
+               "dgtrealmp reached the target SNR");
+    LTFAT_NAME(dgtrealmp_get_errdb)(p, &errdb);
+    LTFAT_NAME(dgtrealmp_get_numatoms)(p, &atoms);
+    LTFAT_NAME(dgtrealmp_done)(&p);
+
+    mu_assert( LTFAT_NAME(segdgtrealmp_init)(pb, L, seglen, 1, &sp)
+               == LTFATERR_SUCCESS, "segdgtrealmp_init");
+    mu_assert( LTFAT_NAME(segdgtrealmp_get_segno)(sp) == L / seglen,
+               "segdgtrealmp splits into L/seglen regions");
+    status = LTFAT_NAME(segdgtrealmp_execute)(sp, f, &c, fout);
+    mu_assert( status == LTFAT_DGTREALMP_STATUS_TOLREACHED,
+               "segdgtrealmp reached the target SNR");
+    LTFAT_NAME(segdgtrealmp_get_errdb)(sp, &errdbseg);
+    LTFAT_NAME(segdgtrealmp_get_numatoms)(sp, &atomsseg);
+    LTFAT_NAME(segdgtrealmp_done)(&sp);
+
+    mu_assert( fabs(errdbseg - errdb) < 0.5,
+               "segdgtrealmp SNR within 0.5 dB of dgtrealmp");
+    mu_assert( atomsseg < 1.1 * atoms,
+               "segdgtrealmp uses less than 10%% more atoms than dgtrealmp");
+
+    // The output does not depend on the number of threads
+    for (ltfatInt nthreads = 2; nthreads <= 4; nthreads++)
+    {
+        mu_assert( LTFAT_NAME(segdgtrealmp_init)(pb, L, seglen, nthreads, &sp)
+                   == LTFATERR_SUCCESS, "segdgtrealmp_init threads");
+        status = LTFAT_NAME(segdgtrealmp_execute)(sp, f, &cthr, foutthr);
+        LTFAT_NAME(segdgtrealmp_get_errdb)(sp, &errdbthr);
+        LTFAT_NAME(segdgtrealmp_get_numatoms)(sp, &atomsthr);
+        LTFAT_NAME(segdgtrealmp_done)(&sp);
+
+        mu_assert( status == LTFAT_DGTREALMP_STATUS_TOLREACHED &&
+                   atomsthr == atomsseg && errdbthr == errdbseg &&
+                   memcmp(cthr, c, clen * sizeof * c) == 0 &&
+                   memcmp(foutthr, fout, L * sizeof * fout) == 0,
+                   "segdgtrealmp threads=%td equals threads=1", nthreads);
+    }
+
+    LTFAT_NAME(dgtrealmp_parbuf_done)(&pb);
+    LTFAT_SAFEFREEALL(f, fout, foutthr, c, cthr);
+    return 0;
+}
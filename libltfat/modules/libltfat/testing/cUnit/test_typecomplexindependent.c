@@ -1,4 +1,10 @@
 #include "test_circshift.c"
+#include "test_fold_array.c"
+#include "test_convsub_td.c"
+#include "test_wfbt.c"
+#include "test_wfbt_stream.c"
+#include "test_gga.c"
+#include "test_chzt.c"
 #include "test_dgt_fb.c"
 #include "test_idgt_fb.c"
 #include "test_dgt_long.c"
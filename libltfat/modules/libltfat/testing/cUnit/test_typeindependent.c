@@ -9,3 +9,18 @@
 #include "test_idgtreal_fb.c"
 #include "test_dgtreal_long.c"
 #include "test_idgtreal_long.c"
+#include "test_fftcache.c"
+#include "test_arena.c"
+#include "test_heapint.c"
+#include "test_rtdgtreal.c"
+#include "test_block_processor.c"
+#include "test_maxtree.c"
+#include "test_dgtrealmp.c"
+#include "test_segdgtrealmp.c"
+#ifdef LTFAT_TEST_PHASERET
+#include "test_gla.c"
+#include "test_leglaupdate.c"
+#include "test_rtisila.c"
+#include "test_rtpghi.c"
+#include "test_pghi.c"
+#endif
@@ -0,0 +1,156 @@
+int TEST_NAME(test_wfbt)()
+{
+    ltfatInt L = 300, W = 3, J = 3, gl[] = {6, 6, 6}, a[] = {2, 2, 3};
+    ltfatInt offset[] = { -5, -5, -5};
+    int flags[] = {0, LTFAT_WFBT_PACKETS | LTFAT_WFBT_INTSQRT,
+                   LTFAT_WFBT_UNDECIMATED, LTFAT_WFBT_UNDECIMATED | LTFAT_WFBT_PACKETS
+                  };
+    ltfatExtType ext[] = {ZERO, PER};
+
+    LTFAT_TYPE* gbuf = LTFAT_NAME(malloc)(3 * gl[0]);
+    const LTFAT_TYPE* g[] = {gbuf, gbuf + gl[0], gbuf + 2 * gl[0]};
+    TEST_NAME(fillRand)(gbuf, 3 * gl[0]);
+
+    // DWT with J levels: node j is attached to the lowpass channel of node j-1
+    LTFAT_NAME(wfbt_node) dwt[3];
+    for (ltfatInt j = 0; j < J; j++)
+        dwt[j] = (LTFAT_NAME(wfbt_node)) { 2, g, gl, a, offset, j - 1, 0 };
+
+    // Irregular tree: three-channel root with nodes on channels 2 and 0
+    LTFAT_NAME(wfbt_node) tree[3] =
+    {
+        { 3, g, gl, a, offset, -1, 0 },
+        { 2, g, gl, a, offset,  0, 2 },
+        { 2, g, gl, a, offset,  0, 0 },
+    };
+
+    LTFAT_TYPE* f = LTFAT_NAME(malloc)(L * W);
+    LTFAT_TYPE* fout = LTFAT_NAME(malloc)(L * W);
+    TEST_NAME(fillRand)(f, L * W);
+
+    // The J-level DWT equals the chain of filterbank_td
+    {
+        LTFAT_NAME(wfbt_plan)* p = NULL;
+        LTFAT_TYPE* c[4] = {NULL};
+        LTFAT_TYPE* cref[2] = {NULL};
+        LTFAT_TYPE* lev = LTFAT_NAME(malloc)(L * W);
+        ltfatInt Llev = L;
+        double err = 0.0;
+
+        mu_assert( LTFAT_NAME(wfbt_init)(dwt, J, L, W, PER, 0, 2, &p)
+                   == LTFATERR_SUCCESS, "wfbt_init dwt");
+        mu_assert( LTFAT_NAME(wfbt_get_outno)(p) == J + 1, "wfbt outno");
+
+        for (ltfatInt m = 0; m < J + 1; m++)
+            c[m] = LTFAT_NAME(malloc)(LTFAT_NAME(wfbt_get_outlen)(p, m) * W);
+
+        mu_assert( LTFAT_NAME(wfbt_execute)(p, f, c) == LTFATERR_SUCCESS,
+                   "wfbt_execute dwt");
+
+        memcpy(lev, f, L * W * sizeof * lev);
+        for (ltfatInt j = 0; j < J; j++)
+        {
+            ltfatInt N = filterbank_td_size(Llev, a[0], gl[0], offset[0], PER);
+            mu_assert( N == LTFAT_NAME(wfbt_get_outlen)(p, j), "wfbt outlen");
+            cref[0] = LTFAT_NAME(malloc)(N * W);
+            cref[1] = LTFAT_NAME(malloc)(N * W);
+            LTFAT_NAME(filterbank_td)(lev, g, Llev, gl, W, a, offset, 2, cref, PER);
+
+            // Highpass of all nodes, the lowpass of the last node comes before it
+            LTFAT_TYPE* chigh = j < J - 1 ? c[j] : c[J];
+            for (ltfatInt n = 0; n < N * W; n++)
+                err += sqrt(ltfat_energy(chigh[n] - cref[1][n]));
+            if (j == J - 1)
+                for (ltfatInt n = 0; n < N * W; n++)
+                    err += sqrt(ltfat_energy(c[J - 1][n] - cref[0][n]));
+
+            for (ltfatInt w = 0; w < W; w++)
+                memcpy(lev + w * N, cref[0] + w * N, N * sizeof * lev);
+            Llev = N;
+            ltfat_free(cref[0]); ltfat_free(cref[1]);
+        }
+        mu_assert( err < 1e-4, "wfbt dwt equals filterbank_td");
+
+        for (ltfatInt m = 0; m < J + 1; m++) ltfat_free(c[m]);
+        ltfat_free(lev);
+        LTFAT_NAME(wfbt_done)(&p);
+    }
+
+    // iwfbt with the same filters is the adjoint, the result does not
+    // depend on the number of threads
+    for (unsigned int fId = 0; fId < ARRAYLEN(flags); fId++)
+    {
+        for (unsigned int eId = 0; eId < ARRAYLEN(ext); eId++)
+        {
+            LTFAT_NAME(wfbt_plan)* p = NULL;
+            LTFAT_NAME(wfbt_plan)* p1 = NULL;
+            LTFAT_NAME(iwfbt_plan)* ip = NULL;
+            LTFAT_TYPE* c[7] = {NULL};
+            LTFAT_TYPE* c1[7] = {NULL};
+            LTFAT_TYPE* c2[7] = {NULL};
+            LTFAT_TYPE ipc = 0, ipf = 0;
+            double err = 0.0;
+
+            mu_assert( LTFAT_NAME(wfbt_init)(tree, 3, L, W, ext[eId], flags[fId],
+                       3, &p) == LTFATERR_SUCCESS, "wfbt_init");
+            mu_assert( LTFAT_NAME(wfbt_init)(tree, 3, L, W, ext[eId], flags[fId],
+                       1, &p1) == LTFATERR_SUCCESS, "wfbt_init 1 thread");
+            mu_assert( LTFAT_NAME(iwfbt_init)(tree, 3, L, W, ext[eId], flags[fId],
+                       3, &ip) == LTFATERR_SUCCESS, "iwfbt_init");
+
+            ltfatInt M = LTFAT_NAME(wfbt_get_outno)(p);
+            mu_assert( M == (flags[fId] & LTFAT_WFBT_PACKETS ? 7 : 5), "wfbt outno");
+            mu_assert( LTFAT_NAME(iwfbt_get_inno)(ip) == M, "iwfbt inno");
+
+            for (ltfatInt m = 0; m < M; m++)
+            {
+                ltfatInt N = LTFAT_NAME(wfbt_get_outlen)(p, m);
+                mu_assert( LTFAT_NAME(iwfbt_get_inlen)(ip, m) == N, "iwfbt inlen");
+                mu_assert( !(flags[fId] & LTFAT_WFBT_UNDECIMATED) || N == L,
+                           "uwfbt outlen");
+                c[m] = LTFAT_NAME(malloc)(N * W);
+                c1[m] = LTFAT_NAME(malloc)(N * W);
+                c2[m] = LTFAT_NAME(malloc)(N * W);
+                TEST_NAME(fillRand)(c2[m], N * W);
+            }
+
+            mu_assert( LTFAT_NAME(wfbt_execute)(p, f, c) == LTFATERR_SUCCESS,
+                       "wfbt_execute");
+            mu_assert( LTFAT_NAME(wfbt_execute)(p1, f, c1) == LTFATERR_SUCCESS,
+                       "wfbt_execute 1 thread");
+            mu_assert( LTFAT_NAME(iwfbt_execute)(ip, (const LTFAT_TYPE**) c2, fout)
+                       == LTFATERR_SUCCESS, "iwfbt_execute");
+
+            for (ltfatInt m = 0; m < M; m++)
+            {
+                ltfatInt N = LTFAT_NAME(wfbt_get_outlen)(p, m);
+                err += memcmp(c[m], c1[m], N * W * sizeof * c[m]) != 0;
+                LTFAT_NAME(conjugate_array)(c2[m], N * W, c2[m]);
+                for (ltfatInt n = 0; n < N * W; n++) ipc += c[m][n] * c2[m][n];
+            }
+            mu_assert( err == 0.0, "wfbt threads");
+
+            LTFAT_NAME(conjugate_array)(fout, L * W, fout);
+            for (ltfatInt l = 0; l < L * W; l++) ipf += f[l] * fout[l];
+            mu_assert( sqrt(ltfat_energy(ipc - ipf)) < 1e-3 * (1.0 + sqrt(ltfat_energy(ipc))),
+                       "iwfbt is adjoint");
+
+            for (ltfatInt m = 0; m < M; m++)
+                LTFAT_SAFEFREEALL(c[m], c1[m], c2[m]);
+            LTFAT_NAME(wfbt_done)(&p);
+            LTFAT_NAME(wfbt_done)(&p1);
+            LTFAT_NAME(iwfbt_done)(&ip);
+        }
+    }
+
+    // Channel 2 of the root used twice
+    LTFAT_NAME(wfbt_plan)* p = NULL;
+    tree[2].parentch = 2;
+    mu_assert( LTFAT_NAME(wfbt_init)(tree, 3, L, W, PER, 0, 1, &p)
+               == LTFATERR_BADARG, "wfbt_init bad tree");
+    mu_assert( LTFAT_NAME(wfbt_init)(tree, 3, L, W, PER, LTFAT_WFBT_INTSCALE, 1, &p)
+               == LTFATERR_BADARG, "wfbt_init interscaling without packets");
+
+    LTFAT_SAFEFREEALL(gbuf, f, fout);
+    return 0;
+}
@@ -0,0 +1,144 @@
+int TEST_NAME(test_wfbt_stream)()
+{
+    // The last 100 samples of f are zero and the stream is fed with further
+    // zeros, so the ZERO extension plans see the same signal
+    ltfatInt L = 300, Lz = 100, Ltot = 700, maxLb = 37;
+    ltfatInt gl[] = {6, 6, 6}, a[] = {2, 2, 3}, offset[] = { -5, -5, -5};
+    ltfatInt skippos[] = {1, 1, 1};
+    int flags[] = {0, LTFAT_WFBT_PACKETS | LTFAT_WFBT_INTSQRT,
+                   LTFAT_WFBT_UNDECIMATED, LTFAT_WFBT_UNDECIMATED | LTFAT_WFBT_PACKETS
+                  };
+
+    LTFAT_TYPE* gbuf = LTFAT_NAME(malloc)(3 * gl[0]);
+    const LTFAT_TYPE* g[] = {gbuf, gbuf + gl[0], gbuf + 2 * gl[0]};
+    TEST_NAME(fillRand)(gbuf, 3 * gl[0]);
+
+    LTFAT_NAME(wfbt_node) tree[3] =
+    {
+        { 3, g, gl, a, offset, -1, 0 },
+        { 2, g, gl, a, offset,  0, 2 },
+        { 2, g, gl, a, offset,  0, 0 },
+    };
+
+    LTFAT_TYPE* f = LTFAT_NAME(calloc)(Ltot);
+    LTFAT_TYPE* fplan = LTFAT_NAME(malloc)(L);
+    LTFAT_TYPE* fstream = LTFAT_NAME(malloc)(Ltot);
+    TEST_NAME(fillRand)(f, L - Lz);
+
+    // Random block lengths, including empty blocks
+    ltfatInt Lbs[1000], blocksNo = 0;
+    for (ltfatInt l = 0; l < Ltot; l += Lbs[blocksNo++])
+        Lbs[blocksNo] = blocksNo % 5 == 3 ? 0 :
+                        ltfat_imin(1 + rand() % maxLb, Ltot - l);
+
+    for (unsigned int fId = 0; fId < ARRAYLEN(flags); fId++)
+    {
+        LTFAT_NAME(wfbt_plan)* p = NULL;
+        LTFAT_NAME(iwfbt_plan)* ip = NULL;
+        LTFAT_NAME(wfbt_stream)* s = NULL;
+        LTFAT_NAME(iwfbt_stream)* is = NULL;
+        LTFAT_TYPE* c[7] = {NULL};
+        LTFAT_TYPE* cs[7] = {NULL};
+        LTFAT_TYPE* cb[7] = {NULL};
+        LTFAT_TYPE* cpos[7] = {NULL};
+        ltfatInt N[7], pos[7] = {0}, cLen[7];
+        double err = 0.0, ierr = 0.0;
+
+        mu_assert( LTFAT_NAME(wfbt_init)(tree, 3, L, 1, ZERO, flags[fId], 1, &p)
+                   == LTFATERR_SUCCESS, "wfbt_init");
+        mu_assert( LTFAT_NAME(iwfbt_init)(tree, 3, L, 1, ZERO, flags[fId], 1, &ip)
+                   == LTFATERR_SUCCESS, "iwfbt_init");
+        mu_assert( LTFAT_NAME(wfbt_stream_init)(tree, 3, maxLb, flags[fId], &s)
+                   == LTFATERR_SUCCESS, "wfbt_stream_init");
+        mu_assert( LTFAT_NAME(iwfbt_stream_init)(tree, 3, maxLb, flags[fId], &is)
+                   == LTFATERR_SUCCESS, "iwfbt_stream_init");
+
+        ltfatInt M = LTFAT_NAME(wfbt_get_outno)(p);
+        ltfatInt delay = LTFAT_NAME(iwfbt_stream_get_delay)(is);
+        mu_assert( LTFAT_NAME(wfbt_stream_get_outno)(s) == M, "wfbt_stream outno");
+        mu_assert( delay >= 0 && delay + L <= Ltot, "iwfbt_stream delay");
+
+        for (ltfatInt m = 0; m < M; m++)
+        {
+            N[m] = LTFAT_NAME(wfbt_get_outlen)(p, m);
+            c[m] = LTFAT_NAME(malloc)(N[m]);
+            cs[m] = LTFAT_NAME(calloc)(Ltot);
+            cb[m] = LTFAT_NAME(malloc)(LTFAT_NAME(wfbt_stream_get_maxoutlen)(s, m));
+        }
+
+        mu_assert( LTFAT_NAME(wfbt_execute)(p, f, c) == LTFATERR_SUCCESS,
+                   "wfbt_execute");
+        mu_assert( LTFAT_NAME(iwfbt_execute)(ip, (const LTFAT_TYPE**) c, fplan)
+                   == LTFATERR_SUCCESS, "iwfbt_execute");
+
+        // Analysis: the stream equals the plan. Synthesis of the plan
+        // coefficients: the stream equals the plan delayed by delay.
+        for (ltfatInt b = 0, l = 0; b < blocksNo; l += Lbs[b++])
+        {
+            for (ltfatInt m = 0; m < M; m++)
+                cpos[m] = cs[m] + pos[m];
+
+            mu_assert( LTFAT_NAME(wfbt_stream_execute)(s, f + l, Lbs[b], cpos, cLen)
+                       == LTFATERR_SUCCESS, "wfbt_stream_execute");
+
+            for (ltfatInt m = 0; m < M; m++)
+            {
+                for (ltfatInt n = 0; n < cLen[m]; n++)
+                    cb[m][n] = pos[m] + n < N[m] ? c[m][pos[m] + n] : 0;
+                pos[m] += cLen[m];
+            }
+
+            mu_assert( LTFAT_NAME(iwfbt_stream_execute)(is, (const LTFAT_TYPE**) cb,
+                       cLen, Lbs[b], fstream + l) == LTFATERR_SUCCESS,
+                       "iwfbt_stream_execute");
+        }
+
+        for (ltfatInt m = 0; m < M; m++)
+        {
+            mu_assert( pos[m] >= N[m], "wfbt_stream outlen");
+            for (ltfatInt n = 0; n < N[m]; n++)
+                err += sqrt(ltfat_energy(cs[m][n] - c[m][n]));
+        }
+        mu_assert( err < 1e-3, "wfbt_stream equals wfbt");
+
+        for (ltfatInt l = 0; l < Ltot; l++)
+        {
+            LTFAT_TYPE ref = l >= delay && l < delay + L ? fplan[l - delay] : 0;
+            if (l < delay + L)
+                ierr += sqrt(ltfat_energy(fstream[l] - ref));
+        }
+        mu_assert( ierr < 1e-3 * L, "iwfbt_stream equals iwfbt");
+
+        // The lengths must follow the block length. cLen is left from the
+        // last block, which need not have been of length Lbs[0], so use a
+        // length which never matches.
+        cLen[0] = -1;
+        mu_assert( LTFAT_NAME(iwfbt_stream_execute)(is, (const LTFAT_TYPE**) cb,
+                   cLen, Lbs[0], fstream) == LTFATERR_BADARG,
+                   "iwfbt_stream_execute bad cLen");
+
+        // After reset, the stream starts over
+        LTFAT_NAME(wfbt_stream_reset)(s);
+        mu_assert( LTFAT_NAME(wfbt_stream_execute)(s, f, maxLb, cb, cLen)
+                   == LTFATERR_SUCCESS, "wfbt_stream_execute after reset");
+        err = 0.0;
+        for (ltfatInt m = 0; m < M; m++)
+            err += memcmp(cb[m], cs[m], cLen[m] * sizeof * cb[m]) != 0;
+        mu_assert( err == 0.0, "wfbt_stream_reset");
+
+        for (ltfatInt m = 0; m < M; m++)
+            LTFAT_SAFEFREEALL(c[m], cs[m], cb[m]);
+        LTFAT_NAME(wfbt_done)(&p);
+        LTFAT_NAME(iwfbt_done)(&ip);
+        LTFAT_NAME(wfbt_stream_done)(&s);
+        LTFAT_NAME(iwfbt_stream_done)(&is);
+    }
+
+    // Filters must not look ahead of the block
+    LTFAT_NAME(filterbank_td_stream)* fs = NULL;
+    mu_assert( LTFAT_NAME(filterbank_td_stream_init)(g, gl, a, skippos, 3, maxLb,
+               &fs) == LTFATERR_BADARG, "filterbank_td_stream_init positive skip");
+
+    LTFAT_SAFEFREEALL(gbuf, f, fplan, fstream);
+    return 0;
+}
@@ -20,6 +20,8 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #include <limits.h>
 
 #define MAXFACTORS 64
+/* Radices up to this use a scratch buffer on the stack in kf_bfly_generic */
+#define KISS_FFT_STACKRADIX 64
 /* e.g. an fft of length 128 has 4 factors 
  as far as kissfft is concerned
  4*4*4*2
@@ -19,6 +19,7 @@ struct LTFAT_KISS(fft_plan){
     int nfft;
     int inverse;
     int factors[2*MAXFACTORS];
+    kiss_fft_cpx* scratch; /* for radices above KISS_FFT_STACKRADIX, or NULL */
     kiss_fft_cpx twiddles[1];
 };
 
@@ -249,8 +250,11 @@ static void kf_bfly_generic(
     kiss_fft_cpx t;
     int Norig = st->nfft;
 
-    kiss_fft_cpx* scratch = (kiss_fft_cpx*)KISS_FFT_TMP_ALLOC(sizeof(
-                                kiss_fft_cpx) * p);
+    /* No allocation here, small radices use the stack and the buffer for
+     * the large ones is part of the plan (which makes such plans
+     * non-reentrant) */
+    kiss_fft_cpx stackscratch[KISS_FFT_STACKRADIX];
+    kiss_fft_cpx* scratch = p <= KISS_FFT_STACKRADIX ? stackscratch : st->scratch;
 
     for ( u = 0; u < m; ++u )
     {
@@ -277,7 +281,6 @@ static void kf_bfly_generic(
             k += m;
         }
     }
-    KISS_FFT_TMP_FREE(scratch);
 }
 
 static
@@ -400,8 +403,20 @@ LTFAT_KISS(fft_plan)*
 LTFAT_KISS(fft_alloc)(int nfft, int inverse_fft, void* mem, size_t* lenmem )
 {
     LTFAT_KISS(fft_plan)* st = NULL;
-    size_t memneeded = sizeof(struct LTFAT_KISS(fft_plan))
-                       + sizeof(kiss_fft_cpx) * (nfft - 1); /* twiddle factors*/
+    int factors[2*MAXFACTORS];
+    int i, maxradix = 0;
+    size_t memneeded;
+
+    kf_factor(nfft, factors);
+    for (i = 0; factors[2 * i + 1] > 1; ++i)
+        if (factors[2 * i] > maxradix) maxradix = factors[2 * i];
+    if (factors[2 * i] > maxradix) maxradix = factors[2 * i];
+    if (maxradix <= KISS_FFT_STACKRADIX)
+        maxradix = 0;
+
+    memneeded = sizeof(struct LTFAT_KISS(fft_plan))
+                + sizeof(kiss_fft_cpx) * (nfft - 1) /* twiddle factors*/
+                + sizeof(kiss_fft_cpx) * maxradix; /* generic butterfly scratch */
 
     if ( lenmem == NULL )
     {
@@ -415,9 +430,10 @@ LTFAT_KISS(fft_alloc)(int nfft, int inverse_fft, void* mem, size_t* lenmem )
     }
     if (st)
     {
-        int i;
         st->nfft = nfft;
         st->inverse = inverse_fft;
+        st->scratch = maxradix ? st->twiddles + nfft : NULL;
+        memcpy(st->factors, factors, sizeof factors);
 
         for (i = 0; i < nfft; ++i)
         {
@@ -428,8 +444,6 @@ LTFAT_KISS(fft_alloc)(int nfft, int inverse_fft, void* mem, size_t* lenmem )
                 phase *= -1;
             kf_cexp(st->twiddles + i, phase );
         }
-
-        kf_factor(nfft, st->factors);
     }
     return st;
 }
@@ -167,6 +167,13 @@ PHASERET_NAME(gla)(const LTFAT_COMPLEX cinit[], const int mask[], const LTFAT_RE
  *
  *  \note In-place mode i.e. \a cinit == \a c is allowed.
  *
+ *  \note The number of threads set by ltfat_dgt_setpar_nthreads() in \a params
+ *  is used for the whole iteration. Channels are then transformed in parallel
+ *  (each by its own single channel DGT plan) and the magnitude projection
+ *  together with the acceleration step is done in blocks. The result does
+ *  not depend on the number of threads. The callbacks are always run by
+ *  the calling thread.
+ *
  *  \param[in]  cinit   Initial set of coefficients, size M2 x N x W or NULL
  *  \param[in]      g   Analysis window, size gl x 1
  *  \param[in]      L   Signal length
@@ -73,6 +73,13 @@ PHASERET_NAME(gsrtisilaoffline)(const LTFAT_REAL s[], const LTFAT_REAL g[],
                                 ltfat_int L, ltfat_int gl, ltfat_int W, ltfat_int a, ltfat_int M,
                                 ltfat_int lookahead, ltfat_int maxit, LTFAT_COMPLEX c[]);
 
+/** Threaded gsrtisilaoffline, see rtisilaoffline_batched */
+PHASERET_API int
+PHASERET_NAME(gsrtisilaoffline_batched)(const LTFAT_REAL s[], const LTFAT_REAL g[],
+                                        ltfat_int L, ltfat_int gl, ltfat_int W, ltfat_int a, ltfat_int M,
+                                        ltfat_int lookahead, ltfat_int maxit, ltfat_int nthreads,
+                                        LTFAT_COMPLEX c[]);
+
 
 #ifdef __cplusplus
 }
@@ -255,6 +255,10 @@ PHASERET_NAME(legla)(const LTFAT_COMPLEX cinit[], const LTFAT_REAL g[], ltfat_in
  *  \param[in]  params   Optional parameters
  *  \param[out]      c   Coefficients with reconstructed phase, size M2 x N x W, cannot be NULL
  *
+ *  \note The number of threads set by ltfat_dgt_setpar_nthreads() in
+ *  \a params is used also by the coefficient update, see
+ *  leglaupdate_set_nthreads().
+ *
  * #### Versions #
  * <tt>
  * phaseret_legla_init_d(const ltfat_complex_d cinit[], const double g[],
@@ -432,6 +436,29 @@ PHASERET_NAME(leglaupdate_execute)(PHASERET_NAME(leglaupdate_plan)* plan,
 PHASERET_API void
 PHASERET_NAME(leglaupdate_done)(PHASERET_NAME(leglaupdate_plan)** plan);
 
+/** Set number of threads used by leglaupdate_execute
+ *
+ * The kernel columns acting on coefficients not yet updated in the current
+ * iteration are applied to blocks of columns in parallel, the rest is
+ * applied to the channels in parallel. With the MOD_STEPWISE
+ * modification, all the columns are processed in parallel. The result
+ * does not depend on the number of threads.
+ *
+ * \param[in]  plan      Update plan
+ * \param[in]  nthreads  Number of threads, 0 means number of processors
+ *
+ * \returns
+ * Status code           | Description
+ * ----------------------|-----------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | \a plan was NULL
+ * LTFATERR_BADARG       | \a nthreads was negative
+ * LTFATERR_NOMEM        | Memory allocation error occurred
+ */
+PHASERET_API int
+PHASERET_NAME(leglaupdate_set_nthreads)(PHASERET_NAME(leglaupdate_plan)* plan,
+                                        ltfat_int nthreads);
+
 /* Single col update */
 PHASERET_API int
 PHASERET_NAME(leglaupdate_col_init)(ltfat_int M, phaseret_size ksize, int flags,
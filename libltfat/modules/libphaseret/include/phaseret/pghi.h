@@ -94,7 +94,6 @@ PHASERET_NAME(pghi_withmask)(const LTFAT_COMPLEX cin[], const int mask[],
  *
  * M2 = M/2 + 1, N = L/a
  *
- * \param[in]    gamma  Window specific constant
  * \param[in]        L  Signal length
  * \param[in]        W  Number of channels
  * \param[in]        a  Hop factor
@@ -103,16 +102,17 @@ PHASERET_NAME(pghi_withmask)(const LTFAT_COMPLEX cin[], const int mask[],
  * \param[in]     tol2  Relative tolernace for the second pass, must be in range [0-1] and
  *                      lower or equal to \a tol1. If \a tol2 is NAN or it is equal to
  *                      \a tol1, only the first pass will be done.
+ * \param[in]    gamma  Window specific constant
  * \param[out]       p  PGHI plan
  *
  * #### Versions #
  * <tt>
- * phaseret_pghi_init_d(double gamma, ltfat_int L, ltfat_int W,
- *                      ltfat_int a, ltfat_int M, double tol1, double tol2,
+ * phaseret_pghi_init_d(ltfat_int L, ltfat_int W, ltfat_int a, ltfat_int M,
+ *                      double tol1, double tol2, double gamma,
  *                      phaseret_pghi_plan_d** p);
  *
- * phaseret_pghi_init_s(double gamma, ltfat_int L, ltfat_int W,
- *                      ltfat_int a, ltfat_int M, double tol1, double tol2,
+ * phaseret_pghi_init_s(ltfat_int L, ltfat_int W, ltfat_int a, ltfat_int M,
+ *                      double tol1, double tol2, double gamma,
  *                      phaseret_pghi_plan_s** p);
  * </tt>
  * \returns
@@ -129,9 +129,43 @@ PHASERET_NAME(pghi_withmask)(const LTFAT_COMPLEX cin[], const int mask[],
  */
 PHASERET_API int
 PHASERET_NAME(pghi_init)(ltfat_int L, ltfat_int W, ltfat_int a, ltfat_int M,
-                         double gamma, double tol1, double tol2,
+                         double tol1, double tol2, double gamma,
                          PHASERET_NAME(pghi_plan)** p);
 
+/** Initialize PGHI plan with a given priority queue of the integration
+ *
+ * Same as pghi_init() but the coefficients are integrated in the order
+ * given by a heap of type \a heaptype. pghi_init() uses LTFAT_HEAP_BINARY,
+ * which processes the coefficients exactly in the order of decreasing
+ * magnitude. LTFAT_HEAP_BUCKET does O(1) work per coefficient, but the
+ * order is only exact up to 1/8 of an octave of the magnitude, see
+ * heap_initwithtype().
+ *
+ * #### Versions #
+ * <tt>
+ * phaseret_pghi_init_withheaptype_d(ltfat_int L, ltfat_int W, ltfat_int a,
+ *                                   ltfat_int M, double tol1, double tol2,
+ *                                   double gamma, ltfat_heap_type heaptype,
+ *                                   phaseret_pghi_plan_d** p);
+ *
+ * phaseret_pghi_init_withheaptype_s(ltfat_int L, ltfat_int W, ltfat_int a,
+ *                                   ltfat_int M, double tol1, double tol2,
+ *                                   double gamma, ltfat_heap_type heaptype,
+ *                                   phaseret_pghi_plan_s** p);
+ * </tt>
+ * \returns
+ * Status code              | Description
+ * -------------------------|--------------------------------------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_BADARG          | \a heaptype was not a valid heap type
+ * \see pghi_init
+ */
+PHASERET_API int
+PHASERET_NAME(pghi_init_withheaptype)(ltfat_int L, ltfat_int W, ltfat_int a,
+                                      ltfat_int M, double tol1, double tol2,
+                                      double gamma, ltfat_heap_type heaptype,
+                                      PHASERET_NAME(pghi_plan)** p);
+
 /** Execute PGHI plan
  *
  * M2 = M/2 + 1, N = L/a
@@ -45,6 +45,39 @@ void
 PHASERET_NAME(rtisilaphaseupdatesyn)(PHASERET_NAME(rtisilaupdate_plan) * p,
                                      const LTFAT_COMPLEX* c, LTFAT_REAL* frameupd);
 
+/* The _batch versions work with all W frames of a plan created by
+ * rtisilaupdate_init_batch at once. The frames of the w-th channel start at
+ * w*framesdist, the magnitude at w*sdist and the coefficients at w*cdist.
+ * The FFTs of the W frames are done by a single multi-column transform. */
+void
+PHASERET_NAME(rtisilaoverlaynthframe_batch)(PHASERET_NAME(rtisilaupdate_plan)* p,
+        const LTFAT_REAL* frames, ltfat_int framesdist, const LTFAT_REAL* g,
+        ltfat_int n, ltfat_int N);
+
+void
+PHASERET_NAME(rtisilaphaseupdate_batch)(PHASERET_NAME(rtisilaupdate_plan)* p,
+                                        const LTFAT_REAL* sframe, ltfat_int sdist,
+                                        LTFAT_REAL* frameupd, ltfat_int frameupddist,
+                                        LTFAT_COMPLEX* c, ltfat_int cdist);
+
+void
+PHASERET_NAME(rtisilaphaseupdatesyn_batch)(PHASERET_NAME(rtisilaupdate_plan)* p,
+        const LTFAT_COMPLEX* c, ltfat_int cdist,
+        LTFAT_REAL* frameupd, ltfat_int frameupddist);
+
+int
+PHASERET_NAME(rtisilaupdate_init_batch)(const LTFAT_REAL* g, const LTFAT_REAL* specg1,
+                                        const LTFAT_REAL* specg2, const LTFAT_REAL* gd,
+                                        ltfat_int gl, ltfat_int a, ltfat_int M, ltfat_int W,
+                                        PHASERET_NAME(rtisilaupdate_plan)** p);
+
+/* In-place rtisilaupdate_execute of all W channels */
+void
+PHASERET_NAME(rtisilaupdate_execute_batch)(PHASERET_NAME(rtisilaupdate_plan)* p,
+        LTFAT_REAL* frames, ltfat_int framesdist, ltfat_int N,
+        const LTFAT_REAL* s, ltfat_int sdist, ltfat_int lookahead, ltfat_int maxit,
+        LTFAT_COMPLEX* c, ltfat_int cdist);
+
 /** Create a RTISILA Update Plan.
  * \param[in]     g          Analysis window
  * \param[in]     specg1     Analysis window used in the first iteration
@@ -347,6 +380,62 @@ PHASERET_API int
 PHASERET_NAME(rtisilaoffline)(const LTFAT_REAL s[], const LTFAT_REAL g[],
                               ltfat_int L, ltfat_int gl, ltfat_int W, ltfat_int a, ltfat_int M,
                               ltfat_int lookahead, ltfat_int maxit, LTFAT_COMPLEX c[]);
+
+/** Do RTISI-LA for a complete magnitude spectrogram using threads
+ *
+ * All channels are processed at once, so the per-frame FFTs of the channels
+ * are done by multi-column transforms. When there are less channels than
+ * threads, each channel is further split into segments processed in
+ * parallel. Each segment but the first one is started
+ * ceil(gl/a) + lookahead frames earlier, the coefficients of these
+ * warm-up frames are discarded and the sign of the segment is chosen such
+ * that they agree with the end of the previous segment. Segmented channels
+ * therefore differ from the sequential result; with \a nthreads = 1 or
+ * \a nthreads <= W the result is equal to rtisilaoffline(). Each doubling
+ * of the number of segments raises the spectral convergence by about
+ * 1.5 dB, the test suite allows 6 dB for up to 4 segments per channel.
+ *
+ * \param[in]     s          Magnitude spectrogram, size M2 x N x W
+ * \param[in]     g          Analysis window, size gl x 1
+ * \param[in]     L          Transform length
+ * \param[in]     gl         Window length
+ * \param[in]     W          Number of signal channels
+ * \param[in]     a          Hop size
+ * \param[in]     M          Number of frequency channels (FFT length)
+ * \param[in]     lookahead  Number of lookahead frames
+ * \param[in]     maxit      Number of per-frame iterations
+ * \param[in]     nthreads   Number of threads, 0 means one per processor
+ * \param[out]    c          Reconstructed coefficients M2 x N x W array
+ *
+ * #### Versions #
+ * <tt>
+ * phaseret_rtisilaoffline_batched_d(const double s[], const double g[],
+ *                                   ltfat_int L, ltfat_int gl, ltfat_int W,
+ *                                   ltfat_int a, ltfat_int M,
+ *                                   ltfat_int lookahead, ltfat_int maxit,
+ *                                   ltfat_int nthreads, ltfat_complex_d c[]);
+ *
+ * phaseret_rtisilaoffline_batched_s(const float s[], const float g[],
+ *                                   ltfat_int L, ltfat_int gl, ltfat_int W,
+ *                                   ltfat_int a, ltfat_int M,
+ *                                   ltfat_int lookahead, ltfat_int maxit,
+ *                                   ltfat_int nthreads, ltfat_complex_s c[]);
+ * </tt>
+ * \returns
+ * Status code              | Description
+ * -------------------------|--------------------------------------------
+ * LTFATERR_SUCCESS         | Indicates no error
+ * LTFATERR_NULLPOINTER     | \a s, \a g or \a c was NULL
+ * LTFATERR_NOTPOSARG       | One of \a W, \a a, \a M or \a maxit was not positive
+ * LTFATERR_BADARG          | \a lookahead or \a nthreads was negative
+ * LTFATERR_NOMEM           | Heap allocation failed
+ * LTFATERR_INITFAILED      | FFTW plan creation or thread creation failed
+ */
+PHASERET_API int
+PHASERET_NAME(rtisilaoffline_batched)(const LTFAT_REAL s[], const LTFAT_REAL g[],
+                                      ltfat_int L, ltfat_int gl, ltfat_int W, ltfat_int a, ltfat_int M,
+                                      ltfat_int lookahead, ltfat_int maxit, ltfat_int nthreads,
+                                      LTFAT_COMPLEX c[]);
 /** @} */
 
 #ifdef __cplusplus
@@ -126,6 +126,64 @@ PHASERET_NAME(rtpghi_set_causal)(PHASERET_NAME(rtpghi_state)* p, int do_causal);
 PHASERET_API int
 PHASERET_NAME(rtpghi_set_tol)(PHASERET_NAME(rtpghi_state)* p, double tol);
 
+/** Choose the priority queue of the phase integration
+ *
+ * LTFAT_HEAP_BINARY (default) processes the coefficients exactly in the
+ * order of decreasing magnitude. With LTFAT_HEAP_BUCKET the log-magnitude
+ * range given by \a tol is divided into 256 uniform buckets and the
+ * coefficients are processed in the order of the buckets, LIFO within a
+ * bucket. All queue operations are then O(1) and the integration of a frame
+ * takes a fixed amount of work for given \a M, independent of the data.
+ *
+ * \note This is not thread safe
+ *
+ * \param[in] p     RTPGHI plan
+ * \param[in] type  Queue type
+ *
+ * #### Versions #
+ * <tt>
+ * phaseret_rtpghi_set_heaptype_d(phaseret_rtpghi_state_d* p, ltfat_heap_type type);
+ *
+ * phaseret_rtpghi_set_heaptype_s(phaseret_rtpghi_state_s* p, ltfat_heap_type type);
+ * </tt>
+ * \returns Status code
+ */
+PHASERET_API int
+PHASERET_NAME(rtpghi_set_heaptype)(PHASERET_NAME(rtpghi_state)* p,
+                                   ltfat_heap_type type);
+
+/** Set number of threads used by rtpghi_execute
+ *
+ * The channels of a frame are processed in parallel on a pool of worker
+ * threads owned by the plan. The pool is created here and no memory is
+ * allocated by the subsequent calls to rtpghi_execute. The result does
+ * not depend on the number of threads.
+ *
+ * \note This is not thread safe
+ *
+ * \param[in] p         RTPGHI plan
+ * \param[in] nthreads  Number of threads, 0 means number of processors.
+ *                      At most W threads are used.
+ *
+ * #### Versions #
+ * <tt>
+ * phaseret_rtpghi_set_nthreads_d(phaseret_rtpghi_state_d* p, ltfat_int nthreads);
+ *
+ * phaseret_rtpghi_set_nthreads_s(phaseret_rtpghi_state_s* p, ltfat_int nthreads);
+ * </tt>
+ * \returns
+ * Status code           | Description
+ * ----------------------|-----------------------
+ * LTFATERR_SUCCESS      | No error occurred
+ * LTFATERR_NULLPOINTER  | \a p was NULL
+ * LTFATERR_BADARG       | \a nthreads was negative
+ * LTFATERR_INITFAILED   | The threads could not be created
+ * LTFATERR_NOMEM        | Memory allocation failed
+ */
+PHASERET_API int
+PHASERET_NAME(rtpghi_set_nthreads)(PHASERET_NAME(rtpghi_state)* p,
+                                   ltfat_int nthreads);
+
 /** Execute RTPGHI plan for a single frame
  *
  *  The function is intedned to be called for consecutive stream of frames
@@ -245,6 +303,10 @@ PHASERET_API int
 PHASERET_NAME(rtpghiupdate_init)(ltfat_int M, ltfat_int W, double tol,
                                  PHASERET_NAME(rtpghiupdate_plan)** pout);
 
+PHASERET_API int
+PHASERET_NAME(rtpghiupdate_set_heaptype)(PHASERET_NAME(rtpghiupdate_plan)* p,
+                                         ltfat_heap_type type);
+
 PHASERET_API int
 PHASERET_NAME(rtpghiupdate_execute)(PHASERET_NAME(rtpghiupdate_plan)* p,
                                     const LTFAT_REAL slog[],
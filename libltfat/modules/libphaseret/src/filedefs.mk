@@ -1,9 +1,11 @@
-files += gla.c legla.c gsrtisila.c gsrtisilapghi.c pghi.c rtisila.c rtpghi.c spsi.c utils.c
+files += gla.c legla.c legla_simd.c gsrtisila.c gsrtisilapghi.c pghi.c rtisila.c rtpghi.c rtpghi_simd.c spsi.c utils.c
 files_notypechange += pghi_typeconstant.c legla_typeconstant.c
 
 DSLFLAGS = -lltfat
 DLFLAGS = -lltfatd
 SLFLAGS = -lltfatf
 CFLAGS+=-Imodules/libltfat/include
+# The private headers shared with libltfat
+CFLAGS+=-Imodules/libltfat/src
 extradepincludes:=\#include \"ltfat.h\"\n
 
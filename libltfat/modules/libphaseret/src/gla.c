@@ -3,9 +3,17 @@
 #include "ltfat/macros.h"
 /* #include "dgtrealwrapper_private.h" */
 
+/* Coefficients per task of the projection pass */
+#define GLA_BLOCK 4096
+
 struct PHASERET_NAME(gla_plan)
 {
     LTFAT_NAME(dgtreal_plan)* p;
+// Single channel plans, used only with the pool and W > 1
+    LTFAT_NAME(dgtreal_plan)** chanp;
+    ltfat_int W;
+    int* chanstatus;
+    ltfat_threadpool* pool;
     PHASERET_NAME(gla_callback_status)* status_callback;
     void* status_callback_userdata;
     PHASERET_NAME(gla_callback_cmod)* cmod_callback;
@@ -22,8 +30,102 @@ struct PHASERET_NAME(gla_plan)
     int do_fast;
     double alpha;
     LTFAT_COMPLEX* t;
+// Arguments of the running iteration
+    LTFAT_COMPLEX* cout;
+    const LTFAT_COMPLEX* cref;
+    const int* mask;
+    ltfat_int M2N;
 };
 
+/* Synthesis or analysis of channel w (taskid) with its own plan */
+static void
+PHASERET_NAME(gla_syn_task)(void* userdata, ltfat_int w,
+                            ltfat_int UNUSED(workerid))
+{
+    PHASERET_NAME(gla_plan)* p = (PHASERET_NAME(gla_plan)*) userdata;
+    ltfat_int L = LTFAT_NAME(dgtreal_get_L)(p->p);
+    p->chanstatus[w] = LTFAT_NAME(dgtreal_execute_syn_newarray)(
+                           p->chanp[w], p->cout + w * p->M2N, p->f + w * L);
+}
+
+static void
+PHASERET_NAME(gla_ana_task)(void* userdata, ltfat_int w,
+                            ltfat_int UNUSED(workerid))
+{
+    PHASERET_NAME(gla_plan)* p = (PHASERET_NAME(gla_plan)*) userdata;
+    ltfat_int L = LTFAT_NAME(dgtreal_get_L)(p->p);
+    p->chanstatus[w] = LTFAT_NAME(dgtreal_execute_ana_newarray)(
+                           p->chanp[w], p->f + w * L, p->cout + w * p->M2N);
+}
+
+static void
+PHASERET_NAME(gla_synana_task)(void* userdata, ltfat_int w, ltfat_int workerid)
+{
+    PHASERET_NAME(gla_plan)* p = (PHASERET_NAME(gla_plan)*) userdata;
+    PHASERET_NAME(gla_syn_task)(userdata, w, workerid);
+    if (!p->chanstatus[w])
+        PHASERET_NAME(gla_ana_task)(userdata, w, workerid);
+}
+
+/* Magnitude projection, mask and the acceleration step fused in a single
+ * pass over coefficients taskid*GLA_BLOCK ... (taskid+1)*GLA_BLOCK - 1.
+ * The arithmetic is that of force_magnitude followed by fastupdate. */
+static void
+PHASERET_NAME(gla_proj_task)(void* userdata, ltfat_int taskid,
+                             ltfat_int UNUSED(workerid))
+{
+    PHASERET_NAME(gla_plan)* p = (PHASERET_NAME(gla_plan)*) userdata;
+    LTFAT_REAL maglim = (LTFAT_REAL) 1e-10;
+    LTFAT_REAL alpha = (LTFAT_REAL) p->alpha;
+    LTFAT_COMPLEX* c = p->cout;
+    ltfat_int W = LTFAT_NAME(dgtreal_get_W)(p->p);
+    ltfat_int start = taskid * GLA_BLOCK;
+    ltfat_int end = ltfat_imin(start + GLA_BLOCK, p->M2N * W);
+
+    for (ltfat_int ii = start; ii < end; ii++)
+    {
+        if (p->mask && p->mask[ii % p->M2N])
+        {
+            c[ii] = p->cref[ii];
+        }
+        else
+        {
+            LTFAT_REAL olds = ltfat_abs(c[ii]);
+            if (olds < maglim)
+                c[ii] = p->s[ii];
+            else
+                c[ii] = p->s[ii] * c[ii] / olds;
+        }
+
+        if (p->do_fast)
+        {
+            LTFAT_COMPLEX cold = c[ii];
+            c[ii] = c[ii] + alpha * (c[ii] - p->t[ii]);
+            p->t[ii] = cold;
+        }
+    }
+}
+
+static int
+PHASERET_NAME(gla_run)(PHASERET_NAME(gla_plan)* p, ltfat_int ntasks,
+                       ltfat_threadpool_task* task)
+{
+    if (p->pool)
+        return ltfat_threadpool_execute(p->pool, ntasks, task, p);
+
+    for (ltfat_int t = 0; t < ntasks; t++)
+        task(p, t, 0);
+    return LTFATERR_SUCCESS;
+}
+
+static int
+PHASERET_NAME(gla_chanstatus)(PHASERET_NAME(gla_plan)* p, ltfat_int W)
+{
+    for (ltfat_int w = 0; w < W; w++)
+        if (p->chanstatus[w]) return p->chanstatus[w];
+    return LTFATERR_SUCCESS;
+}
+
 PHASERET_API int
 PHASERET_NAME(gla)(const LTFAT_COMPLEX cinit[], const int mask[], const LTFAT_REAL g[],
                    ltfat_int L,
@@ -51,11 +153,14 @@ PHASERET_NAME(gla_init)(const LTFAT_COMPLEX cinit[], const LTFAT_REAL g[],
 {
     int status = LTFATERR_SUCCESS;
     PHASERET_NAME(gla_plan)* p = NULL;
+    ltfat_dgt_params* chparams = NULL;
     ltfat_int N = L / a;
     ltfat_int M2 = M / 2 + 1;
+    ltfat_int nthreads = params ? ltfat_dgt_getpar_nthreads(params) : 1;
 
     CHECK(LTFATERR_BADARG, alpha >= 0.0, "alpha cannot be negative");
     CHECKMEM( p = (PHASERET_NAME(gla_plan)*) ltfat_calloc(1, sizeof * p));
+    p->W = W;
     CHECKMEM( p->s = LTFAT_NAME_REAL(malloc)(M2 * N * W));
     CHECKMEM( p->f = LTFAT_NAME_REAL(malloc)(L * W));
 
@@ -66,14 +171,41 @@ PHASERET_NAME(gla_init)(const LTFAT_COMPLEX cinit[], const LTFAT_REAL g[],
         CHECKMEM( p->t = LTFAT_NAME_COMPLEX(malloc)(M2 * N * W));
     }
 
+    if (nthreads == 0)
+        nthreads = ltfat_threadpool_get_nprocs();
+
+    if (nthreads > 1)
+        CHECKSTATUS( ltfat_threadpool_init(nthreads, &p->pool));
+
+    if (p->pool && W > 1)
+    {
+        // Channels are processed in parallel by single channel plans, which
+        // must not spawn threads of their own
+        CHECKMEM( chparams = ltfat_dgt_params_copy(params));
+        CHECKSTATUS( ltfat_dgt_setpar_nthreads(chparams, 1));
+        CHECKMEM( p->chanp = LTFAT_NEWARRAY(LTFAT_NAME(dgtreal_plan)*, W));
+        CHECKMEM( p->chanstatus = LTFAT_NEWARRAY(int, W));
+
+        for (ltfat_int w = 0; w < W; w++)
+            CHECKSTATUS(
+                LTFAT_NAME(dgtreal_init)(g, gl, L, 1, a, M, p->f + w * L,
+                                         c ? c + w * M2 * N : NULL,
+                                         chparams, &p->chanp[w]));
+
+        params = chparams;
+    }
+
     CHECKSTATUS(
         LTFAT_NAME(dgtreal_init)(g, gl, L, W, a, M, p->f, c, params, &p->p));
 
     p->cinit = cinit; p->c = c;
+    p->M2N = M2 * N;
 
+    if (chparams) ltfat_dgt_params_free(chparams);
     *pout = p;
     return status;
 error:
+    if (chparams) ltfat_dgt_params_free(chparams);
     if (p) PHASERET_NAME(gla_done)(&p);
     return status;
 }
@@ -90,6 +222,17 @@ PHASERET_NAME(gla_done)(PHASERET_NAME(gla_plan)** p)
         CHECKSTATUS(
             LTFAT_NAME(dgtreal_done)(&pp->p));
 
+    if (pp->chanp)
+    {
+        for (ltfat_int w = 0; w < pp->W; w++)
+            if (pp->chanp[w])
+                LTFAT_NAME(dgtreal_done)(&pp->chanp[w]);
+        ltfat_free(pp->chanp);
+    }
+
+    if (pp->pool) ltfat_threadpool_done(&pp->pool);
+
+    ltfat_safefree(pp->chanstatus);
     ltfat_safefree(pp->t);
     ltfat_safefree(pp->s);
     ltfat_safefree(pp->f);
@@ -142,35 +285,53 @@ PHASERET_NAME(gla_execute_newarray)(PHASERET_NAME(gla_plan)* p,
     if (p->do_fast)
         memcpy(p->t, cout, (N * M2 * W) * sizeof * p->t );
 
+    p->cout = cout;
+    p->cref = cinit2 ? cinit2 : cinit;
+    p->mask = mask;
+
     for (ltfat_int ii = 0; ii < iter; ii++)
     {
-        // Perform idgtreal
-        CHECKSTATUS( LTFAT_NAME(dgtreal_execute_syn_newarray)(p->p, cout, p->f));
-
-        // Optional signal modification
-        if (p->fmod_callback)
+        if (p->chanp && !p->fmod_callback)
+        {
+            // Perform idgtreal and dgtreal of each channel in one go
             CHECKSTATUS(
-                p->fmod_callback(p->fmod_callback_userdata, p->f, L, W, a, M));
+                PHASERET_NAME(gla_run)(p, W, PHASERET_NAME(gla_synana_task)));
+            CHECKSTATUS( PHASERET_NAME(gla_chanstatus)(p, W));
+        }
+        else
+        {
+            // Perform idgtreal
+            if (p->chanp)
+            {
+                CHECKSTATUS(
+                    PHASERET_NAME(gla_run)(p, W, PHASERET_NAME(gla_syn_task)));
+                CHECKSTATUS( PHASERET_NAME(gla_chanstatus)(p, W));
+            }
+            else
+                CHECKSTATUS(
+                    LTFAT_NAME(dgtreal_execute_syn_newarray)(p->p, cout, p->f));
 
-        // Perform dgtreal
-        CHECKSTATUS( LTFAT_NAME(dgtreal_execute_ana_newarray)(p->p, p->f, cout));
+            // Optional signal modification
+            if (p->fmod_callback)
+                CHECKSTATUS(
+                    p->fmod_callback(p->fmod_callback_userdata, p->f, L, W, a, M));
 
-        PHASERET_NAME(force_magnitude)(cout, p->s, N * M2 * W, cout);
+            // Perform dgtreal
+            if (p->chanp)
+            {
+                CHECKSTATUS(
+                    PHASERET_NAME(gla_run)(p, W, PHASERET_NAME(gla_ana_task)));
+                CHECKSTATUS( PHASERET_NAME(gla_chanstatus)(p, W));
+            }
+            else
+                CHECKSTATUS(
+                    LTFAT_NAME(dgtreal_execute_ana_newarray)(p->p, p->f, cout));
+        }
 
-        if(mask)
-            for(ltfat_int w = 0;w < W; w++)
-                for(ltfat_int jj = 0; jj < N * M2; jj++)
-                    if(mask[jj])
-                    {
-                        if(cinit2)
-                            cout[jj + w * M2 * N] = cinit2[jj + w * M2 * N];
-                        else
-                            cout[jj + w * M2 * N] = cinit[jj + w * M2 * N];
-                    }
-
-        // The acceleration step
-        if (p->do_fast)
-            PHASERET_NAME(fastupdate)(cout, p->t, p->alpha, N * M2 * W );
+        // Magnitude projection, mask and the acceleration step
+        CHECKSTATUS(
+            PHASERET_NAME(gla_run)(p, ltfat_idivceil(N * M2 * W, GLA_BLOCK),
+                                   PHASERET_NAME(gla_proj_task)));
 
         // Optional coefficient modification
         if (p->cmod_callback)
@@ -10,6 +10,16 @@ PHASERET_NAME(gsrtisilaupdate_init)(const LTFAT_REAL* g, const LTFAT_REAL* gd,
                                     ltfat_int gl, ltfat_int a, ltfat_int M,
                                     ltfat_int gNo, int do_skipinitialization,
                                     PHASERET_NAME(gsrtisilaupdate_plan)** pout)
+{
+    return PHASERET_NAME(gsrtisilaupdate_init_batch)(g, gd, gl, a, M, gNo,
+            do_skipinitialization, 1, pout);
+}
+
+int
+PHASERET_NAME(gsrtisilaupdate_init_batch)(const LTFAT_REAL* g, const LTFAT_REAL* gd,
+        ltfat_int gl, ltfat_int a, ltfat_int M,
+        ltfat_int gNo, int do_skipinitialization, ltfat_int W,
+        PHASERET_NAME(gsrtisilaupdate_plan)** pout)
 {
     int status = LTFATERR_SUCCESS;
     PHASERET_NAME(gsrtisilaupdate_plan)* p = NULL;
@@ -17,11 +27,12 @@ PHASERET_NAME(gsrtisilaupdate_init)(const LTFAT_REAL* g, const LTFAT_REAL* gd,
 
     CHECKMEM( p = (PHASERET_NAME(gsrtisilaupdate_plan)*)
                   ltfat_calloc(1, sizeof * p));
-    p->M = M; p->a = a; p->g = g; p->gl = gl; p->gNo = gNo;
+    p->M = M; p->a = a; p->g = g; p->gl = gl; p->gNo = gNo; p->W = W;
     p->do_skipinitialization = do_skipinitialization;
 
     CHECKSTATUS(
-        PHASERET_NAME(rtisilaupdate_init)(NULL, NULL, NULL, gd, gl, a, M, &p->p2));
+        PHASERET_NAME(rtisilaupdate_init_batch)(NULL, NULL, NULL, gd, gl, a, M, W,
+                &p->p2));
 
     *pout = p;
     return status;
@@ -52,10 +63,8 @@ PHASERET_NAME(gsrtisilaupdate_execute)(PHASERET_NAME(gsrtisilaupdate_plan)* p,
                                        LTFAT_REAL* frames2, LTFAT_COMPLEX* cframes2,
                                        LTFAT_COMPLEX* c)
 {
-    ltfat_int lookback = N - lookahead - 1;
-    ltfat_int M = p->M;
     ltfat_int gl = p->gl;
-    ltfat_int M2 = M / 2 + 1;
+    ltfat_int M2 = p->M / 2 + 1;
 
     // If we are not working inplace ...
     if (frames != frames2)
@@ -64,10 +73,26 @@ PHASERET_NAME(gsrtisilaupdate_execute)(PHASERET_NAME(gsrtisilaupdate_plan)* p,
     if (cframes != cframes2)
         memcpy(cframes2, cframes, M2 * N * sizeof * cframes);
 
+    PHASERET_NAME(gsrtisilaupdate_execute_batch)(p, frames2, 0, cframes2, 0, N,
+            s, 0, lookahead, maxit, c, 0);
+}
+
+void
+PHASERET_NAME(gsrtisilaupdate_execute_batch)(
+    PHASERET_NAME(gsrtisilaupdate_plan)* p, LTFAT_REAL* frames,
+    ltfat_int framesdist, LTFAT_COMPLEX* cframes, ltfat_int cframesdist,
+    ltfat_int N, const LTFAT_REAL* s, ltfat_int sdist, ltfat_int lookahead,
+    ltfat_int maxit, LTFAT_COMPLEX* c, ltfat_int cdist)
+{
+    ltfat_int lookback = N - lookahead - 1;
+    ltfat_int M = p->M;
+    ltfat_int gl = p->gl;
+    ltfat_int M2 = M / 2 + 1;
+
     if (!p->do_skipinitialization)
-        PHASERET_NAME(rtisilaphaseupdatesyn)(p->p2,
-                                             cframes2 + (lookback + lookahead)*M2,
-                                             frames2 + (lookback + lookahead)*gl);
+        PHASERET_NAME(rtisilaphaseupdatesyn_batch)(p->p2,
+                cframes + (lookback + lookahead) * M2, cframesdist,
+                frames + (lookback + lookahead) * gl, framesdist);
 
     for (ltfat_int it = 0; it < maxit; it++)
     {
@@ -76,16 +101,19 @@ PHASERET_NAME(gsrtisilaupdate_execute)(PHASERET_NAME(gsrtisilaupdate_plan)* p,
             ltfat_int indx = lookback + nback;
             ltfat_int nfwd = lookahead - nback;
 
-            PHASERET_NAME(rtisilaoverlaynthframe)(p->p2, frames2,
-                                                  p->g + nfwd * gl, indx, N);
+            PHASERET_NAME(rtisilaoverlaynthframe_batch)(p->p2, frames, framesdist,
+                    p->g + nfwd * gl, indx, N);
 
-            PHASERET_NAME(rtisilaphaseupdate)(p->p2, s + nback * M2,
-                                              frames2 +  indx * gl,
-                                              cframes2 + indx * M2);
+            PHASERET_NAME(rtisilaphaseupdate_batch)(p->p2, s + nback * M2, sdist,
+                                                    frames +  indx * gl, framesdist,
+                                                    cframes + indx * M2, cframesdist);
         }
     }
 
-    if (c) memcpy(c, cframes2 + lookback * M2, M2 * sizeof * c);
+    if (c)
+        for (ltfat_int w = 0; w < p->W; w++)
+            memcpy(c + w * cdist, cframes + w * cframesdist + lookback * M2,
+                   M2 * sizeof * c);
 }
 
 PHASERET_API int
@@ -184,8 +212,8 @@ PHASERET_NAME(gsrtisila_init)(const LTFAT_REAL* g, ltfat_int gl, ltfat_int W,
                   LTFAT_NAME_COMPLEX(calloc)( M2 * (lookback + 1 + maxLookahead) * W));
 
     CHECKSTATUS(
-        PHASERET_NAME(gsrtisilaupdate_init)(gana, gd, gl, a, M, lookahead + 1, 1,
-                                            &p->uplan));
+        PHASERET_NAME(gsrtisilaupdate_init_batch)(gana, gd, gl, a, M, lookahead + 1,
+                1, W, &p->uplan));
 
     p->garbageBinSize = 2;
     CHECKMEM( p->garbageBin =
@@ -235,12 +263,13 @@ PHASERET_NAME(gsrtisila_execute)(PHASERET_NAME(gsrtisila_state)* p,
         PHASERET_NAME(shiftcolsleft)(frameschan, gl, noFrames, NULL);
         PHASERET_NAME_COMPLEX(shiftcolsleft)(cframeschan, M2, noFrames, cchan);
         PHASERET_NAME(shiftcolsleft)(sframeschan, M2, p->lookahead + 1, schan);
-
-        PHASERET_NAME(gsrtisilaupdate_execute)(p->uplan, frameschan, cframeschan,
-                                               noFrames, sframeschan, p->lookahead, p->maxit,
-                                               frameschan, cframeschan, cchan);
     }
 
+    // All channels are updated at once
+    PHASERET_NAME(gsrtisilaupdate_execute_batch)(p->uplan, p->frames, N * gl,
+            p->cframes, N * M2, noFrames, p->s, (1 + p->maxLookahead) * M2,
+            p->lookahead, p->maxit, c, M2);
+
 error:
     return status;
 }
@@ -348,38 +377,201 @@ PHASERET_API int
 PHASERET_NAME(gsrtisilaoffline)(const LTFAT_REAL s[], const LTFAT_REAL g[],
                                 ltfat_int L, ltfat_int gl, ltfat_int W, ltfat_int a, ltfat_int M,
                                 ltfat_int lookahead, ltfat_int maxit, LTFAT_COMPLEX c[])
+{
+    return PHASERET_NAME(gsrtisilaoffline_batched)(s, g, L, gl, W, a, M,
+            lookahead, maxit, 1, c);
+}
+
+/* Lanes and groups as in rtisilaoffline_batched */
+struct PHASERET_NAME(gsrtisilaoffline_data)
+{
+    const LTFAT_REAL* s;
+    LTFAT_COMPLEX* c;
+    ltfat_int N;
+    ltfat_int M2;
+    ltfat_int lookahead;
+    ltfat_int warmup;
+    ltfat_int segNo;
+    ltfat_int lanesNo;
+    ltfat_int groupsNo;
+    PHASERET_NAME(gsrtisila_state)** states;
+    LTFAT_REAL* sbuf;
+    LTFAT_COMPLEX* cbuf;
+    LTFAT_COMPLEX* cwarmup;
+};
+
+static void
+PHASERET_NAME(gsrtisilaoffline_lane)(struct PHASERET_NAME(gsrtisilaoffline_data)* d,
+                                     ltfat_int l, ltfat_int* w, ltfat_int* nstart,
+                                     ltfat_int* n0, ltfat_int* n1)
+{
+    ltfat_int seg = l % d->segNo;
+    *w = l / d->segNo;
+    *n0 = seg * d->N / d->segNo;
+    *n1 = (seg + 1) * d->N / d->segNo;
+    *nstart = seg ? *n0 - d->warmup : 0;
+}
+
+static void
+PHASERET_NAME(gsrtisilaoffline_task)(void* userdata, ltfat_int group,
+                                     ltfat_int UNUSED(workerid))
+{
+    struct PHASERET_NAME(gsrtisilaoffline_data)* d =
+        (struct PHASERET_NAME(gsrtisilaoffline_data)*) userdata;
+    ltfat_int N = d->N, M2 = d->M2;
+    ltfat_int l0 = group * d->lanesNo / d->groupsNo;
+    ltfat_int l1 = (group + 1) * d->lanesNo / d->groupsNo;
+    LTFAT_REAL* sbuf = d->sbuf + l0 * M2;
+    LTFAT_COMPLEX* cbuf = d->cbuf + l0 * M2;
+    ltfat_int w, nstart, n0, n1, stepsNo = 0;
+
+    for (ltfat_int l = l0; l < l1; l++)
+    {
+        PHASERET_NAME(gsrtisilaoffline_lane)(d, l, &w, &nstart, &n0, &n1);
+        stepsNo = ltfat_imax(stepsNo, n1 - nstart);
+    }
+
+    for (ltfat_int t = 0; t < stepsNo; t++)
+    {
+        // Lanes which are already finished get zeros
+        for (ltfat_int l = l0; l < l1; l++)
+        {
+            PHASERET_NAME(gsrtisilaoffline_lane)(d, l, &w, &nstart, &n0, &n1);
+            if (nstart + t < n1)
+                memcpy(sbuf + (l - l0) * M2,
+                       d->s + w * N * M2 + ((nstart + t + d->lookahead) % N) * M2,
+                       M2 * sizeof * sbuf);
+            else
+                memset(sbuf + (l - l0) * M2, 0, M2 * sizeof * sbuf);
+        }
+
+        PHASERET_NAME(gsrtisila_execute)(d->states[group], sbuf, cbuf);
+
+        for (ltfat_int l = l0; l < l1; l++)
+        {
+            PHASERET_NAME(gsrtisilaoffline_lane)(d, l, &w, &nstart, &n0, &n1);
+            if (nstart + t >= n0 && nstart + t < n1)
+                memcpy(d->c + w * N * M2 + (nstart + t) * M2,
+                       cbuf + (l - l0) * M2, M2 * sizeof * cbuf);
+            else if (nstart + t < n0)
+                memcpy(d->cwarmup + (l * d->warmup + t) * M2,
+                       cbuf + (l - l0) * M2, M2 * sizeof * cbuf);
+        }
+    }
+}
+
+/* See rtisilaoffline_alignsigns */
+static void
+PHASERET_NAME(gsrtisilaoffline_alignsigns)(
+    struct PHASERET_NAME(gsrtisilaoffline_data)* d)
+{
+    ltfat_int N = d->N, M2 = d->M2;
+    ltfat_int w, nstart, n0, n1;
+
+    for (ltfat_int l = 0; l < d->lanesNo; l++)
+    {
+        double corr = 0.0;
+        LTFAT_COMPLEX* cw = d->cwarmup + l * d->warmup * M2;
+
+        if (l % d->segNo == 0) continue;
+
+        PHASERET_NAME(gsrtisilaoffline_lane)(d, l, &w, &nstart, &n0, &n1);
+
+        for (ltfat_int ii = 0; ii < d->warmup * M2; ii++)
+        {
+            LTFAT_COMPLEX cleft = d->c[w * N * M2 + nstart * M2 + ii];
+            corr += ltfat_real(cleft) * ltfat_real(cw[ii]) +
+                    ltfat_imag(cleft) * ltfat_imag(cw[ii]);
+        }
+
+        if (corr < 0.0)
+            for (ltfat_int ii = n0 * M2; ii < n1 * M2; ii++)
+                d->c[w * N * M2 + ii] = -d->c[w * N * M2 + ii];
+    }
+}
+
+PHASERET_API int
+PHASERET_NAME(gsrtisilaoffline_batched)(const LTFAT_REAL s[], const LTFAT_REAL g[],
+                                        ltfat_int L, ltfat_int gl, ltfat_int W, ltfat_int a, ltfat_int M,
+                                        ltfat_int lookahead, ltfat_int maxit, ltfat_int nthreads,
+                                        LTFAT_COMPLEX c[])
 {
     int status = LTFATERR_SUCCESS;
-    PHASERET_NAME(gsrtisila_state)* p = NULL;
+    struct PHASERET_NAME(gsrtisilaoffline_data) d;
+    const LTFAT_REAL** sinit = NULL;
+    ltfat_threadpool* pool = NULL;
     ltfat_int N = L / a;
     ltfat_int M2 = M / 2 + 1;
 
+    memset(&d, 0, sizeof d);
     CHECKNULL(s); CHECKNULL(g); CHECKNULL(c);
+    CHECK(LTFATERR_NOTPOSARG, W > 0, "W must be positive (passed %d)", W);
+    CHECK(LTFATERR_NOTPOSARG, a > 0, "a must be positive (passed %d)", a);
+    CHECK(LTFATERR_BADARG, nthreads >= 0,
+          "nthreads must be nonnegative (passed %d)", nthreads);
     // Just limit lookahead to something sensible
     lookahead = lookahead > N ? N : lookahead;
 
-    CHECKSTATUS(PHASERET_NAME(gsrtisila_init)(g, gl, 1, a, M, lookahead, maxit, &p));
+    if (nthreads == 0)
+        nthreads = ltfat_threadpool_get_nprocs();
+
+    d.s = s; d.c = c; d.N = N; d.M2 = M2; d.lookahead = lookahead;
+    // A segment starts with a full buffer of frames of its own
+    d.warmup = (ltfat_int)( ceil(((LTFAT_REAL)gl) / a) ) + lookahead;
+    // Channels are split only when there are less of them than threads
+    d.segNo = nthreads > W ? ltfat_idivceil(nthreads, W) : 1;
+    d.segNo = ltfat_imax(1, ltfat_imin(d.segNo, N / (d.warmup + lookahead)));
+    d.lanesNo = W * d.segNo;
+    d.groupsNo = ltfat_imin(nthreads, d.lanesNo);
+
+    CHECKMEM( d.states = LTFAT_NEWARRAY(PHASERET_NAME(gsrtisila_state)*, d.groupsNo));
+    CHECKMEM( sinit = LTFAT_NEWARRAY(const LTFAT_REAL*, d.lanesNo));
+    CHECKMEM( d.sbuf = LTFAT_NAME_REAL(malloc)(M2 * d.lanesNo));
+    CHECKMEM( d.cbuf = LTFAT_NAME_COMPLEX(malloc)(M2 * d.lanesNo));
+    CHECKMEM( d.cwarmup = LTFAT_NAME_COMPLEX(malloc)(M2 * d.warmup * d.lanesNo));
+
+    for (ltfat_int l = 0; l < d.lanesNo; l++)
+    {
+        ltfat_int w, nstart, n0, n1;
+        PHASERET_NAME(gsrtisilaoffline_lane)(&d, l, &w, &nstart, &n0, &n1);
+        sinit[l] = s + w * N * M2 + nstart * M2;
+    }
 
-    for (ltfat_int w = 0; w < W; w++)
+    // Plans are created serially
+    for (ltfat_int group = 0; group < d.groupsNo; group++)
     {
-        const LTFAT_REAL* schan = s + w * N * M2;
-        PHASERET_NAME(gsrtisila_reset)(p, &schan);
+        ltfat_int l0 = group * d.lanesNo / d.groupsNo;
+        ltfat_int l1 = (group + 1) * d.lanesNo / d.groupsNo;
 
-        for (ltfat_int n = 0, nahead = lookahead; nahead < N; ++n, ++nahead)
-        {
-            const LTFAT_REAL* sncol = schan + nahead * M2;
-            LTFAT_COMPLEX* cncol = c + n * M2 + w * N * M2;
-            PHASERET_NAME(gsrtisila_execute)(p, sncol, cncol);
-        }
+        CHECKSTATUS(
+            PHASERET_NAME(gsrtisila_init)(g, gl, l1 - l0, a, M, lookahead, maxit,
+                                          &d.states[group]));
+        PHASERET_NAME(gsrtisila_reset)(d.states[group], sinit + l0);
+    }
 
-        for (ltfat_int n = N - lookahead, nahead = 0; n < N; ++n, ++nahead)
-        {
-            const LTFAT_REAL* sncol = schan + nahead * M2;
-            LTFAT_COMPLEX* cncol = c + n * M2 + w * N * M2;
-            PHASERET_NAME(gsrtisila_execute)(p, sncol, cncol);
-        }
+    if (d.groupsNo > 1)
+    {
+        CHECKSTATUS( ltfat_threadpool_init(d.groupsNo, &pool));
+        CHECKSTATUS(
+            ltfat_threadpool_execute(pool, d.groupsNo,
+                                     PHASERET_NAME(gsrtisilaoffline_task), &d));
+    }
+    else
+    {
+        PHASERET_NAME(gsrtisilaoffline_task)(&d, 0, 0);
     }
+
+    PHASERET_NAME(gsrtisilaoffline_alignsigns)(&d);
+
 error:
-    if (p) PHASERET_NAME(gsrtisila_done)(&p);
+    if (pool) ltfat_threadpool_done(&pool);
+    if (d.states)
+    {
+        for (ltfat_int group = 0; group < d.groupsNo; group++)
+            if (d.states[group])
+                PHASERET_NAME(gsrtisila_done)(&d.states[group]);
+        ltfat_free(d.states);
+    }
+    LTFAT_SAFEFREEALL(sinit, d.sbuf, d.cbuf, d.cwarmup);
     return status;
 }
@@ -11,6 +11,7 @@ struct PHASERET_NAME(gsrtisilaupdate_plan)
     ltfat_int M;
     ltfat_int a;
     ltfat_int gNo;
+    ltfat_int W;
     int do_skipinitialization;
 };
 
@@ -29,5 +30,19 @@ struct PHASERET_NAME(gsrtisila_state)
     ltfat_int garbageBinSize;
 };
 
+int
+PHASERET_NAME(gsrtisilaupdate_init_batch)(const LTFAT_REAL* g, const LTFAT_REAL* gd,
+        ltfat_int gl, ltfat_int a, ltfat_int M,
+        ltfat_int gNo, int do_skipinitialization, ltfat_int W,
+        PHASERET_NAME(gsrtisilaupdate_plan)** p);
+
+/* In-place gsrtisilaupdate_execute of all W channels, see
+ * rtisilaupdate_execute_batch */
+void
+PHASERET_NAME(gsrtisilaupdate_execute_batch)(
+    PHASERET_NAME(gsrtisilaupdate_plan)* p, LTFAT_REAL* frames,
+    ltfat_int framesdist, LTFAT_COMPLEX* cframes, ltfat_int cframesdist,
+    ltfat_int N, const LTFAT_REAL* s, ltfat_int sdist, ltfat_int lookahead,
+    ltfat_int maxit, LTFAT_COMPLEX* c, ltfat_int cdist);
 
 #endif
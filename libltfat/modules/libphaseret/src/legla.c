@@ -24,15 +24,23 @@ struct PHASERET_NAME(legla_plan)
     int ptype;
 };
 
+/* Columns per task of the first pass of leglaupdate_execute */
+#define LEGLA_COLBLOCK 16
+
 struct PHASERET_NAME(leglaupdate_plan)
 {
     ltfat_int kNo;
     LTFAT_COMPLEX** k;
-    LTFAT_COMPLEX* buf;
+    LTFAT_COMPLEX* buf; // One buffer per channel
     ltfat_int a;
     ltfat_int N;
     ltfat_int W;
     PHASERET_NAME(leglaupdate_plan_col)* plan_col;
+    ltfat_threadpool* pool;
+// Arrays of the ongoing leglaupdate_execute
+    const LTFAT_REAL* s;
+    const LTFAT_COMPLEX* c;
+    LTFAT_COMPLEX* cout;
 };
 
 struct PHASERET_NAME(leglaupdate_plan_col)
@@ -125,7 +133,7 @@ PHASERET_NAME(legla_init)(const LTFAT_COMPLEX cinit[], const LTFAT_REAL g[],
     ltfat_dgt_setpar_phaseconv(pLoc.dparams, LTFAT_FREQINV);
     /* pLoc.dparams->ptype = LTFAT_FREQINV; */
     CHECKMEM( p->s = LTFAT_NAME_REAL(malloc)(M2 * N * W));
-    CHECKMEM( p->f = LTFAT_NAME_REAL(malloc)(L));
+    CHECKMEM( p->f = LTFAT_NAME_REAL(malloc)(L * W));
 
     CHECKSTATUS(
         LTFAT_NAME(dgtreal_init)(g, gl, L, W, a, M, p->f, c, pLoc.dparams, &p->dgtplan));
@@ -151,6 +159,10 @@ PHASERET_NAME(legla_init)(const LTFAT_COMPLEX cinit[], const LTFAT_REAL g[],
         PHASERET_NAME(leglaupdate_init)( kernsmall, ksize, L, W, a, M, pLoc.leglaflags,
                                          &p->updateplan));
 
+    CHECKSTATUS(
+        PHASERET_NAME(leglaupdate_set_nthreads)(p->updateplan,
+                ltfat_dgt_getpar_nthreads(pLoc.dparams)));
+
     if (alpha > 0.0)
     {
         p->do_fast = 1;
@@ -412,8 +424,8 @@ PHASERET_NAME(leglaupdate_init)(const LTFAT_COMPLEX kern[], phaseret_size ksize,
     CHECKMEM( p->k = (LTFAT_COMPLEX**) ltfat_malloc( p->kNo * sizeof * p->k));
 
     CHECKMEM( p->buf =
-                  LTFAT_NAME_COMPLEX(malloc)( ((M2 + ksize.height - 1) * (p->N + ksize.width -
-                          1))));
+                  LTFAT_NAME_COMPLEX(malloc)( W * (M2 + ksize.height - 1) * (p->N + ksize.width -
+                          1)));
 
     kernh2 = ksize.height / 2 + 1;
 
@@ -459,6 +471,7 @@ PHASERET_NAME(leglaupdate_done)(PHASERET_NAME(leglaupdate_plan)** plan)
     ltfat_safefree(pp->buf);
 
     if (pp->plan_col) PHASERET_NAME(leglaupdate_col_done)(&pp->plan_col);
+    if (pp->pool) ltfat_threadpool_done(&pp->pool);
     ltfat_free(pp);
     pp = NULL;
 }
@@ -491,59 +504,197 @@ PHASERET_NAME(kernphasefi)(const LTFAT_COMPLEX kern[], phaseret_size ksize,
     }
 }
 
-PHASERET_API void
-PHASERET_NAME(leglaupdate_execute)(PHASERET_NAME(leglaupdate_plan)* plan,
-                                   const LTFAT_REAL s[],
-                                   LTFAT_COMPLEX c[], LTFAT_COMPLEX cout[])
+PHASERET_API int
+PHASERET_NAME(leglaupdate_set_nthreads)(PHASERET_NAME(leglaupdate_plan)* plan,
+                                        ltfat_int nthreads)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(plan);
+    CHECK(LTFATERR_BADARG, nthreads >= 0,
+          "nthreads must be nonnegative (passed %d)", nthreads);
+
+    if (plan->pool) ltfat_threadpool_done(&plan->pool);
+
+    if (nthreads == 0) nthreads = ltfat_threadpool_get_nprocs();
+    if (nthreads == 1) return status;
+
+    CHECKSTATUS( ltfat_threadpool_init(nthreads, &plan->pool));
+error:
+    return status;
+}
+
+static void
+PHASERET_NAME(leglaupdate_run)(PHASERET_NAME(leglaupdate_plan)* plan,
+                               ltfat_int ntasks, ltfat_threadpool_task* task)
 {
+    if (plan->pool &&
+        ltfat_threadpool_execute(plan->pool, ntasks, task, plan) == LTFATERR_SUCCESS)
+        return;
+
+    for (ltfat_int t = 0; t < ntasks; t++)
+        task(plan, t, 0);
+}
+
+/* Copies the channel taskid to its buffer and extends the borders */
+static void
+PHASERET_NAME(leglaupdate_ext_task)(void* userdata, ltfat_int taskid,
+                                    ltfat_int UNUSED(workerid))
+{
+    PHASERET_NAME(leglaupdate_plan)* plan =
+        (PHASERET_NAME(leglaupdate_plan)*) userdata;
     PHASERET_NAME(leglaupdate_plan_col)* p = plan->plan_col;
     ltfat_int M2 = p->M / 2 + 1;
     ltfat_int N = plan->N;
-    ltfat_int W = plan->W;
-    //ltfat_int kernh2 = p->ksize2.height;
-    //ltfat_int kernw = p->ksize.width;
-    ltfat_int M2buf = M2 + p->ksize.height - 1;
-    int do_onthefly = p->flags & MOD_COEFFICIENTWISE;
-    int do_framewise = p->flags & MOD_FRAMEWISE;
-    //int do_revorder = p->flags & ORDER_REV;
-
-    LTFAT_COMPLEX** k = plan->k;
-    LTFAT_COMPLEX* buf = plan->buf;
+    ltfat_int bufl = (M2 + p->ksize.height - 1) * (N + p->ksize.width - 1);
 
-    ltfat_int nfirst;
+    PHASERET_NAME(extendborders)(p, plan->c + taskid * M2 * N, N,
+                                 plan->buf + taskid * bufl);
+}
 
-    for (ltfat_int w = 0; w < W; w++)
+/* First pass of leglaupdate_execute over a block of columns of a channel.
+ *
+ * The kernel columns right of the middle one act on coefficients which
+ * have not been updated in this iteration with any of the modification
+ * schemes, so the columns are independent and the pass can run in
+ * parallel. With MOD_STEPWISE, the rest of the kernel is applied as well.
+ */
+static void
+PHASERET_NAME(leglaupdate_right_task)(void* userdata, ltfat_int taskid,
+                                      ltfat_int UNUSED(workerid))
+{
+    PHASERET_NAME(leglaupdate_plan)* plan =
+        (PHASERET_NAME(leglaupdate_plan)*) userdata;
+    PHASERET_NAME(leglaupdate_plan_col)* p = plan->plan_col;
+    ltfat_int M2 = p->M / 2 + 1;
+    ltfat_int N = plan->N;
+    ltfat_int kernh = p->ksize.height;
+    ltfat_int kernw = p->ksize.width;
+    ltfat_int kernh2 = p->ksize2.height;
+    ltfat_int kernwMidId = p->ksize2.width - 1;
+    ltfat_int M2buf = M2 + kernh - 1;
+    ltfat_int bufl = M2buf * (N + kernw - 1);
+    ltfat_int blocksNo = (N + LEGLA_COLBLOCK - 1) / LEGLA_COLBLOCK;
+    ltfat_int w = taskid / blocksNo;
+    ltfat_int nstart = (taskid % blocksNo) * LEGLA_COLBLOCK;
+    ltfat_int nend = ltfat_imin(nstart + LEGLA_COLBLOCK, N);
+    int do_stepwise = !(p->flags & (MOD_COEFFICIENTWISE | MOD_FRAMEWISE));
+
+    for (ltfat_int n = nstart; n < nend; n++)
     {
-        const LTFAT_REAL* sChan =  s + w * M2 * N;
-        LTFAT_COMPLEX* cChan = c + w * M2 * N;
-        LTFAT_COMPLEX* coutChan = cout + w * M2 * N;
+        const LTFAT_COMPLEX* actK = plan->k[n % plan->kNo];
+        const LTFAT_COMPLEX* cColFirst = plan->buf + w * bufl + n * M2buf;
+        LTFAT_COMPLEX* coutCol = plan->cout + w * M2 * N + n * M2;
 
-        PHASERET_NAME(extendborders)(plan->plan_col, cChan, N, buf);
+        memset(coutCol, 0, M2 * sizeof * coutCol);
 
-        /* Outside loop over columns */
-        for (nfirst = 0; nfirst < N; nfirst++)
+        PHASERET_NAME(leglaupdate_accum)(
+            actK + (kernwMidId + 1) * kernh2, kernh,
+            cColFirst + (kernwMidId + 1) * M2buf, M2buf,
+            kernw - kernwMidId - 1, M2, coutCol);
+
+        if (do_stepwise)
         {
-            /* Pick the right kernel */
-            LTFAT_COMPLEX* actK = k[nfirst % plan->kNo];
-            /* Go to the n-th col in output*/
-            LTFAT_COMPLEX* cColFirst = buf + nfirst * M2buf;
-            LTFAT_COMPLEX* coutCol = coutChan + nfirst * M2;
+            const LTFAT_REAL* sCol = plan->s + w * M2 * N + n * M2;
 
-            const LTFAT_REAL* sCol = sChan + nfirst * M2;
+            PHASERET_NAME(leglaupdate_accum)(actK, kernh, cColFirst, M2buf,
+                                             kernwMidId, M2, coutCol);
+            PHASERET_NAME(leglaupdate_accum)(
+                actK + kernwMidId * kernh2, kernh,
+                cColFirst + kernwMidId * M2buf, M2buf, 1, M2, coutCol);
 
-            PHASERET_NAME(leglaupdate_col_execute)(plan->plan_col, sCol,
-                                                   actK, cColFirst, coutCol);
+            /* Update the phase only after the projection has been done. */
+            for (ltfat_int m = 0; m < M2; m++)
+                coutCol[m] = sCol[m] * exp(I * ltfat_arg(coutCol[m]));
         }
+    }
+}
 
-        if (!do_onthefly && !do_framewise)
+/* Second pass of leglaupdate_execute over all columns of channel taskid.
+ *
+ * The kernel columns left of the middle one and the middle one itself act
+ * on coefficients updated earlier in this pass, so the columns must be
+ * processed in order.
+ */
+static void
+PHASERET_NAME(leglaupdate_left_task)(void* userdata, ltfat_int taskid,
+                                     ltfat_int UNUSED(workerid))
+{
+    PHASERET_NAME(leglaupdate_plan)* plan =
+        (PHASERET_NAME(leglaupdate_plan)*) userdata;
+    PHASERET_NAME(leglaupdate_plan_col)* p = plan->plan_col;
+    ltfat_int M2 = p->M / 2 + 1;
+    ltfat_int N = plan->N;
+    ltfat_int kernh = p->ksize.height;
+    ltfat_int kernw = p->ksize.width;
+    ltfat_int kernh2 = p->ksize2.height;
+    ltfat_int kernwMidId = p->ksize2.width - 1;
+    ltfat_int M2buf = M2 + kernh - 1;
+    ltfat_int bufl = M2buf * (N + kernw - 1);
+    int do_onthefly = p->flags & MOD_COEFFICIENTWISE;
+
+    for (ltfat_int n = 0; n < N; n++)
+    {
+        const LTFAT_COMPLEX* actK = plan->k[n % plan->kNo];
+        const LTFAT_COMPLEX* actKMid = actK + kernwMidId * kernh2;
+        LTFAT_COMPLEX* cColFirst = plan->buf + taskid * bufl + n * M2buf;
+        LTFAT_COMPLEX* cColMid = cColFirst + kernwMidId * M2buf;
+        LTFAT_COMPLEX* coutCol = plan->cout + taskid * M2 * N + n * M2;
+        const LTFAT_REAL* sCol = plan->s + taskid * M2 * N + n * M2;
+
+        PHASERET_NAME(leglaupdate_accum)(actK, kernh, cColFirst, M2buf,
+                                         kernwMidId, M2, coutCol);
+
+        if (do_onthefly)
         {
-            /* Update the phase only after the projection has been done. */
-            for (ltfat_int n = 0; n < N * M2; n++)
-                coutChan[n] = sChan[n] * exp(I * ltfat_arg(coutChan[n]));
+            /* Update the phase of a coefficient immediatelly */
+            for (ltfat_int m = 0; m < M2; m++)
+            {
+                PHASERET_NAME(leglaupdate_accum)(actKMid, kernh, cColMid + m,
+                                                 M2buf, 1, 1, coutCol + m);
+                coutCol[m] = sCol[m] * exp(I * ltfat_arg(coutCol[m]));
+                cColMid[kernh2 - 1 + m] = coutCol[m];
+            }
+        }
+        else
+        {
+            /* Update the phase of a single column */
+            PHASERET_NAME(leglaupdate_accum)(actKMid, kernh, cColMid, M2buf,
+                                             1, M2, coutCol);
+            for (ltfat_int m = 0; m < M2; m++)
+            {
+                coutCol[m] = sCol[m] * exp(I * ltfat_arg(coutCol[m]));
+                cColMid[kernh2 - 1 + m] = coutCol[m];
+            }
         }
     }
 }
 
+PHASERET_API void
+PHASERET_NAME(leglaupdate_execute)(PHASERET_NAME(leglaupdate_plan)* plan,
+                                   const LTFAT_REAL s[],
+                                   LTFAT_COMPLEX c[], LTFAT_COMPLEX cout[])
+{
+    PHASERET_NAME(leglaupdate_plan_col)* p = plan->plan_col;
+    ltfat_int N = plan->N;
+    ltfat_int W = plan->W;
+    ltfat_int blocksNo = (N + LEGLA_COLBLOCK - 1) / LEGLA_COLBLOCK;
+    int do_stepwise = !(p->flags & (MOD_COEFFICIENTWISE | MOD_FRAMEWISE));
+
+    plan->s = s; plan->c = c; plan->cout = cout;
+
+    /* The borders are extended before the kernel is applied, so that the
+     * inner loops do not have to deal with them */
+    PHASERET_NAME(leglaupdate_run)(plan, W,
+                                   &PHASERET_NAME(leglaupdate_ext_task));
+
+    PHASERET_NAME(leglaupdate_run)(plan, W * blocksNo,
+                                   &PHASERET_NAME(leglaupdate_right_task));
+
+    if (!do_stepwise)
+        PHASERET_NAME(leglaupdate_run)(plan, W,
+                                       &PHASERET_NAME(leglaupdate_left_task));
+}
+
 PHASERET_API void
 PHASERET_NAME(leglaupdate_col_execute)(
     PHASERET_NAME( leglaupdate_plan_col)* plan,
@@ -16,6 +16,23 @@ struct phaseret_legla_params
 
 
 
+/* acc[r] += sum over kcols kernel columns of the LEGLA kernel applied at
+ * row r, r = 0,...,rows-1
+ *
+ * k points to the first kernel column (kernh/2+1 elements per column) and
+ * c to the buffer column belonging to it, shifted to the first row.
+ * Consecutive buffer columns are cdist elements apart. For every row, the
+ * columns are processed in order and, within a column, the conjugate
+ * symmetric pairs of rows go first and the middle row last. The
+ * instruction set is chosen according to ltfat_simd_get_level(); all of
+ * them give bit-identical results.
+ */
+void
+PHASERET_NAME(leglaupdate_accum)(const LTFAT_COMPLEX* k, ltfat_int kernh,
+                                 const LTFAT_COMPLEX* c, ltfat_int cdist,
+                                 ltfat_int kcols, ltfat_int rows,
+                                 LTFAT_COMPLEX* acc);
+
 #ifdef __cplusplus
 }
 #endif
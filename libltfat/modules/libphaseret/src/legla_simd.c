@@ -0,0 +1,212 @@
+#include "phaseret/legla.h"
+#include "legla_private.h"
+#include "phaseret_simd_private.h"
+#include "ltfat/macros.h"
+
+/* Reference implementation of leglaupdate_accum. The complex arrays are
+ * accessed as interleaved real and imaginary parts, in the same way as in
+ * the vectorized kernels. */
+static void
+PHASERET_NAME(leglaupdate_accum_plain)(const LTFAT_COMPLEX* k, ltfat_int kernh,
+                                       const LTFAT_COMPLEX* c, ltfat_int cdist,
+                                       ltfat_int kcols, ltfat_int rows,
+                                       LTFAT_COMPLEX* acc)
+{
+    ltfat_int kernh2 = kernh / 2 + 1;
+    const LTFAT_REAL* kr = (const LTFAT_REAL*) k;
+    const LTFAT_REAL* cr = (const LTFAT_REAL*) c;
+    LTFAT_REAL* accr = (LTFAT_REAL*) acc;
+
+    for (ltfat_int r = 0; r < rows; r++)
+    {
+        LTFAT_REAL re = accr[2 * r], im = accr[2 * r + 1];
+
+        for (ltfat_int kn = 0; kn < kcols; kn++)
+        {
+            const LTFAT_REAL* kCol = kr + 2 * kn * kernh2;
+            const LTFAT_REAL* cCol = cr + 2 * (kn * cdist + r);
+
+            for (ltfat_int km = 0; km < kernh2 - 1; km++)
+            {
+                LTFAT_REAL ar = kCol[2 * (kernh2 - 1 - km)];
+                LTFAT_REAL ai = kCol[2 * (kernh2 - 1 - km) + 1];
+                const LTFAT_REAL* u = cCol + 2 * km;
+                const LTFAT_REAL* d = cCol + 2 * (kernh - 1 - km);
+                re += ar * (u[0] + d[0]) - ai * (u[1] - d[1]);
+                im += ar * (u[1] + d[1]) + ai * (u[0] - d[0]);
+            }
+
+            /* The middle row */
+            const LTFAT_REAL* x = cCol + 2 * (kernh2 - 1);
+            re += kCol[0] * x[0] - kCol[1] * x[1];
+            im += kCol[0] * x[1] + kCol[1] * x[0];
+        }
+
+        accr[2 * r] = re; accr[2 * r + 1] = im;
+    }
+}
+
+#ifdef PHASERET_SIMD_X86
+#ifdef LTFAT_SINGLE
+/* Swap the real and the imaginary parts */
+#define PHASERET_SWAP128(x)  _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1))
+#define PHASERET_SWAP256(x)  _mm256_permute_ps(x, 0xB1)
+#define PHASERET_SWAP512(x)  _mm512_permute_ps(x, 0xB1)
+#else
+#define PHASERET_SWAP128(x)  _mm_shuffle_pd(x, x, 1)
+#define PHASERET_SWAP256(x)  _mm256_permute_pd(x, 0x5)
+#define PHASERET_SWAP512(x)  _mm512_permute_pd(x, 0x55)
+#endif
+
+/* Number of complex elements in one register */
+#define PHASERET_CL128  ((ltfat_int)(16 / sizeof (LTFAT_COMPLEX)))
+#define PHASERET_CL256  ((ltfat_int)(32 / sizeof (LTFAT_COMPLEX)))
+#define PHASERET_CL512  ((ltfat_int)(64 / sizeof (LTFAT_COMPLEX)))
+
+/* -1 on the real and 1 on the imaginary parts */
+static const LTFAT_REAL PHASERET_NAME(leglasign)[16] =
+{ -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1, -1, 1 };
+
+/* acc + (ka * s + kb * swap(d)), where ka holds the real part of the
+ * kernel element and kb the imaginary part with the sign of the real
+ * lanes flipped. The negation is exact, so this equals the expressions of
+ * the plain loop. */
+#define PHASERET_LEGLA_STEP(MM, acc, ka, kb, s, ds) \
+    MM(add)(acc, MM(add)(MM(mul)(ka, s), MM(mul)(kb, ds)))
+
+/* One kernel column applied to n registers of rows, n = 1 or 2. The
+ * macro expects kCol, cCol, kernh, kernh2, sgn and the accumulators a0, a1
+ * in scope. */
+#define PHASERET_LEGLA_COL(MM, MT, SWAP, CL, n)                              \
+    do {                                                                     \
+        for (ltfat_int km = 0; km < kernh2 - 1; km++)                        \
+        {                                                                    \
+            const LTFAT_REAL* kel = kCol + 2 * (kernh2 - 1 - km);            \
+            MT ka = MM(set1)(kel[0]);                                        \
+            MT kb = MM(mul)(MM(set1)(kel[1]), sgn);                          \
+            const LTFAT_REAL* u = cCol + 2 * km;                             \
+            const LTFAT_REAL* d = cCol + 2 * (kernh - 1 - km);               \
+            MT u0 = MM(loadu)(u), d0 = MM(loadu)(d);                         \
+            a0 = PHASERET_LEGLA_STEP(MM, a0, ka, kb, MM(add)(u0, d0),        \
+                                     SWAP(MM(sub)(u0, d0)));                 \
+            if (n > 1)                                                       \
+            {                                                                \
+                MT u1 = MM(loadu)(u + 2 * CL), d1 = MM(loadu)(d + 2 * CL);   \
+                a1 = PHASERET_LEGLA_STEP(MM, a1, ka, kb, MM(add)(u1, d1),    \
+                                         SWAP(MM(sub)(u1, d1)));             \
+            }                                                                \
+        }                                                                    \
+        MT ka = MM(set1)(kCol[0]);                                           \
+        MT kb = MM(mul)(MM(set1)(kCol[1]), sgn);                             \
+        const LTFAT_REAL* x = cCol + 2 * (kernh2 - 1);                       \
+        MT x0 = MM(loadu)(x);                                                \
+        a0 = PHASERET_LEGLA_STEP(MM, a0, ka, kb, x0, SWAP(x0));              \
+        if (n > 1)                                                           \
+        {                                                                    \
+            MT x1 = MM(loadu)(x + 2 * CL);                                   \
+            a1 = PHASERET_LEGLA_STEP(MM, a1, ka, kb, x1, SWAP(x1));          \
+        }                                                                    \
+    } while (0)
+
+/* The body of the kernels. Two registers of rows are processed at once
+ * so that the two accumulation chains overlap. The remaining rows, from r
+ * on, are left to the plain loop. */
+#define PHASERET_LEGLA_ACCUM(MM, MT, SWAP, CL)                               \
+    ltfat_int kernh2 = kernh / 2 + 1;                                        \
+    const LTFAT_REAL* kr = (const LTFAT_REAL*) k;                            \
+    const LTFAT_REAL* cr = (const LTFAT_REAL*) c;                            \
+    LTFAT_REAL* accr = (LTFAT_REAL*) acc;                                    \
+    MT sgn = MM(loadu)(PHASERET_NAME(leglasign));                            \
+    ltfat_int r = 0;                                                         \
+    for (; r + 2 * CL <= rows; r += 2 * CL)                                  \
+    {                                                                        \
+        MT a0 = MM(loadu)(accr + 2 * r);                                     \
+        MT a1 = MM(loadu)(accr + 2 * (r + CL));                              \
+        for (ltfat_int kn = 0; kn < kcols; kn++)                             \
+        {                                                                    \
+            const LTFAT_REAL* kCol = kr + 2 * kn * kernh2;                   \
+            const LTFAT_REAL* cCol = cr + 2 * (kn * cdist + r);              \
+            PHASERET_LEGLA_COL(MM, MT, SWAP, CL, 2);                         \
+        }                                                                    \
+        MM(storeu)(accr + 2 * r, a0);                                        \
+        MM(storeu)(accr + 2 * (r + CL), a1);                                 \
+    }                                                                        \
+    for (; r + CL <= rows; r += CL)                                          \
+    {                                                                        \
+        MT a0 = MM(loadu)(accr + 2 * r), a1 = a0;                            \
+        for (ltfat_int kn = 0; kn < kcols; kn++)                             \
+        {                                                                    \
+            const LTFAT_REAL* kCol = kr + 2 * kn * kernh2;                   \
+            const LTFAT_REAL* cCol = cr + 2 * (kn * cdist + r);              \
+            PHASERET_LEGLA_COL(MM, MT, SWAP, CL, 1);                         \
+        }                                                                    \
+        (void) a1;                                                           \
+        MM(storeu)(accr + 2 * r, a0);                                        \
+    }
+
+__attribute__((target("sse2"))) static void
+PHASERET_NAME(leglaupdate_accum_sse2)(const LTFAT_COMPLEX* k, ltfat_int kernh,
+                                      const LTFAT_COMPLEX* c, ltfat_int cdist,
+                                      ltfat_int kcols, ltfat_int rows,
+                                      LTFAT_COMPLEX* acc)
+{
+    PHASERET_LEGLA_ACCUM(PHASERET_MM128, PHASERET_M128, PHASERET_SWAP128,
+                         PHASERET_CL128);
+    PHASERET_NAME(leglaupdate_accum_plain)(k, kernh, c + r, cdist, kcols,
+                                           rows - r, acc + r);
+}
+
+__attribute__((target("avx2"))) static void
+PHASERET_NAME(leglaupdate_accum_avx2)(const LTFAT_COMPLEX* k, ltfat_int kernh,
+                                      const LTFAT_COMPLEX* c, ltfat_int cdist,
+                                      ltfat_int kcols, ltfat_int rows,
+                                      LTFAT_COMPLEX* acc)
+{
+    PHASERET_LEGLA_ACCUM(PHASERET_MM256, PHASERET_M256, PHASERET_SWAP256,
+                         PHASERET_CL256);
+    /* GCC does not clear the upper halves of the registers before the tail
+     * call, the following SSE code would then be slowed down by the state
+     * transitions */
+    _mm256_zeroupper();
+    PHASERET_NAME(leglaupdate_accum_plain)(k, kernh, c + r, cdist, kcols,
+                                           rows - r, acc + r);
+}
+
+__attribute__((target("avx512f"))) static void
+PHASERET_NAME(leglaupdate_accum_avx512)(const LTFAT_COMPLEX* k, ltfat_int kernh,
+                                        const LTFAT_COMPLEX* c, ltfat_int cdist,
+                                        ltfat_int kcols, ltfat_int rows,
+                                        LTFAT_COMPLEX* acc)
+{
+    PHASERET_LEGLA_ACCUM(PHASERET_MM512, PHASERET_M512, PHASERET_SWAP512,
+                         PHASERET_CL512);
+    _mm256_zeroupper();
+    PHASERET_NAME(leglaupdate_accum_plain)(k, kernh, c + r, cdist, kcols,
+                                           rows - r, acc + r);
+}
+
+#undef PHASERET_LEGLA_ACCUM
+#undef PHASERET_LEGLA_COL
+#undef PHASERET_LEGLA_STEP
+#undef PHASERET_SWAP128
+#undef PHASERET_SWAP256
+#undef PHASERET_SWAP512
+#undef PHASERET_CL128
+#undef PHASERET_CL256
+#undef PHASERET_CL512
+#endif /* PHASERET_SIMD_X86 */
+
+void
+PHASERET_NAME(leglaupdate_accum)(const LTFAT_COMPLEX* k, ltfat_int kernh,
+                                 const LTFAT_COMPLEX* c, ltfat_int cdist,
+                                 ltfat_int kcols, ltfat_int rows,
+                                 LTFAT_COMPLEX* acc)
+{
+    /* Single rows of the coefficient-wise update are left to the plain
+     * loop, which avoids the dispatch overhead */
+    PHASERET_SIMD_DISPATCH(rows > 1 ? ltfat_simd_get_level() : LTFAT_SIMD_NONE,
+                           leglaupdate_accum,
+                           (k, kernh, c, cdist, kcols, rows, acc));
+
+    PHASERET_NAME(leglaupdate_accum_plain)(k, kernh, c, cdist, kcols, rows, acc);
+}
@@ -63,11 +63,25 @@ PHASERET_API int
 PHASERET_NAME(pghi_init)(ltfat_int L, ltfat_int W,
                          ltfat_int a, ltfat_int M, double tol1, double tol2,
                          double gamma, PHASERET_NAME(pghi_plan)** pout)
+{
+    return PHASERET_NAME(pghi_init_withheaptype)(L, W, a, M, tol1, tol2, gamma,
+            LTFAT_HEAP_BINARY, pout);
+}
+
+PHASERET_API int
+PHASERET_NAME(pghi_init_withheaptype)(ltfat_int L, ltfat_int W,
+                                      ltfat_int a, ltfat_int M,
+                                      double tol1, double tol2, double gamma,
+                                      ltfat_heap_type heaptype,
+                                      PHASERET_NAME(pghi_plan)** pout)
 {
     PHASERET_NAME(pghi_plan)* p = NULL;
     ltfat_int M2, N;
     int status = LTFATERR_SUCCESS;
     CHECKNULL(pout);
+    CHECK(LTFATERR_BADARG,
+          heaptype == LTFAT_HEAP_BINARY || heaptype == LTFAT_HEAP_BUCKET,
+          "Unknown heap type (passed %d)", (int) heaptype);
     CHECK(LTFATERR_BADARG, !isnan(gamma) && gamma > 0,
           "gamma cannot be nan and must be positive. (Passed %f).", gamma);
     CHECK(LTFATERR_NOTPOSARG, L > 0, "L must be positive");
@@ -93,7 +107,8 @@ PHASERET_NAME(pghi_init)(ltfat_int L, ltfat_int W,
     CHECKMEM( p->fgrad = LTFAT_NAME_REAL(malloc)(M2 * N));
     /* CHECKMEM( p->scratch = malloc(M2 * N * sizeof * p->scratch)); */
     // Not yet
-    p->hit = LTFAT_NAME(heapinttask_init)( M2, N, (ltfat_int)( M2 * log((double)M2)) , NULL, 1);
+    CHECKMEM( p->hit = LTFAT_NAME(heapinttask_init)( M2, N,
+                       (ltfat_int)( M2 * log((double)M2)) , NULL, 1, heaptype));
 
     *pout = p;
     return status;
@@ -118,8 +133,9 @@ PHASERET_NAME(pghi_execute)(PHASERET_NAME(pghi_plan)* p, const LTFAT_REAL s[],
     {
         const LTFAT_REAL* schan = s + w * M2 * N;
         LTFAT_COMPLEX* cchan = c + w * M2 * N;
-        const LTFAT_REAL* tgradwchan = p->tgrad + w * M2 * N;
-        const LTFAT_REAL* fgradwchan = p->fgrad + w * M2 * N;
+        // The gradients are computed for one channel at a time
+        const LTFAT_REAL* tgradwchan = p->tgrad;
+        const LTFAT_REAL* fgradwchan = p->fgrad;
         LTFAT_REAL* scratch = ((LTFAT_REAL*)cchan) + M2 *
                               N; // Second half of the output
 
@@ -192,8 +208,9 @@ PHASERET_NAME(pghi_execute_withmask)(PHASERET_NAME(pghi_plan)* p,
         const LTFAT_COMPLEX* cinchan = cin + w * M2 * N;
         LTFAT_COMPLEX* coutchan = cout + w * M2 * N;
         const int* maskchan = mask + w * M2 * N;
-        const LTFAT_REAL* tgradwchan = p->tgrad + w * M2 * N;
-        const LTFAT_REAL* fgradwchan = p->fgrad + w * M2 * N;
+        // The gradients are computed for one channel at a time
+        const LTFAT_REAL* tgradwchan = p->tgrad;
+        const LTFAT_REAL* fgradwchan = p->fgrad;
         LTFAT_REAL* scratch = ((LTFAT_REAL*)coutchan) + M2 *
                               N; // Second half of the output
 
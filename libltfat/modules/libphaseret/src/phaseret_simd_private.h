@@ -0,0 +1,61 @@
+#ifndef _PHASERET_SIMD_PRIVATE_H
+#define _PHASERET_SIMD_PRIVATE_H
+
+/* Common part of the files with the vectorized kernels. The kernels are
+ * compiled with per-function target attributes so that the library itself
+ * does not have to be built with -mavx2 etc. */
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__)) && !defined(LTFAT_NOSIMD)
+#define PHASERET_SIMD_X86
+#endif
+
+/* GCC would otherwise fuse the multiplications and the additions into FMA
+ * in some of the targets, which would change the results between the
+ * instruction sets */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("fp-contract=off")
+#endif
+
+#ifdef PHASERET_SIMD_X86
+#include <immintrin.h>
+
+#ifdef LTFAT_SINGLE
+#define PHASERET_MM128(op)     _mm_##op##_ps
+#define PHASERET_MM256(op)     _mm256_##op##_ps
+#define PHASERET_MM512(op)     _mm512_##op##_ps
+#define PHASERET_M128          __m128
+#define PHASERET_M256          __m256
+#define PHASERET_M512          __m512
+#else
+#define PHASERET_MM128(op)     _mm_##op##_pd
+#define PHASERET_MM256(op)     _mm256_##op##_pd
+#define PHASERET_MM512(op)     _mm512_##op##_pd
+#define PHASERET_M128          __m128d
+#define PHASERET_M256          __m256d
+#define PHASERET_M512          __m512d
+#endif
+
+/* Calls PHASERET_NAME(NAME_avx512), PHASERET_NAME(NAME_avx2) or
+ * PHASERET_NAME(NAME_sse2) with the parenthesized ARGS according to LEVEL
+ * and returns. Does nothing for LTFAT_SIMD_NONE. */
+#define PHASERET_SIMD_DISPATCH(LEVEL, NAME, ARGS)                            \
+    switch (LEVEL)                                                           \
+    {                                                                        \
+    case LTFAT_SIMD_AVX512:                                                  \
+        PHASERET_NAME(NAME##_avx512) ARGS;                                   \
+        return;                                                              \
+    case LTFAT_SIMD_AVX2:                                                    \
+        PHASERET_NAME(NAME##_avx2) ARGS;                                     \
+        return;                                                              \
+    case LTFAT_SIMD_SSE2:                                                    \
+        PHASERET_NAME(NAME##_sse2) ARGS;                                     \
+        return;                                                              \
+    default:                                                                 \
+        break;                                                               \
+    }
+#else
+#define PHASERET_SIMD_DISPATCH(LEVEL, NAME, ARGS)
+#endif /* PHASERET_SIMD_X86 */
+
+#endif
@@ -16,6 +16,7 @@ struct PHASERET_NAME(rtisilaupdate_plan)
     ltfat_int gl;
     ltfat_int M;
     ltfat_int a;
+    ltfat_int W;                       //!< Number of frames done at once
 };
 
 struct PHASERET_NAME(rtisila_state)
@@ -90,109 +91,123 @@ PHASERET_NAME(rtisilaoverlaynthframe)(PHASERET_NAME( rtisilaupdate_plan) * p,
                                       const LTFAT_REAL* frames,
                                       const LTFAT_REAL* g,
                                       ltfat_int n, ltfat_int N)
+{
+    PHASERET_NAME(rtisilaoverlaynthframe_batch)(p, frames, 0, g, n, N);
+}
+
+void
+PHASERET_NAME(rtisilaoverlaynthframe_batch)(
+    PHASERET_NAME(rtisilaupdate_plan) * p, const LTFAT_REAL* frames,
+    ltfat_int framesdist, const LTFAT_REAL* g, ltfat_int n, ltfat_int N)
 {
     ltfat_int M = p->M;
     ltfat_int gl = p->gl;
     ltfat_int a = p->a;
 
-    PHASERET_NAME(overlaynthframe)(frames, gl, N, a, n, p->frame);
+    for (ltfat_int w = 0; w < p->W; w++)
+    {
+        LTFAT_REAL* frame = p->frame + w * M;
 
-    /* // Copy n-th frame */
-    /* memcpy(p->frame, frames + gl * n, M * sizeof * p->frame); */
-    /*  */
-    /* // Overlap frames n+1 ... N-1 or until there is overlap */
-    /* for (ltfat_int ii = n + 1; ii < N; ii++) */
-    /* { */
-    /*     ltfat_int jj = (ii - n) * a; */
-    /*     ltfat_int nSamp = gl - jj; */
-    /*  */
-    /*     if (nSamp <= 0) break; */
-    /*  */
-    /*     const double* framestmp = frames + gl * ii; */
-    /*  */
-    /*     for (ltfat_int kk = 0; kk < nSamp; kk++) */
-    /*         p->frame[jj + kk] += framestmp[kk]; */
-    /* } */
-    /*  */
-    /* // Overlap frames n-1 ... 0, or until there is no overlap */
-    /* for (ltfat_int ii = n - 1; ii >= 0; ii--) */
-    /* { */
-    /*     ltfat_int jj = (n - ii) * a; */
-    /*     ltfat_int nSamp = gl - jj; */
-    /*  */
-    /*     if (nSamp <= 0) break; */
-    /*  */
-    /*     const double* framestmp = frames + gl * ii; */
-    /*  */
-    /*     for (ltfat_int kk = 0; kk < nSamp; kk++) */
-    /*         p->frame[kk] += framestmp[jj + kk]; */
-    /* } */
+        PHASERET_NAME(overlaynthframe)(frames + w * framesdist, gl, N, a, n,
+                                       frame);
 
-    // Multiply with analysis window
-    for (ltfat_int m = 0; m < gl; m++)
-        p->frame[m] *= g[m];
+        // Multiply with analysis window
+        for (ltfat_int m = 0; m < gl; m++)
+            frame[m] *= g[m];
 
-    // Set remaining samples to zeros
-    for (ltfat_int m = gl; m < M; m++)
-        p->frame[m] = 0.0;
+        // Set remaining samples to zeros
+        for (ltfat_int m = gl; m < M; m++)
+            frame[m] = 0.0;
+    }
 }
 
 void
 PHASERET_NAME(rtisilaphaseupdate)(PHASERET_NAME(rtisilaupdate_plan) * p,
                                   const LTFAT_REAL* sframe, LTFAT_REAL* frameupd, LTFAT_COMPLEX* c)
+{
+    PHASERET_NAME(rtisilaphaseupdate_batch)(p, sframe, 0, frameupd, 0, c, 0);
+}
+
+/* Synthesis part common to rtisilaphaseupdate and rtisilaphaseupdatesyn */
+static void
+PHASERET_NAME(rtisilasynframes)(PHASERET_NAME(rtisilaupdate_plan) * p,
+                                LTFAT_REAL* frameupd, ltfat_int frameupddist)
 {
     ltfat_int M = p->M;
     ltfat_int gl = p->gl;
-    ltfat_int M2 = M / 2 + 1;
-
-    LTFAT_NAME_REAL(circshift)(p->frame, M, -(gl / 2), p->frame);
-
-    // FFTREAL
-    LTFAT_NAME(fftreal_execute)(p->fwdp);
-
-    PHASERET_NAME(force_magnitude)(p->fftframe, sframe, M2, p->fftframe);
-
-    // Copy before it gets overwritten
-    if (c) memcpy(c, p->fftframe, M2 * sizeof * c);
 
     // IFFTREAL // Overwrites input p->fftframe
     LTFAT_NAME(ifftreal_execute)(p->backp);
 
-    LTFAT_NAME_REAL(circshift)(p->frame, M, (gl / 2), p->frame);
+    for (ltfat_int w = 0; w < p->W; w++)
+    {
+        LTFAT_REAL* frame = p->frame + w * M;
 
-    // Multiply with the synthesis window
-    for (ltfat_int m = 0; m < gl; m++)
-        p->frame[m] *= p->gd[m];
+        LTFAT_NAME_REAL(circshift)(frame, M, (gl / 2), frame);
 
-    // Set remaining samples to zeros
-    for (ltfat_int m = gl; m < M; m++)
-        p->frame[m] = 0;
+        // Multiply with the synthesis window
+        for (ltfat_int m = 0; m < gl; m++)
+            frame[m] *= p->gd[m];
 
-    // Copy to the output
-    memcpy(frameupd, p->frame, gl * sizeof * frameupd);
+        // Set remaining samples to zeros
+        for (ltfat_int m = gl; m < M; m++)
+            frame[m] = 0;
+
+        // Copy to the output
+        memcpy(frameupd + w * frameupddist, frame, gl * sizeof * frameupd);
+    }
 }
 
 void
-PHASERET_NAME(rtisilaphaseupdatesyn)(PHASERET_NAME(rtisilaupdate_plan) * p,
-                                     const LTFAT_COMPLEX* c, LTFAT_REAL* frameupd)
+PHASERET_NAME(rtisilaphaseupdate_batch)(
+    PHASERET_NAME(rtisilaupdate_plan) * p,
+    const LTFAT_REAL* sframe, ltfat_int sdist,
+    LTFAT_REAL* frameupd, ltfat_int frameupddist,
+    LTFAT_COMPLEX* c, ltfat_int cdist)
 {
     ltfat_int M = p->M;
     ltfat_int gl = p->gl;
     ltfat_int M2 = M / 2 + 1;
 
-    memcpy(p->fftframe, c , M2 * sizeof * p->fftframe );
-    LTFAT_NAME(ifftreal_execute)(p->backp);
-    LTFAT_NAME_REAL(circshift)(p->frame, M, (gl / 2), p->frame);
+    for (ltfat_int w = 0; w < p->W; w++)
+        LTFAT_NAME_REAL(circshift)(p->frame + w * M, M, -(gl / 2),
+                                   p->frame + w * M);
+
+    // FFTREAL of all the frames at once
+    LTFAT_NAME(fftreal_execute)(p->fwdp);
+
+    for (ltfat_int w = 0; w < p->W; w++)
+    {
+        LTFAT_COMPLEX* fftframe = p->fftframe + w * M2;
+
+        PHASERET_NAME(force_magnitude)(fftframe, sframe + w * sdist, M2,
+                                       fftframe);
+
+        // Copy before it gets overwritten
+        if (c) memcpy(c + w * cdist, fftframe, M2 * sizeof * c);
+    }
+
+    PHASERET_NAME(rtisilasynframes)(p, frameupd, frameupddist);
+}
+
+void
+PHASERET_NAME(rtisilaphaseupdatesyn)(PHASERET_NAME(rtisilaupdate_plan) * p,
+                                     const LTFAT_COMPLEX* c, LTFAT_REAL* frameupd)
+{
+    PHASERET_NAME(rtisilaphaseupdatesyn_batch)(p, c, 0, frameupd, 0);
+}
 
-    // Multiply with the synthesis window
-    for (ltfat_int m = 0; m < gl; m++)
-        p->frame[m] *= p->gd[m];
+void
+PHASERET_NAME(rtisilaphaseupdatesyn_batch)(
+    PHASERET_NAME(rtisilaupdate_plan) * p, const LTFAT_COMPLEX* c,
+    ltfat_int cdist, LTFAT_REAL* frameupd, ltfat_int frameupddist)
+{
+    ltfat_int M2 = p->M / 2 + 1;
 
-    // Set remaining samples to zeros
-    for (ltfat_int m = gl; m < M; m++)
-        p->frame[m] = 0;
+    for (ltfat_int w = 0; w < p->W; w++)
+        memcpy(p->fftframe + w * M2, c + w * cdist, M2 * sizeof * p->fftframe);
 
-    memcpy(frameupd, p->frame, gl * sizeof * frameupd);
+    PHASERET_NAME(rtisilasynframes)(p, frameupd, frameupddist);
 }
 
 
@@ -201,12 +216,23 @@ PHASERET_NAME(rtisilaupdate_init)(const LTFAT_REAL* g,
                                   const LTFAT_REAL* specg1, const LTFAT_REAL* specg2, const LTFAT_REAL* gd,
                                   ltfat_int gl, ltfat_int a, ltfat_int M,
                                   PHASERET_NAME(rtisilaupdate_plan) * *pout)
+{
+    return PHASERET_NAME(rtisilaupdate_init_batch)(g, specg1, specg2, gd, gl, a,
+            M, 1, pout);
+}
+
+int
+PHASERET_NAME(rtisilaupdate_init_batch)(const LTFAT_REAL* g,
+                                        const LTFAT_REAL* specg1, const LTFAT_REAL* specg2, const LTFAT_REAL* gd,
+                                        ltfat_int gl, ltfat_int a, ltfat_int M, ltfat_int W,
+                                        PHASERET_NAME(rtisilaupdate_plan) * *pout)
 {
     int status = LTFATERR_SUCCESS;
     PHASERET_NAME(rtisilaupdate_plan)* p = NULL;
     ltfat_int M2 = M / 2 + 1;
 
     CHECKMEM(p = (PHASERET_NAME(rtisilaupdate_plan)*)ltfat_calloc(1, sizeof * p));
+    p->W = W;
     p->M = M;
     p->a = a;
     p->g = g;
@@ -216,16 +242,16 @@ PHASERET_NAME(rtisilaupdate_init)(const LTFAT_REAL* g,
     p->gl = gl;
 
     // Real input array for FFTREAL and output array for IFFTREAL
-    CHECKMEM(p->frame = LTFAT_NAME_REAL(malloc)(M));
+    CHECKMEM(p->frame = LTFAT_NAME_REAL(malloc)(M * W));
     // Complex output array for FFTREAL and input array to IFFTREAL
-    CHECKMEM(p->fftframe = LTFAT_NAME_COMPLEX(malloc)(M2));
+    CHECKMEM(p->fftframe = LTFAT_NAME_COMPLEX(malloc)(M2 * W));
 
     // FFTREAL plan
-    LTFAT_NAME(fftreal_init)(M, 1, p->frame, p->fftframe, FFTW_MEASURE, &p->fwdp);
+    LTFAT_NAME(fftreal_init)(M, W, p->frame, p->fftframe, FFTW_MEASURE, &p->fwdp);
     CHECKINIT(p->fwdp, "FFTW plan failed");
 
     // IFFTREAL plan
-    LTFAT_NAME(ifftreal_init)(M, 1, p->fftframe, p->frame, FFTW_MEASURE, &p->backp);
+    LTFAT_NAME(ifftreal_init)(M, W, p->fftframe, p->frame, FFTW_MEASURE, &p->backp);
     CHECKINIT(p->backp, "FFTW plan failed");
 
     *pout = p;
@@ -259,36 +285,44 @@ PHASERET_NAME(rtisilaupdate_execute)(
     PHASERET_NAME(rtisilaupdate_plan) * p, const LTFAT_REAL* frames, ltfat_int N,
     const LTFAT_REAL* s, ltfat_int lookahead, ltfat_int maxit, LTFAT_REAL* frames2,
     LTFAT_COMPLEX* c)
+{
+    // If we are not working inplace ...
+    if (frames != frames2)
+        memcpy(frames2, frames, p->gl * N * sizeof * frames);
+
+    PHASERET_NAME(rtisilaupdate_execute_batch)(p, frames2, 0, N, s, 0,
+            lookahead, maxit, c, 0);
+}
+
+void
+PHASERET_NAME(rtisilaupdate_execute_batch)(
+    PHASERET_NAME(rtisilaupdate_plan) * p, LTFAT_REAL* frames,
+    ltfat_int framesdist, ltfat_int N, const LTFAT_REAL* s, ltfat_int sdist,
+    ltfat_int lookahead, ltfat_int maxit, LTFAT_COMPLEX* c, ltfat_int cdist)
 {
     ltfat_int lookback = N - lookahead - 1;
     ltfat_int M = p->M;
     ltfat_int gl = p->gl;
     ltfat_int M2 = M / 2 + 1;
 
-    // If we are not working inplace ...
-    if (frames != frames2)
-        memcpy(frames2, frames, gl * N * sizeof * frames);
-
     for (ltfat_int it = 0; it < maxit; it++)
     {
         for (ltfat_int nback = lookahead; nback >= 0; nback--)
         {
             ltfat_int indx = lookback + nback;
+            const LTFAT_REAL* g = p->g;
 
             // Newest lookahead frame is treated differently
             if (nback == lookahead)
-                if (it == 0)
-                    PHASERET_NAME(rtisilaoverlaynthframe)(p, frames2, p->specg1, indx, N);
-                else
-                    PHASERET_NAME(rtisilaoverlaynthframe)(p, frames2, p->specg2, indx, N);
-            else
-                PHASERET_NAME(rtisilaoverlaynthframe)(p, frames2, p->g, indx, N);
+                g = it == 0 ? p->specg1 : p->specg2;
 
-            if (nback == 0 && it == (maxit - 1))
-                PHASERET_NAME(rtisilaphaseupdate)(p, s + nback * M2, frames2 +  indx * gl, c);
-            else
-                PHASERET_NAME(rtisilaphaseupdate)(p, s + nback * M2, frames2 +  indx * gl,
-                                                  NULL);
+            PHASERET_NAME(rtisilaoverlaynthframe_batch)(p, frames, framesdist, g,
+                    indx, N);
+
+            PHASERET_NAME(rtisilaphaseupdate_batch)(p, s + nback * M2, sdist,
+                                                    frames + indx * gl, framesdist,
+                                                    nback == 0 && it == (maxit - 1) ? c : NULL,
+                                                    cdist);
         }
     }
 }
@@ -375,7 +409,8 @@ PHASERET_NAME(rtisila_init)(const LTFAT_REAL* g, ltfat_int gl,
     CHECKMEM(p = (PHASERET_NAME(rtisila_state)*)ltfat_calloc(1, sizeof * p));
 
     CHECKSTATUS(
-        PHASERET_NAME(rtisilaupdate_init)(NULL, NULL, NULL, NULL, gl, a, M, &p->uplan));
+        PHASERET_NAME(rtisilaupdate_init_batch)(NULL, NULL, NULL, NULL, gl, a, M, W,
+                &p->uplan));
 
     CHECKMEM(p->uplan->g = LTFAT_NAME_REAL(malloc)(gl));
     CHECKMEM(p->uplan->gd = LTFAT_NAME_REAL(malloc)(gl));
@@ -522,7 +557,6 @@ PHASERET_NAME(rtisila_execute)( PHASERET_NAME(rtisila_state) * p,
     for (ltfat_int w = 0; w < p->W; w++)
     {
         const LTFAT_REAL* schan = s + w * M2;
-        LTFAT_COMPLEX* cchan = c + w * M2;
         LTFAT_REAL* frameschan = p->frames + w * N * gl;
         LTFAT_REAL* sframeschan = p->s + w * (1 + p->maxLookahead) * M2;
         // Shift frames buffer
@@ -530,11 +564,13 @@ PHASERET_NAME(rtisila_execute)( PHASERET_NAME(rtisila_state) * p,
 
         // Shift scols buffer
         PHASERET_NAME(shiftcolsleft)(sframeschan, M2, p->lookahead + 1, schan);
-
-        PHASERET_NAME(rtisilaupdate_execute)(p->uplan, frameschan, noFrames,
-                                             sframeschan, p->lookahead, p->maxit, frameschan, cchan);
     }
 
+    // All channels are updated at once
+    PHASERET_NAME(rtisilaupdate_execute_batch)(p->uplan, p->frames, N * gl,
+            noFrames, p->s, (1 + p->maxLookahead) * M2,
+            p->lookahead, p->maxit, c, M2);
+
 error:
     return status;
 }
@@ -543,41 +579,209 @@ PHASERET_API int
 PHASERET_NAME(rtisilaoffline)(const LTFAT_REAL s[], const LTFAT_REAL g[],
                               ltfat_int L, ltfat_int gl, ltfat_int W, ltfat_int a, ltfat_int M,
                               ltfat_int lookahead, ltfat_int maxit, LTFAT_COMPLEX c[])
+{
+    return PHASERET_NAME(rtisilaoffline_batched)(s, g, L, gl, W, a, M,
+            lookahead, maxit, 1, c);
+}
+
+/* The offline processing is split into lanes. A lane is one channel or a
+ * segment of one channel processed as an independent stream. The segments
+ * other than the first one start warmup frames earlier and the coefficients
+ * of those frames are discarded. Lanes are divided among groups. A group is
+ * a multichannel state which runs its lanes in lockstep, so that the FFTs
+ * of all lanes are done at once, and the groups run in parallel. */
+struct PHASERET_NAME(rtisilaoffline_data)
+{
+    const LTFAT_REAL* s;
+    LTFAT_COMPLEX* c;
+    ltfat_int N;
+    ltfat_int M2;
+    ltfat_int lookahead;
+    ltfat_int warmup;
+    ltfat_int segNo;
+    ltfat_int lanesNo;
+    ltfat_int groupsNo;
+    PHASERET_NAME(rtisila_state)** states;
+    LTFAT_REAL* sbuf;
+    LTFAT_COMPLEX* cbuf;
+    LTFAT_COMPLEX* cwarmup;
+};
+
+static void
+PHASERET_NAME(rtisilaoffline_lane)(struct PHASERET_NAME(rtisilaoffline_data)* d,
+                                   ltfat_int l, ltfat_int* w, ltfat_int* nstart,
+                                   ltfat_int* n0, ltfat_int* n1)
+{
+    ltfat_int seg = l % d->segNo;
+    *w = l / d->segNo;
+    *n0 = seg * d->N / d->segNo;
+    *n1 = (seg + 1) * d->N / d->segNo;
+    *nstart = seg ? *n0 - d->warmup : 0;
+}
+
+static void
+PHASERET_NAME(rtisilaoffline_task)(void* userdata, ltfat_int group,
+                                   ltfat_int UNUSED(workerid))
+{
+    struct PHASERET_NAME(rtisilaoffline_data)* d =
+        (struct PHASERET_NAME(rtisilaoffline_data)*) userdata;
+    ltfat_int N = d->N, M2 = d->M2;
+    ltfat_int l0 = group * d->lanesNo / d->groupsNo;
+    ltfat_int l1 = (group + 1) * d->lanesNo / d->groupsNo;
+    LTFAT_REAL* sbuf = d->sbuf + l0 * M2;
+    LTFAT_COMPLEX* cbuf = d->cbuf + l0 * M2;
+    ltfat_int w, nstart, n0, n1, stepsNo = 0;
+
+    for (ltfat_int l = l0; l < l1; l++)
+    {
+        PHASERET_NAME(rtisilaoffline_lane)(d, l, &w, &nstart, &n0, &n1);
+        stepsNo = ltfat_imax(stepsNo, n1 - nstart);
+    }
+
+    for (ltfat_int t = 0; t < stepsNo; t++)
+    {
+        // Lanes which are already finished get zeros
+        for (ltfat_int l = l0; l < l1; l++)
+        {
+            PHASERET_NAME(rtisilaoffline_lane)(d, l, &w, &nstart, &n0, &n1);
+            if (nstart + t < n1)
+                memcpy(sbuf + (l - l0) * M2,
+                       d->s + w * N * M2 + ((nstart + t + d->lookahead) % N) * M2,
+                       M2 * sizeof * sbuf);
+            else
+                memset(sbuf + (l - l0) * M2, 0, M2 * sizeof * sbuf);
+        }
+
+        PHASERET_NAME(rtisila_execute)(d->states[group], sbuf, cbuf);
+
+        for (ltfat_int l = l0; l < l1; l++)
+        {
+            PHASERET_NAME(rtisilaoffline_lane)(d, l, &w, &nstart, &n0, &n1);
+            if (nstart + t >= n0 && nstart + t < n1)
+                memcpy(d->c + w * N * M2 + (nstart + t) * M2,
+                       cbuf + (l - l0) * M2, M2 * sizeof * cbuf);
+            else if (nstart + t < n0)
+                memcpy(d->cwarmup + (l * d->warmup + t) * M2,
+                       cbuf + (l - l0) * M2, M2 * sizeof * cbuf);
+        }
+    }
+}
+
+/* The algorithm is odd-symmetric i.e. a segment can converge to the negative
+ * of the solution its left neighbour continues with. The sign is chosen such
+ * that the warm-up frames agree with the end of the left neighbour. */
+static void
+PHASERET_NAME(rtisilaoffline_alignsigns)(
+    struct PHASERET_NAME(rtisilaoffline_data)* d)
+{
+    ltfat_int N = d->N, M2 = d->M2;
+    ltfat_int w, nstart, n0, n1;
+
+    for (ltfat_int l = 0; l < d->lanesNo; l++)
+    {
+        double corr = 0.0;
+        LTFAT_COMPLEX* cw = d->cwarmup + l * d->warmup * M2;
+
+        if (l % d->segNo == 0) continue;
+
+        PHASERET_NAME(rtisilaoffline_lane)(d, l, &w, &nstart, &n0, &n1);
+
+        for (ltfat_int ii = 0; ii < d->warmup * M2; ii++)
+        {
+            LTFAT_COMPLEX cleft = d->c[w * N * M2 + nstart * M2 + ii];
+            corr += ltfat_real(cleft) * ltfat_real(cw[ii]) +
+                    ltfat_imag(cleft) * ltfat_imag(cw[ii]);
+        }
+
+        if (corr < 0.0)
+            for (ltfat_int ii = n0 * M2; ii < n1 * M2; ii++)
+                d->c[w * N * M2 + ii] = -d->c[w * N * M2 + ii];
+    }
+}
+
+PHASERET_API int
+PHASERET_NAME(rtisilaoffline_batched)(const LTFAT_REAL s[], const LTFAT_REAL g[],
+                                      ltfat_int L, ltfat_int gl, ltfat_int W, ltfat_int a, ltfat_int M,
+                                      ltfat_int lookahead, ltfat_int maxit, ltfat_int nthreads,
+                                      LTFAT_COMPLEX c[])
 {
     int status = LTFATERR_SUCCESS;
-    PHASERET_NAME(rtisila_state)* p = NULL;
+    struct PHASERET_NAME(rtisilaoffline_data) d;
+    const LTFAT_REAL** sinit = NULL;
+    ltfat_threadpool* pool = NULL;
     ltfat_int N = L / a;
     ltfat_int M2 = M / 2 + 1;
 
-    CHECKNULL(s);
-    CHECKNULL(g);
-    CHECKNULL(c);
+    memset(&d, 0, sizeof d);
+    CHECKNULL(s); CHECKNULL(g); CHECKNULL(c);
+    CHECK(LTFATERR_NOTPOSARG, W > 0, "W must be positive (passed %d)", W);
+    CHECK(LTFATERR_NOTPOSARG, a > 0, "a must be positive (passed %d)", a);
+    CHECK(LTFATERR_BADARG, nthreads >= 0,
+          "nthreads must be nonnegative (passed %d)", nthreads);
     // Just limit lookahead to something sensible
     lookahead = lookahead > N ? N : lookahead;
 
-    CHECKSTATUS(PHASERET_NAME(rtisila_init)(g, gl, 1, a, M, lookahead, maxit, &p));
+    if (nthreads == 0)
+        nthreads = ltfat_threadpool_get_nprocs();
+
+    d.s = s; d.c = c; d.N = N; d.M2 = M2; d.lookahead = lookahead;
+    // A segment starts with a full buffer of frames of its own
+    d.warmup = (ltfat_int)( ceil(((LTFAT_REAL)gl) / a) ) + lookahead;
+    // Channels are split only when there are less of them than threads
+    d.segNo = nthreads > W ? ltfat_idivceil(nthreads, W) : 1;
+    d.segNo = ltfat_imax(1, ltfat_imin(d.segNo, N / (d.warmup + lookahead)));
+    d.lanesNo = W * d.segNo;
+    d.groupsNo = ltfat_imin(nthreads, d.lanesNo);
+
+    CHECKMEM( d.states = LTFAT_NEWARRAY(PHASERET_NAME(rtisila_state)*, d.groupsNo));
+    CHECKMEM( sinit = LTFAT_NEWARRAY(const LTFAT_REAL*, d.lanesNo));
+    CHECKMEM( d.sbuf = LTFAT_NAME_REAL(malloc)(M2 * d.lanesNo));
+    CHECKMEM( d.cbuf = LTFAT_NAME_COMPLEX(malloc)(M2 * d.lanesNo));
+    CHECKMEM( d.cwarmup = LTFAT_NAME_COMPLEX(malloc)(M2 * d.warmup * d.lanesNo));
+
+    for (ltfat_int l = 0; l < d.lanesNo; l++)
+    {
+        ltfat_int w, nstart, n0, n1;
+        PHASERET_NAME(rtisilaoffline_lane)(&d, l, &w, &nstart, &n0, &n1);
+        sinit[l] = s + w * N * M2 + nstart * M2;
+    }
 
-    for (ltfat_int w = 0; w < W; w++)
+    // Plans are created serially
+    for (ltfat_int group = 0; group < d.groupsNo; group++)
     {
-        const LTFAT_REAL* schan = s + w * N * M2;
-        PHASERET_NAME(rtisila_reset)(p, &schan);
+        ltfat_int l0 = group * d.lanesNo / d.groupsNo;
+        ltfat_int l1 = (group + 1) * d.lanesNo / d.groupsNo;
 
-        for (ltfat_int n = 0, nahead = lookahead; nahead < N; ++n, ++nahead)
-        {
-            const LTFAT_REAL* sncol = schan + nahead * M2;
-            LTFAT_COMPLEX* cncol = c + n * M2 + w * N * M2;
-            PHASERET_NAME(rtisila_execute)(p, sncol, cncol);
-        }
+        CHECKSTATUS(
+            PHASERET_NAME(rtisila_init)(g, gl, l1 - l0, a, M, lookahead, maxit,
+                                        &d.states[group]));
+        PHASERET_NAME(rtisila_reset)(d.states[group], sinit + l0);
+    }
 
-        for (ltfat_int n = N - lookahead, nahead = 0; n < N; ++n, ++nahead)
-        {
-            const LTFAT_REAL* sncol = schan + nahead * M2;
-            LTFAT_COMPLEX* cncol = c + n * M2 + w * N * M2;
-            PHASERET_NAME(rtisila_execute)(p, sncol, cncol);
-        }
+    if (d.groupsNo > 1)
+    {
+        CHECKSTATUS( ltfat_threadpool_init(d.groupsNo, &pool));
+        CHECKSTATUS(
+            ltfat_threadpool_execute(pool, d.groupsNo,
+                                     PHASERET_NAME(rtisilaoffline_task), &d));
+    }
+    else
+    {
+        PHASERET_NAME(rtisilaoffline_task)(&d, 0, 0);
     }
+
+    PHASERET_NAME(rtisilaoffline_alignsigns)(&d);
+
 error:
-    if (p) PHASERET_NAME(rtisila_done)(&p);
+    if (pool) ltfat_threadpool_done(&pool);
+    if (d.states)
+    {
+        for (ltfat_int group = 0; group < d.groupsNo; group++)
+            if (d.states[group])
+                PHASERET_NAME(rtisila_done)(&d.states[group]);
+        ltfat_free(d.states);
+    }
+    LTFAT_SAFEFREEALL(sinit, d.sbuf, d.cbuf, d.cwarmup);
     return status;
 }
 
@@ -3,6 +3,7 @@
 #include "phaseret/utils.h"
 #include "float.h"
 #include "rtpghi_private.h"
+#include "bitscan_private.h"
 
 
 PHASERET_API int
@@ -22,8 +23,44 @@ PHASERET_NAME(rtpghi_set_tol)(PHASERET_NAME(rtpghi_state)* p, double tol)
     CHECKNULL(p);
     CHECK(LTFATERR_NOTINRANGE, tol > 0 && tol < 1, "tol must be in range ]0,1[");
 
-    p->p->tol = tol;
-    p->p->logtol = log(tol + DBL_MIN);
+    for (ltfat_int w = 0; w < p->W; w++)
+    {
+        p->chanp[w]->tol = tol;
+        p->chanp[w]->logtol = log(tol + DBL_MIN);
+    }
+error:
+    return status;
+}
+
+PHASERET_API int
+PHASERET_NAME(rtpghi_set_heaptype)(PHASERET_NAME(rtpghi_state)* p,
+                                   ltfat_heap_type type)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    for (ltfat_int w = 0; w < p->W; w++)
+        CHECKSTATUS( PHASERET_NAME(rtpghiupdate_set_heaptype)(p->chanp[w], type));
+error:
+    return status;
+}
+
+PHASERET_API int
+PHASERET_NAME(rtpghi_set_nthreads)(PHASERET_NAME(rtpghi_state)* p,
+                                   ltfat_int nthreads)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_BADARG, nthreads >= 0,
+          "nthreads must be nonnegative (passed %td)", nthreads);
+
+    if (p->pool) ltfat_threadpool_done(&p->pool);
+
+    if (nthreads == 0) nthreads = ltfat_threadpool_get_nprocs();
+    // There is no use for more threads than channels
+    nthreads = ltfat_imin(nthreads, p->W);
+    if (nthreads == 1) return status;
+
+    CHECKSTATUS( ltfat_threadpool_init(nthreads, &p->pool));
 error:
     return status;
 }
@@ -46,8 +83,14 @@ PHASERET_NAME(rtpghi_init)(ltfat_int W, ltfat_int a, ltfat_int M,
     CHECK(LTFATERR_NOTINRANGE, tol > 0 && tol < 1, "tol must be in range ]0,1[");
 
     CHECKMEM( p = (PHASERET_NAME(rtpghi_state)*) ltfat_calloc(1, sizeof * p));
+    p->W = W;
+
+    // Each channel has its own update plan so that the channels can be
+    // processed in parallel
+    CHECKMEM( p->chanp = LTFAT_NEWARRAY(PHASERET_NAME(rtpghiupdate_plan)*, W));
+    for (ltfat_int w = 0; w < W; w++)
+        CHECKSTATUS( PHASERET_NAME(rtpghiupdate_init)( M, 1, tol, &p->chanp[w]));
 
-    CHECKSTATUS( PHASERET_NAME(rtpghiupdate_init)( M, W, tol, &p->p));
     CHECKMEM( p->slog =  LTFAT_NAME_REAL(calloc)(3 * M2 * W));
     CHECKMEM( p->tgrad = LTFAT_NAME_REAL(calloc)(3 * M2 * W));
     CHECKMEM( p->s =     LTFAT_NAME_REAL(calloc)(2 * M2 * W));
@@ -58,7 +101,6 @@ PHASERET_NAME(rtpghi_init)(ltfat_int W, ltfat_int a, ltfat_int M,
     p->M = M;
     p->a = a;
     p->gamma = gamma;
-    p->W = W;
 
     *pout = p;
     return status;
@@ -95,49 +137,67 @@ error:
     return status;
 }
 
-PHASERET_API int
-PHASERET_NAME(rtpghi_execute)(PHASERET_NAME(rtpghi_state)* p,
-                              const LTFAT_REAL s[], LTFAT_COMPLEX c[])
+/* Processes channel taskid of the frame stored in p->execs and p->execc */
+static void
+PHASERET_NAME(rtpghi_execute_task)(void* userdata, ltfat_int taskid,
+                                   ltfat_int UNUSED(workerid))
 {
+    PHASERET_NAME(rtpghi_state)* p = (PHASERET_NAME(rtpghi_state)*) userdata;
     // n, n-1, n-2 frames
     // s is n-th
     ltfat_int M2 = p->M / 2 + 1;
-    ltfat_int W = p->W;
+    ltfat_int w = taskid;
+    const LTFAT_REAL* s = p->execs;
+    LTFAT_COMPLEX* c = p->execc;
+
+    LTFAT_REAL* slogCol = p->slog +   w * 3 * M2;
+    LTFAT_REAL* tgradCol = p->tgrad + w * 3 * M2;
+    LTFAT_REAL* sCol = p->s +         w * 2 * M2;
+    LTFAT_REAL* fgradCol = p->fgrad + w * M2;
+    LTFAT_REAL* phaseCol = p->phase + w * M2;
+
+    // store log(s)
+    PHASERET_NAME(shiftcolsleft)(slogCol, M2, 3, NULL);
+    PHASERET_NAME(shiftcolsleft)(tgradCol, M2, 3, NULL);
+    PHASERET_NAME(shiftcolsleft)(sCol, M2, 2, s + w * M2);
+
+    PHASERET_NAME(rtpghilog)(sCol + M2, M2, slogCol + 2 * M2);
+
+    // Compute and store tgrad for n
+    PHASERET_NAME(rtpghitgrad)(slogCol + 2 * M2, p->a, p->M, p->gamma,
+                               tgradCol + 2 * M2);
+
+    // Compute fgrad for n or n-1
+    PHASERET_NAME(rtpghifgrad)(slogCol, p->a, p->M, p->gamma, p->do_causal,
+                               fgradCol);
+
+    PHASERET_NAME(rtpghiupdate_execute)(p->chanp[w],
+                                        p->do_causal ? slogCol + M2 : slogCol,
+                                        p->do_causal ? tgradCol + M2 : tgradCol,
+                                        fgradCol, phaseCol, phaseCol);
+
+    // Combine phase with magnitude
+    PHASERET_NAME(rtpghimagphase)(p->do_causal ? sCol + M2 : sCol, phaseCol, M2,
+                                  c + w * M2);
+}
+
+PHASERET_API int
+PHASERET_NAME(rtpghi_execute)(PHASERET_NAME(rtpghi_state)* p,
+                              const LTFAT_REAL s[], LTFAT_COMPLEX c[])
+{
     int status = LTFATERR_SUCCESS;
     CHECKNULL(p); CHECKNULL(s); CHECKNULL(c);
 
-    for (ltfat_int w = 0; w < W; ++w)
-    {
-        LTFAT_REAL* slogCol = p->slog +   w * 3 * M2;
-        LTFAT_REAL* tgradCol = p->tgrad + w * 3 * M2;
-        LTFAT_REAL* sCol = p->s +         w * 2 * M2;
-        LTFAT_REAL* fgradCol = p->fgrad + w * M2;
-        LTFAT_REAL* phaseCol = p->phase + w * M2;
-
-        // store log(s)
-        PHASERET_NAME(shiftcolsleft)(slogCol, M2, 3, NULL);
-        PHASERET_NAME(shiftcolsleft)(tgradCol, M2, 3, NULL);
-        PHASERET_NAME(shiftcolsleft)(sCol, M2, 2, s + w * M2);
-
-        PHASERET_NAME(rtpghilog)(sCol + M2, M2, slogCol + 2 * M2);
-
-        // Compute and store tgrad for n
-        PHASERET_NAME(rtpghitgrad)(slogCol + 2 * M2, p->a, p->M, p->gamma,
-                                   tgradCol + 2 * M2);
-
-        // Compute fgrad for n or n-1
-        PHASERET_NAME(rtpghifgrad)(slogCol, p->a, p->M, p->gamma, p->do_causal,
-                                   fgradCol);
-
-        PHASERET_NAME(rtpghiupdate_execute)(p->p,
-                                            p->do_causal ? slogCol + M2 : slogCol,
-                                            p->do_causal ? tgradCol + M2 : tgradCol,
-                                            fgradCol, phaseCol, phaseCol);
-
-        // Combine phase with magnitude
-        PHASERET_NAME(rtpghimagphase)(p->do_causal ? sCol + M2 : sCol, phaseCol, M2,
-                                      c + w * M2);
-    }
+    p->execs = s;
+    p->execc = c;
+
+    if (p->pool &&
+        ltfat_threadpool_execute(p->pool, p->W, &PHASERET_NAME(rtpghi_execute_task),
+                                 p) == LTFATERR_SUCCESS)
+        return status;
+
+    for (ltfat_int w = 0; w < p->W; ++w)
+        PHASERET_NAME(rtpghi_execute_task)(p, w, 0);
 
 error:
     return status;
@@ -150,7 +210,13 @@ PHASERET_NAME(rtpghi_done)(PHASERET_NAME(rtpghi_state)** p)
     PHASERET_NAME(rtpghi_state)* pp;
     CHECKNULL(p); CHECKNULL(*p);
     pp = *p;
-    if (pp->p)     PHASERET_NAME(rtpghiupdate_done)(&pp->p);
+    if (pp->pool)  ltfat_threadpool_done(&pp->pool);
+    if (pp->chanp)
+    {
+        for (ltfat_int w = 0; w < pp->W; w++)
+            if (pp->chanp[w]) PHASERET_NAME(rtpghiupdate_done)(&pp->chanp[w]);
+        ltfat_free(pp->chanp);
+    }
     if (pp->slog)  ltfat_free(pp->slog);
     if (pp->s)     ltfat_free(pp->s);
     if (pp->phase) ltfat_free(pp->phase);
@@ -173,6 +239,9 @@ PHASERET_NAME(rtpghiupdate_init)(ltfat_int M, ltfat_int W, double tol,
     CHECKMEM( p = (PHASERET_NAME(rtpghiupdate_plan)*) ltfat_calloc(1, sizeof * p));
     CHECKMEM( p->donemask = (int*) ltfat_calloc(M2, sizeof * p->donemask));
 
+    CHECKMEM( p->bucketnext = LTFAT_NEWARRAY(ltfat_int, 2 * M2));
+    CHECKMEM( p->buckethead = LTFAT_NEWARRAY(ltfat_int, PHASERET_RTPGHI_BUCKETNO));
+
     p->randphaseLen = 10 * M2 * W;
     CHECKMEM( p->randphase = LTFAT_NAME_REAL(malloc)(p->randphaseLen));
 
@@ -184,7 +253,8 @@ PHASERET_NAME(rtpghiupdate_init)(ltfat_int M, ltfat_int W, double tol,
     p->tol = tol;
     p->M = M;
     p->randphaseId = 0;
-    p->h = LTFAT_NAME(heap_init)(2 * M2, NULL);
+    p->heaptype = LTFAT_HEAP_BINARY;
+    CHECKMEM( p->h = LTFAT_NAME(heap_init)(2 * M2, NULL));
 
     *pout = p;
     return status;
@@ -193,6 +263,95 @@ error:
     return status;
 }
 
+PHASERET_API int
+PHASERET_NAME(rtpghiupdate_set_heaptype)(PHASERET_NAME(rtpghiupdate_plan)* p,
+                                         ltfat_heap_type type)
+{
+    int status = LTFATERR_SUCCESS;
+    CHECKNULL(p);
+    CHECK(LTFATERR_BADARG, type == LTFAT_HEAP_BINARY || type == LTFAT_HEAP_BUCKET,
+          "Unknown heap type (passed %d)", (int) type);
+    p->heaptype = type;
+error:
+    return status;
+}
+
+/* The bucket queue orders the keys by the uniformly quantized log-magnitude
+ * and it is LIFO within a bucket. Each key enters at most once per frame
+ * so bucketnext can be indexed by the key. Inserting and deleting is O(1),
+ * the top bucket is found by scanning PHASERET_RTPGHI_BUCKETWORDS words. */
+static void
+PHASERET_NAME(rtpghi_bucket_reset)(PHASERET_NAME(rtpghiupdate_plan)* p,
+                                   const LTFAT_REAL slog[], LTFAT_REAL logabstol)
+{
+    for (ltfat_int b = 0; b < PHASERET_RTPGHI_BUCKETNO; b++)
+        p->buckethead[b] = -1;
+
+    memset(p->bucketmask, 0, sizeof p->bucketmask);
+    p->bucketslog = slog;
+    p->bucketmin = logabstol;
+    p->bucketscale = (LTFAT_REAL) (PHASERET_RTPGHI_BUCKETNO / -p->logtol);
+}
+
+static void
+PHASERET_NAME(rtpghi_bucket_insert)(PHASERET_NAME(rtpghiupdate_plan)* p,
+                                    ltfat_int key)
+{
+    LTFAT_REAL pos = (p->bucketslog[key] - p->bucketmin) * p->bucketscale;
+    ltfat_int b;
+
+    // The keys from the previous frame can be below the range
+    if ( !(pos > 0) )
+        b = 0;
+    else if ( pos >= PHASERET_RTPGHI_BUCKETNO - 1 )
+        b = PHASERET_RTPGHI_BUCKETNO - 1;
+    else
+        b = (ltfat_int) pos;
+
+    p->bucketnext[key] = p->buckethead[b];
+    p->buckethead[b] = key;
+    p->bucketmask[b / 64] |= (uint64_t) 1 << (b % 64);
+}
+
+static ltfat_int
+PHASERET_NAME(rtpghi_bucket_delete)(PHASERET_NAME(rtpghiupdate_plan)* p)
+{
+    for (ltfat_int word = PHASERET_RTPGHI_BUCKETWORDS - 1; word >= 0; word--)
+    {
+        uint64_t x = p->bucketmask[word];
+        ltfat_int b, key;
+        if (!x) continue;
+
+        b = 64 * word + ltfat_highestbit64(x);
+        key = p->buckethead[b];
+        p->buckethead[b] = p->bucketnext[key];
+        if (p->buckethead[b] < 0)
+            p->bucketmask[word] &= ~((uint64_t) 1 << (b % 64));
+        return key;
+    }
+
+    return -1;
+}
+
+static void
+PHASERET_NAME(rtpghi_queue_insert)(PHASERET_NAME(rtpghiupdate_plan)* p,
+                                   ltfat_int key)
+{
+    if (p->heaptype == LTFAT_HEAP_BUCKET)
+        PHASERET_NAME(rtpghi_bucket_insert)(p, key);
+    else
+        LTFAT_NAME(heap_insert)(p->h, key);
+}
+
+static ltfat_int
+PHASERET_NAME(rtpghi_queue_delete)(PHASERET_NAME(rtpghiupdate_plan)* p)
+{
+    if (p->heaptype == LTFAT_HEAP_BUCKET)
+        return PHASERET_NAME(rtpghi_bucket_delete)(p);
+    else
+        return LTFAT_NAME(heap_delete)(p->h);
+}
+
 PHASERET_API int
 PHASERET_NAME(rtpghiupdate_execute_withmask)(PHASERET_NAME(rtpghiupdate_plan)* p,
                                              const LTFAT_REAL slog[],
@@ -237,7 +396,6 @@ PHASERET_NAME(rtpghiupdate_execute_common)(PHASERET_NAME(rtpghiupdate_plan)* p,
                                              const LTFAT_REAL startphase[],
                                              LTFAT_REAL phase[])
 {
-    LTFAT_NAME(heap)* h = p->h;
     ltfat_int M2 = p->M / 2 + 1;
     ltfat_int quickbreak = M2;
     const LTFAT_REAL oneover2 = (LTFAT_REAL) ( 1.0 / 2.0 );
@@ -255,14 +413,17 @@ PHASERET_NAME(rtpghiupdate_execute_common)(PHASERET_NAME(rtpghiupdate_plan)* p,
 
     logabstol += (LTFAT_REAL) p->logtol;
 
-    LTFAT_NAME(heap_reset)(h, slog);
+    if (p->heaptype == LTFAT_HEAP_BUCKET)
+        PHASERET_NAME(rtpghi_bucket_reset)(p, slog, logabstol);
+    else
+        LTFAT_NAME(heap_reset)(p->h, slog);
 
     for (ltfat_int m = 0; m < M2; m++)
     {
         if ( donemask[m] > 0 )
         {
             // We already know this one
-            LTFAT_NAME(heap_insert)(h, m + M2);
+            PHASERET_NAME(rtpghi_queue_insert)(p, m + M2);
             quickbreak--;
         }
         else
@@ -275,13 +436,13 @@ PHASERET_NAME(rtpghiupdate_execute_common)(PHASERET_NAME(rtpghiupdate_plan)* p,
             }
             else
             {
-                LTFAT_NAME(heap_insert)(h, m);
+                PHASERET_NAME(rtpghi_queue_insert)(p, m);
             }
         }
     }
 
     ltfat_int w = -1;
-    while ( (quickbreak > 0) && ( w = LTFAT_NAME(heap_delete)(h) ) >= 0 )
+    while ( (quickbreak > 0) && ( w = PHASERET_NAME(rtpghi_queue_delete)(p) ) >= 0 )
     {
         if ( w >= M2 )
         {
@@ -293,7 +454,7 @@ PHASERET_NAME(rtpghiupdate_execute_common)(PHASERET_NAME(rtpghiupdate_plan)* p,
                 phase[wprev + 1] = phase[wprev] + (fgrad[wprev] + fgrad[wprev + 1]) * oneover2;
                 donemask[wprev + 1] = 1;
 
-                LTFAT_NAME(heap_insert)(h, w + 1);
+                PHASERET_NAME(rtpghi_queue_insert)(p, w + 1);
                 quickbreak--;
             }
 
@@ -302,7 +463,7 @@ PHASERET_NAME(rtpghiupdate_execute_common)(PHASERET_NAME(rtpghiupdate_plan)* p,
                 phase[wprev - 1] = phase[wprev] - (fgrad[wprev] + fgrad[wprev - 1]) * oneover2;
                 donemask[wprev - 1] = 1;
 
-                LTFAT_NAME(heap_insert)(h, w - 1);
+                PHASERET_NAME(rtpghi_queue_insert)(p, w - 1);
                 quickbreak--;
             }
         }
@@ -315,7 +476,7 @@ PHASERET_NAME(rtpghiupdate_execute_common)(PHASERET_NAME(rtpghiupdate_plan)* p,
                 phase[w] = startphase[w] + (tgrad[w] + tgrad[wnext]) * oneover2;
                 donemask[w] = 1;
 
-                LTFAT_NAME(heap_insert)(h, wnext);
+                PHASERET_NAME(rtpghi_queue_insert)(p, wnext);
                 quickbreak--;
             }
         }
@@ -343,6 +504,8 @@ PHASERET_NAME(rtpghiupdate_done)(PHASERET_NAME(rtpghiupdate_plan)** p)
     pp = *p;
     if (pp->h)         LTFAT_NAME(heap_done)(pp->h);
     if (pp->donemask)  ltfat_free(pp->donemask);
+    if (pp->bucketnext) ltfat_free(pp->bucketnext);
+    if (pp->buckethead) ltfat_free(pp->buckethead);
     if (pp->randphase) ltfat_free(pp->randphase);
     ltfat_free(pp);
     pp = NULL;
@@ -406,61 +569,6 @@ error:
 }
 
 
-void
-PHASERET_NAME(rtpghifgrad)(const LTFAT_REAL* logs, ltfat_int a, ltfat_int M,
-                           double gamma,
-                           int do_causal, LTFAT_REAL* fgrad)
-{
-    ltfat_int M2 = M / 2 + 1;
-
-    const LTFAT_REAL fgradmul = (const LTFAT_REAL)( -gamma / (2.0 * a * M));
-    const LTFAT_REAL* scol0 = logs;
-    const LTFAT_REAL* scol2 = logs + 2 * M2;
-
-    if (do_causal)
-    {
-        const LTFAT_REAL* scol1 = logs + M2;
-
-        for (ltfat_int m = 0; m < M2; ++m)
-            fgrad[m] = fgradmul * ((LTFAT_REAL)(3.0)* scol2[m] - (LTFAT_REAL)(4.0) * scol1[m] + scol0[m]);
-    }
-    else
-    {
-        for (ltfat_int m = 0; m < M2; ++m)
-            fgrad[m] = fgradmul * (scol2[m] - scol0[m]);
-    }
-}
-
-void
-PHASERET_NAME(rtpghitgrad)(const LTFAT_REAL* logs, ltfat_int a, ltfat_int M,
-                           double gamma,
-                           LTFAT_REAL* tgrad)
-{
-    ltfat_int M2 = M / 2 + 1;
-
-    const LTFAT_REAL tgradmul = (const LTFAT_REAL)( (a * M) / (gamma * 2.0));
-    const LTFAT_REAL tgradplus = (const LTFAT_REAL)( 2.0 * M_PI * a / ((double)M) );
-
-    tgrad[0]      = 0.0;
-    tgrad[M2 - 1] = 0.0;
-
-    for (ltfat_int m = 1; m < M2 - 1; m++)
-        tgrad[m] = tgradmul * (logs[m + 1] - logs[m - 1]) + tgradplus * m;
-}
-
-void
-PHASERET_NAME(rtpghilog)(const LTFAT_REAL* in, ltfat_int L, LTFAT_REAL* out)
-{
-#ifdef LTFAT_DOUBLE
-    LTFAT_REAL eps = DBL_MIN;
-#elif defined(LTFAT_SINGLE)
-    LTFAT_REAL eps = FLT_MIN;
-#endif
-
-    for (ltfat_int l = 0; l < L; l++)
-        out[l] = log(in[l] + eps);
-}
-
 void
 PHASERET_NAME(rtpghimagphase)(const LTFAT_REAL* s, const LTFAT_REAL* phase,
                               ltfat_int L, LTFAT_COMPLEX* c)
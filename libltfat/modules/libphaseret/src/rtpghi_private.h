@@ -1,10 +1,18 @@
 #ifndef _PHASERET_RTPGHI_PRIVATE_H
 #define _PHASERET_RTPGHI_PRIVATE_H
+#include <stdint.h>
 
+/* The bucket queue divides the log-magnitude range [max + logtol, max] of
+ * the two frames into this many uniform buckets */
+#define PHASERET_RTPGHI_BUCKETNO 256
+#define PHASERET_RTPGHI_BUCKETWORDS (PHASERET_RTPGHI_BUCKETNO / 64)
 
 struct PHASERET_NAME(rtpghi_state)
 {
-    PHASERET_NAME(rtpghiupdate_plan)* p;
+    PHASERET_NAME(rtpghiupdate_plan)** chanp; //!< Update plan of each channel
+    ltfat_threadpool* pool; //!< NULL unless more than one thread is used
+    const LTFAT_REAL* execs; //!< Input frame of the current execute call
+    LTFAT_COMPLEX* execc;    //!< Output frame of the current execute call
     ltfat_int M;
     ltfat_int a;
     ltfat_int W;
@@ -27,6 +35,22 @@ struct PHASERET_NAME(rtpghiupdate_plan)
     LTFAT_REAL* randphase; //!< Precomputed array of random phase
     ltfat_int randphaseLen;
     ltfat_int randphaseId;
+    ltfat_heap_type heaptype;
+    /* Bucket queue only. It does not reuse the bucket heap of libltfat,
+     * only the bit scan of the masks. The heap keys are linear magnitudes
+     * and the bucket is taken from the float exponent, 8 buckets per
+     * octave over the whole float range. Here the keys are log-magnitudes,
+     * which can be negative, and the buckets must be uniform over the
+     * tolerance range of the current frame. The heap also keeps a growing
+     * pool of list nodes for repeated keys, while here every key enters
+     * at most once per frame, so the links are indexed by the key and
+     * execute does not allocate. */
+    const LTFAT_REAL* bucketslog; //!< Values of the keys
+    LTFAT_REAL bucketmin;         //!< Lower bound of the lowest bucket
+    LTFAT_REAL bucketscale;       //!< Buckets per unit of log-magnitude
+    ltfat_int* bucketnext;        //!< Next key in the same bucket, by key
+    ltfat_int* buckethead;        //!< Last inserted key, -1 if empty
+    uint64_t bucketmask[PHASERET_RTPGHI_BUCKETWORDS]; //!< Bit per bucket
 };
 
 #endif
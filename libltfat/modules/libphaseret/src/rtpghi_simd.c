@@ -0,0 +1,371 @@
+#include "phaseret/rtpghi.h"
+#include "rtpghi_private.h"
+#include "phaseret_simd_private.h"
+#include "ltfat/macros.h"
+#include "float.h"
+#include <stdint.h>
+
+/* The logarithm is evaluated as in fdlibm/musl: the argument is split to
+ * 2^k*(1+f) with 1+f in [sqrt(2)/2, sqrt(2)] and log(1+f) is approximated
+ * by a polynomial in s = f/(2+f). The error is below 1 ulp. Only normal,
+ * finite and positive arguments are supported, which holds for magnitude
+ * plus the smallest normal number. The plain loop and all the vectorized
+ * kernels evaluate exactly the same expressions, so the results do not
+ * depend on the instruction set. */
+#ifdef LTFAT_SINGLE
+#define PHASERET_LOG_UINT      uint32_t
+#define PHASERET_LOG_ADD       0x004afb0dU /* 1.0 - sqrt(2)/2 in bits */
+#define PHASERET_LOG_MANT      0x007fffffU
+#define PHASERET_LOG_BASE      0x3f3504f3U /* sqrt(2)/2 */
+#define PHASERET_LOG_EXPSHIFT  23
+#define PHASERET_LOG_EXPBIAS   0x7f
+#define PHASERET_LG1           ((LTFAT_REAL) 0.66666662693)
+#define PHASERET_LG2           ((LTFAT_REAL) 0.40000972152)
+#define PHASERET_LG3           ((LTFAT_REAL) 0.28498786688)
+#define PHASERET_LG4           ((LTFAT_REAL) 0.24279078841)
+#define PHASERET_LN2HI         ((LTFAT_REAL) 6.9313812256e-01)
+#define PHASERET_LN2LO         ((LTFAT_REAL) 9.0580006145e-06)
+#define PHASERET_LOG_EPS       FLT_MIN
+#else
+#define PHASERET_LOG_UINT      uint64_t
+#define PHASERET_LOG_ADD       UINT64_C(0x00095f6200000000)
+#define PHASERET_LOG_MANT      UINT64_C(0x000fffffffffffff)
+#define PHASERET_LOG_BASE      UINT64_C(0x3fe6a09e00000000)
+#define PHASERET_LOG_EXPSHIFT  52
+#define PHASERET_LOG_EXPBIAS   0x3ff
+#define PHASERET_LG1           6.666666666666735130e-01
+#define PHASERET_LG2           3.999999999940941908e-01
+#define PHASERET_LG3           2.857142874366239149e-01
+#define PHASERET_LG4           2.222219843214978396e-01
+#define PHASERET_LG5           1.818357216161805012e-01
+#define PHASERET_LG6           1.531383769920937332e-01
+#define PHASERET_LG7           1.479819860511658591e-01
+#define PHASERET_LN2HI         6.93147180369123816490e-01
+#define PHASERET_LN2LO         1.90821492927058770002e-10
+#define PHASERET_LOG_EPS       DBL_MIN
+#endif
+
+static LTFAT_REAL
+PHASERET_NAME(rtpghi_logscalar)(LTFAT_REAL x)
+{
+    PHASERET_LOG_UINT ix;
+    LTFAT_REAL dk, f, hfsq, s, z, w, R;
+
+    memcpy(&ix, &x, sizeof ix);
+    ix += PHASERET_LOG_ADD;
+    dk = (LTFAT_REAL) ((int) (ix >> PHASERET_LOG_EXPSHIFT) - PHASERET_LOG_EXPBIAS);
+    ix = (ix & PHASERET_LOG_MANT) + PHASERET_LOG_BASE;
+    memcpy(&x, &ix, sizeof x);
+
+    f = x - (LTFAT_REAL) 1.0;
+    hfsq = (LTFAT_REAL) 0.5 * f * f;
+    s = f / ((LTFAT_REAL) 2.0 + f);
+    z = s * s;
+    w = z * z;
+#ifdef LTFAT_SINGLE
+    R = z * (PHASERET_LG1 + w * PHASERET_LG3) +
+        w * (PHASERET_LG2 + w * PHASERET_LG4);
+#else
+    R = z * (PHASERET_LG1 + w * (PHASERET_LG3 + w * (PHASERET_LG5 + w * PHASERET_LG7))) +
+        w * (PHASERET_LG2 + w * (PHASERET_LG4 + w * PHASERET_LG6));
+#endif
+    return s * (hfsq + R) + dk * PHASERET_LN2LO - hfsq + f + dk * PHASERET_LN2HI;
+}
+
+static void
+PHASERET_NAME(rtpghilog_plain)(const LTFAT_REAL* in, ltfat_int L, LTFAT_REAL* out)
+{
+    for (ltfat_int l = 0; l < L; l++)
+        out[l] = PHASERET_NAME(rtpghi_logscalar)(in[l] + PHASERET_LOG_EPS);
+}
+
+/* Time gradient for m in [mstart, mend) */
+static void
+PHASERET_NAME(rtpghitgrad_plain)(const LTFAT_REAL* logs, LTFAT_REAL tgradmul,
+                                 LTFAT_REAL tgradplus, ltfat_int mstart,
+                                 ltfat_int mend, LTFAT_REAL* tgrad)
+{
+    for (ltfat_int m = mstart; m < mend; m++)
+        tgrad[m] = tgradmul * (logs[m + 1] - logs[m - 1]) + tgradplus * m;
+}
+
+/* Frequency gradient for m in [mstart, M2) */
+static void
+PHASERET_NAME(rtpghifgrad_plain)(const LTFAT_REAL* logs, ltfat_int M2,
+                                 LTFAT_REAL fgradmul, int do_causal,
+                                 ltfat_int mstart, LTFAT_REAL* fgrad)
+{
+    const LTFAT_REAL* scol0 = logs;
+    const LTFAT_REAL* scol1 = logs + M2;
+    const LTFAT_REAL* scol2 = logs + 2 * M2;
+
+    if (do_causal)
+    {
+        for (ltfat_int m = mstart; m < M2; ++m)
+            fgrad[m] = fgradmul * ((LTFAT_REAL)(3.0) * scol2[m] -
+                                   (LTFAT_REAL)(4.0) * scol1[m] + scol0[m]);
+    }
+    else
+    {
+        for (ltfat_int m = mstart; m < M2; ++m)
+            fgrad[m] = fgradmul * (scol2[m] - scol0[m]);
+    }
+}
+
+#ifdef PHASERET_SIMD_X86
+#ifdef LTFAT_SINGLE
+#define PHASERET_MI128(op)     _mm_##op##_epi32
+#define PHASERET_MI256(op)     _mm256_##op##_epi32
+#define PHASERET_MI512(op)     _mm512_##op##_epi32
+#define PHASERET_ISET128(x)    _mm_set1_epi32((int) (x))
+#define PHASERET_ISET256(x)    _mm256_set1_epi32((int) (x))
+#define PHASERET_ISET512(x)    _mm512_set1_epi32((int) (x))
+#define PHASERET_CASTI128(x)   _mm_castps_si128(x)
+#define PHASERET_CASTI256(x)   _mm256_castps_si256(x)
+#define PHASERET_CASTI512(x)   _mm512_castps_si512(x)
+#define PHASERET_CASTF128(x)   _mm_castsi128_ps(x)
+#define PHASERET_CASTF256(x)   _mm256_castsi256_ps(x)
+#define PHASERET_CASTF512(x)   _mm512_castsi512_ps(x)
+/* Unbiased exponent as a float vector */
+#define PHASERET_LOGK(MM, MI, ISET, CASTF, OR, ix)                           \
+    MM(cvtepi32)(MI(sub)(MI(srli)(ix, PHASERET_LOG_EXPSHIFT),                \
+                         ISET(PHASERET_LOG_EXPBIAS)))
+#define PHASERET_LOGPOLY(MM, z, w)                                           \
+    MM(add)(MM(mul)(z, MM(add)(MM(set1)(PHASERET_LG1),                       \
+                               MM(mul)(w, MM(set1)(PHASERET_LG3)))),         \
+            MM(mul)(w, MM(add)(MM(set1)(PHASERET_LG2),                       \
+                               MM(mul)(w, MM(set1)(PHASERET_LG4)))))
+#else
+#define PHASERET_MI128(op)     _mm_##op##_epi64
+#define PHASERET_MI256(op)     _mm256_##op##_epi64
+#define PHASERET_MI512(op)     _mm512_##op##_epi64
+#define PHASERET_ISET128(x)    _mm_set1_epi64x((long long) (x))
+#define PHASERET_ISET256(x)    _mm256_set1_epi64x((long long) (x))
+#define PHASERET_ISET512(x)    _mm512_set1_epi64((long long) (x))
+#define PHASERET_CASTI128(x)   _mm_castpd_si128(x)
+#define PHASERET_CASTI256(x)   _mm256_castpd_si256(x)
+#define PHASERET_CASTI512(x)   _mm512_castpd_si512(x)
+#define PHASERET_CASTF128(x)   _mm_castsi128_pd(x)
+#define PHASERET_CASTF256(x)   _mm256_castsi256_pd(x)
+#define PHASERET_CASTF512(x)   _mm512_castsi512_pd(x)
+/* There is no 64 bit integer to double conversion below AVX-512DQ. The
+ * biased exponent is placed into the mantissa of 2^52 instead, the
+ * subtraction is exact. */
+#define PHASERET_LOGK(MM, MI, ISET, CASTF, OR, ix)                           \
+    MM(sub)(CASTF(OR(MI(srli)(ix, PHASERET_LOG_EXPSHIFT),                    \
+                     ISET(UINT64_C(0x4330000000000000)))),                   \
+            MM(set1)(4503599627370496.0 + PHASERET_LOG_EXPBIAS))
+#define PHASERET_LOGPOLY(MM, z, w)                                           \
+    MM(add)(MM(mul)(z, MM(add)(MM(set1)(PHASERET_LG1),                       \
+            MM(mul)(w, MM(add)(MM(set1)(PHASERET_LG3),                       \
+            MM(mul)(w, MM(add)(MM(set1)(PHASERET_LG5),                       \
+                               MM(mul)(w, MM(set1)(PHASERET_LG7)))))))),     \
+            MM(mul)(w, MM(add)(MM(set1)(PHASERET_LG2),                       \
+            MM(mul)(w, MM(add)(MM(set1)(PHASERET_LG4),                       \
+                               MM(mul)(w, MM(set1)(PHASERET_LG6)))))))
+#endif
+
+#define PHASERET_VL128  ((ltfat_int)(16 / sizeof (LTFAT_REAL)))
+#define PHASERET_VL256  ((ltfat_int)(32 / sizeof (LTFAT_REAL)))
+#define PHASERET_VL512  ((ltfat_int)(64 / sizeof (LTFAT_REAL)))
+
+static const LTFAT_REAL PHASERET_NAME(rtpghiiota)[16] =
+{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+/* The same expressions as in rtpghi_logscalar. The loops leave the last
+ * incomplete register to the plain code, from l or m on. */
+#define PHASERET_RTPGHI_LOG(MM, MT, MI, IT, ISET, CASTI, CASTF, AND, OR, VL) \
+    ltfat_int l = 0;                                                         \
+    for (; l + VL <= L; l += VL)                                             \
+    {                                                                        \
+        MT x = MM(add)(MM(loadu)(in + l), MM(set1)(PHASERET_LOG_EPS));       \
+        IT ix = MI(add)(CASTI(x), ISET(PHASERET_LOG_ADD));                   \
+        MT dk = PHASERET_LOGK(MM, MI, ISET, CASTF, OR, ix);                  \
+        ix = MI(add)(AND(ix, ISET(PHASERET_LOG_MANT)),                       \
+                     ISET(PHASERET_LOG_BASE));                               \
+        MT f = MM(sub)(CASTF(ix), MM(set1)(1.0));                            \
+        MT hfsq = MM(mul)(MM(mul)(MM(set1)(0.5), f), f);                     \
+        MT s = MM(div)(f, MM(add)(MM(set1)(2.0), f));                        \
+        MT z = MM(mul)(s, s);                                                \
+        MT w = MM(mul)(z, z);                                                \
+        MT r = MM(mul)(s, MM(add)(hfsq, PHASERET_LOGPOLY(MM, z, w)));        \
+        r = MM(add)(r, MM(mul)(dk, MM(set1)(PHASERET_LN2LO)));               \
+        r = MM(add)(MM(sub)(r, hfsq), f);                                    \
+        r = MM(add)(r, MM(mul)(dk, MM(set1)(PHASERET_LN2HI)));               \
+        MM(storeu)(out + l, r);                                              \
+    }
+
+#define PHASERET_RTPGHI_TGRAD(MM, MT, VL)                                    \
+    MT tmul = MM(set1)(tgradmul);                                            \
+    MT tplus = MM(set1)(tgradplus);                                          \
+    MT iota = MM(loadu)(PHASERET_NAME(rtpghiiota));                          \
+    ltfat_int m = mstart;                                                    \
+    for (; m + VL <= mend; m += VL)                                          \
+    {                                                                        \
+        MT mv = MM(add)(MM(set1)((LTFAT_REAL) m), iota);                     \
+        MT d = MM(sub)(MM(loadu)(logs + m + 1), MM(loadu)(logs + m - 1));    \
+        MM(storeu)(tgrad + m, MM(add)(MM(mul)(tmul, d), MM(mul)(tplus, mv)));\
+    }
+
+#define PHASERET_RTPGHI_FGRAD(MM, MT, VL)                                    \
+    const LTFAT_REAL* scol0 = logs;                                          \
+    const LTFAT_REAL* scol1 = logs + M2;                                     \
+    const LTFAT_REAL* scol2 = logs + 2 * M2;                                 \
+    MT fmul = MM(set1)(fgradmul);                                            \
+    ltfat_int m = 0;                                                         \
+    if (do_causal)                                                           \
+    {                                                                        \
+        MT three = MM(set1)(3.0), four = MM(set1)(4.0);                      \
+        for (; m + VL <= M2; m += VL)                                        \
+        {                                                                    \
+            MT d = MM(sub)(MM(mul)(three, MM(loadu)(scol2 + m)),             \
+                           MM(mul)(four, MM(loadu)(scol1 + m)));             \
+            d = MM(add)(d, MM(loadu)(scol0 + m));                            \
+            MM(storeu)(fgrad + m, MM(mul)(fmul, d));                         \
+        }                                                                    \
+    }                                                                        \
+    else                                                                     \
+    {                                                                        \
+        for (; m + VL <= M2; m += VL)                                        \
+            MM(storeu)(fgrad + m, MM(mul)(fmul, MM(sub)(MM(loadu)(scol2 + m),\
+                                           MM(loadu)(scol0 + m))));          \
+    }
+
+/* Defines the three kernels for one instruction set. The target
+ * attributes are per function so that the library itself does not have
+ * to be built with -mavx2 etc. */
+#define PHASERET_RTPGHI_KERNELS(SUFFIX, TARGET, ZEROUPPER, MM, MT, MI, IT,   \
+                                ISET, CASTI, CASTF, AND, OR, VL)             \
+__attribute__((target(TARGET))) static void                                  \
+PHASERET_NAME(rtpghilog_##SUFFIX)(const LTFAT_REAL* in, ltfat_int L,          \
+                                  LTFAT_REAL* out)                           \
+{                                                                            \
+    PHASERET_RTPGHI_LOG(MM, MT, MI, IT, ISET, CASTI, CASTF, AND, OR, VL)     \
+    ZEROUPPER;                                                               \
+    PHASERET_NAME(rtpghilog_plain)(in + l, L - l, out + l);                  \
+}                                                                            \
+                                                                             \
+__attribute__((target(TARGET))) static void                                  \
+PHASERET_NAME(rtpghitgrad_##SUFFIX)(const LTFAT_REAL* logs,                   \
+                                    LTFAT_REAL tgradmul, LTFAT_REAL tgradplus,\
+                                    ltfat_int mstart, ltfat_int mend,        \
+                                    LTFAT_REAL* tgrad)                       \
+{                                                                            \
+    PHASERET_RTPGHI_TGRAD(MM, MT, VL)                                        \
+    ZEROUPPER;                                                               \
+    PHASERET_NAME(rtpghitgrad_plain)(logs, tgradmul, tgradplus, m, mend,     \
+                                     tgrad);                                 \
+}                                                                            \
+                                                                             \
+__attribute__((target(TARGET))) static void                                  \
+PHASERET_NAME(rtpghifgrad_##SUFFIX)(const LTFAT_REAL* logs, ltfat_int M2,     \
+                                    LTFAT_REAL fgradmul, int do_causal,      \
+                                    LTFAT_REAL* fgrad)                       \
+{                                                                            \
+    PHASERET_RTPGHI_FGRAD(MM, MT, VL)                                        \
+    ZEROUPPER;                                                               \
+    PHASERET_NAME(rtpghifgrad_plain)(logs, M2, fgradmul, do_causal, m,       \
+                                     fgrad);                                 \
+}
+
+PHASERET_RTPGHI_KERNELS(sse2, "sse2", (void) 0,
+                        PHASERET_MM128, PHASERET_M128, PHASERET_MI128, __m128i,
+                        PHASERET_ISET128, PHASERET_CASTI128, PHASERET_CASTF128,
+                        _mm_and_si128, _mm_or_si128, PHASERET_VL128)
+
+/* GCC does not clear the upper halves of the registers before the tail
+ * call, the following SSE code would then be slowed down by the state
+ * transitions */
+PHASERET_RTPGHI_KERNELS(avx2, "avx2", _mm256_zeroupper(),
+                        PHASERET_MM256, PHASERET_M256, PHASERET_MI256, __m256i,
+                        PHASERET_ISET256, PHASERET_CASTI256, PHASERET_CASTF256,
+                        _mm256_and_si256, _mm256_or_si256, PHASERET_VL256)
+
+PHASERET_RTPGHI_KERNELS(avx512, "avx512f", _mm256_zeroupper(),
+                        PHASERET_MM512, PHASERET_M512, PHASERET_MI512, __m512i,
+                        PHASERET_ISET512, PHASERET_CASTI512, PHASERET_CASTF512,
+                        _mm512_and_si512, _mm512_or_si512, PHASERET_VL512)
+
+#undef PHASERET_RTPGHI_KERNELS
+#undef PHASERET_RTPGHI_FGRAD
+#undef PHASERET_RTPGHI_TGRAD
+#undef PHASERET_RTPGHI_LOG
+#undef PHASERET_LOGPOLY
+#undef PHASERET_LOGK
+#undef PHASERET_MI128
+#undef PHASERET_MI256
+#undef PHASERET_MI512
+#undef PHASERET_ISET128
+#undef PHASERET_ISET256
+#undef PHASERET_ISET512
+#undef PHASERET_CASTI128
+#undef PHASERET_CASTI256
+#undef PHASERET_CASTI512
+#undef PHASERET_CASTF128
+#undef PHASERET_CASTF256
+#undef PHASERET_CASTF512
+#undef PHASERET_VL128
+#undef PHASERET_VL256
+#undef PHASERET_VL512
+#endif /* PHASERET_SIMD_X86 */
+
+void
+PHASERET_NAME(rtpghilog)(const LTFAT_REAL* in, ltfat_int L, LTFAT_REAL* out)
+{
+    PHASERET_SIMD_DISPATCH(ltfat_simd_get_level(), rtpghilog, (in, L, out));
+
+    PHASERET_NAME(rtpghilog_plain)(in, L, out);
+}
+
+void
+PHASERET_NAME(rtpghitgrad)(const LTFAT_REAL* logs, ltfat_int a, ltfat_int M,
+                           double gamma,
+                           LTFAT_REAL* tgrad)
+{
+    ltfat_int M2 = M / 2 + 1;
+
+    const LTFAT_REAL tgradmul = (const LTFAT_REAL)( (a * M) / (gamma * 2.0));
+    const LTFAT_REAL tgradplus = (const LTFAT_REAL)( 2.0 * M_PI * a / ((double)M) );
+
+    tgrad[0]      = 0.0;
+    tgrad[M2 - 1] = 0.0;
+
+    PHASERET_SIMD_DISPATCH(ltfat_simd_get_level(), rtpghitgrad,
+                           (logs, tgradmul, tgradplus, 1, M2 - 1, tgrad));
+
+    PHASERET_NAME(rtpghitgrad_plain)(logs, tgradmul, tgradplus, 1, M2 - 1, tgrad);
+}
+
+void
+PHASERET_NAME(rtpghifgrad)(const LTFAT_REAL* logs, ltfat_int a, ltfat_int M,
+                           double gamma,
+                           int do_causal, LTFAT_REAL* fgrad)
+{
+    ltfat_int M2 = M / 2 + 1;
+
+    const LTFAT_REAL fgradmul = (const LTFAT_REAL)( -gamma / (2.0 * a * M));
+
+    PHASERET_SIMD_DISPATCH(ltfat_simd_get_level(), rtpghifgrad,
+                           (logs, M2, fgradmul, do_causal, fgrad));
+
+    PHASERET_NAME(rtpghifgrad_plain)(logs, M2, fgradmul, do_causal, 0, fgrad);
+}
+
+#undef PHASERET_LOG_UINT
+#undef PHASERET_LOG_ADD
+#undef PHASERET_LOG_MANT
+#undef PHASERET_LOG_BASE
+#undef PHASERET_LOG_EXPSHIFT
+#undef PHASERET_LOG_EXPBIAS
+#undef PHASERET_LG1
+#undef PHASERET_LG2
+#undef PHASERET_LG3
+#undef PHASERET_LG4
+#ifndef LTFAT_SINGLE
+#undef PHASERET_LG5
+#undef PHASERET_LG6
+#undef PHASERET_LG7
+#endif
+#undef PHASERET_LN2HI
+#undef PHASERET_LN2LO
+#undef PHASERET_LOG_EPS